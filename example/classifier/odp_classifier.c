@@ -43,6 +43,11 @@
  */
 #define DISPLAY_STRING_LEN	32
 
+/** @def VEC_POOL_SIZE
+ * @brief Number of packet vectors
+ */
+#define VEC_POOL_SIZE		1024
+
 /** Get rid of path in filename - only for unix-type paths using '/' */
 #define NO_PATH(file_name) (strrchr((file_name), '/') ? \
 		strrchr((file_name), '/') + 1 : (file_name))
@@ -74,6 +79,8 @@ typedef struct {
 	int cpu_count;		/**< Number of CPUs to use */
 	uint32_t time;		/**< Number of seconds to run */
 	char *if_name;		/**< pointer to interface names */
+	uint32_t vector;	/**< Packets per CoS vector, 0: no vectors */
+	odp_pool_t vec_pool;	/**< Packet vector pool */
 } appl_args_t;
 
 enum packet_mode {
@@ -82,7 +89,6 @@ enum packet_mode {
 };
 
 /* helper funcs */
-static int drop_err_pkts(odp_packet_t pkt_tbl[], unsigned len);
 static void swap_pkt_addrs(odp_packet_t pkt_tbl[], unsigned len);
 static void parse_args(int argc, char *argv[], appl_args_t *appl_args);
 static void print_info(char *progname, appl_args_t *appl_args);
@@ -280,27 +286,76 @@ static odp_pktio_t create_pktio(const char *dev, odp_pool_t pool)
 }
 
 /**
- * Worker threads to receive the packet
+ * Count, drop or send back a received packet
  *
+ * @return 0 on success, -1 if the worker must stop
  */
-static void *pktio_receive_thread(void *arg)
+static int process_pkt(appl_args_t *appl, odp_packet_t pkt, odp_queue_t queue,
+		       unsigned long *err_cnt)
 {
-	int thr;
+	int thr = odp_thread_id();
 	odp_queue_t outq_def;
-	odp_packet_t pkt;
+	odp_pktio_t pktio_tmp;
 	odp_pool_t pool;
+	global_statistics *stats;
+	int i;
+
+	/* Total packets received */
+	odp_atomic_inc_u64(&appl->total_packets);
+
+	/* Drop packets with errors */
+	if (odp_unlikely(odp_packet_has_error(pkt))) {
+		odp_packet_free(pkt);
+		EXAMPLE_ERR("Drop frame - err_cnt:%lu\n", ++*err_cnt);
+		return 0;
+	}
+
+	pktio_tmp = odp_packet_input(pkt);
+	outq_def = odp_pktio_outq_getdef(pktio_tmp);
+
+	if (outq_def == ODP_QUEUE_INVALID) {
+		EXAMPLE_ERR("  [%02i] Error: def output-Q query\n", thr);
+		return -1;
+	}
+
+	pool = odp_packet_pool(pkt);
+
+	/* Swap Eth MACs and possibly IP-addrs before sending back */
+	swap_pkt_addrs(&pkt, 1);
+	for (i = 0; i <  MAX_PMR_COUNT; i++) {
+		stats = &appl->stats[i];
+		if (queue == stats->queue)
+			odp_atomic_inc_u64(&stats->queue_pkt_count);
+		if (pool == stats->pool)
+			odp_atomic_inc_u64(&stats->pool_pkt_count);
+	}
+
+	if (appl->appl_mode == APPL_MODE_DROP) {
+		odp_packet_free(pkt);
+	} else if (odp_queue_enq(outq_def, odp_packet_to_event(pkt))) {
+		EXAMPLE_ERR("  [%i] Queue enqueue failed.\n", thr);
+		odp_packet_free(pkt);
+	}
+
+	return 0;
+}
+
+/**
+ * Worker threads to receive the packet
+ *
+ */
+static void *pktio_receive_thread(void *arg)
+{
+	odp_packet_vector_t pktv;
+	odp_packet_t *pkt_tbl;
 	odp_event_t ev;
 	unsigned long err_cnt = 0;
 	odp_queue_t queue;
-	int i;
-	thr = odp_thread_id();
+	uint32_t i, num;
 	appl_args_t *appl = (appl_args_t *)arg;
-	global_statistics *stats;
 
 	/* Loop packets */
 	for (;;) {
-		odp_pktio_t pktio_tmp;
-
 		/* Use schedule to get buf from any input queue */
 		ev = odp_schedule(&queue, ODP_SCHED_WAIT);
 
@@ -308,47 +363,26 @@ static void *pktio_receive_thread(void *arg)
 		if (odp_unlikely(ev == ODP_EVENT_INVALID))
 			continue;
 
-		pkt = odp_packet_from_event(ev);
-
-		/* Total packets received */
-		odp_atomic_inc_u64(&appl->total_packets);
-
-		/* Drop packets with errors */
-		if (odp_unlikely(drop_err_pkts(&pkt, 1) == 0)) {
-			EXAMPLE_ERR("Drop frame - err_cnt:%lu\n", ++err_cnt);
+		if (odp_event_type(ev) != ODP_EVENT_PACKET_VECTOR) {
+			if (process_pkt(appl, odp_packet_from_event(ev), queue,
+					&err_cnt))
+				return NULL;
 			continue;
 		}
 
-		pktio_tmp = odp_packet_input(pkt);
-		outq_def = odp_pktio_outq_getdef(pktio_tmp);
-
-		if (outq_def == ODP_QUEUE_INVALID) {
-			EXAMPLE_ERR("  [%02i] Error: def output-Q query\n",
-				    thr);
-			return NULL;
-		}
-
-		pool = odp_packet_pool(pkt);
+		/* A CoS vector holds packets of one queue */
+		pktv = odp_packet_vector_from_event(ev);
+		num  = odp_packet_vector_tbl(pktv, &pkt_tbl);
 
-		/* Swap Eth MACs and possibly IP-addrs before sending back */
-		swap_pkt_addrs(&pkt, 1);
-		for (i = 0; i <  MAX_PMR_COUNT; i++) {
-			stats = &appl->stats[i];
-			if (queue == stats->queue)
-				odp_atomic_inc_u64(&stats->queue_pkt_count);
-			if (pool == stats->pool)
-				odp_atomic_inc_u64(&stats->pool_pkt_count);
+		for (i = 0; i < num; i++) {
+			if (process_pkt(appl, pkt_tbl[i], queue, &err_cnt)) {
+				odp_packet_free_multi(&pkt_tbl[i], num - i);
+				odp_packet_vector_free(pktv);
+				return NULL;
+			}
 		}
 
-		if (appl->appl_mode == APPL_MODE_DROP)
-			odp_packet_free(pkt);
-		else
-			if (odp_queue_enq(outq_def, ev)) {
-				EXAMPLE_ERR("  [%i] Queue enqueue failed.\n",
-					    thr);
-				odp_packet_free(pkt);
-				continue;
-			}
+		odp_packet_vector_free(pktv);
 	}
 
 	return NULL;
@@ -395,6 +429,11 @@ static void configure_default_cos(odp_pktio_t pktio, appl_args_t *args)
 	cls_param.pool = pool_default;
 	cls_param.queue = queue_default;
 	cls_param.drop_policy = ODP_COS_DROP_POOL;
+	if (args->vector) {
+		cls_param.vector.enable   = 1;
+		cls_param.vector.pool     = args->vec_pool;
+		cls_param.vector.max_size = args->vector;
+	}
 	cos_default = odp_cls_cos_create(cos_name, &cls_param);
 
 	if (cos_default == ODP_COS_INVALID) {
@@ -478,6 +517,11 @@ static void configure_cos(odp_pktio_t pktio, appl_args_t *args)
 		cls_param.pool = stats->pool;
 		cls_param.queue = stats->queue;
 		cls_param.drop_policy = ODP_COS_DROP_POOL;
+		if (args->vector) {
+			cls_param.vector.enable   = 1;
+			cls_param.vector.pool     = args->vec_pool;
+			cls_param.vector.max_size = args->vector;
+		}
 		stats->cos = odp_cls_cos_create(cos_name, &cls_param);
 
 		if (0 > odp_pktio_pmr_cos(stats->pmr, pktio, stats->cos)) {
@@ -570,6 +614,21 @@ int main(int argc, char *argv[])
 		exit(EXIT_FAILURE);
 	}
 
+	/* Create packet vector pool */
+	args->vec_pool = ODP_POOL_INVALID;
+	if (args->vector) {
+		odp_pool_param_init(&params);
+		params.vec.num      = VEC_POOL_SIZE;
+		params.vec.max_size = args->vector;
+		params.type         = ODP_POOL_VECTOR;
+
+		args->vec_pool = odp_pool_create("vector_pool", &params);
+		if (args->vec_pool == ODP_POOL_INVALID) {
+			EXAMPLE_ERR("Error: vector pool create failed.\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+
 	/* odp_pool_print(pool); */
 	odp_atomic_init_u64(&args->total_packets, 0);
 
@@ -624,37 +683,6 @@ int main(int argc, char *argv[])
 	return 0;
 }
 
-/**
- * Drop packets which input parsing marked as containing errors.
- *
- * Frees packets with error and modifies pkt_tbl[] to only contain packets with
- * no detected errors.
- *
- * @param pkt_tbl  Array of packet
- * @param len      Length of pkt_tbl[]
- *
- * @return Number of packets with no detected error
- */
-static int drop_err_pkts(odp_packet_t pkt_tbl[], unsigned len)
-{
-	odp_packet_t pkt;
-	unsigned pkt_cnt = len;
-	unsigned i, j;
-
-	for (i = 0, j = 0; i < len; ++i) {
-		pkt = pkt_tbl[i];
-
-		if (odp_unlikely(odp_packet_has_error(pkt))) {
-			odp_packet_free(pkt); /* Drop */
-			pkt_cnt--;
-		} else if (odp_unlikely(i != j++)) {
-			pkt_tbl[j-1] = pkt;
-		}
-	}
-
-	return pkt_cnt;
-}
-
 /**
  * Swap eth src<->dst and IP src<->dst addresses
  *
@@ -807,13 +835,14 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 		{"policy", required_argument, NULL, 'p'},	/* return 'p' */
 		{"mode", required_argument, NULL, 'm'},		/* return 'm' */
 		{"time", required_argument, NULL, 't'},		/* return 't' */
+		{"vector", required_argument, NULL, 'v'},	/* return 'v' */
 		{"help", no_argument, NULL, 'h'},		/* return 'h' */
 		{NULL, 0, NULL, 0}
 	};
 
 
 	while (1) {
-		opt = getopt_long(argc, argv, "+c:t:i:p:m:t:h",
+		opt = getopt_long(argc, argv, "+c:t:i:p:m:t:v:h",
 				longopts, &long_index);
 
 		if (opt == -1)
@@ -831,6 +860,9 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 		case 't':
 			appl_args->time = atoi(optarg);
 			break;
+		case 'v':
+			appl_args->vector = atoi(optarg);
+			break;
 		case 'i':
 			len = strlen(optarg);
 			if (len == 0) {
@@ -946,6 +978,10 @@ static void usage(char *progname)
 			"			0: Runs in infinite loop\n"
 			"			default: Runs in infinite loop\n"
 			"\n"
+			" -v, --vector <number>	Deliver up to <number> packets per event on\n"
+			"			CoS queues\n"
+			"			default: 0, one packet per event\n"
+			"\n"
 			"  -h, --help		Display help and exit.\n"
 			"\n", NO_PATH(progname), NO_PATH(progname)
 	      );
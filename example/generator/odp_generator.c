@@ -27,6 +27,22 @@
 #define SHM_PKT_POOL_SIZE      (64*2048)	/**< pkt pool size */
 #define SHM_PKT_POOL_BUF_SIZE  1856		/**< pkt pool buf size */
 #define DEFAULT_PKT_INTERVAL   1000             /**< interval btw each pkt */
+#define MAX_PKT_BURST          64		/**< max packets per send burst */
+#define DEFAULT_PKT_BURST      32		/**< default send burst */
+#define GEN_STAMP_MAGIC        0x4f445047	/**< "ODPG", stamped payload */
+#define RECV_WAIT_MS           100		/**< receive poll timeout */
+
+/** Latency histogram resolution: 2^LAT_HIST_SUB_BITS buckets per power of
+ *  two, i.e. values are recorded with 6.25% precision */
+#define LAT_HIST_SUB_BITS      4
+#define LAT_HIST_SUB           (1 << LAT_HIST_SUB_BITS)
+
+/** Largest recorded power of two ns, longer latencies land in the last
+ *  bucket */
+#define LAT_HIST_EXP_MAX       39
+
+#define LAT_HIST_BUCKETS \
+	((LAT_HIST_EXP_MAX - LAT_HIST_SUB_BITS + 2) * LAT_HIST_SUB)
 
 #define APPL_MODE_UDP    0			/**< UDP mode */
 #define APPL_MODE_PING   1			/**< ping mode */
@@ -58,6 +74,15 @@ typedef struct {
 	int timeout;		/**< wait time */
 	int interval;		/**< wait interval ms between sending
 				     each packet */
+	int burst;		/**< packets per send burst */
+	uint64_t rate;		/**< packets per second, 0: no pacing */
+	unsigned int srcport;	/**< udp src port */
+	unsigned int dstport;	/**< udp dst port */
+	unsigned int srcip_num;	/**< number of src ip addresses */
+	unsigned int dstip_num;	/**< number of dst ip addresses */
+	unsigned int srcport_num; /**< number of udp src ports */
+	unsigned int dstport_num; /**< number of udp dst ports */
+	int latency;		/**< stamp packets and measure latency */
 } appl_args_t;
 
 /**
@@ -69,8 +94,42 @@ static struct {
 	odp_atomic_u64_t udp;	/**< udp packets */
 	odp_atomic_u64_t icmp;	/**< icmp packets */
 	odp_atomic_u64_t cnt;	/**< sent packets*/
+	odp_atomic_u32_t senders; /**< running high-rate send threads */
 } counters;
 
+/**
+ * Log-linear (HDR style) latency histogram, values in ns
+ */
+typedef struct {
+	uint64_t count;				/**< recorded latencies */
+	uint64_t sum;				/**< sum of latencies */
+	uint64_t min;				/**< lowest latency */
+	uint64_t max;				/**< highest latency */
+	uint64_t bucket[LAT_HIST_BUCKETS];	/**< log-linear buckets */
+} lat_hist_t;
+
+/**
+ * Latency statistics of a receive thread, streams are send threads
+ */
+typedef struct {
+	lat_hist_t hist;			/**< latency histogram */
+	uint64_t rx[MAX_WORKERS];		/**< packets per stream */
+	uint64_t reorder[MAX_WORKERS];		/**< packets received after
+						     a later one */
+} lat_stats_t;
+
+/**
+ * Payload start of the high-rate UDP mode. The sequence number is always
+ * set, the other fields in latency mode.
+ */
+typedef struct {
+	uint32be_t seq;		/**< sequence number in the stream */
+	uint32be_t magic;	/**< GEN_STAMP_MAGIC */
+	uint32be_t stream;	/**< send thread index */
+	uint32be_t ts_hi;	/**< send time in ns, odp_time_global() */
+	uint32be_t ts_lo;
+} gen_stamp_t;
+
 /** * Thread specific arguments
  */
 typedef struct {
@@ -81,8 +140,20 @@ typedef struct {
 	odp_timer_t tim;	/**< Timer handle */
 	odp_timeout_t tmo_ev;	/**< Timeout event */
 	int mode;		/**< Thread mode */
+	uint64_t quota;		/**< packets to send */
+	uint64_t rate;		/**< packets per second, 0: no pacing */
+	odp_atomic_u64_t sent;	/**< packets sent by the thread */
+	lat_stats_t lat;	/**< latency statistics of receive threads */
 } thread_args_t;
 
+/**
+ * Packet template of the high-rate send mode
+ */
+typedef struct {
+	uint8_t data[SHM_PKT_POOL_BUF_SIZE];	/**< packet data */
+	uint32_t len;				/**< packet length */
+} pkt_tmpl_t;
+
 /**
  * Grouping of both parsed CL args and thread specific args - alloc together
  */
@@ -91,6 +162,10 @@ typedef struct {
 	appl_args_t appl;
 	/** Thread specific arguments */
 	thread_args_t thread[MAX_WORKERS];
+	/** Highest sequence number + 1 received per stream. Receive queues
+	 *  are atomic and streams are sent to one interface, so updates to
+	 *  an entry do not overlap. */
+	uint32_t stream_seq[MAX_WORKERS];
 } args_t;
 
 /** Global pointer to args */
@@ -238,8 +313,8 @@ static odp_packet_t pack_udp_pkt(odp_pool_t pool)
 	/* udp */
 	odp_packet_l4_offset_set(pkt, ODPH_ETHHDR_LEN + ODPH_IPV4HDR_LEN);
 	udp = (odph_udphdr_t *)(buf + ODPH_ETHHDR_LEN + ODPH_IPV4HDR_LEN);
-	udp->src_port = 0;
-	udp->dst_port = 0;
+	udp->src_port = odp_cpu_to_be_16(args->appl.srcport);
+	udp->dst_port = odp_cpu_to_be_16(args->appl.dstport);
 	udp->length = odp_cpu_to_be_16(args->appl.payload + ODPH_UDPHDR_LEN);
 	udp->chksum = 0;
 	udp->chksum = odp_cpu_to_be_16(odph_ipv4_udp_chksum(pkt));
@@ -432,6 +507,8 @@ static void *gen_send_thread(void *arg)
 			return NULL;
 		}
 
+		odp_atomic_inc_u64(&thr_args->sent);
+
 		if (args->appl.interval != 0) {
 			printf("  [%02i] send pkt no:%ju seq %ju\n",
 			       thr,
@@ -464,6 +541,244 @@ static void *gen_send_thread(void *arg)
 	return arg;
 }
 
+/**
+ * Update a ones' complement checksum for a changed 16 bit word (RFC 1624)
+ *
+ * Words and checksum are in the same (packet) byte order.
+ */
+static inline uint16_t csum_update16(uint16_t csum, uint16_t old,
+				     uint16_t new)
+{
+	uint32_t sum = (uint16_t)~csum + (uint16_t)~old + new;
+
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+	return ~sum;
+}
+
+static inline uint16_t csum_update32(uint16_t csum, uint32_t old,
+				     uint32_t new)
+{
+	csum = csum_update16(csum, old >> 16, new >> 16);
+	return csum_update16(csum, old & 0xffff, new & 0xffff);
+}
+
+static inline uint32_t xorshift32(uint32_t *state)
+{
+	uint32_t x = *state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+
+/**
+ * Set the latency stamp fields of the template
+ *
+ * @param tmpl   Packet template
+ * @param stream Send thread index
+ */
+static void tmpl_stamp(pkt_tmpl_t *tmpl, uint32_t stream)
+{
+	odph_udphdr_t *udp = (odph_udphdr_t *)(tmpl->data + ODPH_ETHHDR_LEN +
+					       ODPH_IPV4HDR_LEN);
+	gen_stamp_t *stamp = (gen_stamp_t *)(udp + 1);
+	gen_stamp_t new;
+	uint16_t csum = udp->chksum;
+
+	new.seq    = stamp->seq;
+	new.magic  = odp_cpu_to_be_32(GEN_STAMP_MAGIC);
+	new.stream = odp_cpu_to_be_32(stream);
+	new.ts_hi  = 0;
+	new.ts_lo  = 0;
+
+	csum = csum_update32(csum, stamp->magic, new.magic);
+	csum = csum_update32(csum, stamp->stream, new.stream);
+	csum = csum_update32(csum, stamp->ts_hi, new.ts_hi);
+	csum = csum_update32(csum, stamp->ts_lo, new.ts_lo);
+
+	*stamp = new;
+	if (udp->chksum)
+		udp->chksum = csum ? csum : 0xffff;
+}
+
+/**
+ * Fill a packet from the template
+ *
+ * Sets IP ID and payload sequence number and picks random addresses and
+ * ports from the flow ranges. Checksums are updated incrementally.
+ */
+static inline void tmpl_fill(uint8_t *buf, const pkt_tmpl_t *tmpl,
+			     uint32_t seq, uint64_t ts, uint32_t *rnd)
+{
+	appl_args_t *appl = &args->appl;
+	odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)(buf + ODPH_ETHHDR_LEN);
+	odph_udphdr_t *udp = (odph_udphdr_t *)(buf + ODPH_ETHHDR_LEN +
+					       ODPH_IPV4HDR_LEN);
+	gen_stamp_t *stamp = (gen_stamp_t *)(udp + 1);
+	uint16_t ip_csum, udp_csum;
+	uint32_t addr;
+	uint16_t port;
+
+	memcpy(buf, tmpl->data, tmpl->len);
+
+	ip_csum  = ip->chksum;
+	udp_csum = udp->chksum;
+
+	ip_csum = csum_update16(ip_csum, ip->id, odp_cpu_to_be_16(seq));
+	ip->id  = odp_cpu_to_be_16(seq);
+
+	if (appl->srcip_num > 1) {
+		addr = odp_cpu_to_be_32(appl->srcip +
+					xorshift32(rnd) % appl->srcip_num);
+		ip_csum  = csum_update32(ip_csum, ip->src_addr, addr);
+		udp_csum = csum_update32(udp_csum, ip->src_addr, addr);
+		ip->src_addr = addr;
+	}
+
+	if (appl->dstip_num > 1) {
+		addr = odp_cpu_to_be_32(appl->dstip +
+					xorshift32(rnd) % appl->dstip_num);
+		ip_csum  = csum_update32(ip_csum, ip->dst_addr, addr);
+		udp_csum = csum_update32(udp_csum, ip->dst_addr, addr);
+		ip->dst_addr = addr;
+	}
+
+	if (appl->srcport_num > 1) {
+		port = odp_cpu_to_be_16(appl->srcport +
+					xorshift32(rnd) % appl->srcport_num);
+		udp_csum = csum_update16(udp_csum, udp->src_port, port);
+		udp->src_port = port;
+	}
+
+	if (appl->dstport_num > 1) {
+		port = odp_cpu_to_be_16(appl->dstport +
+					xorshift32(rnd) % appl->dstport_num);
+		udp_csum = csum_update16(udp_csum, udp->dst_port, port);
+		udp->dst_port = port;
+	}
+
+	if (appl->payload >= (int)sizeof(uint32_t)) {
+		udp_csum = csum_update32(udp_csum, stamp->seq,
+					 odp_cpu_to_be_32(seq));
+		stamp->seq = odp_cpu_to_be_32(seq);
+	}
+
+	/* Template time stamp is zero */
+	if (appl->latency) {
+		stamp->ts_hi = odp_cpu_to_be_32(ts >> 32);
+		stamp->ts_lo = odp_cpu_to_be_32(ts);
+		udp_csum = csum_update32(udp_csum, 0, stamp->ts_hi);
+		udp_csum = csum_update32(udp_csum, 0, stamp->ts_lo);
+	}
+
+	ip->chksum = ip_csum;
+
+	/* Zero UDP checksum means none, a computed zero is sent as ones */
+	if (udp->chksum)
+		udp->chksum = udp_csum ? udp_csum : 0xffff;
+}
+
+/**
+ * High-rate UDP send thread
+ *
+ * Fills packets from a pre-built template and sends them in bursts
+ * directly to the interface. Sending is paced to the thread rate.
+ *
+ * @param arg  thread arguments of type 'thread_args_t *'
+ */
+static void *gen_send_burst_thread(void *arg)
+{
+	int thr;
+	odp_pktio_t pktio;
+	thread_args_t *thr_args;
+	odp_packet_t pkt_tbl[MAX_PKT_BURST];
+	odp_packet_t pkt;
+	pkt_tmpl_t tmpl;
+	odp_time_t start;
+	uint64_t sent = 0;
+	uint64_t quota, ts = 0;
+	double ns_per_pkt = 0;
+	uint32_t rnd;
+	int burst, num, ret, i;
+
+	thr = odp_thread_id();
+	thr_args = arg;
+	quota = thr_args->quota;
+
+	pktio = odp_pktio_lookup(thr_args->pktio_dev);
+	if (pktio == ODP_PKTIO_INVALID) {
+		EXAMPLE_ERR("  [%02i] Error: lookup of pktio %s failed\n",
+			    thr, thr_args->pktio_dev);
+		return NULL;
+	}
+
+	pkt = pack_udp_pkt(thr_args->pool);
+	if (pkt == ODP_PACKET_INVALID) {
+		EXAMPLE_ERR("  [%02i] Error: template alloc failed\n", thr);
+		return NULL;
+	}
+
+	tmpl.len = odp_packet_len(pkt);
+	odp_packet_copydata_out(pkt, 0, tmpl.len, tmpl.data);
+	odp_packet_free(pkt);
+
+	if (args->appl.latency)
+		tmpl_stamp(&tmpl, thr_args - args->thread);
+
+	if (thr_args->rate)
+		ns_per_pkt = (double)ODP_TIME_SEC_IN_NS / thr_args->rate;
+
+	rnd = 2463534242u ^ (uint32_t)thr;
+
+	printf("  [%02i] created mode: SEND BURST\n", thr);
+
+	start = odp_time_local();
+
+	while (sent < quota) {
+		burst = args->appl.burst;
+		if (quota - sent < (uint64_t)burst)
+			burst = quota - sent;
+
+		/* Wait until the first packet of the burst is due */
+		if (ns_per_pkt != 0) {
+			uint64_t due = sent * ns_per_pkt;
+
+			while (odp_time_to_ns(odp_time_diff(odp_time_local(),
+							    start)) < due)
+				(void)0;
+		}
+
+		num = odp_packet_alloc_multi(thr_args->pool, tmpl.len,
+					     pkt_tbl, burst);
+		if (odp_unlikely(num <= 0))
+			continue;
+
+		if (args->appl.latency)
+			ts = odp_time_to_ns(odp_time_global());
+
+		for (i = 0; i < num; i++)
+			tmpl_fill(odp_packet_data(pkt_tbl[i]), &tmpl,
+				  sent + i, ts, &rnd);
+
+		ret = odp_pktio_send(pktio, pkt_tbl, num);
+		if (odp_unlikely(ret < 0))
+			ret = 0;
+
+		for (i = ret; i < num; i++)
+			odp_packet_free(pkt_tbl[i]);
+
+		sent += ret;
+		odp_atomic_store_u64(&thr_args->sent, sent);
+	}
+
+	odp_atomic_dec_u32(&counters.senders);
+
+	return arg;
+}
+
 /**
  * Print odp packets
  *
@@ -530,6 +845,85 @@ static void print_pkts(int thr, odp_packet_t pkt_tbl[], unsigned len)
 	}
 }
 
+/** Histogram bucket of a latency */
+static inline unsigned lat_hist_bucket(uint64_t ns)
+{
+	unsigned exp;
+
+	if (ns < LAT_HIST_SUB)
+		return ns;
+
+	exp = 63 - __builtin_clzll(ns);
+	if (exp > LAT_HIST_EXP_MAX)
+		return LAT_HIST_BUCKETS - 1;
+
+	return (exp - LAT_HIST_SUB_BITS + 1) * LAT_HIST_SUB +
+	       ((ns >> (exp - LAT_HIST_SUB_BITS)) & (LAT_HIST_SUB - 1));
+}
+
+/** Smallest latency recorded in a histogram bucket */
+static inline uint64_t lat_hist_bucket_min(unsigned bucket)
+{
+	unsigned exp;
+
+	if (bucket < LAT_HIST_SUB)
+		return bucket;
+
+	exp = bucket / LAT_HIST_SUB + LAT_HIST_SUB_BITS - 1;
+	return (uint64_t)(LAT_HIST_SUB + bucket % LAT_HIST_SUB) <<
+	       (exp - LAT_HIST_SUB_BITS);
+}
+
+/**
+ * Record latency, sequence and stream of a stamped packet
+ *
+ * @param lat  Latency statistics of the receive thread
+ * @param pkt  Received packet
+ * @param now  Receive time in ns, odp_time_global()
+ */
+static void lat_record(lat_stats_t *lat, odp_packet_t pkt, uint64_t now)
+{
+	const gen_stamp_t *stamp;
+	odph_udphdr_t *udp;
+	uint32_t len, stream, seq;
+	uint64_t ts, ns;
+	lat_hist_t *hist = &lat->hist;
+
+	if (!odp_packet_has_udp(pkt))
+		return;
+
+	udp = odp_packet_l4_ptr(pkt, &len);
+	if (udp == NULL || len < ODPH_UDPHDR_LEN + sizeof(gen_stamp_t))
+		return;
+
+	stamp = (const gen_stamp_t *)(udp + 1);
+	if (odp_be_to_cpu_32(stamp->magic) != GEN_STAMP_MAGIC)
+		return;
+
+	stream = odp_be_to_cpu_32(stamp->stream);
+	if (stream >= MAX_WORKERS)
+		return;
+
+	seq = odp_be_to_cpu_32(stamp->seq);
+	ts  = (uint64_t)odp_be_to_cpu_32(stamp->ts_hi) << 32 |
+	      odp_be_to_cpu_32(stamp->ts_lo);
+	ns  = now > ts ? now - ts : 0;
+
+	hist->bucket[lat_hist_bucket(ns)]++;
+	hist->count++;
+	hist->sum += ns;
+	if (ns < hist->min)
+		hist->min = ns;
+	if (ns > hist->max)
+		hist->max = ns;
+
+	lat->rx[stream]++;
+	if (seq < args->stream_seq[stream])
+		lat->reorder[stream]++;
+	else
+		args->stream_seq[stream] = seq + 1;
+}
+
 /**
  * Main receive function
  *
@@ -541,7 +935,10 @@ static void *gen_recv_thread(void *arg)
 	odp_pktio_t pktio;
 	thread_args_t *thr_args;
 	odp_packet_t pkt;
-	odp_event_t ev;
+	odp_event_t ev_tbl[MAX_PKT_BURST];
+	uint64_t wait, now;
+	int drain_ms, idle_ms = 0;
+	int num, i;
 
 	thr = odp_thread_id();
 	thr_args = arg;
@@ -553,6 +950,11 @@ static void *gen_recv_thread(void *arg)
 		return NULL;
 	}
 
+	wait = odp_schedule_wait_time(RECV_WAIT_MS * ODP_TIME_MSEC_IN_NS);
+
+	/* Latency mode waits for packets in flight after the senders */
+	drain_ms = args->appl.timeout > 0 ? args->appl.timeout * 1000 : 1000;
+
 	printf("  [%02i] created mode: RECEIVE\n", thr);
 
 	for (;;) {
@@ -563,23 +965,52 @@ static void *gen_recv_thread(void *arg)
 		}
 
 		/* Use schedule to get buf from any input queue */
-		ev = odp_schedule(NULL, ODP_SCHED_WAIT);
-
-		pkt = odp_packet_from_event(ev);
-		/* Drop packets with errors */
-		if (odp_unlikely(odp_packet_has_error(pkt))) {
-			odp_packet_free(pkt);
+		num = odp_schedule_multi(NULL, wait, ev_tbl, MAX_PKT_BURST);
+		if (num == 0) {
+			idle_ms += RECV_WAIT_MS;
+			if (args->appl.latency && idle_ms >= drain_ms &&
+			    odp_atomic_load_u32(&counters.senders) == 0)
+				break;
 			continue;
 		}
 
-		print_pkts(thr, &pkt, 1);
+		idle_ms = 0;
+		now = odp_time_to_ns(odp_time_global());
+
+		for (i = 0; i < num; i++) {
+			pkt = odp_packet_from_event(ev_tbl[i]);
+			/* Drop packets with errors */
+			if (odp_unlikely(odp_packet_has_error(pkt))) {
+				odp_packet_free(pkt);
+				continue;
+			}
+
+			print_pkts(thr, &pkt, 1);
+
+			if (args->appl.latency)
+				lat_record(&thr_args->lat, pkt, now);
 
-		odp_packet_free(pkt);
+			odp_packet_free(pkt);
+		}
 	}
 
 	return arg;
 }
 
+/**
+ * Sum of packets sent by the worker threads
+ */
+static uint64_t sent_pkts(int num_workers)
+{
+	uint64_t pkts = 0;
+	int i;
+
+	for (i = 0; i < num_workers; i++)
+		pkts += odp_atomic_load_u64(&args->thread[i].sent);
+
+	return pkts;
+}
+
 /**
  * printing verbose statistics
  *
@@ -599,8 +1030,7 @@ static void print_global_stats(int num_workers)
 
 	while (odp_thrmask_worker(&thrd_mask) == num_workers) {
 		if (args->appl.number != -1 &&
-		    odp_atomic_load_u64(&counters.cnt) >=
-		    (unsigned int)args->appl.number) {
+		    sent_pkts(num_workers) >= (unsigned int)args->appl.number) {
 			break;
 		}
 
@@ -621,7 +1051,7 @@ static void print_global_stats(int num_workers)
 			printf(" total receive(ICMP: %" PRIu64 ")\n", pkts);
 		}
 
-		pkts = odp_atomic_load_u64(&counters.seq);
+		pkts = sent_pkts(num_workers);
 		printf(" total sent: %" PRIu64 "\n", pkts);
 
 		if (args->appl.mode == APPL_MODE_UDP) {
@@ -635,6 +1065,83 @@ static void print_global_stats(int num_workers)
 	}
 }
 
+/**
+ * Print latency, loss and reordering of the streams
+ *
+ * Merges the histograms of the receive threads.
+ *
+ * @param num_tx       Number of send threads (streams)
+ * @param num_workers  Number of send and receive threads
+ */
+static void print_latency(int num_tx, int num_workers)
+{
+	static const double percentile[] = {50.0, 99.0, 99.9};
+	static lat_hist_t sum;
+	uint64_t sent, rx, reorder, lost;
+	uint64_t target, seen;
+	unsigned b, p;
+	int i, s;
+
+	memset(&sum, 0, sizeof(sum));
+	sum.min = UINT64_MAX;
+
+	for (i = num_tx; i < num_workers; i++) {
+		const lat_hist_t *hist = &args->thread[i].lat.hist;
+
+		if (hist->count == 0)
+			continue;
+
+		sum.count += hist->count;
+		sum.sum += hist->sum;
+		if (hist->min < sum.min)
+			sum.min = hist->min;
+		if (hist->max > sum.max)
+			sum.max = hist->max;
+		for (b = 0; b < LAT_HIST_BUCKETS; b++)
+			sum.bucket[b] += hist->bucket[b];
+	}
+
+	printf("\nStream    sent        received    lost        reordered\n");
+
+	for (s = 0; s < num_tx; s++) {
+		sent = odp_atomic_load_u64(&args->thread[s].sent);
+		rx = 0;
+		reorder = 0;
+
+		for (i = num_tx; i < num_workers; i++) {
+			rx += args->thread[i].lat.rx[s];
+			reorder += args->thread[i].lat.reorder[s];
+		}
+
+		lost = sent > rx ? sent - rx : 0;
+		printf("%-9i %-11" PRIu64 " %-11" PRIu64 " %-11" PRIu64
+		       " %" PRIu64 "\n", s, sent, rx, lost, reorder);
+	}
+
+	if (sum.count == 0) {
+		printf("\nNo stamped packets received\n");
+		return;
+	}
+
+	printf("\nLatency (ns): count %" PRIu64 ", min %" PRIu64 ", avg %"
+	       PRIu64, sum.count, sum.min, sum.sum / sum.count);
+
+	for (p = 0, seen = 0, b = 0;
+	     p < sizeof(percentile) / sizeof(percentile[0]); p++) {
+		target = (uint64_t)(sum.count * percentile[p] / 100.0);
+
+		for (; b < LAT_HIST_BUCKETS - 1; b++) {
+			if (seen + sum.bucket[b] > target)
+				break;
+			seen += sum.bucket[b];
+		}
+
+		printf(", p%g %" PRIu64, percentile[p], lat_hist_bucket_min(b));
+	}
+
+	printf(", max %" PRIu64 "\n", sum.max);
+}
+
 /**
  * ODP packet example main function
  */
@@ -642,7 +1149,7 @@ int main(int argc, char *argv[])
 {
 	odph_linux_pthread_t thread_tbl[MAX_WORKERS];
 	odp_pool_t pool;
-	int num_workers;
+	int num_workers, num_tx;
 	int i;
 	odp_shm_t shm;
 	odp_cpumask_t cpumask;
@@ -669,6 +1176,7 @@ int main(int argc, char *argv[])
 	odp_atomic_init_u64(&counters.udp, 0);
 	odp_atomic_init_u64(&counters.icmp, 0);
 	odp_atomic_init_u64(&counters.cnt, 0);
+	odp_atomic_init_u32(&counters.senders, 0);
 
 	/* Reserve memory for args from shared mem */
 	shm = odp_shm_reserve("shm_args", sizeof(args_t),
@@ -681,6 +1189,11 @@ int main(int argc, char *argv[])
 	}
 	memset(args, 0, sizeof(*args));
 
+	for (i = 0; i < MAX_WORKERS; i++) {
+		odp_atomic_init_u64(&args->thread[i].sent, 0);
+		args->thread[i].lat.hist.min = UINT64_MAX;
+	}
+
 	/* Parse and store the application arguments */
 	parse_args(argc, argv, &args->appl);
 
@@ -714,6 +1227,17 @@ int main(int argc, char *argv[])
 		}
 	}
 
+	/* Latency mode splits workers between sending and receiving */
+	num_tx = num_workers;
+	if (args->appl.latency) {
+		if (num_workers < 2) {
+			EXAMPLE_ERR("Need at least two worker threads\n");
+			exit(EXIT_FAILURE);
+		}
+		num_tx = num_workers / 2;
+	}
+	odp_atomic_store_u32(&counters.senders, num_tx);
+
 	/* Create packet pool */
 	odp_pool_param_init(&params);
 	params.pkt.seg_len = SHM_PKT_POOL_BUF_SIZE;
@@ -721,6 +1245,10 @@ int main(int argc, char *argv[])
 	params.pkt.num     = SHM_PKT_POOL_SIZE/SHM_PKT_POOL_BUF_SIZE;
 	params.type        = ODP_POOL_PACKET;
 
+	/* Room for a few bursts in flight per sender */
+	if (params.pkt.num < (uint32_t)(4 * num_workers * args->appl.burst))
+		params.pkt.num = 4 * num_workers * args->appl.burst;
+
 	pool = odp_pool_create("packet_pool", &params);
 
 	if (pool == ODP_POOL_INVALID) {
@@ -810,6 +1338,8 @@ int main(int argc, char *argv[])
 
 	} else {
 		int cpu = odp_cpumask_first(&cpumask);
+		uint64_t number = args->appl.number;
+
 		for (i = 0; i < num_workers; ++i) {
 			odp_cpumask_t thd_mask;
 			void *(*thr_run_func) (void *);
@@ -818,6 +1348,10 @@ int main(int argc, char *argv[])
 
 			if_idx = i % args->appl.if_count;
 
+			/* Streams go out of the first interface */
+			if (args->appl.latency)
+				if_idx = 0;
+
 			args->thread[i].pktio_dev = args->appl.if_names[if_idx];
 			tq = odp_queue_create("", ODP_QUEUE_TYPE_POLL, NULL);
 			if (tq == ODP_QUEUE_INVALID)
@@ -833,7 +1367,20 @@ int main(int argc, char *argv[])
 				abort();
 			args->thread[i].mode = args->appl.mode;
 
-			if (args->appl.mode == APPL_MODE_UDP) {
+			/* Split packet count and rate between the senders */
+			args->thread[i].quota = UINT64_MAX;
+			if (args->appl.number != -1)
+				args->thread[i].quota = number / num_tx +
+					((uint64_t)i < number % num_tx);
+			args->thread[i].rate = args->appl.rate / num_tx +
+				((uint64_t)i < args->appl.rate % num_tx);
+
+			if (args->appl.mode == APPL_MODE_UDP && i >= num_tx) {
+				thr_run_func = gen_recv_thread;
+			} else if (args->appl.mode == APPL_MODE_UDP &&
+				   args->appl.interval == 0) {
+				thr_run_func = gen_send_burst_thread;
+			} else if (args->appl.mode == APPL_MODE_UDP) {
 				thr_run_func = gen_send_thread;
 			} else if (args->appl.mode == APPL_MODE_RCV) {
 				thr_run_func = gen_recv_thread;
@@ -863,6 +1410,9 @@ int main(int argc, char *argv[])
 	/* Master thread waits for other threads to exit */
 	odph_linux_pthread_join(thread_tbl, num_workers);
 
+	if (args->appl.latency)
+		print_latency(num_tx, num_workers);
+
 	free(args->appl.if_names);
 	free(args->appl.if_str);
 	printf("Exit\n\n");
@@ -899,6 +1449,11 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 		{"count", required_argument, NULL, 'n'},
 		{"timeout", required_argument, NULL, 't'},
 		{"interval", required_argument, NULL, 'i'},
+		{"burst", required_argument, NULL, 'B'},
+		{"rate", required_argument, NULL, 'r'},
+		{"ports", required_argument, NULL, 'o'},
+		{"flows", required_argument, NULL, 'f'},
+		{"latency", no_argument, NULL, 'L'},
 		{"help", no_argument, NULL, 'h'},
 		{NULL, 0, NULL, 0}
 	};
@@ -907,9 +1462,14 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 	appl_args->number = -1;
 	appl_args->payload = 56;
 	appl_args->timeout = -1;
+	appl_args->burst = DEFAULT_PKT_BURST;
+	appl_args->srcip_num = 1;
+	appl_args->dstip_num = 1;
+	appl_args->srcport_num = 1;
+	appl_args->dstport_num = 1;
 
 	while (1) {
-		opt = getopt_long(argc, argv, "+I:a:b:s:d:p:i:m:n:t:w:c:h",
+		opt = getopt_long(argc, argv, "+I:a:b:s:d:p:i:m:n:t:w:c:B:r:o:f:Lh",
 				  longopts, &long_index);
 		if (opt == -1)
 			break;	/* No more options */
@@ -1028,6 +1588,47 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 			appl_args->interval = atoi(optarg);
 			break;
 
+		case 'B':
+			appl_args->burst = atoi(optarg);
+			if (appl_args->burst < 1 ||
+			    appl_args->burst > MAX_PKT_BURST) {
+				EXAMPLE_ERR("burst must be 1..%i\n",
+					    MAX_PKT_BURST);
+				exit(EXIT_FAILURE);
+			}
+			break;
+
+		case 'r':
+			appl_args->rate = strtoull(optarg, NULL, 0);
+			break;
+
+		case 'o':
+			if (sscanf(optarg, "%u,%u", &appl_args->srcport,
+				   &appl_args->dstport) != 2 ||
+			    appl_args->srcport > 0xffff ||
+			    appl_args->dstport > 0xffff) {
+				EXAMPLE_ERR("wrong ports:%s\n", optarg);
+				exit(EXIT_FAILURE);
+			}
+			break;
+
+		case 'f':
+			if (sscanf(optarg, "%u,%u,%u,%u",
+				   &appl_args->srcip_num, &appl_args->dstip_num,
+				   &appl_args->srcport_num,
+				   &appl_args->dstport_num) != 4 ||
+			    !appl_args->srcip_num || !appl_args->dstip_num ||
+			    !appl_args->srcport_num ||
+			    !appl_args->dstport_num) {
+				EXAMPLE_ERR("wrong flows:%s\n", optarg);
+				exit(EXIT_FAILURE);
+			}
+			break;
+
+		case 'L':
+			appl_args->latency = 1;
+			break;
+
 		case 'h':
 			usage(argv[0]);
 			exit(EXIT_SUCCESS);
@@ -1043,6 +1644,20 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 		exit(EXIT_FAILURE);
 	}
 
+	if (appl_args->latency &&
+	    (appl_args->mode != APPL_MODE_UDP || appl_args->interval != 0 ||
+	     appl_args->payload < (int)sizeof(gen_stamp_t))) {
+		EXAMPLE_ERR("latency needs udp mode, interval 0 and %i bytes "
+			    "payload\n", (int)sizeof(gen_stamp_t));
+		exit(EXIT_FAILURE);
+	}
+
+	if (appl_args->srcport + appl_args->srcport_num > 0x10000 ||
+	    appl_args->dstport + appl_args->dstport_num > 0x10000) {
+		EXAMPLE_ERR("port range exceeds 65535\n");
+		exit(EXIT_FAILURE);
+	}
+
 	optind = 1;		/* reset 'extern optind' from the getopt lib */
 }
 
@@ -1080,6 +1695,17 @@ static void print_info(char *progname, appl_args_t *appl_args)
 		PRINT_APPL_MODE(APPL_MODE_PING);
 	else
 		PRINT_APPL_MODE(APPL_MODE_RCV);
+
+	if (appl_args->mode == APPL_MODE_UDP && appl_args->interval == 0)
+		printf("Burst:           %i\n"
+		       "Rate (pps):      %" PRIu64 "\n"
+		       "Flows:           %u src ip, %u dst ip, "
+		       "%u src port, %u dst port\n",
+		       appl_args->burst, appl_args->rate,
+		       appl_args->srcip_num, appl_args->dstip_num,
+		       appl_args->srcport_num, appl_args->dstport_num);
+	if (appl_args->latency)
+		printf("Latency:         yes\n");
 	printf("\n\n");
 	fflush(NULL);
 }
@@ -1118,14 +1744,32 @@ static void usage(char *progname)
 	       "                        ODP_PKTIO_DISABLE_SOCKET_MMSG\n"
 	       " can be used to advanced pkt I/O selection for linux-generic\n"
 	       "  -p, --packetsize payload length of the packets\n"
-	       "  -t, --timeout only for ping mode, wait ICMP reply timeout seconds\n"
+	       "  -t, --timeout ping mode: wait ICMP reply timeout seconds\n"
+	       "                latency mode: wait for packets in flight seconds\n"
 	       "  -i, --interval wait interval ms between sending each packet\n"
 	       "                 default is 1000ms. 0 for flood mode\n"
 	       "  -w, --workers specify number of workers need to be assigned to application\n"
 	       "	         default is to assign all\n"
 	       "  -n, --count the number of packets to be send\n"
 	       "  -c, --cpumask to set on cores\n"
-	       "\n", NO_PATH(progname), NO_PATH(progname)
+	       "\n"
+	       "  UDP mode with interval 0 sends from a packet template in bursts:\n"
+	       "  -B, --burst packets per send burst (default %i, max %i)\n"
+	       "  -r, --rate packets per second of all workers, 0: no pacing (default)\n"
+	       "  -o, --ports udp src and dst port: <sport>,<dport> (default 0,0)\n"
+	       "  -f, --flows number of src ips, dst ips, src ports and dst ports\n"
+	       "              counted up from --srcip, --dstip and --ports and\n"
+	       "              picked at random per packet: <sip>,<dip>,<sport>,<dport>\n"
+	       "              (default 1,1,1,1)\n"
+	       "  -L, --latency half of the workers send time stamped packets out\n"
+	       "                of the first interface, the others receive them\n"
+	       "                from all interfaces. Prints latency percentiles,\n"
+	       "                loss and reordering when the count is sent and\n"
+	       "                --timeout seconds (default 1) passed without\n"
+	       "                packets. Latency is one-way or round-trip,\n"
+	       "                depending on the path back to the generator.\n"
+	       "\n", NO_PATH(progname), NO_PATH(progname),
+	       DEFAULT_PKT_BURST, MAX_PKT_BURST
 	      );
 }
 /**
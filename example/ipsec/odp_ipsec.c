@@ -26,6 +26,7 @@
 #include <odp/helper/ip.h>
 #include <odp/helper/icmp.h>
 #include <odp/helper/ipsec.h>
+#include <odp/helper/pipeline.h>
 
 #include <odp_ipsec_misc.h>
 #include <odp_ipsec_sa_db.h>
@@ -47,6 +48,7 @@ typedef struct {
 	crypto_api_mode_e mode;	/**< Crypto API preferred mode */
 	odp_pool_t pool;	/**< Buffer pool for packet IO */
 	char *if_str;		/**< Storage for interface names */
+	int pipeline;		/**< Process packets in pipeline stages */
 } appl_args_t;
 
 /**
@@ -83,9 +85,6 @@ static odp_pool_t pkt_pool = ODP_POOL_INVALID;
 
 static odp_pool_t out_pool = ODP_POOL_INVALID;
 
-/** ATOMIC queue for IPsec sequence number assignment */
-static odp_queue_t seqnumq;
-
 /** ORDERED queue (eventually) for per packet crypto API completion events */
 static odp_queue_t completionq;
 
@@ -133,12 +132,13 @@ typedef struct {
 	/* Input only */
 	uint32_t src_ip;         /**< SA source IP address */
 	uint32_t dst_ip;         /**< SA dest IP address */
+	ipsec_cache_entry_t *entry; /**< SA anti-replay windows */
 
 	/* Output only */
 	odp_crypto_op_params_t params;  /**< Parameters for crypto call */
-	uint32_t *ah_seq;               /**< AH sequence number location */
-	uint32_t *esp_seq;              /**< ESP sequence number location */
-	uint16_t *tun_hdr_id;           /**< Tunnel header ID > */
+	odp_atomic_u32_t *ah_seq;       /**< AH sequence number location */
+	odp_atomic_u32_t *esp_seq;      /**< ESP sequence number location */
+	odp_atomic_u32_t *tun_hdr_id;   /**< Tunnel header ID > */
 } ipsec_ctx_t;
 
 /**
@@ -294,7 +294,6 @@ void ipsec_init_pre(void)
 	 * Create queues
 	 *
 	 *  - completion queue (should eventually be ORDERED)
-	 *  - sequence number queue (must be ATOMIC)
 	 */
 	odp_queue_param_init(&qparam);
 	qparam.sched.prio  = ODP_SCHED_PRIO_HIGHEST;
@@ -309,18 +308,6 @@ void ipsec_init_pre(void)
 		exit(EXIT_FAILURE);
 	}
 
-	qparam.sched.prio  = ODP_SCHED_PRIO_HIGHEST;
-	qparam.sched.sync  = ODP_SCHED_SYNC_ATOMIC;
-	qparam.sched.group = ODP_SCHED_GROUP_ALL;
-
-	seqnumq = queue_create("seqnum",
-			       ODP_QUEUE_TYPE_SCHED,
-			       &qparam);
-	if (ODP_QUEUE_INVALID == seqnumq) {
-		EXAMPLE_ERR("Error: sequence number queue creation failed\n");
-		exit(EXIT_FAILURE);
-	}
-
 	/* Create output buffer pool */
 	odp_pool_param_init(&params);
 	params.pkt.seg_len = SHM_OUT_POOL_BUF_SIZE;
@@ -649,6 +636,14 @@ pkt_disposition_e do_ipsec_in_classify(odp_packet_t pkt,
 	if (!entry)
 		return PKT_CONTINUE;
 
+	/* Drop replayed and too old packets before crypto */
+	if (ah && ipsec_replay_check(&entry->state.ah_replay,
+				     odp_be_to_cpu_32(ah->seq_no)))
+		return PKT_DROP;
+	if (esp && ipsec_replay_check(&entry->state.esp_replay,
+				      odp_be_to_cpu_32(esp->seq_no)))
+		return PKT_DROP;
+
 	/* Account for configured ESP IV length in packet */
 	hdr_len += entry->esp.iv_len;
 
@@ -669,6 +664,7 @@ pkt_disposition_e do_ipsec_in_classify(odp_packet_t pkt,
 	ctx->ipsec.trl_len = 0;
 	ctx->ipsec.src_ip = entry->src_ip;
 	ctx->ipsec.dst_ip = entry->dst_ip;
+	ctx->ipsec.entry = entry;
 
 	/*If authenticating, zero the mutable fields build the request */
 	if (ah) {
@@ -726,6 +722,19 @@ pkt_disposition_e do_ipsec_in_finish(odp_packet_t pkt,
 	}
 	ip = (odph_ipv4hdr_t *)odp_packet_l3_ptr(pkt, NULL);
 
+	/*
+	 * Authentic packet, update anti-replay windows
+	 */
+	if (ctx->ipsec.esp_offset) {
+		uint8_t *buf = odp_packet_data(pkt);
+		odph_esphdr_t *esp;
+
+		esp = (odph_esphdr_t *)(ctx->ipsec.esp_offset + buf);
+		if (ipsec_replay_update(&ctx->ipsec.entry->state.esp_replay,
+					odp_be_to_cpu_32(esp->seq_no)))
+			return PKT_DROP;
+	}
+
 	/*
 	 * Finish auth
 	 */
@@ -734,6 +743,9 @@ pkt_disposition_e do_ipsec_in_finish(odp_packet_t pkt,
 		odph_ahhdr_t *ah;
 
 		ah = (odph_ahhdr_t *)(ctx->ipsec.ah_offset + buf);
+		if (ipsec_replay_update(&ctx->ipsec.entry->state.ah_replay,
+					odp_be_to_cpu_32(ah->seq_no)))
+			return PKT_DROP;
 		ip->proto = ah->next_header;
 	}
 
@@ -791,8 +803,7 @@ pkt_disposition_e do_ipsec_in_finish(odp_packet_t pkt,
  *
  * Verify the outbound packet has a match in the IPsec cache,
  * if so issue prepend IPsec headers and prepare parameters
- * for crypto API call.  Post the packet to ATOMIC queue so
- * that sequence numbers can be applied in packet order as
+ * for crypto API call.  Sequence numbers are applied as
  * the next processing step.
  *
  * @param pkt   Packet to classify
@@ -935,51 +946,64 @@ pkt_disposition_e do_ipsec_out_classify(odp_packet_t pkt,
 }
 
 /**
- * Packet Processing - Output IPsec packet sequence number assignment
+ * Assign IPsec sequence numbers and tunnel header ID of an output packet
  *
- * Assign the necessary sequence numbers and then issue the crypto API call
+ * Per SA counters are atomic, any worker may number packets of an SA.
+ * Packets get their numbers in the order of the calls.
  *
  * @param pkt  Packet to handle
  * @param ctx  Packet process context
- *
- * @return PKT_CONTINUE if done else PKT_POSTED
  */
 static
-pkt_disposition_e do_ipsec_out_seq(odp_packet_t pkt,
-				   pkt_ctx_t *ctx,
-				   odp_crypto_op_result_t *result)
+void ipsec_out_seq_assign(odp_packet_t pkt, pkt_ctx_t *ctx)
 {
 	uint8_t *buf = odp_packet_data(pkt);
-	odp_bool_t posted = 0;
 
-	/* We were dispatched from atomic queue, assign sequence numbers */
 	if (ctx->ipsec.ah_offset) {
 		odph_ahhdr_t *ah;
 
 		ah = (odph_ahhdr_t *)(ctx->ipsec.ah_offset + buf);
-		ah->seq_no = odp_cpu_to_be_32((*ctx->ipsec.ah_seq)++);
+		ah->seq_no = odp_cpu_to_be_32(
+			odp_atomic_fetch_inc_u32(ctx->ipsec.ah_seq));
 	}
 	if (ctx->ipsec.esp_offset) {
 		odph_esphdr_t *esp;
 
 		esp = (odph_esphdr_t *)(ctx->ipsec.esp_offset + buf);
-		esp->seq_no = odp_cpu_to_be_32((*ctx->ipsec.esp_seq)++);
+		esp->seq_no = odp_cpu_to_be_32(
+			odp_atomic_fetch_inc_u32(ctx->ipsec.esp_seq));
 	}
 	if (ctx->ipsec.tun_hdr_offset) {
 		odph_ipv4hdr_t *ip;
-		int ret;
+		uint16_t id;
 
 		ip = (odph_ipv4hdr_t *)(ctx->ipsec.tun_hdr_offset + buf);
-		ip->id = odp_cpu_to_be_16((*ctx->ipsec.tun_hdr_id)++);
-		if (!ip->id) {
-			/* re-init tunnel hdr id */
-			ret = odp_random_data((uint8_t *)ctx->ipsec.tun_hdr_id,
-					      sizeof(*ctx->ipsec.tun_hdr_id),
-					      1);
-			if (ret != sizeof(*ctx->ipsec.tun_hdr_id))
-				abort();
-		}
+		id = odp_atomic_fetch_inc_u32(ctx->ipsec.tun_hdr_id);
+		/* skip zero on wrap around */
+		if (!id)
+			id = odp_atomic_fetch_inc_u32(ctx->ipsec.tun_hdr_id);
+		ip->id = odp_cpu_to_be_16(id);
 	}
+}
+
+/**
+ * Packet Processing - Output IPsec packet sequence number assignment
+ *
+ * Assign the necessary sequence numbers and then issue the crypto API call
+ *
+ * @param pkt  Packet to handle
+ * @param ctx  Packet process context
+ *
+ * @return PKT_CONTINUE if done else PKT_POSTED
+ */
+static
+pkt_disposition_e do_ipsec_out_seq(odp_packet_t pkt,
+				   pkt_ctx_t *ctx,
+				   odp_crypto_op_result_t *result)
+{
+	odp_bool_t posted = 0;
+
+	ipsec_out_seq_assign(pkt, ctx);
 
 	/* Issue crypto request */
 	if (odp_crypto_operation(&ctx->ipsec.params,
@@ -1028,12 +1052,11 @@ pkt_disposition_e do_ipsec_out_finish(odp_packet_t pkt,
 /**
  * Packet IO worker thread
  *
- * Loop calling odp_schedule to obtain packets from one of three sources,
+ * Loop calling odp_schedule to obtain packets from one of two sources,
  * and continue processing the packet based on the state stored in its
  * per packet context.
  *
  *  - Input interfaces (i.e. new work)
- *  - Sequence number assignment queue
  *  - Per packet crypto API completion queue
  *
  * @param arg  Required by "odph_linux_pthread_create", unused
@@ -1067,16 +1090,12 @@ void *pktio_thread(void *arg EXAMPLE_UNUSED)
 		/* Determine new work versus completion or sequence number */
 		if (ODP_EVENT_PACKET == odp_event_type(ev)) {
 			pkt = odp_packet_from_event(ev);
-			if (seqnumq == dispatchq) {
-				ctx = get_pkt_ctx_from_pkt(pkt);
-			} else {
-				ctx = alloc_pkt_ctx(pkt);
-				if (!ctx) {
-					odp_packet_free(pkt);
-					continue;
-				}
-				ctx->state = PKT_STATE_INPUT_VERIFY;
+			ctx = alloc_pkt_ctx(pkt);
+			if (!ctx) {
+				odp_packet_free(pkt);
+				continue;
 			}
+			ctx->state = PKT_STATE_INPUT_VERIFY;
 		} else if (ODP_EVENT_CRYPTO_COMPL == odp_event_type(ev)) {
 			odp_crypto_compl_t compl;
 
@@ -1139,10 +1158,11 @@ void *pktio_thread(void *arg EXAMPLE_UNUSED)
 							   &skip);
 				if (odp_unlikely(skip)) {
 					ctx->state = PKT_STATE_TRANSMIT;
-				} else {
+				} else if (PKT_POSTED == rc) {
+					/* Atomic per SA sequence numbers,
+					 * continue in this thread */
 					ctx->state = PKT_STATE_IPSEC_OUT_SEQ;
-					if (odp_queue_enq(seqnumq, ev))
-						rc = PKT_DROP;
+					rc = PKT_CONTINUE;
 				}
 				break;
 
@@ -1196,6 +1216,299 @@ void *pktio_thread(void *arg EXAMPLE_UNUSED)
 	return NULL;
 }
 
+/**
+ * Pipeline mode stages
+ *
+ * The processing steps of pktio_thread() split over worker stages:
+ *
+ *  - RX:     poll the input queues, verify packets
+ *  - IN:     input IPsec, route lookup and output classification
+ *  - SEQ:    sequence number assignment, atomic per SA to number packets
+ *            in packet order
+ *  - CRYPTO: output crypto, ordered
+ *  - TX:     send to the output queues
+ *
+ * Crypto runs in SYNC mode within the IN and CRYPTO stages.
+ */
+enum {
+	STAGE_RX = 0,
+	STAGE_IN,
+	STAGE_SEQ,
+	STAGE_CRYPTO,
+	STAGE_TX,
+	NUM_STAGES
+};
+
+#define PIPELINE_BURST 32  /**< Packets per stage function call */
+
+/**
+ * Drop packets and their contexts
+ */
+static
+void drop_pkts(odp_event_t ev[], int num)
+{
+	odp_packet_t pkt;
+	int i;
+
+	for (i = 0; i < num; i++) {
+		pkt = odp_packet_from_event(ev[i]);
+		free_pkt_ctx(get_pkt_ctx_from_pkt(pkt));
+		odp_packet_free(pkt);
+	}
+}
+
+/**
+ * Forward packets to a stage, drop those not forwarded on stop
+ */
+static
+void forward_pkts(odph_pipeline_ctx_t *pctx, int stage,
+		  odp_event_t ev[], int num)
+{
+	int sent;
+
+	if (num == 0)
+		return;
+
+	sent = odph_pipeline_forward(pctx, stage, ev, num);
+	if (sent < 0)
+		sent = 0;
+	if (sent < num)
+		drop_pkts(&ev[sent], num - sent);
+}
+
+/**
+ * SA of an output packet, flow of the SEQ stage
+ */
+static
+uint32_t seq_flow(odp_event_t ev)
+{
+	pkt_ctx_t *ctx = get_pkt_ctx_from_pkt(odp_packet_from_event(ev));
+
+	/* Sequence numbers are per IPsec cache entry */
+	return (uint32_t)((uintptr_t)ctx->ipsec.esp_seq >> 6);
+}
+
+/**
+ * RX stage: poll input queues, allocate contexts and verify packets
+ */
+static
+int rx_stage(odph_pipeline_ctx_t *pctx, odp_event_t ev[],
+	     int num EXAMPLE_UNUSED)
+{
+	static int next_queue;
+	odp_packet_t pkt;
+	pkt_ctx_t *ctx;
+	int received = 0;
+	int fwd = 0;
+	int i, ret;
+
+	for (i = 0; i < num_polled_queues && received < PIPELINE_BURST; i++) {
+		if (next_queue >= num_polled_queues)
+			next_queue = 0;
+
+		ret = odp_queue_deq_multi(poll_queues[next_queue++],
+					  &ev[received],
+					  PIPELINE_BURST - received);
+		if (ret > 0)
+			received += ret;
+	}
+
+	for (i = 0; i < received; i++) {
+		pkt = odp_packet_from_event(ev[i]);
+		ctx = alloc_pkt_ctx(pkt);
+		if (!ctx) {
+			odp_packet_free(pkt);
+			continue;
+		}
+
+		if (PKT_DROP == do_input_verify(pkt, ctx)) {
+			free_pkt_ctx(ctx);
+			odp_packet_free(pkt);
+			continue;
+		}
+
+		ev[fwd++] = ev[i];
+	}
+
+	forward_pkts(pctx, STAGE_IN, ev, fwd);
+
+	return received;
+}
+
+/**
+ * IN stage: input IPsec, route and output IPsec classification
+ */
+static
+int in_stage(odph_pipeline_ctx_t *pctx, odp_event_t ev[], int num)
+{
+	odp_event_t seq_ev[num];
+	int num_seq = 0;
+	int num_tx = 0;
+	int i;
+
+	for (i = 0; i < num; i++) {
+		odp_packet_t pkt = odp_packet_from_event(ev[i]);
+		pkt_ctx_t *ctx = get_pkt_ctx_from_pkt(pkt);
+		odp_crypto_op_result_t result;
+		pkt_disposition_e rc;
+		odp_bool_t skip = FALSE;
+
+		/* SYNC crypto completes in the call */
+		rc = do_ipsec_in_classify(pkt, ctx, &skip, &result);
+		if (PKT_CONTINUE == rc && !skip)
+			rc = do_ipsec_in_finish(pkt, ctx, &result);
+		if (PKT_CONTINUE == rc)
+			rc = do_route_fwd_db(pkt, ctx);
+		if (PKT_CONTINUE == rc)
+			rc = do_ipsec_out_classify(pkt, ctx, &skip);
+
+		if (PKT_DROP == rc) {
+			free_pkt_ctx(ctx);
+			odp_packet_free(pkt);
+		} else if (skip) {
+			ev[num_tx++] = ev[i];
+		} else {
+			seq_ev[num_seq++] = ev[i];
+		}
+	}
+
+	forward_pkts(pctx, STAGE_SEQ, seq_ev, num_seq);
+	forward_pkts(pctx, STAGE_TX, ev, num_tx);
+
+	return 0;
+}
+
+/**
+ * SEQ stage: assign sequence numbers, packets of an SA one at a time
+ */
+static
+int seq_stage(odph_pipeline_ctx_t *pctx, odp_event_t ev[], int num)
+{
+	odp_packet_t pkt;
+	int i;
+
+	for (i = 0; i < num; i++) {
+		pkt = odp_packet_from_event(ev[i]);
+		ipsec_out_seq_assign(pkt, get_pkt_ctx_from_pkt(pkt));
+	}
+
+	forward_pkts(pctx, STAGE_CRYPTO, ev, num);
+
+	return 0;
+}
+
+/**
+ * CRYPTO stage: output crypto, packets leave in sequence number order
+ */
+static
+int crypto_stage(odph_pipeline_ctx_t *pctx, odp_event_t ev[], int num)
+{
+	int fwd = 0;
+	int i;
+
+	for (i = 0; i < num; i++) {
+		odp_packet_t pkt = odp_packet_from_event(ev[i]);
+		pkt_ctx_t *ctx = get_pkt_ctx_from_pkt(pkt);
+		odp_crypto_op_result_t result;
+		odp_bool_t posted = 0;
+
+		if (odp_crypto_operation(&ctx->ipsec.params, &posted,
+					 &result))
+			abort();
+
+		if (PKT_DROP == do_ipsec_out_finish(pkt, ctx, &result)) {
+			free_pkt_ctx(ctx);
+			odp_packet_free(pkt);
+			continue;
+		}
+
+		ev[fwd++] = ev[i];
+	}
+
+	forward_pkts(pctx, STAGE_TX, ev, fwd);
+
+	return 0;
+}
+
+/**
+ * TX stage: send packets to their output queues
+ */
+static
+int tx_stage(odph_pipeline_ctx_t *pctx EXAMPLE_UNUSED, odp_event_t ev[],
+	     int num)
+{
+	static unsigned long pkt_cnt;
+	odp_packet_t pkt;
+	pkt_ctx_t *ctx;
+	int i;
+
+	for (i = 0; i < num; i++) {
+		pkt = odp_packet_from_event(ev[i]);
+		ctx = get_pkt_ctx_from_pkt(pkt);
+
+		if (odp_queue_enq(ctx->outq, ev[i])) {
+			odp_packet_free(pkt);
+		} else if (odp_unlikely(pkt_cnt++ % 1000 == 0)) {
+			printf("  [%02i] pkt_cnt:%lu\n", odp_thread_id(),
+			       pkt_cnt);
+			fflush(NULL);
+		}
+
+		free_pkt_ctx(ctx);
+	}
+
+	return 0;
+}
+
+/**
+ * Create the pipeline of pipeline mode
+ *
+ * @param cpumask      Worker CPUs
+ * @param num_workers  Number of worker CPUs
+ *
+ * @return Pipeline, NULL on failure
+ */
+static
+odph_pipeline_t *create_pipeline(const odp_cpumask_t *cpumask,
+				 int num_workers)
+{
+	odph_pipeline_param_t param;
+	int workers = (num_workers - 3) / 2;
+	int s;
+
+	if (workers < 1)
+		workers = 1;
+
+	odph_pipeline_param_init(&param);
+	param.num_stages = NUM_STAGES;
+	param.cpumask    = cpumask;
+
+	param.stage[STAGE_RX].name = "rx";
+	param.stage[STAGE_RX].fn   = rx_stage;
+
+	param.stage[STAGE_IN].name        = "in";
+	param.stage[STAGE_IN].fn          = in_stage;
+	param.stage[STAGE_IN].num_workers = workers;
+
+	param.stage[STAGE_SEQ].name = "seq";
+	param.stage[STAGE_SEQ].fn   = seq_stage;
+	param.stage[STAGE_SEQ].sync = ODPH_PIPELINE_ATOMIC;
+	param.stage[STAGE_SEQ].flow = seq_flow;
+
+	param.stage[STAGE_CRYPTO].name        = "crypto";
+	param.stage[STAGE_CRYPTO].fn          = crypto_stage;
+	param.stage[STAGE_CRYPTO].num_workers = workers;
+	param.stage[STAGE_CRYPTO].sync        = ODPH_PIPELINE_ORDERED;
+
+	param.stage[STAGE_TX].name = "tx";
+	param.stage[STAGE_TX].fn   = tx_stage;
+
+	for (s = 0; s < NUM_STAGES; s++)
+		param.stage[s].burst = PIPELINE_BURST;
+
+	return odph_pipeline_create("ipsec_pipeline", &param);
+}
+
 /**
  * ODP ipsec example main function
  */
@@ -1203,6 +1516,7 @@ int
 main(int argc, char *argv[])
 {
 	odph_linux_pthread_t thread_tbl[MAX_WORKERS];
+	odph_pipeline_t *pipeline = NULL;
 	int num_workers;
 	int i;
 	int stream_count;
@@ -1254,6 +1568,12 @@ main(int argc, char *argv[])
 	/* Parse and store the application arguments */
 	parse_args(argc, argv, &args->appl);
 
+	/* Pipeline stages poll the input queues and use SYNC crypto */
+	if (args->appl.pipeline) {
+		queue_create = polled_odp_queue_create;
+		args->appl.mode = CRYPTO_API_SYNC;
+	}
+
 	/* Print both system and application information */
 	print_info(NO_PATH(argv[0]), &args->appl);
 
@@ -1322,8 +1642,17 @@ main(int argc, char *argv[])
 	/*
 	 * Create and init worker threads
 	 */
-	odph_linux_pthread_create(thread_tbl, &cpumask,
-				  pktio_thread, NULL, ODP_THREAD_WORKER);
+	if (args->appl.pipeline) {
+		pipeline = create_pipeline(&cpumask, num_workers);
+		if (pipeline == NULL || odph_pipeline_start(pipeline)) {
+			EXAMPLE_ERR("Error: pipeline start failed.\n");
+			exit(EXIT_FAILURE);
+		}
+	} else {
+		odph_linux_pthread_create(thread_tbl, &cpumask,
+					  pktio_thread, NULL,
+					  ODP_THREAD_WORKER);
+	}
 
 	/*
 	 * If there are streams attempt to verify them else
@@ -1336,6 +1665,16 @@ main(int argc, char *argv[])
 			sleep(1);
 		} while (!done);
 		printf("All received\n");
+
+		if (pipeline) {
+			odph_pipeline_stop(pipeline);
+			odph_pipeline_print(pipeline);
+			odph_pipeline_destroy(pipeline);
+		}
+	} else if (pipeline) {
+		/* Stages run until the application is killed */
+		for (;;)
+			pause();
 	} else {
 		odph_linux_pthread_join(thread_tbl, num_workers);
 	}
@@ -1373,6 +1712,7 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 		{"esp", required_argument, NULL, 'e'},		/* return 'e' */
 		{"tunnel", required_argument, NULL, 't'},       /* return 't' */
 		{"stream", required_argument, NULL, 's'},	/* return 's' */
+		{"pipeline", no_argument, NULL, 'P'},		/* return 'P' */
 		{"help", no_argument, NULL, 'h'},		/* return 'h' */
 		{NULL, 0, NULL, 0}
 	};
@@ -1382,7 +1722,7 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 	appl_args->mode = 0;  /* turn off async crypto API by default */
 
 	while (!rc) {
-		opt = getopt_long(argc, argv, "+c:i:m:h:r:p:a:e:t:s:",
+		opt = getopt_long(argc, argv, "+c:i:m:h:r:p:a:e:t:s:P",
 				  longopts, &long_index);
 
 		if (-1 == opt)
@@ -1461,6 +1801,10 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 			rc = create_stream_db_entry(optarg);
 			break;
 
+		case 'P':
+			appl_args->pipeline = 1;
+			break;
+
 		case 'h':
 			usage(argv[0]);
 			exit(EXIT_SUCCESS);
@@ -1560,6 +1904,9 @@ static void usage(char *progname)
 	       "\n"
 	       "Optional OPTIONS\n"
 	       "  -c, --count <number> CPU count.\n"
+	       "  -P, --pipeline       Process packets in a pipeline of worker\n"
+	       "                       stages instead of run to completion.\n"
+	       "                       Uses poll queues and SYNC crypto mode.\n"
 	       "  -h, --help           Display help and exit.\n"
 	       " environment variables: ODP_PKTIO_DISABLE_NETMAP\n"
 	       "                        ODP_PKTIO_DISABLE_SOCKET_MMAP\n"
@@ -18,6 +18,20 @@
 /** Global pointer to ipsec_cache db */
 ipsec_cache_t *ipsec_cache;
 
+/** Hash bucket of an SPI */
+static inline uint32_t spi_hash(uint32_t spi)
+{
+	return (spi ^ (spi >> 16)) & (IPSEC_CACHE_HASH_SIZE - 1);
+}
+
+/** Hash bucket of an output address pair */
+static inline uint32_t addr_hash(uint32_t src_ip, uint32_t dst_ip)
+{
+	uint32_t hash = src_ip * 0x9e3779b1 ^ dst_ip;
+
+	return (hash ^ (hash >> 16)) & (IPSEC_CACHE_HASH_SIZE - 1);
+}
+
 void init_ipsec_cache(void)
 {
 	odp_shm_t shm;
@@ -137,38 +151,52 @@ int create_ipsec_cache_entry(sa_db_entry_t *cipher_sa,
 		memcpy(&entry->ah.key, &auth_sa->key, sizeof(ipsec_key_t));
 	}
 
+	odp_atomic_init_u32(&entry->state.tun_hdr_id, 0);
 	if (tun) {
 		entry->tun_src_ip = tun->tun_src_ip;
 		entry->tun_dst_ip = tun->tun_dst_ip;
 		mode = IPSEC_SA_MODE_TUNNEL;
 
 		int ret;
+		uint16_t id;
 
 		if (!in) {
 			/* init tun hdr id */
-			ret = odp_random_data((uint8_t *)
-					      &entry->state.tun_hdr_id,
-					      sizeof(entry->state.tun_hdr_id),
-					      1);
-			if (ret != sizeof(entry->state.tun_hdr_id))
+			ret = odp_random_data((uint8_t *)&id, sizeof(id), 1);
+			if (ret != sizeof(id))
 				return -1;
+			odp_atomic_init_u32(&entry->state.tun_hdr_id, id);
 		}
 	}
 	entry->mode = mode;
 
 	/* Initialize state */
-	entry->state.esp_seq = 0;
-	entry->state.ah_seq = 0;
+	odp_atomic_init_u32(&entry->state.esp_seq, 0);
+	odp_atomic_init_u32(&entry->state.ah_seq, 0);
+	memset(&entry->state.esp_replay, 0, sizeof(ipsec_replay_t));
+	memset(&entry->state.ah_replay, 0, sizeof(ipsec_replay_t));
 	entry->state.session = session;
 
-	/* Add entry to the appropriate list */
+	/* Add entry to the appropriate hash chains, newest first */
 	ipsec_cache->index++;
 	if (in) {
-		entry->next = ipsec_cache->in_list;
-		ipsec_cache->in_list = entry;
+		if (entry->esp.alg) {
+			uint32_t idx = spi_hash(entry->esp.spi);
+
+			entry->next = ipsec_cache->esp_hash[idx];
+			ipsec_cache->esp_hash[idx] = entry;
+		}
+		if (entry->ah.alg) {
+			uint32_t idx = spi_hash(entry->ah.spi);
+
+			entry->ah_next = ipsec_cache->ah_hash[idx];
+			ipsec_cache->ah_hash[idx] = entry;
+		}
 	} else {
-		entry->next = ipsec_cache->out_list;
-		ipsec_cache->out_list = entry;
+		uint32_t idx = addr_hash(entry->src_ip, entry->dst_ip);
+
+		entry->next = ipsec_cache->out_hash[idx];
+		ipsec_cache->out_hash[idx] = entry;
 	}
 
 	return 0;
@@ -179,10 +207,19 @@ ipsec_cache_entry_t *find_ipsec_cache_entry_in(uint32_t src_ip,
 					       odph_ahhdr_t *ah,
 					       odph_esphdr_t *esp)
 {
-	ipsec_cache_entry_t *entry = ipsec_cache->in_list;
+	ipsec_cache_entry_t *entry;
 
-	/* Look for a hit */
-	for (; NULL != entry; entry = entry->next) {
+	/* Look for a hit on the ESP or else AH SPI hash chain */
+	if (esp)
+		entry = ipsec_cache->esp_hash[spi_hash(
+					odp_be_to_cpu_32(esp->spi))];
+	else if (ah)
+		entry = ipsec_cache->ah_hash[spi_hash(
+					odp_be_to_cpu_32(ah->spi))];
+	else
+		return NULL;
+
+	for (; NULL != entry; entry = esp ? entry->next : entry->ah_next) {
 		if ((entry->src_ip != src_ip) || (entry->dst_ip != dst_ip))
 			if ((entry->tun_src_ip != src_ip) ||
 			    (entry->tun_dst_ip != dst_ip))
@@ -205,12 +242,88 @@ ipsec_cache_entry_t *find_ipsec_cache_entry_out(uint32_t src_ip,
 						uint32_t dst_ip,
 						uint8_t proto EXAMPLE_UNUSED)
 {
-	ipsec_cache_entry_t *entry = ipsec_cache->out_list;
+	ipsec_cache_entry_t *entry;
 
 	/* Look for a hit */
+	entry = ipsec_cache->out_hash[addr_hash(src_ip, dst_ip)];
 	for (; NULL != entry; entry = entry->next) {
 		if ((entry->src_ip == src_ip) && (entry->dst_ip == dst_ip))
 			break;
 	}
 	return entry;
 }
+
+/*
+ * Anti-replay window
+ *
+ * The slot of block 'seq / 32' is 'block % IPSEC_REPLAY_SLOTS'. A slot
+ * tagged with an older block is reused for the new block, a slot tagged
+ * with a newer block means that the sequence number has left the window.
+ * Sequence numbers start from zero in this example.
+ */
+static inline uint64_t replay_slot_load(ipsec_replay_t *win, uint32_t idx)
+{
+	return __atomic_load_n(&win->slot[idx], __ATOMIC_ACQUIRE);
+}
+
+static inline int replay_too_old(ipsec_replay_t *win, uint32_t seq)
+{
+	uint64_t hi = __atomic_load_n(&win->hi, __ATOMIC_ACQUIRE);
+
+	return (uint64_t)seq + IPSEC_REPLAY_WINDOW < hi;
+}
+
+int ipsec_replay_check(ipsec_replay_t *win, uint32_t seq)
+{
+	uint32_t block = seq / 32;
+	uint64_t slot;
+
+	if (replay_too_old(win, seq))
+		return -1;
+
+	slot = replay_slot_load(win, block % IPSEC_REPLAY_SLOTS);
+
+	if ((uint32_t)(slot >> 32) == block)
+		return (slot & (1ULL << (seq % 32))) ? -1 : 0;
+
+	/* Newer block in the slot: out of window */
+	return (slot >> 32) > block ? -1 : 0;
+}
+
+int ipsec_replay_update(ipsec_replay_t *win, uint32_t seq)
+{
+	uint32_t block = seq / 32;
+	uint32_t idx = block % IPSEC_REPLAY_SLOTS;
+	uint64_t bit = 1ULL << (seq % 32);
+	uint64_t slot, new_slot;
+	uint64_t hi;
+
+	if (replay_too_old(win, seq))
+		return -1;
+
+	slot = replay_slot_load(win, idx);
+	do {
+		if ((uint32_t)(slot >> 32) == block) {
+			if (slot & bit)
+				return -1;
+			new_slot = slot | bit;
+		} else if ((slot >> 32) > block) {
+			return -1;
+		} else {
+			new_slot = ((uint64_t)block << 32) | bit;
+		}
+	} while (!__atomic_compare_exchange_n(&win->slot[idx], &slot,
+					      new_slot, 0, __ATOMIC_ACQ_REL,
+					      __ATOMIC_ACQUIRE));
+
+	/* Advance the window */
+	hi = __atomic_load_n(&win->hi, __ATOMIC_ACQUIRE);
+	while (seq >= hi &&
+	       !__atomic_compare_exchange_n(&win->hi, &hi,
+					    (uint64_t)seq + 1, 0,
+					    __ATOMIC_ACQ_REL,
+					    __ATOMIC_ACQUIRE))
+		;
+
+	return 0;
+}
@@ -26,11 +26,37 @@ typedef enum {
 	CRYPTO_API_ASYNC_NEW_BUFFER   /**< Asynchronous new buffer */
 } crypto_api_mode_e;
 
+/** Anti-replay window slots, each tracks 32 sequence numbers */
+#define IPSEC_REPLAY_SLOTS  32
+
+/** Anti-replay window size: sequence numbers this far behind the highest
+ *  received one are still accepted */
+#define IPSEC_REPLAY_WINDOW ((IPSEC_REPLAY_SLOTS - 1) * 32)
+
+/**
+ * Inbound SA anti-replay window
+ *
+ * Lock-free: updated with atomic compare and swap, so that any worker may
+ * receive packets of the SA. A slot holds the 32 bit block number
+ * (seq / 32) in its high half and the received bits of the block in its
+ * low half.
+ */
+typedef struct {
+	uint64_t hi;                          /**< Highest sequence + 1 */
+	uint64_t slot[IPSEC_REPLAY_SLOTS];    /**< Received bitmap slots */
+} ipsec_replay_t;
+
+/** Number of IPsec cache hash buckets, power of two */
+#define IPSEC_CACHE_HASH_SIZE 64
+
 /**
  * IPsec cache data base entry
  */
 typedef struct ipsec_cache_entry_s {
-	struct ipsec_cache_entry_s  *next;        /**< Next entry on list */
+	struct ipsec_cache_entry_s  *next;        /**< Next on output or input
+						       ESP hash chain */
+	struct ipsec_cache_entry_s  *ah_next;     /**< Next on input AH hash
+						       chain */
 	odp_bool_t                   in_place;    /**< Crypto API mode */
 	uint32_t                     src_ip;      /**< Source v4 address */
 	uint32_t                     dst_ip;      /**< Destination v4 address */
@@ -54,10 +80,12 @@ typedef struct ipsec_cache_entry_s {
 	/* Per SA state */
 	struct {
 		odp_crypto_session_t session;  /**< Crypto session handle */
-		uint32_t      esp_seq;         /**< ESP TX sequence number */
-		uint32_t      ah_seq;          /**< AH TX sequence number */
+		odp_atomic_u32_t esp_seq;      /**< ESP TX sequence number */
+		odp_atomic_u32_t ah_seq;       /**< AH TX sequence number */
 		uint8_t       iv[MAX_IV_LEN];  /**< ESP IV storage */
-		uint16be_t    tun_hdr_id;      /**< Tunnel header IP ID */
+		odp_atomic_u32_t tun_hdr_id;   /**< Tunnel header IP ID */
+		ipsec_replay_t esp_replay;     /**< ESP RX anti-replay */
+		ipsec_replay_t ah_replay;      /**< AH RX anti-replay */
 	} state;
 } ipsec_cache_entry_t;
 
@@ -66,8 +94,12 @@ typedef struct ipsec_cache_entry_s {
  */
 typedef struct ipsec_cache_s {
 	uint32_t             index;       /**< Index of next available entry */
-	ipsec_cache_entry_t *in_list;     /**< List of active input entries */
-	ipsec_cache_entry_t *out_list;    /**< List of active output entries */
+	/** Input entries with ESP hashed by ESP SPI */
+	ipsec_cache_entry_t *esp_hash[IPSEC_CACHE_HASH_SIZE];
+	/** Input entries with AH hashed by AH SPI */
+	ipsec_cache_entry_t *ah_hash[IPSEC_CACHE_HASH_SIZE];
+	/** Output entries hashed by source and destination address */
+	ipsec_cache_entry_t *out_hash[IPSEC_CACHE_HASH_SIZE];
 	ipsec_cache_entry_t  array[MAX_DB]; /**< Entry storage */
 } ipsec_cache_t;
 
@@ -126,6 +158,31 @@ ipsec_cache_entry_t *find_ipsec_cache_entry_out(uint32_t src_ip,
 						uint32_t dst_ip,
 						uint8_t proto);
 
+/**
+ * Check a received sequence number against the anti-replay window
+ *
+ * Called before integrity check, does not update the window.
+ *
+ * @param win   Anti-replay window
+ * @param seq   Sequence number
+ *
+ * @return 0 if not received yet and within the window else -1
+ */
+int ipsec_replay_check(ipsec_replay_t *win, uint32_t seq);
+
+/**
+ * Mark a sequence number received in the anti-replay window
+ *
+ * Called after successful integrity check. Catches replays that passed
+ * ipsec_replay_check() concurrently.
+ *
+ * @param win   Anti-replay window
+ * @param seq   Sequence number
+ *
+ * @return 0 if not received before and within the window else -1
+ */
+int ipsec_replay_update(ipsec_replay_t *win, uint32_t seq);
+
 #ifdef __cplusplus
 }
 #endif
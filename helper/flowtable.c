@@ -0,0 +1,744 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <odp.h>
+#include <odp/helper/flowtable.h>
+#include "odph_debug.h"
+
+#define MAX_FLOWS_DEFAULT   65536
+#define TIMEOUT_DEFAULT     (30 * ODP_TIME_SEC_IN_NS)
+#define TICK_DEFAULT        (100 * ODP_TIME_MSEC_IN_NS)
+#define WHEEL_TICKS_DEFAULT 1024
+#define MAX_LOCKS           4096
+#define CACHE_BATCH         64
+#define MULTI_BURST         32
+#define NIL                 0xffffffff
+
+#define ROUNDUP(x, align) ((((x) + (align) - 1) / (align)) * (align))
+
+/* Hash chain node of a direction. Nodes are referred to by the flow index
+ * times two plus the direction. */
+typedef struct {
+	odph_flow_key_t key;
+	uint32_t bucket;
+	uint32_t next;
+} node_t;
+
+struct odph_flow_s {
+	node_t node[2];
+	odp_atomic_u64_t last_ns;	/* Last lookup */
+	odp_atomic_u64_t timeout_ns;
+	odp_atomic_u32_t state;
+	uint32_t live;		/* Linked, changed under the bucket locks */
+	uint32_t next;		/* Wheel tick, deferred free or free list */
+	uint32_t owner;		/* Thread of the wheel */
+	odph_flow_table_t *tbl;
+	odp_atomic_u64_t packets[2];
+	odp_atomic_u64_t bytes[2];
+	uint64_t data[];
+};
+
+/* Per thread wheel, free flow cache and statistics */
+typedef struct ODP_ALIGNED_CACHE {
+	uint32_t *wheel;	/* Flow list per tick */
+	uint64_t tick;		/* Next tick to run */
+	int started;		/* Wheel has flows */
+	uint32_t free;
+	uint32_t num_free;
+	odph_flow_table_stats_t stats;
+} thr_t;
+
+struct odph_flow_table_s {
+	char name[ODP_SHM_NAME_LEN];
+	odp_shm_t shm;
+	uint8_t *flows;
+	uint32_t *bucket;
+	odp_spinlock_t *lock;
+	size_t flow_size;
+	uint32_t max_flows;
+	uint32_t data_size;
+	uint32_t bucket_mask;
+	uint32_t lock_mask;
+	uint32_t wheel_mask;
+	uint64_t timeout_ns;
+	uint64_t tick_ns;
+	odph_flow_expire_fn_t expire_fn;
+	void *expire_arg;
+	odp_spinlock_t free_lock;
+	uint32_t free;		/* Global free list */
+	thr_t thr[ODP_THREAD_COUNT_MAX];
+};
+
+static inline uint64_t now_ns(void)
+{
+	return odp_time_to_ns(odp_time_global());
+}
+
+static inline odph_flow_t *flow_ptr(odph_flow_table_t *tbl, uint32_t idx)
+{
+	return (odph_flow_t *)(tbl->flows + (size_t)idx * tbl->flow_size);
+}
+
+static inline uint32_t flow_idx(odph_flow_table_t *tbl, odph_flow_t *flow)
+{
+	return ((uint8_t *)flow - tbl->flows) / tbl->flow_size;
+}
+
+static inline uint32_t key_hash(const odph_flow_key_t *key)
+{
+	uint64_t a = ((uint64_t)key->src_ip << 32) | key->dst_ip;
+	uint64_t b = ((uint64_t)key->src_port << 32) |
+		     ((uint32_t)key->dst_port << 16) | key->proto;
+	uint64_t hash;
+
+	hash  = a * 0x9e3779b97f4a7c15ULL;
+	hash ^= b * 0xc2b2ae3d27d4eb4fULL;
+	hash ^= hash >> 29;
+	hash *= 0xbf58476d1ce4e5b9ULL;
+	hash ^= hash >> 32;
+
+	return hash;
+}
+
+static inline int key_equal(const odph_flow_key_t *a, const odph_flow_key_t *b)
+{
+	return memcmp(a, b, sizeof(odph_flow_key_t)) == 0;
+}
+
+/* Another thread may have seen the flow after 'now' */
+static inline int timed_out(odph_flow_t *flow, uint64_t now)
+{
+	uint64_t last = odp_atomic_load_u64(&flow->last_ns);
+
+	return now > last &&
+	       now - last >= odp_atomic_load_u64(&flow->timeout_ns);
+}
+
+/* Chain links are read without locks */
+static inline uint32_t load_ref(uint32_t *ref)
+{
+	return __atomic_load_n(ref, __ATOMIC_ACQUIRE);
+}
+
+static inline void store_ref(uint32_t *ref, uint32_t val)
+{
+	__atomic_store_n(ref, val, __ATOMIC_RELEASE);
+}
+
+static inline thr_t *thr_self(odph_flow_table_t *tbl)
+{
+	return &tbl->thr[odp_thread_id()];
+}
+
+void odph_flow_param_init(odph_flow_param_t *param)
+{
+	memset(param, 0, sizeof(*param));
+	param->max_flows   = MAX_FLOWS_DEFAULT;
+	param->timeout_ns  = TIMEOUT_DEFAULT;
+	param->tick_ns     = TICK_DEFAULT;
+	param->wheel_ticks = WHEEL_TICKS_DEFAULT;
+}
+
+odph_flow_table_t *odph_flow_table_create(const char *name,
+					  const odph_flow_param_t *param)
+{
+	odph_flow_table_t *tbl;
+	odp_shm_t shm;
+	uint32_t buckets, locks, i;
+	size_t flow_size, size, off_bucket, off_lock, off_wheel, off_flows;
+
+	if (param->max_flows == 0 || param->max_flows >= NIL / 2 ||
+	    param->tick_ns == 0 || param->wheel_ticks < 2 ||
+	    (param->wheel_ticks & (param->wheel_ticks - 1))) {
+		ODPH_ERR("Bad flow table parameters\n");
+		return NULL;
+	}
+
+	/* A bucket per node */
+	buckets = 1;
+	while (buckets < 2 * param->max_flows)
+		buckets <<= 1;
+
+	locks = buckets < MAX_LOCKS ? buckets : MAX_LOCKS;
+
+	flow_size  = ROUNDUP(sizeof(odph_flow_t) + param->data_size,
+			     ODP_CACHE_LINE_SIZE);
+	off_bucket = ROUNDUP(sizeof(odph_flow_table_t), ODP_CACHE_LINE_SIZE);
+	off_lock   = ROUNDUP(off_bucket + buckets * sizeof(uint32_t),
+			     ODP_CACHE_LINE_SIZE);
+	off_wheel  = ROUNDUP(off_lock + locks * sizeof(odp_spinlock_t),
+			     ODP_CACHE_LINE_SIZE);
+	off_flows  = ROUNDUP(off_wheel + ODP_THREAD_COUNT_MAX *
+			     param->wheel_ticks * sizeof(uint32_t),
+			     ODP_CACHE_LINE_SIZE);
+	size       = off_flows + (size_t)param->max_flows * flow_size;
+
+	shm = odp_shm_reserve(name, size, ODP_CACHE_LINE_SIZE, 0);
+	tbl = odp_shm_addr(shm);
+	if (tbl == NULL) {
+		ODPH_ERR("Flow table %s reserve failed\n", name);
+		return NULL;
+	}
+
+	memset(tbl, 0, off_flows);
+	snprintf(tbl->name, sizeof(tbl->name), "%s", name);
+	tbl->shm         = shm;
+	tbl->flows       = (uint8_t *)tbl + off_flows;
+	tbl->bucket      = (uint32_t *)((uint8_t *)tbl + off_bucket);
+	tbl->lock        = (odp_spinlock_t *)((uint8_t *)tbl + off_lock);
+	tbl->flow_size   = flow_size;
+	tbl->max_flows   = param->max_flows;
+	tbl->data_size   = param->data_size;
+	tbl->bucket_mask = buckets - 1;
+	tbl->lock_mask   = locks - 1;
+	tbl->wheel_mask  = param->wheel_ticks - 1;
+	tbl->timeout_ns  = param->timeout_ns;
+	tbl->tick_ns     = param->tick_ns;
+	tbl->expire_fn   = param->expire_fn;
+	tbl->expire_arg  = param->expire_arg;
+
+	for (i = 0; i < buckets; i++)
+		tbl->bucket[i] = NIL;
+
+	for (i = 0; i < locks; i++)
+		odp_spinlock_init(&tbl->lock[i]);
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+		thr_t *thr = &tbl->thr[i];
+
+		thr->wheel = (uint32_t *)((uint8_t *)tbl + off_wheel) +
+			     i * param->wheel_ticks;
+		memset(thr->wheel, 0xff,
+		       param->wheel_ticks * sizeof(uint32_t));
+		thr->free = NIL;
+	}
+
+	/* Flows are touched here once, not on every add */
+	odp_spinlock_init(&tbl->free_lock);
+	for (i = 0; i < tbl->max_flows; i++) {
+		odph_flow_t *flow = flow_ptr(tbl, i);
+
+		memset(flow, 0, sizeof(odph_flow_t));
+		flow->next = i + 1 < tbl->max_flows ? i + 1 : NIL;
+	}
+	tbl->free = 0;
+
+	return tbl;
+}
+
+int odph_flow_table_destroy(odph_flow_table_t *tbl)
+{
+	/* Run recycling deferred by this thread before the memory goes */
+	odp_rcu_barrier();
+
+	return odp_shm_free(tbl->shm);
+}
+
+static uint32_t flow_alloc(odph_flow_table_t *tbl, thr_t *thr)
+{
+	uint32_t idx, i;
+
+	if (thr->num_free == 0) {
+		odp_spinlock_lock(&tbl->free_lock);
+
+		for (i = 0; i < CACHE_BATCH && tbl->free != NIL; i++) {
+			idx = tbl->free;
+			tbl->free = flow_ptr(tbl, idx)->next;
+			flow_ptr(tbl, idx)->next = thr->free;
+			thr->free = idx;
+			thr->num_free++;
+		}
+
+		odp_spinlock_unlock(&tbl->free_lock);
+
+		if (thr->num_free == 0)
+			return NIL;
+	}
+
+	idx = thr->free;
+	thr->free = flow_ptr(tbl, idx)->next;
+	thr->num_free--;
+	return idx;
+}
+
+static void flow_free(odph_flow_table_t *tbl, thr_t *thr, uint32_t idx)
+{
+	uint32_t head, tail, i;
+
+	flow_ptr(tbl, idx)->next = thr->free;
+	thr->free = idx;
+	thr->num_free++;
+
+	if (thr->num_free < 2 * CACHE_BATCH)
+		return;
+
+	/* Return a batch to the global list */
+	head = thr->free;
+	tail = head;
+	for (i = 1; i < CACHE_BATCH; i++)
+		tail = flow_ptr(tbl, tail)->next;
+
+	thr->free = flow_ptr(tbl, tail)->next;
+	thr->num_free -= CACHE_BATCH;
+
+	odp_spinlock_lock(&tbl->free_lock);
+	flow_ptr(tbl, tail)->next = tbl->free;
+	tbl->free = head;
+	odp_spinlock_unlock(&tbl->free_lock);
+}
+
+/* Grace period of a batch of unlinked flows ended */
+static void flow_recycle(void *arg)
+{
+	odph_flow_t *flow = arg;
+	odph_flow_table_t *tbl = flow->tbl;
+	thr_t *thr = thr_self(tbl);
+	uint32_t idx = flow_idx(tbl, flow);
+	uint32_t next;
+
+	while (idx != NIL) {
+		next = flow_ptr(tbl, idx)->next;
+		flow_free(tbl, thr, idx);
+		idx = next;
+	}
+}
+
+static void recycle(odph_flow_table_t *tbl, uint32_t head)
+{
+	odph_flow_t *flow;
+
+	if (head == NIL)
+		return;
+
+	flow = flow_ptr(tbl, head);
+	if (odp_rcu_defer(flow_recycle, flow)) {
+		odp_rcu_synchronize();
+		flow_recycle(flow);
+	}
+}
+
+static void lock_buckets(odph_flow_table_t *tbl, uint32_t b0, uint32_t b1)
+{
+	uint32_t l0 = b0 & tbl->lock_mask;
+	uint32_t l1 = b1 & tbl->lock_mask;
+
+	if (l0 == l1) {
+		odp_spinlock_lock(&tbl->lock[l0]);
+	} else if (l0 < l1) {
+		odp_spinlock_lock(&tbl->lock[l0]);
+		odp_spinlock_lock(&tbl->lock[l1]);
+	} else {
+		odp_spinlock_lock(&tbl->lock[l1]);
+		odp_spinlock_lock(&tbl->lock[l0]);
+	}
+}
+
+static void unlock_buckets(odph_flow_table_t *tbl, uint32_t b0, uint32_t b1)
+{
+	uint32_t l0 = b0 & tbl->lock_mask;
+	uint32_t l1 = b1 & tbl->lock_mask;
+
+	odp_spinlock_unlock(&tbl->lock[l0]);
+	if (l0 != l1)
+		odp_spinlock_unlock(&tbl->lock[l1]);
+}
+
+/* Find a key in a bucket, with the bucket locked */
+static uint32_t bucket_find(odph_flow_table_t *tbl, uint32_t bucket,
+			    const odph_flow_key_t *key)
+{
+	uint32_t ref = tbl->bucket[bucket];
+	node_t *node;
+
+	while (ref != NIL) {
+		node = &flow_ptr(tbl, ref >> 1)->node[ref & 1];
+		if (key_equal(&node->key, key))
+			return ref;
+		ref = node->next;
+	}
+
+	return NIL;
+}
+
+/* Unlink both nodes of a flow, with its buckets locked */
+static void flow_unlink(odph_flow_table_t *tbl, odph_flow_t *flow)
+{
+	uint32_t idx = flow_idx(tbl, flow);
+	uint32_t *prev;
+	uint32_t d;
+
+	for (d = 0; d < 2; d++) {
+		prev = &tbl->bucket[flow->node[d].bucket];
+
+		while (*prev != idx * 2 + d)
+			prev = &flow_ptr(tbl, *prev >> 1)->node[*prev & 1].next;
+
+		/* Readers on the node still find the rest of the chain */
+		store_ref(prev, flow->node[d].next);
+	}
+
+	flow->live = 0;
+}
+
+/* Unlink a flow that timed out, returns 1 if this call unlinked it */
+static int flow_expire(odph_flow_table_t *tbl, thr_t *thr,
+		       odph_flow_t *flow, uint64_t now)
+{
+	int ret = 0;
+
+	lock_buckets(tbl, flow->node[0].bucket, flow->node[1].bucket);
+
+	if (flow->live && timed_out(flow, now)) {
+		flow_unlink(tbl, flow);
+		ret = 1;
+	}
+
+	unlock_buckets(tbl, flow->node[0].bucket, flow->node[1].bucket);
+
+	if (ret) {
+		thr->stats.expired++;
+		if (tbl->expire_fn)
+			tbl->expire_fn(tbl, flow, tbl->expire_arg);
+	}
+
+	return ret;
+}
+
+static void wheel_insert(odph_flow_table_t *tbl, thr_t *thr,
+			 odph_flow_t *flow, uint64_t now_tick,
+			 uint64_t expire_ns)
+{
+	uint64_t tick = expire_ns / tbl->tick_ns + 1;
+	uint32_t *slot;
+
+	/* Later timeouts are revisited once per wheel turn */
+	if (tick <= now_tick)
+		tick = now_tick + 1;
+	else if (tick > now_tick + tbl->wheel_mask)
+		tick = now_tick + tbl->wheel_mask;
+
+	slot = &thr->wheel[tick & tbl->wheel_mask];
+	flow->next = *slot;
+	*slot = flow_idx(tbl, flow);
+}
+
+static inline void key_reverse(const odph_flow_key_t *key,
+			       odph_flow_key_t *rev)
+{
+	memset(rev, 0, sizeof(*rev));
+	rev->src_ip   = key->dst_ip;
+	rev->dst_ip   = key->src_ip;
+	rev->src_port = key->dst_port;
+	rev->dst_port = key->src_port;
+	rev->proto    = key->proto;
+}
+
+int odph_flow_add(odph_flow_table_t *tbl, const odph_flow_key_t *key,
+		  const odph_flow_key_t *reply, odph_flow_t **flow,
+		  odph_flow_dir_t *dir)
+{
+	thr_t *thr = thr_self(tbl);
+	odph_flow_key_t rev;
+	odph_flow_t *new, *old;
+	uint32_t b0, b1, ref, idx;
+	uint64_t now = now_ns();
+	int d;
+
+	if (reply == NULL) {
+		key_reverse(key, &rev);
+		reply = &rev;
+	}
+
+	b0 = key_hash(key) & tbl->bucket_mask;
+	b1 = key_hash(reply) & tbl->bucket_mask;
+
+	idx = flow_alloc(tbl, thr);
+	if (idx == NIL) {
+		thr->stats.full++;
+		return -1;
+	}
+
+	new = flow_ptr(tbl, idx);
+
+retry:
+	lock_buckets(tbl, b0, b1);
+
+	for (d = 0; d < 2; d++) {
+		ref = bucket_find(tbl, d ? b1 : b0, d ? reply : key);
+		if (ref == NIL)
+			continue;
+
+		old = flow_ptr(tbl, ref >> 1);
+
+		if (timed_out(old, now)) {
+			/* Its other bucket may not be locked */
+			unlock_buckets(tbl, b0, b1);
+			flow_expire(tbl, thr, old, now);
+			goto retry;
+		}
+
+		unlock_buckets(tbl, b0, b1);
+		flow_free(tbl, thr, idx);
+
+		if (d)
+			return -1;
+
+		*flow = old;
+		if (dir)
+			*dir = ref & 1;
+		return 0;
+	}
+
+	/* Not visible to readers until linked */
+	new->node[0].key    = *key;
+	new->node[0].bucket = b0;
+	new->node[1].key    = *reply;
+	new->node[1].bucket = b1;
+	odp_atomic_init_u64(&new->last_ns, now);
+	odp_atomic_init_u64(&new->timeout_ns, tbl->timeout_ns);
+	odp_atomic_init_u32(&new->state, 0);
+	odp_atomic_init_u64(&new->packets[0], 0);
+	odp_atomic_init_u64(&new->packets[1], 0);
+	odp_atomic_init_u64(&new->bytes[0], 0);
+	odp_atomic_init_u64(&new->bytes[1], 0);
+	new->owner = odp_thread_id();
+	new->tbl   = tbl;
+	new->live  = 1;
+	memset(new->data, 0, tbl->data_size);
+
+	new->node[0].next = tbl->bucket[b0];
+	store_ref(&tbl->bucket[b0], idx * 2);
+	new->node[1].next = tbl->bucket[b1];
+	store_ref(&tbl->bucket[b1], idx * 2 + 1);
+
+	unlock_buckets(tbl, b0, b1);
+
+	if (!thr->started) {
+		thr->tick    = now / tbl->tick_ns;
+		thr->started = 1;
+	}
+	wheel_insert(tbl, thr, new, thr->tick, now + tbl->timeout_ns);
+
+	thr->stats.added++;
+	*flow = new;
+	if (dir)
+		*dir = ODPH_FLOW_DIR_ORIG;
+	return 1;
+}
+
+static inline odph_flow_t *bucket_lookup(odph_flow_table_t *tbl,
+					 uint32_t ref,
+					 const odph_flow_key_t *key,
+					 odph_flow_dir_t *dir, uint64_t now)
+{
+	odph_flow_t *flow;
+	node_t *node;
+
+	while (ref != NIL) {
+		flow = flow_ptr(tbl, ref >> 1);
+		node = &flow->node[ref & 1];
+
+		if (key_equal(&node->key, key)) {
+			if (timed_out(flow, now))
+				return NULL;
+
+			/* Write the shared line once per tick at most */
+			if (now >= odp_atomic_load_u64(&flow->last_ns) +
+			    tbl->tick_ns)
+				odp_atomic_store_u64(&flow->last_ns, now);
+
+			if (dir)
+				*dir = ref & 1;
+			return flow;
+		}
+
+		ref = load_ref(&node->next);
+	}
+
+	return NULL;
+}
+
+odph_flow_t *odph_flow_lookup(odph_flow_table_t *tbl,
+			      const odph_flow_key_t *key,
+			      odph_flow_dir_t *dir)
+{
+	uint32_t bucket = key_hash(key) & tbl->bucket_mask;
+
+	return bucket_lookup(tbl, load_ref(&tbl->bucket[bucket]), key, dir,
+			     now_ns());
+}
+
+int odph_flow_lookup_multi(odph_flow_table_t *tbl, const odph_flow_key_t key[],
+			   odph_flow_t *flow[], odph_flow_dir_t dir[],
+			   int num)
+{
+	uint32_t ref[MULTI_BURST];
+	uint64_t now = now_ns();
+	int found = 0;
+	int i, j, n;
+
+	for (i = 0; i < num; i += n) {
+		n = num - i < MULTI_BURST ? num - i : MULTI_BURST;
+
+		for (j = 0; j < n; j++) {
+			ref[j] = key_hash(&key[i + j]) & tbl->bucket_mask;
+			odp_prefetch(&tbl->bucket[ref[j]]);
+		}
+
+		for (j = 0; j < n; j++) {
+			ref[j] = load_ref(&tbl->bucket[ref[j]]);
+			if (ref[j] != NIL)
+				odp_prefetch(flow_ptr(tbl, ref[j] >> 1));
+		}
+
+		for (j = 0; j < n; j++) {
+			flow[i + j] = bucket_lookup(tbl, ref[j], &key[i + j],
+						    dir ? &dir[i + j] : NULL,
+						    now);
+			if (flow[i + j])
+				found++;
+		}
+	}
+
+	return found;
+}
+
+int odph_flow_del(odph_flow_table_t *tbl, odph_flow_t *flow)
+{
+	int ret = -1;
+
+	lock_buckets(tbl, flow->node[0].bucket, flow->node[1].bucket);
+
+	if (flow->live) {
+		flow_unlink(tbl, flow);
+		ret = 0;
+	}
+
+	unlock_buckets(tbl, flow->node[0].bucket, flow->node[1].bucket);
+
+	if (ret == 0)
+		thr_self(tbl)->stats.deleted++;
+
+	return ret;
+}
+
+int odph_flow_age(odph_flow_table_t *tbl)
+{
+	thr_t *thr = thr_self(tbl);
+	uint64_t now = now_ns();
+	uint64_t now_tick = now / tbl->tick_ns;
+	uint64_t tick, expire;
+	uint32_t idx, next;
+	uint32_t dead = NIL;
+	odph_flow_t *flow;
+	int num = 0;
+
+	if (!thr->started || thr->tick > now_tick)
+		return 0;
+
+	/* All ticks passed, each slot once */
+	tick = thr->tick;
+	if (now_tick - tick > tbl->wheel_mask)
+		tick = now_tick - tbl->wheel_mask;
+
+	for (; tick <= now_tick; tick++) {
+		idx = thr->wheel[tick & tbl->wheel_mask];
+		thr->wheel[tick & tbl->wheel_mask] = NIL;
+
+		while (idx != NIL) {
+			flow = flow_ptr(tbl, idx);
+			next = flow->next;
+
+			expire = odp_atomic_load_u64(&flow->last_ns) +
+				 odp_atomic_load_u64(&flow->timeout_ns);
+
+			if (flow->live && expire > now) {
+				wheel_insert(tbl, thr, flow, now_tick, expire);
+			} else {
+				if (flow->live && flow_expire(tbl, thr, flow,
+							      now))
+					num++;
+
+				/* Deleted, timed out or refreshed while
+				 * unlinked by another thread */
+				if (flow->live) {
+					wheel_insert(tbl, thr, flow, now_tick,
+						     expire);
+				} else {
+					flow->next = dead;
+					dead = idx;
+				}
+			}
+
+			idx = next;
+		}
+	}
+
+	thr->tick = now_tick + 1;
+	recycle(tbl, dead);
+	return num;
+}
+
+const odph_flow_key_t *odph_flow_key(odph_flow_t *flow, odph_flow_dir_t dir)
+{
+	return &flow->node[dir].key;
+}
+
+void *odph_flow_data(odph_flow_t *flow)
+{
+	return flow->data;
+}
+
+uint32_t odph_flow_state(odph_flow_t *flow)
+{
+	return odp_atomic_load_u32(&flow->state);
+}
+
+void odph_flow_state_set(odph_flow_t *flow, uint32_t state)
+{
+	odp_atomic_store_u32(&flow->state, state);
+}
+
+void odph_flow_timeout_set(odph_flow_table_t *tbl ODPH_UNUSED,
+			   odph_flow_t *flow, uint64_t timeout_ns)
+{
+	odp_atomic_store_u64(&flow->timeout_ns, timeout_ns);
+}
+
+void odph_flow_count(odph_flow_t *flow, odph_flow_dir_t dir, uint32_t bytes)
+{
+	odp_atomic_inc_u64(&flow->packets[dir]);
+	odp_atomic_add_u64(&flow->bytes[dir], bytes);
+}
+
+void odph_flow_counters(odph_flow_t *flow, odph_flow_dir_t dir,
+			uint64_t *packets, uint64_t *bytes)
+{
+	*packets = odp_atomic_load_u64(&flow->packets[dir]);
+	*bytes   = odp_atomic_load_u64(&flow->bytes[dir]);
+}
+
+void odph_flow_table_stats(odph_flow_table_t *tbl,
+			   odph_flow_table_stats_t *stats)
+{
+	int i;
+
+	memset(stats, 0, sizeof(*stats));
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+		odph_flow_table_stats_t *s = &tbl->thr[i].stats;
+
+		stats->added   += s->added;
+		stats->deleted += s->deleted;
+		stats->expired += s->expired;
+		stats->full    += s->full;
+	}
+
+	stats->flows = stats->added - stats->deleted - stats->expired;
+}
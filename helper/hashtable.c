@@ -57,7 +57,9 @@ typedef struct {
 	odph_hash_node *hash_node_pool;
 	/** number of element in the hash_node_pool */
 	uint32_t hash_node_num;
-	char rsv[7]; /**< Reserved,for alignment */
+	/** readers take no locks, see odph_hash_table_rcu_create() */
+	uint8_t rcu;
+	char rsv[6]; /**< Reserved,for alignment */
 	char name[ODPH_TABLE_NAME_LEN]; /**< table name */
 } odph_hash_table_imp;
 
@@ -70,12 +72,21 @@ odph_table_t odph_hash_table_create(const char *name, uint32_t capacity,
 	odph_hash_table_imp *tbl;
 	odp_shm_t shmem;
 	uint32_t node_mem;
+	uint32_t head_mem = sizeof(odph_hash_table_imp)
+		+ ODPH_MAX_BUCKET_NUM * sizeof(odph_list_head)
+		+ ODPH_MAX_BUCKET_NUM * sizeof(odp_rwlock_t);
 
 	if (strlen(name) >= ODPH_TABLE_NAME_LEN || capacity < 1 ||
 	    capacity >= 0x1000 || key_size == 0 || value_size == 0) {
 		ODPH_DBG("create para input error!\n");
 		return NULL;
 	}
+	/* buckets and locks must fit, otherwise their init overruns the
+	 * memory block */
+	if ((capacity << 20) <= head_mem) {
+		ODPH_DBG("capacity too small for the buckets\n");
+		return NULL;
+	}
 	tbl = (odph_hash_table_imp *)odp_shm_addr(odp_shm_lookup(name));
 	if (tbl != NULL) {
 		ODPH_DBG("name already exist\n");
@@ -106,9 +117,7 @@ odph_table_t odph_hash_table_create(const char *name, uint32_t capacity,
 	tbl->list_head_pool = (odph_list_head *)((char *)tbl->lock_pool
 			+ ODPH_MAX_BUCKET_NUM * sizeof(odp_rwlock_t));
 
-	node_mem = tbl->init_cap - sizeof(odph_hash_table_imp)
-		- ODPH_MAX_BUCKET_NUM * sizeof(odph_list_head)
-		- ODPH_MAX_BUCKET_NUM * sizeof(odp_rwlock_t);
+	node_mem = tbl->init_cap - head_mem;
 
 	node_num = node_mem / (sizeof(odph_hash_node) + key_size + value_size);
 	tbl->hash_node_num = node_num;
@@ -125,6 +134,29 @@ odph_table_t odph_hash_table_create(const char *name, uint32_t capacity,
 	return (odph_table_t)tbl;
 }
 
+/**
+ * Create a hash table read without locks
+ *
+ * odph_hash_get_value() takes no lock and writes nothing shared. Updates
+ * replace or unlink nodes under the bucket lock, and removed nodes return
+ * to the pool after an RCU grace period (odp_rcu_defer()). Threads reading
+ * the table must report quiescent states, e.g. by calling odp_schedule().
+ */
+odph_table_t odph_hash_table_rcu_create(const char *name, uint32_t capacity,
+					uint32_t key_size,
+					uint32_t value_size)
+{
+	odph_hash_table_imp *tbl;
+
+	tbl = (odph_hash_table_imp *)odph_hash_table_create(name, capacity,
+							    key_size,
+							    value_size);
+	if (tbl != NULL)
+		tbl->rcu = 1;
+
+	return (odph_table_t)tbl;
+}
+
 int odph_hash_table_destroy(odph_table_t table)
 {
 	int ret;
@@ -135,6 +167,10 @@ int odph_hash_table_destroy(odph_table_t table)
 		if (hash_tbl->magicword != ODPH_HASH_TABLE_MAGIC_WORD)
 			return ODPH_FAIL;
 
+		/* run pending node frees before the pool goes away */
+		if (hash_tbl->rcu)
+			odp_rcu_barrier();
+
 		ret = odp_shm_free(odp_shm_lookup(hash_tbl->name));
 		if (ret != 0) {
 			ODPH_DBG("free fail\n");
@@ -220,6 +256,65 @@ void odp_hashnode_give(odph_table_t table, odph_hash_node *node)
 	       (sizeof(odph_hash_node) + tbl->key_size + tbl->value_size));
 }
 
+/**
+ * Release a node unlinked from an RCU table, after a grace period
+ */
+static void odp_hashnode_give_rcu(void *arg)
+{
+	odph_hash_node *node = (odph_hash_node *)arg;
+
+	node->list_node.next = NULL;
+	node->list_node.prev = NULL;
+}
+
+static int odph_hash_put_value_rcu(odph_hash_table_imp *tbl, void *key,
+				   void *value)
+{
+	uint16_t hash = odp_key_hash(key, tbl->key_size);
+	odph_hash_node *node, *old = NULL;
+	char *tmp;
+
+	/* the new version of the node is filled before it is linked */
+	node = odp_hashnode_take((odph_table_t)tbl);
+	if (node == NULL) {
+		/* removed nodes may wait for a grace period */
+		odp_rcu_barrier();
+		node = odp_hashnode_take((odph_table_t)tbl);
+		if (node == NULL)
+			return ODPH_FAIL;
+	}
+
+	memcpy(node->content, key, tbl->key_size);
+	tmp = (void *)((char *)node->content + tbl->key_size);
+	memcpy(tmp, value, tbl->value_size);
+
+	odp_rwlock_write_lock(&tbl->lock_pool[hash]);
+
+	ODPH_LIST_FOR_EACH(old, &tbl->list_head_pool[hash], odph_hash_node,
+			   list_node)
+	{
+		if (memcmp(old->content, key, tbl->key_size) == 0)
+			break;
+	}
+
+	if (&old->list_node != &tbl->list_head_pool[hash]) {
+		/* readers see either the old or the new value, never a mix */
+		odph_list_replace_rcu(&old->list_node, &node->list_node);
+	} else {
+		odph_list_add_rcu(&node->list_node, &tbl->list_head_pool[hash]);
+		old = NULL;
+	}
+
+	odp_rwlock_write_unlock(&tbl->lock_pool[hash]);
+
+	if (old != NULL && odp_rcu_defer(odp_hashnode_give_rcu, old)) {
+		odp_rcu_synchronize();
+		odp_hashnode_give_rcu(old);
+	}
+
+	return ODPH_SUCCESS;
+}
+
 /* should make sure the input table exists and is available */
 int odph_hash_put_value(odph_table_t table, void *key, void *value)
 {
@@ -231,6 +326,9 @@ int odph_hash_put_value(odph_table_t table, void *key, void *value)
 	if (table == NULL || key == NULL || value == NULL)
 		return ODPH_FAIL;
 
+	if (tbl->rcu)
+		return odph_hash_put_value_rcu(tbl, key, value);
+
 	/* hash value is just the index of the list head in pool */
 	hash = odp_key_hash(key, tbl->key_size);
 
@@ -283,6 +381,21 @@ int odph_hash_get_value(odph_table_t table, void *key, void *buffer,
 	/* hash value is just the index of the list head in pool */
 	hash = odp_key_hash(key, tbl->key_size);
 
+	if (tbl->rcu) {
+		ODPH_LIST_FOR_EACH_RCU(node, &tbl->list_head_pool[hash],
+				       odph_hash_node, list_node)
+		{
+			if (memcmp(node->content, key, tbl->key_size) == 0) {
+				tmp = (void *)((char *)node->content
+					       + tbl->key_size);
+				memcpy(buffer, tmp, tbl->value_size);
+				return ODPH_SUCCESS;
+			}
+		}
+
+		return ODPH_FAIL;
+	}
+
 	odp_rwlock_read_lock(&tbl->lock_pool[hash]);
 
 	ODPH_LIST_FOR_EACH(node, &tbl->list_head_pool[hash],
@@ -323,11 +436,24 @@ int odph_hash_remove_value(odph_table_t table, void *key)
 	ODPH_LIST_FOR_EACH(node, &tbl->list_head_pool[hash], odph_hash_node,
 			   list_node)
 	{
-		if (memcmp(node->content, key, tbl->key_size) == 0) {
+		if (memcmp(node->content, key, tbl->key_size) != 0)
+			continue;
+
+		if (!tbl->rcu) {
 			odp_hashnode_give(table, node);
 			odp_rwlock_write_unlock(&tbl->lock_pool[hash]);
 			return ODPH_SUCCESS;
 		}
+
+		/* readers may still be on the node */
+		odph_list_del_rcu(&node->list_node);
+		odp_rwlock_write_unlock(&tbl->lock_pool[hash]);
+
+		if (odp_rcu_defer(odp_hashnode_give_rcu, node)) {
+			odp_rcu_synchronize();
+			odp_hashnode_give_rcu(node);
+		}
+		return ODPH_SUCCESS;
 	}
 
 	odp_rwlock_write_unlock(&tbl->lock_pool[hash]);
@@ -343,3 +469,11 @@ odph_table_ops_t odph_hash_table_ops = {
 	odph_hash_get_value,
 	odph_hash_remove_value};
 
+odph_table_ops_t odph_hash_table_rcu_ops = {
+	odph_hash_table_rcu_create,
+	odph_hash_table_lookup,
+	odph_hash_table_destroy,
+	odph_hash_put_value,
+	odph_hash_get_value,
+	odph_hash_remove_value};
+
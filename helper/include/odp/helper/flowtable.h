@@ -0,0 +1,301 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP flow table helper, connection tracking for stateful firewalls and NAT
+ *
+ * A flow is found with the 5-tuple of either direction: the key of the
+ * original direction and the key of the reply direction, which is the
+ * reverse of the original unless a NAT rewrites it. Each flow has a user
+ * state word, a user data area and packet and byte counters per direction.
+ *
+ * Lookups take no locks and write nothing shared, except the last seen
+ * time once per aging tick. Adds and deletes lock the hash buckets of the
+ * two keys. Removed flows are recycled after an RCU grace period, so
+ * threads looking up flows must report quiescent states, e.g. by calling
+ * odp_schedule() or odp_rcu_quiescent() (see odp_rcu).
+ *
+ * Flows live in a fixed arena sized at create time. Each thread caches
+ * free flows and keeps a timer wheel of the flows it added. A flow expires
+ * when it has not been looked up for its timeout. odph_flow_age() runs the
+ * wheel of the calling thread up to the current time: only the flows in
+ * the ticks passed are visited, never the whole table. Lookups and adds
+ * treat timed out flows as gone even before their wheel runs.
+ */
+
+#ifndef ODPH_FLOWTABLE_H_
+#define ODPH_FLOWTABLE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp.h>
+
+/** Flow table */
+typedef struct odph_flow_table_s odph_flow_table_t;
+
+/** Flow */
+typedef struct odph_flow_s odph_flow_t;
+
+/** Flow key, in the byte order chosen by the user. Unused bytes zero. */
+typedef struct {
+	uint32_t src_ip;	/**< Source IPv4 address */
+	uint32_t dst_ip;	/**< Destination IPv4 address */
+	uint16_t src_port;	/**< Source port */
+	uint16_t dst_port;	/**< Destination port */
+	uint8_t  proto;		/**< IP protocol */
+	uint8_t  pad[3];	/**< Zero */
+} odph_flow_key_t;
+
+/** Direction of a flow key */
+typedef enum {
+	ODPH_FLOW_DIR_ORIG = 0,	/**< Original direction */
+	ODPH_FLOW_DIR_REPLY	/**< Reply direction */
+} odph_flow_dir_t;
+
+/**
+ * Flow timed out
+ *
+ * Called when a timed out flow has been unlinked from the table, e.g. to
+ * release a NAT port, by odph_flow_age() or by an add of one of its keys.
+ * Lookups in progress may still see the flow.
+ *
+ * @param tbl    Table
+ * @param flow   Flow
+ * @param arg    Table parameter 'expire_arg'
+ */
+typedef void (*odph_flow_expire_fn_t)(odph_flow_table_t *tbl,
+				      odph_flow_t *flow, void *arg);
+
+/** Flow table parameters */
+typedef struct {
+	/** Maximum number of flows (default 65536). Each thread caches up
+	 *  to 127 free flows. */
+	uint32_t max_flows;
+
+	/** User data bytes per flow (default 0) */
+	uint32_t data_size;
+
+	/** Default flow timeout in nanoseconds (default 30 s) */
+	uint64_t timeout_ns;
+
+	/** Aging tick in nanoseconds (default 100 ms) */
+	uint64_t tick_ns;
+
+	/** Ticks per timer wheel, power of two (default 1024). Flows timing
+	 *  out later are revisited once per wheel turn. */
+	uint32_t wheel_ticks;
+
+	/** Called for timed out flows, NULL: none (default) */
+	odph_flow_expire_fn_t expire_fn;
+
+	/** Argument of 'expire_fn' */
+	void *expire_arg;
+} odph_flow_param_t;
+
+/** Flow table statistics */
+typedef struct {
+	uint64_t flows;		/**< Flows in the table */
+	uint64_t added;		/**< Flows added */
+	uint64_t deleted;	/**< Flows deleted */
+	uint64_t expired;	/**< Flows timed out */
+	uint64_t full;		/**< Adds failed on a full table */
+} odph_flow_table_stats_t;
+
+/**
+ * Initialize flow table parameters
+ *
+ * @param param  Parameters to initialize to defaults
+ */
+void odph_flow_param_init(odph_flow_param_t *param);
+
+/**
+ * Create a flow table
+ *
+ * @param name   Table name, unique
+ * @param param  Table parameters
+ *
+ * @return Table, NULL on failure
+ */
+odph_flow_table_t *odph_flow_table_create(const char *name,
+					  const odph_flow_param_t *param);
+
+/**
+ * Destroy a flow table
+ *
+ * No thread may use the table during or after the call. Threads that
+ * called odph_flow_age() must have called odp_rcu_barrier() or
+ * odp_term_local() before, the calling thread is done here.
+ *
+ * @param tbl    Table
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odph_flow_table_destroy(odph_flow_table_t *tbl);
+
+/**
+ * Add a flow
+ *
+ * When the key of either direction belongs to a live flow, no flow is
+ * added. Concurrent adds of the same flow add it once, the others find it.
+ *
+ * @param tbl        Table
+ * @param key        Key of the original direction
+ * @param reply      Key of the reply direction, NULL: 'key' reversed
+ * @param[out] flow  Added flow, or the flow of 'key' when 0 is returned
+ * @param[out] dir   Direction of 'key' in the flow, NULL: not needed
+ *
+ * @retval 1 flow added, 'dir' is ODPH_FLOW_DIR_ORIG
+ * @retval 0 flow of 'key' exists
+ * @retval <0 table full, or 'reply' belongs to another flow
+ */
+int odph_flow_add(odph_flow_table_t *tbl, const odph_flow_key_t *key,
+		  const odph_flow_key_t *reply, odph_flow_t **flow,
+		  odph_flow_dir_t *dir);
+
+/**
+ * Look up a flow
+ *
+ * @param tbl        Table
+ * @param key        Key of either direction
+ * @param[out] dir   Direction of 'key' in the flow, NULL: not needed
+ *
+ * @return Flow, NULL when not found or timed out
+ */
+odph_flow_t *odph_flow_lookup(odph_flow_table_t *tbl,
+			      const odph_flow_key_t *key,
+			      odph_flow_dir_t *dir);
+
+/**
+ * Look up multiple flows
+ *
+ * Hashes all keys and prefetches their buckets before walking them.
+ *
+ * @param tbl        Table
+ * @param key        Keys
+ * @param[out] flow  Flows, NULL when not found
+ * @param[out] dir   Directions, NULL: not needed
+ * @param num        Number of keys
+ *
+ * @return Number of flows found
+ */
+int odph_flow_lookup_multi(odph_flow_table_t *tbl, const odph_flow_key_t key[],
+			   odph_flow_t *flow[], odph_flow_dir_t dir[],
+			   int num);
+
+/**
+ * Delete a flow
+ *
+ * The flow is unlinked at once and recycled by the wheel of the thread
+ * that added it. 'expire_fn' is not called.
+ *
+ * @param tbl    Table
+ * @param flow   Flow
+ *
+ * @retval 0 on success
+ * @retval <0 flow already deleted or timed out
+ */
+int odph_flow_del(odph_flow_table_t *tbl, odph_flow_t *flow);
+
+/**
+ * Run the timer wheel of the calling thread
+ *
+ * Each thread that adds flows calls this periodically, e.g. once per
+ * burst of packets or from an odp_timer timeout handler. Also recycles
+ * the flows the thread added that were deleted.
+ *
+ * @param tbl    Table
+ *
+ * @return Number of flows timed out
+ */
+int odph_flow_age(odph_flow_table_t *tbl);
+
+/**
+ * Key of a flow
+ *
+ * @param flow   Flow
+ * @param dir    Direction
+ *
+ * @return Key
+ */
+const odph_flow_key_t *odph_flow_key(odph_flow_t *flow, odph_flow_dir_t dir);
+
+/**
+ * User data of a flow
+ *
+ * @param flow   Flow
+ *
+ * @return 'data_size' bytes, zeroed when the flow was added
+ */
+void *odph_flow_data(odph_flow_t *flow);
+
+/**
+ * User state of a flow, 0 when added
+ *
+ * @param flow   Flow
+ *
+ * @return State
+ */
+uint32_t odph_flow_state(odph_flow_t *flow);
+
+/**
+ * Set user state of a flow
+ *
+ * @param flow   Flow
+ * @param state  State
+ */
+void odph_flow_state_set(odph_flow_t *flow, uint32_t state);
+
+/**
+ * Set flow timeout
+ *
+ * E.g. a short timeout until a TCP handshake completes, a long one after.
+ *
+ * @param tbl        Table
+ * @param flow       Flow
+ * @param timeout_ns Timeout in nanoseconds from the last lookup
+ */
+void odph_flow_timeout_set(odph_flow_table_t *tbl, odph_flow_t *flow,
+			   uint64_t timeout_ns);
+
+/**
+ * Count a packet of a flow
+ *
+ * @param flow   Flow
+ * @param dir    Direction of the packet
+ * @param bytes  Packet length
+ */
+void odph_flow_count(odph_flow_t *flow, odph_flow_dir_t dir, uint32_t bytes);
+
+/**
+ * Packet and byte counters of a flow
+ *
+ * @param flow         Flow
+ * @param dir          Direction
+ * @param[out] packets Packets
+ * @param[out] bytes   Bytes
+ */
+void odph_flow_counters(odph_flow_t *flow, odph_flow_dir_t dir,
+			uint64_t *packets, uint64_t *bytes);
+
+/**
+ * Flow table statistics, sum of all threads
+ *
+ * @param tbl        Table
+ * @param[out] stats Statistics
+ */
+void odph_flow_table_stats(odph_flow_table_t *tbl,
+			   odph_flow_table_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
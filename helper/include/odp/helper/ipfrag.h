@@ -0,0 +1,166 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP IPv4 fragmentation and reassembly helper
+ *
+ * odph_ipv4_fragment() splits a packet into fragments that fit an MTU. The
+ * first fragment is the original packet trimmed in place, the others are
+ * allocated and filled with one copy of their share of the payload.
+ *
+ * A reassembly table collects the fragments of datagrams keyed by source,
+ * destination, protocol and IP ID. The table is split into shards, each
+ * with its own lock, hash buckets and a fixed number of datagram entries,
+ * so memory use is bounded and threads receiving different flows rarely
+ * contend. When a shard is full its oldest datagram is dropped to make
+ * room. Datagrams not completed within the timeout are dropped when
+ * odph_ipfrag_expire() is called, e.g. from an odp_timer timeout handler
+ * or periodically from the receive loop, or when their shard runs out of
+ * entries.
+ *
+ * Packets must have a valid L3 offset.
+ */
+
+#ifndef ODPH_IPFRAG_H_
+#define ODPH_IPFRAG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp.h>
+
+/** Maximum number of fragments of a datagram */
+#define ODPH_IPFRAG_MAX_FRAGS 64
+
+/** Default reassembly timeout in nanoseconds */
+#define ODPH_IPFRAG_TIMEOUT_NS (30 * ODP_TIME_SEC_IN_NS)
+
+/** Reassembly table */
+typedef struct odph_ipfrag_table_s odph_ipfrag_table_t;
+
+/** Reassembly table parameters */
+typedef struct {
+	/** Number of shards, power of two (default 1). Use e.g. the number
+	 *  of receiving threads. */
+	uint32_t num_shards;
+
+	/** Datagrams being reassembled, in total over all shards
+	 *  (default 1024) */
+	uint32_t max_flows;
+
+	/** Fragments per datagram, at most ODPH_IPFRAG_MAX_FRAGS
+	 *  (default 16) */
+	uint32_t max_frags;
+
+	/** Reassembly timeout in nanoseconds
+	 *  (default ODPH_IPFRAG_TIMEOUT_NS) */
+	uint64_t timeout_ns;
+} odph_ipfrag_param_t;
+
+/** Reassembly statistics */
+typedef struct {
+	uint64_t frags;		/**< Fragments received */
+	uint64_t reassembled;	/**< Datagrams reassembled */
+	uint64_t expired;	/**< Datagrams dropped on timeout */
+	uint64_t evicted;	/**< Datagrams dropped on a full shard */
+	uint64_t dropped;	/**< Bad, overlapping or excess fragments */
+} odph_ipfrag_stats_t;
+
+/**
+ * Fragment an IPv4 packet
+ *
+ * Splits a packet longer than 'mtu' bytes of IP datagram into fragments.
+ * Each fragment carries the L2 header of the packet. IP options are copied
+ * to the first fragment, only options with the copy flag to the others.
+ * Packet metadata other than L2 and L3 offsets is not copied.
+ *
+ * @param pkt        IPv4 packet, consumed on success
+ * @param mtu        Maximum IP datagram length of a fragment
+ * @param pool       Pool of the fragments after the first one,
+ *                   ODP_POOL_INVALID: pool of 'pkt'
+ * @param[out] frags Fragments, 'frags[0]' is 'pkt'
+ * @param max_frags  Size of 'frags'
+ *
+ * @return Number of fragments, 1 when the packet fits the MTU
+ * @retval <0 on failure: don't fragment set, too many fragments, bad
+ *            header or allocation failure. 'pkt' is not modified.
+ */
+int odph_ipv4_fragment(odp_packet_t pkt, uint32_t mtu, odp_pool_t pool,
+		       odp_packet_t frags[], int max_frags);
+
+/**
+ * Initialize reassembly table parameters
+ *
+ * @param param  Parameters to initialize to defaults
+ */
+void odph_ipfrag_param_init(odph_ipfrag_param_t *param);
+
+/**
+ * Create a reassembly table
+ *
+ * @param name   Table name, unique
+ * @param param  Table parameters
+ *
+ * @return Table, NULL on failure
+ */
+odph_ipfrag_table_t *odph_ipfrag_table_create(const char *name,
+					      const odph_ipfrag_param_t *param);
+
+/**
+ * Destroy a reassembly table
+ *
+ * Fragments held in the table are freed.
+ *
+ * @param tbl    Table
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odph_ipfrag_table_destroy(odph_ipfrag_table_t *tbl);
+
+/**
+ * Reassemble an IPv4 datagram
+ *
+ * A fragment is held in the table until its datagram is complete. The
+ * first fragment becomes the reassembled packet, the payload of the others
+ * is copied into it. Packets that are not fragments are returned as is.
+ *
+ * @param tbl      Table
+ * @param pkt      IPv4 packet or fragment, consumed
+ * @param[out] out Reassembled datagram when 1 is returned
+ *
+ * @retval 1 datagram in 'out'
+ * @retval 0 fragment held
+ * @retval <0 fragment dropped and freed
+ */
+int odph_ipv4_reassemble(odph_ipfrag_table_t *tbl, odp_packet_t pkt,
+			 odp_packet_t *out);
+
+/**
+ * Drop timed out datagrams
+ *
+ * @param tbl    Table
+ *
+ * @return Number of datagrams dropped
+ */
+int odph_ipfrag_expire(odph_ipfrag_table_t *tbl);
+
+/**
+ * Reassembly statistics, sum of all shards
+ *
+ * @param tbl        Table
+ * @param[out] stats Statistics
+ */
+void odph_ipfrag_stats(odph_ipfrag_table_t *tbl, odph_ipfrag_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -44,6 +44,34 @@ typedef struct {
 } odph_linux_pthread_t;
 
 
+/** Worker launcher parameters */
+typedef struct {
+	/** Number of workers, 0: one per available physical core */
+	int num;
+
+	/** NUMA node of the workers, e.g. odph_linux_netdev_node() of the
+	 *  interface the workers serve. -1: any node (default). */
+	int node;
+
+	/** 0: one worker per physical core (default), SMT siblings stay
+	 *  idle. 1: siblings are used when there are not enough cores. */
+	int smt;
+
+	/** 1: when the system has isolated CPUs (isolcpus, nohz_full), use
+	 *  only those (default). 0: use any CPU. */
+	int isolated;
+
+	/** 1..99: run workers in SCHED_FIFO class at this priority.
+	 *  0: default scheduling class (default). */
+	int fifo_prio;
+
+	/** 1: lock all current and future process memory (mlockall) */
+	int mlock;
+
+	/** Thread type (default ODP_THREAD_WORKER) */
+	odp_thread_type_t thr_type;
+} odph_linux_worker_param_t;
+
 /** Linux process state information */
 typedef struct {
 	pid_t pid;      /**< Process ID */
@@ -81,6 +109,60 @@ int odph_linux_pthread_create(odph_linux_pthread_t *thread_tbl,
 void odph_linux_pthread_join(odph_linux_pthread_t *thread_tbl, int num);
 
 
+/**
+ * Initialize worker launcher parameters
+ *
+ * @param param         Parameters to initialize to defaults
+ */
+void odph_linux_worker_param_init(odph_linux_worker_param_t *param);
+
+/**
+ * NUMA node of a network interface
+ *
+ * @param dev           Interface name, e.g. "eth0"
+ *
+ * @return Node number, or -1 if unknown (e.g. virtual interfaces)
+ */
+int odph_linux_netdev_node(const char *dev);
+
+/**
+ * Select worker CPUs from the system topology
+ *
+ * Reads cores, SMT siblings, NUMA nodes and isolated CPUs from sysfs and
+ * selects CPUs of the process affinity mask: one per physical core, on
+ * the requested node and isolated CPUs first. CPUs are allocated from the
+ * highest numbered down, the core of CPU 0 is left to control threads
+ * when possible.
+ *
+ * @param[out] mask     Selected CPUs
+ * @param param         Launcher parameters
+ *
+ * @return Number of CPUs selected, may be less than requested
+ */
+int odph_linux_cpumask_worker(odp_cpumask_t *mask,
+			      const odph_linux_worker_param_t *param);
+
+/**
+ * Launch pinned worker threads
+ *
+ * Selects CPUs with odph_linux_cpumask_worker(), applies the scheduling
+ * class and memory locking of the parameters and creates one thread per
+ * CPU like odph_linux_pthread_create(). The placement is printed.
+ * Scheduling and locking failures (e.g. missing privileges) are reported
+ * and do not prevent the launch.
+ *
+ * @param thread_tbl    Thread table, at least param->num entries or one
+ *                      per CPU when param->num is 0
+ * @param param         Launcher parameters
+ * @param start_routine Thread start function
+ * @param arg           Thread argument
+ *
+ * @return Number of threads created, join with odph_linux_pthread_join()
+ */
+int odph_linux_worker_create(odph_linux_pthread_t *thread_tbl,
+			     const odph_linux_worker_param_t *param,
+			     void *(*start_routine)(void *), void *arg);
+
 /**
  * Fork a process
  *
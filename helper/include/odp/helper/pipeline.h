@@ -0,0 +1,275 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP software pipeline helper
+ *
+ * A pipeline is a chain of stages, each run by its own worker threads. A
+ * stage function processes a burst of events and passes them on to a later
+ * stage with odph_pipeline_forward(), frees them or sends them out. The
+ * first stage is the source of the pipeline, it receives events itself,
+ * e.g. from packet input queues.
+ *
+ * Stages are connected with lock-free rings, one per worker of the
+ * receiving stage. A ring is single producer when only one worker runs
+ * before the stage. Bursts are spread over the workers of a parallel
+ * stage. An atomic stage steers all events of a flow to the same worker, so
+ * that events of a flow are processed one at a time and in order.
+ *
+ * An ordered stage and the stages after it are fed from scheduled queues of
+ * their own schedule group instead: ordered stage workers process events in
+ * parallel and the scheduler restores their order when they are forwarded
+ * to the next stage. An atomic stage after an ordered one has a queue per
+ * worker, flows are steered to the queues.
+ *
+ * A forward waits while the input of the next stage is full, which slows
+ * down the earlier stages down to the source (backpressure). Each worker
+ * counts events, calls and the CPU cycles spent in the stage function.
+ */
+
+#ifndef ODPH_PIPELINE_H_
+#define ODPH_PIPELINE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp.h>
+
+/** Maximum number of stages */
+#define ODPH_PIPELINE_MAX_STAGES  8
+
+/** Maximum number of workers of a pipeline */
+#define ODPH_PIPELINE_MAX_WORKERS 32
+
+/** Maximum number of events per stage function call */
+#define ODPH_PIPELINE_MAX_BURST   64
+
+/** Pipeline */
+typedef struct odph_pipeline_s odph_pipeline_t;
+
+/** Worker context, passed to stage functions */
+typedef struct odph_pipeline_ctx_s odph_pipeline_ctx_t;
+
+/** Stage synchronization */
+typedef enum {
+	/** Events are processed in parallel by the stage workers */
+	ODPH_PIPELINE_PARALLEL = 0,
+
+	/** Events of a flow are processed by one worker at a time, in
+	 *  order */
+	ODPH_PIPELINE_ATOMIC,
+
+	/** Events are processed in parallel, their order is restored when
+	 *  forwarded to the next stage */
+	ODPH_PIPELINE_ORDERED
+} odph_pipeline_sync_t;
+
+/**
+ * Stage function
+ *
+ * Called with a burst of 1 to 'burst' events, which the function forwards,
+ * frees or sends out. The source stage function is called with 'num' 0 and
+ * an array of 'burst' entries for its own use.
+ *
+ * @param ctx    Worker context
+ * @param ev     Events
+ * @param num    Number of events, 0 for the source stage
+ *
+ * @return Source stage: number of events received, 0 when idle.
+ *         Other stages: 0
+ */
+typedef int (*odph_pipeline_fn_t)(odph_pipeline_ctx_t *ctx,
+				  odp_event_t ev[], int num);
+
+/**
+ * Flow of an event for atomic stages
+ *
+ * @param ev     Event
+ *
+ * @return Flow identifier
+ */
+typedef uint32_t (*odph_pipeline_flow_fn_t)(odp_event_t ev);
+
+/** Stage parameters */
+typedef struct {
+	/** Stage name */
+	const char *name;
+
+	/** Stage function */
+	odph_pipeline_fn_t fn;
+
+	/** User argument, see odph_pipeline_arg() */
+	void *arg;
+
+	/** Number of workers (default 1) */
+	int num_workers;
+
+	/** Synchronization (default ODPH_PIPELINE_PARALLEL) */
+	odph_pipeline_sync_t sync;
+
+	/** Flow of an event for atomic stages. NULL: flow hash of packets,
+	 *  other events are flow 0 (default). */
+	odph_pipeline_flow_fn_t flow;
+
+	/** Maximum number of events per stage function call
+	 *  (default and maximum ODPH_PIPELINE_MAX_BURST) */
+	int burst;
+
+	/** Input ring size per worker, power of two (default 1024) */
+	uint32_t ring_size;
+} odph_pipeline_stage_param_t;
+
+/** Pipeline parameters */
+typedef struct {
+	/** Number of stages */
+	int num_stages;
+
+	/** Stage parameters */
+	odph_pipeline_stage_param_t stage[ODPH_PIPELINE_MAX_STAGES];
+
+	/** CPUs of the workers, each worker is pinned to one CPU in stage
+	 *  order. Workers share CPUs when there are more workers than CPUs.
+	 *  NULL: odp_cpumask_default_worker() (default). */
+	const odp_cpumask_t *cpumask;
+} odph_pipeline_param_t;
+
+/** Stage statistics */
+typedef struct {
+	uint64_t events;	/**< Events processed */
+	uint64_t calls;		/**< Stage function calls with events */
+	uint64_t busy_cycles;	/**< CPU cycles in those calls */
+	uint64_t cycles;	/**< CPU cycles the workers ran */
+	uint64_t stalls;	/**< Forward retries on a full next stage */
+} odph_pipeline_stats_t;
+
+/**
+ * Initialize pipeline parameters
+ *
+ * @param param  Parameters to initialize to defaults
+ */
+void odph_pipeline_param_init(odph_pipeline_param_t *param);
+
+/**
+ * Create a pipeline
+ *
+ * Creates the rings, queues and schedule groups of the stages. Workers
+ * are not started.
+ *
+ * @param name   Pipeline name, unique
+ * @param param  Pipeline parameters
+ *
+ * @return Pipeline, NULL on failure
+ */
+odph_pipeline_t *odph_pipeline_create(const char *name,
+				      const odph_pipeline_param_t *param);
+
+/**
+ * Start the pipeline workers
+ *
+ * @param pl     Pipeline
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odph_pipeline_start(odph_pipeline_t *pl);
+
+/**
+ * Stop the pipeline
+ *
+ * Stops the stages in order: the source first, then each stage once it
+ * has processed all events of the earlier stages. Waits for the workers to
+ * exit.
+ *
+ * @param pl     Pipeline
+ */
+void odph_pipeline_stop(odph_pipeline_t *pl);
+
+/**
+ * Destroy a stopped pipeline
+ *
+ * Events left in the stage inputs are freed.
+ *
+ * @param pl     Pipeline
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odph_pipeline_destroy(odph_pipeline_t *pl);
+
+/**
+ * Forward events to a later stage
+ *
+ * Waits while the input of the stage is full, unless the pipeline is being
+ * stopped. Events not forwarded remain owned by the caller.
+ *
+ * @param ctx    Worker context
+ * @param stage  Index of the stage, greater than the caller's stage
+ * @param ev     Events
+ * @param num    Number of events
+ *
+ * @return Number of events forwarded, <0 on a bad stage index
+ */
+int odph_pipeline_forward(odph_pipeline_ctx_t *ctx, int stage,
+			  odp_event_t ev[], int num);
+
+/**
+ * Stage of a worker
+ *
+ * @param ctx    Worker context
+ *
+ * @return Stage index
+ */
+int odph_pipeline_stage(odph_pipeline_ctx_t *ctx);
+
+/**
+ * Worker index within its stage
+ *
+ * @param ctx    Worker context
+ *
+ * @return 0 .. num_workers - 1
+ */
+int odph_pipeline_worker(odph_pipeline_ctx_t *ctx);
+
+/**
+ * User argument of a stage
+ *
+ * @param ctx    Worker context
+ *
+ * @return Stage parameter 'arg'
+ */
+void *odph_pipeline_arg(odph_pipeline_ctx_t *ctx);
+
+/**
+ * Statistics of a stage, sum of its workers
+ *
+ * Statistics of running workers are updated as they run, cycles when they
+ * exit.
+ *
+ * @param pl     Pipeline
+ * @param stage  Stage index
+ * @param[out] stats Statistics
+ *
+ * @retval 0 on success
+ * @retval <0 on a bad stage index
+ */
+int odph_pipeline_stats(odph_pipeline_t *pl, int stage,
+			odph_pipeline_stats_t *stats);
+
+/**
+ * Print the stages and their statistics
+ *
+ * @param pl     Pipeline
+ */
+void odph_pipeline_print(odph_pipeline_t *pl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
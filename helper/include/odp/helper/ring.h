@@ -194,6 +194,18 @@ typedef struct odph_ring {
 odph_ring_t *odph_ring_create(const char *name, unsigned count,
 			    unsigned flags);
 
+/**
+ * Free a ring
+ *
+ * The ring must be empty or its objects are lost.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @return
+ *   0 on success, <0 on failure
+ */
+int odph_ring_free(odph_ring_t *r);
+
 
 /**
  * Change the high water mark.
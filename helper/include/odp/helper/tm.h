@@ -0,0 +1,246 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP traffic manager helper
+ *
+ * A traffic manager sits between the application and the output of a
+ * packet IO interface opened in ODP_PKTOUT_MODE_SEND. Packets are enqueued
+ * to TM queues, which are the leaves of a hierarchy: the port at the root,
+ * classes under the port and queues under a class or directly under the
+ * port. odph_tm_send() picks packets down the hierarchy and sends them in
+ * a burst with odp_pktio_send().
+ *
+ * At each node the children are served in strict priority order, children
+ * of the same priority share the output by deficit weighted round robin.
+ * Every node may have a token bucket shaper. Tokens are refilled lazily from
+ * the time elapsed since the node was last visited, one timestamp per
+ * odph_tm_send() call, so no timers run. A shaped node is served while it
+ * has tokens left and may go one packet into debt.
+ *
+ * A queue drops packets at the tail when full, or earlier with weighted
+ * random early detection (WRED) on its average length.
+ *
+ * The hierarchy is built before packets are enqueued. Any thread may
+ * enqueue, one thread at a time calls odph_tm_send().
+ */
+
+#ifndef ODPH_TM_H_
+#define ODPH_TM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp.h>
+
+/** Maximum number of classes */
+#define ODPH_TM_MAX_CLASSES 16
+
+/** Maximum number of queues */
+#define ODPH_TM_MAX_QUEUES  64
+
+/** Number of strict priorities, 0 is the highest */
+#define ODPH_TM_PRIOS       4
+
+/** Maximum number of packets per odph_tm_send() call */
+#define ODPH_TM_MAX_BURST   64
+
+/** Parent of classes, and of queues directly under the port */
+#define ODPH_TM_PORT        (-1)
+
+/** Traffic manager */
+typedef struct odph_tm_s odph_tm_t;
+
+/** Token bucket shaper */
+typedef struct {
+	/** Rate in bits per second, 0: not shaped */
+	uint64_t rate_bps;
+
+	/** Bucket size in bytes, the burst sent at line rate after idle.
+	 *  0: 10 ms at the rate. */
+	uint32_t burst;
+} odph_tm_shaper_t;
+
+/** Class or queue parameters */
+typedef struct {
+	/** Strict priority among the siblings, 0 is the highest
+	 *  (default 0) */
+	uint32_t prio;
+
+	/** Weight among the siblings of the same priority (default 1) */
+	uint32_t weight;
+
+	/** Shaper (default not shaped) */
+	odph_tm_shaper_t shaper;
+} odph_tm_node_param_t;
+
+/** Queue drop policy */
+typedef enum {
+	/** Drop when full */
+	ODPH_TM_DROP_TAIL = 0,
+
+	/** Weighted random early detection, and drop when full */
+	ODPH_TM_DROP_WRED
+} odph_tm_drop_t;
+
+/** WRED parameters, on the average queue length in packets */
+typedef struct {
+	uint32_t min_th;	/**< No drops below */
+	uint32_t max_th;	/**< All dropped from */
+	uint32_t max_p;		/**< Drop probability at max_th, percent */
+} odph_tm_wred_t;
+
+/** Queue parameters */
+typedef struct {
+	/** Scheduling and shaping */
+	odph_tm_node_param_t node;
+
+	/** Queue size, power of two. Holds size - 1 packets
+	 *  (default 1024) */
+	uint32_t size;
+
+	/** Drop policy (default ODPH_TM_DROP_TAIL) */
+	odph_tm_drop_t drop;
+
+	/** WRED parameters */
+	odph_tm_wred_t wred;
+} odph_tm_queue_param_t;
+
+/** Traffic manager parameters */
+typedef struct {
+	/** Output interface */
+	odp_pktio_t pktio;
+
+	/** Port shaper (default not shaped) */
+	odph_tm_shaper_t shaper;
+
+	/** Bytes per unit of weight per round robin round (default 1536) */
+	uint32_t quantum;
+} odph_tm_param_t;
+
+/** Statistics of a queue, or the port */
+typedef struct {
+	uint64_t packets;	/**< Packets sent */
+	uint64_t bytes;		/**< Bytes sent */
+	uint64_t tail_drops;	/**< Packets dropped on a full queue */
+	uint64_t wred_drops;	/**< Packets dropped by WRED */
+} odph_tm_stats_t;
+
+/**
+ * Initialize traffic manager parameters
+ *
+ * @param param  Parameters to initialize to defaults
+ */
+void odph_tm_param_init(odph_tm_param_t *param);
+
+/**
+ * Initialize class parameters
+ *
+ * @param param  Parameters to initialize to defaults
+ */
+void odph_tm_node_param_init(odph_tm_node_param_t *param);
+
+/**
+ * Initialize queue parameters
+ *
+ * @param param  Parameters to initialize to defaults
+ */
+void odph_tm_queue_param_init(odph_tm_queue_param_t *param);
+
+/**
+ * Create a traffic manager
+ *
+ * @param name   Name, unique
+ * @param param  Parameters
+ *
+ * @return Traffic manager, NULL on failure
+ */
+odph_tm_t *odph_tm_create(const char *name, const odph_tm_param_t *param);
+
+/**
+ * Destroy a traffic manager
+ *
+ * Packets left in the queues are freed.
+ *
+ * @param tm     Traffic manager
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odph_tm_destroy(odph_tm_t *tm);
+
+/**
+ * Create a class under the port
+ *
+ * @param tm     Traffic manager
+ * @param param  Class parameters
+ *
+ * @return Class index
+ * @retval <0 on failure
+ */
+int odph_tm_class_create(odph_tm_t *tm, const odph_tm_node_param_t *param);
+
+/**
+ * Create a queue
+ *
+ * @param tm     Traffic manager
+ * @param parent Class index, or ODPH_TM_PORT
+ * @param param  Queue parameters
+ *
+ * @return Queue index
+ * @retval <0 on failure
+ */
+int odph_tm_queue_create(odph_tm_t *tm, int parent,
+			 const odph_tm_queue_param_t *param);
+
+/**
+ * Enqueue packets to a queue
+ *
+ * Packets are consumed: those not queued are dropped, freed and counted.
+ *
+ * @param tm     Traffic manager
+ * @param queue  Queue index
+ * @param pkt    Packets
+ * @param num    Number of packets
+ *
+ * @return Number of packets queued
+ * @retval <0 on a bad queue index, packets not consumed
+ */
+int odph_tm_enq_multi(odph_tm_t *tm, int queue, odp_packet_t pkt[], int num);
+
+/**
+ * Send packets
+ *
+ * Picks up to 'max' packets the shapers allow and sends them. Packets the
+ * interface does not accept are sent first on the next call.
+ *
+ * @param tm     Traffic manager
+ * @param max    Maximum number of packets, at most ODPH_TM_MAX_BURST
+ *
+ * @return Number of packets sent, 0 when nothing could be sent
+ */
+int odph_tm_send(odph_tm_t *tm, int max);
+
+/**
+ * Statistics of a queue or the port
+ *
+ * @param tm         Traffic manager
+ * @param queue      Queue index, or ODPH_TM_PORT for the sum of all queues
+ * @param[out] stats Statistics
+ *
+ * @retval 0 on success
+ * @retval <0 on a bad queue index
+ */
+int odph_tm_stats(odph_tm_t *tm, int queue, odph_tm_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
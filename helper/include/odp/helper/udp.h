@@ -51,6 +51,7 @@ static inline uint16_t odph_ipv4_udp_chksum(odp_packet_t pkt)
 	uint32_t sum = 0;
 	odph_udphdr_t *udph;
 	odph_ipv4hdr_t *iph;
+	uint32_t src, dst;
 	uint16_t udplen;
 	uint8_t *buf;
 
@@ -63,10 +64,12 @@ static inline uint16_t odph_ipv4_udp_chksum(odp_packet_t pkt)
 	iph = (odph_ipv4hdr_t *)odp_packet_l3_ptr(pkt, NULL);
 	udph = (odph_udphdr_t *)odp_packet_l4_ptr(pkt, NULL);
 	udplen = odp_be_to_cpu_16(udph->length);
+	src = odp_be_to_cpu_32(iph->src_addr);
+	dst = odp_be_to_cpu_32(iph->dst_addr);
 
 	/* 32-bit sum of all 16-bit words covered by UDP chksum */
-	sum = (iph->src_addr & 0xFFFF) + (iph->src_addr >> 16) +
-	      (iph->dst_addr & 0xFFFF) + (iph->dst_addr >> 16) +
+	sum = (src & 0xFFFF) + (src >> 16) +
+	      (dst & 0xFFFF) + (dst >> 16) +
 	      (uint16_t)iph->proto + udplen;
 	for (buf = (uint8_t *)udph; udplen > 1; udplen -= 2) {
 		sum += ((*buf << 8) + *(buf + 1));
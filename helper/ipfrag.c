@@ -0,0 +1,679 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <odp.h>
+#include <odp/helper/ip.h>
+#include <odp/helper/chksum.h>
+#include <odp/helper/ipfrag.h>
+#include "odph_debug.h"
+
+#define MAX_FLOWS_DEFAULT 1024
+#define MAX_FRAGS_DEFAULT 16
+#define IPV4_MAX_LEN      0xffff
+#define IPV4_MAX_HDR_LEN  60
+#define IPOPT_EOL         0
+#define IPOPT_NOP         1
+#define IPOPT_COPY        0x80
+#define IPV4_DF           0x4000
+#define IPV4_MF           0x2000
+#define IPV4_OFFSET       0x1fff
+
+#define ROUNDUP(x, align) ((((x) + (align) - 1) / (align)) * (align))
+
+/* Fragment held in the table */
+typedef struct {
+	odp_packet_t pkt;
+	uint16_t off;		/* Payload offset in the datagram */
+	uint16_t len;		/* Payload length */
+} frag_t;
+
+/* Datagram being reassembled */
+typedef struct flow_s {
+	struct flow_s *next;	/* Hash bucket or free list */
+	struct flow_s *lru_prev;
+	struct flow_s *lru_next;
+	uint32_t src;
+	uint32_t dst;
+	uint16_t id;
+	uint8_t proto;
+	uint32_t bucket;
+	uint64_t expire_ns;	/* Timeout from the first fragment */
+	uint32_t total;		/* Payload length, 0 until the last fragment */
+	uint32_t recv;		/* Payload bytes received */
+	uint32_t num;
+	frag_t frag[];
+} flow_t;
+
+/* Shard, oldest datagram at the LRU head */
+typedef struct ODP_ALIGNED_CACHE {
+	odp_spinlock_t lock;
+	flow_t **bucket;
+	flow_t *free;
+	flow_t *lru_head;
+	flow_t *lru_tail;
+	odph_ipfrag_stats_t stats;
+} shard_t;
+
+struct odph_ipfrag_table_s {
+	char name[ODP_SHM_NAME_LEN];
+	odp_shm_t shm;
+	uint32_t num_shards;
+	uint32_t bucket_mask;
+	uint32_t max_frags;
+	uint64_t timeout_ns;
+	shard_t shard[];
+};
+
+static inline uint64_t now_ns(void)
+{
+	return odp_time_to_ns(odp_time_global());
+}
+
+/* Copy 'len' bytes from one packet to another */
+static int copy_data(odp_packet_t dst, uint32_t dst_off,
+		     odp_packet_t src, uint32_t src_off, uint32_t len)
+{
+	uint32_t seglen;
+	uint8_t *data;
+
+	while (len) {
+		data = odp_packet_offset(src, src_off, &seglen, NULL);
+		if (data == NULL)
+			return -1;
+
+		if (seglen > len)
+			seglen = len;
+
+		if (odp_packet_copydata_in(dst, dst_off, seglen, data))
+			return -1;
+
+		src_off += seglen;
+		dst_off += seglen;
+		len     -= seglen;
+	}
+
+	return 0;
+}
+
+/* Read and check the IPv4 header at 'l3', returns header length */
+static int read_hdr(odp_packet_t pkt, uint32_t l3, uint8_t *hdr)
+{
+	odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)hdr;
+	uint32_t ihl;
+
+	if (l3 == ODP_PACKET_OFFSET_INVALID ||
+	    odp_packet_copydata_out(pkt, l3, ODPH_IPV4HDR_LEN, hdr))
+		return -1;
+
+	ihl = ODPH_IPV4HDR_IHL(ip->ver_ihl) * 4;
+	if (ODPH_IPV4HDR_VER(ip->ver_ihl) != ODPH_IPV4 ||
+	    ihl < ODPH_IPV4HDR_LEN || odp_be_to_cpu_16(ip->tot_len) < ihl ||
+	    l3 + odp_be_to_cpu_16(ip->tot_len) > odp_packet_len(pkt))
+		return -1;
+
+	if (ihl > ODPH_IPV4HDR_LEN &&
+	    odp_packet_copydata_out(pkt, l3 + ODPH_IPV4HDR_LEN,
+				    ihl - ODPH_IPV4HDR_LEN,
+				    hdr + ODPH_IPV4HDR_LEN))
+		return -1;
+
+	return ihl;
+}
+
+/* Write an IPv4 header with a fresh checksum */
+static int write_hdr(odp_packet_t pkt, uint32_t l3, uint8_t *hdr, int ihl)
+{
+	odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)hdr;
+
+	ip->chksum = 0;
+	ip->chksum = odp_chksum(hdr, ihl);
+
+	return odp_packet_copydata_in(pkt, l3, ihl, hdr);
+}
+
+/* Header of the second and later fragments: options with the copy flag */
+static int copied_hdr(const uint8_t *hdr, int ihl, uint8_t *out)
+{
+	int i = ODPH_IPV4HDR_LEN;
+	int len = ODPH_IPV4HDR_LEN;
+	int opt_len;
+
+	memcpy(out, hdr, ODPH_IPV4HDR_LEN);
+
+	while (i < ihl && hdr[i] != IPOPT_EOL) {
+		if (hdr[i] == IPOPT_NOP) {
+			i++;
+			continue;
+		}
+
+		if (i + 1 >= ihl)
+			return -1;
+
+		opt_len = hdr[i + 1];
+		if (opt_len < 2 || i + opt_len > ihl)
+			return -1;
+
+		if (hdr[i] & IPOPT_COPY) {
+			memcpy(&out[len], &hdr[i], opt_len);
+			len += opt_len;
+		}
+
+		i += opt_len;
+	}
+
+	while (len & 3)
+		out[len++] = IPOPT_EOL;
+
+	out[0] = (hdr[0] & 0xf0) | (len / 4);
+	return len;
+}
+
+int odph_ipv4_fragment(odp_packet_t pkt, uint32_t mtu, odp_pool_t pool,
+		       odp_packet_t frags[], int max_frags)
+{
+	uint8_t hdr[IPV4_MAX_HDR_LEN];
+	uint8_t hdr2[IPV4_MAX_HDR_LEN];
+	odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)hdr;
+	odph_ipv4hdr_t *ip2 = (odph_ipv4hdr_t *)hdr2;
+	uint32_t l2 = odp_packet_l2_offset(pkt);
+	uint32_t l3 = odp_packet_l3_offset(pkt);
+	uint32_t tot_len, payload, first, len, off, base;
+	uint16_t frag_off;
+	int ihl, ihl2, num, i;
+
+	ihl = read_hdr(pkt, l3, hdr);
+	if (ihl < 0) {
+		ODPH_DBG("Bad IPv4 header\n");
+		return -1;
+	}
+
+	tot_len = odp_be_to_cpu_16(ip->tot_len);
+	if (tot_len <= mtu) {
+		frags[0] = pkt;
+		return 1;
+	}
+
+	frag_off = odp_be_to_cpu_16(ip->frag_offset);
+	if (frag_off & IPV4_DF)
+		return -1;
+
+	ihl2 = copied_hdr(hdr, ihl, hdr2);
+	if (ihl2 < 0 || mtu < (uint32_t)ihl + 8)
+		return -1;
+
+	/* Fragment payloads are multiples of 8 bytes, except the last one */
+	payload = tot_len - ihl;
+	first   = (mtu - ihl) & ~7;
+	len     = (mtu - ihl2) & ~7;
+	num     = 1 + (payload - first + len - 1) / len;
+
+	if (num > max_frags)
+		return -1;
+
+	if (pool == ODP_POOL_INVALID)
+		pool = odp_packet_pool(pkt);
+
+	base = (frag_off & IPV4_OFFSET) * 8;
+	off  = first;
+
+	for (i = 1; i < num; i++) {
+		uint32_t flen = payload - off < len ? payload - off : len;
+		uint16_t flags = frag_off & IPV4_MF;
+		odp_packet_t frag;
+
+		if (i < num - 1)
+			flags = IPV4_MF;
+
+		frag = odp_packet_alloc(pool, l3 + ihl2 + flen);
+		frags[i] = frag;
+
+		if (frag == ODP_PACKET_INVALID ||
+		    copy_data(frag, 0, pkt, 0, l3) ||
+		    copy_data(frag, l3 + ihl2, pkt, l3 + ihl + off, flen)) {
+			ODPH_DBG("Fragment alloc failed\n");
+			if (frag == ODP_PACKET_INVALID)
+				i--;
+			for (; i > 0; i--)
+				odp_packet_free(frags[i]);
+			return -1;
+		}
+
+		ip2->tot_len     = odp_cpu_to_be_16(ihl2 + flen);
+		ip2->frag_offset = odp_cpu_to_be_16(flags |
+						    ((base + off) / 8));
+		write_hdr(frag, l3, hdr2, ihl2);
+
+		if (l2 != ODP_PACKET_OFFSET_INVALID)
+			odp_packet_l2_offset_set(frag, l2);
+		odp_packet_l3_offset_set(frag, l3);
+
+		off += flen;
+	}
+
+	/* The first fragment is the original packet, trimmed */
+	odp_packet_pull_tail(pkt, odp_packet_len(pkt) - (l3 + ihl + first));
+	ip->tot_len     = odp_cpu_to_be_16(ihl + first);
+	ip->frag_offset = odp_cpu_to_be_16(frag_off |
+					   IPV4_MF);
+	write_hdr(pkt, l3, hdr, ihl);
+
+	frags[0] = pkt;
+	return num;
+}
+
+void odph_ipfrag_param_init(odph_ipfrag_param_t *param)
+{
+	memset(param, 0, sizeof(*param));
+	param->num_shards = 1;
+	param->max_flows  = MAX_FLOWS_DEFAULT;
+	param->max_frags  = MAX_FRAGS_DEFAULT;
+	param->timeout_ns = ODPH_IPFRAG_TIMEOUT_NS;
+}
+
+static inline size_t flow_size(uint32_t max_frags)
+{
+	size_t size = sizeof(flow_t) + max_frags * sizeof(frag_t);
+
+	return ROUNDUP(size, sizeof(void *));
+}
+
+odph_ipfrag_table_t *odph_ipfrag_table_create(const char *name,
+					      const odph_ipfrag_param_t *param)
+{
+	odph_ipfrag_table_t *tbl;
+	odp_shm_t shm;
+	uint32_t flows, buckets, s, i;
+	size_t fsize, hdr_size, size;
+	uint8_t *ptr;
+
+	if (param->num_shards == 0 ||
+	    (param->num_shards & (param->num_shards - 1)) ||
+	    param->max_flows < param->num_shards ||
+	    param->max_frags == 0 ||
+	    param->max_frags > ODPH_IPFRAG_MAX_FRAGS) {
+		ODPH_ERR("Bad reassembly table parameters\n");
+		return NULL;
+	}
+
+	flows = param->max_flows / param->num_shards;
+
+	/* Two buckets per datagram */
+	buckets = 1;
+	while (buckets < 2 * flows)
+		buckets <<= 1;
+
+	fsize    = flow_size(param->max_frags);
+	hdr_size = ROUNDUP(sizeof(odph_ipfrag_table_t) +
+			   param->num_shards * sizeof(shard_t),
+			   ODP_CACHE_LINE_SIZE);
+	size     = hdr_size + param->num_shards *
+		   (buckets * sizeof(flow_t *) + flows * fsize);
+
+	shm = odp_shm_reserve(name, size, ODP_CACHE_LINE_SIZE, 0);
+	tbl = odp_shm_addr(shm);
+	if (tbl == NULL) {
+		ODPH_ERR("Reassembly table %s reserve failed\n", name);
+		return NULL;
+	}
+
+	memset(tbl, 0, size);
+	snprintf(tbl->name, sizeof(tbl->name), "%s", name);
+	tbl->shm         = shm;
+	tbl->num_shards  = param->num_shards;
+	tbl->bucket_mask = buckets - 1;
+	tbl->max_frags   = param->max_frags;
+	tbl->timeout_ns  = param->timeout_ns;
+
+	ptr = (uint8_t *)tbl + hdr_size;
+
+	for (s = 0; s < tbl->num_shards; s++) {
+		shard_t *shard = &tbl->shard[s];
+
+		odp_spinlock_init(&shard->lock);
+		shard->bucket = (flow_t **)ptr;
+		ptr += buckets * sizeof(flow_t *);
+
+		for (i = 0; i < flows; i++) {
+			flow_t *flow = (flow_t *)ptr;
+
+			flow->next  = shard->free;
+			shard->free = flow;
+			ptr += fsize;
+		}
+	}
+
+	return tbl;
+}
+
+static void free_frags(flow_t *flow)
+{
+	uint32_t i;
+
+	for (i = 0; i < flow->num; i++)
+		odp_packet_free(flow->frag[i].pkt);
+
+	flow->num = 0;
+}
+
+/* Unlink a datagram from its bucket and the LRU list */
+static void flow_remove(odph_ipfrag_table_t *tbl, shard_t *shard,
+			flow_t *flow)
+{
+	flow_t **prev = &shard->bucket[flow->bucket & tbl->bucket_mask];
+
+	while (*prev != flow)
+		prev = &(*prev)->next;
+	*prev = flow->next;
+
+	if (flow->lru_prev)
+		flow->lru_prev->lru_next = flow->lru_next;
+	else
+		shard->lru_head = flow->lru_next;
+
+	if (flow->lru_next)
+		flow->lru_next->lru_prev = flow->lru_prev;
+	else
+		shard->lru_tail = flow->lru_prev;
+
+	flow->next  = shard->free;
+	shard->free = flow;
+}
+
+static void flow_drop(odph_ipfrag_table_t *tbl, shard_t *shard,
+		      flow_t *flow)
+{
+	free_frags(flow);
+	flow_remove(tbl, shard, flow);
+}
+
+int odph_ipfrag_table_destroy(odph_ipfrag_table_t *tbl)
+{
+	uint32_t s;
+
+	for (s = 0; s < tbl->num_shards; s++) {
+		shard_t *shard = &tbl->shard[s];
+
+		while (shard->lru_head)
+			flow_drop(tbl, shard, shard->lru_head);
+	}
+
+	return odp_shm_free(tbl->shm);
+}
+
+static inline uint32_t flow_hash(uint32_t src, uint32_t dst, uint16_t id,
+				 uint8_t proto)
+{
+	uint32_t hash;
+
+	hash  = src * 0x9e3779b1;
+	hash ^= dst * 0x85ebca6b;
+	hash ^= (id | ((uint32_t)proto << 16)) * 0xc2b2ae35;
+	hash ^= hash >> 15;
+
+	return hash;
+}
+
+/* Move the fragments of a complete datagram into the first one */
+static int reassemble(odp_packet_t *out, frag_t frag[], uint32_t num,
+		      uint32_t total)
+{
+	uint8_t hdr[IPV4_MAX_HDR_LEN];
+	odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)hdr;
+	odp_packet_t pkt, new_pkt;
+	uint32_t l2, l3, len, i, j;
+	int ihl, ret = 0;
+	frag_t tmp;
+
+	/* Sort by offset, the fragments don't overlap */
+	for (i = 1; i < num; i++) {
+		tmp = frag[i];
+		for (j = i; j > 0 && frag[j - 1].off > tmp.off; j--)
+			frag[j] = frag[j - 1];
+		frag[j] = tmp;
+	}
+
+	pkt = frag[0].pkt;
+	l2  = odp_packet_l2_offset(pkt);
+	l3  = odp_packet_l3_offset(pkt);
+	ihl = read_hdr(pkt, l3, hdr);
+
+	/* Drop L2 padding, then make room for the rest of the payload */
+	len = l3 + ihl + frag[0].len;
+	odp_packet_pull_tail(pkt, odp_packet_len(pkt) - len);
+
+	if (odp_packet_tailroom(pkt) >= total - frag[0].len) {
+		odp_packet_push_tail(pkt, total - frag[0].len);
+	} else {
+		new_pkt = odp_packet_add_data(pkt, len, total - frag[0].len);
+		if (new_pkt == ODP_PACKET_INVALID) {
+			ret = -1;
+			pkt = ODP_PACKET_INVALID;
+		} else {
+			pkt = new_pkt;
+			if (l2 != ODP_PACKET_OFFSET_INVALID)
+				odp_packet_l2_offset_set(pkt, l2);
+			odp_packet_l3_offset_set(pkt, l3);
+		}
+	}
+
+	for (i = 1; i < num; i++) {
+		odp_packet_t src = frag[i].pkt;
+		uint8_t src_hdr[IPV4_MAX_HDR_LEN];
+		uint32_t src_l3 = odp_packet_l3_offset(src);
+		int src_ihl = read_hdr(src, src_l3, src_hdr);
+
+		if (ret == 0 &&
+		    copy_data(pkt, l3 + ihl + frag[i].off, src,
+			      src_l3 + src_ihl, frag[i].len))
+			ret = -1;
+
+		odp_packet_free(src);
+	}
+
+	if (ret) {
+		if (pkt != ODP_PACKET_INVALID)
+			odp_packet_free(pkt);
+		return -1;
+	}
+
+	ip->tot_len     = odp_cpu_to_be_16(ihl + total);
+	ip->frag_offset = odp_cpu_to_be_16(odp_be_to_cpu_16(ip->frag_offset) &
+					   IPV4_DF);
+	write_hdr(pkt, l3, hdr, ihl);
+
+	*out = pkt;
+	return 1;
+}
+
+int odph_ipv4_reassemble(odph_ipfrag_table_t *tbl, odp_packet_t pkt,
+			 odp_packet_t *out)
+{
+	uint8_t hdr[IPV4_MAX_HDR_LEN];
+	odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)hdr;
+	frag_t done[ODPH_IPFRAG_MAX_FRAGS];
+	uint32_t hash, src, dst, off, len, num, total, i;
+	uint16_t frag_off;
+	shard_t *shard;
+	flow_t *flow;
+	uint64_t now;
+	int ihl, mf;
+
+	ihl = read_hdr(pkt, odp_packet_l3_offset(pkt), hdr);
+	frag_off = odp_be_to_cpu_16(ip->frag_offset);
+
+	if (ihl >= 0 && !ODPH_IPV4HDR_IS_FRAGMENT(frag_off)) {
+		*out = pkt;
+		return 1;
+	}
+
+	shard = &tbl->shard[0];
+
+	len = odp_be_to_cpu_16(ip->tot_len) - ihl;
+	off = (frag_off & IPV4_OFFSET) * 8;
+	mf  = !!(frag_off & IPV4_MF);
+
+	if (ihl < 0 || (mf && (len == 0 || (len & 7))) ||
+	    ihl + off + len > IPV4_MAX_LEN)
+		goto drop;
+
+	src  = odp_be_to_cpu_32(ip->src_addr);
+	dst  = odp_be_to_cpu_32(ip->dst_addr);
+	hash = flow_hash(src, dst, ip->id, ip->proto);
+	now  = now_ns();
+
+	shard = &tbl->shard[(hash >> 24) & (tbl->num_shards - 1)];
+	odp_spinlock_lock(&shard->lock);
+	shard->stats.frags++;
+
+	for (flow = shard->bucket[hash & tbl->bucket_mask]; flow;
+	     flow = flow->next) {
+		if (flow->src == src && flow->dst == dst &&
+		    flow->id == ip->id && flow->proto == ip->proto)
+			break;
+	}
+
+	if (flow && flow->expire_ns <= now) {
+		flow_drop(tbl, shard, flow);
+		shard->stats.expired++;
+		flow = NULL;
+	}
+
+	if (flow == NULL) {
+		if (shard->free == NULL) {
+			flow_drop(tbl, shard, shard->lru_head);
+			shard->stats.evicted++;
+		}
+
+		flow = shard->free;
+		shard->free = flow->next;
+
+		flow->src       = src;
+		flow->dst       = dst;
+		flow->id        = ip->id;
+		flow->proto     = ip->proto;
+		flow->bucket    = hash;
+		flow->expire_ns = now + tbl->timeout_ns;
+		flow->total     = 0;
+		flow->recv      = 0;
+		flow->num       = 0;
+
+		flow->next = shard->bucket[hash & tbl->bucket_mask];
+		shard->bucket[hash & tbl->bucket_mask] = flow;
+
+		flow->lru_next = NULL;
+		flow->lru_prev = shard->lru_tail;
+		if (shard->lru_tail)
+			shard->lru_tail->lru_next = flow;
+		else
+			shard->lru_head = flow;
+		shard->lru_tail = flow;
+	}
+
+	for (i = 0; i < flow->num; i++) {
+		frag_t *f = &flow->frag[i];
+
+		if (off < (uint32_t)f->off + f->len && f->off < off + len) {
+			/* A duplicate is dropped, an overlap drops the
+			 * datagram */
+			if (f->off != off || f->len != len)
+				flow_drop(tbl, shard, flow);
+			goto drop_locked;
+		}
+	}
+
+	if ((!mf && flow->total && flow->total != off + len) ||
+	    (flow->total && off + len > flow->total) ||
+	    flow->num == tbl->max_frags) {
+		flow_drop(tbl, shard, flow);
+		goto drop_locked;
+	}
+
+	if (!mf)
+		flow->total = off + len;
+
+	flow->frag[flow->num].pkt = pkt;
+	flow->frag[flow->num].off = off;
+	flow->frag[flow->num].len = len;
+	flow->num++;
+	flow->recv += len;
+
+	if (flow->total == 0 || flow->recv != flow->total) {
+		odp_spinlock_unlock(&shard->lock);
+		return 0;
+	}
+
+	/* Complete, reassemble outside of the lock */
+	num   = flow->num;
+	total = flow->total;
+	memcpy(done, flow->frag, num * sizeof(frag_t));
+	flow->num = 0;
+	flow_remove(tbl, shard, flow);
+	shard->stats.reassembled++;
+	odp_spinlock_unlock(&shard->lock);
+
+	if (reassemble(out, done, num, total) == 1)
+		return 1;
+
+	odp_spinlock_lock(&shard->lock);
+	shard->stats.reassembled--;
+	shard->stats.dropped++;
+	odp_spinlock_unlock(&shard->lock);
+	return -1;
+
+drop:
+	odp_spinlock_lock(&shard->lock);
+drop_locked:
+	shard->stats.dropped++;
+	odp_spinlock_unlock(&shard->lock);
+	odp_packet_free(pkt);
+	return -1;
+}
+
+int odph_ipfrag_expire(odph_ipfrag_table_t *tbl)
+{
+	uint64_t now = now_ns();
+	int num = 0;
+	uint32_t s;
+
+	for (s = 0; s < tbl->num_shards; s++) {
+		shard_t *shard = &tbl->shard[s];
+
+		odp_spinlock_lock(&shard->lock);
+
+		/* Datagrams expire in LRU order */
+		while (shard->lru_head && shard->lru_head->expire_ns <= now) {
+			flow_drop(tbl, shard, shard->lru_head);
+			shard->stats.expired++;
+			num++;
+		}
+
+		odp_spinlock_unlock(&shard->lock);
+	}
+
+	return num;
+}
+
+void odph_ipfrag_stats(odph_ipfrag_table_t *tbl, odph_ipfrag_stats_t *stats)
+{
+	uint32_t s;
+
+	memset(stats, 0, sizeof(*stats));
+
+	for (s = 0; s < tbl->num_shards; s++) {
+		shard_t *shard = &tbl->shard[s];
+
+		odp_spinlock_lock(&shard->lock);
+		stats->frags       += shard->stats.frags;
+		stats->reassembled += shard->stats.reassembled;
+		stats->expired     += shard->stats.expired;
+		stats->evicted     += shard->stats.evicted;
+		stats->dropped     += shard->stats.dropped;
+		odp_spinlock_unlock(&shard->lock);
+	}
+}
@@ -32,16 +32,30 @@ typedef struct {
 	uint32_t node_sum;
 	/** size of a lineartable element,including the rwlock in the head */
 	uint32_t value_size;
+	/** size of the value content given at create */
+	uint32_t data_size;
+	/** readers take no locks, see odph_linear_table_rcu_create() */
+	uint32_t rcu;
 	void *value_array; /**< value pool in array format */
 	char name[ODPH_TABLE_NAME_LEN]; /**< name of the table */
 } odph_linear_table_imp;
 
+/** @internal head of a lineartable element in RCU mode
+ *  Two copies of the value follow, readers use the one selected by 'cur'.
+ *  Writers fill the other copy, switch 'cur' and wait for an RCU grace
+ *  period before the old copy can be written again.
+ */
+typedef struct {
+	odp_rwlock_t lock; /**< serializes writers only */
+	uint32_t cur; /**< copy read by readers, 0 or 1 */
+} odph_linear_rcu_head;
+
 /** Note: for linear table, key must be an number, its size is fixed 4.
  *  So, we ignore the input key_size here
  */
 
-odph_table_t odph_linear_table_create(const char *name, uint32_t capacity,
-				      uint32_t ODP_IGNORED, uint32_t value_size)
+static odph_table_t linear_table_create(const char *name, uint32_t capacity,
+					uint32_t value_size, int rcu)
 {
 	int idx;
 	uint32_t node_num;
@@ -71,7 +85,7 @@ odph_table_t odph_linear_table_create(const char *name, uint32_t capacity,
 	/* clean this block of memory */
 	memset(tbl, 0, capacity << 20);
 
-	tbl->init_cap = capacity < 20;
+	tbl->init_cap = capacity << 20;
 
 	strncpy(tbl->name, name, ODPH_TABLE_NAME_LEN - 1);
 
@@ -80,9 +94,15 @@ odph_table_t odph_linear_table_create(const char *name, uint32_t capacity,
 	 * there is a rwlock in the head of every node
 	 */
 
-	tbl->value_size = value_size + sizeof(odp_rwlock_t);
+	tbl->data_size = value_size;
+	tbl->rcu = rcu;
+	if (rcu)
+		tbl->value_size = sizeof(odph_linear_rcu_head) + 2 * value_size;
+	else
+		tbl->value_size = value_size + sizeof(odp_rwlock_t);
 
-	node_num = tbl->init_cap / tbl->value_size;
+	node_num = (tbl->init_cap - sizeof(odph_linear_table_imp)) /
+		   tbl->value_size;
 	tbl->node_sum = node_num;
 
 	tbl->value_array = (void *)((char *)tbl
@@ -100,6 +120,27 @@ odph_table_t odph_linear_table_create(const char *name, uint32_t capacity,
 	return (odph_table_t)(tbl);
 }
 
+odph_table_t odph_linear_table_create(const char *name, uint32_t capacity,
+				      uint32_t ODP_IGNORED, uint32_t value_size)
+{
+	return linear_table_create(name, capacity, value_size, 0);
+}
+
+/**
+ * Create a linear table read without locks
+ *
+ * odph_lineartable_get_value() takes no lock and writes nothing shared.
+ * odph_lineartable_put_value() waits for an RCU grace period, so threads
+ * reading the table must report quiescent states, e.g. by calling
+ * odp_schedule(). Each element keeps two copies of the value.
+ */
+odph_table_t odph_linear_table_rcu_create(const char *name, uint32_t capacity,
+					  uint32_t ODP_IGNORED,
+					  uint32_t value_size)
+{
+	return linear_table_create(name, capacity, value_size, 1);
+}
+
 int odph_linear_table_destroy(odph_table_t table)
 {
 	int ret;
@@ -158,6 +199,28 @@ int odph_lineartable_put_value(odph_table_t table, void *key, void *value)
 
 	entry = (void *)((char *)tbl->value_array + ikey * tbl->value_size);
 	lock = (odp_rwlock_t *)entry;
+
+	if (tbl->rcu) {
+		odph_linear_rcu_head *head = (odph_linear_rcu_head *)entry;
+		uint32_t spare;
+
+		odp_rwlock_write_lock(lock);
+
+		spare = head->cur ^ 1;
+		entry = (char *)entry + sizeof(odph_linear_rcu_head) +
+			spare * tbl->data_size;
+		memcpy(entry, value, tbl->data_size);
+
+		odp_mb_release();
+		*(volatile uint32_t *)&head->cur = spare;
+
+		/* the old copy is written by the next put */
+		odp_rcu_synchronize();
+
+		odp_rwlock_write_unlock(lock);
+		return ODPH_SUCCESS;
+	}
+
 	entry = (char *)entry + sizeof(odp_rwlock_t);
 
 	odp_rwlock_write_lock(lock);
@@ -187,6 +250,20 @@ int odph_lineartable_get_value(odph_table_t table, void *key, void *buffer,
 
 	entry = (void *)((char *)tbl->value_array + ikey * tbl->value_size);
 	lock = (odp_rwlock_t *)entry;
+
+	if (tbl->rcu) {
+		odph_linear_rcu_head *head = (odph_linear_rcu_head *)entry;
+		uint32_t cur = *(volatile uint32_t *)&head->cur;
+
+		if (buffer_size < tbl->data_size)
+			return ODPH_FAIL;
+
+		entry = (char *)entry + sizeof(odph_linear_rcu_head) +
+			cur * tbl->data_size;
+		memcpy(buffer, entry, tbl->data_size);
+		return ODPH_SUCCESS;
+	}
+
 	entry = (char *)entry + sizeof(odp_rwlock_t);
 
 	odp_rwlock_read_lock(lock);
@@ -207,3 +284,12 @@ odph_table_ops_t odph_linear_table_ops = {
 	NULL,
 	};
 
+odph_table_ops_t odph_linear_table_rcu_ops = {
+	odph_linear_table_rcu_create,
+	odph_linear_table_lookup,
+	odph_linear_table_destroy,
+	odph_lineartable_put_value,
+	odph_lineartable_get_value,
+	NULL,
+	};
+
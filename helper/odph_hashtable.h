@@ -23,6 +23,10 @@ odph_table_t odph_hash_table_create(const char *name,
 				    uint32_t capacity,
 				    uint32_t key_size,
 				    uint32_t value_size);
+odph_table_t odph_hash_table_rcu_create(const char *name,
+					uint32_t capacity,
+					uint32_t key_size,
+					uint32_t value_size);
 odph_table_t odph_hash_table_lookup(const char *name);
 int odph_hash_table_destroy(odph_table_t table);
 int odph_hash_put_value(odph_table_t table, void *key, void *value);
@@ -31,6 +35,7 @@ int odph_hash_get_value(odph_table_t table, void *key, void *buffer,
 int odph_hash_remove_value(odph_table_t table, void *key);
 
 extern odph_table_ops_t odph_hash_table_ops;
+extern odph_table_ops_t odph_hash_table_rcu_ops;
 
 #ifdef __cplusplus
 }
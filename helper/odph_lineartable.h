@@ -24,6 +24,10 @@ odph_table_t odph_linear_table_create(const char *name,
 				      uint32_t capacity,
 				      uint32_t ODP_IGNORED,
 				      uint32_t value_size);
+odph_table_t odph_linear_table_rcu_create(const char *name,
+					  uint32_t capacity,
+					  uint32_t ODP_IGNORED,
+					  uint32_t value_size);
 odph_table_t odph_linear_table_lookup(const char *name);
 int odph_linear_table_destroy(odph_table_t table);
 int odph_linear_put_value(odph_table_t table, void *key, void *value);
@@ -31,6 +35,7 @@ int odph_linear_get_value(odph_table_t table, void *key, void *buffer,
 			  uint32_t buffer_size);
 
 extern odph_table_ops_t odph_linear_table_ops;
+extern odph_table_ops_t odph_linear_table_rcu_ops;
 
 #ifdef __cplusplus
 }
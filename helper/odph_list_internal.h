@@ -14,6 +14,8 @@
 #ifndef ODPH_LIST_INTER_H_
 #define ODPH_LIST_INTER_H_
 
+#include <odp/sync.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -69,6 +71,54 @@ static inline int odph_list_empty(const struct odph_list_object *head)
 	return head->next == head;
 }
 
+/*
+ * RCU variants, for lists read without locks while updaters hold a lock.
+ * The next pointer of an entry is published only after the entry is
+ * initialized, and removed entries keep their pointers so that readers
+ * still on them can continue. A removed entry can be reused only after
+ * an RCU grace period.
+ */
+
+static inline odph_list_object *odph_list_next_rcu(odph_list_object *entry)
+{
+	/* Address dependency orders the reads through the returned entry */
+	return *(odph_list_object * volatile *)&entry->next;
+}
+
+static inline void odph_list_set_next_rcu(odph_list_object *entry,
+					  odph_list_object *next)
+{
+	/* Entry content is visible before the entry */
+	odp_mb_release();
+	*(odph_list_object * volatile *)&entry->next = next;
+}
+
+static inline void odph_list_add_rcu(odph_list_object *new,
+				     odph_list_object *head)
+{
+	odph_list_object *next = head->next;
+
+	new->next = next;
+	new->prev = head;
+	odph_list_set_next_rcu(head, new);
+	next->prev = new;
+}
+
+static inline void odph_list_del_rcu(odph_list_object *entry)
+{
+	odph_list_set_next_rcu(entry->prev, entry->next);
+	entry->next->prev = entry->prev;
+}
+
+static inline void odph_list_replace_rcu(odph_list_object *old,
+					 odph_list_object *new)
+{
+	new->next = old->next;
+	new->prev = old->prev;
+	odph_list_set_next_rcu(new->prev, new);
+	new->next->prev = new;
+}
+
 #define container_of(ptr, type, list_node) \
 		((type *)(void *)((char *)ptr - offsetof(type, list_node)))
 
@@ -77,6 +127,13 @@ static inline int odph_list_empty(const struct odph_list_object *head)
 		&pos->list_node != (list_head); \
 		pos = container_of(pos->list_node.next, type, list_node))
 
+#define ODPH_LIST_FOR_EACH_RCU(pos, list_head, type, list_node) \
+	for (pos = container_of(odph_list_next_rcu(list_head), type, \
+				list_node); \
+		&pos->list_node != (list_head); \
+		pos = container_of(odph_list_next_rcu(&pos->list_node), \
+				   type, list_node))
+
 #ifdef __cplusplus
 }
 #endif
@@ -9,9 +9,12 @@
 #endif
 #include <sched.h>
 #include <unistd.h>
+#include <dirent.h>
+#include <errno.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <sys/prctl.h>
+#include <sys/mman.h>
 
 #include <stdlib.h>
 #include <string.h>
@@ -44,10 +47,26 @@ static void *odp_run_start_routine(void *arg)
 	return ret_ptr;
 }
 
-int odph_linux_pthread_create(odph_linux_pthread_t *thread_tbl,
-			      const odp_cpumask_t *mask_in,
-			      void *(*start_routine)(void *), void *arg,
-			      odp_thread_type_t thr_type)
+/* Set SCHED_FIFO class into thread attributes */
+static int pthread_attr_fifo(pthread_attr_t *attr, int prio)
+{
+	struct sched_param param;
+
+	memset(&param, 0, sizeof(param));
+	param.sched_priority = prio;
+
+	if (pthread_attr_setinheritsched(attr, PTHREAD_EXPLICIT_SCHED) ||
+	    pthread_attr_setschedpolicy(attr, SCHED_FIFO) ||
+	    pthread_attr_setschedparam(attr, &param))
+		return -1;
+
+	return 0;
+}
+
+static int pthread_create_mask(odph_linux_pthread_t *thread_tbl,
+			       const odp_cpumask_t *mask_in,
+			       void *(*start_routine)(void *), void *arg,
+			       odp_thread_type_t thr_type, int fifo_prio)
 {
 	int i;
 	int num;
@@ -83,6 +102,10 @@ int odph_linux_pthread_create(odph_linux_pthread_t *thread_tbl,
 		pthread_attr_setaffinity_np(&thread_tbl[i].attr,
 					    sizeof(cpu_set_t), &thd_mask.set);
 
+		if (fifo_prio > 0 &&
+		    pthread_attr_fifo(&thread_tbl[i].attr, fifo_prio))
+			ODPH_ERR("Bad SCHED_FIFO priority %d\n", fifo_prio);
+
 		thread_tbl[i].start_args = malloc(sizeof(odp_start_args_t));
 		if (thread_tbl[i].start_args == NULL)
 			ODPH_ABORT("Malloc failed");
@@ -95,6 +118,17 @@ int odph_linux_pthread_create(odph_linux_pthread_t *thread_tbl,
 				     &thread_tbl[i].attr,
 				     odp_run_start_routine,
 				     thread_tbl[i].start_args);
+		if (ret == EPERM && fifo_prio > 0) {
+			/* No privileges for real-time class */
+			ODPH_ERR("SCHED_FIFO not permitted, cpu #%d runs in "
+				 "default class\n", cpu);
+			pthread_attr_setinheritsched(&thread_tbl[i].attr,
+						     PTHREAD_INHERIT_SCHED);
+			ret = pthread_create(&thread_tbl[i].thread,
+					     &thread_tbl[i].attr,
+					     odp_run_start_routine,
+					     thread_tbl[i].start_args);
+		}
 		if (ret != 0) {
 			ODPH_ERR("Failed to start thread on cpu #%d\n", cpu);
 			free(thread_tbl[i].start_args);
@@ -107,6 +141,15 @@ int odph_linux_pthread_create(odph_linux_pthread_t *thread_tbl,
 	return i;
 }
 
+int odph_linux_pthread_create(odph_linux_pthread_t *thread_tbl,
+			      const odp_cpumask_t *mask,
+			      void *(*start_routine)(void *), void *arg,
+			      odp_thread_type_t thr_type)
+{
+	return pthread_create_mask(thread_tbl, mask, start_routine, arg,
+				   thr_type, 0);
+}
+
 void odph_linux_pthread_join(odph_linux_pthread_t *thread_tbl, int num)
 {
 	int i;
@@ -124,6 +167,340 @@ void odph_linux_pthread_join(odph_linux_pthread_t *thread_tbl, int num)
 	}
 }
 
+#define SYSFS_CPU_DIR "/sys/devices/system/cpu"
+#define SYSFS_NET_DIR "/sys/class/net"
+
+/* CPU topology read from sysfs */
+typedef struct {
+	odp_cpumask_t avail;	/**< online CPUs in process affinity */
+	odp_cpumask_t isolated;	/**< isolcpus and nohz_full CPUs */
+	struct {
+		int core;	/**< first SMT sibling, identifies the core */
+		int core_id;	/**< core_id in package */
+		int package;	/**< physical_package_id */
+		int node;	/**< NUMA node */
+	} cpu[CPU_SETSIZE];
+} cpu_topo_t;
+
+/* Read an integer from a sysfs file, 'def' if not available */
+static int sysfs_read_int(const char *path, int def)
+{
+	FILE *file;
+	int val;
+
+	file = fopen(path, "r");
+	if (file == NULL)
+		return def;
+
+	if (fscanf(file, "%i", &val) != 1)
+		val = def;
+
+	fclose(file);
+	return val;
+}
+
+/* Parse a cpulist file ("0-3,8,10-11"). Missing files, empty lists and
+ * "(null)" result an empty mask. */
+static void sysfs_read_cpulist(const char *path, odp_cpumask_t *mask)
+{
+	char buf[1024];
+	char *str, *end;
+	FILE *file;
+	long first, last;
+
+	odp_cpumask_zero(mask);
+
+	file = fopen(path, "r");
+	if (file == NULL)
+		return;
+
+	if (fgets(buf, sizeof(buf), file) == NULL) {
+		fclose(file);
+		return;
+	}
+
+	fclose(file);
+
+	str = buf;
+	while (*str >= '0' && *str <= '9') {
+		first = strtol(str, &end, 10);
+		last  = first;
+
+		if (*end == '-')
+			last = strtol(end + 1, &end, 10);
+
+		for (; first <= last && first < CPU_SETSIZE; first++)
+			odp_cpumask_set(mask, first);
+
+		if (*end != ',')
+			break;
+
+		str = end + 1;
+	}
+}
+
+/* NUMA node of a CPU from its nodeN directory entry */
+static int sysfs_cpu_node(int cpu)
+{
+	char path[64];
+	struct dirent *ent;
+	DIR *dir;
+	int node = 0;
+
+	snprintf(path, sizeof(path), SYSFS_CPU_DIR "/cpu%i", cpu);
+
+	dir = opendir(path);
+	if (dir == NULL)
+		return 0;
+
+	while ((ent = readdir(dir)) != NULL) {
+		if (strncmp(ent->d_name, "node", 4) == 0 &&
+		    ent->d_name[4] >= '0' && ent->d_name[4] <= '9') {
+			node = atoi(&ent->d_name[4]);
+			break;
+		}
+	}
+
+	closedir(dir);
+	return node;
+}
+
+static int cpu_topo_read(cpu_topo_t *topo)
+{
+	char path[96];
+	odp_cpumask_t online, affinity, siblings;
+	int cpu;
+
+	if (sched_getaffinity(0, sizeof(cpu_set_t), &affinity.set)) {
+		ODPH_ERR("sched_getaffinity() failed\n");
+		return -1;
+	}
+
+	sysfs_read_cpulist(SYSFS_CPU_DIR "/online", &online);
+	if (odp_cpumask_count(&online) == 0)
+		odp_cpumask_copy(&online, &affinity);
+
+	odp_cpumask_and(&topo->avail, &online, &affinity);
+
+	sysfs_read_cpulist(SYSFS_CPU_DIR "/isolated", &topo->isolated);
+	sysfs_read_cpulist(SYSFS_CPU_DIR "/nohz_full", &siblings);
+	odp_cpumask_or(&topo->isolated, &topo->isolated, &siblings);
+
+	for (cpu = odp_cpumask_first(&topo->avail); cpu >= 0;
+	     cpu = odp_cpumask_next(&topo->avail, cpu)) {
+		snprintf(path, sizeof(path),
+			 SYSFS_CPU_DIR "/cpu%i/topology/core_id", cpu);
+		topo->cpu[cpu].core_id = sysfs_read_int(path, cpu);
+
+		snprintf(path, sizeof(path),
+			 SYSFS_CPU_DIR "/cpu%i/topology/physical_package_id",
+			 cpu);
+		topo->cpu[cpu].package = sysfs_read_int(path, 0);
+
+		snprintf(path, sizeof(path),
+			 SYSFS_CPU_DIR "/cpu%i/topology/thread_siblings_list",
+			 cpu);
+		sysfs_read_cpulist(path, &siblings);
+		topo->cpu[cpu].core = odp_cpumask_first(&siblings);
+		if (topo->cpu[cpu].core < 0)
+			topo->cpu[cpu].core = cpu;
+
+		topo->cpu[cpu].node = sysfs_cpu_node(cpu);
+	}
+
+	return 0;
+}
+
+/* Select up to 'num' CPUs from 'cand', highest first. Pass 0 takes one CPU
+ * per free core except the control core, pass 1 the control core and
+ * pass 2 (smt) SMT siblings of used cores. */
+static int cpu_topo_select(const cpu_topo_t *topo, const odp_cpumask_t *cand,
+			   int num, int smt, odp_cpumask_t *mask)
+{
+	odp_cpumask_t cores;
+	int ctrl_core, cpu, pass, count = 0;
+
+	odp_cpumask_zero(mask);
+	odp_cpumask_zero(&cores);
+
+	ctrl_core = odp_cpumask_isset(&topo->avail, 0) ? topo->cpu[0].core : -1;
+
+	for (pass = 0; pass < 3; pass++) {
+		if (num == 0 && count > 0)
+			break;
+
+		if (pass == 2 && !smt)
+			break;
+
+		for (cpu = odp_cpumask_last(cand); cpu >= 0; cpu--) {
+			int core = topo->cpu[cpu].core;
+
+			if (num && count == num)
+				return count;
+
+			if (!odp_cpumask_isset(cand, cpu) ||
+			    odp_cpumask_isset(mask, cpu))
+				continue;
+
+			if (pass < 2 && odp_cpumask_isset(&cores, core))
+				continue;
+
+			if (pass == 0 && core == ctrl_core)
+				continue;
+
+			odp_cpumask_set(mask, cpu);
+			odp_cpumask_set(&cores, core);
+			count++;
+		}
+	}
+
+	return count;
+}
+
+static int cpumask_worker(cpu_topo_t *topo, odp_cpumask_t *mask,
+			  const odph_linux_worker_param_t *param)
+{
+	odp_cpumask_t cand, tmp;
+	int cpu;
+
+	if (cpu_topo_read(topo))
+		return 0;
+
+	odp_cpumask_copy(&cand, &topo->avail);
+
+	if (param->node >= 0) {
+		odp_cpumask_zero(&tmp);
+
+		for (cpu = odp_cpumask_first(&cand); cpu >= 0;
+		     cpu = odp_cpumask_next(&cand, cpu))
+			if (topo->cpu[cpu].node == param->node)
+				odp_cpumask_set(&tmp, cpu);
+
+		if (odp_cpumask_count(&tmp))
+			odp_cpumask_copy(&cand, &tmp);
+		else
+			ODPH_DBG("No CPUs on node %i, using any node\n",
+				 param->node);
+	}
+
+	if (param->isolated) {
+		odp_cpumask_and(&tmp, &cand, &topo->isolated);
+
+		if (odp_cpumask_count(&tmp))
+			odp_cpumask_copy(&cand, &tmp);
+	}
+
+	return cpu_topo_select(topo, &cand, param->num, param->smt, mask);
+}
+
+void odph_linux_worker_param_init(odph_linux_worker_param_t *param)
+{
+	memset(param, 0, sizeof(odph_linux_worker_param_t));
+	param->node     = -1;
+	param->isolated = 1;
+	param->thr_type = ODP_THREAD_WORKER;
+}
+
+int odph_linux_netdev_node(const char *dev)
+{
+	char path[128];
+
+	snprintf(path, sizeof(path), SYSFS_NET_DIR "/%s/device/numa_node",
+		 dev);
+
+	/* Kernel reports -1 when the device has no node affinity */
+	return sysfs_read_int(path, -1);
+}
+
+int odph_linux_cpumask_worker(odp_cpumask_t *mask,
+			      const odph_linux_worker_param_t *param)
+{
+	cpu_topo_t *topo;
+	int num;
+
+	topo = malloc(sizeof(cpu_topo_t));
+	if (topo == NULL) {
+		ODPH_ERR("Malloc failed\n");
+		odp_cpumask_zero(mask);
+		return 0;
+	}
+
+	num = cpumask_worker(topo, mask, param);
+
+	free(topo);
+	return num;
+}
+
+static void worker_print(const cpu_topo_t *topo, const odp_cpumask_t *mask,
+			 const odph_linux_pthread_t *thread_tbl, int num)
+{
+	int i, cpu, sib;
+
+	printf("\nWorker placement\n");
+	printf("  thread  cpu  core  package  node\n");
+
+	for (i = 0; i < num; i++) {
+		cpu = thread_tbl[i].cpu;
+
+		printf("  %6i  %3i  %4i  %7i  %4i", i, cpu,
+		       topo->cpu[cpu].core_id, topo->cpu[cpu].package,
+		       topo->cpu[cpu].node);
+
+		if (odp_cpumask_isset(&topo->isolated, cpu))
+			printf("  isolated");
+
+		for (sib = odp_cpumask_first(mask); sib >= 0;
+		     sib = odp_cpumask_next(mask, sib)) {
+			if (sib != cpu &&
+			    topo->cpu[sib].core == topo->cpu[cpu].core) {
+				printf("  sibling busy");
+				break;
+			}
+		}
+
+		printf("\n");
+	}
+
+	printf("\n");
+}
+
+int odph_linux_worker_create(odph_linux_pthread_t *thread_tbl,
+			     const odph_linux_worker_param_t *param,
+			     void *(*start_routine)(void *), void *arg)
+{
+	odp_cpumask_t mask;
+	cpu_topo_t *topo;
+	int num;
+
+	topo = malloc(sizeof(cpu_topo_t));
+	if (topo == NULL) {
+		ODPH_ERR("Malloc failed\n");
+		return 0;
+	}
+
+	num = cpumask_worker(topo, &mask, param);
+	if (num == 0) {
+		ODPH_ERR("No CPUs for workers\n");
+		free(topo);
+		return 0;
+	}
+
+	if (param->num && num < param->num)
+		ODPH_ERR("Only %i of %i workers placed\n", num, param->num);
+
+	/* Page faults on first touch are latency spikes in the fast path */
+	if (param->mlock && mlockall(MCL_CURRENT | MCL_FUTURE))
+		ODPH_ERR("mlockall() failed: %s\n", strerror(errno));
+
+	num = pthread_create_mask(thread_tbl, &mask, start_routine, arg,
+				  param->thr_type, param->fifo_prio);
+
+	worker_print(topo, &mask, thread_tbl, num);
+
+	free(topo);
+	return num;
+}
+
 int odph_linux_process_fork_n(odph_linux_process_t *proc_tbl,
 			      const odp_cpumask_t *mask_in)
 {
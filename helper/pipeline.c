@@ -0,0 +1,771 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sched.h>
+
+#include <odp.h>
+#include <odp/helper/linux.h>
+#include <odp/helper/ring.h>
+#include <odp/helper/pipeline.h>
+#include "odph_debug.h"
+#include "odph_pause.h"
+
+#define RING_SIZE_DEFAULT 1024
+
+/* Empty polls or full forwards before yielding the CPU */
+#define IDLE_SPIN         64
+
+/* Rings carry events as pointers */
+_ODP_STATIC_ASSERT(sizeof(odp_event_t) == sizeof(void *),
+		   "Event handle is not pointer sized");
+
+/* Worker context */
+struct odph_pipeline_ctx_s {
+	odph_pipeline_t *pl;
+	int stage;		/* Stage index */
+	int worker;		/* Worker index within the stage */
+	odph_ring_t *ring;	/* Input ring, NULL: stage fed from queues */
+	/* Next worker or queue of each later stage for parallel forwards */
+	uint32_t next[ODPH_PIPELINE_MAX_STAGES];
+	odph_pipeline_stats_t stats;
+} ODP_ALIGNED_CACHE;
+
+/* Stage */
+typedef struct {
+	odph_pipeline_stage_param_t param;
+	char name[ODP_QUEUE_NAME_LEN];
+	int first;		/* First worker context */
+	int queue_input;	/* Fed from scheduled queues instead of rings */
+	int num_queues;
+	odp_queue_t queue[ODPH_PIPELINE_MAX_WORKERS];
+	odp_schedule_group_t group;
+	odp_atomic_u32_t running; /* Workers running */
+} stage_t;
+
+struct odph_pipeline_s {
+	char name[ODP_SHM_NAME_LEN];
+	odp_shm_t shm;
+	int num_stages;
+	int num_workers;
+	int num_threads;	/* Threads started */
+	int has_cpumask;
+	odp_cpumask_t cpumask;
+	/* Stages below this index have been stopped */
+	odp_atomic_u32_t stop_stage;
+	stage_t stage[ODPH_PIPELINE_MAX_STAGES];
+	odph_pipeline_ctx_t ctx[ODPH_PIPELINE_MAX_WORKERS];
+	odph_linux_pthread_t thread_tbl[ODPH_PIPELINE_MAX_WORKERS];
+};
+
+static const char *sync_str[] = {"parallel", "atomic", "ordered"};
+
+void odph_pipeline_param_init(odph_pipeline_param_t *param)
+{
+	int i;
+
+	memset(param, 0, sizeof(*param));
+
+	for (i = 0; i < ODPH_PIPELINE_MAX_STAGES; i++) {
+		param->stage[i].num_workers = 1;
+		param->stage[i].sync        = ODPH_PIPELINE_PARALLEL;
+		param->stage[i].burst       = ODPH_PIPELINE_MAX_BURST;
+		param->stage[i].ring_size   = RING_SIZE_DEFAULT;
+	}
+}
+
+static int check_param(const odph_pipeline_param_t *param)
+{
+	const odph_pipeline_stage_param_t *sp;
+	int num_workers = 0;
+	int i;
+
+	if (param->num_stages < 1 ||
+	    param->num_stages > ODPH_PIPELINE_MAX_STAGES) {
+		ODPH_ERR("Bad number of stages %i\n", param->num_stages);
+		return -1;
+	}
+
+	for (i = 0; i < param->num_stages; i++) {
+		sp = &param->stage[i];
+
+		if (sp->fn == NULL || sp->num_workers < 1 ||
+		    sp->burst < 1 || sp->burst > ODPH_PIPELINE_MAX_BURST ||
+		    sp->ring_size < 2 ||
+		    (sp->ring_size & (sp->ring_size - 1))) {
+			ODPH_ERR("Bad parameters of stage %i\n", i);
+			return -1;
+		}
+
+		num_workers += sp->num_workers;
+	}
+
+	if (num_workers > ODPH_PIPELINE_MAX_WORKERS) {
+		ODPH_ERR("Too many workers %i\n", num_workers);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Scheduled queues of an ordered stage or a stage after one */
+static int create_queues(odph_pipeline_t *pl, stage_t *st)
+{
+	odp_queue_param_t qparam;
+	odp_thrmask_t zero;
+	char name[ODP_QUEUE_NAME_LEN];
+	int i;
+
+	snprintf(name, sizeof(name), "%s.%s", pl->name, st->name);
+	odp_thrmask_zero(&zero);
+	st->group = odp_schedule_group_create(name, &zero);
+	if (st->group == ODP_SCHED_GROUP_INVALID) {
+		ODPH_ERR("Schedule group %s create failed\n", name);
+		return -1;
+	}
+
+	odp_queue_param_init(&qparam);
+	qparam.sched.prio  = ODP_SCHED_PRIO_DEFAULT;
+	qparam.sched.group = st->group;
+
+	switch (st->param.sync) {
+	case ODPH_PIPELINE_ATOMIC:
+		qparam.sched.sync = ODP_SCHED_SYNC_ATOMIC;
+		st->num_queues = st->param.num_workers;
+		break;
+	case ODPH_PIPELINE_ORDERED:
+		qparam.sched.sync = ODP_SCHED_SYNC_ORDERED;
+		st->num_queues = 1;
+		break;
+	default:
+		qparam.sched.sync = ODP_SCHED_SYNC_NONE;
+		st->num_queues = 1;
+		break;
+	}
+
+	for (i = 0; i < st->num_queues; i++) {
+		snprintf(name, sizeof(name), "%s.%s.%i", pl->name, st->name,
+			 i);
+		st->queue[i] = odp_queue_create(name, ODP_QUEUE_TYPE_SCHED,
+						&qparam);
+		if (st->queue[i] == ODP_QUEUE_INVALID) {
+			ODPH_ERR("Queue %s create failed\n", name);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+odph_pipeline_t *odph_pipeline_create(const char *name,
+				      const odph_pipeline_param_t *param)
+{
+	odph_pipeline_t *pl;
+	odp_shm_t shm;
+	char ring_name[ODPH_RING_NAMESIZE];
+	int producers = 0;
+	int ordered = 0;
+	int w = 0;
+	int s, i;
+
+	if (check_param(param))
+		return NULL;
+
+	shm = odp_shm_reserve(name, sizeof(odph_pipeline_t),
+			      ODP_CACHE_LINE_SIZE, 0);
+	pl = odp_shm_addr(shm);
+	if (pl == NULL) {
+		ODPH_ERR("Pipeline %s reserve failed\n", name);
+		return NULL;
+	}
+
+	memset(pl, 0, sizeof(*pl));
+	snprintf(pl->name, sizeof(pl->name), "%s", name);
+	pl->shm        = shm;
+	pl->num_stages = param->num_stages;
+	odp_atomic_init_u32(&pl->stop_stage, 0);
+
+	if (param->cpumask) {
+		odp_cpumask_copy(&pl->cpumask, param->cpumask);
+		pl->has_cpumask = 1;
+	}
+
+	for (s = 0; s < pl->num_stages; s++)
+		pl->stage[s].group = ODP_SCHED_GROUP_INVALID;
+
+	for (s = 0; s < pl->num_stages; s++) {
+		stage_t *st = &pl->stage[s];
+
+		st->param = param->stage[s];
+		if (st->param.name)
+			snprintf(st->name, sizeof(st->name), "%s",
+				 st->param.name);
+		else
+			snprintf(st->name, sizeof(st->name), "stage%i", s);
+		st->param.name = st->name;
+		st->first = w;
+		odp_atomic_init_u32(&st->running, 0);
+
+		/* The source has no input and no order to keep */
+		if (s == 0)
+			st->param.sync = ODPH_PIPELINE_PARALLEL;
+		else if (st->param.sync == ODPH_PIPELINE_ORDERED)
+			ordered = 1;
+
+		st->queue_input = ordered;
+		if (st->queue_input && create_queues(pl, st))
+			goto error;
+
+		for (i = 0; i < st->param.num_workers; i++, w++) {
+			odph_pipeline_ctx_t *ctx = &pl->ctx[w];
+			unsigned flags = ODPH_RING_F_SC_DEQ;
+
+			ctx->pl     = pl;
+			ctx->stage  = s;
+			ctx->worker = i;
+
+			if (s == 0 || st->queue_input)
+				continue;
+
+			/* Only workers of earlier stages forward here */
+			if (producers == 1)
+				flags |= ODPH_RING_F_SP_ENQ;
+
+			snprintf(ring_name, sizeof(ring_name), "%.20s.r%i",
+				 pl->name, w);
+			ctx->ring = odph_ring_create(ring_name,
+						     st->param.ring_size,
+						     flags);
+			if (ctx->ring == NULL)
+				goto error;
+		}
+
+		producers += st->param.num_workers;
+	}
+
+	pl->num_workers = w;
+	return pl;
+
+error:
+	pl->num_workers = w;
+	odph_pipeline_destroy(pl);
+	return NULL;
+}
+
+/* Spin a while, then let other workers sharing the CPU run */
+static inline void idle_wait(uint32_t *idle)
+{
+	if (++(*idle) < IDLE_SPIN) {
+		odph_pause();
+		return;
+	}
+
+	*idle = 0;
+	sched_yield();
+}
+
+static inline int stage_stopped(odph_pipeline_t *pl, int stage)
+{
+	return odp_atomic_load_u32(&pl->stop_stage) > (uint32_t)stage;
+}
+
+static inline uint32_t event_flow(const stage_t *st, odp_event_t ev)
+{
+	odp_packet_t pkt;
+
+	if (st->param.flow)
+		return st->param.flow(ev);
+
+	if (odp_event_type(ev) == ODP_EVENT_PACKET) {
+		pkt = odp_packet_from_event(ev);
+		if (odp_packet_has_flow_hash(pkt))
+			return odp_packet_flow_hash(pkt);
+	}
+
+	return 0;
+}
+
+/* Enqueue to a ring or a queue, wait while it is full */
+static int enq_wait(odph_pipeline_ctx_t *ctx, int stage, odph_ring_t *ring,
+		    odp_queue_t queue, odp_event_t ev[], int num)
+{
+	uint32_t idle = 0;
+	int sent = 0;
+	int ret;
+
+	while (sent < num) {
+		if (ring)
+			ret = odph_ring_enqueue_burst(ring,
+						      (void **)&ev[sent],
+						      num - sent) &
+			      ODPH_RING_SZ_MASK;
+		else
+			ret = odp_queue_enq_multi(queue, &ev[sent],
+						  num - sent);
+
+		if (ret > 0) {
+			sent += ret;
+			continue;
+		}
+
+		if (stage_stopped(ctx->pl, stage))
+			break;
+
+		ctx->stats.stalls++;
+		idle_wait(&idle);
+	}
+
+	return sent;
+}
+
+/* Input ring or queue of worker or queue 'idx' of a stage */
+static inline void stage_input(const stage_t *st, odph_pipeline_t *pl,
+			       uint32_t idx, odph_ring_t **ring,
+			       odp_queue_t *queue)
+{
+	if (st->queue_input) {
+		*ring  = NULL;
+		*queue = st->queue[idx];
+	} else {
+		*ring  = pl->ctx[st->first + idx].ring;
+		*queue = ODP_QUEUE_INVALID;
+	}
+}
+
+/* Steer events to workers or queues by flow, keeping their order */
+static int forward_flow(odph_pipeline_ctx_t *ctx, int stage,
+			odp_event_t ev[], int num)
+{
+	odph_pipeline_t *pl = ctx->pl;
+	const stage_t *st = &pl->stage[stage];
+	uint32_t n = st->queue_input ? (uint32_t)st->num_queues :
+				       (uint32_t)st->param.num_workers;
+	odp_event_t tmp[num];
+	uint8_t dst[num];
+	odph_ring_t *ring;
+	odp_queue_t queue;
+	int sent = 0;
+	uint32_t idx;
+	int i, cnt;
+
+	for (i = 0; i < num; i++)
+		dst[i] = event_flow(st, ev[i]) % n;
+
+	for (idx = 0; idx < n; idx++) {
+		cnt = 0;
+		for (i = 0; i < num; i++) {
+			if (dst[i] == idx)
+				tmp[cnt++] = ev[i];
+		}
+
+		if (cnt == 0)
+			continue;
+
+		stage_input(st, pl, idx, &ring, &queue);
+		if (enq_wait(ctx, stage, ring, queue, tmp, cnt) != cnt)
+			break;
+		sent += cnt;
+	}
+
+	if (sent == num)
+		return num;
+
+	/* Stopped: leave the events not forwarded first in the table */
+	cnt = 0;
+	for (i = 0; i < num; i++) {
+		if (dst[i] >= idx)
+			tmp[cnt++] = ev[i];
+	}
+	memcpy(ev, tmp, cnt * sizeof(odp_event_t));
+
+	return num - cnt;
+}
+
+/* Spread bursts over the workers of a stage, skipping full rings */
+static int forward_parallel(odph_pipeline_ctx_t *ctx, int stage,
+			    odp_event_t ev[], int num)
+{
+	odph_pipeline_t *pl = ctx->pl;
+	const stage_t *st = &pl->stage[stage];
+	uint32_t n = st->param.num_workers;
+	uint32_t idx = ctx->next[stage];
+	uint32_t tried = 0;
+	uint32_t idle = 0;
+	odph_ring_t *ring;
+	int sent = 0;
+	int ret;
+
+	while (sent < num) {
+		ring = pl->ctx[st->first + idx].ring;
+		ret = odph_ring_enqueue_burst(ring, (void **)&ev[sent],
+					      num - sent) & ODPH_RING_SZ_MASK;
+		sent += ret;
+
+		if (++idx == n)
+			idx = 0;
+
+		if (ret > 0) {
+			tried = 0;
+			continue;
+		}
+
+		/* All rings full */
+		if (++tried < n)
+			continue;
+
+		tried = 0;
+		if (stage_stopped(pl, stage))
+			break;
+
+		ctx->stats.stalls++;
+		idle_wait(&idle);
+	}
+
+	ctx->next[stage] = idx;
+	return sent;
+}
+
+int odph_pipeline_forward(odph_pipeline_ctx_t *ctx, int stage,
+			  odp_event_t ev[], int num)
+{
+	odph_pipeline_t *pl = ctx->pl;
+	const stage_t *st;
+
+	if (odp_unlikely(stage <= ctx->stage || stage >= pl->num_stages)) {
+		ODPH_ERR("Bad forward from stage %i to %i\n", ctx->stage,
+			 stage);
+		return -1;
+	}
+
+	st = &pl->stage[stage];
+
+	if (st->param.sync == ODPH_PIPELINE_ATOMIC &&
+	    (st->queue_input ? st->num_queues : st->param.num_workers) > 1)
+		return forward_flow(ctx, stage, ev, num);
+
+	if (st->queue_input)
+		return enq_wait(ctx, stage, NULL, st->queue[0], ev, num);
+
+	return forward_parallel(ctx, stage, ev, num);
+}
+
+int odph_pipeline_stage(odph_pipeline_ctx_t *ctx)
+{
+	return ctx->stage;
+}
+
+int odph_pipeline_worker(odph_pipeline_ctx_t *ctx)
+{
+	return ctx->worker;
+}
+
+void *odph_pipeline_arg(odph_pipeline_ctx_t *ctx)
+{
+	return ctx->pl->stage[ctx->stage].param.arg;
+}
+
+static inline void run_fn(odph_pipeline_ctx_t *ctx, const stage_t *st,
+			  odp_event_t ev[], int num)
+{
+	uint64_t c1, c2;
+
+	c1 = odp_cpu_cycles();
+	st->param.fn(ctx, ev, num);
+	c2 = odp_cpu_cycles();
+
+	ctx->stats.events      += num;
+	ctx->stats.calls++;
+	ctx->stats.busy_cycles += odp_cpu_cycles_diff(c2, c1);
+}
+
+static void *worker_thread(void *arg)
+{
+	odph_pipeline_ctx_t *ctx = arg;
+	odph_pipeline_t *pl = ctx->pl;
+	stage_t *st = &pl->stage[ctx->stage];
+	odp_event_t ev[ODPH_PIPELINE_MAX_BURST];
+	int burst = st->param.burst;
+	odp_thrmask_t thrmask;
+	uint64_t start, c1, c2;
+	uint32_t idle = 0;
+	int stopped, num;
+
+	if (st->queue_input) {
+		odp_thrmask_zero(&thrmask);
+		odp_thrmask_set(&thrmask, odp_thread_id());
+		if (odp_schedule_group_join(st->group, &thrmask))
+			ODPH_ABORT("Join of %s failed\n", st->name);
+	}
+
+	start = odp_cpu_cycles();
+
+	while (1) {
+		stopped = stage_stopped(pl, ctx->stage);
+
+		if (ctx->stage == 0) {
+			if (stopped)
+				break;
+
+			c1 = odp_cpu_cycles();
+			num = st->param.fn(ctx, ev, 0);
+			if (num > 0) {
+				c2 = odp_cpu_cycles();
+				ctx->stats.events      += num;
+				ctx->stats.calls++;
+				ctx->stats.busy_cycles +=
+					odp_cpu_cycles_diff(c2, c1);
+				idle = 0;
+			} else {
+				idle_wait(&idle);
+			}
+			continue;
+		}
+
+		if (st->queue_input)
+			num = odp_schedule_multi(NULL, ODP_SCHED_NO_WAIT, ev,
+						 burst);
+		else
+			num = odph_ring_dequeue_burst(ctx->ring, (void **)ev,
+						      burst);
+
+		if (num > 0) {
+			run_fn(ctx, st, ev, num);
+			idle = 0;
+		} else if (stopped) {
+			break;
+		} else {
+			idle_wait(&idle);
+		}
+	}
+
+	/* Process events prefetched by the scheduler and release the
+	 * last context, which lets the reordered events go */
+	if (st->queue_input) {
+		odp_schedule_pause();
+		while ((num = odp_schedule_multi(NULL, ODP_SCHED_NO_WAIT, ev,
+						 burst)) > 0)
+			run_fn(ctx, st, ev, num);
+		odp_schedule_resume();
+
+		if (odp_schedule_group_leave(st->group, &thrmask))
+			ODPH_ERR("Leave of %s failed\n", st->name);
+	}
+
+	ctx->stats.cycles = odp_cpu_cycles_diff(odp_cpu_cycles(), start);
+	odp_atomic_dec_u32(&st->running);
+
+	return NULL;
+}
+
+int odph_pipeline_start(odph_pipeline_t *pl)
+{
+	odp_cpumask_t cpumask, mask;
+	int num_cpus, cpu;
+	int s, w;
+
+	if (pl->num_threads) {
+		ODPH_ERR("Pipeline %s already started\n", pl->name);
+		return -1;
+	}
+
+	if (pl->has_cpumask) {
+		odp_cpumask_copy(&cpumask, &pl->cpumask);
+		num_cpus = odp_cpumask_count(&cpumask);
+	} else {
+		num_cpus = odp_cpumask_default_worker(&cpumask,
+						      pl->num_workers);
+	}
+
+	if (num_cpus < 1) {
+		ODPH_ERR("No CPUs for pipeline %s\n", pl->name);
+		return -1;
+	}
+
+	if (num_cpus < pl->num_workers)
+		ODPH_DBG("Pipeline %s: %i workers share %i CPUs\n", pl->name,
+			 pl->num_workers, num_cpus);
+
+	odp_atomic_store_u32(&pl->stop_stage, 0);
+	for (s = 0; s < pl->num_stages; s++)
+		odp_atomic_store_u32(&pl->stage[s].running,
+				     pl->stage[s].param.num_workers);
+
+	cpu = odp_cpumask_first(&cpumask);
+	for (w = 0; w < pl->num_workers; w++) {
+		odp_cpumask_zero(&mask);
+		odp_cpumask_set(&mask, cpu);
+
+		if (odph_linux_pthread_create(&pl->thread_tbl[w], &mask,
+					      worker_thread, &pl->ctx[w],
+					      ODP_THREAD_WORKER) != 1) {
+			ODPH_ERR("Worker %i create failed\n", w);
+			break;
+		}
+		pl->num_threads++;
+
+		cpu = odp_cpumask_next(&cpumask, cpu);
+		if (cpu < 0)
+			cpu = odp_cpumask_first(&cpumask);
+	}
+
+	if (pl->num_threads == pl->num_workers)
+		return 0;
+
+	/* Workers not created are not running */
+	for (; w < pl->num_workers; w++)
+		odp_atomic_dec_u32(&pl->stage[pl->ctx[w].stage].running);
+
+	odph_pipeline_stop(pl);
+	return -1;
+}
+
+void odph_pipeline_stop(odph_pipeline_t *pl)
+{
+	int s;
+
+	if (pl->num_threads == 0)
+		return;
+
+	for (s = 0; s < pl->num_stages; s++) {
+		odp_atomic_store_u32(&pl->stop_stage, s + 1);
+
+		while (odp_atomic_load_u32(&pl->stage[s].running))
+			odp_time_wait_ns(ODP_TIME_MSEC_IN_NS);
+	}
+
+	odph_linux_pthread_join(pl->thread_tbl, pl->num_threads);
+	pl->num_threads = 0;
+}
+
+/* Free events left in the inputs of a stage */
+static void drain_stage(odph_pipeline_t *pl, stage_t *st)
+{
+	odp_event_t ev[ODPH_PIPELINE_MAX_BURST];
+	odp_thrmask_t thrmask;
+	int i, w, num;
+
+	for (w = st->first; w < st->first + st->param.num_workers; w++) {
+		if (pl->ctx[w].ring == NULL)
+			continue;
+
+		while ((num = odph_ring_dequeue_burst(pl->ctx[w].ring,
+						      (void **)ev,
+						      ODPH_PIPELINE_MAX_BURST))
+		       > 0) {
+			for (i = 0; i < num; i++)
+				odp_event_free(ev[i]);
+		}
+	}
+
+	if (st->group == ODP_SCHED_GROUP_INVALID)
+		return;
+
+	odp_thrmask_zero(&thrmask);
+	odp_thrmask_set(&thrmask, odp_thread_id());
+	if (odp_schedule_group_join(st->group, &thrmask))
+		return;
+
+	while ((num = odp_schedule_multi(NULL, ODP_SCHED_NO_WAIT, ev,
+					 ODPH_PIPELINE_MAX_BURST)) > 0) {
+		for (i = 0; i < num; i++)
+			odp_event_free(ev[i]);
+	}
+
+	odp_schedule_group_leave(st->group, &thrmask);
+}
+
+int odph_pipeline_destroy(odph_pipeline_t *pl)
+{
+	int ret = 0;
+	int s, w;
+
+	if (pl->num_threads) {
+		ODPH_ERR("Pipeline %s running\n", pl->name);
+		return -1;
+	}
+
+	for (s = 0; s < pl->num_stages; s++) {
+		stage_t *st = &pl->stage[s];
+
+		drain_stage(pl, st);
+
+		for (w = st->first;
+		     w < st->first + st->param.num_workers &&
+		     w < pl->num_workers; w++) {
+			if (pl->ctx[w].ring && odph_ring_free(pl->ctx[w].ring))
+				ret = -1;
+		}
+
+		for (w = 0; w < st->num_queues; w++) {
+			if (st->queue[w] != ODP_QUEUE_INVALID &&
+			    odp_queue_destroy(st->queue[w]))
+				ret = -1;
+		}
+
+		if (st->group != ODP_SCHED_GROUP_INVALID &&
+		    odp_schedule_group_destroy(st->group))
+			ret = -1;
+	}
+
+	if (odp_shm_free(pl->shm))
+		ret = -1;
+
+	return ret;
+}
+
+int odph_pipeline_stats(odph_pipeline_t *pl, int stage,
+			odph_pipeline_stats_t *stats)
+{
+	const stage_t *st;
+	int w;
+
+	if (stage < 0 || stage >= pl->num_stages)
+		return -1;
+
+	st = &pl->stage[stage];
+	memset(stats, 0, sizeof(*stats));
+
+	for (w = st->first; w < st->first + st->param.num_workers; w++) {
+		const odph_pipeline_stats_t *ws = &pl->ctx[w].stats;
+
+		stats->events      += ws->events;
+		stats->calls       += ws->calls;
+		stats->busy_cycles += ws->busy_cycles;
+		stats->cycles      += ws->cycles;
+		stats->stalls      += ws->stalls;
+	}
+
+	return 0;
+}
+
+void odph_pipeline_print(odph_pipeline_t *pl)
+{
+	odph_pipeline_stats_t stats;
+	int s;
+
+	printf("\nPipeline %s\n", pl->name);
+	printf("  %-12s %7s %-8s %-5s %12s %8s %10s %6s %10s\n", "stage",
+	       "workers", "sync", "input", "events", "burst",
+	       "cycles/ev", "busy%", "stalls");
+
+	for (s = 0; s < pl->num_stages; s++) {
+		const stage_t *st = &pl->stage[s];
+
+		odph_pipeline_stats(pl, s, &stats);
+		printf("  %-12s %7i %-8s %-5s %12" PRIu64 " %8.1f %10.1f "
+		       "%6.1f %10" PRIu64 "\n", st->name,
+		       st->param.num_workers, sync_str[st->param.sync],
+		       s == 0 ? "-" : st->queue_input ? "queue" : "ring",
+		       stats.events,
+		       stats.calls ? (double)stats.events / stats.calls : 0.0,
+		       stats.events ?
+		       (double)stats.busy_cycles / stats.events : 0.0,
+		       stats.cycles ?
+		       100.0 * stats.busy_cycles / stats.cycles : 0.0,
+		       stats.stalls);
+	}
+}
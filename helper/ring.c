@@ -171,6 +171,10 @@ odph_ring_create(const char *name, unsigned count, unsigned flags)
 	ring_size = count*sizeof(void *)+sizeof(odph_ring_t);
 
 	odp_rwlock_write_lock(&qlock);
+	/* rings created without odph_ring_tailq_init() */
+	if (odp_ring_list.tqh_last == NULL)
+		TAILQ_INIT(&odp_ring_list);
+
 	/* reserve a memory zone for this ring.*/
 	shm = odp_shm_reserve(ring_name, ring_size, ODP_CACHE_LINE_SIZE, 0);
 
@@ -201,6 +205,21 @@ odph_ring_create(const char *name, unsigned count, unsigned flags)
 	return r;
 }
 
+/* free the ring */
+int odph_ring_free(odph_ring_t *r)
+{
+	odp_shm_t shm;
+	int ret;
+
+	odp_rwlock_write_lock(&qlock);
+	shm = odp_shm_lookup(r->name);
+	TAILQ_REMOVE(&odp_ring_list, r, next);
+	ret = odp_shm_free(shm);
+	odp_rwlock_write_unlock(&qlock);
+
+	return ret;
+}
+
 /*
  * change the high water mark. If *count* is 0, water marking is
  * disabled
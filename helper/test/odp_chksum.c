@@ -196,7 +196,7 @@ int main(int argc TEST_UNUSED, char *argv[] TEST_UNUSED)
 
 	printf("chksum = 0x%x\n", udp->chksum);
 
-	if (udp->chksum != 0xab2d)
+	if (udp->chksum != 0x7e5a)
 		status = -1;
 
 	odp_packet_free(test_packet);
@@ -0,0 +1,377 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <test_debug.h>
+#include <odp.h>
+#include <odp/helper/linux.h>
+#include <odp/helper/flowtable.h>
+
+#include <string.h>
+
+#define MAX_WORKERS      4
+#define SMALL_FLOWS      256
+#define TIMEOUT_MS       50
+#define BENCH_FLOWS      (1 << 18)
+#define FLOWS_PER_WORKER 50000
+#define SHARED_FLOWS     1000
+#define BURST            32
+
+typedef struct {
+	odph_flow_table_t *tbl;
+	odp_atomic_u32_t shared_added;
+	odp_atomic_u32_t errors;
+	odp_atomic_u64_t add_ns;
+	odp_atomic_u64_t lookup_ns;
+	odp_atomic_u32_t expired_cb;
+} test_globals_t;
+
+static test_globals_t *gbl;
+
+static void make_key(odph_flow_key_t *key, uint32_t src, uint32_t id)
+{
+	memset(key, 0, sizeof(*key));
+	key->src_ip   = 0x0a000000 | src;
+	key->dst_ip   = 0xc0a80000 | (id >> 16);
+	key->src_port = 1024 + (id & 0xffff);
+	key->dst_port = 80;
+	key->proto    = 6;
+}
+
+static void expire_cb(odph_flow_table_t *tbl TEST_UNUSED,
+		      odph_flow_t *flow TEST_UNUSED, void *arg)
+{
+	odp_atomic_inc_u32(arg);
+}
+
+static int test_basic(void)
+{
+	odph_flow_param_t param;
+	odph_flow_table_stats_t stats;
+	odph_flow_table_t *tbl;
+	odph_flow_key_t key, rev, nat, keys[4];
+	odph_flow_t *flow, *flow2, *flows[4];
+	odph_flow_dir_t dir, dirs[4];
+	uint64_t packets, bytes;
+	int i, ret = 0;
+
+	odph_flow_param_init(&param);
+	param.max_flows   = SMALL_FLOWS;
+	param.data_size   = 16;
+	param.timeout_ns  = TIMEOUT_MS * ODP_TIME_MSEC_IN_NS;
+	param.tick_ns     = 5 * ODP_TIME_MSEC_IN_NS;
+	param.wheel_ticks = 4;
+	param.expire_fn   = expire_cb;
+	param.expire_arg  = &gbl->expired_cb;
+
+	param.wheel_ticks = 3;
+	if (odph_flow_table_create("bad", &param) != NULL) {
+		LOG_ERR("Error: created with bad parameters.\n");
+		return -1;
+	}
+	param.wheel_ticks = 4;
+
+	tbl = odph_flow_table_create("flow_basic", &param);
+	if (tbl == NULL) {
+		LOG_ERR("Error: table create failed.\n");
+		return -1;
+	}
+
+	/* Both directions, the reply key reversed */
+	make_key(&key, 1, 1);
+	memset(&rev, 0, sizeof(rev));
+	rev.src_ip   = key.dst_ip;
+	rev.dst_ip   = key.src_ip;
+	rev.src_port = key.dst_port;
+	rev.dst_port = key.src_port;
+	rev.proto    = key.proto;
+
+	if (odph_flow_add(tbl, &key, NULL, &flow, &dir) != 1 ||
+	    dir != ODPH_FLOW_DIR_ORIG ||
+	    odph_flow_add(tbl, &rev, NULL, &flow2, &dir) != 0 ||
+	    flow2 != flow || dir != ODPH_FLOW_DIR_REPLY ||
+	    odph_flow_lookup(tbl, &key, &dir) != flow ||
+	    dir != ODPH_FLOW_DIR_ORIG ||
+	    odph_flow_lookup(tbl, &rev, &dir) != flow ||
+	    dir != ODPH_FLOW_DIR_REPLY ||
+	    memcmp(odph_flow_key(flow, ODPH_FLOW_DIR_REPLY), &rev,
+		   sizeof(rev))) {
+		LOG_ERR("Error: bidirectional lookup.\n");
+		ret = -1;
+	}
+
+	/* State, data and counters */
+	odph_flow_state_set(flow, 3);
+	memset(odph_flow_data(flow), 0xaa, 16);
+	odph_flow_count(flow, ODPH_FLOW_DIR_REPLY, 100);
+	odph_flow_count(flow, ODPH_FLOW_DIR_REPLY, 60);
+	odph_flow_counters(flow, ODPH_FLOW_DIR_REPLY, &packets, &bytes);
+	if (odph_flow_state(flow) != 3 || packets != 2 || bytes != 160) {
+		LOG_ERR("Error: flow state or counters.\n");
+		ret = -1;
+	}
+
+	/* NAT: reply to the translated address, taken reply key fails */
+	make_key(&key, 2, 2);
+	make_key(&nat, 3, 3);
+	if (odph_flow_add(tbl, &key, &nat, &flow2, NULL) != 1 ||
+	    odph_flow_lookup(tbl, &nat, &dir) != flow2 ||
+	    dir != ODPH_FLOW_DIR_REPLY ||
+	    *(uint8_t *)odph_flow_data(flow2) != 0) {
+		LOG_ERR("Error: NAT flow.\n");
+		ret = -1;
+	}
+
+	make_key(&key, 4, 4);
+	if (odph_flow_add(tbl, &key, &nat, &flow2, NULL) >= 0 ||
+	    odph_flow_lookup(tbl, &key, NULL) != NULL) {
+		LOG_ERR("Error: reply key of another flow.\n");
+		ret = -1;
+	}
+
+	/* Batched lookup, the third key is the NAT reply */
+	for (i = 0; i < 4; i++)
+		make_key(&keys[i], i + 1, i + 1);
+
+	if (odph_flow_lookup_multi(tbl, keys, flows, dirs, 4) != 3 ||
+	    flows[0] != flow || dirs[0] != ODPH_FLOW_DIR_ORIG ||
+	    flows[1] == NULL || flows[2] != flows[1] ||
+	    dirs[2] != ODPH_FLOW_DIR_REPLY || flows[3] != NULL) {
+		LOG_ERR("Error: batched lookup.\n");
+		ret = -1;
+	}
+
+	/* Delete */
+	if (odph_flow_del(tbl, flows[1]) ||
+	    odph_flow_del(tbl, flows[1]) == 0 ||
+	    odph_flow_lookup(tbl, &nat, NULL) != NULL) {
+		LOG_ERR("Error: delete.\n");
+		ret = -1;
+	}
+
+	/* Fill the table */
+	for (i = 0; i < 2 * SMALL_FLOWS; i++) {
+		make_key(&key, 100, i);
+		odph_flow_add(tbl, &key, NULL, &flow2, NULL);
+	}
+
+	odph_flow_table_stats(tbl, &stats);
+	/* The deleted flow is recycled by aging */
+	if (stats.full == 0 || stats.flows != SMALL_FLOWS - 1) {
+		LOG_ERR("Error: full table, %" PRIu64 " flows.\n",
+			stats.flows);
+		ret = -1;
+	}
+
+	/* Looked up flows stay, others time out */
+	for (i = 0; i < 2 * TIMEOUT_MS; i++) {
+		odp_time_wait_ns(ODP_TIME_MSEC_IN_NS);
+		odph_flow_lookup(tbl, odph_flow_key(flow, ODPH_FLOW_DIR_ORIG),
+				 NULL);
+		odph_flow_age(tbl);
+		odp_rcu_quiescent();
+	}
+
+	odph_flow_table_stats(tbl, &stats);
+	printf("basic: flows %" PRIu64 ", added %" PRIu64 ", deleted %"
+	       PRIu64 ", expired %" PRIu64 ", full %" PRIu64 "\n",
+	       stats.flows, stats.added, stats.deleted, stats.expired,
+	       stats.full);
+
+	if (stats.flows != 1 || odph_flow_lookup(tbl, &rev, NULL) != flow ||
+	    stats.expired != odp_atomic_load_u32(&gbl->expired_cb)) {
+		LOG_ERR("Error: aging.\n");
+		ret = -1;
+	}
+
+	/* Timed out flows were recycled */
+	odp_rcu_barrier();
+	for (i = 0; i < SMALL_FLOWS / 2; i++) {
+		make_key(&key, 200, i);
+		if (odph_flow_add(tbl, &key, NULL, &flow2, NULL) != 1) {
+			LOG_ERR("Error: add after aging.\n");
+			ret = -1;
+			break;
+		}
+	}
+
+	if (odph_flow_table_destroy(tbl)) {
+		LOG_ERR("Error: table destroy failed.\n");
+		ret = -1;
+	}
+
+	return ret;
+}
+
+static void *worker_fn(void *arg TEST_UNUSED)
+{
+	odph_flow_table_t *tbl = gbl->tbl;
+	uint32_t thr = odp_thread_id();
+	odph_flow_key_t key[BURST];
+	odph_flow_t *flow[BURST];
+	odp_time_t t1, t2;
+	int i, j, ret;
+
+	/* Same flows from all workers, each added once */
+	for (i = 0; i < SHARED_FLOWS; i++) {
+		make_key(&key[0], 0, i);
+		ret = odph_flow_add(tbl, &key[0], NULL, &flow[0], NULL);
+		if (ret < 0)
+			odp_atomic_inc_u32(&gbl->errors);
+		else if (ret == 1)
+			odp_atomic_inc_u32(&gbl->shared_added);
+	}
+
+	t1 = odp_time_local();
+
+	for (i = 0; i < FLOWS_PER_WORKER; i++) {
+		make_key(&key[0], thr, i);
+		if (odph_flow_add(tbl, &key[0], NULL, &flow[0], NULL) != 1)
+			odp_atomic_inc_u32(&gbl->errors);
+
+		if ((i % BURST) == 0) {
+			odph_flow_age(tbl);
+			odp_rcu_quiescent();
+		}
+	}
+
+	t2 = odp_time_local();
+	odp_atomic_add_u64(&gbl->add_ns,
+			   odp_time_to_ns(odp_time_diff(t2, t1)));
+
+	t1 = odp_time_local();
+
+	for (i = 0; i + BURST <= FLOWS_PER_WORKER; i += BURST) {
+		for (j = 0; j < BURST; j++)
+			make_key(&key[j], thr, i + j);
+
+		if (odph_flow_lookup_multi(tbl, key, flow, NULL, BURST) !=
+		    BURST)
+			odp_atomic_inc_u32(&gbl->errors);
+
+		odp_rcu_quiescent();
+	}
+
+	t2 = odp_time_local();
+	odp_atomic_add_u64(&gbl->lookup_ns,
+			   odp_time_to_ns(odp_time_diff(t2, t1)));
+
+	return NULL;
+}
+
+static int test_workers(void)
+{
+	odph_linux_pthread_t thread_tbl[MAX_WORKERS];
+	odph_flow_param_t param;
+	odph_flow_table_stats_t stats;
+	odp_cpumask_t cpumask;
+	uint64_t flows, add_ns, lookup_ns;
+	int num, ret = 0;
+
+	odph_flow_param_init(&param);
+	param.max_flows = BENCH_FLOWS;
+
+	gbl->tbl = odph_flow_table_create("flow_bench", &param);
+	if (gbl->tbl == NULL) {
+		LOG_ERR("Error: table create failed.\n");
+		return -1;
+	}
+
+	/* Grace periods don't wait for this thread while it joins */
+	odp_rcu_thread_offline();
+
+	num = odp_cpumask_default_worker(&cpumask, MAX_WORKERS);
+	odph_linux_pthread_create(thread_tbl, &cpumask, worker_fn, NULL,
+				  ODP_THREAD_WORKER);
+	odph_linux_pthread_join(thread_tbl, num);
+
+	odph_flow_table_stats(gbl->tbl, &stats);
+	flows     = (uint64_t)num * FLOWS_PER_WORKER;
+	add_ns    = odp_atomic_load_u64(&gbl->add_ns) / num;
+	lookup_ns = odp_atomic_load_u64(&gbl->lookup_ns) / num;
+
+	printf("workers %i: %.0f new flows/s, %.0f lookups/s\n", num,
+	       add_ns ? flows * (double)ODP_TIME_SEC_IN_NS / add_ns : 0.0,
+	       lookup_ns ? flows * (double)ODP_TIME_SEC_IN_NS / lookup_ns :
+	       0.0);
+
+	if (odp_atomic_load_u32(&gbl->errors) ||
+	    odp_atomic_load_u32(&gbl->shared_added) != SHARED_FLOWS ||
+	    stats.flows != flows + SHARED_FLOWS) {
+		LOG_ERR("Error: %" PRIu32 " errors, %" PRIu32
+			" shared flows added, %" PRIu64 " flows.\n",
+			odp_atomic_load_u32(&gbl->errors),
+			odp_atomic_load_u32(&gbl->shared_added), stats.flows);
+		ret = -1;
+	}
+
+	if (odph_flow_table_destroy(gbl->tbl)) {
+		LOG_ERR("Error: table destroy failed.\n");
+		ret = -1;
+	}
+
+	return ret;
+}
+
+static int run_test(void)
+{
+	odp_shm_t shm;
+	int ret = 0;
+
+	shm = odp_shm_reserve("test_globals", sizeof(test_globals_t),
+			      ODP_CACHE_LINE_SIZE, 0);
+	gbl = odp_shm_addr(shm);
+	if (gbl == NULL) {
+		LOG_ERR("Error: shm reserve failed.\n");
+		return -1;
+	}
+	memset(gbl, 0, sizeof(*gbl));
+	odp_atomic_init_u32(&gbl->shared_added, 0);
+	odp_atomic_init_u32(&gbl->errors, 0);
+	odp_atomic_init_u64(&gbl->add_ns, 0);
+	odp_atomic_init_u64(&gbl->lookup_ns, 0);
+	odp_atomic_init_u32(&gbl->expired_cb, 0);
+
+	if (test_basic())
+		ret = -1;
+
+	if (ret == 0 && test_workers())
+		ret = -1;
+
+	odp_shm_free(shm);
+	return ret;
+}
+
+int main(int argc TEST_UNUSED, char *argv[] TEST_UNUSED)
+{
+	int ret;
+
+	if (odp_init_global(NULL, NULL)) {
+		LOG_ERR("Error: ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_init_local(ODP_THREAD_CONTROL)) {
+		LOG_ERR("Error: ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	ret = run_test();
+
+	if (odp_term_local()) {
+		LOG_ERR("Error: ODP local term failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global()) {
+		LOG_ERR("Error: ODP global term failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (ret)
+		exit(EXIT_FAILURE);
+
+	return 0;
+}
@@ -0,0 +1,521 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/*
+ * Fragments datagrams, reassembles them in shuffled order and compares the
+ * result to the original. Packets of an optional pcap file given as the
+ * first argument are run through the same check. Ends with a fragments per
+ * second benchmark.
+ */
+
+#include <test_debug.h>
+#include <odp.h>
+#include <odp/helper/eth.h>
+#include <odp/helper/ip.h>
+#include <odp/helper/chksum.h>
+#include <odp/helper/ipfrag.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define NUM_PKTS      2048
+#define PKT_LEN_MAX   9018
+#define MTU           576
+#define BENCH_ROUNDS  20000
+#define BENCH_LEN     1500
+#define BENCH_BURST   32
+#define L3_OFFSET     ODPH_ETHHDR_LEN
+
+#define PCAP_MAGIC    0xa1b2c3d4
+#define PCAP_LINKTYPE_ETHERNET 1
+
+typedef struct {
+	uint32_t magic;
+	uint16_t version_major;
+	uint16_t version_minor;
+	int32_t  thiszone;
+	uint32_t sigfigs;
+	uint32_t snaplen;
+	uint32_t linktype;
+} pcap_file_hdr_t;
+
+typedef struct {
+	uint32_t ts_sec;
+	uint32_t ts_usec;
+	uint32_t incl_len;
+	uint32_t orig_len;
+} pcap_rec_hdr_t;
+
+static odp_pool_t pool;
+static uint8_t ref[PKT_LEN_MAX];
+static uint8_t data[PKT_LEN_MAX];
+
+/* Router alert is copied to all fragments, record route is not */
+static const uint8_t options[] = {0x94, 0x04, 0x00, 0x00,
+				  0x07, 0x07, 0x04, 0x00,
+				  0x00, 0x00, 0x00, 0x00};
+
+static odp_packet_t make_pkt(const uint8_t *buf, uint32_t len)
+{
+	odp_packet_t pkt = odp_packet_alloc(pool, len);
+
+	if (pkt == ODP_PACKET_INVALID)
+		return pkt;
+
+	odp_packet_copydata_in(pkt, 0, len, buf);
+	odp_packet_l2_offset_set(pkt, 0);
+	odp_packet_l3_offset_set(pkt, L3_OFFSET);
+	return pkt;
+}
+
+/* Ethernet frame with an IPv4/UDP datagram of 'len' bytes in 'ref' */
+static uint32_t make_datagram(uint32_t len, uint16_t id, int opts)
+{
+	odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)&ref[L3_OFFSET];
+	uint32_t ihl = ODPH_IPV4HDR_LEN + (opts ? sizeof(options) : 0);
+	uint32_t i;
+
+	for (i = 0; i < L3_OFFSET + len; i++)
+		ref[i] = i * 7 + id;
+
+	ref[12] = 0x08;
+	ref[13] = 0x00;
+
+	ip->ver_ihl     = ODPH_IPV4 << 4 | ihl / 4;
+	ip->tos         = 0;
+	ip->tot_len     = odp_cpu_to_be_16(len);
+	ip->id          = odp_cpu_to_be_16(id);
+	ip->frag_offset = 0;
+	ip->ttl         = 64;
+	ip->proto       = ODPH_IPPROTO_UDP;
+	ip->src_addr    = odp_cpu_to_be_32(0x0a000001);
+	ip->dst_addr    = odp_cpu_to_be_32(0x0a000002 + (id & 0xff));
+
+	if (opts)
+		memcpy(&ref[L3_OFFSET + ODPH_IPV4HDR_LEN], options,
+		       sizeof(options));
+
+	ip->chksum = 0;
+	ip->chksum = odp_chksum(ip, ihl);
+
+	return L3_OFFSET + len;
+}
+
+static int check_frag(odp_packet_t pkt, uint32_t mtu)
+{
+	uint32_t len = odp_packet_len(pkt);
+	odph_ipv4hdr_t *ip;
+	uint32_t ihl;
+
+	if (len > L3_OFFSET + mtu || len > sizeof(data) ||
+	    odp_packet_l3_offset(pkt) != L3_OFFSET)
+		return -1;
+
+	odp_packet_copydata_out(pkt, 0, len, data);
+	ip  = (odph_ipv4hdr_t *)&data[L3_OFFSET];
+	ihl = ODPH_IPV4HDR_IHL(ip->ver_ihl) * 4;
+
+	if (memcmp(data, ref, L3_OFFSET) ||
+	    odp_be_to_cpu_16(ip->tot_len) != len - L3_OFFSET ||
+	    odp_chksum(ip, ihl) != 0)
+		return -1;
+
+	return 0;
+}
+
+static int check_datagram(odp_packet_t pkt, uint32_t len)
+{
+	if (odp_packet_len(pkt) != len)
+		return -1;
+
+	odp_packet_copydata_out(pkt, 0, len, data);
+	return memcmp(data, ref, len) ? -1 : 0;
+}
+
+/* Fragment the datagram in 'ref', reassemble in reverse order */
+static int frag_reass(odph_ipfrag_table_t *tbl, uint32_t len, uint32_t mtu)
+{
+	odp_packet_t frags[ODPH_IPFRAG_MAX_FRAGS];
+	odp_packet_t pkt, out;
+	int num, i, ret;
+
+	pkt = make_pkt(ref, len);
+	if (pkt == ODP_PACKET_INVALID)
+		return -1;
+
+	num = odph_ipv4_fragment(pkt, mtu, ODP_POOL_INVALID, frags,
+				 ODPH_IPFRAG_MAX_FRAGS);
+	if (num < 1) {
+		odp_packet_free(pkt);
+		return -1;
+	}
+
+	for (i = 0; i < num; i++) {
+		if (check_frag(frags[i], mtu)) {
+			LOG_ERR("Error: bad fragment %i.\n", i);
+			for (i = 0; i < num; i++)
+				odp_packet_free(frags[i]);
+			return -1;
+		}
+	}
+
+	for (i = num - 1; i >= 0; i--) {
+		ret = odph_ipv4_reassemble(tbl, frags[i], &out);
+		if (ret != (i == 0 ? 1 : 0)) {
+			LOG_ERR("Error: reassemble returned %i.\n", ret);
+			return -1;
+		}
+	}
+
+	ret = check_datagram(out, len);
+	odp_packet_free(out);
+	return ret;
+}
+
+static int test_basic(odph_ipfrag_table_t *tbl)
+{
+	static const uint32_t sizes[] = {100, 576, 577, 1500, 4000, 8000};
+	odp_packet_t frags[2];
+	odp_packet_t pkt;
+	uint32_t i, len;
+	int opts;
+
+	for (opts = 0; opts < 2; opts++) {
+		for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+			len = make_datagram(sizes[i], i, opts);
+			if (frag_reass(tbl, len, MTU)) {
+				LOG_ERR("Error: datagram of %" PRIu32
+					" bytes, options %i.\n",
+					sizes[i], opts);
+				return -1;
+			}
+		}
+	}
+
+	/* Don't fragment */
+	len = make_datagram(1500, 100, 0);
+	ref[L3_OFFSET + 6] |= 0x40;
+	pkt = make_pkt(ref, len);
+	if (pkt == ODP_PACKET_INVALID)
+		return -1;
+
+	if (odph_ipv4_fragment(pkt, MTU, ODP_POOL_INVALID, frags, 2) >= 0 ||
+	    odp_packet_len(pkt) != len) {
+		LOG_ERR("Error: fragmented with don't fragment set.\n");
+		odp_packet_free(pkt);
+		return -1;
+	}
+
+	odp_packet_free(pkt);
+
+	/* Too many fragments */
+	len = make_datagram(1500, 101, 0);
+	pkt = make_pkt(ref, len);
+	if (pkt == ODP_PACKET_INVALID)
+		return -1;
+
+	if (odph_ipv4_fragment(pkt, MTU, ODP_POOL_INVALID, frags, 2) >= 0 ||
+	    check_datagram(pkt, len)) {
+		LOG_ERR("Error: fragmented into too many fragments.\n");
+		odp_packet_free(pkt);
+		return -1;
+	}
+
+	odp_packet_free(pkt);
+	return 0;
+}
+
+static int test_drops(void)
+{
+	odph_ipfrag_param_t param;
+	odph_ipfrag_stats_t stats;
+	odph_ipfrag_table_t *tbl;
+	odp_packet_t frags[ODPH_IPFRAG_MAX_FRAGS];
+	odp_packet_t out, dup;
+	uint32_t len;
+	int num, ret = 0;
+
+	odph_ipfrag_param_init(&param);
+	param.max_flows  = 2;
+	param.timeout_ns = 10 * ODP_TIME_MSEC_IN_NS;
+
+	tbl = odph_ipfrag_table_create("ipfrag_drops", &param);
+	if (tbl == NULL)
+		return -1;
+
+	/* Duplicate fragment is dropped, the datagram completes */
+	len = make_datagram(1500, 1, 0);
+	num = odph_ipv4_fragment(make_pkt(ref, len), MTU, ODP_POOL_INVALID,
+				 frags, ODPH_IPFRAG_MAX_FRAGS);
+	dup = odp_packet_copy(frags[1], pool);
+
+	if (num != 3 || dup == ODP_PACKET_INVALID ||
+	    odph_ipv4_reassemble(tbl, frags[1], &out) != 0 ||
+	    odph_ipv4_reassemble(tbl, dup, &out) >= 0 ||
+	    odph_ipv4_reassemble(tbl, frags[0], &out) != 0 ||
+	    odph_ipv4_reassemble(tbl, frags[2], &out) != 1 ||
+	    check_datagram(out, len)) {
+		LOG_ERR("Error: duplicate fragment.\n");
+		return -1;
+	}
+	odp_packet_free(out);
+
+	/* Three datagrams in two entries, the oldest is evicted */
+	for (num = 0; num < 3; num++) {
+		len = make_datagram(1500, 10 + num, 0);
+		odph_ipv4_fragment(make_pkt(ref, len), MTU, ODP_POOL_INVALID,
+				   frags, ODPH_IPFRAG_MAX_FRAGS);
+		odp_packet_free(frags[1]);
+		odp_packet_free(frags[2]);
+		if (odph_ipv4_reassemble(tbl, frags[0], &out) != 0)
+			ret = -1;
+	}
+
+	/* The other two time out */
+	odp_time_wait_ns(20 * ODP_TIME_MSEC_IN_NS);
+	if (odph_ipfrag_expire(tbl) != 2)
+		ret = -1;
+
+	odph_ipfrag_stats(tbl, &stats);
+	printf("drops: frags %" PRIu64 ", reassembled %" PRIu64
+	       ", expired %" PRIu64 ", evicted %" PRIu64 ", dropped %"
+	       PRIu64 "\n", stats.frags, stats.reassembled, stats.expired,
+	       stats.evicted, stats.dropped);
+
+	if (stats.frags != 7 || stats.reassembled != 1 ||
+	    stats.expired != 2 || stats.evicted != 1 || stats.dropped != 1)
+		ret = -1;
+
+	if (ret)
+		LOG_ERR("Error: eviction or expiry.\n");
+
+	if (odph_ipfrag_table_destroy(tbl))
+		ret = -1;
+
+	return ret;
+}
+
+static int test_pcap(odph_ipfrag_table_t *tbl, const char *file)
+{
+	pcap_file_hdr_t fhdr;
+	pcap_rec_hdr_t rhdr;
+	odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)&ref[L3_OFFSET];
+	FILE *fp;
+	int num = 0, ret = 0;
+
+	fp = fopen(file, "rb");
+	if (fp == NULL) {
+		LOG_ERR("Error: cannot open %s.\n", file);
+		return -1;
+	}
+
+	if (fread(&fhdr, sizeof(fhdr), 1, fp) != 1 ||
+	    fhdr.magic != PCAP_MAGIC ||
+	    fhdr.linktype != PCAP_LINKTYPE_ETHERNET) {
+		LOG_ERR("Error: %s is not an Ethernet pcap file.\n", file);
+		fclose(fp);
+		return -1;
+	}
+
+	while (ret == 0 && fread(&rhdr, sizeof(rhdr), 1, fp) == 1) {
+		uint32_t len;
+
+		if (rhdr.incl_len > sizeof(ref) ||
+		    fread(ref, rhdr.incl_len, 1, fp) != 1)
+			break;
+
+		/* Unfragmented IPv4 only, without L2 padding */
+		if (rhdr.incl_len < L3_OFFSET + ODPH_IPV4HDR_LEN ||
+		    ref[12] != 0x08 || ref[13] != 0x00 ||
+		    ODPH_IPV4HDR_VER(ip->ver_ihl) != ODPH_IPV4 ||
+		    ODPH_IPV4HDR_IS_FRAGMENT(odp_be_to_cpu_16(ip->frag_offset)))
+			continue;
+
+		len = L3_OFFSET + odp_be_to_cpu_16(ip->tot_len);
+		if (len > rhdr.incl_len)
+			continue;
+
+		if (ODPH_IPV4HDR_FLAGS_DONT_FRAG(odp_be_to_cpu_16(
+						 ip->frag_offset)))
+			ip->frag_offset = 0;
+
+		ip->chksum = 0;
+		ip->chksum = odp_chksum(ip, ODPH_IPV4HDR_IHL(ip->ver_ihl) * 4);
+
+		ret = frag_reass(tbl, len, MTU);
+		num++;
+	}
+
+	fclose(fp);
+	printf("pcap: %i packets from %s\n", num, file);
+
+	if (ret)
+		LOG_ERR("Error: pcap packet %i.\n", num);
+
+	return ret;
+}
+
+static int bench(void)
+{
+	odph_ipfrag_param_t param;
+	odph_ipfrag_table_t *tbl;
+	odp_packet_t frags[BENCH_BURST][ODPH_IPFRAG_MAX_FRAGS];
+	int num[BENCH_BURST];
+	odp_packet_t out;
+	odp_time_t t1, t2;
+	uint64_t nsec, count = 0;
+	uint32_t len;
+	int r, b, i, ret = 0;
+
+	odph_ipfrag_param_init(&param);
+	param.num_shards = 4;
+
+	tbl = odph_ipfrag_table_create("ipfrag_bench", &param);
+	if (tbl == NULL)
+		return -1;
+
+	t1 = odp_time_local();
+
+	for (r = 0; r < BENCH_ROUNDS / BENCH_BURST && ret == 0; r++) {
+		/* A burst of datagrams with interleaved fragments */
+		for (b = 0; b < BENCH_BURST; b++) {
+			len = make_datagram(BENCH_LEN, r * BENCH_BURST + b, 0);
+			num[b] = odph_ipv4_fragment(make_pkt(ref, len), MTU,
+						    ODP_POOL_INVALID, frags[b],
+						    ODPH_IPFRAG_MAX_FRAGS);
+			if (num[b] < 1)
+				return -1;
+			count += num[b];
+		}
+
+		for (i = 0; i < num[0]; i++) {
+			for (b = 0; b < BENCH_BURST; b++) {
+				if (odph_ipv4_reassemble(tbl, frags[b][i],
+							 &out) < 0) {
+					ret = -1;
+					continue;
+				}
+
+				if (i == num[b] - 1)
+					odp_packet_free(out);
+			}
+		}
+	}
+
+	t2 = odp_time_local();
+	nsec = odp_time_to_ns(odp_time_diff(t2, t1));
+
+	printf("bench: %" PRIu64 " fragments in %" PRIu64 " us, %.0f "
+	       "fragments/s (fragment and reassemble)\n", count, nsec / 1000,
+	       nsec ? count * (double)ODP_TIME_SEC_IN_NS / nsec : 0.0);
+
+	if (ret)
+		LOG_ERR("Error: benchmark reassembly failed.\n");
+
+	if (odph_ipfrag_table_destroy(tbl))
+		ret = -1;
+
+	return ret;
+}
+
+static int run_test(const char *pcap)
+{
+	odph_ipfrag_param_t param;
+	odph_ipfrag_stats_t stats;
+	odph_ipfrag_table_t *tbl;
+	odp_pool_param_t params;
+	int ret = 0;
+
+	odp_pool_param_init(&params);
+	params.pkt.seg_len = 0;
+	params.pkt.len     = PKT_LEN_MAX;
+	params.pkt.num     = NUM_PKTS;
+	params.type        = ODP_POOL_PACKET;
+
+	pool = odp_pool_create("ipfrag_pool", &params);
+	if (pool == ODP_POOL_INVALID) {
+		LOG_ERR("Error: pool create failed.\n");
+		return -1;
+	}
+
+	odph_ipfrag_param_init(&param);
+
+	/* Bad parameters */
+	param.num_shards = 3;
+	if (odph_ipfrag_table_create("bad", &param) != NULL) {
+		LOG_ERR("Error: created with bad parameters.\n");
+		return -1;
+	}
+	param.num_shards = 2;
+
+	tbl = odph_ipfrag_table_create("ipfrag_table", &param);
+	if (tbl == NULL) {
+		LOG_ERR("Error: table create failed.\n");
+		return -1;
+	}
+
+	if (test_basic(tbl))
+		ret = -1;
+
+	if (ret == 0 && pcap && test_pcap(tbl, pcap))
+		ret = -1;
+
+	odph_ipfrag_stats(tbl, &stats);
+	if (stats.dropped || stats.expired || stats.evicted) {
+		LOG_ERR("Error: unexpected drops.\n");
+		ret = -1;
+	}
+
+	if (odph_ipfrag_table_destroy(tbl)) {
+		LOG_ERR("Error: table destroy failed.\n");
+		ret = -1;
+	}
+
+	if (ret == 0 && test_drops())
+		ret = -1;
+
+	if (ret == 0 && bench())
+		ret = -1;
+
+	if (odp_pool_destroy(pool)) {
+		LOG_ERR("Error: pool destroy failed.\n");
+		ret = -1;
+	}
+
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	int ret;
+
+	if (odp_init_global(NULL, NULL)) {
+		LOG_ERR("Error: ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_init_local(ODP_THREAD_CONTROL)) {
+		LOG_ERR("Error: ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	ret = run_test(argc > 1 ? argv[1] : NULL);
+
+	if (odp_term_local()) {
+		LOG_ERR("Error: ODP local term failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global()) {
+		LOG_ERR("Error: ODP global term failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (ret)
+		exit(EXIT_FAILURE);
+
+	return 0;
+}
@@ -0,0 +1,311 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <test_debug.h>
+#include <odp.h>
+#include <odp/helper/linux.h>
+#include <odp/helper/pipeline.h>
+
+#include <string.h>
+
+#define NUM_EVENTS  4096
+#define NUM_FLOWS   4
+#define NUM_BUFS    1024
+#define WAIT_SEC    30
+
+enum {
+	STAGE_SRC = 0,
+	STAGE_ATOMIC,
+	STAGE_ORDERED,
+	STAGE_SINK,
+	NUM_STAGES
+};
+
+typedef struct {
+	uint32_t seq;
+	uint32_t flow;
+} test_hdr_t;
+
+typedef struct {
+	odp_pool_t pool;
+	uint32_t seq;
+	/* Last sequence number per flow seen by the atomic stage, + 1 */
+	uint32_t atomic_last[NUM_FLOWS];
+	/* Atomic stage worker of each flow, + 1 */
+	uint32_t atomic_worker[NUM_FLOWS];
+	uint32_t sink_last[NUM_FLOWS];
+	int backward_checked;
+	odp_atomic_u32_t received;
+	odp_atomic_u32_t errors;
+} test_globals_t;
+
+static test_globals_t *gbl;
+
+static inline test_hdr_t *ev_hdr(odp_event_t ev)
+{
+	return odp_buffer_addr(odp_buffer_from_event(ev));
+}
+
+static uint32_t flow_fn(odp_event_t ev)
+{
+	return ev_hdr(ev)->flow;
+}
+
+static void free_events(odp_event_t ev[], int num)
+{
+	int i;
+
+	for (i = 0; i < num; i++)
+		odp_event_free(ev[i]);
+}
+
+static void forward(odph_pipeline_ctx_t *ctx, int stage, odp_event_t ev[],
+		    int num)
+{
+	int sent = odph_pipeline_forward(ctx, stage, ev, num);
+
+	if (sent < 0)
+		sent = 0;
+
+	if (sent < num)
+		free_events(&ev[sent], num - sent);
+}
+
+static int src_fn(odph_pipeline_ctx_t *ctx, odp_event_t ev[],
+		  int num TEST_UNUSED)
+{
+	odp_buffer_t buf;
+	test_hdr_t *hdr;
+	int i;
+
+	for (i = 0; i < 16 && gbl->seq < NUM_EVENTS; i++) {
+		buf = odp_buffer_alloc(gbl->pool);
+		if (buf == ODP_BUFFER_INVALID)
+			break;
+
+		hdr = odp_buffer_addr(buf);
+		hdr->seq  = gbl->seq++;
+		hdr->flow = hdr->seq % NUM_FLOWS;
+		ev[i] = odp_buffer_to_event(buf);
+	}
+
+	if (i)
+		forward(ctx, STAGE_ATOMIC, ev, i);
+
+	return i;
+}
+
+static int atomic_fn(odph_pipeline_ctx_t *ctx, odp_event_t ev[], int num)
+{
+	uint32_t worker = odph_pipeline_worker(ctx) + 1;
+	test_hdr_t *hdr;
+	int i;
+
+	for (i = 0; i < num; i++) {
+		hdr = ev_hdr(ev[i]);
+
+		/* A flow stays on one worker */
+		if (gbl->atomic_worker[hdr->flow] == 0)
+			gbl->atomic_worker[hdr->flow] = worker;
+		else if (gbl->atomic_worker[hdr->flow] != worker)
+			odp_atomic_inc_u32(&gbl->errors);
+
+		if (hdr->seq + 1 <= gbl->atomic_last[hdr->flow])
+			odp_atomic_inc_u32(&gbl->errors);
+		gbl->atomic_last[hdr->flow] = hdr->seq + 1;
+	}
+
+	forward(ctx, STAGE_ORDERED, ev, num);
+	return 0;
+}
+
+static int ordered_fn(odph_pipeline_ctx_t *ctx, odp_event_t ev[], int num)
+{
+	forward(ctx, STAGE_SINK, ev, num);
+	return 0;
+}
+
+static int sink_fn(odph_pipeline_ctx_t *ctx, odp_event_t ev[], int num)
+{
+	test_hdr_t *hdr;
+	int i;
+
+	/* Forwards go to later stages only */
+	if (!gbl->backward_checked) {
+		if (odph_pipeline_forward(ctx, STAGE_ATOMIC, ev, num) >= 0)
+			odp_atomic_inc_u32(&gbl->errors);
+		gbl->backward_checked = 1;
+	}
+
+	for (i = 0; i < num; i++) {
+		hdr = ev_hdr(ev[i]);
+
+		if (hdr->seq + 1 <= gbl->sink_last[hdr->flow])
+			odp_atomic_inc_u32(&gbl->errors);
+		gbl->sink_last[hdr->flow] = hdr->seq + 1;
+	}
+
+	free_events(ev, num);
+	odp_atomic_add_u32(&gbl->received, num);
+	return 0;
+}
+
+static int run_test(void)
+{
+	odph_pipeline_param_t param;
+	odph_pipeline_stats_t stats;
+	odph_pipeline_t *pl;
+	odp_pool_param_t params;
+	odp_shm_t shm;
+	int ret = 0;
+	int s, i;
+
+	shm = odp_shm_reserve("test_globals", sizeof(test_globals_t),
+			      ODP_CACHE_LINE_SIZE, 0);
+	gbl = odp_shm_addr(shm);
+	if (gbl == NULL) {
+		LOG_ERR("Error: shm reserve failed.\n");
+		return -1;
+	}
+	memset(gbl, 0, sizeof(*gbl));
+	odp_atomic_init_u32(&gbl->received, 0);
+	odp_atomic_init_u32(&gbl->errors, 0);
+
+	odp_pool_param_init(&params);
+	params.buf.size  = sizeof(test_hdr_t);
+	params.buf.align = 0;
+	params.buf.num   = NUM_BUFS;
+	params.type      = ODP_POOL_BUFFER;
+
+	gbl->pool = odp_pool_create("pipeline_pool", &params);
+	if (gbl->pool == ODP_POOL_INVALID) {
+		LOG_ERR("Error: pool create failed.\n");
+		return -1;
+	}
+
+	odph_pipeline_param_init(&param);
+	param.num_stages = NUM_STAGES;
+
+	param.stage[STAGE_SRC].name = "src";
+	param.stage[STAGE_SRC].fn   = src_fn;
+
+	param.stage[STAGE_ATOMIC].name        = "atomic";
+	param.stage[STAGE_ATOMIC].fn          = atomic_fn;
+	param.stage[STAGE_ATOMIC].num_workers = 2;
+	param.stage[STAGE_ATOMIC].sync        = ODPH_PIPELINE_ATOMIC;
+	param.stage[STAGE_ATOMIC].flow        = flow_fn;
+	param.stage[STAGE_ATOMIC].ring_size   = 256;
+
+	param.stage[STAGE_ORDERED].name        = "ordered";
+	param.stage[STAGE_ORDERED].fn          = ordered_fn;
+	param.stage[STAGE_ORDERED].num_workers = 2;
+	param.stage[STAGE_ORDERED].sync        = ODPH_PIPELINE_ORDERED;
+
+	param.stage[STAGE_SINK].name = "sink";
+	param.stage[STAGE_SINK].fn   = sink_fn;
+
+	/* Bad parameters */
+	param.stage[STAGE_SINK].fn = NULL;
+	if (odph_pipeline_create("bad", &param) != NULL) {
+		LOG_ERR("Error: created with bad parameters.\n");
+		return -1;
+	}
+	param.stage[STAGE_SINK].fn = sink_fn;
+
+	pl = odph_pipeline_create("test_pipeline", &param);
+	if (pl == NULL) {
+		LOG_ERR("Error: pipeline create failed.\n");
+		return -1;
+	}
+
+	if (odph_pipeline_start(pl)) {
+		LOG_ERR("Error: pipeline start failed.\n");
+		odph_pipeline_destroy(pl);
+		return -1;
+	}
+
+	for (i = 0; i < WAIT_SEC * 100 &&
+	     odp_atomic_load_u32(&gbl->received) < NUM_EVENTS; i++)
+		odp_time_wait_ns(10 * ODP_TIME_MSEC_IN_NS);
+
+	odph_pipeline_stop(pl);
+	odph_pipeline_print(pl);
+
+	if (odp_atomic_load_u32(&gbl->received) != NUM_EVENTS) {
+		LOG_ERR("Error: received %" PRIu32 " of %i events.\n",
+			odp_atomic_load_u32(&gbl->received), NUM_EVENTS);
+		ret = -1;
+	}
+
+	if (odp_atomic_load_u32(&gbl->errors)) {
+		LOG_ERR("Error: %" PRIu32 " order errors.\n",
+			odp_atomic_load_u32(&gbl->errors));
+		ret = -1;
+	}
+
+	for (s = 0; s < NUM_STAGES; s++) {
+		if (odph_pipeline_stats(pl, s, &stats) ||
+		    stats.events != NUM_EVENTS) {
+			LOG_ERR("Error: stage %i stats.\n", s);
+			ret = -1;
+		}
+	}
+
+	if (odph_pipeline_stats(pl, NUM_STAGES, &stats) == 0) {
+		LOG_ERR("Error: stats of a bad stage.\n");
+		ret = -1;
+	}
+
+	if (!gbl->backward_checked) {
+		LOG_ERR("Error: forward to an earlier stage not checked.\n");
+		ret = -1;
+	}
+
+	if (odph_pipeline_destroy(pl)) {
+		LOG_ERR("Error: pipeline destroy failed.\n");
+		ret = -1;
+	}
+
+	if (odp_pool_destroy(gbl->pool)) {
+		LOG_ERR("Error: pool destroy failed.\n");
+		ret = -1;
+	}
+
+	odp_shm_free(shm);
+	return ret;
+}
+
+int main(int argc TEST_UNUSED, char *argv[] TEST_UNUSED)
+{
+	int ret;
+
+	if (odp_init_global(NULL, NULL)) {
+		LOG_ERR("Error: ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_init_local(ODP_THREAD_CONTROL)) {
+		LOG_ERR("Error: ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	ret = run_test();
+
+	if (odp_term_local()) {
+		LOG_ERR("Error: ODP local term failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global()) {
+		LOG_ERR("Error: ODP global term failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (ret)
+		exit(EXIT_FAILURE);
+
+	return 0;
+}
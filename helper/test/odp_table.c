@@ -25,12 +25,11 @@
  * value (data): MAC address of the next hop station (6 bytes).
  */
 
-int main(int argc TEST_UNUSED, char *argv[] TEST_UNUSED)
+static int test_hash_table(struct odp_table_ops *test_ops)
 {
 	int ret = 0;
 	odph_table_t table;
 	odph_table_t tmp_tbl;
-	struct odp_table_ops *test_ops;
 	char tmp[32];
 	char ip_addr1[] = "12345678";
 	char ip_addr2[] = "11223344";
@@ -40,21 +39,7 @@ int main(int argc TEST_UNUSED, char *argv[] TEST_UNUSED)
 	char mac_addr3[] = "0B4433221101";
 	char mac_addr4[] = "0B4433221102";
 
-	ret = odp_init_global(NULL, NULL);
-	if (ret != 0) {
-		LOG_ERR("odp_shm_init_global fail\n");
-		exit(EXIT_FAILURE);
-	}
-	ret = odp_init_local(ODP_THREAD_WORKER);
-	if (ret != 0) {
-		LOG_ERR("odp_shm_init_local fail\n");
-		exit(EXIT_FAILURE);
-	}
-
-	printf("test hash table:\n");
-	test_ops = &odph_hash_table_ops;
-
-	table = test_ops->f_create("test", 1, 4, 16);
+	table = test_ops->f_create("test", 2, 4, 16);
 	if (table == NULL) {
 		printf("table create fail\n");
 		return -1;
@@ -113,10 +98,89 @@ int main(int argc TEST_UNUSED, char *argv[] TEST_UNUSED)
 	ret = test_ops->f_des(table);
 	if (ret != 0) {
 		printf("destroy table fail!!!\n");
-		exit(EXIT_FAILURE);
+		return -1;
 	}
 	printf("\t5  destroy table success!\n");
 
+	return 0;
+}
+
+/* Values read without locks while the writer switches between copies */
+static int test_linear_table_rcu(void)
+{
+	struct odp_table_ops *test_ops = &odph_linear_table_rcu_ops;
+	odph_table_t table;
+	uint32_t key = 3;
+	uint32_t bad_key = 1 << 30;
+	char tmp[16];
+	char mac_addr1[] = "0A1122334401";
+	char mac_addr2[] = "0A1122334402";
+	int i;
+
+	table = test_ops->f_create("test_linear", 1, 0, sizeof(mac_addr1));
+	if (table == NULL) {
+		printf("table create fail\n");
+		return -1;
+	}
+
+	for (i = 0; i < 3; i++) {
+		char *mac = i % 2 ? mac_addr2 : mac_addr1;
+
+		if (test_ops->f_put(table, &key, mac) != 0) {
+			printf("put value fail\n");
+			return -1;
+		}
+
+		if (test_ops->f_get(table, &key, tmp, sizeof(tmp)) != 0 ||
+		    strcmp(tmp, mac) != 0) {
+			printf("get value fail\n");
+			return -1;
+		}
+	}
+	printf("\t1  get after %d puts value = %s\n", i, tmp);
+
+	if (test_ops->f_put(table, &bad_key, mac_addr1) == 0) {
+		printf("put out of range key fail\n");
+		return -1;
+	}
+	printf("\t2  out of range key rejected\n");
+
+	if (test_ops->f_des(table) != 0) {
+		printf("destroy table fail!!!\n");
+		return -1;
+	}
+	printf("\t3  destroy table success!\n");
+
+	return 0;
+}
+
+int main(int argc TEST_UNUSED, char *argv[] TEST_UNUSED)
+{
+	int ret = 0;
+
+	ret = odp_init_global(NULL, NULL);
+	if (ret != 0) {
+		LOG_ERR("odp_shm_init_global fail\n");
+		exit(EXIT_FAILURE);
+	}
+	ret = odp_init_local(ODP_THREAD_WORKER);
+	if (ret != 0) {
+		LOG_ERR("odp_shm_init_local fail\n");
+		exit(EXIT_FAILURE);
+	}
+
+	printf("test hash table:\n");
+	if (test_hash_table(&odph_hash_table_ops))
+		exit(EXIT_FAILURE);
+
+	printf("test hash table, rcu:\n");
+	if (test_hash_table(&odph_hash_table_rcu_ops))
+		exit(EXIT_FAILURE);
+
+	printf("test linear table, rcu:\n");
+	if (test_linear_table_rcu())
+		exit(EXIT_FAILURE);
+
 	printf("all test finished success!!\n");
 
 	if (odp_term_local()) {
@@ -0,0 +1,403 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <test_debug.h>
+#include <odp.h>
+#include <odp/helper/tm.h>
+
+#include <string.h>
+
+#define NUM_PKTS     1024
+#define PKT_LEN      1000
+#define MAX_RX       512
+#define SHAPE_BPS    (8 * 1000 * 1000)
+#define SHAPE_BURST  40000
+#define SHAPE_MS     100
+
+typedef struct {
+	odp_pool_t pool;
+	odp_pktio_t pktio;
+	uint8_t tag[MAX_RX];
+	int num_rx;
+} test_globals_t;
+
+static test_globals_t *gbl;
+
+/* Enqueue packets tagged in the first payload byte */
+static int enq(odph_tm_t *tm, int queue, int num, uint8_t tag)
+{
+	odp_packet_t pkt[NUM_PKTS];
+	int i;
+
+	for (i = 0; i < num; i++) {
+		pkt[i] = odp_packet_alloc(gbl->pool, PKT_LEN);
+		if (pkt[i] == ODP_PACKET_INVALID) {
+			LOG_ERR("Error: packet alloc failed.\n");
+			odp_packet_free_multi(pkt, i);
+			return -1;
+		}
+
+		*(uint8_t *)odp_packet_data(pkt[i]) = tag;
+	}
+
+	return odph_tm_enq_multi(tm, queue, pkt, num);
+}
+
+/* Receive what the TM sent over the loop interface, in order */
+static void rx(void)
+{
+	odp_packet_t pkt[64];
+	int num, i;
+
+	gbl->num_rx = 0;
+
+	while ((num = odp_pktio_recv(gbl->pktio, pkt, 64)) > 0) {
+		for (i = 0; i < num; i++) {
+			if (gbl->num_rx < MAX_RX)
+				gbl->tag[gbl->num_rx++] =
+					*(uint8_t *)odp_packet_data(pkt[i]);
+			odp_packet_free(pkt[i]);
+		}
+	}
+}
+
+static odph_tm_t *tm_create(const char *name)
+{
+	odph_tm_param_t param;
+	odph_tm_t *tm;
+
+	odph_tm_param_init(&param);
+	param.pktio = gbl->pktio;
+
+	tm = odph_tm_create(name, &param);
+	if (tm == NULL)
+		LOG_ERR("Error: %s create failed.\n", name);
+
+	return tm;
+}
+
+static int test_priority(void)
+{
+	odph_tm_queue_param_t qparam;
+	odph_tm_t *tm;
+	int lo, hi, i, ret = 0;
+
+	tm = tm_create("tm_prio");
+	if (tm == NULL)
+		return -1;
+
+	odph_tm_queue_param_init(&qparam);
+	qparam.node.prio = 1;
+	lo = odph_tm_queue_create(tm, ODPH_TM_PORT, &qparam);
+	qparam.node.prio = 0;
+	hi = odph_tm_queue_create(tm, ODPH_TM_PORT, &qparam);
+
+	qparam.node.prio = ODPH_TM_PRIOS;
+	if (odph_tm_queue_create(tm, ODPH_TM_PORT, &qparam) >= 0 ||
+	    odph_tm_queue_create(tm, 0, &qparam) >= 0) {
+		LOG_ERR("Error: queue created with bad parameters.\n");
+		ret = -1;
+	}
+
+	if (lo < 0 || hi < 0 || enq(tm, lo, 10, 1) != 10 ||
+	    enq(tm, hi, 10, 0) != 10) {
+		LOG_ERR("Error: queue setup failed.\n");
+		odph_tm_destroy(tm);
+		return -1;
+	}
+
+	if (odph_tm_send(tm, ODPH_TM_MAX_BURST) != 20) {
+		LOG_ERR("Error: priority send failed.\n");
+		ret = -1;
+	}
+
+	rx();
+	for (i = 0; i < gbl->num_rx; i++) {
+		if (gbl->tag[i] != (i < 10 ? 0 : 1)) {
+			LOG_ERR("Error: packet %i out of priority order.\n", i);
+			ret = -1;
+			break;
+		}
+	}
+
+	if (gbl->num_rx != 20 || odph_tm_send(tm, ODPH_TM_MAX_BURST) != 0) {
+		LOG_ERR("Error: received %i packets.\n", gbl->num_rx);
+		ret = -1;
+	}
+
+	if (odph_tm_destroy(tm))
+		ret = -1;
+
+	return ret;
+}
+
+/* Two classes with weights 1 and 3, one queue each */
+static int test_weights(void)
+{
+	odph_tm_node_param_t cparam;
+	odph_tm_queue_param_t qparam;
+	odph_tm_t *tm;
+	int cls[2], queue[2], count[2] = {0, 0};
+	int i, num, ret = 0;
+
+	tm = tm_create("tm_weight");
+	if (tm == NULL)
+		return -1;
+
+	odph_tm_queue_param_init(&qparam);
+
+	for (i = 0; i < 2; i++) {
+		odph_tm_node_param_init(&cparam);
+		cparam.weight = 1 + 2 * i;
+		cls[i]   = odph_tm_class_create(tm, &cparam);
+		queue[i] = odph_tm_queue_create(tm, cls[i], &qparam);
+
+		if (cls[i] < 0 || queue[i] < 0 ||
+		    enq(tm, queue[i], 200, i) != 200) {
+			LOG_ERR("Error: class setup failed.\n");
+			odph_tm_destroy(tm);
+			return -1;
+		}
+	}
+
+	num  = odph_tm_send(tm, 40);
+	num += odph_tm_send(tm, 40);
+
+	rx();
+	for (i = 0; i < gbl->num_rx; i++)
+		count[gbl->tag[i]]++;
+
+	printf("  weights 1:3 sent %i:%i packets\n", count[0], count[1]);
+
+	if (num != 80 || gbl->num_rx != 80) {
+		LOG_ERR("Error: sent %i, received %i.\n", num, gbl->num_rx);
+		ret = -1;
+	}
+
+	/* Three times as many, give or take a round */
+	if (count[1] < 2 * count[0] || count[1] > 4 * count[0]) {
+		LOG_ERR("Error: weights not respected.\n");
+		ret = -1;
+	}
+
+	/* Destroy frees the packets left */
+	if (odph_tm_destroy(tm))
+		ret = -1;
+
+	return ret;
+}
+
+static int test_shaper(void)
+{
+	odph_tm_queue_param_t qparam;
+	odph_tm_stats_t stats;
+	odph_tm_t *tm;
+	uint64_t start, ns, end_ns, rate_bytes, expected;
+	int queue, ret = 0;
+
+	tm = tm_create("tm_shape");
+	if (tm == NULL)
+		return -1;
+
+	odph_tm_queue_param_init(&qparam);
+	qparam.node.shaper.rate_bps = SHAPE_BPS;
+	qparam.node.shaper.burst    = SHAPE_BURST;
+
+	queue = odph_tm_queue_create(tm, ODPH_TM_PORT, &qparam);
+	if (queue < 0 || enq(tm, queue, 300, 0) != 300) {
+		LOG_ERR("Error: queue setup failed.\n");
+		odph_tm_destroy(tm);
+		return -1;
+	}
+
+	/* Time taken before each send, the last send has all the tokens
+	 * of 'ns' */
+	start = odp_time_to_ns(odp_time_local());
+	do {
+		ns = odp_time_to_ns(odp_time_local()) - start;
+		odph_tm_send(tm, ODPH_TM_MAX_BURST);
+		rx();
+	} while (ns < SHAPE_MS * ODP_TIME_MSEC_IN_NS);
+
+	end_ns = odp_time_to_ns(odp_time_local()) - start;
+	odph_tm_stats(tm, queue, &stats);
+
+	/* At most the burst, the rate until the end and one packet of debt */
+	expected = SHAPE_BURST + (uint64_t)SHAPE_BPS / 8 * end_ns /
+		   ODP_TIME_SEC_IN_NS + PKT_LEN;
+
+	/* At least half of the rate until the last send */
+	rate_bytes = (uint64_t)SHAPE_BPS / 8 * ns / ODP_TIME_SEC_IN_NS;
+
+	printf("  %i kbps shaper sent %" PRIu64 " bytes in %" PRIu64
+	       " us, at most %" PRIu64 " expected\n", SHAPE_BPS / 1000,
+	       stats.bytes, ns / 1000, expected);
+
+	/* The bucket holds 40 ms at the rate, so no tokens are lost while
+	 * the loop is preempted for less than that */
+	if (stats.bytes > expected ||
+	    stats.bytes < SHAPE_BURST + rate_bytes / 2) {
+		LOG_ERR("Error: shaper rate not respected.\n");
+		ret = -1;
+	}
+
+	if (odph_tm_destroy(tm))
+		ret = -1;
+
+	return ret;
+}
+
+static int test_drops(void)
+{
+	odph_tm_queue_param_t qparam;
+	odph_tm_stats_t stats;
+	odph_tm_t *tm;
+	int tail, wred, num, ret = 0;
+
+	tm = tm_create("tm_drop");
+	if (tm == NULL)
+		return -1;
+
+	odph_tm_queue_param_init(&qparam);
+	qparam.size = 16;
+	tail = odph_tm_queue_create(tm, ODPH_TM_PORT, &qparam);
+
+	qparam.size        = 64;
+	qparam.drop        = ODPH_TM_DROP_WRED;
+	qparam.wred.min_th = 4;
+	qparam.wred.max_th = 16;
+	qparam.wred.max_p  = 50;
+	wred = odph_tm_queue_create(tm, ODPH_TM_PORT, &qparam);
+
+	if (tail < 0 || wred < 0) {
+		LOG_ERR("Error: queue setup failed.\n");
+		odph_tm_destroy(tm);
+		return -1;
+	}
+
+	num = enq(tm, tail, 40, 0);
+	odph_tm_stats(tm, tail, &stats);
+	if (num != 15 || stats.tail_drops != 25 || stats.wred_drops) {
+		LOG_ERR("Error: tail drop queued %i.\n", num);
+		ret = -1;
+	}
+
+	num = enq(tm, wred, 60, 1);
+	odph_tm_stats(tm, wred, &stats);
+	printf("  WRED queued %i of 60\n", num);
+	if (num >= 60 || stats.wred_drops != (uint64_t)(60 - num) ||
+	    stats.tail_drops) {
+		LOG_ERR("Error: WRED queued %i.\n", num);
+		ret = -1;
+	}
+
+	odph_tm_send(tm, ODPH_TM_MAX_BURST);
+	rx();
+
+	odph_tm_stats(tm, ODPH_TM_PORT, &stats);
+	if (stats.packets != (uint64_t)gbl->num_rx || stats.tail_drops != 25) {
+		LOG_ERR("Error: port statistics.\n");
+		ret = -1;
+	}
+
+	if (odph_tm_destroy(tm))
+		ret = -1;
+
+	return ret;
+}
+
+static int run_test(void)
+{
+	odp_pool_param_t params;
+	odp_pktio_param_t pktio_param;
+	odp_shm_t shm;
+	int ret = 0;
+
+	shm = odp_shm_reserve("test_globals", sizeof(test_globals_t),
+			      ODP_CACHE_LINE_SIZE, 0);
+	gbl = odp_shm_addr(shm);
+	if (gbl == NULL) {
+		LOG_ERR("Error: shm reserve failed.\n");
+		return -1;
+	}
+	memset(gbl, 0, sizeof(*gbl));
+
+	odp_pool_param_init(&params);
+	params.pkt.seg_len = PKT_LEN;
+	params.pkt.len     = PKT_LEN;
+	params.pkt.num     = NUM_PKTS;
+	params.type        = ODP_POOL_PACKET;
+
+	gbl->pool = odp_pool_create("tm_pool", &params);
+	if (gbl->pool == ODP_POOL_INVALID) {
+		LOG_ERR("Error: pool create failed.\n");
+		odp_shm_free(shm);
+		return -1;
+	}
+
+	odp_pktio_param_init(&pktio_param);
+	pktio_param.in_mode  = ODP_PKTIN_MODE_RECV;
+	pktio_param.out_mode = ODP_PKTOUT_MODE_SEND;
+
+	gbl->pktio = odp_pktio_open("loop", gbl->pool, &pktio_param);
+	if (gbl->pktio == ODP_PKTIO_INVALID || odp_pktio_start(gbl->pktio)) {
+		LOG_ERR("Error: loop pktio open failed.\n");
+		ret = -1;
+	}
+
+	if (ret == 0 && test_priority())
+		ret = -1;
+
+	if (ret == 0 && test_weights())
+		ret = -1;
+
+	if (ret == 0 && test_shaper())
+		ret = -1;
+
+	if (ret == 0 && test_drops())
+		ret = -1;
+
+	if (gbl->pktio != ODP_PKTIO_INVALID) {
+		odp_pktio_stop(gbl->pktio);
+		odp_pktio_close(gbl->pktio);
+	}
+
+	odp_pool_destroy(gbl->pool);
+	odp_shm_free(shm);
+	return ret;
+}
+
+int main(int argc TEST_UNUSED, char *argv[] TEST_UNUSED)
+{
+	int ret;
+
+	if (odp_init_global(NULL, NULL)) {
+		LOG_ERR("Error: ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_init_local(ODP_THREAD_CONTROL)) {
+		LOG_ERR("Error: ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	ret = run_test();
+
+	if (odp_term_local()) {
+		LOG_ERR("Error: ODP local term failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global()) {
+		LOG_ERR("Error: ODP global term failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (ret)
+		exit(EXIT_FAILURE);
+
+	return 0;
+}
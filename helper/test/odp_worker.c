@@ -0,0 +1,101 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <test_debug.h>
+#include <odp.h>
+#include <odp/helper/linux.h>
+
+#include <sched.h>
+
+#define NUMBER_WORKERS 16
+
+static odp_atomic_u32_t workers_run;
+
+static void *worker_fn(void *arg TEST_UNUSED)
+{
+	/* depend on the odp helper to call odp_init_local */
+
+	printf("Worker thread on CPU %d\n", odp_cpu_id());
+	odp_atomic_inc_u32(&workers_run);
+
+	/* depend on the odp helper to call odp_term_local */
+
+	return 0;
+}
+
+/* Launch workers with topology based placement */
+int main(int argc TEST_UNUSED, char *argv[] TEST_UNUSED)
+{
+	odph_linux_pthread_t thread_tbl[NUMBER_WORKERS];
+	odph_linux_worker_param_t param;
+	odp_cpumask_t cpu_mask;
+	cpu_set_t affinity;
+	int num_workers;
+	int cpu;
+
+	if (odp_init_global(NULL, NULL)) {
+		LOG_ERR("Error: ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_init_local(ODP_THREAD_CONTROL)) {
+		LOG_ERR("Error: ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* virtual interfaces do not have a node */
+	if (odph_linux_netdev_node("lo") != -1) {
+		LOG_ERR("Error: node of lo\n");
+		exit(EXIT_FAILURE);
+	}
+
+	odph_linux_worker_param_init(&param);
+	param.num  = NUMBER_WORKERS;
+	param.node = odph_linux_netdev_node("lo");
+
+	/* selected CPUs must be usable by this process */
+	num_workers = odph_linux_cpumask_worker(&cpu_mask, &param);
+	if (num_workers < 1 || num_workers != odp_cpumask_count(&cpu_mask)) {
+		LOG_ERR("Error: %i worker CPUs selected\n", num_workers);
+		exit(EXIT_FAILURE);
+	}
+
+	sched_getaffinity(0, sizeof(affinity), &affinity);
+	for (cpu = odp_cpumask_first(&cpu_mask); cpu >= 0;
+	     cpu = odp_cpumask_next(&cpu_mask, cpu)) {
+		if (!CPU_ISSET(cpu, &affinity)) {
+			LOG_ERR("Error: CPU %i not in affinity mask\n", cpu);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	/* unprivileged SCHED_FIFO and mlock fall back with a warning */
+	param.fifo_prio = 1;
+	param.mlock     = 1;
+
+	odp_atomic_init_u32(&workers_run, 0);
+	num_workers = odph_linux_worker_create(thread_tbl, &param, worker_fn,
+					       NULL);
+	odph_linux_pthread_join(thread_tbl, num_workers);
+
+	if (num_workers < 1 ||
+	    odp_atomic_load_u32(&workers_run) != (uint32_t)num_workers) {
+		LOG_ERR("Error: %i workers launched\n", num_workers);
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_local()) {
+		LOG_ERR("Error: ODP local term failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_term_global()) {
+		LOG_ERR("Error: ODP global term failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return 0;
+}
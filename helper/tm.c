@@ -0,0 +1,482 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <odp.h>
+#include <odp/helper/ring.h>
+#include <odp/helper/tm.h>
+#include "odph_debug.h"
+
+#define QUEUE_SIZE_DEFAULT 1024
+#define QUANTUM_DEFAULT    1536
+#define MAX_CHILDREN       (ODPH_TM_MAX_CLASSES + ODPH_TM_MAX_QUEUES)
+#define NUM_NODES          (1 + MAX_CHILDREN)
+#define CLASS_NODE(i)      (1 + (i))
+#define QUEUE_NODE(i)      (1 + ODPH_TM_MAX_CLASSES + (i))
+
+/* Round robin passes over the children before giving up, enough for a
+ * jumbo frame with the smallest quantum */
+#define MAX_ROUNDS         8
+
+/* WRED average queue length: 8 fraction bits, new sample weight 1/8 */
+#define WRED_SHIFT         8
+#define WRED_WEIGHT        3
+
+/* Packets are held in rings as pointers */
+_ODP_STATIC_ASSERT(sizeof(odp_packet_t) == sizeof(void *),
+		   "Packet handle is not pointer sized");
+
+typedef struct {
+	int used;
+	int leaf;
+	int parent;		/* Node index, -1: port */
+	odph_tm_node_param_t param;
+
+	/* Shaper, tokens in bytes scaled by ODP_TIME_SEC_IN_NS */
+	uint64_t rate;		/* Bytes per second */
+	int64_t tokens;
+	int64_t burst;
+	uint64_t last_ns;
+
+	/* Round robin among the siblings */
+	int64_t deficit;
+
+	/* Children by priority, served from 'cursor' */
+	int child[ODPH_TM_PRIOS][MAX_CHILDREN];
+	int num_child[ODPH_TM_PRIOS];
+	int cursor[ODPH_TM_PRIOS];
+	int quantum_given[ODPH_TM_PRIOS];
+
+	/* Queue */
+	odph_ring_t *ring;
+	odp_packet_t head;	/* Next packet, taken off the ring */
+	odp_spinlock_t lock;	/* Enqueue */
+	odph_tm_drop_t drop;
+	odph_tm_wred_t wred;
+	uint32_t avg;		/* Average length, WRED_SHIFT fraction bits */
+	uint32_t rnd;
+	odph_tm_stats_t stats;
+} node_t;
+
+struct odph_tm_s {
+	char name[ODP_SHM_NAME_LEN];
+	odp_shm_t shm;
+	odp_pktio_t pktio;
+	uint32_t quantum;
+	int num_classes;
+	int num_queues;
+	int num_pending;
+	odp_packet_t pending[ODPH_TM_MAX_BURST];
+	node_t node[NUM_NODES];
+};
+
+static inline uint64_t now_ns(void)
+{
+	return odp_time_to_ns(odp_time_global());
+}
+
+static void shaper_init(node_t *node, const odph_tm_shaper_t *shaper,
+			uint64_t now)
+{
+	uint64_t burst = shaper->burst;
+
+	node->rate = shaper->rate_bps / 8;
+
+	/* Default to 10 ms at the rate */
+	if (burst == 0)
+		burst = node->rate / 100 ? node->rate / 100 : 1;
+
+	node->burst   = (int64_t)burst * ODP_TIME_SEC_IN_NS;
+	node->tokens  = node->burst;
+	node->last_ns = now;
+}
+
+/* Refill tokens for the time since the last visit */
+static inline int shaper_conform(node_t *node, uint64_t now)
+{
+	uint64_t dt;
+
+	if (node->rate == 0)
+		return 1;
+
+	if (now > node->last_ns) {
+		dt = now - node->last_ns;
+		node->last_ns = now;
+
+		if (dt >= (uint64_t)(node->burst - node->tokens) / node->rate)
+			node->tokens = node->burst;
+		else
+			node->tokens += dt * node->rate;
+	}
+
+	return node->tokens > 0;
+}
+
+void odph_tm_param_init(odph_tm_param_t *param)
+{
+	memset(param, 0, sizeof(*param));
+	param->pktio   = ODP_PKTIO_INVALID;
+	param->quantum = QUANTUM_DEFAULT;
+}
+
+void odph_tm_node_param_init(odph_tm_node_param_t *param)
+{
+	memset(param, 0, sizeof(*param));
+	param->weight = 1;
+}
+
+void odph_tm_queue_param_init(odph_tm_queue_param_t *param)
+{
+	memset(param, 0, sizeof(*param));
+	odph_tm_node_param_init(&param->node);
+	param->size = QUEUE_SIZE_DEFAULT;
+	param->drop = ODPH_TM_DROP_TAIL;
+}
+
+odph_tm_t *odph_tm_create(const char *name, const odph_tm_param_t *param)
+{
+	odph_tm_t *tm;
+	odp_shm_t shm;
+
+	if (param->pktio == ODP_PKTIO_INVALID || param->quantum == 0) {
+		ODPH_ERR("Bad traffic manager parameters\n");
+		return NULL;
+	}
+
+	shm = odp_shm_reserve(name, sizeof(odph_tm_t), ODP_CACHE_LINE_SIZE, 0);
+	tm = odp_shm_addr(shm);
+	if (tm == NULL) {
+		ODPH_ERR("Traffic manager %s reserve failed\n", name);
+		return NULL;
+	}
+
+	memset(tm, 0, sizeof(*tm));
+	snprintf(tm->name, sizeof(tm->name), "%s", name);
+	tm->shm     = shm;
+	tm->pktio   = param->pktio;
+	tm->quantum = param->quantum;
+
+	tm->node[0].used   = 1;
+	tm->node[0].parent = -1;
+	shaper_init(&tm->node[0], &param->shaper, now_ns());
+
+	return tm;
+}
+
+static int node_add(odph_tm_t *tm, int idx, int parent,
+		    const odph_tm_node_param_t *param)
+{
+	node_t *node = &tm->node[idx];
+	node_t *up = &tm->node[parent];
+
+	if (param->prio >= ODPH_TM_PRIOS || param->weight == 0) {
+		ODPH_ERR("Bad node parameters\n");
+		return -1;
+	}
+
+	node->used   = 1;
+	node->parent = parent;
+	node->param  = *param;
+	node->head   = ODP_PACKET_INVALID;
+	shaper_init(node, &param->shaper, now_ns());
+
+	up->child[param->prio][up->num_child[param->prio]++] = idx;
+	return 0;
+}
+
+int odph_tm_class_create(odph_tm_t *tm, const odph_tm_node_param_t *param)
+{
+	int cls = tm->num_classes;
+
+	if (cls >= ODPH_TM_MAX_CLASSES ||
+	    node_add(tm, CLASS_NODE(cls), 0, param))
+		return -1;
+
+	tm->num_classes++;
+	return cls;
+}
+
+int odph_tm_queue_create(odph_tm_t *tm, int parent,
+			 const odph_tm_queue_param_t *param)
+{
+	char ring_name[ODPH_RING_NAMESIZE];
+	int queue = tm->num_queues;
+	node_t *node = &tm->node[QUEUE_NODE(queue)];
+
+	if (queue >= ODPH_TM_MAX_QUEUES ||
+	    (parent != ODPH_TM_PORT &&
+	     (parent < 0 || parent >= tm->num_classes)) ||
+	    (param->drop == ODPH_TM_DROP_WRED &&
+	     (param->wred.min_th >= param->wred.max_th ||
+	      param->wred.max_p > 100))) {
+		ODPH_ERR("Bad queue parameters\n");
+		return -1;
+	}
+
+	/* Enqueues are serialized by the queue lock, one thread sends */
+	snprintf(ring_name, sizeof(ring_name), "%.20s.q%i", tm->name, queue);
+	node->ring = odph_ring_create(ring_name, param->size,
+				      ODPH_RING_F_SP_ENQ | ODPH_RING_F_SC_DEQ);
+	if (node->ring == NULL) {
+		ODPH_ERR("Queue ring %s create failed\n", ring_name);
+		return -1;
+	}
+
+	if (node_add(tm, QUEUE_NODE(queue),
+		     parent == ODPH_TM_PORT ? 0 : CLASS_NODE(parent),
+		     &param->node)) {
+		odph_ring_free(node->ring);
+		node->ring = NULL;
+		return -1;
+	}
+
+	node->leaf = 1;
+	node->drop = param->drop;
+	node->wred = param->wred;
+	node->rnd  = 0x9e3779b9 + queue;
+	odp_spinlock_init(&node->lock);
+
+	tm->num_queues++;
+	return queue;
+}
+
+int odph_tm_destroy(odph_tm_t *tm)
+{
+	odp_packet_t pkt;
+	int ret = 0;
+	int i;
+
+	odp_packet_free_multi(tm->pending, tm->num_pending);
+
+	for (i = 0; i < tm->num_queues; i++) {
+		node_t *node = &tm->node[QUEUE_NODE(i)];
+
+		if (node->head != ODP_PACKET_INVALID)
+			odp_packet_free(node->head);
+
+		while (odph_ring_sc_dequeue_bulk(node->ring, (void **)&pkt,
+						 1) == 0)
+			odp_packet_free(pkt);
+
+		if (odph_ring_free(node->ring))
+			ret = -1;
+	}
+
+	if (odp_shm_free(tm->shm))
+		ret = -1;
+
+	return ret;
+}
+
+/* Random early drop on the average queue length */
+static inline int wred_drop(node_t *node, uint32_t len)
+{
+	uint32_t min = node->wred.min_th << WRED_SHIFT;
+	uint32_t max = node->wred.max_th << WRED_SHIFT;
+	uint32_t prob;
+
+	node->avg += ((int32_t)(len << WRED_SHIFT) - (int32_t)node->avg) >>
+		     WRED_WEIGHT;
+
+	if (node->avg < min)
+		return 0;
+
+	if (node->avg >= max)
+		return 1;
+
+	/* Drop probability in 1/65536 */
+	prob = (uint64_t)node->wred.max_p * 65536 / 100 *
+	       (node->avg - min) / (max - min);
+
+	node->rnd ^= node->rnd << 13;
+	node->rnd ^= node->rnd >> 17;
+	node->rnd ^= node->rnd << 5;
+
+	return (node->rnd & 0xffff) < prob;
+}
+
+int odph_tm_enq_multi(odph_tm_t *tm, int queue, odp_packet_t pkt[], int num)
+{
+	node_t *node;
+	int queued = 0;
+	int i;
+
+	if (queue < 0 || queue >= tm->num_queues)
+		return -1;
+
+	node = &tm->node[QUEUE_NODE(queue)];
+	odp_spinlock_lock(&node->lock);
+
+	for (i = 0; i < num; i++) {
+		if (node->drop == ODPH_TM_DROP_WRED &&
+		    wred_drop(node, odph_ring_count(node->ring))) {
+			node->stats.wred_drops++;
+			odp_packet_free(pkt[i]);
+			continue;
+		}
+
+		if (odph_ring_sp_enqueue_bulk(node->ring, (void **)&pkt[i],
+					      1)) {
+			node->stats.tail_drops++;
+			odp_packet_free(pkt[i]);
+			continue;
+		}
+
+		queued++;
+	}
+
+	odp_spinlock_unlock(&node->lock);
+	return queued;
+}
+
+/* Queue to send from next in a subtree, without taking the packet */
+static int pick(odph_tm_t *tm, int idx, uint64_t now, uint32_t *len)
+{
+	node_t *node = &tm->node[idx];
+	node_t *child;
+	int prio, leaf, visits, idle, num, c;
+	uint32_t plen;
+
+	if (node->leaf) {
+		if (node->head == ODP_PACKET_INVALID &&
+		    odph_ring_sc_dequeue_bulk(node->ring,
+					      (void **)&node->head, 1))
+			return -1;
+
+		*len = odp_packet_len(node->head);
+		return idx;
+	}
+
+	for (prio = 0; prio < ODPH_TM_PRIOS; prio++) {
+		num  = node->num_child[prio];
+		idle = 0;
+
+		/* Until a pass finds no child with a packet to send */
+		for (visits = 0; visits < MAX_ROUNDS * num && idle < num;
+		     visits++) {
+			c = node->cursor[prio];
+			child = &tm->node[node->child[prio][c]];
+
+			if (shaper_conform(child, now)) {
+				leaf = pick(tm, node->child[prio][c], now,
+					    &plen);
+
+				/* Empty children don't save credit */
+				if (leaf < 0)
+					child->deficit = 0;
+			} else {
+				leaf = -1;
+			}
+
+			if (leaf >= 0) {
+				idle = 0;
+
+				if (!node->quantum_given[prio]) {
+					child->deficit += (int64_t)tm->quantum *
+							  child->param.weight;
+					node->quantum_given[prio] = 1;
+				}
+
+				if (child->deficit >= plen) {
+					*len = plen;
+					return leaf;
+				}
+			} else {
+				idle++;
+			}
+
+			node->cursor[prio] = c + 1 < num ? c + 1 : 0;
+			node->quantum_given[prio] = 0;
+		}
+	}
+
+	return -1;
+}
+
+/* Charge a packet to the shapers and deficits up from the queue */
+static void charge(odph_tm_t *tm, int idx, uint32_t len)
+{
+	node_t *node;
+
+	while (idx >= 0) {
+		node = &tm->node[idx];
+
+		if (node->rate)
+			node->tokens -= (int64_t)len * ODP_TIME_SEC_IN_NS;
+
+		node->deficit -= len;
+		idx = node->parent;
+	}
+}
+
+int odph_tm_send(odph_tm_t *tm, int max)
+{
+	node_t *port = &tm->node[0];
+	uint64_t now = now_ns();
+	odp_packet_t pkt;
+	uint32_t len;
+	int num = tm->num_pending;
+	int idx, sent;
+
+	if (max > ODPH_TM_MAX_BURST)
+		max = ODPH_TM_MAX_BURST;
+
+	while (num < max && shaper_conform(port, now)) {
+		idx = pick(tm, 0, now, &len);
+		if (idx < 0)
+			break;
+
+		pkt = tm->node[idx].head;
+		tm->node[idx].head = ODP_PACKET_INVALID;
+		charge(tm, idx, len);
+
+		tm->node[idx].stats.packets++;
+		tm->node[idx].stats.bytes += len;
+		tm->pending[num++] = pkt;
+	}
+
+	if (num == 0)
+		return 0;
+
+	sent = odp_pktio_send(tm->pktio, tm->pending, num);
+	if (sent < 0)
+		sent = 0;
+
+	tm->num_pending = num - sent;
+	if (sent && tm->num_pending)
+		memmove(tm->pending, &tm->pending[sent],
+			tm->num_pending * sizeof(odp_packet_t));
+
+	return sent;
+}
+
+int odph_tm_stats(odph_tm_t *tm, int queue, odph_tm_stats_t *stats)
+{
+	int i;
+
+	if (queue != ODPH_TM_PORT && (queue < 0 || queue >= tm->num_queues))
+		return -1;
+
+	if (queue != ODPH_TM_PORT) {
+		*stats = tm->node[QUEUE_NODE(queue)].stats;
+		return 0;
+	}
+
+	memset(stats, 0, sizeof(*stats));
+
+	for (i = 0; i < tm->num_queues; i++) {
+		odph_tm_stats_t *s = &tm->node[QUEUE_NODE(i)].stats;
+
+		stats->packets    += s->packets;
+		stats->bytes      += s->bytes;
+		stats->tail_drops += s->tail_drops;
+		stats->wred_drops += s->wred_drops;
+	}
+
+	return 0;
+}
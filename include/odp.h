@@ -57,6 +57,9 @@ extern "C" {
 #include <odp/thrmask.h>
 #include <odp/spinlock_recursive.h>
 #include <odp/rwlock_recursive.h>
+#include <odp/mcslock.h>
+#include <odp/pflock.h>
+#include <odp/rcu.h>
 #include <odp/std_clib.h>
 
 #ifdef __cplusplus
@@ -96,6 +96,8 @@ typedef struct odp_cls_cos_param {
 	odp_queue_t queue;	/**< Queue associated with CoS */
 	odp_pool_t pool;	/**< Pool associated with CoS */
 	odp_cls_drop_t drop_policy;	/**< Drop policy associated with CoS */
+	/** Packet vectors of the CoS queue, disabled by default */
+	odp_packet_vector_param_t vector;
 } odp_cls_cos_param_t;
 
 /**
@@ -39,7 +39,7 @@ extern "C" {
  * @typedef odp_event_type_t
  * ODP event types:
  * ODP_EVENT_BUFFER, ODP_EVENT_PACKET, ODP_EVENT_TIMEOUT,
- * ODP_EVENT_CRYPTO_COMPL
+ * ODP_EVENT_CRYPTO_COMPL, ODP_EVENT_PACKET_VECTOR
  */
 
 /**
@@ -68,7 +68,8 @@ uint64_t odp_event_to_u64(odp_event_t hdl);
  * Free event
  *
  * Frees the event based on its type. Results are undefined if event
- * type is unknown.
+ * type is unknown. A packet vector is freed together with the packets
+ * it holds.
  *
  * @param event    Event handle
  *
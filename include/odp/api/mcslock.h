@@ -0,0 +1,99 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+
+/**
+ * @file
+ *
+ * ODP MCS lock
+ */
+
+#ifndef ODP_API_MCSLOCK_H_
+#define ODP_API_MCSLOCK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup odp_locks
+ * @details
+ * <b> MCS lock (odp_mcslock_t) </b>
+ *
+ * MCS lock is a fair (FIFO) queue lock. Each thread brings its own queue
+ * node (odp_mcslock_node_t) and spins only on that node, instead of on the
+ * shared lock word. Lock hand-over touches only the cache lines of the
+ * previous and next owner, which keeps the lock scalable under heavy
+ * contention and across NUMA nodes when nodes are allocated from thread
+ * local memory (e.g. the stack). The same node must be passed to lock and
+ * unlock calls, and a node must not be used for another lock meanwhile.
+ * MCS locks shall not be used if a thread may be preempted.
+ * @{
+ */
+
+/**
+ * @typedef odp_mcslock_t
+ * ODP MCS lock
+ */
+
+/**
+ * @typedef odp_mcslock_node_t
+ * ODP MCS lock queue node
+ */
+
+/**
+ * Initialize MCS lock.
+ *
+ * @param lock    Pointer to an MCS lock
+ */
+void odp_mcslock_init(odp_mcslock_t *lock);
+
+/**
+ * Acquire MCS lock.
+ *
+ * @param lock    Pointer to an MCS lock
+ * @param node    Queue node of the calling thread
+ */
+void odp_mcslock_lock(odp_mcslock_t *lock, odp_mcslock_node_t *node);
+
+/**
+ * Try to acquire MCS lock.
+ *
+ * @param lock    Pointer to an MCS lock
+ * @param node    Queue node of the calling thread
+ *
+ * @retval 1 lock acquired
+ * @retval 0 lock not acquired
+ */
+int odp_mcslock_trylock(odp_mcslock_t *lock, odp_mcslock_node_t *node);
+
+/**
+ * Release MCS lock.
+ *
+ * @param lock    Pointer to an MCS lock
+ * @param node    Queue node used to acquire the lock
+ */
+void odp_mcslock_unlock(odp_mcslock_t *lock, odp_mcslock_node_t *node);
+
+/**
+ * Check if MCS lock is locked.
+ *
+ * @param lock    Pointer to an MCS lock
+ *
+ * @retval 1 the lock is busy (locked)
+ * @retval 0 the lock is available (unlocked)
+ */
+int odp_mcslock_is_locked(odp_mcslock_t *lock);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -48,6 +48,16 @@ extern "C" {
  * Invalid packet segment
  */
 
+/**
+ * @typedef odp_packet_vector_t
+ * ODP packet vector
+ */
+
+/**
+ * @def ODP_PACKET_VECTOR_INVALID
+ * Invalid packet vector
+ */
+
 /*
  *
  * Alloc and free
@@ -900,6 +910,124 @@ int odp_packet_copydata_out(odp_packet_t pkt, uint32_t offset,
 int odp_packet_copydata_in(odp_packet_t pkt, uint32_t offset,
 			   uint32_t len, const void *src);
 
+/*
+ *
+ * Packet vectors
+ * ********************************************************
+ *
+ */
+
+/**
+ * Packet vector parameters
+ *
+ * When enabled, packet input and the classifier enqueue received packets
+ * as packet vectors (ODP_EVENT_PACKET_VECTOR) instead of one event per
+ * packet. A vector holds packets that were received in the same burst and
+ * are destined to the same queue, in reception order.
+ */
+typedef struct odp_packet_vector_param_t {
+	/** 1: enqueue packet vectors, 0: enqueue packets (default) */
+	odp_bool_t enable;
+
+	/** Vector pool of type ODP_POOL_VECTOR */
+	odp_pool_t pool;
+
+	/** Maximum number of packets per vector. Use 0 for the maximum of
+	 *  the pool. */
+	uint32_t max_size;
+} odp_packet_vector_param_t;
+
+/**
+ * Allocate a packet vector
+ *
+ * The vector is allocated empty.
+ *
+ * @param pool   Pool of type ODP_POOL_VECTOR
+ *
+ * @return Handle of allocated packet vector
+ * @retval ODP_PACKET_VECTOR_INVALID  Vector could not be allocated
+ */
+odp_packet_vector_t odp_packet_vector_alloc(odp_pool_t pool);
+
+/**
+ * Free a packet vector
+ *
+ * Packets in the vector are not freed. Use odp_event_free() to free the
+ * vector together with its packets.
+ *
+ * @param pktv   Packet vector handle
+ */
+void odp_packet_vector_free(odp_packet_vector_t pktv);
+
+/**
+ * Get packet vector handle from event
+ *
+ * @param ev     Event handle of type ODP_EVENT_PACKET_VECTOR
+ *
+ * @return Packet vector handle
+ */
+odp_packet_vector_t odp_packet_vector_from_event(odp_event_t ev);
+
+/**
+ * Convert packet vector handle to event
+ *
+ * @param pktv   Packet vector handle
+ *
+ * @return Event handle
+ */
+odp_event_t odp_packet_vector_to_event(odp_packet_vector_t pktv);
+
+/**
+ * Packet table of a vector
+ *
+ * The table has room for the maximum number of packets of the vector
+ * pool. The application may read and overwrite the packet handles and
+ * update the number of valid entries with odp_packet_vector_size_set().
+ *
+ * @param      pktv     Packet vector handle
+ * @param[out] pkt_tbl  Pointer to the packet table
+ *
+ * @return Number of packets in the vector
+ */
+uint32_t odp_packet_vector_tbl(odp_packet_vector_t pktv,
+			       odp_packet_t **pkt_tbl);
+
+/**
+ * Number of packets in a vector
+ *
+ * @param pktv   Packet vector handle
+ *
+ * @return Number of packets
+ */
+uint32_t odp_packet_vector_size(odp_packet_vector_t pktv);
+
+/**
+ * Set the number of packets in a vector
+ *
+ * @param pktv   Packet vector handle
+ * @param size   Number of valid entries in the packet table, up to the
+ *               maximum of the vector pool
+ */
+void odp_packet_vector_size_set(odp_packet_vector_t pktv, uint32_t size);
+
+/**
+ * Pool of a packet vector
+ *
+ * @param pktv   Packet vector handle
+ *
+ * @return Vector pool handle
+ */
+odp_pool_t odp_packet_vector_pool(odp_packet_vector_t pktv);
+
+/**
+ * Get printable value for an odp_packet_vector_t
+ *
+ * @param hdl  odp_packet_vector_t handle to be printed
+ * @return     uint64_t value that can be used to print/display this
+ *             handle
+ */
+uint64_t odp_packet_vector_to_u64(odp_packet_vector_t hdl);
+
 /*
  *
  * Debugging
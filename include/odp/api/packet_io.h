@@ -82,6 +82,30 @@ typedef enum odp_pktio_output_mode_t {
 	ODP_PKTOUT_MODE_DISABLED
 } odp_pktio_output_mode_t;
 
+/**
+ * Packet input parse level
+ *
+ * Protocol layers parsed by the implementation when a packet is received.
+ * Layers above the selected level are parsed on demand, when the application
+ * first accesses their metadata (e.g. odp_packet_l3_ptr() or
+ * odp_packet_has_udp()). Applications which never look above L2 (e.g. L2
+ * forwarders) save the cost of parsing by selecting a low level.
+ */
+typedef enum odp_pktio_parse_level_t {
+	/** Implementation default (L2) */
+	ODP_PKTIO_PARSE_DEFAULT = 0,
+	/** Do not parse on receive */
+	ODP_PKTIO_PARSE_NONE,
+	/** Parse L2 (Ethernet) metadata on receive */
+	ODP_PKTIO_PARSE_L2,
+	/** Parse up to and including L3 (VLAN, IPv4, IPv6, ARP) */
+	ODP_PKTIO_PARSE_L3,
+	/** Parse up to and including L4 (TCP, UDP, ICMP, IPsec) */
+	ODP_PKTIO_PARSE_L4,
+	/** Parse all supported protocol layers */
+	ODP_PKTIO_PARSE_ALL
+} odp_pktio_parse_level_t;
+
 /**
  * Packet IO parameters
  *
@@ -93,8 +117,63 @@ typedef struct odp_pktio_param_t {
 	odp_pktio_input_mode_t in_mode;
 	/** Packet output mode */
 	odp_pktio_output_mode_t out_mode;
+	/** Packet input parse level */
+	odp_pktio_parse_level_t parse_level;
+	/** Packet vectors of the default input queue. Applies to scheduled
+	 *  input (ODP_PKTIN_MODE_SCHED), disabled by default. */
+	odp_packet_vector_param_t in_vector;
 } odp_pktio_param_t;
 
+/**
+ * Packet IO statistics counters
+ *
+ * Counters accumulate from odp_pktio_open() or the last
+ * odp_pktio_stats_reset(). Counters an interface type cannot provide read
+ * as zero.
+ */
+typedef struct odp_pktio_stats_t {
+	/** Octets in received packets, including the Ethernet header */
+	uint64_t in_octets;
+	/** Packets received, either returned by odp_pktio_recv() or
+	 *  delivered to input queues */
+	uint64_t in_packets;
+	/** Received packets dropped without an error, e.g. because the
+	 *  application did not keep up with the interface */
+	uint64_t in_discards;
+	/** Received packets dropped because no packet buffer was available */
+	uint64_t in_no_buffers;
+	/** Received packets dropped by the classifier */
+	uint64_t in_cls_drops;
+	/** Receive errors */
+	uint64_t in_errors;
+	/** Octets in transmitted packets, including the Ethernet header */
+	uint64_t out_octets;
+	/** Packets accepted for transmission */
+	uint64_t out_packets;
+	/** Packets accepted for transmission but dropped without an error */
+	uint64_t out_discards;
+	/** Transmit errors */
+	uint64_t out_errors;
+} odp_pktio_stats_t;
+
+/**
+ * Packet IO per queue statistics counters
+ *
+ * Interfaces with several device queues (e.g. receive side scaling rings)
+ * count packets per queue. Interfaces with a single queue report their
+ * interface level packet and octet counters as queue 0.
+ */
+typedef struct odp_pktio_queue_stats_t {
+	/** Octets in packets received on the queue */
+	uint64_t in_octets;
+	/** Packets received on the queue */
+	uint64_t in_packets;
+	/** Octets in packets transmitted on the queue */
+	uint64_t out_octets;
+	/** Packets transmitted on the queue */
+	uint64_t out_packets;
+} odp_pktio_queue_stats_t;
+
 /**
  * Open a packet IO interface
  *
@@ -376,6 +455,57 @@ int odp_pktio_headroom_set(odp_pktio_t pktio, uint32_t headroom);
  */
 uint64_t odp_pktio_to_u64(odp_pktio_t pktio);
 
+/**
+ * Read pktio statistics counters
+ *
+ * Counters are kept per thread and summed when read, so reading is much
+ * more expensive than counting. Avoid calling this in the fast path.
+ *
+ * @param	pktio	Packet IO handle
+ * @param[out]	stats	Output buffer for counters
+ *
+ * @retval  0 on success
+ * @retval <0 on failure
+ */
+int odp_pktio_stats(odp_pktio_t pktio, odp_pktio_stats_t *stats);
+
+/**
+ * Reset pktio statistics counters
+ *
+ * Set all interface and queue counters of the pktio to zero.
+ *
+ * @param	pktio	Packet IO handle
+ *
+ * @retval  0 on success
+ * @retval <0 on failure
+ */
+int odp_pktio_stats_reset(odp_pktio_t pktio);
+
+/**
+ * Number of pktio queues with statistics counters
+ *
+ * @param	pktio	Packet IO handle
+ *
+ * @return Number of queues, valid queue indexes are 0 ... num - 1
+ * @retval <0 on failure
+ */
+int odp_pktio_stats_num_queues(odp_pktio_t pktio);
+
+/**
+ * Read pktio per queue statistics counters
+ *
+ * @param	pktio	Packet IO handle
+ * @param	queue	Queue index
+ * @param[out]	stats	Output buffer for counters
+ *
+ * @retval  0 on success
+ * @retval <0 on failure
+ *
+ * @see odp_pktio_stats_num_queues()
+ */
+int odp_pktio_queue_stats(odp_pktio_t pktio, int queue,
+			  odp_pktio_queue_stats_t *stats);
+
 /**
  * Intiailize pktio params
  *
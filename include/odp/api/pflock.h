@@ -0,0 +1,82 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+
+/**
+ * @file
+ *
+ * ODP phase-fair reader/writer lock
+ */
+
+#ifndef ODP_API_PFLOCK_H_
+#define ODP_API_PFLOCK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup odp_locks
+ * @details
+ * <b> Phase-fair reader/writer lock (odp_pflock_t) </b>
+ *
+ * A phase-fair reader/writer lock alternates between read and write phases.
+ * Readers arriving while a writer waits are held back until that writer
+ * is done, and a writer waits for at most one read phase. Neither readers
+ * nor writers can starve, unlike with odp_rwlock_t. Writers are served in
+ * FIFO order.
+ * @{
+ */
+
+/**
+ * @typedef odp_pflock_t
+ * ODP phase-fair reader/writer lock
+ */
+
+/**
+ * Initialize a phase-fair reader/writer lock.
+ *
+ * @param pflock Pointer to a phase-fair reader/writer lock
+ */
+void odp_pflock_init(odp_pflock_t *pflock);
+
+/**
+ * Acquire read permission on a phase-fair reader/writer lock.
+ *
+ * @param pflock Pointer to a phase-fair reader/writer lock
+ */
+void odp_pflock_read_lock(odp_pflock_t *pflock);
+
+/**
+ * Release read permission on a phase-fair reader/writer lock.
+ *
+ * @param pflock Pointer to a phase-fair reader/writer lock
+ */
+void odp_pflock_read_unlock(odp_pflock_t *pflock);
+
+/**
+ * Acquire write permission on a phase-fair reader/writer lock.
+ *
+ * @param pflock Pointer to a phase-fair reader/writer lock
+ */
+void odp_pflock_write_lock(odp_pflock_t *pflock);
+
+/**
+ * Release write permission on a phase-fair reader/writer lock.
+ *
+ * @param pflock Pointer to a phase-fair reader/writer lock
+ */
+void odp_pflock_write_unlock(odp_pflock_t *pflock);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
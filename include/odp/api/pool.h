@@ -87,6 +87,13 @@ typedef struct odp_pool_param_t {
 			/** Number of timeouts in the pool */
 			uint32_t num;
 		} tmo;
+		struct {
+			/** Number of packet vectors in the pool */
+			uint32_t num;
+
+			/** Maximum number of packets a vector holds */
+			uint32_t max_size;
+		} vec;
 	};
 } odp_pool_param_t;
 
@@ -96,6 +103,8 @@ typedef struct odp_pool_param_t {
 #define ODP_POOL_BUFFER       ODP_EVENT_BUFFER
 /** Timeout pool */
 #define ODP_POOL_TIMEOUT      ODP_EVENT_TIMEOUT
+/** Packet vector pool */
+#define ODP_POOL_VECTOR       ODP_EVENT_PACKET_VECTOR
 
 /**
  * Create a pool
@@ -0,0 +1,121 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+
+/**
+ * @file
+ *
+ * ODP RCU
+ */
+
+#ifndef ODP_API_RCU_H_
+#define ODP_API_RCU_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup odp_rcu ODP RCU
+ *  Quiescent state based read-copy-update
+ *
+ *  RCU lets threads read shared data structures without locks or atomic
+ *  operations while other threads update them. Readers mark no critical
+ *  sections. Instead, every thread periodically reports a quiescent state,
+ *  a point where it holds no references to RCU protected data. This is done
+ *  implicitly by odp_schedule() and odp_schedule_multi(), or explicitly with
+ *  odp_rcu_quiescent() by threads that do not use the scheduler.
+ *
+ *  An updater publishes a new version of the data (e.g. links a new node),
+ *  unpublishes the old one and then either waits a grace period with
+ *  odp_rcu_synchronize(), or hands the old version to odp_rcu_defer() to be
+ *  freed later. A grace period ends when every online thread has reported a
+ *  quiescent state after it started. Updaters still serialize with each
+ *  other, e.g. with a lock.
+ *
+ *  A thread is online, and thus waited for, from its first quiescent state
+ *  report or odp_rcu_thread_online() call until odp_rcu_thread_offline() or
+ *  odp_term_local(). Threads must go offline before blocking or sleeping
+ *  for long, as a thread that stops reporting quiescent states stalls all
+ *  grace periods.
+ *  @{
+ */
+
+/**
+ * RCU callback function
+ *
+ * @param arg     Argument given to odp_rcu_defer()
+ */
+typedef void (*odp_rcu_cb_t)(void *arg);
+
+/**
+ * Report a quiescent state
+ *
+ * The calling thread declares that it holds no references to RCU protected
+ * data. References obtained before the call must not be used after it.
+ * Brings the thread online if it was offline.
+ */
+void odp_rcu_quiescent(void);
+
+/**
+ * Bring the calling thread online
+ *
+ * Grace periods wait for online threads only. A thread must be online while
+ * it reads RCU protected data.
+ */
+void odp_rcu_thread_online(void);
+
+/**
+ * Take the calling thread offline
+ *
+ * Implies a quiescent state. The thread must not read RCU protected data
+ * until it is online again.
+ */
+void odp_rcu_thread_offline(void);
+
+/**
+ * Wait for a grace period
+ *
+ * Returns after every other online thread has reported a quiescent state,
+ * or gone offline, after the call started. Data unpublished before the
+ * call is no longer referenced by any reader when the call returns. The
+ * calling thread is in a quiescent state during the call.
+ */
+void odp_rcu_synchronize(void);
+
+/**
+ * Call a function after a grace period
+ *
+ * Queues the function to the calling thread. It is called by the same
+ * thread after a grace period that started after this call, during a later
+ * odp_rcu_defer(), odp_rcu_barrier() or odp_term_local() call. Waits for a
+ * grace period and runs the queue if it is full.
+ *
+ * @param func    Function to call, typically frees 'arg'
+ * @param arg     Argument to the function
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+int odp_rcu_defer(odp_rcu_cb_t func, void *arg);
+
+/**
+ * Run deferred calls
+ *
+ * Calls all functions queued by the calling thread with odp_rcu_defer(),
+ * waiting for their grace periods to end first. Functions queued by other
+ * threads are not called.
+ */
+void odp_rcu_barrier(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
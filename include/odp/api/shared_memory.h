@@ -50,6 +50,25 @@ extern "C" {
 #define ODP_SHM_SW_ONLY 0x1 /**< Application SW only, no HW access */
 #define ODP_SHM_PROC    0x2 /**< Share with external processes */
 
+/* Placement. Requests that cannot be met fall back to the closest
+ * alternative (smaller pages, no node binding), see odp_shm_info() and
+ * odp_shm_print_all() for the resulting placement. */
+#define ODP_SHM_PREFAULT   0x4   /**< Fault in all pages at reserve */
+#define ODP_SHM_PAGE_4K    0x10  /**< Use normal pages */
+#define ODP_SHM_PAGE_2M    0x20  /**< Use 2 MB huge pages */
+#define ODP_SHM_PAGE_1G    0x40  /**< Use 1 GB huge pages */
+#define ODP_SHM_NUMA_LOCAL 0x80  /**< Place on the NUMA node of the
+				      calling thread */
+#define ODP_SHM_NUMA_NODE  0x100 /**< Place on the NUMA node set with
+				      ODP_SHM_NODE() */
+
+/** Place on NUMA node 'node' (0 ... 255) */
+#define ODP_SHM_NODE(node) (ODP_SHM_NUMA_NODE | \
+			    ((uint32_t)(node) & 0xff) << 24)
+
+/** NUMA node selected with ODP_SHM_NODE() */
+#define ODP_SHM_NODE_GET(flags) (((flags) >> 24) & 0xff)
+
 /**
  * Shared memory block info
  */
@@ -59,6 +78,8 @@ typedef struct odp_shm_info_t {
 	uint64_t    size;      /**< Block size in bytes */
 	uint64_t    page_size; /**< Memory page size */
 	uint32_t    flags;     /**< ODP_SHM_* flags */
+	int         numa_node; /**< NUMA node of the first page,
+				    <0 if not known */
 } odp_shm_info_t;
 
 
@@ -128,6 +149,9 @@ int odp_shm_info(odp_shm_t shm, odp_shm_info_t *info);
 
 /**
  * Print all shared memory blocks
+ *
+ * Shows the page size and the NUMA node of each block, and marks those
+ * whose requested placement fell back.
  */
 void odp_shm_print_all(void);
 
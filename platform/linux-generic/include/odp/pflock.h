@@ -0,0 +1,28 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP phase-fair reader/writer lock
+ */
+
+#ifndef ODP_PLAT_PFLOCK_H_
+#define ODP_PLAT_PFLOCK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/plat/pflock_types.h>
+
+#include <odp/api/pflock.h>
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -17,10 +17,36 @@
 extern "C" {
 #endif
 
+#include <odp/std_types.h>
+
 /**
  * @internal platform specific data
  */
 typedef struct odp_platform_init_t {
+	/** Name of a multi-process instance, or NULL (default) for memory
+	 *  private to this process and the processes it forks. Processes of
+	 *  an instance share shm blocks, pools and queues, and exchange
+	 *  buffer, packet, pool and queue handles. Packet IO and crypto
+	 *  sessions are used only by the process that created them. */
+	const char *instance;
+
+	/** 0: create the instance (primary process). 1: attach to the
+	 *  instance of a running primary process, e.g. from a monitoring
+	 *  tool. Blocks reserved after attaching become visible after
+	 *  odp_shm_lookup() or odp_pool_lookup(). */
+	int secondary;
+
+	/** Scheduler idle policy. A thread that finds no events in
+	 *  odp_schedule() polls again 'sched_idle_spin' times, then pauses
+	 *  the CPU between the next 'sched_idle_pause' polls and then
+	 *  sleeps until an enqueue wakes it up, or at most
+	 *  'sched_idle_sleep_ns'. Scheduled packet input is polled, the
+	 *  sleep time bounds its wake latency. 0: default,
+	 *  -1: skip the phase (sched_idle_spin = -1 always busy polls). */
+	int sched_idle_spin;
+	int sched_idle_pause;		/**< Polls with CPU pause */
+	int64_t sched_idle_sleep_ns;	/**< Max sleep time. 0 (default) or
+					 *   -1: never sleep, pause forever */
 } odp_platform_init_t;
 
 #ifdef __cplusplus
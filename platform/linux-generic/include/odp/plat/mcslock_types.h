@@ -0,0 +1,42 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+
+/**
+ * @file
+ *
+ * ODP MCS lock
+ */
+
+#ifndef ODP_MCSLOCK_TYPES_H_
+#define ODP_MCSLOCK_TYPES_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/atomic.h>
+#include <odp/align.h>
+
+/** @internal */
+struct odp_mcslock_node_s {
+	struct odp_mcslock_node_s *next; /**< Next waiter in the queue */
+	odp_atomic_u32_t locked;	  /**< Waiter spins until cleared */
+} ODP_ALIGNED_CACHE;
+
+/** @internal */
+struct odp_mcslock_s {
+	struct odp_mcslock_node_s *tail; /**< Last waiter, NULL if free */
+};
+
+typedef struct odp_mcslock_node_s odp_mcslock_node_t;
+typedef struct odp_mcslock_s odp_mcslock_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -36,6 +36,10 @@ typedef ODP_HANDLE_T(odp_packet_seg_t);
 
 #define ODP_PACKET_SEG_INVALID _odp_cast_scalar(odp_packet_seg_t, 0xffffffff)
 
+typedef ODP_HANDLE_T(odp_packet_vector_t);
+
+#define ODP_PACKET_VECTOR_INVALID _odp_cast_scalar(odp_packet_vector_t, 0xffffffff)
+
 /** Get printable format of odp_packet_t */
 static inline uint64_t odp_packet_to_u64(odp_packet_t hdl)
 {
@@ -48,6 +52,12 @@ static inline uint64_t odp_packet_seg_to_u64(odp_packet_seg_t hdl)
 	return _odp_pri(hdl);
 }
 
+/** Get printable format of odp_packet_vector_t */
+static inline uint64_t odp_packet_vector_to_u64(odp_packet_vector_t hdl)
+{
+	return _odp_pri(hdl);
+}
+
 /**
  * @}
  */
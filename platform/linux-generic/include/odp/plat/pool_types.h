@@ -37,6 +37,7 @@ typedef enum odp_pool_type_t {
 	ODP_POOL_BUFFER  = ODP_EVENT_BUFFER,
 	ODP_POOL_PACKET  = ODP_EVENT_PACKET,
 	ODP_POOL_TIMEOUT = ODP_EVENT_TIMEOUT,
+	ODP_POOL_VECTOR  = ODP_EVENT_PACKET_VECTOR,
 } odp_pool_type_t;
 
 /** Get printable format of odp_pool_t */
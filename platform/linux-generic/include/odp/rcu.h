@@ -0,0 +1,26 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP RCU
+ */
+
+#ifndef ODP_PLAT_RCU_H_
+#define ODP_PLAT_RCU_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/api/rcu.h>
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
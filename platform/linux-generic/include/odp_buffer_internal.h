@@ -104,17 +104,12 @@ typedef union odp_buffer_bits_t {
 /* Common buffer header */
 struct odp_buffer_hdr_t {
 	struct odp_buffer_hdr_t *next;       /* next buf in a list--keep 1st */
-	union {                              /* Multi-use secondary link */
-		struct odp_buffer_hdr_t *prev;
-		struct odp_buffer_hdr_t *link;
-	};
 	odp_buffer_bits_t        handle;     /* handle */
 	union {
 		uint32_t all;
 		struct {
 			uint32_t zeroized:1; /* Zeroize buf data on free */
 			uint32_t hdrdata:1;  /* Data is in buffer hdr */
-			uint32_t sustain:1;  /* Sustain order */
 		};
 	} flags;
 	int16_t                  allocator;  /* allocating thread id */
@@ -134,11 +129,7 @@ struct odp_buffer_hdr_t {
 	uint32_t                 segsize;    /* segment size */
 	void                    *addr[ODP_BUFFER_MAX_SEG]; /* block addrs */
 	uint64_t                 order;      /* sequence for ordered queues */
-	queue_entry_t           *origin_qe;  /* ordered queue origin */
-	union {
-		queue_entry_t   *target_qe;  /* ordered queue target */
-		uint64_t         sync[ODP_CONFIG_MAX_ORDERED_LOCKS_PER_QUEUE];
-	};
+	queue_entry_t           *target_qe;  /* deferred ordered enq target */
 };
 
 /** @internal Compile time assert that the
@@ -75,6 +75,7 @@ struct cos_s {
 	odp_cos_flow_set_t flow_set;	/* Assigned Flow Set */
 	char name[ODP_COS_NAME_LEN];	/* name */
 	size_t headroom;		/* Headroom for this CoS */
+	odp_packet_vector_param_t vector;	/* Packet vectors of the queue */
 	odp_spinlock_t lock;		/* cos lock */
 };
 
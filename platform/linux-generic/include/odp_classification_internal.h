@@ -70,6 +70,14 @@ Same as packet classifier uses linux-generic internal pktio struct
 **/
 int _odp_packet_classifier(pktio_entry_t *entry, odp_packet_t pkt);
 
+/**
+@internal
+
+Enqueue a classified packet to the queue of its CoS, into a packet vector
+when the CoS has vectors enabled. Called from the receive path of the pktio.
+**/
+int cls_enq(pktio_entry_t *entry, cos_t *cos, odp_packet_t pkt);
+
 /**
 Packet IO classifier init
 
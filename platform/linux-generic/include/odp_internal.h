@@ -29,18 +29,30 @@ typedef struct {
 	uint64_t page_size;
 	int      cache_line_size;
 	int      cpu_count;
+	int      numa_nodes;
 	char     model_str[128];
 } odp_system_info_t;
 
+/* Max length of multi-process instance names */
+#define ODP_INSTANCE_NAME_LEN 32
+
 struct odp_global_data_s {
 	odp_log_func_t log_fn;
 	odp_abort_func_t abort_fn;
 	odp_system_info_t system_info;
+	char instance[ODP_INSTANCE_NAME_LEN]; /* "" if not multi-process */
+	int secondary;	/* attached to the instance of a primary process */
+	struct {
+		int spin;
+		int pause;
+		int64_t sleep_ns;
+	} sched_idle;	/* odp_platform_init_t scheduler idle policy */
 };
 
 extern struct odp_global_data_s odp_global_data;
 
 int odp_system_info_init(void);
+int odp_cpu_numa_node(int cpu);
 
 int odp_thread_init_global(void);
 int odp_thread_init_local(odp_thread_type_t type);
@@ -50,6 +62,9 @@ int odp_thread_term_global(void);
 int odp_shm_init_global(void);
 int odp_shm_term_global(void);
 int odp_shm_init_local(void);
+uint32_t _odp_shm_worker_flags(void);
+void _odp_shm_sync(void);
+void _odp_shm_instance_ready(void);
 
 int odp_pool_init_global(void);
 int odp_pool_init_local(void);
@@ -77,6 +92,16 @@ int odp_schedule_term_local(void);
 int odp_timer_init_global(void);
 int odp_timer_disarm_all(void);
 
+int odp_trace_init_global(void);
+int odp_trace_term_global(void);
+int odp_trace_init_local(void);
+int odp_trace_term_local(void);
+
+int odp_rcu_init_global(void);
+int odp_rcu_term_global(void);
+int odp_rcu_init_local(void);
+int odp_rcu_term_local(void);
+
 int odp_time_global_init(void);
 
 void _odp_flush_caches(void);
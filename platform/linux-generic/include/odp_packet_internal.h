@@ -39,6 +39,7 @@ typedef union {
 
 	struct {
 		uint32_t parsed_l2:1; /**< L2 parsed */
+		uint32_t parsed_l3:1; /**< L3 parsed */
 		uint32_t parsed_all:1;/**< Parsing complete */
 
 		uint32_t l2:1;        /**< known L2 protocol present */
@@ -150,6 +151,23 @@ typedef struct odp_packet_hdr_stride {
 	uint8_t pad[ODP_CACHE_LINE_SIZE_ROUNDUP(sizeof(odp_packet_hdr_t))];
 } odp_packet_hdr_stride;
 
+/**
+ * Internal Packet vector header
+ *
+ * The packet table is the buffer data.
+ */
+typedef struct {
+	/* common buffer header */
+	odp_buffer_hdr_t buf_hdr;
+
+	/* number of packets in the table */
+	uint32_t size;
+} odp_packet_vector_hdr_t;
+
+typedef struct odp_packet_vector_hdr_stride {
+	uint8_t pad[ODP_CACHE_LINE_SIZE_ROUNDUP(sizeof(odp_packet_vector_hdr_t))];
+} odp_packet_vector_hdr_stride;
+
 /**
  * Return the packet header
  */
@@ -158,6 +176,31 @@ static inline odp_packet_hdr_t *odp_packet_hdr(odp_packet_t pkt)
 	return (odp_packet_hdr_t *)odp_buf_to_hdr((odp_buffer_t)pkt);
 }
 
+/**
+ * Return the packet vector header
+ */
+static inline odp_packet_vector_hdr_t *odp_packet_vector_hdr(
+	odp_packet_vector_t pktv)
+{
+	return (odp_packet_vector_hdr_t *)odp_buf_to_hdr((odp_buffer_t)pktv);
+}
+
+/**
+ * Return the packet table of a vector
+ */
+static inline odp_packet_t *packet_vector_tbl(odp_packet_vector_hdr_t *hdr)
+{
+	return (odp_packet_t *)hdr->buf_hdr.addr[0];
+}
+
+/**
+ * Maximum number of packets of a vector
+ */
+static inline uint32_t packet_vector_max_size(odp_packet_vector_hdr_t *hdr)
+{
+	return odp_buf_to_pool(&hdr->buf_hdr)->s.params.vec.max_size;
+}
+
 static inline void copy_packet_parser_metadata(odp_packet_hdr_t *src_hdr,
 					       odp_packet_hdr_t *dst_hdr)
 {
@@ -224,6 +267,11 @@ static inline int packet_parse_l2_not_done(odp_packet_hdr_t *pkt_hdr)
 	return !pkt_hdr->input_flags.parsed_l2;
 }
 
+static inline int packet_parse_l3_not_done(odp_packet_hdr_t *pkt_hdr)
+{
+	return !pkt_hdr->input_flags.parsed_l3;
+}
+
 static inline int packet_parse_not_complete(odp_packet_hdr_t *pkt_hdr)
 {
 	return !pkt_hdr->input_flags.parsed_all;
@@ -241,9 +289,27 @@ odp_packet_t packet_alloc(odp_pool_t pool_hdl, uint32_t len, int parse);
 /* Fill in parser metadata for L2 */
 void packet_parse_l2(odp_packet_hdr_t *pkt_hdr);
 
+/* Parse packet up to and including L3 */
+int packet_parse_l3(odp_packet_hdr_t *pkt_hdr);
+
 /* Perform full packet parse */
 int packet_parse_full(odp_packet_hdr_t *pkt_hdr);
 
+/* Parse the layers of a packet not parsed yet, up to level */
+void packet_parse_layer(odp_packet_hdr_t *pkt_hdr,
+			odp_pktio_parse_level_t level);
+
+/* Parse a burst of packets up to level, prefetching packet data ahead.
+ * Ethernet/IP headers are classified PARSE_BURST packets at a time (SSE2
+ * when available), uncommon headers fall back to the generic parser. */
+void packet_parse_multi(const odp_packet_t pkt[], int num,
+			odp_pktio_parse_level_t level);
+
+/* Same as packet_parse_multi(), one packet at a time with the generic
+ * parser */
+void packet_parse_multi_scalar(const odp_packet_t pkt[], int num,
+			       odp_pktio_parse_level_t level);
+
 /* Reset parser metadata for a new parse */
 void packet_parse_reset(odp_packet_hdr_t *pkt_hdr);
 
@@ -257,6 +323,13 @@ int _odp_parse_common(odp_packet_hdr_t *pkt_hdr, const uint8_t *parseptr);
 
 int _odp_cls_parse(odp_packet_hdr_t *pkt_hdr, const uint8_t *parseptr);
 
+/* Check vector parameters of packet input, resolves the default size.
+ * Returns 0 if vectors are disabled or valid. */
+int packet_vector_param_check(odp_packet_vector_param_t *param);
+
+/* Free a packet vector and the packets it holds */
+void packet_vector_free_all(odp_packet_vector_t pktv);
+
 #ifdef __cplusplus
 }
 #endif
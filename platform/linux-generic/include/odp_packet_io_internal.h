@@ -22,6 +22,7 @@ extern "C" {
 #include <odp/ticketlock.h>
 #include <odp_packet_socket.h>
 #include <odp_packet_netmap.h>
+#include <odp_packet_xdp.h>
 #include <odp_packet_tap.h>
 #include <odp_classification_datamodel.h>
 #include <odp_align_internal.h>
@@ -29,10 +30,15 @@ extern "C" {
 
 #include <odp/config.h>
 #include <odp/hints.h>
+#include <odp/thread.h>
 #include <net/if.h>
 
 #define PKTIO_NAME_LEN 256
 
+/** Device queues with their own statistics counters, queues above this
+ *  share counters modulo the limit */
+#define PKTIO_STATS_MAX_QUEUES 16
+
 /** Determine if a socket read/write error should be reported. Transient errors
  *  that simply require the caller to retry are ignored, the _send/_recv APIs
  *  are non-blocking and it is the caller's responsibility to retry if the
@@ -42,9 +48,20 @@ extern "C" {
 /* Forward declaration */
 struct pktio_if_ops;
 
+/* Opaque per-thread ring of the loop device, defined in pktio/loop.c */
+struct pkt_loop_ring;
+
 typedef struct {
-	odp_queue_t loopq;		/**< loopback queue for "loop" device */
+	odp_shm_t shm;			/**< shm block holding the rings */
+	struct pkt_loop_ring *ring;	/**< one SPSC ring per sending thread */
+	odp_atomic_u32_t num_rings;	/**< rings used so far (max thr id+1) */
+	uint32_t rx_next;		/**< first ring to drain on next recv */
+	uint64_t latency_ns;		/**< injected TX to RX latency */
+	uint32_t drop_thresh;		/**< drop when rand < drop_thresh */
+	uint32_t seed;			/**< drop injection PRNG seed */
+	odp_bool_t parse;		/**< parse packets on receive */
 	odp_bool_t promisc;		/**< promiscuous mode state */
+	uint8_t mac[ETH_ALEN];		/**< MAC address of the device */
 } pkt_loop_t;
 
 #ifdef HAVE_PCAP
@@ -62,6 +79,22 @@ typedef struct {
 } pkt_pcap_t;
 #endif
 
+/** Maximum number of packet vectors filled during one receive */
+#define PKTIO_VEC_PEND_MAX 8
+
+/** Packet vector being filled by the classifier */
+typedef struct {
+	queue_entry_t *queue;		/**< destination queue */
+	odp_packet_vector_t vec;	/**< open vector */
+	uint32_t max_size;		/**< packets per vector */
+} pktio_vec_pend_t;
+
+/** Statistics counters updated by a single thread, summed when read */
+typedef struct {
+	odp_pktio_stats_t cnt ODP_ALIGNED_CACHE;
+	odp_pktio_queue_stats_t queue[PKTIO_STATS_MAX_QUEUES];
+} pktio_stats_slot_t;
+
 struct pktio_entry {
 	const struct pktio_if_ops *ops; /**< Implementation specific methods */
 	odp_ticketlock_t lock;		/**< entry ticketlock */
@@ -70,6 +103,16 @@ struct pktio_entry {
 	odp_pktio_t handle;		/**< pktio handle */
 	odp_queue_t inq_default;	/**< default input queue, if set */
 	odp_queue_t outq_default;	/**< default out queue */
+	int tx_mt_safe;			/**< send is thread safe, do not lock
+					     the entry around it */
+	int parse_burst;		/**< parse received bursts with the
+					     burst parser */
+	pktio_stats_slot_t *stats;	/**< counters, one slot per thread */
+	int stats_num_queues;		/**< queues counted by the backend,
+					     0 if it has a single queue */
+	odp_pktio_stats_t stats_base;	/**< counters at last reset */
+	odp_pktio_queue_stats_t stats_queue_base[PKTIO_STATS_MAX_QUEUES];
+					/**< queue counters at last reset */
 	union {
 		pkt_loop_t pkt_loop;            /**< Using loopback for IO */
 		pkt_sock_t pkt_sock;		/**< using socket API for IO */
@@ -78,6 +121,9 @@ struct pktio_entry {
 		pkt_netmap_t pkt_nm;		/**< using netmap API for IO */
 #ifdef HAVE_PCAP
 		pkt_pcap_t pkt_pcap;		/**< Using pcap for IO */
+#endif
+#ifdef HAVE_AF_XDP
+		pkt_xdp_t pkt_xdp;		/**< using AF_XDP for IO */
 #endif
 		pkt_tap_t pkt_tap;		/**< using TAP for IO */
 	};
@@ -90,6 +136,10 @@ struct pktio_entry {
 					   pktio_open() */
 	odp_pktio_t id;
 	odp_pktio_param_t param;
+	pktio_vec_pend_t vec_pend[PKTIO_VEC_PEND_MAX];
+					/**< vectors of classified packets,
+					     enqueued at the end of a receive */
+	int vec_pend_num;		/**< number of open vectors */
 };
 
 typedef union {
@@ -118,11 +168,19 @@ typedef struct pktio_if_ops {
 	int (*promisc_mode_set)(pktio_entry_t *pktio_entry,  int enable);
 	int (*promisc_mode_get)(pktio_entry_t *pktio_entry);
 	int (*mac_get)(pktio_entry_t *pktio_entry, void *mac_addr);
+	int (*stats)(pktio_entry_t *pktio_entry, odp_pktio_stats_t *stats);
 } pktio_if_ops_t;
 
 int _odp_packet_cls_enq(pktio_entry_t *pktio_entry, const uint8_t *base,
 			uint16_t buf_len, odp_packet_t *pkt_ret);
 
+/* Add a classified packet to the open vector of its queue. Called from
+ * the receive path with the entry locked, vectors are enqueued when full
+ * and when the receive completes. Returns <0 if the packet was not taken. */
+int _odp_pktio_vec_add(pktio_entry_t *entry, queue_entry_t *queue,
+		       const odp_packet_vector_param_t *param,
+		       odp_packet_t pkt);
+
 extern void *pktio_entry_ptr[];
 
 static inline int pktio_to_id(odp_pktio_t pktio)
@@ -154,12 +212,29 @@ static inline void pktio_cls_enabled_set(pktio_entry_t *entry, int ena)
 	entry->s.cls_enabled = ena;
 }
 
+/** Counters of the calling thread */
+static inline odp_pktio_stats_t *pktio_stats(pktio_entry_t *entry)
+{
+	return &entry->s.stats[odp_thread_id()].cnt;
+}
+
+/** Queue counters of the calling thread */
+static inline odp_pktio_queue_stats_t *pktio_queue_stats(pktio_entry_t *entry,
+							 unsigned queue)
+{
+	return &entry->s.stats[odp_thread_id()].queue[queue %
+						     PKTIO_STATS_MAX_QUEUES];
+}
+
 int pktin_poll(pktio_entry_t *entry);
 
 extern const pktio_if_ops_t netmap_pktio_ops;
 extern const pktio_if_ops_t sock_mmsg_pktio_ops;
 extern const pktio_if_ops_t sock_mmap_pktio_ops;
 extern const pktio_if_ops_t loopback_pktio_ops;
+#ifdef HAVE_AF_XDP
+extern const pktio_if_ops_t xdp_pktio_ops;
+#endif
 #ifdef HAVE_PCAP
 extern const pktio_if_ops_t pcap_pktio_ops;
 #endif
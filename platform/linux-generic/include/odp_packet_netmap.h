@@ -8,18 +8,34 @@
 #define ODP_PACKET_NETMAP_H
 
 #include <odp/pool.h>
+#include <odp/ticketlock.h>
 
 #include <linux/if_ether.h>
+#include <net/if.h>
+
+/** Netmap rx/tx ring pair, bound through its own descriptor */
+typedef struct {
+	struct nm_desc *desc;		/**< descriptor bound to the rings */
+	odp_ticketlock_t tx_lock;	/**< serializes senders on the ring */
+} netmap_ring_t;
 
 /** Packet socket using netmap mmaped rings for both Rx and Tx */
 typedef struct {
 	odp_pool_t pool;		/**< pool to alloc packets from */
 	size_t max_frame_len;		/**< buf_size - sizeof(pkt_hdr) */
-	struct nm_desc *rx_desc;	/**< netmap meta-data for the device */
-	struct nm_desc *tx_desc;	/**< netmap meta-data for the device */
+	struct nm_desc *desc;		/**< netmap meta-data for the port */
+	netmap_ring_t *ring;		/**< one descriptor per ring pair */
+	unsigned num_rings;		/**< number of ring descriptors */
+	unsigned num_rx_rings;		/**< number of rx rings in use */
+	unsigned num_tx_rings;		/**< number of tx rings in use */
+	unsigned rx_next;		/**< next rx ring to poll */
+	int is_virtual;			/**< VALE or pipe port, no netdev */
+	int promisc;			/**< promiscuous mode of virtual port */
 	uint32_t if_flags;		/**< interface flags */
 	int sockfd;			/**< control socket */
 	unsigned char if_mac[ETH_ALEN]; /**< eth mac address */
+	char if_name[IFNAMSIZ];		/**< kernel interface name */
+	char nm_name[IFNAMSIZ + 16];	/**< netmap port name */
 } pkt_netmap_t;
 
 #endif
@@ -46,6 +46,7 @@ typedef struct {
 	unsigned char if_mac[ETH_ALEN];	/**< IF eth mac addr */
 	uint8_t *cache_ptr[ODP_PACKET_SOCKET_MAX_BURST_RX];
 	odp_shm_t shm;
+	uint64_t drops; /**< kernel drops read so far */
 } pkt_sock_t;
 
 /** packet mmap ring */
@@ -82,6 +83,7 @@ typedef struct {
 	unsigned char if_mac[ETH_ALEN];
 	struct sockaddr_ll ll;
 	int fanout;
+	uint64_t drops; /**< kernel drops read so far */
 } pkt_sock_mmap_t;
 
 static inline void
@@ -116,4 +118,9 @@ int promisc_mode_set_fd(int fd, const char *name, int enable);
  */
 int promisc_mode_get_fd(int fd, const char *name);
 
+/**
+ * Add packets dropped by the kernel since the last call to drops
+ */
+int drops_get_fd(int fd, uint64_t *drops);
+
 #endif
@@ -0,0 +1,46 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#ifndef ODP_PACKET_XDP_H
+#define ODP_PACKET_XDP_H
+
+#include <odp/pool.h>
+#include <odp/shared_memory.h>
+
+#include <linux/if_ether.h>
+#include <net/if.h>
+
+/** Maximum number of device queues bound to XSK sockets */
+#define XDP_MAX_QUEUES 16
+
+struct xdp_queue;
+
+/** Packet IO using AF_XDP sockets, one socket per device rx queue */
+typedef struct {
+	odp_pool_t pool;		/**< pool to alloc packets from */
+	int ifindex;			/**< interface index */
+	int sockfd;			/**< control socket */
+	int prog_fd;			/**< XDP redirect program */
+	int map_fd;			/**< XSKMAP, queue id to socket */
+	int link_fd;			/**< attachment of the program */
+	unsigned num_queues;		/**< number of XSK sockets */
+	unsigned rx_next;		/**< next queue to poll */
+	int pool_umem;			/**< UMEM registered over the pool */
+	int zero_copy;			/**< sockets bound in zero-copy mode */
+	int busy_poll;			/**< busy poll time in usec, 0 if off */
+	uint32_t chunk_size;		/**< UMEM chunk size */
+	uint32_t frame_len_max;		/**< max frame length, limited by UMEM
+					     chunks and device MTU */
+	uint64_t page_size;		/**< UMEM chunks must not cross pages
+					     of this size, 0 if they may */
+	odp_shm_t shm;			/**< queue state and tables */
+	odp_shm_t umem_shm;		/**< private UMEM of copy mode */
+	struct xdp_queue *queue;	/**< per queue socket state */
+	unsigned char if_mac[ETH_ALEN]; /**< eth mac address */
+	char if_name[IFNAMSIZ];		/**< kernel interface name */
+} pkt_xdp_t;
+
+#endif
@@ -13,6 +13,7 @@
 extern "C" {
 #endif
 
+#include <odp_atomic_internal.h>
 
 /**
  * Spin loop for ODP internal use
@@ -50,6 +51,36 @@ static inline void odp_spin(void)
 #endif
 }
 
+/**
+ * Wait until a 32-bit atomic variable equals a value, with load-acquire
+ *
+ * On ARMv8 the waiter sleeps in WFE until the cache line it monitors is
+ * written, instead of polling the line.
+ */
+static inline void odp_spin_until_eq_u32(odp_atomic_u32_t *atom,
+					 uint32_t val)
+{
+#if defined __aarch64__
+	uint32_t tmp;
+
+	__asm__ __volatile__ ("ldaxr %w0, [%1]"
+			      : "=&r" (tmp) : "r" (&atom->v) : "memory");
+	if (tmp == val)
+		return;
+
+	__asm__ __volatile__ ("sevl" : : : "memory");
+	do {
+		__asm__ __volatile__ ("wfe" : : : "memory");
+		__asm__ __volatile__ ("ldaxr %w0, [%1]"
+				      : "=&r" (tmp) : "r" (&atom->v)
+				      : "memory");
+	} while (tmp != val);
+#else
+	while (_odp_atomic_u32_load_mm(atom, _ODP_MEMMODEL_ACQ) != val)
+		odp_spin();
+#endif
+}
+
 
 #ifdef __cplusplus
 }
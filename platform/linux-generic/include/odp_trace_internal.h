@@ -0,0 +1,222 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP hot path tracing - implementation internal
+ *
+ * Compiled in with --enable-trace (ODP_TRACE=1), otherwise all trace macros
+ * expand to nothing. Each thread records the cycles spent in instrumented
+ * functions into its own ring of recent events and into per trace point
+ * log-linear (HDR style) latency histograms. Both live in a shm block
+ * created with ODP_SHM_PROC, named "odp_trace_<pid>", which external tools
+ * (odp_trace_dump) map read-only while the application runs.
+ *
+ * The ODP_TRACE_MASK environment variable selects the recorded trace points
+ * as a bit mask of trace_point_t values (default: all).
+ */
+
+#ifndef ODP_TRACE_INTERNAL_H_
+#define ODP_TRACE_INTERNAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/std_types.h>
+#include <odp/align.h>
+#include <odp/hints.h>
+#include <odp/cpu.h>
+#include <odp/thread.h>
+
+/** Trace points */
+typedef enum {
+	TRACE_SCHEDULE = 0,	/**< schedule() round returning events,
+				     arg: events */
+	TRACE_QUEUE_ENQ,	/**< queue_enq() and queue_enq_multi() */
+	TRACE_QUEUE_DEQ,	/**< queue_deq() and queue_deq_multi()
+				     returning events, arg: events */
+	TRACE_BUFFER_ALLOC,	/**< buffer_alloc() */
+	TRACE_BUFFER_FREE,	/**< odp_buffer_free() */
+	TRACE_PKTIN_POLL,	/**< pktin_poll() receiving packets,
+				     arg: packets */
+	TRACE_PKTIO_RECV,	/**< odp_pktio_recv() returning packets,
+				     arg: packets */
+	TRACE_PKTIO_SEND,	/**< odp_pktio_send() and pktout queues,
+				     arg: packets sent */
+	TRACE_SCHEDULE_IDLE,	/**< idle scheduler thread sleeping,
+				     arg: max sleep in us */
+	TRACE_NUM_POINTS
+} trace_point_t;
+
+/** Snapshot layout identification */
+#define TRACE_MAGIC		0x4f445054	/* "ODPT" */
+#define TRACE_VERSION		1
+
+/** Events kept per thread, power of two */
+#define TRACE_RING_SIZE		1024
+
+/** Histogram resolution: 2^TRACE_HIST_SUB_BITS buckets per power of two,
+ *  i.e. values are recorded with 12.5% precision */
+#define TRACE_HIST_SUB_BITS	3
+#define TRACE_HIST_SUB		(1 << TRACE_HIST_SUB_BITS)
+
+/** Largest recorded power of two, longer durations land in the last
+ *  bucket */
+#define TRACE_HIST_EXP_MAX	39
+
+#define TRACE_HIST_BUCKETS \
+	((TRACE_HIST_EXP_MAX - TRACE_HIST_SUB_BITS + 2) * TRACE_HIST_SUB)
+
+/** Max length of trace point names in the snapshot */
+#define TRACE_NAME_LEN		16
+
+/** One recorded event */
+typedef struct {
+	uint64_t start;		/**< start time in CPU cycles */
+	uint32_t cycles;	/**< duration, saturated to 32 bits */
+	uint16_t point;		/**< trace_point_t */
+	uint16_t arg;		/**< trace point specific argument */
+} trace_event_t;
+
+/** Latency histogram of one trace point */
+typedef struct {
+	uint64_t count;				/**< recorded durations */
+	uint64_t sum;				/**< sum of durations */
+	uint64_t min;				/**< shortest duration */
+	uint64_t max;				/**< longest duration */
+	uint64_t bucket[TRACE_HIST_BUCKETS];	/**< log-linear buckets */
+} trace_hist_t;
+
+/** Trace state of one thread, written by that thread only */
+typedef struct {
+	/** Events written so far, the newest is at (head - 1) modulo ring
+	 *  size. Stored after the event, so readers see complete events. */
+	uint64_t head ODP_ALIGNED_CACHE;
+	trace_event_t ring[TRACE_RING_SIZE];	/**< recent events */
+	trace_hist_t hist[TRACE_NUM_POINTS];	/**< latency histograms */
+} trace_thread_t;
+
+/** Snapshot shm block */
+typedef struct {
+	uint32_t magic;			/**< TRACE_MAGIC */
+	uint32_t version;		/**< TRACE_VERSION */
+	uint32_t num_threads;		/**< entries in thread[] */
+	uint32_t num_points;		/**< TRACE_NUM_POINTS */
+	uint32_t ring_size;		/**< TRACE_RING_SIZE */
+	uint32_t hist_sub_bits;		/**< TRACE_HIST_SUB_BITS */
+	uint32_t hist_buckets;		/**< TRACE_HIST_BUCKETS */
+	uint32_t mask;			/**< recorded trace points */
+	uint64_t cpu_hz;		/**< cycle counter frequency */
+	char point_name[TRACE_NUM_POINTS][TRACE_NAME_LEN];
+					/**< names of trace points */
+	trace_thread_t thread[ODP_THREAD_COUNT_MAX];
+					/**< indexed by thread id */
+} trace_shm_t;
+
+/** Histogram bucket of a duration */
+static inline unsigned trace_hist_bucket(uint64_t cycles)
+{
+	unsigned exp;
+
+	if (cycles < TRACE_HIST_SUB)
+		return cycles;
+
+	exp = 63 - __builtin_clzll(cycles);
+	if (exp > TRACE_HIST_EXP_MAX)
+		return TRACE_HIST_BUCKETS - 1;
+
+	return (exp - TRACE_HIST_SUB_BITS + 1) * TRACE_HIST_SUB +
+	       ((cycles >> (exp - TRACE_HIST_SUB_BITS)) & (TRACE_HIST_SUB - 1));
+}
+
+/** Smallest duration recorded in a histogram bucket */
+static inline uint64_t trace_hist_bucket_min(unsigned bucket)
+{
+	unsigned exp;
+
+	if (bucket < TRACE_HIST_SUB)
+		return bucket;
+
+	exp = bucket / TRACE_HIST_SUB + TRACE_HIST_SUB_BITS - 1;
+	return (uint64_t)(TRACE_HIST_SUB + bucket % TRACE_HIST_SUB) <<
+	       (exp - TRACE_HIST_SUB_BITS);
+}
+
+#if ODP_TRACE
+
+extern __thread trace_thread_t *trace_local;
+extern uint32_t trace_mask;
+
+static inline void trace_record(trace_point_t point, uint64_t start,
+				unsigned arg)
+{
+	trace_thread_t *thr = trace_local;
+	trace_hist_t *hist;
+	trace_event_t *ev;
+	uint64_t cycles;
+
+	if (odp_unlikely(thr == NULL || !(trace_mask & (1 << point))))
+		return;
+
+	cycles = odp_cpu_cycles_diff(odp_cpu_cycles(), start);
+
+	ev = &thr->ring[thr->head & (TRACE_RING_SIZE - 1)];
+	ev->start = start;
+	ev->cycles = cycles > UINT32_MAX ? UINT32_MAX : cycles;
+	ev->point = point;
+	ev->arg = arg > UINT16_MAX ? UINT16_MAX : arg;
+	__atomic_store_n(&thr->head, thr->head + 1, __ATOMIC_RELEASE);
+
+	hist = &thr->hist[point];
+	hist->bucket[trace_hist_bucket(cycles)]++;
+	hist->count++;
+	hist->sum += cycles;
+	if (cycles < hist->min)
+		hist->min = cycles;
+	if (cycles > hist->max)
+		hist->max = cycles;
+}
+
+/** Scope of TRACE_SCOPE() */
+typedef struct {
+	trace_point_t point;
+	uint64_t start;
+} trace_scope_t;
+
+static inline void trace_scope_end(trace_scope_t *scope)
+{
+	trace_record(scope->point, scope->start, 0);
+}
+
+/** Start timing a code section, ended by TRACE_END() in the same scope */
+#define TRACE_BEGIN(tp) \
+	uint64_t trace_start_##tp = odp_cpu_cycles()
+
+/** Record the code section started by TRACE_BEGIN() */
+#define TRACE_END(tp, arg) \
+	trace_record(TRACE_##tp, trace_start_##tp, (arg))
+
+/** Record the time until the enclosing scope is left, on any return path */
+#define TRACE_SCOPE(tp) \
+	trace_scope_t trace_scope_##tp \
+	__attribute__((cleanup(trace_scope_end))) = \
+		{ TRACE_##tp, odp_cpu_cycles() }
+
+#else
+
+#define TRACE_BEGIN(tp)
+#define TRACE_END(tp, arg) do {} while (0)
+#define TRACE_SCOPE(tp)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,2 +1,3 @@
 AM_CONDITIONAL([netmap_support], [test x$netmap_support = xyes ])
 AM_CONDITIONAL([HAVE_PCAP], [test x$have_pcap = xyes])
+AM_CONDITIONAL([HAVE_AF_XDP], [test x$have_af_xdp = xyes])
@@ -20,7 +20,11 @@ m4_include([platform/linux-generic/m4/odp_pthread.m4])
 m4_include([platform/linux-generic/m4/odp_openssl.m4])
 m4_include([platform/linux-generic/m4/odp_netmap.m4])
 m4_include([platform/linux-generic/m4/odp_pcap.m4])
+m4_include([platform/linux-generic/m4/odp_xdp.m4])
 
 AC_CONFIG_FILES([platform/linux-generic/Makefile
 		 platform/linux-generic/test/Makefile
-		 platform/linux-generic/test/pktio/Makefile])
+		 platform/linux-generic/test/pktio/Makefile
+		 platform/linux-generic/test/trace/Makefile
+		 platform/linux-generic/test/mp/Makefile
+		 platform/linux-generic/test/sched_idle/Makefile])
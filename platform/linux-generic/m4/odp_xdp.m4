@@ -0,0 +1,14 @@
+#########################################################################
+# Check for AF_XDP availability
+#########################################################################
+have_af_xdp=no
+AC_CHECK_HEADER(linux/if_xdp.h,
+    [AC_CHECK_DECL(XDP_UMEM_UNALIGNED_CHUNK_FLAG,
+        [AC_CHECK_DECL(BPF_LINK_CREATE, have_af_xdp=yes, [],
+                       [#include <linux/bpf.h>])],
+    [], [#include <linux/if_xdp.h>])],
+[])
+
+if test $have_af_xdp == yes; then
+    AM_CFLAGS="$AM_CFLAGS -DHAVE_AF_XDP"
+fi
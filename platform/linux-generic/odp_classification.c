@@ -52,6 +52,14 @@ int odp_classification_init_global(void)
 	odp_shm_t pmr_set_shm;
 	int i;
 
+	if (odp_global_data.secondary) {
+		cos_tbl = odp_shm_addr(odp_shm_lookup("shm_odp_cos_tbl"));
+		pmr_tbl = odp_shm_addr(odp_shm_lookup("shm_odp_pmr_tbl"));
+		pmr_set_tbl = odp_shm_addr(odp_shm_lookup(
+					   "shm_odp_pmr_set_tbl"));
+		return cos_tbl && pmr_tbl && pmr_set_tbl ? 0 : -1;
+	}
+
 	cos_shm = odp_shm_reserve("shm_odp_cos_tbl",
 			sizeof(cos_tbl_t),
 			sizeof(cos_t), 0);
@@ -159,6 +167,9 @@ void odp_cls_cos_param_init(odp_cls_cos_param_t *param)
 	param->queue = ODP_QUEUE_INVALID;
 	param->pool = ODP_POOL_INVALID;
 	param->drop_policy = ODP_COS_DROP_NEVER;
+	param->vector.enable = 0;
+	param->vector.pool = ODP_POOL_INVALID;
+	param->vector.max_size = 0;
 }
 
 odp_cos_t odp_cls_cos_create(const char *name, odp_cls_cos_param_t *param)
@@ -167,6 +178,10 @@ odp_cos_t odp_cls_cos_create(const char *name, odp_cls_cos_param_t *param)
 	queue_entry_t *queue;
 	pool_entry_t *pool;
 	odp_cls_drop_t drop_policy;
+	odp_packet_vector_param_t vector = param->vector;
+
+	if (packet_vector_param_check(&vector))
+		return ODP_COS_INVALID;
 
 	/* Packets are dropped if Queue or Pool is invalid*/
 	if (param->queue == ODP_QUEUE_INVALID)
@@ -195,6 +210,7 @@ odp_cos_t odp_cls_cos_create(const char *name, odp_cls_cos_param_t *param)
 			cos_tbl->cos_entry[i].s.headroom = 0;
 			cos_tbl->cos_entry[i].s.valid = 1;
 			cos_tbl->cos_entry[i].s.drop_policy = drop_policy;
+			cos_tbl->cos_entry[i].s.vector = vector;
 			UNLOCK(&cos_tbl->cos_entry[i].s.lock);
 			return _odp_cast_scalar(odp_cos_t, i);
 		}
@@ -890,7 +906,6 @@ int pktio_classifier_init(pktio_entry_t *entry)
 
 int _odp_packet_classifier(pktio_entry_t *entry, odp_packet_t pkt)
 {
-	queue_entry_t *queue;
 	cos_t *cos;
 	odp_packet_hdr_t *pkt_hdr;
 	odp_packet_t new_pkt;
@@ -927,8 +942,16 @@ int _odp_packet_classifier(pktio_entry_t *entry, odp_packet_t pkt)
 	}
 
 	/* Enqueuing the Packet based on the CoS */
-	queue = cos->s.queue;
-	return queue_enq(queue, odp_buf_to_hdr((odp_buffer_t)new_pkt), 0);
+	return cls_enq(entry, cos, new_pkt);
+}
+
+int cls_enq(pktio_entry_t *entry, cos_t *cos, odp_packet_t pkt)
+{
+	if (cos->s.vector.enable &&
+	    _odp_pktio_vec_add(entry, cos->s.queue, &cos->s.vector, pkt) == 0)
+		return 0;
+
+	return queue_enq(cos->s.queue, odp_buf_to_hdr((odp_buffer_t)pkt), 0);
 }
 
 int packet_classifier(odp_pktio_t pktio, odp_packet_t pkt)
@@ -799,6 +799,11 @@ odp_crypto_init_global(void)
 	odp_shm_t shm;
 	int idx;
 
+	if (odp_global_data.secondary) {
+		global = odp_shm_addr(odp_shm_lookup("crypto_pool"));
+		return global ? 0 : -1;
+	}
+
 	/* Calculate the memory size we need */
 	mem_size  = sizeof(*global);
 	mem_size += (MAX_SESSIONS * sizeof(odp_crypto_generic_session_t));
@@ -9,13 +9,19 @@
 #include <odp/debug.h>
 #include <odp_debug_internal.h>
 
+#include <string.h>
+
 struct odp_global_data_s odp_global_data;
 
 int odp_init_global(const odp_init_t *params,
-		    const odp_platform_init_t *platform_params ODP_UNUSED)
+		    const odp_platform_init_t *platform_params)
 {
 	odp_global_data.log_fn = odp_override_log;
 	odp_global_data.abort_fn = odp_override_abort;
+	odp_global_data.instance[0] = 0;
+	odp_global_data.secondary = 0;
+	memset(&odp_global_data.sched_idle, 0,
+	       sizeof(odp_global_data.sched_idle));
 
 	if (params != NULL) {
 		if (params->log_fn != NULL)
@@ -24,6 +30,22 @@ int odp_init_global(const odp_init_t *params,
 			odp_global_data.abort_fn = params->abort_fn;
 	}
 
+	if (platform_params != NULL && platform_params->instance != NULL) {
+		strncpy(odp_global_data.instance, platform_params->instance,
+			ODP_INSTANCE_NAME_LEN - 1);
+		odp_global_data.instance[ODP_INSTANCE_NAME_LEN - 1] = 0;
+		odp_global_data.secondary = platform_params->secondary;
+	}
+
+	if (platform_params != NULL) {
+		odp_global_data.sched_idle.spin  =
+			platform_params->sched_idle_spin;
+		odp_global_data.sched_idle.pause =
+			platform_params->sched_idle_pause;
+		odp_global_data.sched_idle.sleep_ns =
+			platform_params->sched_idle_sleep_ns;
+	}
+
 	if (odp_time_global_init()) {
 		ODP_ERR("ODP time init failed.\n");
 		return -1;
@@ -44,6 +66,16 @@ int odp_init_global(const odp_init_t *params,
 		return -1;
 	}
 
+	if (odp_trace_init_global()) {
+		ODP_ERR("ODP trace init failed.\n");
+		return -1;
+	}
+
+	if (odp_rcu_init_global()) {
+		ODP_ERR("ODP rcu init failed.\n");
+		return -1;
+	}
+
 	if (odp_pool_init_global()) {
 		ODP_ERR("ODP pool init failed.\n");
 		return -1;
@@ -78,13 +110,36 @@ int odp_init_global(const odp_init_t *params,
 		return -1;
 	}
 
+	_odp_shm_instance_ready();
+
 	return 0;
 }
 
+/* Shared state of an instance stays with its primary process */
+static int odp_term_secondary(void)
+{
+	int rc = 0;
+
+	if (odp_trace_term_global()) {
+		ODP_ERR("ODP trace term failed.\n");
+		rc = -1;
+	}
+
+	if (odp_shm_term_global()) {
+		ODP_ERR("ODP shm term failed.\n");
+		rc = -1;
+	}
+
+	return rc;
+}
+
 int odp_term_global(void)
 {
 	int rc = 0;
 
+	if (odp_global_data.secondary)
+		return odp_term_secondary();
+
 	if (odp_classification_term_global()) {
 		ODP_ERR("ODP classificatio term failed.\n");
 		rc = -1;
@@ -115,6 +170,16 @@ int odp_term_global(void)
 		rc = -1;
 	}
 
+	if (odp_rcu_term_global()) {
+		ODP_ERR("ODP rcu term failed.\n");
+		rc = -1;
+	}
+
+	if (odp_trace_term_global()) {
+		ODP_ERR("ODP trace term failed.\n");
+		rc = -1;
+	}
+
 	if (odp_thread_term_global()) {
 		ODP_ERR("ODP thread term failed.\n");
 		rc = -1;
@@ -140,6 +205,16 @@ int odp_init_local(odp_thread_type_t thr_type)
 		return -1;
 	}
 
+	if (odp_trace_init_local()) {
+		ODP_ERR("ODP trace local init failed.\n");
+		return -1;
+	}
+
+	if (odp_rcu_init_local()) {
+		ODP_ERR("ODP rcu local init failed.\n");
+		return -1;
+	}
+
 	if (odp_pktio_init_local()) {
 		ODP_ERR("ODP packet io local init failed.\n");
 		return -1;
@@ -163,6 +238,11 @@ int odp_term_local(void)
 	int rc = 0;
 	int rc_thd = 0;
 
+	if (odp_rcu_term_local()) {
+		ODP_ERR("ODP rcu local term failed.\n");
+		rc = -1;
+	}
+
 	if (odp_schedule_term_local()) {
 		ODP_ERR("ODP schedule local term failed.\n");
 		rc = -1;
@@ -173,6 +253,11 @@ int odp_term_local(void)
 		rc = -1;
 	}
 
+	if (odp_trace_term_local()) {
+		ODP_ERR("ODP trace local term failed.\n");
+		rc = -1;
+	}
+
 	rc_thd = odp_thread_term_local();
 	if (rc_thd < 0) {
 		ODP_ERR("ODP thread local term failed.\n");
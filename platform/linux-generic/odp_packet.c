@@ -19,6 +19,10 @@
 #include <string.h>
 #include <stdio.h>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 /*
  *
  * Alloc and free
@@ -29,6 +33,7 @@
 static inline void packet_parse_disable(odp_packet_hdr_t *pkt_hdr)
 {
 	pkt_hdr->input_flags.parsed_l2  = 1;
+	pkt_hdr->input_flags.parsed_l3  = 1;
 	pkt_hdr->input_flags.parsed_all = 1;
 }
 
@@ -376,16 +381,16 @@ int odp_packet_l2_offset_set(odp_packet_t pkt, uint32_t offset)
 void *odp_packet_l3_ptr(odp_packet_t pkt, uint32_t *len)
 {
 	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
-	if (packet_parse_not_complete(pkt_hdr))
-		packet_parse_full(pkt_hdr);
+	if (packet_parse_l3_not_done(pkt_hdr))
+		packet_parse_l3(pkt_hdr);
 	return packet_map(pkt_hdr, pkt_hdr->l3_offset, len);
 }
 
 uint32_t odp_packet_l3_offset(odp_packet_t pkt)
 {
 	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
-	if (packet_parse_not_complete(pkt_hdr))
-		packet_parse_full(pkt_hdr);
+	if (packet_parse_l3_not_done(pkt_hdr))
+		packet_parse_l3(pkt_hdr);
 	return pkt_hdr->l3_offset;
 }
 
@@ -930,12 +935,17 @@ void packet_parse_l2(odp_packet_hdr_t *pkt_hdr)
 	pkt_hdr->input_flags.parsed_l2 = 1;
 }
 
-int _odp_parse_common(odp_packet_hdr_t *pkt_hdr, const uint8_t *ptr)
+/**
+ * Parse L2 headers (VLAN, SNAP) and L3 header of a packet
+ *
+ * L4 offset and protocol are recorded for a later parse_l4().
+ */
+static void parse_l3(odp_packet_hdr_t *pkt_hdr, const uint8_t *ptr)
 {
 	const odph_ethhdr_t *eth;
 	const odph_vlanhdr_t *vlan;
 	uint16_t ethtype;
-	uint32_t offset, seglen;
+	uint32_t offset;
 	uint8_t ip_proto = 0;
 	const uint8_t *parseptr;
 
@@ -943,18 +953,9 @@ int _odp_parse_common(odp_packet_hdr_t *pkt_hdr, const uint8_t *ptr)
 	if (packet_parse_l2_not_done(pkt_hdr))
 		packet_parse_l2(pkt_hdr);
 
-	if (ptr == NULL) {
-		eth = (odph_ethhdr_t *)packet_map(pkt_hdr, 0, &seglen);
-		parseptr = (const uint8_t *)&eth->type;
-		ethtype = odp_be_to_cpu_16(*((const uint16_t *)
-					   (const void *)parseptr));
-	} else {
-		eth = (const odph_ethhdr_t *)ptr;
-		parseptr = (const uint8_t *)&eth->type;
-		ethtype = odp_be_to_cpu_16(*((const uint16_t *)
-					   (const void *)parseptr));
-	}
-
+	eth = (const odph_ethhdr_t *)ptr;
+	parseptr = (const uint8_t *)&eth->type;
+	ethtype = odp_be_to_cpu_16(*((const uint16_t *)(const void *)parseptr));
 
 	/* Parse the VLAN header(s), if present */
 	if (ethtype == ODPH_ETHTYPE_VLAN_OUTER) {
@@ -986,7 +987,10 @@ int _odp_parse_common(odp_packet_hdr_t *pkt_hdr, const uint8_t *ptr)
 		pkt_hdr->input_flags.snap = 1;
 		if (ethtype > pkt_hdr->frame_len - offset) {
 			pkt_hdr->error_flags.snap_len = 1;
-			goto parse_exit;
+			/* Nothing more to parse */
+			pkt_hdr->input_flags.parsed_l3 = 1;
+			pkt_hdr->input_flags.parsed_all = 1;
+			return;
 		}
 		offset   += 8;
 		parseptr += 8;
@@ -1025,11 +1029,26 @@ int _odp_parse_common(odp_packet_hdr_t *pkt_hdr, const uint8_t *ptr)
 		ip_proto = 255;  /* Reserved invalid by IANA */
 	}
 
-	/* Set l4_offset+flag only for known ip_proto */
-	pkt_hdr->input_flags.l4 = 1;
+	/* Where parse_l4() resumes. Not visible to the application before
+	 * parsed_all is set, since L4 accessors parse first. */
 	pkt_hdr->l4_offset = offset;
 	pkt_hdr->l4_protocol = ip_proto;
 
+	pkt_hdr->input_flags.parsed_l3 = 1;
+}
+
+/**
+ * Parse L4 header of a packet, after parse_l3()
+ */
+static void parse_l4(odp_packet_hdr_t *pkt_hdr, const uint8_t *ptr)
+{
+	uint32_t offset = pkt_hdr->l4_offset;
+	uint8_t ip_proto = pkt_hdr->l4_protocol;
+	const uint8_t *parseptr = ptr + offset;
+
+	/* Set l4_offset+flag only for known ip_proto */
+	pkt_hdr->input_flags.l4 = 1;
+
 	/* Parse Layer 4 headers */
 	switch (ip_proto) {
 	case ODPH_IPPROTO_ICMP:
@@ -1064,9 +1083,20 @@ int _odp_parse_common(odp_packet_hdr_t *pkt_hdr, const uint8_t *ptr)
 	* final header (ARP, ICMP, AH, ESP, or IP Fragment).
 	*/
 	pkt_hdr->payload_offset = offset;
-
-parse_exit:
 	pkt_hdr->input_flags.parsed_all = 1;
+}
+
+int _odp_parse_common(odp_packet_hdr_t *pkt_hdr, const uint8_t *ptr)
+{
+	if (ptr == NULL)
+		ptr = packet_map(pkt_hdr, 0, NULL);
+
+	if (packet_parse_l3_not_done(pkt_hdr))
+		parse_l3(pkt_hdr, ptr);
+
+	if (packet_parse_not_complete(pkt_hdr))
+		parse_l4(pkt_hdr, ptr);
+
 	return pkt_hdr->error_flags.all != 0;
 }
 
@@ -1082,3 +1112,280 @@ int packet_parse_full(odp_packet_hdr_t *pkt_hdr)
 {
 	return _odp_parse_common(pkt_hdr, NULL);
 }
+
+/**
+ * Parse up to L3, L4 is left for a later (lazy) parse
+ */
+int packet_parse_l3(odp_packet_hdr_t *pkt_hdr)
+{
+	parse_l3(pkt_hdr, packet_map(pkt_hdr, 0, NULL));
+	return pkt_hdr->error_flags.all != 0;
+}
+
+void packet_parse_layer(odp_packet_hdr_t *pkt_hdr,
+			odp_pktio_parse_level_t level)
+{
+	switch (level) {
+	case ODP_PKTIO_PARSE_NONE:
+		break;
+	case ODP_PKTIO_PARSE_DEFAULT:
+	case ODP_PKTIO_PARSE_L2:
+		if (packet_parse_l2_not_done(pkt_hdr))
+			packet_parse_l2(pkt_hdr);
+		break;
+	case ODP_PKTIO_PARSE_L3:
+		if (packet_parse_l3_not_done(pkt_hdr))
+			packet_parse_l3(pkt_hdr);
+		break;
+	default:
+		if (packet_parse_not_complete(pkt_hdr))
+			packet_parse_full(pkt_hdr);
+		break;
+	}
+}
+
+/* Number of packets whose headers are prefetched ahead of the parser */
+#define PARSE_PREFETCH 4
+
+/* Number of packets classified together by parse_eth_burst() */
+#define PARSE_BURST 8
+
+/* Bytes of headers the burst parser needs in the first segment */
+#define PARSE_BURST_HDR_LEN (ODPH_ETHHDR_LEN + ODPH_VLANHDR_LEN + \
+			     ODPH_IPV6HDR_LEN)
+
+/**
+ * Classify the Ethernet headers of a burst of packets
+ *
+ * type12[] and type16[] hold the (big endian) 16 bit words at offsets 12
+ * and 16 of each packet, i.e. the Ethertype of untagged frames and the one
+ * following a single VLAN tag. Returns bit masks of the packets carrying a
+ * VLAN tag, IPv4 and IPv6.
+ */
+#ifdef __SSE2__
+static inline void parse_eth_burst(const uint16_t type12[],
+				   const uint16_t type16[],
+				   uint32_t *vlan,
+				   uint32_t *ipv4, uint32_t *ipv6)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i t12, t16, is_vlan, l3type, is_ipv4, is_ipv6;
+
+	t12 = _mm_loadu_si128((const __m128i *)(const void *)type12);
+	t16 = _mm_loadu_si128((const __m128i *)(const void *)type16);
+
+	is_vlan = _mm_cmpeq_epi16(t12, _mm_set1_epi16((int16_t)
+				  odp_cpu_to_be_16(ODPH_ETHTYPE_VLAN)));
+	l3type  = _mm_or_si128(_mm_and_si128(is_vlan, t16),
+			       _mm_andnot_si128(is_vlan, t12));
+	is_ipv4 = _mm_cmpeq_epi16(l3type, _mm_set1_epi16((int16_t)
+				  odp_cpu_to_be_16(ODPH_ETHTYPE_IPV4)));
+	is_ipv6 = _mm_cmpeq_epi16(l3type, _mm_set1_epi16((int16_t)
+				  odp_cpu_to_be_16(ODPH_ETHTYPE_IPV6)));
+
+	*vlan = _mm_movemask_epi8(_mm_packs_epi16(is_vlan, zero));
+	*ipv4 = _mm_movemask_epi8(_mm_packs_epi16(is_ipv4, zero));
+	*ipv6 = _mm_movemask_epi8(_mm_packs_epi16(is_ipv6, zero));
+}
+#else
+static inline void parse_eth_burst(const uint16_t type12[],
+				   const uint16_t type16[],
+				   uint32_t *vlan,
+				   uint32_t *ipv4, uint32_t *ipv6)
+{
+	uint16_t type;
+	int i;
+
+	*vlan = 0;
+	*ipv4 = 0;
+	*ipv6 = 0;
+
+	for (i = 0; i < PARSE_BURST; i++) {
+		type = type12[i];
+		if (type12[i] == odp_cpu_to_be_16(ODPH_ETHTYPE_VLAN)) {
+			type = type16[i];
+			*vlan |= 1 << i;
+		}
+		if (type == odp_cpu_to_be_16(ODPH_ETHTYPE_IPV4))
+			*ipv4 |= 1 << i;
+		else if (type == odp_cpu_to_be_16(ODPH_ETHTYPE_IPV6))
+			*ipv6 |= 1 << i;
+	}
+}
+#endif
+
+/**
+ * Fill in L2 and L3 metadata of a plain IPv4 or IPv6 packet classified by
+ * parse_eth_burst(). Returns -1 when the packet needs the full parser
+ * (IP options, extension headers, fragments or errors).
+ */
+static inline int parse_l3_fast(odp_packet_hdr_t *pkt_hdr,
+				const uint8_t *ptr, int vlan, int ipv4)
+{
+	uint32_t offset = ODPH_ETHHDR_LEN;
+	const odph_vlanhdr_t *vlan_hdr;
+	const odph_ipv4hdr_t *ip;
+	const odph_ipv6hdr_t *ip6;
+	uint16_t l3_len;
+	uint8_t ip_proto;
+
+	if (vlan)
+		offset += ODPH_VLANHDR_LEN;
+
+	if (ipv4) {
+		ip = (const odph_ipv4hdr_t *)(const void *)(ptr + offset);
+		l3_len = odp_be_to_cpu_16(ip->tot_len);
+		if (odp_unlikely(ip->ver_ihl != (ODPH_IPV4 << 4 |
+						 ODPH_IPV4HDR_IHL_MIN)) ||
+		    odp_unlikely(ODPH_IPV4HDR_IS_FRAGMENT(
+				 odp_be_to_cpu_16(ip->frag_offset))) ||
+		    l3_len > pkt_hdr->frame_len - offset)
+			return -1;
+		ip_proto = ip->proto;
+	} else {
+		ip6 = (const odph_ipv6hdr_t *)(const void *)(ptr + offset);
+		l3_len = odp_be_to_cpu_16(ip6->payload_len);
+		if (odp_unlikely((odp_be_to_cpu_32(ip6->ver_tc_flow) >> 28) !=
+				 6) ||
+		    ip6->next_hdr == ODPH_IPPROTO_HOPOPTS ||
+		    ip6->next_hdr == ODPH_IPPROTO_ROUTE ||
+		    ip6->next_hdr == ODPH_IPPROTO_FRAG ||
+		    l3_len > pkt_hdr->frame_len - offset)
+			return -1;
+		ip_proto = ip6->next_hdr;
+	}
+
+	if (packet_parse_l2_not_done(pkt_hdr))
+		packet_parse_l2(pkt_hdr);
+
+	if (vlan) {
+		vlan_hdr = (const odph_vlanhdr_t *)(const void *)
+			   (ptr + ODPH_ETHHDR_LEN - 2);
+		pkt_hdr->input_flags.vlan = 1;
+		pkt_hdr->vlan_c_tag = ((ODPH_ETHTYPE_VLAN << 16) |
+				       odp_be_to_cpu_16(vlan_hdr->tci));
+	}
+
+	pkt_hdr->input_flags.l3 = 1;
+	pkt_hdr->l3_offset = offset;
+	pkt_hdr->l3_len = l3_len;
+
+	if (ipv4) {
+		pkt_hdr->input_flags.ipv4 = 1;
+		pkt_hdr->l3_protocol = ODPH_ETHTYPE_IPV4;
+		offset += ODPH_IPV4HDR_LEN;
+	} else {
+		pkt_hdr->input_flags.ipv6 = 1;
+		pkt_hdr->l3_protocol = ODPH_ETHTYPE_IPV6;
+		offset += ODPH_IPV6HDR_LEN;
+	}
+
+	pkt_hdr->l4_offset = offset;
+	pkt_hdr->l4_protocol = ip_proto;
+	pkt_hdr->input_flags.parsed_l3 = 1;
+
+	return 0;
+}
+
+/**
+ * Parse up to PARSE_BURST packets above L2
+ *
+ * Ethernet headers are classified together, plain IPv4/IPv6 headers are
+ * then decoded without the generic parser. Anything else falls back to
+ * packet_parse_layer().
+ */
+static void parse_burst(const odp_packet_t pkt[], int num,
+			odp_pktio_parse_level_t level)
+{
+	odp_packet_hdr_t *pkt_hdr[PARSE_BURST];
+	const uint8_t *ptr[PARSE_BURST];
+	uint16_t type12[PARSE_BURST], type16[PARSE_BURST];
+	uint32_t seglen, vlan, ipv4, ipv6;
+	int i;
+
+	for (i = 0; i < PARSE_BURST; i++) {
+		type12[i] = 0;
+		type16[i] = 0;
+		if (i >= num)
+			continue;
+
+		pkt_hdr[i] = odp_packet_hdr(pkt[i]);
+		ptr[i] = packet_map(pkt_hdr[i], 0, &seglen);
+
+		/* Leave short, segmented or already parsed headers to the
+		 * generic parser */
+		if (odp_unlikely(seglen < PARSE_BURST_HDR_LEN) ||
+		    !packet_parse_l3_not_done(pkt_hdr[i]))
+			continue;
+
+		type12[i] = *(const uint16_t *)(const void *)(ptr[i] + 12);
+		type16[i] = *(const uint16_t *)(const void *)(ptr[i] + 16);
+	}
+
+	parse_eth_burst(type12, type16, &vlan, &ipv4, &ipv6);
+
+	for (i = 0; i < num; i++) {
+		if (((ipv4 | ipv6) & (1 << i)) &&
+		    parse_l3_fast(pkt_hdr[i], ptr[i], vlan & (1 << i),
+				  ipv4 & (1 << i)) == 0) {
+			if (level != ODP_PKTIO_PARSE_L3)
+				parse_l4(pkt_hdr[i], ptr[i]);
+			continue;
+		}
+
+		packet_parse_layer(pkt_hdr[i], level);
+	}
+}
+
+void packet_parse_multi(const odp_packet_t pkt[], int num,
+			odp_pktio_parse_level_t level)
+{
+	odp_packet_hdr_t *pkt_hdr;
+	int i, n;
+
+	switch (level) {
+	case ODP_PKTIO_PARSE_NONE:
+		return;
+	case ODP_PKTIO_PARSE_DEFAULT:
+	case ODP_PKTIO_PARSE_L2:
+		/* Metadata only, packet data is not touched */
+		for (i = 0; i < num; i++) {
+			pkt_hdr = odp_packet_hdr(pkt[i]);
+			if (packet_parse_l2_not_done(pkt_hdr))
+				packet_parse_l2(pkt_hdr);
+		}
+		return;
+	default:
+		break;
+	}
+
+	for (i = 0; i < num && i < PARSE_BURST; i++)
+		odp_prefetch(packet_map(odp_packet_hdr(pkt[i]), 0, NULL));
+
+	for (i = 0; i < num; i += PARSE_BURST) {
+		/* Prefetch the next burst while parsing this one */
+		for (n = i + PARSE_BURST; n < num && n < i + 2 * PARSE_BURST;
+		     n++)
+			odp_prefetch(packet_map(odp_packet_hdr(pkt[n]),
+						0, NULL));
+
+		n = num - i < PARSE_BURST ? num - i : PARSE_BURST;
+		parse_burst(&pkt[i], n, level);
+	}
+}
+
+void packet_parse_multi_scalar(const odp_packet_t pkt[], int num,
+			       odp_pktio_parse_level_t level)
+{
+	int i;
+
+	for (i = 0; i < num && i < PARSE_PREFETCH; i++)
+		odp_prefetch(packet_map(odp_packet_hdr(pkt[i]), 0, NULL));
+
+	for (i = 0; i < num; i++) {
+		if (i + PARSE_PREFETCH < num)
+			odp_prefetch(packet_map(odp_packet_hdr(pkt[i +
+						PARSE_PREFETCH]), 0, NULL));
+		packet_parse_layer(odp_packet_hdr(pkt[i]), level);
+	}
+}
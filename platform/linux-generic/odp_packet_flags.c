@@ -14,6 +14,20 @@
 	return pkt_hdr->x;			       \
 	} while (0)
 
+#define retflag_l3(p, x) do {			       \
+	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(p); \
+	if (packet_parse_l3_not_done(pkt_hdr))	       \
+		packet_parse_l3(pkt_hdr);	       \
+	return pkt_hdr->x;			       \
+	} while (0)
+
+#define retflag_l2(p, x) do {			       \
+	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(p); \
+	if (packet_parse_l2_not_done(pkt_hdr))	       \
+		packet_parse_l2(pkt_hdr);	       \
+	return pkt_hdr->x;			       \
+	} while (0)
+
 #define setflag(p, x, v) do {			       \
 	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(p); \
 	if (packet_parse_not_complete(pkt_hdr))	       \
@@ -33,14 +47,12 @@ int odp_packet_has_error(odp_packet_t pkt)
 
 int odp_packet_has_l2(odp_packet_t pkt)
 {
-	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
-
-	return pkt_hdr->input_flags.l2;
+	retflag_l2(pkt, input_flags.l2);
 }
 
 int odp_packet_has_l3(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.l3);
+	retflag_l3(pkt, input_flags.l3);
 }
 
 int odp_packet_has_l4(odp_packet_t pkt)
@@ -50,51 +62,47 @@ int odp_packet_has_l4(odp_packet_t pkt)
 
 int odp_packet_has_eth(odp_packet_t pkt)
 {
-	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
-
-	return pkt_hdr->input_flags.eth;
+	retflag_l2(pkt, input_flags.eth);
 }
 
 int odp_packet_has_jumbo(odp_packet_t pkt)
 {
-	odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt);
-
-	return pkt_hdr->input_flags.jumbo;
+	retflag_l2(pkt, input_flags.jumbo);
 }
 
 int odp_packet_has_vlan(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.vlan);
+	retflag_l3(pkt, input_flags.vlan);
 }
 
 int odp_packet_has_vlan_qinq(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.vlan_qinq);
+	retflag_l3(pkt, input_flags.vlan_qinq);
 }
 
 int odp_packet_has_arp(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.arp);
+	retflag_l3(pkt, input_flags.arp);
 }
 
 int odp_packet_has_ipv4(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.ipv4);
+	retflag_l3(pkt, input_flags.ipv4);
 }
 
 int odp_packet_has_ipv6(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.ipv6);
+	retflag_l3(pkt, input_flags.ipv6);
 }
 
 int odp_packet_has_ipfrag(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.ipfrag);
+	retflag_l3(pkt, input_flags.ipfrag);
 }
 
 int odp_packet_has_ipopt(odp_packet_t pkt)
 {
-	retflag(pkt, input_flags.ipopt);
+	retflag_l3(pkt, input_flags.ipopt);
 }
 
 int odp_packet_has_ipsec(odp_packet_t pkt)
@@ -19,14 +19,19 @@
 #include <odp_schedule_internal.h>
 #include <odp_classification_internal.h>
 #include <odp_debug_internal.h>
+#include <odp_trace_internal.h>
 
 #include <string.h>
+#include <stdlib.h>
 #include <sys/ioctl.h>
 #include <ifaddrs.h>
 #include <errno.h>
 
 static pktio_table_t *pktio_tbl;
 
+/* Statistics slots, ODP_THREAD_COUNT_MAX per pktio entry */
+static pktio_stats_slot_t *pktio_stats_tbl;
+
 /* pktio pointer entries ( for inlines) */
 void *pktio_entry_ptr[ODP_CONFIG_PKTIO_ENTRIES];
 
@@ -40,6 +45,18 @@ int odp_pktio_init_global(void)
 	odp_shm_t shm;
 	int pktio_if;
 
+	if (odp_global_data.secondary) {
+		/* Queues refer to the entries, only the primary does IO */
+		pktio_tbl = odp_shm_addr(odp_shm_lookup("odp_pktio_entries"));
+		if (pktio_tbl == NULL)
+			return -1;
+
+		for (id = 0; id < ODP_CONFIG_PKTIO_ENTRIES; id++)
+			pktio_entry_ptr[id] = &pktio_tbl->entries[id];
+
+		return 0;
+	}
+
 	shm = odp_shm_reserve("odp_pktio_entries",
 			      sizeof(pktio_table_t),
 			      sizeof(pktio_entry_t), 0);
@@ -50,6 +67,15 @@ int odp_pktio_init_global(void)
 
 	memset(pktio_tbl, 0, sizeof(pktio_table_t));
 
+	shm = odp_shm_reserve("odp_pktio_stats",
+			      sizeof(pktio_stats_slot_t) *
+			      ODP_THREAD_COUNT_MAX * ODP_CONFIG_PKTIO_ENTRIES,
+			      ODP_CACHE_LINE_SIZE, 0);
+	pktio_stats_tbl = odp_shm_addr(shm);
+
+	if (pktio_stats_tbl == NULL)
+		return -1;
+
 	odp_spinlock_init(&pktio_tbl->lock);
 
 	for (id = 1; id <= ODP_CONFIG_PKTIO_ENTRIES; ++id) {
@@ -60,6 +86,8 @@ int odp_pktio_init_global(void)
 		odp_spinlock_init(&pktio_entry->s.cls.l2_cos_table.lock);
 		odp_spinlock_init(&pktio_entry->s.cls.l3_cos_table.lock);
 
+		pktio_entry->s.stats = &pktio_stats_tbl[(id - 1) *
+							ODP_THREAD_COUNT_MAX];
 		pktio_entry_ptr[id - 1] = pktio_entry;
 		/* Create a default output queue for each pktio resource */
 		snprintf(name, sizeof(name), "%i-pktio_outq_default", (int)id);
@@ -131,6 +159,18 @@ static void init_pktio_entry(pktio_entry_t *entry)
 	set_taken(entry);
 	pktio_cls_enabled_set(entry, 0);
 	entry->s.inq_default = ODP_QUEUE_INVALID;
+	entry->s.tx_mt_safe = 0;
+	entry->s.parse_burst = getenv("ODP_PKTIO_DISABLE_PARSE_BURST") ?
+			       0 : 1;
+
+	/* Slots of all threads are cleared, counting needs no reset */
+	memset(entry->s.stats, 0,
+	       sizeof(pktio_stats_slot_t) * ODP_THREAD_COUNT_MAX);
+	memset(&entry->s.stats_base, 0, sizeof(entry->s.stats_base));
+	memset(entry->s.stats_queue_base, 0,
+	       sizeof(entry->s.stats_queue_base));
+	entry->s.stats_num_queues = 0;
+	entry->s.vec_pend_num = 0;
 
 	pktio_classifier_init(entry);
 }
@@ -198,7 +238,17 @@ static odp_pktio_t setup_pktio_entry(const char *dev, odp_pool_t pool,
 	memcpy(&pktio_entry->s.param, param, sizeof(odp_pktio_param_t));
 	pktio_entry->s.id = id;
 
+	if (packet_vector_param_check(&pktio_entry->s.param.in_vector)) {
+		unlock_entry_classifier(pktio_entry);
+		free_pktio_entry(id);
+		return ODP_PKTIO_INVALID;
+	}
+
 	for (pktio_if = 0; pktio_if_ops[pktio_if]; ++pktio_if) {
+		/* Not left over from a backend that failed to open */
+		pktio_entry->s.tx_mt_safe = 0;
+		pktio_entry->s.stats_num_queues = 0;
+
 		ret = pktio_if_ops[pktio_if]->open(id, pktio_entry, dev, pool);
 
 		if (!ret) {
@@ -244,6 +294,13 @@ odp_pktio_t odp_pktio_open(const char *dev, odp_pool_t pool,
 
 	ODP_ASSERT(pool_type_is_packet(pool));
 
+	/* Packet IO belongs to the primary process of an instance */
+	if (odp_global_data.secondary) {
+		ODP_ERR("%s: no packet IO in a secondary process\n", dev);
+		__odp_errno = EPERM;
+		return ODP_PKTIO_INVALID;
+	}
+
 	id = odp_pktio_lookup(dev);
 	if (id != ODP_PKTIO_INVALID) {
 		/* interface is already open */
@@ -376,15 +433,85 @@ odp_pktio_t odp_pktio_lookup(const char *dev)
 
 
 
+static void pktio_vec_enq(pktio_entry_t *entry, pktio_vec_pend_t *pend)
+{
+	odp_packet_vector_hdr_t *hdr = odp_packet_vector_hdr(pend->vec);
+
+	if (odp_unlikely(queue_enq(pend->queue, &hdr->buf_hdr, 0))) {
+		pktio_stats(entry)->in_cls_drops += hdr->size;
+		packet_vector_free_all(pend->vec);
+	}
+}
+
+static void pktio_vec_flush(pktio_entry_t *entry)
+{
+	int i;
+
+	for (i = 0; i < entry->s.vec_pend_num; i++)
+		pktio_vec_enq(entry, &entry->s.vec_pend[i]);
+
+	entry->s.vec_pend_num = 0;
+}
+
+int _odp_pktio_vec_add(pktio_entry_t *entry, queue_entry_t *queue,
+		       const odp_packet_vector_param_t *param,
+		       odp_packet_t pkt)
+{
+	pktio_vec_pend_t *pend = NULL;
+	odp_packet_vector_hdr_t *hdr;
+	int i;
+
+	for (i = 0; i < entry->s.vec_pend_num; i++) {
+		if (entry->s.vec_pend[i].queue == queue) {
+			pend = &entry->s.vec_pend[i];
+			break;
+		}
+	}
+
+	if (pend == NULL) {
+		if (entry->s.vec_pend_num == PKTIO_VEC_PEND_MAX)
+			pktio_vec_flush(entry);
+
+		pend = &entry->s.vec_pend[entry->s.vec_pend_num];
+		pend->vec = odp_packet_vector_alloc(param->pool);
+		if (odp_unlikely(pend->vec == ODP_PACKET_VECTOR_INVALID))
+			return -1;
+
+		pend->queue    = queue;
+		pend->max_size = param->max_size;
+		entry->s.vec_pend_num++;
+	}
+
+	hdr = odp_packet_vector_hdr(pend->vec);
+	packet_vector_tbl(hdr)[hdr->size++] = pkt;
+
+	/* A full vector is enqueued and its slot released */
+	if (hdr->size == pend->max_size) {
+		pktio_vec_enq(entry, pend);
+		*pend = entry->s.vec_pend[--entry->s.vec_pend_num];
+	}
+
+	return 0;
+}
+
 int odp_pktio_recv(odp_pktio_t id, odp_packet_t pkt_table[], int len)
 {
 	pktio_entry_t *pktio_entry = get_pktio_entry(id);
+	odp_pktio_stats_t *stats;
+	uint64_t octets = 0;
 	int pkts;
 	int i;
 
 	if (pktio_entry == NULL)
 		return -1;
 
+	if (odp_unlikely(odp_global_data.secondary)) {
+		__odp_errno = EPERM;
+		return -1;
+	}
+
+	TRACE_BEGIN(PKTIO_RECV);
+
 	lock_entry(pktio_entry);
 	if (pktio_entry->s.state == STATE_STOP ||
 	    pktio_entry->s.param.in_mode == ODP_PKTIN_MODE_DISABLED) {
@@ -393,13 +520,76 @@ int odp_pktio_recv(odp_pktio_t id, odp_packet_t pkt_table[], int len)
 		return -1;
 	}
 	pkts = pktio_entry->s.ops->recv(pktio_entry, pkt_table, len);
+	if (pktio_entry->s.vec_pend_num)
+		pktio_vec_flush(pktio_entry);
 	unlock_entry(pktio_entry);
 
-	if (pkts < 0)
+	stats = pktio_stats(pktio_entry);
+
+	if (pkts < 0) {
+		stats->in_errors++;
 		return pkts;
+	}
+
+	for (i = 0; i < pkts; ++i) {
+		odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt_table[i]);
+
+		pkt_hdr->input = id;
+		octets += pkt_hdr->frame_len;
+	}
+
+	stats->in_packets += pkts;
+	stats->in_octets += octets;
+
+	/* Layers above the parse level are parsed on first access */
+	if (odp_likely(pktio_entry->s.parse_burst))
+		packet_parse_multi(pkt_table, pkts,
+				   pktio_entry->s.param.parse_level);
+	else
+		packet_parse_multi_scalar(pkt_table, pkts,
+					  pktio_entry->s.param.parse_level);
+
+	if (pkts)
+		TRACE_END(PKTIO_RECV, pkts);
+
+	return pkts;
+}
+
+static uint64_t pkt_octets(odp_packet_t pkt_table[], int num)
+{
+	uint64_t octets = 0;
+	int i;
+
+	for (i = 0; i < num; i++)
+		octets += odp_packet_hdr(pkt_table[i])->frame_len;
+
+	return octets;
+}
+
+/* Send and count, packets must be read before the backend frees them */
+static int pktio_send(pktio_entry_t *entry, odp_packet_t pkt_table[], int len)
+{
+	odp_pktio_stats_t *stats = pktio_stats(entry);
+	uint64_t octets = pkt_octets(pkt_table, len);
+	int pkts;
+
+	TRACE_BEGIN(PKTIO_SEND);
+
+	pkts = entry->s.ops->send(entry, pkt_table, len);
+
+	if (odp_unlikely(pkts < 0)) {
+		stats->out_errors++;
+		return pkts;
+	}
+
+	/* Packets not sent are still owned by the caller */
+	if (odp_unlikely(pkts < len))
+		octets -= pkt_octets(&pkt_table[pkts], len - pkts);
+
+	stats->out_packets += pkts;
+	stats->out_octets += octets;
 
-	for (i = 0; i < pkts; ++i)
-		odp_packet_hdr(pkt_table[i])->input = id;
+	TRACE_END(PKTIO_SEND, pkts);
 
 	return pkts;
 }
@@ -412,6 +602,23 @@ int odp_pktio_send(odp_pktio_t id, odp_packet_t pkt_table[], int len)
 	if (pktio_entry == NULL)
 		return -1;
 
+	if (odp_unlikely(odp_global_data.secondary)) {
+		__odp_errno = EPERM;
+		return -1;
+	}
+
+	/* Backends with thread safe send (e.g. per-thread rings) are called
+	 * without serializing senders on the entry lock */
+	if (pktio_entry->s.tx_mt_safe) {
+		if (odp_unlikely(pktio_entry->s.state == STATE_STOP ||
+				 pktio_entry->s.param.out_mode ==
+				 ODP_PKTOUT_MODE_DISABLED)) {
+			__odp_errno = EPERM;
+			return -1;
+		}
+		return pktio_send(pktio_entry, pkt_table, len);
+	}
+
 	lock_entry(pktio_entry);
 	if (pktio_entry->s.state == STATE_STOP ||
 	    pktio_entry->s.param.out_mode == ODP_PKTOUT_MODE_DISABLED) {
@@ -419,7 +626,7 @@ int odp_pktio_send(odp_pktio_t id, odp_packet_t pkt_table[], int len)
 		__odp_errno = EPERM;
 		return -1;
 	}
-	pkts = pktio_entry->s.ops->send(pktio_entry, pkt_table, len);
+	pkts = pktio_send(pktio_entry, pkt_table, len);
 	unlock_entry(pktio_entry);
 
 	return pkts;
@@ -643,6 +850,44 @@ int pktin_deq_multi(queue_entry_t *qentry, odp_buffer_hdr_t *buf_hdr[], int num)
 	return nbr;
 }
 
+/* Receive a burst directly into a vector and enqueue it as one event */
+static int pktin_poll_vector(pktio_entry_t *entry)
+{
+	const odp_packet_vector_param_t *param = &entry->s.param.in_vector;
+	odp_packet_vector_hdr_t *hdr;
+	odp_packet_vector_t pktv;
+	queue_entry_t *qentry;
+	int num;
+
+	TRACE_BEGIN(PKTIN_POLL);
+
+	pktv = odp_packet_vector_alloc(param->pool);
+	if (odp_unlikely(pktv == ODP_PACKET_VECTOR_INVALID))
+		return 0;
+
+	hdr = odp_packet_vector_hdr(pktv);
+	num = odp_pktio_recv(entry->s.handle, packet_vector_tbl(hdr),
+			     param->max_size);
+
+	if (num <= 0) {
+		odp_packet_vector_free(pktv);
+		if (num < 0) {
+			ODP_ERR("Packet recv error\n");
+			return -1;
+		}
+		return 0;
+	}
+
+	hdr->size = num;
+	qentry = queue_to_qentry(entry->s.inq_default);
+	if (odp_unlikely(queue_enq(qentry, &hdr->buf_hdr, 0)))
+		packet_vector_free_all(pktv);
+
+	TRACE_END(PKTIN_POLL, num);
+
+	return 0;
+}
+
 int pktin_poll(pktio_entry_t *entry)
 {
 	odp_packet_t pkt_tbl[QUEUE_MULTI_MAX];
@@ -662,6 +907,11 @@ int pktin_poll(pktio_entry_t *entry)
 	if (entry->s.state == STATE_STOP)
 		return 0;
 
+	if (entry->s.param.in_vector.enable)
+		return pktin_poll_vector(entry);
+
+	TRACE_BEGIN(PKTIN_POLL);
+
 	num = odp_pktio_recv(pktio, pkt_tbl, QUEUE_MULTI_MAX);
 
 	if (num == 0)
@@ -683,6 +933,8 @@ int pktin_poll(pktio_entry_t *entry)
 		queue_enq_multi(qentry, hdr_tbl, num, 0);
 	}
 
+	TRACE_END(PKTIN_POLL, num);
+
 	return 0;
 }
 
@@ -795,6 +1047,174 @@ int odp_pktio_mac_addr(odp_pktio_t id, void *mac_addr, int addr_size)
 	return ret;
 }
 
+/* Sum the slots of all threads, plus the counters kept by the device */
+static int pktio_stats_sum(pktio_entry_t *entry, odp_pktio_stats_t *stats)
+{
+	uint64_t *sum = (uint64_t *)stats;
+	unsigned num = sizeof(odp_pktio_stats_t) / sizeof(uint64_t);
+	unsigned i, thr;
+
+	memset(stats, 0, sizeof(*stats));
+
+	for (thr = 0; thr < ODP_THREAD_COUNT_MAX; thr++) {
+		const uint64_t *cnt = (const uint64_t *)&entry->s.stats[thr].cnt;
+
+		for (i = 0; i < num; i++)
+			sum[i] += cnt[i];
+	}
+
+	if (entry->s.ops->stats)
+		return entry->s.ops->stats(entry, stats);
+
+	return 0;
+}
+
+static void pktio_queue_stats_sum(pktio_entry_t *entry, int queue,
+				  odp_pktio_queue_stats_t *stats)
+{
+	uint64_t *sum = (uint64_t *)stats;
+	unsigned num = sizeof(odp_pktio_queue_stats_t) / sizeof(uint64_t);
+	unsigned i, thr;
+
+	memset(stats, 0, sizeof(*stats));
+
+	for (thr = 0; thr < ODP_THREAD_COUNT_MAX; thr++) {
+		const uint64_t *cnt =
+			(const uint64_t *)&entry->s.stats[thr].queue[queue];
+
+		for (i = 0; i < num; i++)
+			sum[i] += cnt[i];
+	}
+}
+
+static void stats_sub(uint64_t *cnt, const uint64_t *base, unsigned num)
+{
+	unsigned i;
+
+	for (i = 0; i < num; i++)
+		cnt[i] -= base[i];
+}
+
+int odp_pktio_stats(odp_pktio_t id, odp_pktio_stats_t *stats)
+{
+	pktio_entry_t *entry;
+	int ret;
+
+	entry = get_pktio_entry(id);
+	if (entry == NULL) {
+		ODP_DBG("pktio entry %d does not exist\n", id);
+		return -1;
+	}
+
+	lock_entry(entry);
+
+	if (odp_unlikely(is_free(entry))) {
+		unlock_entry(entry);
+		ODP_DBG("already freed pktio\n");
+		return -1;
+	}
+
+	ret = pktio_stats_sum(entry, stats);
+	stats_sub((uint64_t *)stats, (const uint64_t *)&entry->s.stats_base,
+		  sizeof(odp_pktio_stats_t) / sizeof(uint64_t));
+
+	unlock_entry(entry);
+	return ret;
+}
+
+int odp_pktio_stats_reset(odp_pktio_t id)
+{
+	pktio_entry_t *entry;
+	int ret = 0;
+	int i;
+
+	entry = get_pktio_entry(id);
+	if (entry == NULL) {
+		ODP_DBG("pktio entry %d does not exist\n", id);
+		return -1;
+	}
+
+	lock_entry(entry);
+
+	if (odp_unlikely(is_free(entry))) {
+		unlock_entry(entry);
+		ODP_DBG("already freed pktio\n");
+		return -1;
+	}
+
+	/* Slots are written by their threads without locks, reset by
+	 * remembering the current values instead of clearing them */
+	ret = pktio_stats_sum(entry, &entry->s.stats_base);
+	for (i = 0; i < PKTIO_STATS_MAX_QUEUES; i++)
+		pktio_queue_stats_sum(entry, i, &entry->s.stats_queue_base[i]);
+
+	unlock_entry(entry);
+	return ret;
+}
+
+int odp_pktio_stats_num_queues(odp_pktio_t id)
+{
+	pktio_entry_t *entry;
+	int num;
+
+	entry = get_pktio_entry(id);
+	if (entry == NULL) {
+		ODP_DBG("pktio entry %d does not exist\n", id);
+		return -1;
+	}
+
+	num = entry->s.stats_num_queues;
+	if (num > PKTIO_STATS_MAX_QUEUES)
+		num = PKTIO_STATS_MAX_QUEUES;
+
+	return num ? num : 1;
+}
+
+int odp_pktio_queue_stats(odp_pktio_t id, int queue,
+			  odp_pktio_queue_stats_t *stats)
+{
+	pktio_entry_t *entry;
+	odp_pktio_stats_t cnt;
+	int ret = 0;
+
+	entry = get_pktio_entry(id);
+	if (entry == NULL) {
+		ODP_DBG("pktio entry %d does not exist\n", id);
+		return -1;
+	}
+
+	if (queue < 0 || queue >= odp_pktio_stats_num_queues(id))
+		return -1;
+
+	lock_entry(entry);
+
+	if (odp_unlikely(is_free(entry))) {
+		unlock_entry(entry);
+		ODP_DBG("already freed pktio\n");
+		return -1;
+	}
+
+	if (entry->s.stats_num_queues) {
+		pktio_queue_stats_sum(entry, queue, stats);
+		stats_sub((uint64_t *)stats,
+			  (const uint64_t *)&entry->s.stats_queue_base[queue],
+			  sizeof(odp_pktio_queue_stats_t) / sizeof(uint64_t));
+	} else {
+		/* Single queue, the interface counters are the queue's */
+		ret = pktio_stats_sum(entry, &cnt);
+		stats_sub((uint64_t *)&cnt,
+			  (const uint64_t *)&entry->s.stats_base,
+			  sizeof(odp_pktio_stats_t) / sizeof(uint64_t));
+		stats->in_octets = cnt.in_octets;
+		stats->in_packets = cnt.in_packets;
+		stats->out_octets = cnt.out_octets;
+		stats->out_packets = cnt.out_packets;
+	}
+
+	unlock_entry(entry);
+	return ret;
+}
+
 void odp_pktio_param_init(odp_pktio_param_t *params)
 {
 	memset(params, 0, sizeof(odp_pktio_param_t));
@@ -844,6 +1264,11 @@ int odp_pktio_term_global(void)
 	if (ret != 0)
 		ODP_ERR("shm free failed for odp_pktio_entries");
 
+	if (odp_shm_free(odp_shm_lookup("odp_pktio_stats"))) {
+		ODP_ERR("shm free failed for odp_pktio_stats");
+		ret = -1;
+	}
+
 	return ret;
 }
 
@@ -0,0 +1,80 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <odp/pflock.h>
+#include <odp/atomic.h>
+#include <odp_atomic_internal.h>
+#include <odp_spin_internal.h>
+
+/*
+ * Phase-fair ticket lock (Brandenburg & Anderson, PF-T). The low bits of
+ * 'rd_in' tell readers whether a writer is present and its phase, the upper
+ * bits count readers in the same units as 'rd_out'. Writers are serialized
+ * by the 'wr_in'/'wr_out' ticket pair.
+ */
+#define PF_WBITS	0x3	/* Writer bits in rd_in */
+#define PF_PRES		0x2	/* Writer present */
+#define PF_PHID		0x1	/* Writer phase id */
+#define PF_RINC		0x100	/* Reader increment */
+
+void odp_pflock_init(odp_pflock_t *pflock)
+{
+	odp_atomic_init_u32(&pflock->rd_in, 0);
+	odp_atomic_init_u32(&pflock->rd_out, 0);
+	odp_atomic_init_u32(&pflock->wr_in, 0);
+	odp_atomic_init_u32(&pflock->wr_out, 0);
+}
+
+void odp_pflock_read_lock(odp_pflock_t *pflock)
+{
+	uint32_t w;
+
+	w = _odp_atomic_u32_fetch_add_mm(&pflock->rd_in, PF_RINC,
+					 _ODP_MEMMODEL_ACQ) & PF_WBITS;
+	if (w == 0)
+		return;
+
+	/* A writer is present, wait until its phase ends. The next writer
+	 * has the other phase id, so readers are not starved by a stream
+	 * of writers. */
+	while ((_odp_atomic_u32_load_mm(&pflock->rd_in, _ODP_MEMMODEL_ACQ) &
+		PF_WBITS) == w)
+		odp_spin();
+}
+
+void odp_pflock_read_unlock(odp_pflock_t *pflock)
+{
+	_odp_atomic_u32_add_mm(&pflock->rd_out, PF_RINC, _ODP_MEMMODEL_RLS);
+}
+
+void odp_pflock_write_lock(odp_pflock_t *pflock)
+{
+	uint32_t ticket, w;
+
+	/* Wait for the turn among writers */
+	ticket = odp_atomic_fetch_inc_u32(&pflock->wr_in);
+	odp_spin_until_eq_u32(&pflock->wr_out, ticket);
+
+	/* Block new readers and wait for the readers already in to leave */
+	w = PF_PRES | (ticket & PF_PHID);
+	ticket = _odp_atomic_u32_fetch_add_mm(&pflock->rd_in, w,
+					      _ODP_MEMMODEL_RLX);
+	odp_spin_until_eq_u32(&pflock->rd_out, ticket);
+}
+
+void odp_pflock_write_unlock(odp_pflock_t *pflock)
+{
+	uint32_t ticket;
+
+	/* Only the owner writes 'wr_out' and the writer bits of 'rd_in' */
+	ticket = _odp_atomic_u32_load_mm(&pflock->wr_out, _ODP_MEMMODEL_RLX);
+
+	/* Start a read phase, then let the next writer in */
+	_odp_atomic_u32_sub_mm(&pflock->rd_in, PF_PRES | (ticket & PF_PHID),
+			       _ODP_MEMMODEL_RLS);
+	_odp_atomic_u32_store_mm(&pflock->wr_out, ticket + 1,
+				 _ODP_MEMMODEL_RLS);
+}
@@ -19,6 +19,7 @@
 #include <odp/hints.h>
 #include <odp/thread.h>
 #include <odp_debug_internal.h>
+#include <odp_trace_internal.h>
 #include <odp_atomic_internal.h>
 
 #include <string.h>
@@ -34,6 +35,7 @@ typedef union buffer_type_any_u {
 	odp_buffer_hdr_t  buf;
 	odp_packet_hdr_t  pkt;
 	odp_timeout_hdr_t tmo;
+	odp_packet_vector_hdr_t vec;
 } odp_anybuf_t;
 
 /* Any buffer type header */
@@ -66,9 +68,20 @@ int odp_pool_init_global(void)
 	uint32_t i;
 	odp_shm_t shm;
 
+	if (odp_global_data.secondary) {
+		pool_tbl = odp_shm_addr(odp_shm_lookup(SHM_DEFAULT_NAME));
+		if (pool_tbl == NULL)
+			return -1;
+
+		for (i = 0; i < ODP_CONFIG_POOLS; i++)
+			pool_entry_ptr[i] = &pool_tbl->pool[i];
+
+		return 0;
+	}
+
 	shm = odp_shm_reserve(SHM_DEFAULT_NAME,
 			      sizeof(pool_table_t),
-			      sizeof(pool_entry_t), 0);
+			      sizeof(pool_entry_t), _odp_shm_worker_flags());
 
 	pool_tbl = odp_shm_addr(shm);
 
@@ -240,6 +253,20 @@ odp_pool_t odp_pool_create(const char *name, odp_pool_param_t *params)
 		buf_stride = sizeof(odp_timeout_hdr_stride);
 		break;
 
+	case ODP_POOL_VECTOR:
+		if (params->vec.max_size == 0)
+			return ODP_POOL_INVALID;
+
+		buf_num  = params->vec.num;
+		blk_size = params->vec.max_size * sizeof(odp_packet_t);
+
+		/* Small packet tables are stored in the header */
+		if (blk_size > ODP_MAX_INLINE_BUF)
+			blk_size = ODP_ALIGN_ROUNDUP(blk_size, buf_align);
+
+		buf_stride = sizeof(odp_packet_vector_hdr_stride);
+		break;
+
 	default:
 		return ODP_POOL_INVALID;
 	}
@@ -295,9 +322,13 @@ odp_pool_t odp_pool_create(const char *name, odp_pool_param_t *params)
 							  mdata_size +
 							  udata_size);
 
+		/* Near the workers and faulted in, so that the data path
+		 * does not take page faults */
 		shm = odp_shm_reserve(pool->s.name,
 				      pool->s.pool_size,
-				      ODP_PAGE_SIZE, 0);
+				      ODP_PAGE_SIZE,
+				      _odp_shm_worker_flags() |
+				      ODP_SHM_PREFAULT);
 		if (shm == ODP_SHM_INVALID) {
 			POOL_UNLOCK(&pool->s.lock);
 			return ODP_POOL_INVALID;
@@ -416,6 +447,9 @@ odp_pool_t odp_pool_lookup(const char *name)
 	uint32_t i;
 	pool_entry_t *pool;
 
+	/* Map pools created by other processes of the instance */
+	_odp_shm_sync();
+
 	for (i = 0; i < ODP_CONFIG_POOLS; i++) {
 		pool = get_pool_entry(i);
 
@@ -486,6 +520,7 @@ odp_buffer_t buffer_alloc(odp_pool_t pool_hdl, size_t size)
 	pool_entry_t *pool = get_pool_entry(pool_id);
 	uintmax_t totsize = pool->s.headroom + size + pool->s.tailroom;
 	odp_anybuf_t *buf;
+	TRACE_SCOPE(BUFFER_ALLOC);
 
 	/* Reject oversized allocation requests */
 	if ((pool->s.flags.unsegmented && totsize > pool->s.seg_size) ||
@@ -524,9 +559,6 @@ odp_buffer_t buffer_alloc(odp_pool_t pool_hdl, size_t size)
 	/* By default, buffers inherit their pool's zeroization setting */
 	buf->buf.flags.zeroized = pool->s.flags.zeroized;
 
-	/* By default, buffers are not associated with an ordered queue */
-	buf->buf.origin_qe = NULL;
-
 	return odp_hdr_to_buf(&buf->buf);
 }
 
@@ -561,6 +593,7 @@ void odp_buffer_free(odp_buffer_t buf)
 {
 	odp_buffer_hdr_t *buf_hdr = odp_buf_to_hdr(buf);
 	pool_entry_t *pool = odp_buf_to_pool(buf_hdr);
+	TRACE_SCOPE(BUFFER_FREE);
 
 	if (odp_unlikely(pool->s.low_wm_assert))
 		ret_buf(&pool->s, buf_hdr);
@@ -617,7 +650,8 @@ void odp_pool_print(odp_pool_t pool_hdl)
 		pool->s.params.type == ODP_POOL_BUFFER ? "buffer" :
 	       (pool->s.params.type == ODP_POOL_PACKET ? "packet" :
 	       (pool->s.params.type == ODP_POOL_TIMEOUT ? "timeout" :
-		"unknown")));
+	       (pool->s.params.type == ODP_POOL_VECTOR ? "vector" :
+		"unknown"))));
 	ODP_DBG(" pool storage    ODP managed shm handle %" PRIu64 "\n",
 		odp_shm_to_u64(pool->s.pool_shm));
 	ODP_DBG(" pool status     %s\n",
@@ -642,6 +676,8 @@ void odp_pool_print(odp_pool_t pool_hdl)
 			pool->s.params.pkt.seg_len, pool->s.seg_size);
 		ODP_DBG(" pkt length      %u requested, %u used\n",
 			pool->s.params.pkt.len, pool->s.blk_size);
+	} else if (pool->s.params.type == ODP_POOL_VECTOR) {
+		ODP_DBG(" vector size     %u\n", pool->s.params.vec.max_size);
 	}
 	ODP_DBG(" num bufs        %u\n",  pool->s.buf_num);
 	ODP_DBG(" bufs available  %u %s\n", bufcount,
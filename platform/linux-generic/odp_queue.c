@@ -20,8 +20,11 @@
 #include <odp_packet_io_internal.h>
 #include <odp_packet_io_queue.h>
 #include <odp_debug_internal.h>
+#include <odp_trace_internal.h>
 #include <odp/hints.h>
 #include <odp/sync.h>
+#include <odp_atomic_internal.h>
+#include <odp_spin_internal.h>
 
 #ifdef USE_TICKETLOCK
 #include <odp/ticketlock.h>
@@ -39,18 +42,31 @@
 
 #include <string.h>
 
-#define RESOLVE_ORDER 0
 #define SUSTAIN_ORDER 1
 
-#define NOAPPEND 0
-#define APPEND   1
-
 typedef struct queue_table_t {
 	queue_entry_t  queue[ODP_CONFIG_QUEUES];
 } queue_table_t;
 
 static queue_table_t *queue_tbl;
 
+typedef struct {
+	enq_func_t       enqueue;
+	deq_func_t       dequeue;
+	enq_multi_func_t enqueue_multi;
+	deq_multi_func_t dequeue_multi;
+} queue_ops_t;
+
+/* Indexed by QUEUE_OPS_xxx */
+static const queue_ops_t queue_ops[] = {
+	[QUEUE_OPS_DEFAULT] = {queue_enq, queue_deq,
+			       queue_enq_multi, queue_deq_multi},
+	[QUEUE_OPS_PKTIN]   = {pktin_enqueue, pktin_dequeue,
+			       pktin_enq_multi, pktin_deq_multi},
+	[QUEUE_OPS_PKTOUT]  = {queue_pktout_enq, pktout_dequeue,
+			       queue_pktout_enq_multi, pktout_deq_multi},
+};
+
 
 static inline void get_qe_locks(queue_entry_t *qe1, queue_entry_t *qe2)
 {
@@ -86,6 +102,42 @@ queue_entry_t *get_qentry(uint32_t queue_id)
 	return &queue_tbl->queue[queue_id];
 }
 
+static inline reorder_slot_t *reorder_slot(reorder_window_t *win,
+					   uint64_t order)
+{
+	return &win->slot[order & (REORDER_WINDOW_SIZE - 1)];
+}
+
+static void reorder_init(queue_entry_t *queue)
+{
+	reorder_window_t *win = &queue->s.reorder;
+	uint32_t i;
+
+	queue->s.order_in = 0;
+	odp_atomic_init_u64(&win->head, 0);
+	odp_atomic_init_u32(&win->drain, 0);
+
+	for (i = 0; i < ODP_CONFIG_MAX_ORDERED_LOCKS_PER_QUEUE; i++)
+		odp_atomic_init_u64(&win->lock[i], 0);
+
+	for (i = 0; i < REORDER_WINDOW_SIZE; i++) {
+		odp_atomic_init_u64(&win->slot[i].done, 0);
+		win->slot[i].tail = NULL;
+	}
+}
+
+/* Check for deferred enqueues, e.g. of orders never released */
+static int reorder_pending(queue_entry_t *queue)
+{
+	uint32_t i;
+
+	for (i = 0; i < REORDER_WINDOW_SIZE; i++)
+		if (queue->s.reorder.slot[i].tail)
+			return 1;
+
+	return 0;
+}
+
 static int queue_init(queue_entry_t *queue, const char *name,
 		      odp_queue_type_t type, odp_queue_param_t *param)
 {
@@ -107,30 +159,20 @@ static int queue_init(queue_entry_t *queue, const char *name,
 
 	switch (type) {
 	case ODP_QUEUE_TYPE_PKTIN:
-		queue->s.enqueue = pktin_enqueue;
-		queue->s.dequeue = pktin_dequeue;
-		queue->s.enqueue_multi = pktin_enq_multi;
-		queue->s.dequeue_multi = pktin_deq_multi;
+		queue->s.ops = QUEUE_OPS_PKTIN;
 		break;
 	case ODP_QUEUE_TYPE_PKTOUT:
-		queue->s.enqueue = queue_pktout_enq;
-		queue->s.dequeue = pktout_dequeue;
-		queue->s.enqueue_multi = queue_pktout_enq_multi;
-		queue->s.dequeue_multi = pktout_deq_multi;
+		queue->s.ops = QUEUE_OPS_PKTOUT;
 		break;
 	default:
-		queue->s.enqueue = queue_enq;
-		queue->s.dequeue = queue_deq;
-		queue->s.enqueue_multi = queue_enq_multi;
-		queue->s.dequeue_multi = queue_deq_multi;
+		queue->s.ops = QUEUE_OPS_DEFAULT;
 		break;
 	}
 
 	queue->s.head = NULL;
 	queue->s.tail = NULL;
 
-	queue->s.reorder_head = NULL;
-	queue->s.reorder_tail = NULL;
+	reorder_init(queue);
 
 	queue->s.pri_queue = ODP_QUEUE_INVALID;
 	queue->s.cmd_ev    = ODP_EVENT_INVALID;
@@ -140,14 +182,19 @@ static int queue_init(queue_entry_t *queue, const char *name,
 
 int odp_queue_init_global(void)
 {
-	uint32_t i, j;
+	uint32_t i;
 	odp_shm_t shm;
 
 	ODP_DBG("Queue init ... ");
 
+	if (odp_global_data.secondary) {
+		queue_tbl = odp_shm_addr(odp_shm_lookup("odp_queues"));
+		return queue_tbl ? 0 : -1;
+	}
+
 	shm = odp_shm_reserve("odp_queues",
 			      sizeof(queue_table_t),
-			      sizeof(queue_entry_t), 0);
+			      sizeof(queue_entry_t), _odp_shm_worker_flags());
 
 	queue_tbl = odp_shm_addr(shm);
 
@@ -160,10 +207,6 @@ int odp_queue_init_global(void)
 		/* init locks */
 		queue_entry_t *queue = get_qentry(i);
 		LOCK_INIT(&queue->s.lock);
-		for (j = 0; j < ODP_CONFIG_MAX_ORDERED_LOCKS_PER_QUEUE; j++) {
-			odp_atomic_init_u64(&queue->s.sync_in[j], 0);
-			odp_atomic_init_u64(&queue->s.sync_out[j], 0);
-		}
 		queue->s.handle = queue_from_id(i);
 	}
 
@@ -324,7 +367,7 @@ int odp_queue_destroy(odp_queue_t handle)
 		ODP_ERR("queue \"%s\" not empty\n", queue->s.name);
 		return -1;
 	}
-	if (queue_is_ordered(queue) && queue->s.reorder_head) {
+	if (queue_is_ordered(queue) && reorder_pending(queue)) {
 		UNLOCK(&queue->s.lock);
 		ODP_ERR("queue \"%s\" reorder queue not empty\n",
 			queue->s.name);
@@ -391,209 +434,264 @@ odp_queue_t odp_queue_lookup(const char *name)
 	return ODP_QUEUE_INVALID;
 }
 
-int queue_enq(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr, int sustain)
+/* Wait until older orders leave the slot of 'order' */
+static inline void reorder_wait(reorder_window_t *win, uint64_t order)
 {
-	queue_entry_t *origin_qe;
-	uint64_t order;
+	while (odp_unlikely(order - _odp_atomic_u64_load_mm(&win->head,
+							    _ODP_MEMMODEL_ACQ)
+			    >= REORDER_WINDOW_SIZE))
+		odp_spin();
+}
 
-	get_queue_order(&origin_qe, &order, buf_hdr);
+/* Append to the enqueues of an order, only the order owner calls this */
+static inline void reorder_slot_add(reorder_slot_t *slot,
+				    queue_entry_t *queue,
+				    odp_buffer_hdr_t *buf_hdr[], int num)
+{
+	odp_buffer_hdr_t *tail = slot->tail;
+	int i;
 
-	/* Handle enqueues from ordered queues separately */
-	if (origin_qe)
-		return ordered_queue_enq(queue, buf_hdr, sustain,
-					 origin_qe, order);
+	for (i = 0; i < num; i++) {
+		buf_hdr[i]->target_qe = queue;
 
-	LOCK(&queue->s.lock);
+		if (tail) {
+			buf_hdr[i]->next = tail->next;
+			tail->next       = buf_hdr[i];
+		} else {
+			buf_hdr[i]->next = buf_hdr[i];
+		}
+
+		tail = buf_hdr[i];
+	}
+
+	slot->tail = tail;
+}
 
+/* Remove the enqueues of an order, returns the first one */
+static inline odp_buffer_hdr_t *reorder_slot_take(reorder_slot_t *slot)
+{
+	odp_buffer_hdr_t *tail = slot->tail;
+	odp_buffer_hdr_t *head;
+
+	if (tail == NULL)
+		return NULL;
+
+	head       = tail->next;
+	tail->next = NULL;
+	slot->tail = NULL;
+
+	return head;
+}
+
+/* Enqueue without ordering */
+static int enq_unordered(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[],
+			 int num)
+{
+	int sched = 0;
+	int i;
+
+	/* Chain input buffers together */
+	for (i = 0; i < num - 1; i++)
+		buf_hdr[i]->next = buf_hdr[i + 1];
+
+	buf_hdr[num - 1]->next = NULL;
+
+	LOCK(&queue->s.lock);
 	if (odp_unlikely(queue->s.status < QUEUE_STATUS_READY)) {
 		UNLOCK(&queue->s.lock);
 		ODP_ERR("Bad queue status\n");
 		return -1;
 	}
 
-	queue_add(queue, buf_hdr);
+	/* Empty queue */
+	if (queue->s.head == NULL)
+		queue->s.head = buf_hdr[0];
+	else
+		queue->s.tail->next = buf_hdr[0];
+
+	queue->s.tail = buf_hdr[num - 1];
 
 	if (queue->s.status == QUEUE_STATUS_NOTSCHED) {
 		queue->s.status = QUEUE_STATUS_SCHED;
-		UNLOCK(&queue->s.lock);
-		if (schedule_queue(queue))
-			ODP_ABORT("schedule_queue failed\n");
-		return 0;
+		sched = 1; /* retval: schedule queue */
 	}
-
 	UNLOCK(&queue->s.lock);
-	return 0;
+
+	/* Add queue to scheduling */
+	if (sched && schedule_queue(queue))
+		ODP_ABORT("schedule_queue failed\n");
+
+	return num; /* All events enqueued */
 }
 
-int ordered_queue_enq(queue_entry_t *queue,
-		      odp_buffer_hdr_t *buf_hdr,
-		      int sustain,
-		      queue_entry_t *origin_qe,
-		      uint64_t order)
+/* Enqueue to the target of an ordered enqueue */
+static inline int reorder_target_enq(queue_entry_t *queue,
+				     odp_buffer_hdr_t *buf_hdr[], int num)
 {
-	odp_buffer_hdr_t *reorder_buf;
-	odp_buffer_hdr_t *next_buf;
-	odp_buffer_hdr_t *reorder_tail;
-	odp_buffer_hdr_t *placeholder_buf = NULL;
-	int               release_count, placeholder_count;
-	int               sched = 0;
-
-	/* Need two locks for enq operations from ordered queues */
-	get_qe_locks(origin_qe, queue);
-
-	if (odp_unlikely(origin_qe->s.status < QUEUE_STATUS_READY ||
-			 queue->s.status < QUEUE_STATUS_READY)) {
-		free_qe_locks(queue, origin_qe);
-		ODP_ERR("Bad queue status\n");
-		ODP_ERR("queue = %s, origin q = %s, buf = %p\n",
-			queue->s.name, origin_qe->s.name, buf_hdr);
-		return -1;
-	}
+	if (queue->s.ops == QUEUE_OPS_PKTOUT)
+		return pktout_enq_multi(queue, buf_hdr, num);
 
-	/* Remember that enq was called for this order */
-	sched_enq_called();
+	return enq_unordered(queue, buf_hdr, num);
+}
 
-	/* We can only complete this enq if we're in order */
-	if (order > origin_qe->s.order_out) {
-		reorder_enq(queue, order, origin_qe, buf_hdr, sustain);
+/* Output the deferred enqueues of an order, in bursts per target queue.
+ * Events the target does not accept are dropped, the enqueue call that
+ * deferred them has already succeeded. */
+static void reorder_output(odp_buffer_hdr_t *buf_hdr)
+{
+	odp_buffer_hdr_t *burst[QUEUE_MULTI_MAX];
+	queue_entry_t *queue;
+	int num, ret;
 
-		/* This enq can't complete until order is restored, so
-		 * we're done here.
-		 */
-		free_qe_locks(queue, origin_qe);
-		return 0;
-	}
+	while (buf_hdr) {
+		queue = buf_hdr->target_qe;
+		num   = 0;
 
-	/* Resolve order if requested */
-	if (!sustain) {
-		order_release(origin_qe, 1);
-		sched_order_resolved(buf_hdr);
-	}
+		while (buf_hdr && buf_hdr->target_qe == queue &&
+		       num < QUEUE_MULTI_MAX) {
+			burst[num++] = buf_hdr;
+			buf_hdr = buf_hdr->next;
+		}
 
-	/* Update queue status */
-	if (queue->s.status == QUEUE_STATUS_NOTSCHED) {
-		queue->s.status = QUEUE_STATUS_SCHED;
-		sched = 1;
+		ret = reorder_target_enq(queue, burst, num);
+		if (odp_unlikely(ret < 0))
+			ret = 0;
+
+		while (ret < num)
+			odp_buffer_free(burst[ret++]->handle.handle);
 	}
+}
 
-	/* We're in order, however the reorder queue may have other buffers
-	 * sharing this order on it and this buffer must not be enqueued ahead
-	 * of them. If the reorder queue is empty we can short-cut and
-	 * simply add to the target queue directly.
-	 */
+/* Output released orders from the head of the window. A single thread
+ * drains at a time, others leave their released orders to it. */
+static void reorder_drain(queue_entry_t *origin_qe)
+{
+	reorder_window_t *win = &origin_qe->s.reorder;
+	uint32_t lock_count = origin_qe->s.param.sched.lock_count;
+	reorder_slot_t *slot;
+	uint64_t head, exp;
+	uint32_t busy, i;
 
-	if (!origin_qe->s.reorder_head) {
-		queue_add_chain(queue, buf_hdr);
-		free_qe_locks(queue, origin_qe);
+	do {
+		busy = 0;
+		if (!_odp_atomic_u32_cmp_xchg_strong_mm(&win->drain, &busy, 1,
+							_ODP_MEMMODEL_SC,
+							_ODP_MEMMODEL_RLX))
+			return;
 
-		/* Add queue to scheduling */
-		if (sched && schedule_queue(queue))
-			ODP_ABORT("schedule_queue failed\n");
-		return 0;
-	}
+		head = _odp_atomic_u64_load_mm(&win->head, _ODP_MEMMODEL_RLX);
+		slot = reorder_slot(win, head);
 
-	/* The reorder_queue is non-empty, so sort this buffer into it.  Note
-	 * that we force the sustain bit on here because we'll be removing
-	 * this immediately and we already accounted for this order earlier.
-	 */
-	reorder_enq(queue, order, origin_qe, buf_hdr, 1);
+		while (_odp_atomic_u64_load_mm(&slot->done, _ODP_MEMMODEL_ACQ) ==
+		       head + 1) {
+			reorder_output(reorder_slot_take(slot));
 
-	/* Pick up this element, and all others resolved by this enq,
-	 * and add them to the target queue.
-	 */
-	reorder_deq(queue, origin_qe, &reorder_tail, &placeholder_buf,
-		    &release_count, &placeholder_count);
+			/* Pass ordered locks the order did not take */
+			for (i = 0; i < lock_count; i++) {
+				exp = head;
+				_odp_atomic_u64_cmp_xchg_strong_mm(
+					&win->lock[i], &exp, head + 1,
+					_ODP_MEMMODEL_RLS, _ODP_MEMMODEL_RLX);
+			}
 
-	/* Move the list from the reorder queue to the target queue */
-	if (queue->s.head)
-		queue->s.tail->next = origin_qe->s.reorder_head;
-	else
-		queue->s.head       = origin_qe->s.reorder_head;
-	queue->s.tail               = reorder_tail;
-	origin_qe->s.reorder_head   = reorder_tail->next;
-	reorder_tail->next          = NULL;
+			head++;
+			_odp_atomic_u64_store_mm(&win->head, head,
+						 _ODP_MEMMODEL_RLS);
+			slot = reorder_slot(win, head);
+		}
 
-	/* Reflect resolved orders in the output sequence */
-	order_release(origin_qe, release_count + placeholder_count);
+		_odp_atomic_u32_store_mm(&win->drain, 0, _ODP_MEMMODEL_SC);
 
-	/* Now handle any resolved orders for events destined for other
-	 * queues, appending placeholder bufs as needed.
-	 */
-	if (origin_qe != queue)
-		UNLOCK(&queue->s.lock);
+		/* Recheck for orders released while the drain was busy */
+	} while (_odp_atomic_u64_load_mm(&slot->done, _ODP_MEMMODEL_SC) ==
+		 head + 1);
+}
 
-	/* Add queue to scheduling */
-	if (sched && schedule_queue(queue))
-		ODP_ABORT("schedule_queue failed\n");
+/* Enqueue from an ordered context. The oldest order enqueues directly,
+ * younger orders defer their enqueues to the window. */
+static int reorder_enq(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[],
+		       int num, queue_entry_t *origin_qe, uint64_t order)
+{
+	reorder_window_t *win = &origin_qe->s.reorder;
+	reorder_slot_t *slot = reorder_slot(win, order);
 
-	reorder_complete(origin_qe, &reorder_buf, &placeholder_buf, APPEND);
-	UNLOCK(&origin_qe->s.lock);
+	if (odp_unlikely(queue->s.status < QUEUE_STATUS_READY)) {
+		ODP_ERR("Bad queue status\n");
+		return -1;
+	}
 
-	if (reorder_buf)
-		queue_enq_internal(reorder_buf);
+	reorder_wait(win, order);
 
-	/* Free all placeholder bufs that are now released */
-	while (placeholder_buf) {
-		next_buf = placeholder_buf->next;
-		odp_buffer_free(placeholder_buf->handle.handle);
-		placeholder_buf = next_buf;
+	if (order != _odp_atomic_u64_load_mm(&win->head, _ODP_MEMMODEL_ACQ)) {
+		reorder_slot_add(slot, queue, buf_hdr, num);
+		return num;
 	}
 
-	return 0;
+	/* In order, enqueues deferred before go first */
+	reorder_output(reorder_slot_take(slot));
+
+	return reorder_target_enq(queue, buf_hdr, num);
 }
 
-int queue_enq_multi(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[],
-		    int num, int sustain)
+void reorder_release(queue_entry_t *origin_qe, uint64_t order)
+{
+	reorder_window_t *win = &origin_qe->s.reorder;
+
+	reorder_wait(win, order);
+	_odp_atomic_u64_store_mm(&reorder_slot(win, order)->done, order + 1,
+				 _ODP_MEMMODEL_SC);
+	reorder_drain(origin_qe);
+}
+
+int queue_enq(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr,
+	      int sustain ODP_UNUSED)
 {
-	int sched = 0;
-	int i, rc;
-	odp_buffer_hdr_t *tail;
 	queue_entry_t *origin_qe;
 	uint64_t order;
+	TRACE_SCOPE(QUEUE_ENQ);
 
-	/* Chain input buffers together */
-	for (i = 0; i < num - 1; i++)
-		buf_hdr[i]->next = buf_hdr[i + 1];
-
-	tail = buf_hdr[num - 1];
-	buf_hdr[num - 1]->next = NULL;
+	get_sched_order(&origin_qe, &order);
 
-	/* Handle ordered enqueues commonly via links */
-	get_queue_order(&origin_qe, &order, buf_hdr[0]);
-	if (origin_qe) {
-		buf_hdr[0]->link = buf_hdr[0]->next;
-		rc = ordered_queue_enq(queue, buf_hdr[0], sustain,
-				       origin_qe, order);
-		return rc == 0 ? num : rc;
-	}
+	/* Handle enqueues from ordered queues separately */
+	if (origin_qe)
+		return reorder_enq(queue, &buf_hdr, 1, origin_qe,
+				   order) == 1 ? 0 : -1;
 
-	/* Handle unordered enqueues */
 	LOCK(&queue->s.lock);
+
 	if (odp_unlikely(queue->s.status < QUEUE_STATUS_READY)) {
 		UNLOCK(&queue->s.lock);
 		ODP_ERR("Bad queue status\n");
 		return -1;
 	}
 
-	/* Empty queue */
-	if (queue->s.head == NULL)
-		queue->s.head = buf_hdr[0];
-	else
-		queue->s.tail->next = buf_hdr[0];
-
-	queue->s.tail = tail;
+	queue_add(queue, buf_hdr);
 
 	if (queue->s.status == QUEUE_STATUS_NOTSCHED) {
 		queue->s.status = QUEUE_STATUS_SCHED;
-		sched = 1; /* retval: schedule queue */
+		UNLOCK(&queue->s.lock);
+		if (schedule_queue(queue))
+			ODP_ABORT("schedule_queue failed\n");
+		return 0;
 	}
+
 	UNLOCK(&queue->s.lock);
+	return 0;
+}
 
-	/* Add queue to scheduling */
-	if (sched && schedule_queue(queue))
-		ODP_ABORT("schedule_queue failed\n");
+int queue_enq_multi(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[],
+		    int num, int sustain ODP_UNUSED)
+{
+	queue_entry_t *origin_qe;
+	uint64_t order;
+	TRACE_SCOPE(QUEUE_ENQ);
 
-	return num; /* All events enqueued */
+	get_sched_order(&origin_qe, &order);
+
+	if (origin_qe)
+		return reorder_enq(queue, buf_hdr, num, origin_qe, order);
+
+	return enq_unordered(queue, buf_hdr, num);
 }
 
 int odp_queue_enq_multi(odp_queue_t handle, const odp_event_t ev[], int num)
@@ -610,8 +708,11 @@ int odp_queue_enq_multi(odp_queue_t handle, const odp_event_t ev[], int num)
 	for (i = 0; i < num; i++)
 		buf_hdr[i] = odp_buf_to_hdr(odp_buffer_from_event(ev[i]));
 
-	return num == 0 ? 0 : queue->s.enqueue_multi(queue, buf_hdr,
-						     num, SUSTAIN_ORDER);
+	if (num == 0)
+		return 0;
+
+	return queue_ops[queue->s.ops].enqueue_multi(queue, buf_hdr, num,
+						     SUSTAIN_ORDER);
 }
 
 int odp_queue_enq(odp_queue_t handle, odp_event_t ev)
@@ -622,22 +723,14 @@ int odp_queue_enq(odp_queue_t handle, odp_event_t ev)
 	queue   = queue_to_qentry(handle);
 	buf_hdr = odp_buf_to_hdr(odp_buffer_from_event(ev));
 
-	/* No chains via this entry */
-	buf_hdr->link = NULL;
-
-	return queue->s.enqueue(queue, buf_hdr, SUSTAIN_ORDER);
-}
-
-int queue_enq_internal(odp_buffer_hdr_t *buf_hdr)
-{
-	return buf_hdr->target_qe->s.enqueue(buf_hdr->target_qe, buf_hdr,
-					     buf_hdr->flags.sustain);
+	return queue_ops[queue->s.ops].enqueue(queue, buf_hdr, SUSTAIN_ORDER);
 }
 
 odp_buffer_hdr_t *queue_deq(queue_entry_t *queue)
 {
 	odp_buffer_hdr_t *buf_hdr;
-	uint32_t i;
+
+	TRACE_BEGIN(QUEUE_DEQ);
 
 	LOCK(&queue->s.lock);
 
@@ -658,17 +751,8 @@ odp_buffer_hdr_t *queue_deq(queue_entry_t *queue)
 	 * ordered queue rather than deq, however the logic is simpler
 	 * to do it here and has the same effect.
 	 */
-	if (queue_is_ordered(queue)) {
-		buf_hdr->origin_qe = queue;
+	if (queue_is_ordered(queue))
 		buf_hdr->order = queue->s.order_in++;
-		for (i = 0; i < queue->s.param.sched.lock_count; i++) {
-			buf_hdr->sync[i] =
-				odp_atomic_fetch_inc_u64(&queue->s.sync_in[i]);
-		}
-		buf_hdr->flags.sustain = SUSTAIN_ORDER;
-	} else {
-		buf_hdr->origin_qe = NULL;
-	}
 
 	if (queue->s.head == NULL) {
 		/* Queue is now empty */
@@ -677,6 +761,8 @@ odp_buffer_hdr_t *queue_deq(queue_entry_t *queue)
 
 	UNLOCK(&queue->s.lock);
 
+	TRACE_END(QUEUE_DEQ, 1);
+
 	return buf_hdr;
 }
 
@@ -685,7 +771,8 @@ int queue_deq_multi(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[], int num)
 {
 	odp_buffer_hdr_t *hdr;
 	int i;
-	uint32_t j;
+
+	TRACE_BEGIN(QUEUE_DEQ);
 
 	LOCK(&queue->s.lock);
 	if (odp_unlikely(queue->s.status < QUEUE_STATUS_READY)) {
@@ -710,18 +797,8 @@ int queue_deq_multi(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[], int num)
 		buf_hdr[i]       = hdr;
 		hdr              = hdr->next;
 		buf_hdr[i]->next = NULL;
-		if (queue_is_ordered(queue)) {
-			buf_hdr[i]->origin_qe = queue;
-			buf_hdr[i]->order     = queue->s.order_in++;
-			for (j = 0; j < queue->s.param.sched.lock_count; j++) {
-				buf_hdr[i]->sync[j] =
-					odp_atomic_fetch_inc_u64
-					(&queue->s.sync_in[j]);
-			}
-			buf_hdr[i]->flags.sustain = SUSTAIN_ORDER;
-		} else {
-			buf_hdr[i]->origin_qe = NULL;
-		}
+		if (queue_is_ordered(queue))
+			buf_hdr[i]->order = queue->s.order_in++;
 	}
 
 	queue->s.head = hdr;
@@ -733,6 +810,8 @@ int queue_deq_multi(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[], int num)
 
 	UNLOCK(&queue->s.lock);
 
+	TRACE_END(QUEUE_DEQ, i);
+
 	return i;
 }
 
@@ -747,7 +826,7 @@ int odp_queue_deq_multi(odp_queue_t handle, odp_event_t events[], int num)
 
 	queue = queue_to_qentry(handle);
 
-	ret = queue->s.dequeue_multi(queue, buf_hdr, num);
+	ret = queue_ops[queue->s.ops].dequeue_multi(queue, buf_hdr, num);
 
 	for (i = 0; i < ret; i++)
 		events[i] = odp_buffer_to_event(buf_hdr[i]->handle.handle);
@@ -762,7 +841,7 @@ odp_event_t odp_queue_deq(odp_queue_t handle)
 	odp_buffer_hdr_t *buf_hdr;
 
 	queue   = queue_to_qentry(handle);
-	buf_hdr = queue->s.dequeue(queue);
+	buf_hdr = queue_ops[queue->s.ops].dequeue(queue);
 
 	if (buf_hdr)
 		return odp_buffer_to_event(buf_hdr->handle.handle);
@@ -771,160 +850,31 @@ odp_event_t odp_queue_deq(odp_queue_t handle)
 }
 
 int queue_pktout_enq(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr,
-		     int sustain)
+		     int sustain ODP_UNUSED)
 {
 	queue_entry_t *origin_qe;
 	uint64_t order;
-	int rc;
 
 	/* Special processing needed only if we came from an ordered queue */
-	get_queue_order(&origin_qe, &order, buf_hdr);
+	get_sched_order(&origin_qe, &order);
 	if (!origin_qe)
 		return pktout_enqueue(queue, buf_hdr);
 
-	/* Must lock origin_qe for ordered processing */
-	LOCK(&origin_qe->s.lock);
-	if (odp_unlikely(origin_qe->s.status < QUEUE_STATUS_READY)) {
-		UNLOCK(&origin_qe->s.lock);
-		ODP_ERR("Bad origin queue status\n");
-		return -1;
-	}
-
-	/* We can only complete the enq if we're in order */
-	sched_enq_called();
-	if (order > origin_qe->s.order_out) {
-		reorder_enq(queue, order, origin_qe, buf_hdr, sustain);
-
-		/* This enq can't complete until order is restored, so
-		 * we're done here.
-		 */
-		UNLOCK(&origin_qe->s.lock);
-		return 0;
-	}
-
-	/* Perform our enq since we're in order.
-	 * Note: Don't hold the origin_qe lock across an I/O operation!
-	 */
-	UNLOCK(&origin_qe->s.lock);
-
-	/* Handle any chained buffers (internal calls) */
-	if (buf_hdr->link) {
-		odp_buffer_hdr_t *buf_hdrs[QUEUE_MULTI_MAX];
-		odp_buffer_hdr_t *next_buf;
-		int num = 0;
-
-		next_buf = buf_hdr->link;
-		buf_hdr->link = NULL;
-
-		while (next_buf) {
-			buf_hdrs[num++] = next_buf;
-			next_buf = next_buf->next;
-		}
-
-		rc = pktout_enq_multi(queue, buf_hdrs, num);
-		if (rc < num)
-			return -1;
-	} else {
-		rc = pktout_enqueue(queue, buf_hdr);
-		if (rc)
-			return rc;
-	}
-
-	/* Reacquire the lock following the I/O send. Note that we're still
-	 * guaranteed to be in order here since we haven't released
-	 * order yet.
-	 */
-	LOCK(&origin_qe->s.lock);
-	if (odp_unlikely(origin_qe->s.status < QUEUE_STATUS_READY)) {
-		UNLOCK(&origin_qe->s.lock);
-		ODP_ERR("Bad origin queue status\n");
-		return -1;
-	}
-
-	/* Account for this ordered enq */
-	if (!sustain) {
-		order_release(origin_qe, 1);
-		sched_order_resolved(NULL);
-	}
-
-	/* Now check to see if our successful enq has unblocked other buffers
-	 * in the origin's reorder queue.
-	 */
-	odp_buffer_hdr_t *reorder_buf;
-	odp_buffer_hdr_t *next_buf;
-	odp_buffer_hdr_t *reorder_tail;
-	odp_buffer_hdr_t *xmit_buf;
-	odp_buffer_hdr_t *placeholder_buf;
-	int               release_count, placeholder_count;
-
-	/* Send released buffers as well */
-	if (reorder_deq(queue, origin_qe, &reorder_tail, &placeholder_buf,
-			&release_count, &placeholder_count)) {
-		xmit_buf = origin_qe->s.reorder_head;
-		origin_qe->s.reorder_head = reorder_tail->next;
-		reorder_tail->next = NULL;
-		UNLOCK(&origin_qe->s.lock);
-
-		do {
-			next_buf = xmit_buf->next;
-			pktout_enqueue(queue, xmit_buf);
-			xmit_buf = next_buf;
-		} while (xmit_buf);
-
-		/* Reacquire the origin_qe lock to continue */
-		LOCK(&origin_qe->s.lock);
-		if (odp_unlikely(origin_qe->s.status < QUEUE_STATUS_READY)) {
-			UNLOCK(&origin_qe->s.lock);
-			ODP_ERR("Bad origin queue status\n");
-			return -1;
-		}
-	}
-
-	/* Update the order sequence to reflect the deq'd elements */
-	order_release(origin_qe, release_count + placeholder_count);
-
-	/* Now handle sends to other queues that are ready to go */
-	reorder_complete(origin_qe, &reorder_buf, &placeholder_buf, APPEND);
-
-	/* We're fully done with the origin_qe at last */
-	UNLOCK(&origin_qe->s.lock);
-
-	/* Now send the next buffer to its target queue */
-	if (reorder_buf)
-		queue_enq_internal(reorder_buf);
-
-	/* Free all placeholder bufs that are now released */
-	while (placeholder_buf) {
-		next_buf = placeholder_buf->next;
-		odp_buffer_free(placeholder_buf->handle.handle);
-		placeholder_buf = next_buf;
-	}
-
-	return 0;
+	return reorder_enq(queue, &buf_hdr, 1, origin_qe, order) == 1 ? 0 : -1;
 }
 
 int queue_pktout_enq_multi(queue_entry_t *queue, odp_buffer_hdr_t *buf_hdr[],
-			   int num, int sustain)
+			   int num, int sustain ODP_UNUSED)
 {
-	int i, rc;
 	queue_entry_t *origin_qe;
 	uint64_t order;
 
 	/* If we're not ordered, handle directly */
-	get_queue_order(&origin_qe, &order, buf_hdr[0]);
+	get_sched_order(&origin_qe, &order);
 	if (!origin_qe)
 		return pktout_enq_multi(queue, buf_hdr, num);
 
-	/* Chain input buffers together */
-	for (i = 0; i < num - 1; i++)
-		buf_hdr[i]->next = buf_hdr[i + 1];
-
-	buf_hdr[num - 1]->next = NULL;
-
-	/* Handle commonly via links */
-	buf_hdr[0]->link = buf_hdr[0]->next;
-	rc = queue_pktout_enq(queue, buf_hdr[0], sustain);
-	return rc == 0 ? num : rc;
+	return reorder_enq(queue, buf_hdr, num, origin_qe, order);
 }
 
 void queue_lock(queue_entry_t *queue)
@@ -943,127 +893,6 @@ void odp_queue_param_init(odp_queue_param_t *params)
 	memset(params, 0, sizeof(odp_queue_param_t));
 }
 
-/* These routines exists here rather than in odp_schedule
- * because they operate on queue interenal structures
- */
-int release_order(queue_entry_t *origin_qe, uint64_t order,
-		  odp_pool_t pool, int enq_called)
-{
-	odp_buffer_t placeholder_buf;
-	odp_buffer_hdr_t *placeholder_buf_hdr, *reorder_buf, *next_buf;
-
-	/* Must lock the origin queue to process the release */
-	LOCK(&origin_qe->s.lock);
-
-	/* If we are in order we can release immediately since there can be no
-	 * confusion about intermediate elements
-	 */
-	if (order <= origin_qe->s.order_out) {
-		reorder_buf = origin_qe->s.reorder_head;
-
-		/* We're in order, however there may be one or more events on
-		 * the reorder queue that are part of this order. If that is
-		 * the case, remove them and let ordered_queue_enq() handle
-		 * them and resolve the order for us.
-		 */
-		if (reorder_buf && reorder_buf->order == order) {
-			odp_buffer_hdr_t *reorder_head = reorder_buf;
-
-			next_buf = reorder_buf->next;
-
-			while (next_buf && next_buf->order == order) {
-				reorder_buf = next_buf;
-				next_buf    = next_buf->next;
-			}
-
-			origin_qe->s.reorder_head = reorder_buf->next;
-			reorder_buf->next = NULL;
-
-			UNLOCK(&origin_qe->s.lock);
-			reorder_head->link = reorder_buf->next;
-			return ordered_queue_enq(reorder_head->target_qe,
-						 reorder_head, RESOLVE_ORDER,
-						 origin_qe, order);
-		}
-
-		/* Reorder queue has no elements for this order, so it's safe
-		 * to resolve order here
-		 */
-		order_release(origin_qe, 1);
-
-		/* Check if this release allows us to unblock waiters.  At the
-		 * point of this call, the reorder list may contain zero or
-		 * more placeholders that need to be freed, followed by zero
-		 * or one complete reorder buffer chain. Note that since we
-		 * are releasing order, we know no further enqs for this order
-		 * can occur, so ignore the sustain bit to clear out our
-		 * element(s) on the reorder queue
-		 */
-		reorder_complete(origin_qe, &reorder_buf,
-				 &placeholder_buf_hdr, NOAPPEND);
-
-		/* Now safe to unlock */
-		UNLOCK(&origin_qe->s.lock);
-
-		/* If reorder_buf has a target, do the enq now */
-		if (reorder_buf)
-			queue_enq_internal(reorder_buf);
-
-		while (placeholder_buf_hdr) {
-			odp_buffer_hdr_t *placeholder_next =
-				placeholder_buf_hdr->next;
-
-			odp_buffer_free(placeholder_buf_hdr->handle.handle);
-			placeholder_buf_hdr = placeholder_next;
-		}
-
-		return 0;
-	}
-
-	/* If we are not in order we need a placeholder to represent our
-	 * "place in line" unless we have issued enqs, in which case we
-	 * already have a place in the reorder queue. If we need a
-	 * placeholder, use an element from the same pool we were scheduled
-	 * with is from, otherwise just ensure that the final element for our
-	 * order is not marked sustain.
-	 */
-	if (enq_called) {
-		reorder_buf = NULL;
-		next_buf    = origin_qe->s.reorder_head;
-
-		while (next_buf && next_buf->order <= order) {
-			reorder_buf = next_buf;
-			next_buf = next_buf->next;
-		}
-
-		if (reorder_buf && reorder_buf->order == order) {
-			reorder_buf->flags.sustain = 0;
-			UNLOCK(&origin_qe->s.lock);
-			return 0;
-		}
-	}
-
-	placeholder_buf = odp_buffer_alloc(pool);
-
-	/* Can't release if no placeholder is available */
-	if (odp_unlikely(placeholder_buf == ODP_BUFFER_INVALID)) {
-		UNLOCK(&origin_qe->s.lock);
-		return -1;
-	}
-
-	placeholder_buf_hdr = odp_buf_to_hdr(placeholder_buf);
-
-	/* Copy info to placeholder and add it to the reorder queue */
-	placeholder_buf_hdr->origin_qe     = origin_qe;
-	placeholder_buf_hdr->order         = order;
-	placeholder_buf_hdr->flags.sustain = 0;
-
-	reorder_enq(NULL, order, origin_qe, placeholder_buf_hdr, 0);
-
-	UNLOCK(&origin_qe->s.lock);
-	return 0;
-}
-
 int odp_queue_info(odp_queue_t handle, odp_queue_info_t *info)
 {
 	uint32_t queue_id;
@@ -5,6 +5,11 @@
  */
 
 #include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 #include <odp/schedule.h>
 #include <odp_schedule_internal.h>
 #include <odp/align.h>
@@ -15,6 +20,8 @@
 #include <odp_internal.h>
 #include <odp/config.h>
 #include <odp_debug_internal.h>
+#include <odp_trace_internal.h>
+#include <odp_rcu_internal.h>
 #include <odp/thread.h>
 #include <odp/time.h>
 #include <odp/spinlock.h>
@@ -23,6 +30,7 @@
 #include <odp_queue_internal.h>
 #include <odp_packet_io_internal.h>
 #include <odp_spin_internal.h>
+#include <odp_atomic_internal.h>
 
 odp_thrmask_t sched_mask_all;
 
@@ -36,6 +44,18 @@ odp_thrmask_t sched_mask_all;
 /* Maximum number of dequeues */
 #define MAX_DEQ 4
 
+/* Idle policy defaults: empty polls before pausing and polls with pause
+ * before sleeping. Threads sleep only when given a sleep time. */
+#define IDLE_SPIN_DEF     1000
+#define IDLE_PAUSE_DEF    10000
+
+/* CPU pause instructions between polls in the pause phase */
+#define IDLE_PAUSE_SPINS  16
+
+/* Polls after a sleep even when the wait time has passed: a sleep may
+ * overrun it and packet input takes two rounds (poll, then dequeue) */
+#define IDLE_WAKE_POLLS   2
+
 
 /* Mask of queues per priority */
 typedef uint8_t pri_mask_t;
@@ -58,6 +78,15 @@ typedef struct {
 		char           name[ODP_SCHED_GROUP_NAME_LEN];
 		odp_thrmask_t *mask;
 	} sched_grp[ODP_CONFIG_SCHED_GRPS];
+
+	/* Idle policy, UINT32_MAX: phase not used */
+	uint32_t       idle_spin;
+	uint32_t       idle_pause;
+	uint64_t       idle_sleep_ns;
+
+	/* Idle threads sleep on idle_seq (futex), enqueues wake them */
+	odp_atomic_u32_t idle_seq ODP_ALIGNED_CACHE;
+	odp_atomic_u32_t idle_sleepers;
 } sched_t;
 
 /* Schedule command */
@@ -87,13 +116,13 @@ typedef struct {
 	queue_entry_t *qe;
 	queue_entry_t *origin_qe;
 	uint64_t order;
-	uint64_t sync[ODP_CONFIG_MAX_ORDERED_LOCKS_PER_QUEUE];
-	odp_pool_t pool;
-	int enq_called;
 	int num;
 	int index;
 	int pause;
 	int ignore_ordered_context;
+	uint32_t idle;		/* empty polls since the last event */
+	uint32_t idle_seq;	/* idle_seq when registered as sleeper */
+	int idle_sleeper;	/* registered, polls once more then sleeps */
 } sched_local_t;
 
 /* Global scheduler context */
@@ -122,9 +151,16 @@ int odp_schedule_init_global(void)
 
 	ODP_DBG("Schedule init ... ");
 
+	odp_thrmask_setall(&sched_mask_all);
+
+	if (odp_global_data.secondary) {
+		sched = odp_shm_addr(odp_shm_lookup("odp_scheduler"));
+		return sched ? 0 : -1;
+	}
+
 	shm = odp_shm_reserve("odp_scheduler",
 			      sizeof(sched_t),
-			      ODP_CACHE_LINE_SIZE, 0);
+			      ODP_CACHE_LINE_SIZE, _odp_shm_worker_flags());
 
 	sched = odp_shm_addr(shm);
 
@@ -152,6 +188,28 @@ int odp_schedule_init_global(void)
 	sched->shm  = shm;
 	odp_spinlock_init(&sched->mask_lock);
 
+	sched->idle_spin  = odp_global_data.sched_idle.spin ?
+			    (uint32_t)odp_global_data.sched_idle.spin :
+			    IDLE_SPIN_DEF;
+	sched->idle_pause = odp_global_data.sched_idle.pause ?
+			    (uint32_t)odp_global_data.sched_idle.pause :
+			    IDLE_PAUSE_DEF;
+	sched->idle_sleep_ns = odp_global_data.sched_idle.sleep_ns > 0 ?
+			       (uint64_t)odp_global_data.sched_idle.sleep_ns :
+			       0;
+
+	if (odp_global_data.sched_idle.pause < 0)
+		sched->idle_pause = 0;
+
+	/* Busy poll or pause forever */
+	if (odp_global_data.sched_idle.spin < 0)
+		sched->idle_spin = UINT32_MAX;
+	else if (sched->idle_sleep_ns == 0)
+		sched->idle_pause = UINT32_MAX - sched->idle_spin;
+
+	odp_atomic_init_u32(&sched->idle_seq, 0);
+	odp_atomic_init_u32(&sched->idle_sleepers, 0);
+
 	for (i = 0; i < ODP_CONFIG_SCHED_PRIOS; i++) {
 		odp_queue_t queue;
 		char name[] = "odp_priXX_YY";
@@ -183,8 +241,6 @@ int odp_schedule_init_global(void)
 		sched->sched_grp[i].mask = thread_sched_grp_mask(i);
 	}
 
-	odp_thrmask_setall(&sched_mask_all);
-
 	ODP_DBG("done\n");
 
 	return 0;
@@ -268,6 +324,99 @@ int odp_schedule_term_local(void)
 	return 0;
 }
 
+static long futex(odp_atomic_u32_t *addr, int op, uint32_t val,
+		  const struct timespec *timeout)
+{
+	/* Not private: sleepers of a multi-process instance share it */
+	return syscall(SYS_futex, &addr->v, op, val, timeout, NULL, 0);
+}
+
+/* Wake up idle threads after a schedule command was enqueued. Busy
+ * threads do not sleep, the check is a read of a shared cache line. */
+static inline void sched_wake(void)
+{
+	/* No thread ever sleeps, no barrier either */
+	if (odp_likely(sched->idle_sleep_ns == 0))
+		return;
+
+	/* Orders the enqueue before the sleeper count load, against
+	 * sched_idle() registering before its last poll */
+	odp_mb_full();
+
+	if (odp_likely(odp_atomic_load_u32(&sched->idle_sleepers) == 0))
+		return;
+
+	odp_atomic_inc_u32(&sched->idle_seq);
+	futex(&sched->idle_seq, FUTEX_WAKE, INT_MAX, NULL);
+}
+
+static void sched_idle_cancel(void)
+{
+	odp_atomic_dec_u32(&sched->idle_sleepers);
+	sched_local.idle_sleeper = 0;
+}
+
+/* Idle policy after an empty poll: spin, pause, then sleep until woken
+ * up or the sleep time (or 'next' when not NULL) passes. Returns 1 after
+ * a sleep. */
+static int sched_idle(const odp_time_t *next)
+{
+	struct timespec ts;
+	uint64_t ns;
+	int i;
+
+	if (sched_local.idle_sleeper) {
+		/* Registered and the last poll was empty */
+		ns = sched->idle_sleep_ns;
+
+		if (next) {
+			odp_time_t now = odp_time_local();
+			uint64_t left;
+
+			if (odp_time_cmp(*next, now) < 0)
+				left = 0;
+			else
+				left = odp_time_to_ns(odp_time_diff(*next,
+								    now));
+			if (left < ns)
+				ns = left;
+		}
+
+		ts.tv_sec  = ns / ODP_TIME_SEC_IN_NS;
+		ts.tv_nsec = ns % ODP_TIME_SEC_IN_NS;
+
+		TRACE_BEGIN(SCHEDULE_IDLE);
+		futex(&sched->idle_seq, FUTEX_WAIT, sched_local.idle_seq, &ts);
+		TRACE_END(SCHEDULE_IDLE, ns / 1000);
+
+		sched_idle_cancel();
+		return 1;
+	}
+
+	if (odp_likely(sched_local.idle < sched->idle_spin)) {
+		sched_local.idle++;
+		return 0;
+	}
+
+	if (sched_local.idle - sched->idle_spin < sched->idle_pause) {
+		sched_local.idle++;
+
+		for (i = 0; i < IDLE_PAUSE_SPINS; i++)
+			odp_spin();
+
+		return 0;
+	}
+
+	/* Register as a sleeper and poll once more. An enqueue either
+	 * sees the sleeper and changes idle_seq, or the poll finds it. */
+	sched_local.idle_seq = odp_atomic_load_u32(&sched->idle_seq);
+	odp_atomic_inc_u32(&sched->idle_sleepers);
+	odp_mb_full();
+	sched_local.idle_sleeper = 1;
+
+	return 0;
+}
+
 static int pri_id_queue(odp_queue_t queue)
 {
 	return (QUEUES_PER_PRIO-1) & (queue_to_id(queue));
@@ -379,6 +528,7 @@ int schedule_pktio_start(odp_pktio_t pktio, int prio)
 	if (odp_queue_enq(pri_queue, odp_buffer_to_event(buf)))
 		ODP_ABORT("schedule_pktio_start failed\n");
 
+	sched_wake();
 
 	return 0;
 }
@@ -391,26 +541,22 @@ void odp_schedule_release_atomic(void)
 		if (odp_queue_enq(sched_local.pri_queue, sched_local.cmd_ev))
 			ODP_ABORT("odp_schedule_release_atomic failed\n");
 		sched_local.pri_queue = ODP_QUEUE_INVALID;
+		sched_wake();
 	}
 }
 
 void odp_schedule_release_ordered(void)
 {
 	if (sched_local.origin_qe) {
-		int rc = release_order(sched_local.origin_qe,
-				       sched_local.order,
-				       sched_local.pool,
-				       sched_local.enq_called);
-		if (rc == 0)
-			sched_local.origin_qe = NULL;
+		reorder_release(sched_local.origin_qe, sched_local.order);
+		sched_local.origin_qe = NULL;
 	}
 }
 
 void odp_schedule_release_context(void)
 {
 	if (sched_local.origin_qe) {
-		release_order(sched_local.origin_qe, sched_local.order,
-			      sched_local.pool, sched_local.enq_called);
+		reorder_release(sched_local.origin_qe, sched_local.order);
 		sched_local.origin_qe = NULL;
 	} else
 		odp_schedule_release_atomic();
@@ -441,7 +587,6 @@ static int schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
 	int i, j;
 	int thr;
 	int ret;
-	uint32_t k;
 
 	if (sched_local.num) {
 		ret = copy_events(out_ev, max_num);
@@ -492,6 +637,13 @@ static int schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
 			sched_cmd = odp_buffer_addr(buf);
 
 			if (sched_cmd->cmd == SCHED_CMD_POLL_PKTIN) {
+				/* Packet input belongs to the primary */
+				if (odp_unlikely(odp_global_data.secondary)) {
+					if (odp_queue_enq(pri_q, ev))
+						ODP_ABORT("schedule failed\n");
+					continue;
+				}
+
 				/* Poll packet input */
 				if (pktin_poll(sched_cmd->pe)) {
 					/* Stop scheduling the pktio */
@@ -553,15 +705,6 @@ static int schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
 				sched_local.origin_qe = qe;
 				sched_local.order =
 					sched_local.buf_hdr[0]->order;
-				sched_local.pool =
-					sched_local.buf_hdr[0]->pool_hdl;
-				for (k = 0;
-				     k < qe->s.param.sched.lock_count;
-				     k++) {
-					sched_local.sync[k] =
-						sched_local.buf_hdr[0]->sync[k];
-				}
-				sched_local.enq_called = 0;
 			} else if (queue_is_atomic(qe)) {
 				/* Hold queue during atomic access */
 				sched_local.pri_queue = pri_q;
@@ -590,16 +733,27 @@ static int schedule_loop(odp_queue_t *out_queue, uint64_t wait,
 {
 	odp_time_t next, wtime;
 	int first = 1;
+	int woken = 0;
 	int ret;
 
 	while (1) {
+		/* The thread holds no references from previous events */
+		_odp_rcu_quiescent();
+
+		TRACE_BEGIN(SCHEDULE);
+
 		ret = schedule(out_queue, out_ev, max_num, max_deq);
 
-		if (ret)
+		if (ret) {
+			TRACE_END(SCHEDULE, ret);
+			sched_local.idle = 0;
 			break;
+		}
 
-		if (wait == ODP_SCHED_WAIT)
+		if (wait == ODP_SCHED_WAIT) {
+			sched_idle(NULL);
 			continue;
+		}
 
 		if (wait == ODP_SCHED_NO_WAIT)
 			break;
@@ -611,10 +765,20 @@ static int schedule_loop(odp_queue_t *out_queue, uint64_t wait,
 			continue;
 		}
 
-		if (odp_time_cmp(next, odp_time_local()) < 0)
-			break;
+		if (odp_time_cmp(next, odp_time_local()) < 0) {
+			if (woken == 0)
+				break;
+
+			woken--;
+			continue;
+		}
+
+		woken = sched_idle(&next) ? IDLE_WAKE_POLLS : 0;
 	}
 
+	if (odp_unlikely(sched_local.idle_sleeper))
+		sched_idle_cancel();
+
 	return ret;
 }
 
@@ -797,44 +961,37 @@ void odp_schedule_prefetch(int num ODP_UNUSED)
 void odp_schedule_order_lock(unsigned lock_index)
 {
 	queue_entry_t *origin_qe;
-	uint64_t sync, sync_out;
+	odp_atomic_u64_t *lock;
 
 	origin_qe = sched_local.origin_qe;
 	if (!origin_qe || lock_index >= origin_qe->s.param.sched.lock_count)
 		return;
 
-	sync = sched_local.sync[lock_index];
-	sync_out = odp_atomic_load_u64(&origin_qe->s.sync_out[lock_index]);
-	ODP_ASSERT(sync >= sync_out);
+	lock = &origin_qe->s.reorder.lock[lock_index];
+	ODP_ASSERT(sched_local.order >= odp_atomic_load_u64(lock));
 
-	/* Wait until we are in order. Note that sync_out will be incremented
-	 * both by unlocks as well as order resolution, so we're OK if only
-	 * some events in the ordered flow need to lock.
-	 */
-	while (sync != sync_out) {
+	/* Wait for our ticket. The lock is passed on by unlocks and, for
+	 * orders that do not take it, by the reorder window drain. */
+	while (_odp_atomic_u64_load_mm(lock, _ODP_MEMMODEL_ACQ) !=
+	       sched_local.order)
 		odp_spin();
-		sync_out =
-			odp_atomic_load_u64(&origin_qe->s.sync_out[lock_index]);
-	}
 }
 
 void odp_schedule_order_unlock(unsigned lock_index)
 {
 	queue_entry_t *origin_qe;
+	odp_atomic_u64_t *lock;
 
 	origin_qe = sched_local.origin_qe;
 	if (!origin_qe || lock_index >= origin_qe->s.param.sched.lock_count)
 		return;
-	ODP_ASSERT(sched_local.sync[lock_index] ==
-		   odp_atomic_load_u64(&origin_qe->s.sync_out[lock_index]));
 
-	/* Release the ordered lock */
-	odp_atomic_fetch_inc_u64(&origin_qe->s.sync_out[lock_index]);
-}
+	lock = &origin_qe->s.reorder.lock[lock_index];
+	ODP_ASSERT(sched_local.order == odp_atomic_load_u64(lock));
 
-void sched_enq_called(void)
-{
-	sched_local.enq_called = 1;
+	/* Release the ordered lock */
+	_odp_atomic_u64_store_mm(lock, sched_local.order + 1,
+				 _ODP_MEMMODEL_RLS);
 }
 
 void get_sched_order(queue_entry_t **origin_qe, uint64_t *order)
@@ -848,15 +1005,13 @@ void get_sched_order(queue_entry_t **origin_qe, uint64_t *order)
 	}
 }
 
-void sched_order_resolved(odp_buffer_hdr_t *buf_hdr)
-{
-	if (buf_hdr)
-		buf_hdr->origin_qe = NULL;
-	sched_local.origin_qe = NULL;
-}
-
 int schedule_queue(const queue_entry_t *qe)
 {
+	int ret;
+
 	sched_local.ignore_ordered_context = 1;
-	return odp_queue_enq(qe->s.pri_queue, qe->s.cmd_ev);
+	ret = odp_queue_enq(qe->s.pri_queue, qe->s.cmd_ev);
+	sched_wake();
+
+	return ret;
 }
@@ -4,8 +4,8 @@
  * SPDX-License-Identifier:     BSD-3-Clause
  */
 
-/*ftruncate _POSIX_C_SOURCE 200809L */
-#define _POSIX_C_SOURCE 200809L
+/* ftruncate, syscall, sched_getaffinity, MAP_FIXED_NOREPLACE */
+#define _GNU_SOURCE
 
 #include <odp/shared_memory.h>
 #include <odp_internal.h>
@@ -18,10 +18,15 @@
 #include <odp/config.h>
 
 #include <unistd.h>
+#include <sched.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <asm/mman.h>
+#include <linux/mempolicy.h>
+#include <sys/vfs.h>
 #include <fcntl.h>
+#include <signal.h>
 
 #include <stdio.h>
 #include <string.h>
@@ -30,6 +35,9 @@
 _ODP_STATIC_ASSERT(ODP_CONFIG_SHM_BLOCKS >= ODP_CONFIG_POOLS,
 		   "ODP_CONFIG_SHM_BLOCKS < ODP_CONFIG_POOLS");
 
+/* Max length of backing file paths of instance blocks */
+#define SHM_PATH_LEN 96
+
 typedef struct {
 	char      name[ODP_SHM_NAME_LEN];
 	uint64_t  size;
@@ -41,7 +49,13 @@ typedef struct {
 	odp_shm_t hdl;
 	uint32_t  flags;
 	uint64_t  page_sz;
+	uint64_t  req_page_sz;	/* requested page size */
+	int       numa_req;	/* requested NUMA node, -1 if none */
+	int       numa_bound;	/* memory policy set to numa_req */
 	int       fd;
+	uint32_t  gen;		/* instance generation of the reserve */
+	char      path[SHM_PATH_LEN];	/* file other processes map */
+	int       unlink;	/* path is removed when the block is freed */
 
 } odp_shm_block_t;
 
@@ -50,17 +64,86 @@ typedef struct {
 	odp_shm_block_t block[ODP_CONFIG_SHM_BLOCKS];
 	odp_spinlock_t  lock;
 
+	/* Multi-process instance */
+	uint32_t        gen;		/* incremented on reserve and free */
+	int             ready;		/* primary completed init */
+	pid_t           primary;	/* primary process */
+	uint64_t        base;		/* address window of all blocks */
+	uint64_t        window_size;
+
 } odp_shm_table_t;
 
 
+/* Mapping of an instance block in this process */
+typedef struct {
+	uint32_t  gen;		/* generation of the mapped block, 0 if none */
+	int       fd;		/* memfd created by this process, or -1 */
+	void      *addr;
+	uint64_t  size;
+
+} shm_local_t;
+
+
+/* Process local state of a multi-process instance */
+typedef struct {
+	int         mp;		/* blocks are shared with other processes */
+	char        name[SHM_PATH_LEN];	/* shm_open() name of the table */
+	uint32_t    gen;	/* table generation seen by shm_sync() */
+	shm_local_t block[ODP_CONFIG_SHM_BLOCKS];
+
+} shm_proc_t;
+
+
 #ifndef MAP_ANONYMOUS
 #define MAP_ANONYMOUS MAP_ANON
 #endif
 
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+#define SHM_PAGE_2M (2 * 1024 * 1024ULL)
+#define SHM_PAGE_1G (1024 * 1024 * 1024ULL)
+
+/* Page sizes tried by one reserve */
+#define SHM_MAX_PAGE_SIZES 3
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE 0x100000
+#endif
+
+#ifndef MFD_HUGETLB
+#define MFD_HUGETLB 0x0004U
+#endif
+
+#ifndef MFD_HUGE_SHIFT
+#define MFD_HUGE_SHIFT 26
+#endif
+
+/* Hugetlbfs mount used when memfd cannot allocate huge pages */
+#define SHM_HUGETLBFS "/dev/hugepages"
+
+/* Address window of a multi-process instance. Every process maps the
+ * blocks at the same addresses, so that pointers stored in shared memory
+ * (buffer headers, queue links) stay valid in all of them. */
+#if UINTPTR_MAX > 0xffffffff
+#define SHM_MP_BASE        0x100000000000ULL
+#define SHM_MP_WINDOW_SIZE (256 * SHM_PAGE_1G)
+#else
+#define SHM_MP_BASE        0x40000000ULL
+#define SHM_MP_WINDOW_SIZE (1 * SHM_PAGE_1G)
+#endif
+
 
 /* Global shared memory table */
 static odp_shm_table_t *odp_shm_tbl;
 
+/* Placement flags for memory used by worker threads */
+static uint32_t shm_worker_flags;
+
+/* Multi-process instance state of this process */
+static shm_proc_t shm_proc;
+
 
 static inline uint32_t from_handle(odp_shm_t shm)
 {
@@ -74,14 +157,342 @@ static inline odp_shm_t to_handle(uint32_t index)
 }
 
 
+/*
+ * Node of the worker CPUs, when all CPUs available to the process are on
+ * the same node of a NUMA system
+ */
+static int shm_worker_node(void)
+{
+	cpu_set_t cpuset;
+	int cpu, cpu_node, node = -1;
+
+	if (odp_global_data.system_info.numa_nodes < 2)
+		return -1;
+
+	if (sched_getaffinity(0, sizeof(cpuset), &cpuset))
+		return -1;
+
+	for (cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+		if (!CPU_ISSET(cpu, &cpuset))
+			continue;
+
+		cpu_node = odp_cpu_numa_node(cpu);
+		if (cpu_node < 0 || (node >= 0 && cpu_node != node))
+			return -1;
+
+		node = cpu_node;
+	}
+
+	return node;
+}
+
+uint32_t _odp_shm_worker_flags(void)
+{
+	return shm_worker_flags;
+}
+
+/* Reserve an address range without backing memory */
+static void *shm_window_reserve(void *hint, uint64_t size)
+{
+	void *addr;
+
+	addr = mmap(hint, size, PROT_NONE,
+		    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE |
+		    (hint ? MAP_FIXED_NOREPLACE : 0), -1, 0);
+
+	if (addr == MAP_FAILED)
+		return NULL;
+
+	/* Kernels before 4.17 take the address only as a hint */
+	if (hint && addr != hint) {
+		munmap(addr, size);
+		return NULL;
+	}
+
+	return addr;
+}
+
+/* Return a range of the instance window to the reserved state */
+static void shm_window_release(void *addr, uint64_t size)
+{
+	if (mmap(addr, size, PROT_NONE,
+		 MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED,
+		 -1, 0) == MAP_FAILED)
+		ODP_ERR("unable to release %p: %s\n", addr, strerror(errno));
+}
+
+/* Lowest free range of the instance window, aligned to the page size */
+static void *shm_window_alloc(uint64_t size, uint64_t page_sz)
+{
+	uint64_t end = odp_shm_tbl->base + odp_shm_tbl->window_size;
+	uint64_t start = ODP_ALIGN_ROUNDUP(odp_shm_tbl->base, page_sz);
+	uint64_t b_start, b_end;
+	uint32_t i;
+
+	for (i = 0; i < ODP_CONFIG_SHM_BLOCKS; i++) {
+		odp_shm_block_t *block = &odp_shm_tbl->block[i];
+
+		if (block->addr == NULL)
+			continue;
+
+		b_start = (uintptr_t)block->addr_orig;
+		b_end   = b_start + block->alloc_size;
+
+		if (start < b_end && b_start < start + size) {
+			/* Overlap, retry after the block */
+			start = ODP_ALIGN_ROUNDUP(b_end, page_sz);
+			i = -1;
+		}
+	}
+
+	if (start + size > end)
+		return NULL;
+
+	return (void *)(uintptr_t)start;
+}
+
+/* Remove the mapping of a block from this process */
+static void shm_local_unmap(uint32_t index)
+{
+	shm_local_t *local = &shm_proc.block[index];
+
+	shm_window_release(local->addr, local->size);
+
+	if (local->fd != -1)
+		close(local->fd);
+
+	local->gen = 0;
+	local->fd  = -1;
+}
+
+/* Map a block reserved by another process of the instance */
+static int shm_local_map(uint32_t index)
+{
+	odp_shm_block_t *block = &odp_shm_tbl->block[index];
+	shm_local_t *local = &shm_proc.block[index];
+	void *addr;
+	int fd;
+
+	fd = open(block->path, O_RDWR);
+	if (fd == -1) {
+		ODP_ERR("%s: cannot open %s: %s\n", block->name, block->path,
+			strerror(errno));
+		return -1;
+	}
+
+	addr = mmap(block->addr_orig, block->alloc_size,
+		    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+	close(fd);
+
+	if (addr == MAP_FAILED) {
+		ODP_ERR("%s: mmap failed: %s\n", block->name, strerror(errno));
+		shm_window_release(block->addr_orig, block->alloc_size);
+		return -1;
+	}
+
+	local->gen  = block->gen;
+	local->addr = addr;
+	local->size = block->alloc_size;
+
+	return 0;
+}
+
+/*
+ * Bring the mappings of this process up to date with the instance table:
+ * map blocks reserved and unmap blocks freed by other processes. Called
+ * with the table lock held.
+ */
+static void shm_sync(void)
+{
+	odp_shm_block_t *block;
+	shm_local_t *local;
+	uint32_t i;
+
+	if (!shm_proc.mp || shm_proc.gen == odp_shm_tbl->gen)
+		return;
+
+	for (i = 0; i < ODP_CONFIG_SHM_BLOCKS; i++) {
+		block = &odp_shm_tbl->block[i];
+		local = &shm_proc.block[i];
+
+		if (local->gen == block->gen)
+			continue;
+
+		if (local->gen)
+			shm_local_unmap(i);
+
+		if (block->gen)
+			shm_local_map(i);
+	}
+
+	shm_proc.gen = odp_shm_tbl->gen;
+}
+
+/* Map blocks reserved since the last call */
+void _odp_shm_sync(void)
+{
+	if (!shm_proc.mp || shm_proc.gen == odp_shm_tbl->gen)
+		return;
+
+	odp_spinlock_lock(&odp_shm_tbl->lock);
+	shm_sync();
+	odp_spinlock_unlock(&odp_shm_tbl->lock);
+}
+
+void _odp_shm_instance_ready(void)
+{
+	if (shm_proc.mp && !odp_global_data.secondary)
+		odp_shm_tbl->ready = 1;
+}
+
+/*
+ * Create (primary) or attach to (secondary) the table of a multi-process
+ * instance. The table is a named shm file, blocks are mapped from files
+ * into an address window at the same addresses in every process.
+ */
+static int shm_instance_init(void)
+{
+	odp_shm_table_t *tbl;
+	struct stat st;
+	void *base;
+	int secondary = odp_global_data.secondary;
+	int oflag = secondary ? O_RDWR : O_RDWR | O_CREAT | O_TRUNC;
+	int fd;
+	uint32_t i;
+
+	snprintf(shm_proc.name, sizeof(shm_proc.name), "odp_%s",
+		 odp_global_data.instance);
+
+	fd = shm_open(shm_proc.name, oflag, S_IRUSR | S_IWUSR);
+	if (fd == -1) {
+		ODP_ERR("%s: shm_open failed: %s\n", shm_proc.name,
+			strerror(errno));
+		return -1;
+	}
+
+	if (!secondary && ftruncate(fd, sizeof(odp_shm_table_t)) == -1) {
+		ODP_ERR("%s: ftruncate failed.\n", shm_proc.name);
+		close(fd);
+		return -1;
+	}
+
+	if (secondary &&
+	    (fstat(fd, &st) || st.st_size != sizeof(odp_shm_table_t))) {
+		ODP_ERR("%s: not an instance of this ODP version\n",
+			shm_proc.name);
+		close(fd);
+		return -1;
+	}
+
+	tbl = mmap(NULL, sizeof(odp_shm_table_t), PROT_READ | PROT_WRITE,
+		   MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (tbl == MAP_FAILED)
+		return -1;
+
+	memset(&shm_proc.block, 0, sizeof(shm_proc.block));
+	for (i = 0; i < ODP_CONFIG_SHM_BLOCKS; i++)
+		shm_proc.block[i].fd = -1;
+
+	if (!secondary) {
+		memset(tbl, 0, sizeof(odp_shm_table_t));
+		odp_spinlock_init(&tbl->lock);
+
+		base = shm_window_reserve((void *)(uintptr_t)SHM_MP_BASE,
+					  SHM_MP_WINDOW_SIZE);
+		if (base == NULL)
+			base = shm_window_reserve(NULL, SHM_MP_WINDOW_SIZE);
+
+		if (base == NULL) {
+			ODP_ERR("%s: cannot reserve address window\n",
+				shm_proc.name);
+			goto error;
+		}
+
+		tbl->primary     = getpid();
+		tbl->base        = (uintptr_t)base;
+		tbl->window_size = SHM_MP_WINDOW_SIZE;
+	} else {
+		if (!tbl->ready ||
+		    (kill(tbl->primary, 0) == -1 && errno == ESRCH)) {
+			ODP_ERR("%s: primary process is not running\n",
+				shm_proc.name);
+			goto error;
+		}
+
+		base = shm_window_reserve((void *)(uintptr_t)tbl->base,
+					  tbl->window_size);
+		if (base == NULL) {
+			ODP_ERR("%s: address window 0x%" PRIx64 " is in use\n",
+				shm_proc.name, tbl->base);
+			goto error;
+		}
+	}
+
+	odp_shm_tbl = tbl;
+	shm_proc.mp  = 1;
+	shm_proc.gen = 0;
+
+	odp_spinlock_lock(&tbl->lock);
+	shm_sync();
+	odp_spinlock_unlock(&tbl->lock);
+
+	ODP_DBG("%s instance %s, address window %p\n",
+		secondary ? "Attached to" : "Created", odp_global_data.instance,
+		base);
+
+	return 0;
+
+error:
+	munmap(tbl, sizeof(odp_shm_table_t));
+	if (!secondary)
+		shm_unlink(shm_proc.name);
+	return -1;
+}
+
+static int shm_instance_term(void)
+{
+	uint32_t i;
+	int ret;
+
+	for (i = 0; i < ODP_CONFIG_SHM_BLOCKS; i++)
+		if (shm_proc.block[i].fd != -1)
+			close(shm_proc.block[i].fd);
+
+	munmap((void *)(uintptr_t)odp_shm_tbl->base,
+	       odp_shm_tbl->window_size);
+
+	if (!odp_global_data.secondary) {
+		odp_shm_tbl->ready = 0;
+		if (shm_unlink(shm_proc.name))
+			ODP_ERR("%s: shm_unlink failed\n", shm_proc.name);
+	}
+
+	shm_proc.mp = 0;
+
+	ret = munmap(odp_shm_tbl, sizeof(odp_shm_table_t));
+	if (ret)
+		ODP_ERR("unable to munmap\n.");
+
+	return ret;
+}
+
 int odp_shm_init_global(void)
 {
 	void *addr;
+	int node;
 
 #ifndef MAP_HUGETLB
 	ODP_DBG("NOTE: mmap does not support huge pages\n");
 #endif
 
+	node = shm_worker_node();
+	shm_worker_flags = node >= 0 ? ODP_SHM_NODE(node) : 0;
+
+	if (odp_global_data.instance[0])
+		return shm_instance_init();
+
 	addr = mmap(NULL, sizeof(odp_shm_table_t),
 		    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
 
@@ -100,6 +511,9 @@ int odp_shm_term_global(void)
 {
 	int ret;
 
+	if (shm_proc.mp)
+		return shm_instance_term();
+
 	ret = munmap(odp_shm_tbl, sizeof(odp_shm_table_t));
 	if (ret)
 		ODP_ERR("unable to munmap\n.");
@@ -110,6 +524,7 @@ int odp_shm_term_global(void)
 
 int odp_shm_init_local(void)
 {
+	_odp_shm_sync();
 	return 0;
 }
 
@@ -159,12 +574,25 @@ int odp_shm_free(odp_shm_t shm)
 		return 0;
 	}
 
-	ret = munmap(block->addr_orig, block->alloc_size);
-	if (0 != ret) {
-		ODP_DBG("odp_shm_free: munmap failed: %s, id %u, addr %p\n",
-			strerror(errno), i, block->addr_orig);
-		odp_spinlock_unlock(&odp_shm_tbl->lock);
-		return -1;
+	if (shm_proc.mp) {
+		/* Other processes unmap the block on their next sync */
+		shm_sync();
+		if (shm_proc.block[i].gen)
+			shm_local_unmap(i);
+		if (block->unlink && unlink(block->path))
+			ODP_DBG("odp_shm_free: unlink %s failed\n",
+				block->path);
+		odp_shm_tbl->gen++;
+		shm_proc.gen = odp_shm_tbl->gen;
+	} else {
+		ret = munmap(block->addr_orig, block->alloc_size);
+		if (0 != ret) {
+			ODP_DBG("odp_shm_free: munmap failed: %s, id %u, "
+				"addr %p\n", strerror(errno), i,
+				block->addr_orig);
+			odp_spinlock_unlock(&odp_shm_tbl->lock);
+			return -1;
+		}
 	}
 
 	if (block->flags & ODP_SHM_PROC) {
@@ -180,32 +608,159 @@ int odp_shm_free(odp_shm_t shm)
 	return 0;
 }
 
+/* Page sizes to try, largest first */
+static int shm_page_sizes(uint32_t flags, uint64_t alloc_size,
+			  uint64_t page_sz[])
+{
+	int num = 0;
+#ifdef MAP_HUGETLB
+	uint64_t huge_sz = odp_sys_huge_page_size();
+
+	if (flags & ODP_SHM_PAGE_1G)
+		page_sz[num++] = SHM_PAGE_1G;
+
+	if (flags & (ODP_SHM_PAGE_1G | ODP_SHM_PAGE_2M))
+		page_sz[num++] = SHM_PAGE_2M;
+	else if (!(flags & ODP_SHM_PAGE_4K) && huge_sz &&
+		 alloc_size > odp_sys_page_size())
+		page_sz[num++] = huge_sz;
+#else
+	(void)flags;
+	(void)alloc_size;
+#endif
+	page_sz[num++] = odp_sys_page_size();
+
+	return num;
+}
+
+static int shm_map_flags(uint32_t flags, uint64_t page_sz)
+{
+#ifdef MAP_HUGETLB
+	if (page_sz <= odp_sys_page_size())
+		return 0;
+
+	/* Without a page size flag, the default huge page size is used */
+	if (!(flags & (ODP_SHM_PAGE_1G | ODP_SHM_PAGE_2M)))
+		return MAP_HUGETLB;
+
+	return MAP_HUGETLB |
+	       ((63 - __builtin_clzll(page_sz)) << MAP_HUGE_SHIFT);
+#else
+	(void)flags;
+	(void)page_sz;
+	return 0;
+#endif
+}
+
+/* NUMA node the calling thread runs on */
+static int shm_local_node(void)
+{
+	unsigned cpu, node;
+
+	if (syscall(__NR_getcpu, &cpu, &node, NULL))
+		return -1;
+
+	return node;
+}
+
+/* Prefer allocating pages of a range from a node */
+static int shm_mbind(void *addr, uint64_t len, int node)
+{
+	unsigned long nodemask[256 / (8 * sizeof(unsigned long))];
+
+	memset(nodemask, 0, sizeof(nodemask));
+	nodemask[node / (8 * sizeof(unsigned long))] =
+		1UL << (node % (8 * sizeof(unsigned long)));
+
+	return syscall(__NR_mbind, addr, len, MPOL_PREFERRED, nodemask,
+		       8 * sizeof(nodemask), 0);
+}
+
+/* NUMA node of the page at an address, faults the page in */
+static int shm_page_node(void *addr)
+{
+	int node;
+
+	if (syscall(__NR_get_mempolicy, &node, NULL, 0, addr,
+		    MPOL_F_NODE | MPOL_F_ADDR))
+		return -1;
+
+	return node;
+}
+
+/* Create the file backing a block of a multi-process instance */
+static int shm_file_create(odp_shm_block_t *block, const char *name,
+			   uint32_t index, uint64_t page_sz)
+{
+	unsigned int mfd_flags = 0;
+	struct statfs fs;
+	int fd = -1;
+
+	block->unlink = 0;
+
+	if (page_sz > odp_sys_page_size())
+		mfd_flags = MFD_HUGETLB |
+			    ((63 - __builtin_clzll(page_sz)) << MFD_HUGE_SHIFT);
+
+#ifdef __NR_memfd_create
+	fd = syscall(__NR_memfd_create, name, mfd_flags);
+#endif
+	if (fd != -1) {
+		/* Other processes open the file through the creator */
+		snprintf(block->path, SHM_PATH_LEN, "/proc/%d/fd/%d",
+			 getpid(), fd);
+		return fd;
+	}
+
+	if (mfd_flags == 0)
+		return -1;
+
+	/* Kernels before 4.14 allocate huge pages only from hugetlbfs */
+	snprintf(block->path, SHM_PATH_LEN, SHM_HUGETLBFS "/odp_%s_%u",
+		 odp_global_data.instance, index);
+
+	fd = open(block->path, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+	if (fd == -1)
+		return -1;
+
+	if (fstatfs(fd, &fs) || (uint64_t)fs.f_bsize != page_sz) {
+		close(fd);
+		unlink(block->path);
+		return -1;
+	}
+
+	block->unlink = 1;
+	return fd;
+}
+
+static void shm_file_close(odp_shm_block_t *block, int fd)
+{
+	if (fd == -1)
+		return;
+
+	close(fd);
+	if (block->unlink)
+		unlink(block->path);
+	block->unlink = 0;
+}
+
 odp_shm_t odp_shm_reserve(const char *name, uint64_t size, uint64_t align,
 			  uint32_t flags)
 {
 	uint32_t i;
 	odp_shm_block_t *block;
-	void *addr;
+	void *addr, *fixed;
 	int fd = -1;
+	int mp_fd, map_fd;
 	int map_flag = MAP_SHARED;
 	/* If already exists: O_EXCL: error, O_TRUNC: truncate to zero */
 	int oflag = O_RDWR | O_CREAT | O_TRUNC;
-	uint64_t alloc_size;
-	uint64_t page_sz, huge_sz;
-#ifdef MAP_HUGETLB
-	int need_huge_page = 0;
-	uint64_t alloc_hp_size;
-#endif
+	uint64_t alloc_size, map_size, off;
+	uint64_t page_sz[SHM_MAX_PAGE_SIZES];
+	int num_page_sz, p;
 
-	page_sz = odp_sys_page_size();
 	alloc_size = size + align;
-
-#ifdef MAP_HUGETLB
-	huge_sz = odp_sys_huge_page_size();
-	need_huge_page =  (huge_sz && alloc_size > page_sz);
-	/* munmap for huge pages requires sizes round up by page */
-	alloc_hp_size = (size + align + (huge_sz - 1)) & (-huge_sz);
-#endif
+	num_page_sz = shm_page_sizes(flags, alloc_size, page_sz);
 
 	if (flags & ODP_SHM_PROC) {
 		/* Creates a file to /dev/shm */
@@ -215,11 +770,12 @@ odp_shm_t odp_shm_reserve(const char *name, uint64_t size, uint64_t align,
 			ODP_DBG("%s: shm_open failed.\n", name);
 			return ODP_SHM_INVALID;
 		}
-	} else {
+	} else if (!shm_proc.mp) {
 		map_flag |= MAP_ANONYMOUS;
 	}
 
 	odp_spinlock_lock(&odp_shm_tbl->lock);
+	shm_sync();
 
 	if (find_block(name, NULL)) {
 		/* Found a block with the same name */
@@ -247,50 +803,90 @@ odp_shm_t odp_shm_reserve(const char *name, uint64_t size, uint64_t align,
 	block->hdl  = to_handle(i);
 	addr        = MAP_FAILED;
 
-#ifdef MAP_HUGETLB
-	/* Try first huge pages */
-	if (need_huge_page) {
-		if ((flags & ODP_SHM_PROC) &&
-		    (ftruncate(fd, alloc_hp_size) == -1)) {
-			odp_spinlock_unlock(&odp_shm_tbl->lock);
-			ODP_DBG("%s: ftruncate huge pages failed.\n", name);
-			return ODP_SHM_INVALID;
+	/* Try huge pages first, normal pages are the last choice */
+	for (p = 0; p < num_page_sz && addr == MAP_FAILED; p++) {
+		/* munmap for huge pages requires sizes round up by page */
+		map_size = (alloc_size + page_sz[p] - 1) & (-page_sz[p]);
+		fixed    = NULL;
+		mp_fd    = -1;
+
+		if (shm_proc.mp) {
+			/* Same address in all processes of the instance */
+			fixed = shm_window_alloc(map_size, page_sz[p]);
+			if (fixed == NULL) {
+				ODP_DBG("%s: instance address window full.\n",
+					name);
+				continue;
+			}
+
+			if (!(flags & ODP_SHM_PROC)) {
+				mp_fd = shm_file_create(block, name, i,
+							page_sz[p]);
+				if (mp_fd == -1)
+					continue;
+			}
+		}
+
+		map_fd = mp_fd != -1 ? mp_fd : fd;
+
+		if (map_fd != -1 && ftruncate(map_fd, map_size) == -1) {
+			ODP_DBG("%s: ftruncate failed.\n", name);
+			shm_file_close(block, mp_fd);
+			continue;
 		}
 
-		addr = mmap(NULL, alloc_hp_size, PROT_READ | PROT_WRITE,
-				map_flag | MAP_HUGETLB, fd, 0);
+		addr = mmap(fixed, map_size, PROT_READ | PROT_WRITE,
+			    map_flag | (fixed ? MAP_FIXED : 0) |
+			    (mp_fd == -1 ? shm_map_flags(flags, page_sz[p]) : 0),
+			    map_fd, 0);
 		if (addr == MAP_FAILED) {
-			ODP_DBG(" %s:\n"
-				"\tNo huge pages, fall back to normal pages,\n"
-				"\tcheck: /proc/sys/vm/nr_hugepages.\n", name);
-		} else {
-			block->alloc_size = alloc_hp_size;
-			block->huge = 1;
-			block->page_sz = huge_sz;
+			if (fixed)
+				shm_window_release(fixed, map_size);
+			shm_file_close(block, mp_fd);
+			if (p < num_page_sz - 1)
+				ODP_DBG(" %s:\n"
+					"\tNo %" PRIu64 " kB pages, fall back "
+					"to %" PRIu64 " kB pages,\n"
+					"\tcheck: /proc/sys/vm/nr_hugepages.\n",
+					name, page_sz[p] / 1024,
+					page_sz[p + 1] / 1024);
+			continue;
 		}
+
+		block->alloc_size = map_size;
+		block->huge = page_sz[p] > odp_sys_page_size();
+		block->page_sz = page_sz[p];
+		shm_proc.block[i].fd = mp_fd;
 	}
-#endif
 
-	/* Use normal pages for small or failed huge page allocations */
 	if (addr == MAP_FAILED) {
-		if ((flags & ODP_SHM_PROC) &&
-		    (ftruncate(fd, alloc_size) == -1)) {
-			odp_spinlock_unlock(&odp_shm_tbl->lock);
-			ODP_ERR("%s: ftruncate failed.\n", name);
-			return ODP_SHM_INVALID;
-		}
+		odp_spinlock_unlock(&odp_shm_tbl->lock);
+		ODP_DBG("%s mmap failed.\n", name);
+		return ODP_SHM_INVALID;
+	}
 
-		addr = mmap(NULL, alloc_size, PROT_READ | PROT_WRITE,
-				map_flag, fd, 0);
-		if (addr == MAP_FAILED) {
-			odp_spinlock_unlock(&odp_shm_tbl->lock);
-			ODP_DBG("%s mmap failed.\n", name);
-			return ODP_SHM_INVALID;
-		} else {
-			block->alloc_size = alloc_size;
-			block->huge = 0;
-			block->page_sz = page_sz;
-		}
+	block->req_page_sz = page_sz[0];
+	block->numa_req    = -1;
+	block->numa_bound  = 0;
+
+	/* Pages are placed when first touched, set the policy before */
+	if (flags & ODP_SHM_NUMA_NODE)
+		block->numa_req = ODP_SHM_NODE_GET(flags);
+	else if (flags & ODP_SHM_NUMA_LOCAL)
+		block->numa_req = shm_local_node();
+
+	if (block->numa_req >= 0) {
+		if (shm_mbind(addr, block->alloc_size, block->numa_req) == 0)
+			block->numa_bound = 1;
+		else
+			ODP_DBG(" %s:\n"
+				"\tCannot place on NUMA node %i: %s\n",
+				name, block->numa_req, strerror(errno));
+	}
+
+	if (flags & ODP_SHM_PREFAULT) {
+		for (off = 0; off < block->alloc_size; off += block->page_sz)
+			((volatile uint8_t *)addr)[off] = 0;
 	}
 
 	block->addr_orig = addr;
@@ -306,6 +902,21 @@ odp_shm_t odp_shm_reserve(const char *name, uint64_t size, uint64_t align,
 	block->fd         = fd;
 	block->addr       = addr;
 
+	if (shm_proc.mp) {
+		if (flags & ODP_SHM_PROC)
+			snprintf(block->path, SHM_PATH_LEN, "/dev/shm/%s",
+				 name);
+
+		if (++odp_shm_tbl->gen == 0)
+			odp_shm_tbl->gen = 1;
+
+		block->gen = odp_shm_tbl->gen;
+		shm_proc.gen = odp_shm_tbl->gen;
+		shm_proc.block[i].gen  = block->gen;
+		shm_proc.block[i].addr = block->addr_orig;
+		shm_proc.block[i].size = block->alloc_size;
+	}
+
 	odp_spinlock_unlock(&odp_shm_tbl->lock);
 	return block->hdl;
 }
@@ -316,6 +927,7 @@ odp_shm_t odp_shm_lookup(const char *name)
 	odp_shm_t hdl;
 
 	odp_spinlock_lock(&odp_shm_tbl->lock);
+	shm_sync();
 
 	if (find_block(name, &i) == 0) {
 		odp_spinlock_unlock(&odp_shm_tbl->lock);
@@ -338,6 +950,8 @@ void *odp_shm_addr(odp_shm_t shm)
 	if (i > (ODP_CONFIG_SHM_BLOCKS - 1))
 		return NULL;
 
+	_odp_shm_sync();
+
 	return odp_shm_tbl->block[i].addr;
 }
 
@@ -352,6 +966,8 @@ int odp_shm_info(odp_shm_t shm, odp_shm_info_t *info)
 	if (i > (ODP_CONFIG_SHM_BLOCKS - 1))
 		return -1;
 
+	_odp_shm_sync();
+
 	block = &odp_shm_tbl->block[i];
 
 	info->name      = block->name;
@@ -359,14 +975,30 @@ int odp_shm_info(odp_shm_t shm, odp_shm_info_t *info)
 	info->size      = block->size;
 	info->page_size = block->page_sz;
 	info->flags     = block->flags;
+	info->numa_node = block->addr ? shm_page_node(block->addr) : -1;
 
 	return 0;
 }
 
 
+static const char *shm_page_str(uint64_t page_sz, char *str, int len)
+{
+	if (page_sz >= SHM_PAGE_1G)
+		snprintf(str, len, "%uG", (unsigned)(page_sz >> 30));
+	else if (page_sz >= 1024 * 1024)
+		snprintf(str, len, "%uM", (unsigned)(page_sz >> 20));
+	else
+		snprintf(str, len, "%uK", (unsigned)(page_sz >> 10));
+
+	return str;
+}
+
 void odp_shm_print_all(void)
 {
 	int i;
+	char page[16];
+
+	_odp_shm_sync();
 
 	ODP_PRINT("\nShared memory\n");
 	ODP_PRINT("--------------\n");
@@ -374,23 +1006,42 @@ void odp_shm_print_all(void)
 		  odp_sys_page_size() / 1024);
 	ODP_PRINT("  huge page size: %"PRIu64" kB\n",
 		  odp_sys_huge_page_size() / 1024);
+	ODP_PRINT("  numa nodes:     %i\n",
+		  odp_global_data.system_info.numa_nodes);
+	if (shm_proc.mp)
+		ODP_PRINT("  instance:       %s, %s process, primary pid %i\n",
+			  odp_global_data.instance,
+			  odp_global_data.secondary ? "secondary" : "primary",
+			  (int)odp_shm_tbl->primary);
 	ODP_PRINT("\n");
 
-	ODP_PRINT("  id name                       kB align huge addr\n");
+	ODP_PRINT("  id name                       kB align page node "
+		  "addr\n");
 
 	for (i = 0; i < ODP_CONFIG_SHM_BLOCKS; i++) {
 		odp_shm_block_t *block;
+		int node;
 
 		block = &odp_shm_tbl->block[i];
 
 		if (block->addr) {
+			node = shm_page_node(block->addr);
+
+			/* '!' marks a page size or node that fell back */
 			ODP_PRINT("  %2i %-24s %4"PRIu64"  %4"PRIu64
-				  " %2c   %p\n",
+				  " %3s%c %3i%c %p\n",
 				  i,
 				  block->name,
 				  block->size/1024,
 				  block->align,
-				  (block->huge ? '*' : ' '),
+				  shm_page_str(block->page_sz, page,
+					       sizeof(page)),
+				  block->page_sz != block->req_page_sz ?
+				  '!' : ' ',
+				  node,
+				  block->numa_req >= 0 &&
+				  (!block->numa_bound ||
+				   node != block->numa_req) ? '!' : ' ',
 				  block->addr);
 		}
 	}
@@ -36,6 +36,8 @@ typedef struct {
 
 #define HUGE_PAGE_DIR "/sys/kernel/mm/hugepages"
 
+#define NUMA_NODE_DIR "/sys/devices/system/node"
+
 
 /*
  * Report the number of CPUs in the affinity mask of the main thread
@@ -111,6 +113,55 @@ static int huge_page_size(void)
 }
 
 
+/*
+ * Number of NUMA nodes, from /sys/devices/system/node/nodeN entries
+ */
+static int numa_node_count(void)
+{
+	DIR *dir;
+	struct dirent *dirent;
+	int node, count = 0;
+
+	dir = opendir(NUMA_NODE_DIR);
+	if (dir == NULL)
+		return 1;
+
+	while ((dirent = readdir(dir)) != NULL) {
+		if (sscanf(dirent->d_name, "node%i", &node) == 1)
+			count++;
+	}
+
+	closedir(dir);
+
+	return count ? count : 1;
+}
+
+/*
+ * NUMA node of a CPU, from the /sys/devices/system/cpu/cpuN/nodeM entry
+ */
+int odp_cpu_numa_node(int cpu)
+{
+	DIR *dir;
+	struct dirent *dirent;
+	char path[64];
+	int node = -1;
+
+	snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%i", cpu);
+
+	dir = opendir(path);
+	if (dir == NULL)
+		return -1;
+
+	while ((dirent = readdir(dir)) != NULL) {
+		if (sscanf(dirent->d_name, "node%i", &node) == 1)
+			break;
+	}
+
+	closedir(dir);
+
+	return node;
+}
+
 
 /*
  * HW specific /proc/cpuinfo file parsing
@@ -366,6 +417,8 @@ int odp_system_info_init(void)
 		return -1;
 	}
 
+	odp_global_data.system_info.numa_nodes = numa_node_count();
+
 	return 0;
 }
 
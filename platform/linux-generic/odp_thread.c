@@ -61,6 +61,13 @@ int odp_thread_init_global(void)
 	odp_shm_t shm;
 	int i;
 
+	if (odp_global_data.secondary) {
+		/* Thread ids are unique within the instance */
+		thread_globals = odp_shm_addr(odp_shm_lookup(
+					      "odp_thread_globals"));
+		return thread_globals ? 0 : -1;
+	}
+
 	shm = odp_shm_reserve("odp_thread_globals",
 			      sizeof(thread_globals_t),
 			      ODP_CACHE_LINE_SIZE, 0);
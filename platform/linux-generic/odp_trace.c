@@ -0,0 +1,141 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <odp_internal.h>
+#include <odp_trace_internal.h>
+
+#if ODP_TRACE
+
+#include <odp/shared_memory.h>
+#include <odp/thread.h>
+#include <odp_debug_internal.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static const char *const trace_point_name[TRACE_NUM_POINTS] = {
+	[TRACE_SCHEDULE]	= "schedule",
+	[TRACE_QUEUE_ENQ]	= "queue_enq",
+	[TRACE_QUEUE_DEQ]	= "queue_deq",
+	[TRACE_BUFFER_ALLOC]	= "buffer_alloc",
+	[TRACE_BUFFER_FREE]	= "buffer_free",
+	[TRACE_PKTIN_POLL]	= "pktin_poll",
+	[TRACE_PKTIO_RECV]	= "pktio_recv",
+	[TRACE_PKTIO_SEND]	= "pktio_send",
+	[TRACE_SCHEDULE_IDLE]	= "schedule_idle",
+};
+
+static trace_shm_t *trace_shm;
+
+__thread trace_thread_t *trace_local;
+uint32_t trace_mask;
+
+int odp_trace_init_global(void)
+{
+	char name[ODP_SHM_NAME_LEN];
+	const char *env;
+	odp_shm_t shm;
+	int i, j;
+
+	snprintf(name, sizeof(name), "odp_trace_%d", getpid());
+
+	shm = odp_shm_reserve(name, sizeof(trace_shm_t),
+			      ODP_CACHE_LINE_SIZE, ODP_SHM_PROC);
+
+	trace_shm = odp_shm_addr(shm);
+
+	if (trace_shm == NULL) {
+		ODP_ERR("Trace init: Shm reserve failed.\n");
+		return -1;
+	}
+
+	memset(trace_shm, 0, sizeof(trace_shm_t));
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++)
+		for (j = 0; j < TRACE_NUM_POINTS; j++)
+			trace_shm->thread[i].hist[j].min = UINT64_MAX;
+
+	for (j = 0; j < TRACE_NUM_POINTS; j++)
+		strncpy(trace_shm->point_name[j], trace_point_name[j],
+			TRACE_NAME_LEN - 1);
+
+	trace_mask = (1 << TRACE_NUM_POINTS) - 1;
+	env = getenv("ODP_TRACE_MASK");
+	if (env)
+		trace_mask &= strtoul(env, NULL, 0);
+
+	trace_shm->num_threads   = ODP_THREAD_COUNT_MAX;
+	trace_shm->num_points    = TRACE_NUM_POINTS;
+	trace_shm->ring_size     = TRACE_RING_SIZE;
+	trace_shm->hist_sub_bits = TRACE_HIST_SUB_BITS;
+	trace_shm->hist_buckets  = TRACE_HIST_BUCKETS;
+	trace_shm->mask          = trace_mask;
+	trace_shm->cpu_hz        = odp_global_data.system_info.cpu_hz;
+	trace_shm->version       = TRACE_VERSION;
+	/* Readers check the magic last */
+	__atomic_store_n(&trace_shm->magic, TRACE_MAGIC, __ATOMIC_RELEASE);
+
+	ODP_DBG("Trace snapshot in /dev/shm/%s, mask 0x%" PRIx32 "\n",
+		name, trace_mask);
+
+	return 0;
+}
+
+int odp_trace_term_global(void)
+{
+	odp_shm_t shm;
+	char name[ODP_SHM_NAME_LEN];
+
+	snprintf(name, sizeof(name), "odp_trace_%d", getpid());
+	shm = odp_shm_lookup(name);
+	trace_shm = NULL;
+
+	if (shm == ODP_SHM_INVALID || odp_shm_free(shm)) {
+		ODP_ERR("Trace term: Shm free failed.\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+int odp_trace_init_local(void)
+{
+	trace_local = &trace_shm->thread[odp_thread_id()];
+	return 0;
+}
+
+int odp_trace_term_local(void)
+{
+	trace_local = NULL;
+	return 0;
+}
+
+#else
+
+int odp_trace_init_global(void)
+{
+	return 0;
+}
+
+int odp_trace_term_global(void)
+{
+	return 0;
+}
+
+int odp_trace_init_local(void)
+{
+	return 0;
+}
+
+int odp_trace_term_local(void)
+{
+	return 0;
+}
+
+#endif
@@ -15,6 +15,9 @@ const pktio_if_ops_t * const pktio_if_ops[]  = {
 #ifdef ODP_NETMAP
 	&netmap_pktio_ops,
 #endif
+#ifdef HAVE_AF_XDP
+	&xdp_pktio_ops,
+#endif
 #ifdef HAVE_PCAP
 	&pcap_pktio_ops,
 #endif
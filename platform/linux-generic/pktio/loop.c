@@ -5,6 +5,36 @@
  * SPDX-License-Identifier:     BSD-3-Clause
  */
 
+/**
+ * @file
+ *
+ * Loopback pktio type
+ *
+ * Packets sent on a loop device are received back on the same device. Each
+ * sending thread owns a single producer / single consumer ring, so that
+ * transmit never takes a lock and receive (already serialized by the pktio
+ * entry lock) drains the rings in a round robin fashion.
+ *
+ * The name passed to odp_pktio_open() must be "loop" or "loop<N>" (N being
+ * any decimal number, to open several independent loopback devices),
+ * optionally followed by a list of options:
+ *
+ * loop1:lat=50:drop=0.1:seed=7:parse=0
+ *
+ *   lat     latency in microseconds added between send and receive of a
+ *           packet. Default is 0.
+ *   drop    percentage of sent packets which are silently dropped. The
+ *           default is 0.
+ *   seed    seed of the pseudo random generator used for drop injection.
+ *           A given seed always drops the same packets of a given sending
+ *           thread. The default is 1.
+ *   parse   set to 0 to keep the metadata packets were sent with, instead
+ *           of resetting it and parsing packets again on receive (up to
+ *           the parse level of the interface). The default is 1.
+ *
+ * The total length of the string is limited by PKTIO_NAME_LEN.
+ */
+
 #ifndef _GNU_SOURCE
 #define _GNU_SOURCE
 #endif
@@ -14,89 +44,277 @@
 #include <odp_packet_io_internal.h>
 #include <odp_classification_internal.h>
 #include <odp_debug_internal.h>
+#include <odp_atomic_internal.h>
 #include <odp/hints.h>
 
 #include <odp/helper/eth.h>
 #include <odp/helper/ip.h>
 
 #include <errno.h>
+#include <stdlib.h>
+
+/* Number of packets each per-thread ring can hold, must be a power of two */
+#define LOOP_RING_SIZE 256
+#define LOOP_RING_MASK (LOOP_RING_SIZE - 1)
 
 /* MAC address for the "loop" interface */
 static const char pktio_loop_mac[] = {0x02, 0xe9, 0x34, 0x80, 0x73, 0x01};
 
+typedef struct {
+	odp_packet_t pkt;
+	uint64_t ts;			/**< transmit time when latency is set */
+} loop_slot_t;
+
+struct pkt_loop_ring {
+	/* Producer side, written by the owner thread only */
+	odp_atomic_u32_t head ODP_ALIGNED_CACHE;
+	uint32_t rnd;			/**< drop injection PRNG state */
+	/* Consumer side, written by the receiver only */
+	odp_atomic_u32_t tail ODP_ALIGNED_CACHE;
+	loop_slot_t slot[LOOP_RING_SIZE] ODP_ALIGNED_CACHE;
+};
+
+static int loopback_parse_devname(pkt_loop_t *loop, const char *devname)
+{
+	char name[PKTIO_NAME_LEN];
+	char *tok, *end;
+	unsigned long idx;
+	double drop;
+
+	if (strncmp(devname, "loop", 4) != 0)
+		return -1;
+
+	snprintf(name, sizeof(name), "%s", devname);
+
+	memcpy(loop->mac, pktio_loop_mac, ETH_ALEN);
+	loop->latency_ns = 0;
+	loop->drop_thresh = 0;
+	loop->seed = 1;
+	loop->parse = 1;
+
+	/* Device index, "loop" is kept as the historical default device */
+	tok = name + 4;
+	if (*tok != '\0' && *tok != ':') {
+		idx = strtoul(tok, &end, 10);
+		if (end == tok || (*end != '\0' && *end != ':') || idx > 0xff)
+			return -1;
+		loop->mac[4] = idx;
+		loop->mac[5] = 0x02;
+		tok = end;
+	}
+
+	if (*tok == '\0')
+		return 0;
+
+	for (tok = strtok(tok + 1, ":"); tok; tok = strtok(NULL, ":")) {
+		if (strncmp(tok, "lat=", 4) == 0) {
+			loop->latency_ns = strtoull(tok + 4, NULL, 10) *
+					   ODP_TIME_USEC_IN_NS;
+		} else if (strncmp(tok, "drop=", 5) == 0) {
+			drop = strtod(tok + 5, NULL);
+			if (drop < 0.0 || drop > 100.0) {
+				ODP_ERR("invalid drop percentage\n");
+				return -1;
+			}
+			loop->drop_thresh = drop >= 100.0 ? UINT32_MAX :
+				(uint32_t)(drop / 100.0 * (double)UINT32_MAX);
+		} else if (strncmp(tok, "seed=", 5) == 0) {
+			loop->seed = strtoul(tok + 5, NULL, 10);
+		} else if (strncmp(tok, "parse=", 6) == 0) {
+			loop->parse = atoi(tok + 6) != 0;
+		} else {
+			ODP_ERR("unknown loop option %s\n", tok);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
 static int loopback_open(odp_pktio_t id, pktio_entry_t *pktio_entry,
 			 const char *devname, odp_pool_t pool ODP_UNUSED)
 {
-	if (strcmp(devname, "loop"))
-		return -1;
+	pkt_loop_t *loop = &pktio_entry->s.pkt_loop;
+	char shm_name[ODP_SHM_NAME_LEN];
+	int i;
 
-	char loopq_name[ODP_QUEUE_NAME_LEN];
+	if (loopback_parse_devname(loop, devname))
+		return -1;
 
-	snprintf(loopq_name, sizeof(loopq_name), "%" PRIu64 "-pktio_loopq",
+	snprintf(shm_name, sizeof(shm_name), "%" PRIu64 "-pktio_loop_rings",
 		 odp_pktio_to_u64(id));
-	pktio_entry->s.pkt_loop.loopq =
-		odp_queue_create(loopq_name, ODP_QUEUE_TYPE_POLL, NULL);
-
-	if (pktio_entry->s.pkt_loop.loopq == ODP_QUEUE_INVALID)
+	loop->shm = odp_shm_reserve(shm_name, sizeof(struct pkt_loop_ring) *
+				    ODP_THREAD_COUNT_MAX,
+				    ODP_CACHE_LINE_SIZE, 0);
+	if (loop->shm == ODP_SHM_INVALID)
 		return -1;
 
+	loop->ring = odp_shm_addr(loop->shm);
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+		odp_atomic_init_u32(&loop->ring[i].head, 0);
+		odp_atomic_init_u32(&loop->ring[i].tail, 0);
+		/* xorshift state must never be zero */
+		loop->ring[i].rnd = (loop->seed ^ (i * 0x9e3779b9)) | 1;
+	}
+
+	odp_atomic_init_u32(&loop->num_rings, 0);
+	loop->rx_next = 0;
+	pktio_entry->s.tx_mt_safe = 1;
+
 	return 0;
 }
 
 static int loopback_close(pktio_entry_t *pktio_entry)
 {
-	return odp_queue_destroy(pktio_entry->s.pkt_loop.loopq);
+	pkt_loop_t *loop = &pktio_entry->s.pkt_loop;
+	struct pkt_loop_ring *ring;
+	uint32_t num_rings, i, tail, head;
+
+	/* Free packets sent but not received yet */
+	num_rings = odp_atomic_load_u32(&loop->num_rings);
+	for (i = 0; i < num_rings; i++) {
+		ring = &loop->ring[i];
+		head = _odp_atomic_u32_load_mm(&ring->head, _ODP_MEMMODEL_ACQ);
+		for (tail = odp_atomic_load_u32(&ring->tail);
+		     tail != head; tail++)
+			odp_packet_free(ring->slot[tail & LOOP_RING_MASK].pkt);
+		odp_atomic_store_u32(&ring->tail, tail);
+	}
+
+	return odp_shm_free(loop->shm);
+}
+
+/* Dequeue up to len packets from a ring, in order and honoring the injected
+ * latency. Only called by the (single) receiver. */
+static unsigned loop_ring_deq(pkt_loop_t *loop, struct pkt_loop_ring *ring,
+			      odp_packet_t pkts[], unsigned len, uint64_t now)
+{
+	uint32_t tail, head;
+	unsigned num, i;
+	loop_slot_t *slot;
+
+	tail = odp_atomic_load_u32(&ring->tail);
+	head = _odp_atomic_u32_load_mm(&ring->head, _ODP_MEMMODEL_ACQ);
+	num = head - tail;
+	if (num > len)
+		num = len;
+
+	for (i = 0; i < num; i++) {
+		slot = &ring->slot[(tail + i) & LOOP_RING_MASK];
+		if (loop->latency_ns && slot->ts + loop->latency_ns > now)
+			break;
+		pkts[i] = slot->pkt;
+	}
+
+	if (i)
+		_odp_atomic_u32_store_mm(&ring->tail, tail + i,
+					 _ODP_MEMMODEL_RLS);
+	return i;
 }
 
 static int loopback_recv(pktio_entry_t *pktio_entry, odp_packet_t pkts[],
 			 unsigned len)
 {
-	int nbr, i, j;
-	odp_buffer_hdr_t *hdr_tbl[QUEUE_MULTI_MAX];
-	queue_entry_t *qentry;
-	odp_packet_hdr_t *pkt_hdr;
-	odp_packet_t pkt;
+	pkt_loop_t *loop = &pktio_entry->s.pkt_loop;
+	uint32_t num_rings, ring_id, i;
+	unsigned nbr = 0, num, j;
+	uint64_t now = 0;
 
-	nbr = 0;
-	qentry = queue_to_qentry(pktio_entry->s.pkt_loop.loopq);
-	nbr = queue_deq_multi(qentry, hdr_tbl, len);
-
-	if (pktio_cls_enabled(pktio_entry)) {
-		for (i = 0, j = 0; i < nbr; i++) {
-			pkt = _odp_packet_from_buffer(odp_hdr_to_buf
-						      (hdr_tbl[i]));
-			pkt_hdr = odp_packet_hdr(pkt);
-			packet_parse_reset(pkt_hdr);
-			packet_parse_l2(pkt_hdr);
-			if (0 > _odp_packet_classifier(pktio_entry, pkt))
-				pkts[j++] = pkt;
-		}
-	nbr = j;
-	} else {
-		for (i = 0; i < nbr; ++i) {
-			pkts[i] = _odp_packet_from_buffer(odp_hdr_to_buf
-							  (hdr_tbl[i]));
-			pkt_hdr = odp_packet_hdr(pkts[i]);
-			packet_parse_reset(pkt_hdr);
-			packet_parse_l2(pkt_hdr);
-		}
+	num_rings = odp_atomic_load_u32(&loop->num_rings);
+	if (odp_unlikely(num_rings == 0))
+		return 0;
+
+	if (loop->latency_ns)
+		now = odp_time_to_ns(odp_time_local());
+
+	ring_id = loop->rx_next < num_rings ? loop->rx_next : 0;
+	for (i = 0; i < num_rings && nbr < len; i++) {
+		nbr += loop_ring_deq(loop, &loop->ring[ring_id],
+				     &pkts[nbr], len - nbr, now);
+		if (++ring_id == num_rings)
+			ring_id = 0;
+	}
+	/* Start from the next ring on the next call for fairness */
+	loop->rx_next = ring_id;
+
+	if (loop->parse) {
+		for (j = 0; j < nbr; j++)
+			packet_parse_reset(odp_packet_hdr(pkts[j]));
+	}
+
+	if (!pktio_cls_enabled(pktio_entry))
+		return nbr;
+
+	/* The classifier needs all layers, parse them as a burst */
+	packet_parse_multi(pkts, nbr, ODP_PKTIO_PARSE_ALL);
+
+	for (j = 0, num = 0; j < nbr; j++) {
+		if (0 > _odp_packet_classifier(pktio_entry, pkts[j]))
+			pkts[num++] = pkts[j];
 	}
 
-	return nbr;
+	return num;
+}
+
+static inline uint32_t loop_rand(struct pkt_loop_ring *ring)
+{
+	uint32_t x = ring->rnd;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	ring->rnd = x;
+
+	return x;
 }
 
 static int loopback_send(pktio_entry_t *pktio_entry, odp_packet_t pkt_tbl[],
 			 unsigned len)
 {
-	odp_buffer_hdr_t *hdr_tbl[QUEUE_MULTI_MAX];
-	queue_entry_t *qentry;
-	unsigned i;
+	pkt_loop_t *loop = &pktio_entry->s.pkt_loop;
+	struct pkt_loop_ring *ring;
+	uint32_t thr = odp_thread_id();
+	uint32_t num_rings, head, tail;
+	unsigned free_slots, i;
+	uint64_t ts = 0;
+
+	/* Make the receiver scan the ring of this thread */
+	num_rings = odp_atomic_load_u32(&loop->num_rings);
+	while (odp_unlikely(thr >= num_rings)) {
+		if (_odp_atomic_u32_cmp_xchg_strong_mm(&loop->num_rings,
+						       &num_rings, thr + 1,
+						       _ODP_MEMMODEL_RLX,
+						       _ODP_MEMMODEL_RLX))
+			break;
+	}
+
+	ring = &loop->ring[thr];
+	head = odp_atomic_load_u32(&ring->head);
+	tail = _odp_atomic_u32_load_mm(&ring->tail, _ODP_MEMMODEL_ACQ);
+	free_slots = LOOP_RING_SIZE - (head - tail);
+	if (len > free_slots)
+		len = free_slots;
+
+	if (loop->latency_ns)
+		ts = odp_time_to_ns(odp_time_local());
+
+	for (i = 0; i < len; i++) {
+		if (odp_unlikely(loop->drop_thresh) &&
+		    loop_rand(ring) < loop->drop_thresh) {
+			/* Lost on the wire: reported as sent */
+			odp_packet_free(pkt_tbl[i]);
+			pktio_stats(pktio_entry)->out_discards++;
+			continue;
+		}
+		ring->slot[head & LOOP_RING_MASK].pkt = pkt_tbl[i];
+		ring->slot[head & LOOP_RING_MASK].ts = ts;
+		head++;
+	}
 
-	for (i = 0; i < len; ++i)
-		hdr_tbl[i] = odp_buf_to_hdr(_odp_packet_to_buffer(pkt_tbl[i]));
+	_odp_atomic_u32_store_mm(&ring->head, head, _ODP_MEMMODEL_RLS);
 
-	qentry = queue_to_qentry(pktio_entry->s.pkt_loop.loopq);
-	return queue_enq_multi(qentry, hdr_tbl, len, 0);
+	return len;
 }
 
 static int loopback_mtu_get(pktio_entry_t *pktio_entry ODP_UNUSED)
@@ -105,10 +323,10 @@ static int loopback_mtu_get(pktio_entry_t *pktio_entry ODP_UNUSED)
 	return INT_MAX;
 }
 
-static int loopback_mac_addr_get(pktio_entry_t *pktio_entry ODP_UNUSED,
+static int loopback_mac_addr_get(pktio_entry_t *pktio_entry,
 				 void *mac_addr)
 {
-	memcpy(mac_addr, pktio_loop_mac, ETH_ALEN);
+	memcpy(mac_addr, pktio_entry->s.pkt_loop.mac, ETH_ALEN);
 	return ETH_ALEN;
 }
 
@@ -14,10 +14,12 @@
 #include <odp_packet_socket.h>
 #include <odp_packet_io_internal.h>
 #include <odp_debug_internal.h>
+#include <odp/thread.h>
 #include <odp/helper/eth.h>
 
+#include <errno.h>
+#include <stdlib.h>
 #include <sys/ioctl.h>
-#include <poll.h>
 #include <linux/ethtool.h>
 #include <linux/sockios.h>
 #include <odp_classification_datamodel.h>
@@ -27,13 +29,25 @@
 #define NETMAP_WITH_LIBS
 #include <net/netmap_user.h>
 
-static struct nm_desc mmap_desc;	/** Used to store the mmap address;
-					  filled in first time, used for
-					  subsequent calls to nm_open */
+/*
+ * Every rx/tx ring pair of the port is bound through its own netmap
+ * descriptor (NR_REG_ONE_NIC), so rings are synchronized independently and
+ * senders on different rings never serialize. All descriptors share the
+ * memory mapping of the port wide descriptor.
+ *
+ * Besides NIC ports ("eth0" or "netmap:eth0") the VALE switch ports
+ * ("vale0:p0") and netmap pipes ("vale0:p0{0", "netmap:eth0}0") are accepted.
+ * These have no kernel network device, which makes two VALE ports or the two
+ * ends of a pipe a local test setup that needs no NIC hardware.
+ */
 
 #define NM_OPEN_RETRIES 5
 #define NM_INJECT_RETRIES 10
 
+/* Locally administered base MAC for VALE and pipe ports */
+static const unsigned char netmap_virt_mac[] = {0x02, 0xe9, 0x34, 0x4e,
+						0x4d, 0x00};
+
 static int netmap_do_ioctl(pktio_entry_t *pktio_entry, unsigned long cmd,
 			   int subcmd)
 {
@@ -44,8 +58,7 @@ static int netmap_do_ioctl(pktio_entry_t *pktio_entry, unsigned long cmd,
 	int fd = pkt_nm->sockfd;
 
 	memset(&ifr, 0, sizeof(ifr));
-	snprintf(ifr.ifr_name, sizeof(ifr.ifr_name), "%s",
-		 pktio_entry->s.name);
+	snprintf(ifr.ifr_name, sizeof(ifr.ifr_name), "%s", pkt_nm->if_name);
 
 	switch (cmd) {
 	case SIOCSIFFLAGS:
@@ -85,13 +98,22 @@ done:
 static int netmap_close(pktio_entry_t *pktio_entry)
 {
 	pkt_netmap_t *pkt_nm = &pktio_entry->s.pkt_nm;
+	unsigned i;
 
-	if (pkt_nm->rx_desc != NULL) {
-		nm_close(pkt_nm->rx_desc);
-		mmap_desc.mem = NULL;
+	for (i = 0; i < pkt_nm->num_rings; i++) {
+		if (pkt_nm->ring[i].desc != NULL &&
+		    pkt_nm->ring[i].desc != pkt_nm->desc)
+			nm_close(pkt_nm->ring[i].desc);
+	}
+	free(pkt_nm->ring);
+	pkt_nm->ring = NULL;
+	pkt_nm->num_rings = 0;
+
+	/* Port descriptor owns the memory mapping, close it last */
+	if (pkt_nm->desc != NULL) {
+		nm_close(pkt_nm->desc);
+		pkt_nm->desc = NULL;
 	}
-	if (pkt_nm->tx_desc != NULL)
-		nm_close(pkt_nm->tx_desc);
 
 	if (pkt_nm->sockfd != -1 && close(pkt_nm->sockfd) != 0) {
 		__odp_errno = errno;
@@ -101,10 +123,62 @@ static int netmap_close(pktio_entry_t *pktio_entry)
 	return 0;
 }
 
-static int netmap_open(odp_pktio_t id ODP_UNUSED, pktio_entry_t *pktio_entry,
+/* Bind a descriptor to each ring pair of the port */
+static int netmap_open_rings(pkt_netmap_t *pkt_nm)
+{
+	struct nm_desc *desc = pkt_nm->desc;
+	char name[sizeof(pkt_nm->nm_name) + 8];
+	unsigned i, num_rings;
+
+	pkt_nm->num_rx_rings = desc->req.nr_rx_rings;
+	pkt_nm->num_tx_rings = desc->req.nr_tx_rings;
+
+	/* All hardware rings are polled, however many the NIC has */
+	num_rings = pkt_nm->num_rx_rings > pkt_nm->num_tx_rings ?
+		    pkt_nm->num_rx_rings : pkt_nm->num_tx_rings;
+
+	pkt_nm->ring = calloc(num_rings, sizeof(netmap_ring_t));
+	if (pkt_nm->ring == NULL) {
+		ODP_ERR("Ring table alloc failed, %u rings\n", num_rings);
+		return -1;
+	}
+	pkt_nm->num_rings = num_rings;
+
+	for (i = 0; i < pkt_nm->num_rings; i++)
+		odp_ticketlock_init(&pkt_nm->ring[i].tx_lock);
+
+	/* Single ring pair (always the case with pipes): the port
+	 * descriptor is the ring descriptor */
+	if (pkt_nm->num_rings == 1) {
+		pkt_nm->ring[0].desc = desc;
+		return 0;
+	}
+
+	for (i = 0; i < pkt_nm->num_rings; i++) {
+		snprintf(name, sizeof(name), "%s-%u", pkt_nm->nm_name, i);
+		pkt_nm->ring[i].desc = nm_open(name, NULL, NETMAP_NO_TX_POLL |
+					       NM_OPEN_NO_MMAP, desc);
+		if (pkt_nm->ring[i].desc == NULL) {
+			ODP_ERR("nm_open(%s) failed\n", name);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/* Set only once the open succeeds, the next backend is tried otherwise */
+static void netmap_open_done(pktio_entry_t *pktio_entry)
+{
+	/* Senders pick a ring by thread and lock only that ring */
+	pktio_entry->s.tx_mt_safe = 1;
+	pktio_entry->s.stats_num_queues = pktio_entry->s.pkt_nm.num_rings;
+}
+
+static int netmap_open(odp_pktio_t id, pktio_entry_t *pktio_entry,
 		       const char *netdev, odp_pool_t pool)
 {
-	char ifname[IFNAMSIZ + 7]; /* netmap:<ifname> */
+	const char *prefix;
 	int err;
 	int sockfd;
 	int i;
@@ -128,24 +202,38 @@ static int netmap_open(odp_pktio_t id ODP_UNUSED, pktio_entry_t *pktio_entry,
 
 	snprintf(pktio_entry->s.name, sizeof(pktio_entry->s.name), "%s",
 		 netdev);
-	snprintf(ifname, sizeof(ifname), "netmap:%s", netdev);
 
-	if (mmap_desc.mem == NULL)
-		pkt_nm->rx_desc = nm_open(ifname, NULL, NETMAP_NO_TX_POLL,
-					  NULL);
+	/* VALE ports are opened as is, other ports get the netmap prefix */
+	if (strncmp(netdev, "vale", 4) == 0 ||
+	    strncmp(netdev, "netmap:", 7) == 0)
+		prefix = "";
 	else
-		pkt_nm->rx_desc = nm_open(ifname, NULL, NETMAP_NO_TX_POLL |
-					  NM_OPEN_NO_MMAP, &mmap_desc);
-	pkt_nm->tx_desc = nm_open(ifname, NULL, NM_OPEN_NO_MMAP, &mmap_desc);
+		prefix = "netmap:";
+	snprintf(pkt_nm->nm_name, sizeof(pkt_nm->nm_name), "%s%s", prefix,
+		 netdev);
+
+	if (strncmp(netdev, "netmap:", 7) == 0)
+		netdev += 7;
+	snprintf(pkt_nm->if_name, sizeof(pkt_nm->if_name), "%s", netdev);
 
-	if (pkt_nm->rx_desc == NULL || pkt_nm->tx_desc == NULL) {
-		ODP_ERR("nm_open(%s) failed\n", ifname);
+	pkt_nm->is_virtual = strncmp(netdev, "vale", 4) == 0 ||
+			     strchr(netdev, '{') != NULL ||
+			     strchr(netdev, '}') != NULL;
+
+	pkt_nm->desc = nm_open(pkt_nm->nm_name, NULL, NETMAP_NO_TX_POLL, NULL);
+	if (pkt_nm->desc == NULL) {
+		ODP_ERR("nm_open(%s) failed\n", pkt_nm->nm_name);
 		goto error;
 	}
 
-	if (mmap_desc.mem == NULL) {
-		mmap_desc.mem = pkt_nm->rx_desc->mem;
-		mmap_desc.memsize = pkt_nm->rx_desc->memsize;
+	if (netmap_open_rings(pkt_nm))
+		goto error;
+
+	if (pkt_nm->is_virtual) {
+		memcpy(pkt_nm->if_mac, netmap_virt_mac, ETH_ALEN);
+		pkt_nm->if_mac[ETH_ALEN - 1] = odp_pktio_to_u64(id);
+		netmap_open_done(pktio_entry);
+		return 0;
 	}
 
 	sockfd = socket(AF_INET, SOCK_DGRAM, 0);
@@ -161,7 +249,7 @@ static int netmap_open(odp_pktio_t id ODP_UNUSED, pktio_entry_t *pktio_entry,
 	if ((pkt_nm->if_flags & IFF_UP) == 0)
 		ODP_DBG("%s is down\n", pktio_entry->s.name);
 
-	err = mac_addr_get_fd(sockfd, netdev, pkt_nm->if_mac);
+	err = mac_addr_get_fd(sockfd, pkt_nm->if_name, pkt_nm->if_mac);
 	if (err)
 		goto error;
 
@@ -174,8 +262,10 @@ static int netmap_open(odp_pktio_t id ODP_UNUSED, pktio_entry_t *pktio_entry,
 		 * this case without the additional sleep pktio validation
 		 * tests fail. */
 		sleep(1);
-		if (err == 0)
+		if (err == 0) {
+			netmap_open_done(pktio_entry);
 			return 0;
+		}
 	}
 	ODP_ERR("%s didn't come up\n", pktio_entry->s.name);
 
@@ -205,11 +295,13 @@ static inline int netmap_pkt_to_odp(pktio_entry_t *pktio_entry,
 	if (odp_unlikely(len > pktio_entry->s.pkt_nm.max_frame_len)) {
 		ODP_ERR("RX: frame too big %" PRIu16 " %zu!\n", len,
 			pktio_entry->s.pkt_nm.max_frame_len);
+		pktio_stats(pktio_entry)->in_errors++;
 		return -1;
 	}
 
 	if (odp_unlikely(len < ODPH_ETH_LEN_MIN)) {
 		ODP_ERR("RX: Frame truncated: %" PRIu16 "\n", len);
+		pktio_stats(pktio_entry)->in_errors++;
 		return -1;
 	}
 
@@ -220,13 +312,11 @@ static inline int netmap_pkt_to_odp(pktio_entry_t *pktio_entry,
 			return 0;
 		return -1;
 	} else {
-		odp_packet_hdr_t *pkt_hdr;
-
 		pkt = packet_alloc(pktio_entry->s.pkt_nm.pool, len, 1);
-		if (pkt == ODP_PACKET_INVALID)
+		if (pkt == ODP_PACKET_INVALID) {
+			pktio_stats(pktio_entry)->in_no_buffers++;
 			return -1;
-
-		pkt_hdr = odp_packet_hdr(pkt);
+		}
 
 		/* For now copy the data in the mbuf,
 		   worry about zero-copy later */
@@ -235,7 +325,6 @@ static inline int netmap_pkt_to_odp(pktio_entry_t *pktio_entry,
 			return -1;
 		}
 
-		packet_parse_l2(pkt_hdr);
 		*pkt_out = pkt;
 	}
 
@@ -245,30 +334,37 @@ static inline int netmap_pkt_to_odp(pktio_entry_t *pktio_entry,
 static int netmap_recv(pktio_entry_t *pktio_entry, odp_packet_t pkt_table[],
 		       unsigned num)
 {
+	pkt_netmap_t *pkt_nm = &pktio_entry->s.pkt_nm;
 	struct netmap_ring *ring;
-	struct nm_desc *desc = pktio_entry->s.pkt_nm.rx_desc;
-	struct pollfd polld;
+	struct nm_desc *desc;
+	odp_pktio_queue_stats_t *qstats;
 	char *buf;
-	int i;
-	int num_rings = desc->last_rx_ring - desc->first_rx_ring + 1;
-	int ring_id = desc->cur_rx_ring;
+	unsigned i;
 	unsigned num_rx = 0;
-	uint32_t slot_id;
-
-	polld.fd = desc->fd;
-	polld.events = POLLIN;
-
-	for (i = 0; i < num_rings && num_rx != num; i++) {
-		ring_id = desc->cur_rx_ring + i;
-
-		if (ring_id > desc->last_rx_ring)
-			ring_id = desc->first_rx_ring;
-
-		ring = NETMAP_RXRING(desc->nifp, ring_id);
-
-		while (!nm_ring_empty(ring) && num_rx != num) {
-			slot_id = ring->cur;
+	unsigned ring_id = pkt_nm->rx_next;
+	uint32_t slot_id, avail, num_slots;
+	uint64_t octets;
+
+	for (i = 0; i < pkt_nm->num_rx_rings && num_rx != num; i++) {
+		ring_id = pkt_nm->rx_next + i;
+		if (ring_id >= pkt_nm->num_rx_rings)
+			ring_id -= pkt_nm->num_rx_rings;
+
+		desc = pkt_nm->ring[ring_id].desc;
+		ring = NETMAP_RXRING(desc->nifp, desc->first_rx_ring);
+
+		avail = nm_ring_space(ring);
+		if (avail > num - num_rx)
+			avail = num - num_rx;
+		if (avail == 0)
+			continue;
+
+		num_slots = avail;
+		octets = 0;
+		slot_id = ring->cur;
+		while (avail--) {
 			buf = NETMAP_BUF(ring, ring->slot[slot_id].buf_idx);
+			octets += ring->slot[slot_id].len;
 
 			odp_prefetch(buf);
 
@@ -276,47 +372,92 @@ static int netmap_recv(pktio_entry_t *pktio_entry, odp_packet_t pkt_table[],
 					       buf, ring->slot[slot_id].len))
 				num_rx++;
 
-			ring->cur = nm_ring_next(ring, slot_id);
-			ring->head = ring->cur;
+			slot_id = nm_ring_next(ring, slot_id);
 		}
-	}
-	desc->cur_rx_ring = ring_id;
+		/* Return the consumed slots to the kernel at once */
+		ring->cur = slot_id;
+		ring->head = slot_id;
 
-	if (num_rx == 0) {
-		if (odp_unlikely(poll(&polld, 1, 0) < 0))
-			ODP_ERR("RX: poll error\n");
+		qstats = pktio_queue_stats(pktio_entry, ring_id);
+		qstats->in_packets += num_slots;
+		qstats->in_octets += octets;
 	}
+	/* Continue from the ring after the last served one */
+	pkt_nm->rx_next = ring_id + 1 < pkt_nm->num_rx_rings ? ring_id + 1 : 0;
+
+	/* The port descriptor is bound to all rings, one sync covers them */
+	if (num_rx == 0 &&
+	    odp_unlikely(ioctl(pkt_nm->desc->fd, NIOCRXSYNC, NULL) < 0))
+		ODP_ERR("RX: sync error\n");
+
 	return num_rx;
 }
 
 static int netmap_send(pktio_entry_t *pktio_entry, odp_packet_t pkt_table[],
 		       unsigned num)
 {
-	struct pollfd polld;
-	struct nm_desc *nm_desc = pktio_entry->s.pkt_nm.tx_desc;
-	unsigned i, nb_tx;
-	uint8_t *frame;
-	uint32_t frame_len;
+	pkt_netmap_t *pkt_nm = &pktio_entry->s.pkt_nm;
+	netmap_ring_t *tx_ring;
+	struct netmap_ring *ring;
+	struct netmap_slot *slot;
+	struct nm_desc *desc;
+	odp_pktio_queue_stats_t *qstats;
+	odp_packet_t pkt;
+	unsigned i, nb_tx, ring_id;
+	uint32_t l2_offset, frame_len;
+	uint64_t octets = 0;
+	int retry = 0;
+	int too_big = 0;
+
+	ring_id = odp_thread_id() % pkt_nm->num_tx_rings;
+	tx_ring = &pkt_nm->ring[ring_id];
+	desc = tx_ring->desc;
+	ring = NETMAP_TXRING(desc->nifp, desc->first_tx_ring);
 
-	polld.fd = nm_desc->fd;
-	polld.events = POLLOUT;
+	odp_ticketlock_lock(&tx_ring->tx_lock);
 
 	for (nb_tx = 0; nb_tx < num; nb_tx++) {
-		frame_len = 0;
-		frame = odp_packet_l2_ptr(pkt_table[nb_tx], &frame_len);
-		for (i = 0; i < NM_INJECT_RETRIES; i++) {
-			if (nm_inject(nm_desc, frame, frame_len) == 0)
-				poll(&polld, 1, 0);
-			else
-				break;
-		}
-		if (odp_unlikely(i == NM_INJECT_RETRIES)) {
-			ioctl(nm_desc->fd, NIOCTXSYNC, NULL);
+		pkt = pkt_table[nb_tx];
+		l2_offset = odp_packet_l2_offset(pkt);
+		if (l2_offset == ODP_PACKET_OFFSET_INVALID)
+			l2_offset = 0;
+		frame_len = odp_packet_len(pkt) - l2_offset;
+
+		if (odp_unlikely(frame_len > ring->nr_buf_size)) {
+			too_big = 1;
 			break;
 		}
+
+		/* Reclaim completed slots when the ring fills up */
+		while (nm_ring_empty(ring) && retry < NM_INJECT_RETRIES) {
+			ioctl(desc->fd, NIOCTXSYNC, NULL);
+			retry++;
+		}
+		if (odp_unlikely(nm_ring_empty(ring)))
+			break;
+
+		slot = &ring->slot[ring->cur];
+		odp_packet_copydata_out(pkt, l2_offset, frame_len,
+					NETMAP_BUF(ring, slot->buf_idx));
+		slot->len = frame_len;
+		octets += frame_len;
+
+		ring->cur = nm_ring_next(ring, ring->cur);
+		ring->head = ring->cur;
 	}
 	/* Send pending packets */
-	poll(&polld, 1, 0);
+	ioctl(desc->fd, NIOCTXSYNC, NULL);
+
+	odp_ticketlock_unlock(&tx_ring->tx_lock);
+
+	if (odp_unlikely(too_big && nb_tx == 0)) {
+		__odp_errno = EMSGSIZE;
+		return -1;
+	}
+
+	qstats = pktio_queue_stats(pktio_entry, ring_id);
+	qstats->out_packets += nb_tx;
+	qstats->out_octets += octets;
 
 	for (i = 0; i < nb_tx; i++)
 		odp_packet_free(pkt_table[i]);
@@ -332,20 +473,39 @@ static int netmap_mac_addr_get(pktio_entry_t *pktio_entry, void *mac_addr)
 
 static int netmap_mtu_get(pktio_entry_t *pktio_entry)
 {
-	return mtu_get_fd(pktio_entry->s.pkt_nm.sockfd, pktio_entry->s.name);
+	pkt_netmap_t *pkt_nm = &pktio_entry->s.pkt_nm;
+	struct nm_desc *desc = pkt_nm->ring[0].desc;
+
+	/* Virtual ports are limited by the netmap buffer size only */
+	if (pkt_nm->is_virtual)
+		return NETMAP_TXRING(desc->nifp,
+				     desc->first_tx_ring)->nr_buf_size;
+
+	return mtu_get_fd(pkt_nm->sockfd, pkt_nm->if_name);
 }
 
 static int netmap_promisc_mode_set(pktio_entry_t *pktio_entry,
 				   odp_bool_t enable)
 {
-	return promisc_mode_set_fd(pktio_entry->s.pkt_nm.sockfd,
-				   pktio_entry->s.name, enable);
+	pkt_netmap_t *pkt_nm = &pktio_entry->s.pkt_nm;
+
+	/* VALE switch and pipes deliver by MAC learning only */
+	if (pkt_nm->is_virtual) {
+		pkt_nm->promisc = enable;
+		return 0;
+	}
+
+	return promisc_mode_set_fd(pkt_nm->sockfd, pkt_nm->if_name, enable);
 }
 
 static int netmap_promisc_mode_get(pktio_entry_t *pktio_entry)
 {
-	return promisc_mode_get_fd(pktio_entry->s.pkt_nm.sockfd,
-				   pktio_entry->s.name);
+	pkt_netmap_t *pkt_nm = &pktio_entry->s.pkt_nm;
+
+	if (pkt_nm->is_virtual)
+		return pkt_nm->promisc;
+
+	return promisc_mode_get_fd(pkt_nm->sockfd, pkt_nm->if_name);
 }
 
 const pktio_if_ops_t netmap_pktio_ops = {
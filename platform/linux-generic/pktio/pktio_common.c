@@ -17,6 +17,7 @@ int _odp_packet_cls_enq(pktio_entry_t *pktio_entry,
 			odp_packet_t *pkt_ret)
 {
 	cos_t *cos;
+	odp_pktio_stats_t *stats;
 	odp_packet_t pkt;
 	odp_packet_hdr_t pkt_hdr;
 	int ret;
@@ -28,30 +29,40 @@ int _odp_packet_cls_enq(pktio_entry_t *pktio_entry,
 	cos = pktio_select_cos(pktio_entry, base, &pkt_hdr);
 
 	/* if No CoS found then drop the packet */
-	if (cos == NULL || cos->s.queue == NULL || cos->s.pool == NULL)
+	if (cos == NULL || cos->s.queue == NULL || cos->s.pool == NULL) {
+		pktio_stats(pktio_entry)->in_cls_drops++;
 		return 0;
+	}
 
 	pool = cos->s.pool->s.pool_hdl;
 
 	pkt = odp_packet_alloc(pool, buf_len);
-	if (odp_unlikely(pkt == ODP_PACKET_INVALID))
+	if (odp_unlikely(pkt == ODP_PACKET_INVALID)) {
+		pktio_stats(pktio_entry)->in_no_buffers++;
 		return 0;
+	}
 
 	copy_packet_parser_metadata(&pkt_hdr, odp_packet_hdr(pkt));
 	odp_packet_hdr(pkt)->input = pktio_entry->s.id;
 
 	if (odp_packet_copydata_in(pkt, 0, buf_len, base) != 0) {
 		odp_packet_free(pkt);
+		pktio_stats(pktio_entry)->in_errors++;
 		return 0;
 	}
 
 	/* Parse and set packet header data */
 	odp_packet_pull_tail(pkt, odp_packet_len(pkt) - buf_len);
-	ret = queue_enq(cos->s.queue, odp_buf_to_hdr((odp_buffer_t)pkt), 0);
+	ret = cls_enq(pktio_entry, cos, pkt);
 	if (ret < 0) {
 		*pkt_ret = pkt;
 		return 1;
 	}
 
+	/* Packets handed back are counted by odp_pktio_recv() */
+	stats = pktio_stats(pktio_entry);
+	stats->in_packets++;
+	stats->in_octets += buf_len;
+
 	return 0;
 }
@@ -193,6 +193,27 @@ int promisc_mode_get_fd(int fd, const char *name)
 	return !!(ifr.ifr_flags & IFF_PROMISC);
 }
 
+/*
+ * ODP_PACKET_SOCKET_MMSG:
+ * ODP_PACKET_SOCKET_MMAP:
+ */
+int drops_get_fd(int fd, uint64_t *drops)
+{
+	struct tpacket_stats st;
+	socklen_t len = sizeof(st);
+
+	/* The kernel clears its counters on each read */
+	if (getsockopt(fd, SOL_PACKET, PACKET_STATISTICS, &st, &len) < 0) {
+		__odp_errno = errno;
+		ODP_DBG("getsockopt(PACKET_STATISTICS): %s\n",
+			strerror(errno));
+		return -1;
+	}
+
+	*drops += st.tp_drops;
+	return 0;
+}
+
 /*
  * ODP_PACKET_SOCKET_MMSG:
  */
@@ -406,7 +427,6 @@ static int sock_mmsg_recv(pktio_entry_t *pktio_entry,
 		for (i = 0; i < recv_msgs; i++) {
 			void *base = msgvec[i].msg_hdr.msg_iov->iov_base;
 			struct ethhdr *eth_hdr = base;
-			odp_packet_hdr_t *pkt_hdr;
 
 			/* Don't receive packets sent by ourselves */
 			if (odp_unlikely(ethaddrs_equal(pkt_sock->if_mac,
@@ -414,13 +434,10 @@ static int sock_mmsg_recv(pktio_entry_t *pktio_entry,
 				odp_packet_free(pkt_table[i]);
 				continue;
 			}
-			pkt_hdr = odp_packet_hdr(pkt_table[i]);
-			/* Parse and set packet header data */
+			/* Set packet length, parsing is done by the caller */
 			odp_packet_pull_tail(pkt_table[i],
 					     odp_packet_len(pkt_table[i]) -
 					     msgvec[i].msg_len);
-
-			packet_parse_l2(pkt_hdr);
 			pkt_table[nb_rx] = pkt_table[i];
 			nb_rx++;
 		}
@@ -533,6 +550,17 @@ static int sock_promisc_mode_get(pktio_entry_t *pktio_entry)
 				   pktio_entry->s.name);
 }
 
+static int sock_stats(pktio_entry_t *pktio_entry, odp_pktio_stats_t *stats)
+{
+	pkt_sock_t *pkt_sock = &pktio_entry->s.pkt_sock;
+
+	if (drops_get_fd(pkt_sock->sockfd, &pkt_sock->drops))
+		return -1;
+
+	stats->in_discards += pkt_sock->drops;
+	return 0;
+}
+
 const pktio_if_ops_t sock_mmsg_pktio_ops = {
 	.init = NULL,
 	.term = NULL,
@@ -545,5 +573,6 @@ const pktio_if_ops_t sock_mmsg_pktio_ops = {
 	.mtu_get = sock_mtu_get,
 	.promisc_mode_set = sock_promisc_mode_set,
 	.promisc_mode_get = sock_promisc_mode_get,
-	.mac_get = sock_mac_addr_get
+	.mac_get = sock_mac_addr_get,
+	.stats = sock_stats
 };
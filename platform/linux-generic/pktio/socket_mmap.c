@@ -154,15 +154,13 @@ static inline unsigned pkt_mmap_v2_rx(pktio_entry_t *pktio_entry,
 			if (ret)
 				nb_rx++;
 		} else {
-			odp_packet_hdr_t *hdr;
-
 			pkt_table[i] = packet_alloc(pkt_sock->pool, pkt_len, 1);
 			if (odp_unlikely(pkt_table[i] == ODP_PACKET_INVALID)) {
+				pktio_stats(pktio_entry)->in_no_buffers++;
 				mmap_rx_user_ready(ppd.raw); /* drop */
 				frame_num = next_frame_num;
 				continue;
 			}
-			hdr = odp_packet_hdr(pkt_table[i]);
 			ret = odp_packet_copydata_in(pkt_table[i], 0,
 						     pkt_len, pkt_buf);
 			if (ret != 0) {
@@ -172,7 +170,6 @@ static inline unsigned pkt_mmap_v2_rx(pktio_entry_t *pktio_entry,
 				continue;
 			}
 
-			packet_parse_l2(hdr);
 			nb_rx++;
 		}
 
@@ -554,6 +551,18 @@ static int sock_mmap_promisc_mode_get(pktio_entry_t *pktio_entry)
 				   pktio_entry->s.name);
 }
 
+static int sock_mmap_stats(pktio_entry_t *pktio_entry,
+			   odp_pktio_stats_t *stats)
+{
+	pkt_sock_mmap_t *pkt_sock = &pktio_entry->s.pkt_sock_mmap;
+
+	if (drops_get_fd(pkt_sock->sockfd, &pkt_sock->drops))
+		return -1;
+
+	stats->in_discards += pkt_sock->drops;
+	return 0;
+}
+
 const pktio_if_ops_t sock_mmap_pktio_ops = {
 	.init = NULL,
 	.term = NULL,
@@ -566,5 +575,6 @@ const pktio_if_ops_t sock_mmap_pktio_ops = {
 	.mtu_get = sock_mmap_mtu_get,
 	.promisc_mode_set = sock_mmap_promisc_mode_set,
 	.promisc_mode_get = sock_mmap_promisc_mode_get,
-	.mac_get = sock_mmap_mac_addr_get
+	.mac_get = sock_mmap_mac_addr_get,
+	.stats = sock_mmap_stats
 };
@@ -197,8 +197,6 @@ static odp_packet_t pack_odp_pkt(odp_pool_t pool,
 		return ODP_PACKET_INVALID;
 	}
 
-	packet_parse_l2(odp_packet_hdr(pkt));
-
 	return pkt;
 }
 
@@ -221,8 +219,11 @@ static int tap_pktio_recv(pktio_entry_t *pktio_entry, odp_packet_t pkts[],
 		}
 
 		pkts[i] = pack_odp_pkt(tap->pool, buf, retval);
-		if (pkts[i] == ODP_PACKET_INVALID)
+		if (pkts[i] == ODP_PACKET_INVALID) {
+			/* The frame has been read and is lost */
+			pktio_stats(pktio_entry)->in_no_buffers++;
 			break;
+		}
 	}
 
 	return i;
@@ -0,0 +1,1120 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/*
+ * AF_XDP packet IO
+ *
+ * One XSK socket is bound to each rx queue of the device and a minimal XDP
+ * program redirects every queue to its socket through an XSKMAP. Devices
+ * are opened by name ("eth0") or with an explicit prefix ("xdp:eth0").
+ *
+ * When the packet pool segments can hold a full UMEM chunk, the UMEM is
+ * registered over the pool memory (unaligned chunk mode): the fill ring is
+ * stocked with pool packets, received frames land directly in them and
+ * single segment packets of the pool are transmitted from where they are.
+ * Otherwise a private UMEM is used and packets are copied in and out of its
+ * frames. Sockets are bound in zero-copy mode when the program attached in
+ * driver mode, falling back to copy mode.
+ *
+ * Environment:
+ *   ODP_PKTIO_DISABLE_XDP     do not use this backend
+ *   ODP_PKTIO_XDP_COPY        never bind in zero-copy mode
+ *   ODP_PKTIO_XDP_BUSY_POLL   busy poll time in usec (SO_PREFER_BUSY_POLL)
+ */
+
+#ifdef HAVE_AF_XDP
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <odp_packet_xdp.h>
+#include <odp_packet_socket.h>
+#include <odp_packet_io_internal.h>
+#include <odp_packet_internal.h>
+#include <odp_pool_internal.h>
+#include <odp_debug_internal.h>
+#include <odp/thread.h>
+#include <odp/system_info.h>
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <linux/bpf.h>
+#include <linux/ethtool.h>
+#include <linux/if_link.h>
+#include <linux/if_xdp.h>
+#include <linux/sockios.h>
+
+#ifndef AF_XDP
+#define AF_XDP 44
+#endif
+#ifndef SOL_XDP
+#define SOL_XDP 283
+#endif
+#ifndef SO_PREFER_BUSY_POLL
+#define SO_PREFER_BUSY_POLL 69
+#endif
+#ifndef SO_BUSY_POLL_BUDGET
+#define SO_BUSY_POLL_BUDGET 70
+#endif
+
+#define XDP_RING_SIZE 512	/* descriptors per XSK ring, power of two */
+#define XDP_CHUNK_SIZE_MIN 2048	/* smallest UMEM chunk the kernel takes */
+#define XDP_FRAME_SIZE 4096	/* private UMEM frame size */
+#define XDP_FILL_NUM (XDP_RING_SIZE / 2) /* pool packets in a fill ring */
+#define XDP_BUSY_POLL_BUDGET 64	/* packets per busy poll */
+#define XDP_TX_RETRIES 10	/* kicks to wait for free tx descriptors */
+#define XDP_COPY_RETRIES 4	/* allocs to find a non page crossing copy */
+#define XDP_BIND_RETRIES 100	/* 1ms waits for a busy queue */
+
+/** Memory mapped XSK ring */
+typedef struct {
+	uint32_t *producer;		/**< producer index */
+	uint32_t *consumer;		/**< consumer index */
+	uint32_t *flags;		/**< XDP_RING_NEED_WAKEUP */
+	void *desc;			/**< descriptors */
+	uint32_t mask;			/**< ring size - 1 */
+	void *map;			/**< mapping of the ring */
+	size_t map_len;			/**< length of the mapping */
+} xdp_ring_t;
+
+/** XSK socket of one device queue */
+struct xdp_queue {
+	int fd;				/**< XSK socket */
+	xdp_ring_t rx;			/**< received descriptors */
+	xdp_ring_t tx;			/**< descriptors to send */
+	xdp_ring_t fill;		/**< UMEM addresses to receive into */
+	xdp_ring_t comp;		/**< UMEM addresses sent */
+	odp_ticketlock_t tx_lock;	/**< serializes senders on the queue */
+	uint8_t *umem;			/**< UMEM base address */
+	/* Pool UMEM */
+	odp_packet_t *pkt;		/**< packet owning each pool block
+					     handed to the kernel */
+	uint32_t fill_cnt;		/**< packets handed over by the fill
+					     ring and not received yet */
+	odp_packet_t *park;		/**< packets not usable as chunks */
+	uint32_t num_park;		/**< number of parked packets */
+	/* Private UMEM */
+	uint64_t *free_frame;		/**< free tx frames */
+	uint32_t num_free;		/**< number of free tx frames */
+};
+
+static inline uint32_t ring_avail(xdp_ring_t *ring)
+{
+	return __atomic_load_n(ring->producer, __ATOMIC_ACQUIRE) -
+	       *ring->consumer;
+}
+
+static inline uint32_t ring_free(xdp_ring_t *ring)
+{
+	return XDP_RING_SIZE - (*ring->producer -
+				__atomic_load_n(ring->consumer,
+						__ATOMIC_ACQUIRE));
+}
+
+static inline int ring_needs_wakeup(xdp_ring_t *ring)
+{
+	return __atomic_load_n(ring->flags, __ATOMIC_RELAXED) &
+	       XDP_RING_NEED_WAKEUP;
+}
+
+static inline int xdp_crosses_page(pkt_xdp_t *xdp, uint64_t addr,
+				   uint32_t len)
+{
+	return xdp->page_size &&
+	       (addr & (xdp->page_size - 1)) + len > xdp->page_size;
+}
+
+static int xdp_bpf(int cmd, union bpf_attr *attr)
+{
+	return syscall(__NR_bpf, cmd, attr, sizeof(*attr));
+}
+
+/* Create the XSKMAP, load the redirect program and attach it, in driver
+ * mode when possible */
+static int xdp_prog_attach(pkt_xdp_t *xdp)
+{
+	union bpf_attr attr;
+	/* return bpf_redirect_map(&xsks, ctx->rx_queue_index, XDP_PASS); */
+	struct bpf_insn prog[] = {
+		{ .code = BPF_LDX | BPF_MEM | BPF_W, .dst_reg = BPF_REG_2,
+		  .src_reg = BPF_REG_1,
+		  .off = offsetof(struct xdp_md, rx_queue_index) },
+		{ .code = BPF_LD | BPF_DW | BPF_IMM, .dst_reg = BPF_REG_1,
+		  .src_reg = BPF_PSEUDO_MAP_FD, .imm = 0 },
+		{ .code = 0 },
+		{ .code = BPF_ALU64 | BPF_MOV | BPF_K, .dst_reg = BPF_REG_3,
+		  .imm = XDP_PASS },
+		{ .code = BPF_JMP | BPF_CALL, .imm = BPF_FUNC_redirect_map },
+		{ .code = BPF_JMP | BPF_EXIT },
+	};
+	static const char license[] = "Dual BSD/GPL";
+
+	memset(&attr, 0, sizeof(attr));
+	attr.map_type = BPF_MAP_TYPE_XSKMAP;
+	attr.key_size = sizeof(uint32_t);
+	attr.value_size = sizeof(uint32_t);
+	attr.max_entries = XDP_MAX_QUEUES;
+	xdp->map_fd = xdp_bpf(BPF_MAP_CREATE, &attr);
+	if (xdp->map_fd < 0) {
+		ODP_DBG("XSKMAP create failed: %s\n", strerror(errno));
+		return -1;
+	}
+
+	prog[1].imm = xdp->map_fd;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.prog_type = BPF_PROG_TYPE_XDP;
+	attr.expected_attach_type = BPF_XDP;
+	attr.insns = (uintptr_t)prog;
+	attr.insn_cnt = sizeof(prog) / sizeof(prog[0]);
+	attr.license = (uintptr_t)license;
+	xdp->prog_fd = xdp_bpf(BPF_PROG_LOAD, &attr);
+	if (xdp->prog_fd < 0) {
+		ODP_DBG("XDP program load failed: %s\n", strerror(errno));
+		return -1;
+	}
+
+	/* The link detaches the program when closed, also on exit */
+	memset(&attr, 0, sizeof(attr));
+	attr.link_create.prog_fd = xdp->prog_fd;
+	attr.link_create.target_ifindex = xdp->ifindex;
+	attr.link_create.attach_type = BPF_XDP;
+	attr.link_create.flags = XDP_FLAGS_DRV_MODE;
+	xdp->link_fd = xdp_bpf(BPF_LINK_CREATE, &attr);
+	if (xdp->link_fd >= 0)
+		return 1;
+
+	attr.link_create.flags = XDP_FLAGS_SKB_MODE;
+	xdp->link_fd = xdp_bpf(BPF_LINK_CREATE, &attr);
+	if (xdp->link_fd < 0) {
+		ODP_DBG("XDP attach to %s failed: %s\n", xdp->if_name,
+			strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
+
+static unsigned xdp_num_queues(pkt_xdp_t *xdp)
+{
+	struct ethtool_channels channels;
+	struct ifreq ifr;
+	unsigned num;
+
+	memset(&channels, 0, sizeof(channels));
+	channels.cmd = ETHTOOL_GCHANNELS;
+	memset(&ifr, 0, sizeof(ifr));
+	snprintf(ifr.ifr_name, sizeof(ifr.ifr_name), "%s", xdp->if_name);
+	ifr.ifr_data = (void *)&channels;
+
+	if (ioctl(xdp->sockfd, SIOCETHTOOL, &ifr) < 0)
+		return 1;
+
+	num = channels.combined_count + channels.rx_count;
+	if (num == 0)
+		return 1;
+
+	return num > XDP_MAX_QUEUES ? XDP_MAX_QUEUES : num;
+}
+
+static int xdp_ring_map(int fd, xdp_ring_t *ring,
+			const struct xdp_ring_offset *off, off_t pgoff,
+			size_t desc_size)
+{
+	uint8_t *map;
+
+	ring->map_len = off->desc + XDP_RING_SIZE * desc_size;
+	map = mmap(NULL, ring->map_len, PROT_READ | PROT_WRITE,
+		   MAP_SHARED | MAP_POPULATE, fd, pgoff);
+	if (map == MAP_FAILED) {
+		ODP_ERR("XSK ring mmap failed: %s\n", strerror(errno));
+		return -1;
+	}
+
+	ring->map = map;
+	ring->producer = (uint32_t *)(void *)(map + off->producer);
+	ring->consumer = (uint32_t *)(void *)(map + off->consumer);
+	ring->flags = (uint32_t *)(void *)(map + off->flags);
+	ring->desc = map + off->desc;
+	ring->mask = XDP_RING_SIZE - 1;
+
+	return 0;
+}
+
+static void xdp_ring_unmap(xdp_ring_t *ring)
+{
+	if (ring->map != NULL)
+		munmap(ring->map, ring->map_len);
+	ring->map = NULL;
+}
+
+/* Keep the fill ring stocked with pool packets */
+static void xdp_fill_pool(pkt_xdp_t *xdp, struct xdp_queue *q)
+{
+	pool_entry_t *pool = odp_pool_to_entry(xdp->pool);
+	uint64_t *fill = q->fill.desc;
+	uint32_t prod = *q->fill.producer;
+	uint32_t len = pool->s.seg_size - pool->s.headroom - pool->s.tailroom;
+	uint32_t num = XDP_FILL_NUM - q->fill_cnt;
+	uint32_t i, n = 0;
+	uint64_t addr;
+	odp_packet_t pkt;
+
+	for (i = 0; i < num; i++) {
+		pkt = packet_alloc(xdp->pool, len, 1);
+		if (odp_unlikely(pkt == ODP_PACKET_INVALID))
+			break;
+
+		addr = (uint8_t *)odp_packet_hdr(pkt)->buf_hdr.addr[0] -
+		       q->umem;
+
+		/* Zero-copy drivers reject chunks that cross pages, keep
+		 * such blocks out of circulation */
+		if (odp_unlikely(xdp_crosses_page(xdp, addr,
+						  xdp->chunk_size))) {
+			q->park[q->num_park++] = pkt;
+			continue;
+		}
+
+		q->pkt[addr / pool->s.seg_size] = pkt;
+		fill[(prod + n) & q->fill.mask] = addr;
+		n++;
+	}
+
+	if (n) {
+		__atomic_store_n(q->fill.producer, prod + n, __ATOMIC_RELEASE);
+		q->fill_cnt += n;
+	}
+}
+
+/* A queue stays busy for a moment after its previous socket was closed,
+ * until the kernel has released the old UMEM */
+static int xdp_bind(int fd, struct sockaddr_xdp *sxdp)
+{
+	int i;
+
+	for (i = 0; i < XDP_BIND_RETRIES; i++) {
+		if (bind(fd, (struct sockaddr *)sxdp, sizeof(*sxdp)) == 0)
+			return 0;
+		if (errno != EBUSY)
+			break;
+		usleep(1000);
+	}
+
+	return -1;
+}
+
+static int xdp_queue_open(pktio_entry_t *pktio_entry, struct xdp_queue *q,
+			  uint32_t queue_id)
+{
+	pkt_xdp_t *xdp = &pktio_entry->s.pkt_xdp;
+	struct xdp_umem_reg reg;
+	struct xdp_mmap_offsets off;
+	struct sockaddr_xdp sxdp;
+	socklen_t optlen = sizeof(off);
+	int size = XDP_RING_SIZE;
+	int budget = XDP_BUSY_POLL_BUDGET;
+	int one = 1;
+	uint64_t *fill;
+	uint32_t i;
+
+	q->fd = socket(AF_XDP, SOCK_RAW, 0);
+	if (q->fd < 0) {
+		ODP_DBG("AF_XDP socket failed: %s\n", strerror(errno));
+		return -1;
+	}
+
+	memset(&reg, 0, sizeof(reg));
+	if (xdp->pool_umem) {
+		pool_entry_t *pool = odp_pool_to_entry(xdp->pool);
+
+		reg.addr = (uintptr_t)pool->s.pool_base_addr;
+		reg.len = pool->s.pool_size;
+		reg.flags = XDP_UMEM_UNALIGNED_CHUNK_FLAG;
+	} else {
+		reg.addr = (uintptr_t)q->umem;
+		reg.len = XDP_FRAME_SIZE * 2 * XDP_RING_SIZE;
+	}
+	reg.chunk_size = xdp->chunk_size;
+
+	if (setsockopt(q->fd, SOL_XDP, XDP_UMEM_REG, &reg, sizeof(reg)) ||
+	    setsockopt(q->fd, SOL_XDP, XDP_UMEM_FILL_RING, &size,
+		       sizeof(size)) ||
+	    setsockopt(q->fd, SOL_XDP, XDP_UMEM_COMPLETION_RING, &size,
+		       sizeof(size)) ||
+	    setsockopt(q->fd, SOL_XDP, XDP_RX_RING, &size, sizeof(size)) ||
+	    setsockopt(q->fd, SOL_XDP, XDP_TX_RING, &size, sizeof(size))) {
+		ODP_ERR("XSK setup failed: %s\n", strerror(errno));
+		return -1;
+	}
+
+	if (getsockopt(q->fd, SOL_XDP, XDP_MMAP_OFFSETS, &off, &optlen)) {
+		ODP_ERR("XSK mmap offsets failed: %s\n", strerror(errno));
+		return -1;
+	}
+
+	if (xdp_ring_map(q->fd, &q->fill, &off.fr, XDP_UMEM_PGOFF_FILL_RING,
+			 sizeof(uint64_t)) ||
+	    xdp_ring_map(q->fd, &q->comp, &off.cr,
+			 XDP_UMEM_PGOFF_COMPLETION_RING, sizeof(uint64_t)) ||
+	    xdp_ring_map(q->fd, &q->rx, &off.rx, XDP_PGOFF_RX_RING,
+			 sizeof(struct xdp_desc)) ||
+	    xdp_ring_map(q->fd, &q->tx, &off.tx, XDP_PGOFF_TX_RING,
+			 sizeof(struct xdp_desc)))
+		return -1;
+
+	if (xdp->busy_poll &&
+	    (setsockopt(q->fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &one,
+			sizeof(one)) ||
+	     setsockopt(q->fd, SOL_SOCKET, SO_BUSY_POLL, &xdp->busy_poll,
+			sizeof(xdp->busy_poll)) ||
+	     setsockopt(q->fd, SOL_SOCKET, SO_BUSY_POLL_BUDGET, &budget,
+			sizeof(budget)))) {
+		ODP_ERR("XSK busy poll setup failed: %s\n", strerror(errno));
+		return -1;
+	}
+
+	odp_ticketlock_init(&q->tx_lock);
+
+	/* Private UMEM: first half of the frames for rx, second for tx */
+	if (xdp->pool_umem) {
+		xdp_fill_pool(xdp, q);
+	} else {
+		fill = q->fill.desc;
+		for (i = 0; i < XDP_RING_SIZE; i++) {
+			fill[i] = (uint64_t)i * XDP_FRAME_SIZE;
+			q->free_frame[i] = (uint64_t)(XDP_RING_SIZE + i) *
+					   XDP_FRAME_SIZE;
+		}
+		q->num_free = XDP_RING_SIZE;
+		__atomic_store_n(q->fill.producer, XDP_RING_SIZE,
+				 __ATOMIC_RELEASE);
+	}
+
+	memset(&sxdp, 0, sizeof(sxdp));
+	sxdp.sxdp_family = AF_XDP;
+	sxdp.sxdp_ifindex = xdp->ifindex;
+	sxdp.sxdp_queue_id = queue_id;
+
+	if (xdp->zero_copy) {
+		sxdp.sxdp_flags = XDP_USE_NEED_WAKEUP | XDP_ZEROCOPY;
+		if (xdp_bind(q->fd, &sxdp) == 0)
+			return 0;
+
+		/* Not supported by the driver, fall back to copy mode */
+		ODP_DBG("%s: no zero-copy on queue %" PRIu32 "\n",
+			xdp->if_name, queue_id);
+		if (queue_id == 0)
+			xdp->zero_copy = 0;
+	}
+
+	sxdp.sxdp_flags = XDP_USE_NEED_WAKEUP | XDP_COPY;
+	if (xdp_bind(q->fd, &sxdp)) {
+		ODP_ERR("XSK bind to %s queue %" PRIu32 " failed: %s\n",
+			xdp->if_name, queue_id, strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
+
+static void xdp_queue_close(pkt_xdp_t *xdp, struct xdp_queue *q)
+{
+	uint32_t i, num_blks;
+	pool_entry_t *pool;
+
+	xdp_ring_unmap(&q->rx);
+	xdp_ring_unmap(&q->tx);
+	xdp_ring_unmap(&q->fill);
+	xdp_ring_unmap(&q->comp);
+
+	if (q->fd >= 0)
+		close(q->fd);
+	q->fd = -1;
+
+	if (!xdp->pool_umem)
+		return;
+
+	/* Socket is gone, packets the kernel held are ours again */
+	pool = odp_pool_to_entry(xdp->pool);
+	num_blks = pool->s.buf_num * pool->s.blk_size / pool->s.seg_size;
+	for (i = 0; i < num_blks; i++) {
+		if (q->pkt[i] != ODP_PACKET_INVALID)
+			odp_packet_free(q->pkt[i]);
+		q->pkt[i] = ODP_PACKET_INVALID;
+	}
+
+	for (i = 0; i < q->num_park; i++)
+		odp_packet_free(q->park[i]);
+	q->num_park = 0;
+	q->fill_cnt = 0;
+}
+
+static int xdp_close(pktio_entry_t *pktio_entry)
+{
+	pkt_xdp_t *xdp = &pktio_entry->s.pkt_xdp;
+	unsigned i;
+	int ret = 0;
+
+	/* Detach first, no more frames are redirected to the sockets */
+	if (xdp->link_fd >= 0)
+		close(xdp->link_fd);
+	xdp->link_fd = -1;
+
+	for (i = 0; i < xdp->num_queues; i++)
+		xdp_queue_close(xdp, &xdp->queue[i]);
+	xdp->num_queues = 0;
+
+	if (xdp->prog_fd >= 0)
+		close(xdp->prog_fd);
+	if (xdp->map_fd >= 0)
+		close(xdp->map_fd);
+	xdp->prog_fd = -1;
+	xdp->map_fd = -1;
+
+	if (xdp->umem_shm != ODP_SHM_INVALID && odp_shm_free(xdp->umem_shm))
+		ret = -1;
+	if (xdp->shm != ODP_SHM_INVALID && odp_shm_free(xdp->shm))
+		ret = -1;
+	xdp->umem_shm = ODP_SHM_INVALID;
+	xdp->shm = ODP_SHM_INVALID;
+
+	if (xdp->sockfd != -1 && close(xdp->sockfd) != 0) {
+		__odp_errno = errno;
+		ODP_ERR("close(sockfd): %s\n", strerror(errno));
+		ret = -1;
+	}
+	xdp->sockfd = -1;
+
+	return ret;
+}
+
+/* Pick the UMEM layout and reserve queue state */
+static int xdp_umem_init(odp_pktio_t id, pkt_xdp_t *xdp, int drv_mode)
+{
+	pool_entry_t *pool = odp_pool_to_entry(xdp->pool);
+	char shm_name[ODP_SHM_NAME_LEN];
+	odp_shm_info_t info;
+	uint32_t num_blks = 0;
+	size_t size;
+	uint8_t *addr;
+	unsigned i;
+
+	/* Pool UMEM needs whole chunks in a segment, and a pool large enough
+	 * to keep the fill rings deep without starving the application. A
+	 * shallow fill ring drops bursts. */
+	xdp->pool_umem = pool->s.seg_size >= XDP_CHUNK_SIZE_MIN &&
+			 pool->s.buf_num >= 4 * XDP_FILL_NUM * xdp->num_queues;
+
+	xdp->zero_copy = drv_mode && !getenv("ODP_PKTIO_XDP_COPY");
+
+	if (xdp->pool_umem) {
+		num_blks = pool->s.buf_num * pool->s.blk_size /
+			   pool->s.seg_size;
+		xdp->chunk_size = pool->s.seg_size < ODP_PAGE_SIZE ?
+				  pool->s.seg_size : ODP_PAGE_SIZE;
+
+		/* Segments cross small pages too often for zero-copy, on
+		 * huge pages only the few crossing chunks are parked */
+		if (odp_shm_info(pool->s.pool_shm, &info) ||
+		    info.page_size <= odp_sys_page_size())
+			xdp->zero_copy = 0;
+		else
+			xdp->page_size = info.page_size;
+
+		size = xdp->num_queues * (sizeof(struct xdp_queue) +
+					  2 * num_blks * sizeof(odp_packet_t));
+	} else {
+		xdp->chunk_size = XDP_FRAME_SIZE;
+		size = xdp->num_queues * (sizeof(struct xdp_queue) +
+					  XDP_RING_SIZE * sizeof(uint64_t));
+
+		snprintf(shm_name, sizeof(shm_name),
+			 "%" PRIu64 "-pktio_xdp_umem", odp_pktio_to_u64(id));
+		xdp->umem_shm = odp_shm_reserve(shm_name, xdp->num_queues *
+						XDP_FRAME_SIZE * 2 *
+						XDP_RING_SIZE,
+						ODP_PAGE_SIZE, 0);
+		if (xdp->umem_shm == ODP_SHM_INVALID)
+			return -1;
+	}
+	xdp->frame_len_max = xdp->chunk_size - XDP_PACKET_HEADROOM;
+
+	snprintf(shm_name, sizeof(shm_name), "%" PRIu64 "-pktio_xdp",
+		 odp_pktio_to_u64(id));
+	xdp->shm = odp_shm_reserve(shm_name, size, ODP_CACHE_LINE_SIZE, 0);
+	if (xdp->shm == ODP_SHM_INVALID)
+		return -1;
+
+	xdp->queue = odp_shm_addr(xdp->shm);
+	memset(xdp->queue, 0, sizeof(struct xdp_queue) * xdp->num_queues);
+	addr = (uint8_t *)&xdp->queue[xdp->num_queues];
+
+	for (i = 0; i < xdp->num_queues; i++) {
+		struct xdp_queue *q = &xdp->queue[i];
+		uint32_t j;
+
+		q->fd = -1;
+		if (xdp->pool_umem) {
+			q->umem = pool->s.pool_base_addr;
+			q->pkt = (odp_packet_t *)(void *)addr;
+			q->park = &q->pkt[num_blks];
+			addr += 2 * num_blks * sizeof(odp_packet_t);
+			for (j = 0; j < num_blks; j++)
+				q->pkt[j] = ODP_PACKET_INVALID;
+		} else {
+			q->umem = (uint8_t *)odp_shm_addr(xdp->umem_shm) +
+				  (size_t)i * XDP_FRAME_SIZE * 2 *
+				  XDP_RING_SIZE;
+			q->free_frame = (uint64_t *)(void *)addr;
+			addr += XDP_RING_SIZE * sizeof(uint64_t);
+		}
+	}
+
+	return 0;
+}
+
+static int xdp_open(odp_pktio_t id, pktio_entry_t *pktio_entry,
+		    const char *devname, odp_pool_t pool)
+{
+	pkt_xdp_t *xdp = &pktio_entry->s.pkt_xdp;
+	const char *env;
+	int drv_mode, mtu;
+	unsigned i;
+
+	if (getenv("ODP_PKTIO_DISABLE_XDP"))
+		return -1;
+
+	if (pool == ODP_POOL_INVALID)
+		return -1;
+
+	/* Init pktio entry */
+	memset(xdp, 0, sizeof(*xdp));
+	xdp->pool = pool;
+	xdp->sockfd = -1;
+	xdp->prog_fd = -1;
+	xdp->map_fd = -1;
+	xdp->link_fd = -1;
+	xdp->shm = ODP_SHM_INVALID;
+	xdp->umem_shm = ODP_SHM_INVALID;
+
+	if (strncmp(devname, "xdp:", 4) == 0)
+		devname += 4;
+	snprintf(xdp->if_name, sizeof(xdp->if_name), "%s", devname);
+
+	xdp->ifindex = if_nametoindex(xdp->if_name);
+	if (xdp->ifindex == 0)
+		return -1;
+
+	env = getenv("ODP_PKTIO_XDP_BUSY_POLL");
+	if (env != NULL)
+		xdp->busy_poll = atoi(env);
+
+	xdp->sockfd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (xdp->sockfd == -1) {
+		ODP_ERR("Cannot get device control socket\n");
+		goto error;
+	}
+
+	if (mac_addr_get_fd(xdp->sockfd, xdp->if_name, xdp->if_mac))
+		goto error;
+
+	xdp->num_queues = xdp_num_queues(xdp);
+
+	drv_mode = xdp_prog_attach(xdp);
+	if (drv_mode < 0)
+		goto error;
+
+	if (xdp_umem_init(id, xdp, drv_mode))
+		goto error;
+
+	/* Frames are limited by the UMEM chunk and by the device MTU */
+	mtu = mtu_get_fd(xdp->sockfd, xdp->if_name);
+	if (mtu < 0)
+		goto error;
+	if ((uint32_t)mtu + ETH_HLEN < xdp->frame_len_max)
+		xdp->frame_len_max = mtu + ETH_HLEN;
+
+	for (i = 0; i < xdp->num_queues; i++) {
+		union bpf_attr attr;
+		uint32_t key = i;
+		uint32_t fd;
+
+		if (xdp_queue_open(pktio_entry, &xdp->queue[i], i))
+			goto error;
+
+		fd = xdp->queue[i].fd;
+		memset(&attr, 0, sizeof(attr));
+		attr.map_fd = xdp->map_fd;
+		attr.key = (uintptr_t)&key;
+		attr.value = (uintptr_t)&fd;
+		if (xdp_bpf(BPF_MAP_UPDATE_ELEM, &attr)) {
+			ODP_ERR("XSKMAP update failed: %s\n", strerror(errno));
+			goto error;
+		}
+	}
+
+	/* Senders pick a queue by thread and lock only that queue */
+	pktio_entry->s.tx_mt_safe = 1;
+	pktio_entry->s.stats_num_queues = xdp->num_queues;
+
+	ODP_DBG("%s: AF_XDP %u queues, %s UMEM, %s mode\n", xdp->if_name,
+		xdp->num_queues, xdp->pool_umem ? "pool" : "private",
+		xdp->zero_copy ? "zero-copy" : "copy");
+
+	return 0;
+
+error:
+	xdp_close(pktio_entry);
+	return -1;
+}
+
+/* Reclaim sent frames from the completion ring */
+static void xdp_complete(pkt_xdp_t *xdp, struct xdp_queue *q)
+{
+	const uint64_t *comp = q->comp.desc;
+	uint32_t cons = *q->comp.consumer;
+	uint32_t avail = ring_avail(&q->comp);
+	uint32_t seg_size = 0;
+	uint32_t i, idx;
+	uint64_t addr;
+
+	if (avail == 0)
+		return;
+
+	if (xdp->pool_umem)
+		seg_size = odp_pool_to_entry(xdp->pool)->s.seg_size;
+
+	for (i = 0; i < avail; i++) {
+		addr = comp[(cons + i) & q->comp.mask];
+
+		if (xdp->pool_umem) {
+			idx = (addr & XSK_UNALIGNED_BUF_ADDR_MASK) / seg_size;
+			odp_packet_free(q->pkt[idx]);
+			q->pkt[idx] = ODP_PACKET_INVALID;
+		} else {
+			q->free_frame[q->num_free++] = addr &
+						       ~(uint64_t)(XDP_FRAME_SIZE - 1);
+		}
+	}
+
+	__atomic_store_n(q->comp.consumer, cons + avail, __ATOMIC_RELEASE);
+}
+
+static inline odp_packet_t xdp_rx_pool(pktio_entry_t *pktio_entry,
+				       struct xdp_queue *q,
+				       const struct xdp_desc *desc)
+{
+	pkt_xdp_t *xdp = &pktio_entry->s.pkt_xdp;
+	pool_entry_t *pool = odp_pool_to_entry(xdp->pool);
+	uint64_t base = desc->addr & XSK_UNALIGNED_BUF_ADDR_MASK;
+	uint64_t offset = desc->addr >> XSK_UNALIGNED_BUF_OFFSET_SHIFT;
+	uint32_t idx = base / pool->s.seg_size;
+	odp_packet_t pkt = q->pkt[idx];
+	odp_packet_t cls_pkt;
+	odp_packet_hdr_t *pkt_hdr;
+
+	q->pkt[idx] = ODP_PACKET_INVALID;
+	q->fill_cnt--;
+
+	if (pktio_cls_enabled(pktio_entry)) {
+		int ret = _odp_packet_cls_enq(pktio_entry,
+					      q->umem + base + offset,
+					      desc->len, &cls_pkt);
+
+		odp_packet_free(pkt);
+		return ret ? cls_pkt : ODP_PACKET_INVALID;
+	}
+
+	/* Frame was received in place, only set the data window */
+	pkt_hdr = odp_packet_hdr(pkt);
+	pkt_hdr->headroom = offset;
+	pkt_hdr->frame_len = desc->len;
+	pkt_hdr->tailroom = pool->s.seg_size * pkt_hdr->buf_hdr.segcount -
+			    offset - desc->len;
+
+	return pkt;
+}
+
+static inline odp_packet_t xdp_rx_copy(pktio_entry_t *pktio_entry,
+				       struct xdp_queue *q,
+				       const struct xdp_desc *desc)
+{
+	const uint8_t *data = q->umem + desc->addr;
+	odp_packet_t pkt;
+
+	if (pktio_cls_enabled(pktio_entry)) {
+		if (_odp_packet_cls_enq(pktio_entry, data, desc->len, &pkt))
+			return pkt;
+		return ODP_PACKET_INVALID;
+	}
+
+	pkt = packet_alloc(pktio_entry->s.pkt_xdp.pool, desc->len, 1);
+	if (odp_unlikely(pkt == ODP_PACKET_INVALID)) {
+		pktio_stats(pktio_entry)->in_no_buffers++;
+		return ODP_PACKET_INVALID;
+	}
+
+	if (odp_packet_copydata_in(pkt, 0, desc->len, data) != 0) {
+		odp_packet_free(pkt);
+		pktio_stats(pktio_entry)->in_errors++;
+		return ODP_PACKET_INVALID;
+	}
+
+	return pkt;
+}
+
+static unsigned xdp_queue_recv(pktio_entry_t *pktio_entry,
+			       struct xdp_queue *q, odp_packet_t pkt_table[],
+			       unsigned num)
+{
+	pkt_xdp_t *xdp = &pktio_entry->s.pkt_xdp;
+	const struct xdp_desc *desc = q->rx.desc;
+	uint64_t *fill = q->fill.desc;
+	uint32_t cons = *q->rx.consumer;
+	uint32_t fill_prod = *q->fill.producer;
+	uint32_t avail = ring_avail(&q->rx);
+	const struct xdp_desc *d;
+	odp_pktio_queue_stats_t *qstats;
+	odp_packet_t pkt;
+	uint64_t octets = 0;
+	unsigned i, nb_rx = 0;
+
+	if (avail > num)
+		avail = num;
+
+	for (i = 0; i < avail; i++) {
+		d = &desc[(cons + i) & q->rx.mask];
+		octets += d->len;
+
+		if (xdp->pool_umem) {
+			pkt = xdp_rx_pool(pktio_entry, q, d);
+		} else {
+			pkt = xdp_rx_copy(pktio_entry, q, d);
+			/* Frame is free again as soon as copied */
+			fill[fill_prod++ & q->fill.mask] = d->addr;
+		}
+
+		if (pkt != ODP_PACKET_INVALID)
+			pkt_table[nb_rx++] = pkt;
+	}
+
+	if (avail) {
+		__atomic_store_n(q->rx.consumer, cons + avail,
+				 __ATOMIC_RELEASE);
+
+		qstats = pktio_queue_stats(pktio_entry, q - xdp->queue);
+		qstats->in_packets += avail;
+		qstats->in_octets += octets;
+	}
+
+	if (xdp->pool_umem)
+		xdp_fill_pool(xdp, q);
+	else if (avail)
+		__atomic_store_n(q->fill.producer, fill_prod,
+				 __ATOMIC_RELEASE);
+
+	/* Sent packets go back to the pool as early as possible, the fill
+	 * ring is stocked from the same pool */
+	if (ring_avail(&q->comp) && odp_ticketlock_trylock(&q->tx_lock)) {
+		xdp_complete(xdp, q);
+		odp_ticketlock_unlock(&q->tx_lock);
+	}
+
+	/* Drive the device when the kernel asks for it or when busy
+	 * polling */
+	if (avail == 0 && (xdp->busy_poll || ring_needs_wakeup(&q->fill)))
+		recvfrom(q->fd, NULL, 0, MSG_DONTWAIT, NULL, NULL);
+
+	return nb_rx;
+}
+
+static int xdp_recv(pktio_entry_t *pktio_entry, odp_packet_t pkt_table[],
+		    unsigned num)
+{
+	pkt_xdp_t *xdp = &pktio_entry->s.pkt_xdp;
+	unsigned i, queue_id = xdp->rx_next;
+	unsigned num_rx = 0;
+
+	for (i = 0; i < xdp->num_queues && num_rx != num; i++) {
+		queue_id = xdp->rx_next + i;
+		if (queue_id >= xdp->num_queues)
+			queue_id -= xdp->num_queues;
+
+		num_rx += xdp_queue_recv(pktio_entry, &xdp->queue[queue_id],
+					 &pkt_table[num_rx], num - num_rx);
+	}
+	/* Continue from the queue after the last served one */
+	xdp->rx_next = queue_id + 1 < xdp->num_queues ? queue_id + 1 : 0;
+
+	return num_rx;
+}
+
+static inline void xdp_kick_tx(struct xdp_queue *q)
+{
+	if (ring_needs_wakeup(&q->tx))
+		sendto(q->fd, NULL, 0, MSG_DONTWAIT, NULL, 0);
+}
+
+/* Wait until the queue can take one more frame */
+static int xdp_tx_wait(pkt_xdp_t *xdp, struct xdp_queue *q, uint32_t prod)
+{
+	int i;
+
+	for (i = 0; i < XDP_TX_RETRIES; i++) {
+		if (xdp->pool_umem ? ring_free(&q->tx) != 0 : q->num_free != 0)
+			return 0;
+
+		__atomic_store_n(q->tx.producer, prod, __ATOMIC_RELEASE);
+		xdp_kick_tx(q);
+		xdp_complete(xdp, q);
+	}
+
+	return xdp->pool_umem ? ring_free(&q->tx) == 0 : q->num_free == 0;
+}
+
+/* Copy a packet into a pool packet usable as a single tx chunk */
+static odp_packet_t xdp_tx_copy(pkt_xdp_t *xdp, struct xdp_queue *q,
+				odp_packet_t pkt, uint32_t len)
+{
+	odp_packet_t copy;
+	uint64_t addr;
+	int i;
+
+	for (i = 0; i < XDP_COPY_RETRIES; i++) {
+		copy = packet_alloc(xdp->pool, len, 0);
+		if (copy == ODP_PACKET_INVALID)
+			return ODP_PACKET_INVALID;
+
+		addr = (uint8_t *)odp_packet_data(copy) - q->umem;
+		if (!xdp_crosses_page(xdp, addr, len)) {
+			odp_packet_copydata_out(pkt, 0, len,
+						odp_packet_data(copy));
+			return copy;
+		}
+
+		q->park[q->num_park++] = copy;
+	}
+
+	return ODP_PACKET_INVALID;
+}
+
+static unsigned xdp_send_pool(pkt_xdp_t *xdp, struct xdp_queue *q,
+			      odp_packet_t pkt_table[], unsigned num,
+			      int *too_big)
+{
+	struct xdp_desc *desc = q->tx.desc;
+	uint32_t prod = *q->tx.producer;
+	uint32_t seg_size = odp_pool_to_entry(xdp->pool)->s.seg_size;
+	odp_packet_t pkt, copy;
+	odp_packet_hdr_t *pkt_hdr;
+	uint32_t len;
+	uint64_t addr;
+	unsigned nb_tx;
+
+	for (nb_tx = 0; nb_tx < num; nb_tx++) {
+		pkt = pkt_table[nb_tx];
+		len = odp_packet_len(pkt);
+
+		if (odp_unlikely(len > xdp->frame_len_max)) {
+			*too_big = 1;
+			break;
+		}
+
+		if (odp_unlikely(xdp_tx_wait(xdp, q, prod)))
+			break;
+
+		pkt_hdr = odp_packet_hdr(pkt);
+		addr = (uint8_t *)odp_packet_data(pkt) - q->umem;
+
+		/* Chunks must come from this pool and be contiguous */
+		if (odp_unlikely(pkt_hdr->buf_hdr.pool_hdl != xdp->pool ||
+				 odp_packet_seg_len(pkt) != len ||
+				 xdp_crosses_page(xdp, addr, len))) {
+			copy = xdp_tx_copy(xdp, q, pkt, len);
+			if (copy == ODP_PACKET_INVALID)
+				break;
+			odp_packet_free(pkt);
+			pkt_table[nb_tx] = copy;
+			pkt = copy;
+			addr = (uint8_t *)odp_packet_data(pkt) - q->umem;
+		}
+
+		q->pkt[addr / seg_size] = pkt;
+		desc[prod & q->tx.mask].addr = addr;
+		desc[prod & q->tx.mask].len = len;
+		desc[prod & q->tx.mask].options = 0;
+		prod++;
+	}
+
+	__atomic_store_n(q->tx.producer, prod, __ATOMIC_RELEASE);
+
+	return nb_tx;
+}
+
+static unsigned xdp_send_copy(pkt_xdp_t *xdp, struct xdp_queue *q,
+			      odp_packet_t pkt_table[], unsigned num,
+			      int *too_big)
+{
+	struct xdp_desc *desc = q->tx.desc;
+	uint32_t prod = *q->tx.producer;
+	uint32_t len;
+	uint64_t addr;
+	unsigned i, nb_tx;
+
+	for (nb_tx = 0; nb_tx < num; nb_tx++) {
+		len = odp_packet_len(pkt_table[nb_tx]);
+
+		if (odp_unlikely(len > xdp->frame_len_max)) {
+			*too_big = 1;
+			break;
+		}
+
+		if (odp_unlikely(xdp_tx_wait(xdp, q, prod)))
+			break;
+
+		addr = q->free_frame[--q->num_free];
+		odp_packet_copydata_out(pkt_table[nb_tx], 0, len,
+					q->umem + addr);
+
+		desc[prod & q->tx.mask].addr = addr;
+		desc[prod & q->tx.mask].len = len;
+		desc[prod & q->tx.mask].options = 0;
+		prod++;
+	}
+
+	__atomic_store_n(q->tx.producer, prod, __ATOMIC_RELEASE);
+
+	for (i = 0; i < nb_tx; i++)
+		odp_packet_free(pkt_table[i]);
+
+	return nb_tx;
+}
+
+static int xdp_send(pktio_entry_t *pktio_entry, odp_packet_t pkt_table[],
+		    unsigned num)
+{
+	pkt_xdp_t *xdp = &pktio_entry->s.pkt_xdp;
+	unsigned queue_id = odp_thread_id() % xdp->num_queues;
+	struct xdp_queue *q = &xdp->queue[queue_id];
+	const struct xdp_desc *desc = q->tx.desc;
+	odp_pktio_queue_stats_t *qstats;
+	uint32_t prod;
+	uint64_t octets = 0;
+	unsigned nb_tx;
+	int too_big = 0;
+
+	odp_ticketlock_lock(&q->tx_lock);
+
+	xdp_complete(xdp, q);
+	prod = *q->tx.producer;
+
+	if (xdp->pool_umem)
+		nb_tx = xdp_send_pool(xdp, q, pkt_table, num, &too_big);
+	else
+		nb_tx = xdp_send_copy(xdp, q, pkt_table, num, &too_big);
+
+	if (nb_tx)
+		xdp_kick_tx(q);
+
+	/* Frame lengths are still in the descriptors just queued */
+	for (; prod != *q->tx.producer; prod++)
+		octets += desc[prod & q->tx.mask].len;
+
+	odp_ticketlock_unlock(&q->tx_lock);
+
+	qstats = pktio_queue_stats(pktio_entry, queue_id);
+	qstats->out_packets += nb_tx;
+	qstats->out_octets += octets;
+
+	if (odp_unlikely(too_big && nb_tx == 0)) {
+		__odp_errno = EMSGSIZE;
+		return -1;
+	}
+
+	return nb_tx;
+}
+
+static int xdp_mtu_get(pktio_entry_t *pktio_entry)
+{
+	return pktio_entry->s.pkt_xdp.frame_len_max - ETH_HLEN;
+}
+
+static int xdp_mac_addr_get(pktio_entry_t *pktio_entry, void *mac_addr)
+{
+	memcpy(mac_addr, pktio_entry->s.pkt_xdp.if_mac, ETH_ALEN);
+	return ETH_ALEN;
+}
+
+static int xdp_promisc_mode_set(pktio_entry_t *pktio_entry,
+				odp_bool_t enable)
+{
+	return promisc_mode_set_fd(pktio_entry->s.pkt_xdp.sockfd,
+				   pktio_entry->s.pkt_xdp.if_name, enable);
+}
+
+static int xdp_promisc_mode_get(pktio_entry_t *pktio_entry)
+{
+	return promisc_mode_get_fd(pktio_entry->s.pkt_xdp.sockfd,
+				   pktio_entry->s.pkt_xdp.if_name);
+}
+
+static int xdp_stats(pktio_entry_t *pktio_entry, odp_pktio_stats_t *stats)
+{
+	pkt_xdp_t *xdp = &pktio_entry->s.pkt_xdp;
+	struct xdp_statistics st;
+	socklen_t len;
+	unsigned i;
+
+	/* Kernel counters are cumulative per socket */
+	for (i = 0; i < xdp->num_queues; i++) {
+		/* Older kernels fill in only the first fields */
+		memset(&st, 0, sizeof(st));
+		len = sizeof(st);
+		if (getsockopt(xdp->queue[i].fd, SOL_XDP, XDP_STATISTICS,
+			       &st, &len)) {
+			__odp_errno = errno;
+			ODP_DBG("getsockopt(XDP_STATISTICS): %s\n",
+				strerror(errno));
+			return -1;
+		}
+
+		stats->in_discards += st.rx_dropped + st.rx_ring_full;
+		stats->in_no_buffers += st.rx_fill_ring_empty_descs;
+		stats->in_errors += st.rx_invalid_descs;
+		stats->out_errors += st.tx_invalid_descs;
+	}
+
+	return 0;
+}
+
+const pktio_if_ops_t xdp_pktio_ops = {
+	.init = NULL,
+	.term = NULL,
+	.open = xdp_open,
+	.close = xdp_close,
+	.start = NULL,
+	.stop = NULL,
+	.recv = xdp_recv,
+	.send = xdp_send,
+	.mtu_get = xdp_mtu_get,
+	.promisc_mode_set = xdp_promisc_mode_set,
+	.promisc_mode_get = xdp_promisc_mode_get,
+	.mac_get = xdp_mac_addr_get,
+	.stats = xdp_stats
+};
+
+#endif /* HAVE_AF_XDP */
@@ -0,0 +1,259 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * Multi-process instance test
+ *
+ * The primary process creates an instance with a buffer pool and queues,
+ * then starts itself again with exec() as a secondary process. The
+ * secondary shares nothing inherited from the primary: it attaches to the
+ * instance, allocates buffers from the primary's pool and enqueues them to
+ * the primary's queue. It also reserves a shm block of its own, which the
+ * primary checks before acknowledging.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <odp.h>
+
+#define NUM_BUFS	32
+#define BUF_SIZE	256
+#define MAGIC		0x6d701234
+#define TIMEOUT_US	(10 * 1000 * 1000)
+#define POLL_US		1000
+
+typedef struct {
+	uint32_t magic;
+	uint32_t seq;
+	int      pid;
+} msg_t;
+
+static odp_event_t deq_wait(odp_queue_t queue)
+{
+	odp_event_t ev;
+	int us;
+
+	for (us = 0; us < TIMEOUT_US; us += POLL_US) {
+		ev = odp_queue_deq(queue);
+		if (ev != ODP_EVENT_INVALID)
+			return ev;
+
+		usleep(POLL_US);
+	}
+
+	return ODP_EVENT_INVALID;
+}
+
+static int run_secondary(const char *instance)
+{
+	odp_platform_init_t plat;
+	odp_pool_t pool;
+	odp_queue_t queue, ack;
+	odp_buffer_t buf;
+	odp_event_t ev;
+	odp_shm_t shm;
+	msg_t *msg;
+	uint32_t *val;
+	int i, ret = 0;
+
+	memset(&plat, 0, sizeof(plat));
+	plat.instance  = instance;
+	plat.secondary = 1;
+
+	if (odp_init_global(NULL, &plat) ||
+	    odp_init_local(ODP_THREAD_CONTROL)) {
+		fprintf(stderr, "secondary: attach to %s failed\n", instance);
+		return -1;
+	}
+
+	pool  = odp_pool_lookup("mp_pool");
+	queue = odp_queue_lookup("mp_queue");
+	ack   = odp_queue_lookup("mp_ack");
+
+	if (pool == ODP_POOL_INVALID || queue == ODP_QUEUE_INVALID ||
+	    ack == ODP_QUEUE_INVALID) {
+		fprintf(stderr, "secondary: lookup failed\n");
+		return -1;
+	}
+
+	shm = odp_shm_reserve("mp_secondary", sizeof(uint32_t),
+			      ODP_CACHE_LINE_SIZE, 0);
+	val = odp_shm_addr(shm);
+	if (val == NULL) {
+		fprintf(stderr, "secondary: shm reserve failed\n");
+		return -1;
+	}
+	*val = MAGIC;
+
+	for (i = 0; i < NUM_BUFS; i++) {
+		buf = odp_buffer_alloc(pool);
+		if (buf == ODP_BUFFER_INVALID) {
+			fprintf(stderr, "secondary: buffer alloc failed\n");
+			return -1;
+		}
+
+		msg = odp_buffer_addr(buf);
+		msg->magic = MAGIC;
+		msg->seq   = i;
+		msg->pid   = getpid();
+
+		if (odp_queue_enq(queue, odp_buffer_to_event(buf))) {
+			fprintf(stderr, "secondary: enqueue failed\n");
+			odp_buffer_free(buf);
+			return -1;
+		}
+	}
+
+	/* Keep the shm block until the primary has checked it */
+	ev = deq_wait(ack);
+	if (ev == ODP_EVENT_INVALID) {
+		fprintf(stderr, "secondary: no ack\n");
+		ret = -1;
+	} else {
+		odp_buffer_free(odp_buffer_from_event(ev));
+	}
+
+	if (odp_shm_free(shm))
+		ret = -1;
+
+	if (odp_term_local() < 0 || odp_term_global())
+		ret = -1;
+
+	return ret;
+}
+
+static int check_msgs(odp_queue_t queue, odp_pool_t pool, pid_t pid)
+{
+	odp_buffer_t buf;
+	odp_event_t ev;
+	msg_t *msg;
+	int i, ret = 0;
+
+	for (i = 0; i < NUM_BUFS; i++) {
+		ev = deq_wait(queue);
+		if (ev == ODP_EVENT_INVALID) {
+			fprintf(stderr, "primary: buffer %i not received\n",
+				i);
+			return -1;
+		}
+
+		buf = odp_buffer_from_event(ev);
+		msg = odp_buffer_addr(buf);
+
+		if (odp_buffer_pool(buf) != pool || msg->magic != MAGIC ||
+		    msg->seq != (uint32_t)i || msg->pid != pid) {
+			fprintf(stderr, "primary: bad buffer %i\n", i);
+			ret = -1;
+		}
+
+		odp_buffer_free(buf);
+	}
+
+	return ret;
+}
+
+static int run_primary(const char *prog)
+{
+	char instance[32];
+	odp_platform_init_t plat;
+	odp_pool_param_t params;
+	odp_pool_t pool;
+	odp_queue_t queue, ack;
+	odp_buffer_t buf;
+	uint32_t *val;
+	pid_t pid;
+	int status, ret = 0;
+
+	snprintf(instance, sizeof(instance), "mp_test_%i", (int)getpid());
+
+	memset(&plat, 0, sizeof(plat));
+	plat.instance = instance;
+
+	if (odp_init_global(NULL, &plat) ||
+	    odp_init_local(ODP_THREAD_CONTROL)) {
+		fprintf(stderr, "primary: init failed\n");
+		return -1;
+	}
+
+	odp_pool_param_init(&params);
+	params.buf.size  = BUF_SIZE;
+	params.buf.align = 0;
+	params.buf.num   = NUM_BUFS + 1;
+	params.type      = ODP_POOL_BUFFER;
+
+	pool  = odp_pool_create("mp_pool", &params);
+	queue = odp_queue_create("mp_queue", ODP_QUEUE_TYPE_POLL, NULL);
+	ack   = odp_queue_create("mp_ack", ODP_QUEUE_TYPE_POLL, NULL);
+
+	if (pool == ODP_POOL_INVALID || queue == ODP_QUEUE_INVALID ||
+	    ack == ODP_QUEUE_INVALID) {
+		fprintf(stderr, "primary: create failed\n");
+		return -1;
+	}
+
+	pid = fork();
+	if (pid < 0)
+		return -1;
+
+	if (pid == 0) {
+		/* Nothing inherited: the secondary starts from scratch */
+		execl(prog, prog, "-s", instance, (char *)NULL);
+		_exit(EXIT_FAILURE);
+	}
+
+	if (check_msgs(queue, pool, pid))
+		ret = -1;
+
+	val = odp_shm_addr(odp_shm_lookup("mp_secondary"));
+	if (val == NULL || *val != MAGIC) {
+		fprintf(stderr, "primary: secondary shm block not visible\n");
+		ret = -1;
+	}
+
+	odp_shm_print_all();
+
+	buf = odp_buffer_alloc(pool);
+	if (buf == ODP_BUFFER_INVALID ||
+	    odp_queue_enq(ack, odp_buffer_to_event(buf)))
+		ret = -1;
+
+	if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) ||
+	    WEXITSTATUS(status) != EXIT_SUCCESS) {
+		fprintf(stderr, "primary: secondary failed\n");
+		ret = -1;
+	}
+
+	if (odp_queue_destroy(ack) || odp_queue_destroy(queue) ||
+	    odp_pool_destroy(pool))
+		ret = -1;
+
+	if (odp_term_local() < 0 || odp_term_global())
+		ret = -1;
+
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	int ret;
+
+	if (argc == 3 && strcmp(argv[1], "-s") == 0)
+		ret = run_secondary(argv[2]);
+	else
+		ret = run_primary("/proc/self/exe");
+
+	printf("%s: %s\n", argc == 3 ? "secondary" : "primary",
+	       ret ? "FAIL" : "PASS");
+
+	return ret ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,226 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * Scheduler idle sleep test
+ *
+ * A worker waits in odp_schedule() with a short spin and pause phase and
+ * a long sleep time, so it soon sleeps on the scheduler futex. The main
+ * thread lets it fall asleep, then enqueues an event. The worker must
+ * receive it well before the sleep time passes, which only an enqueue
+ * wake up does, and must have used little CPU time while waiting.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <odp.h>
+#include <odp/helper/linux.h>
+
+#define ROUNDS		5
+#define SLEEP_NS	(1000 * ODP_TIME_MSEC_IN_NS)
+#define IDLE_US		(100 * 1000)
+#define TIMEOUT_US	(10 * 1000 * 1000)
+#define POLL_US		1000
+
+typedef struct {
+	odp_queue_t queue;
+	odp_atomic_u32_t waiting;	/* Rounds the worker started */
+	odp_atomic_u32_t done;		/* Rounds the worker finished */
+	odp_atomic_u32_t errors;
+	uint64_t enq_ns;
+} test_globals_t;
+
+static test_globals_t *gbl;
+
+static uint64_t cpu_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (uint64_t)ts.tv_sec * ODP_TIME_SEC_IN_NS + ts.tv_nsec;
+}
+
+static void *worker(void *arg ODP_UNUSED)
+{
+	uint64_t start, cpu, wake_ns, wait_ns;
+	odp_event_t ev;
+	int i;
+
+	for (i = 0; i < ROUNDS; i++) {
+		start = odp_time_to_ns(odp_time_local());
+		cpu = cpu_ns();
+		odp_atomic_inc_u32(&gbl->waiting);
+
+		ev = odp_schedule(NULL, ODP_SCHED_WAIT);
+
+		wake_ns = odp_time_to_ns(odp_time_local());
+		cpu     = cpu_ns() - cpu;
+		wait_ns = wake_ns - start;
+
+		printf("  round %i: woken up %" PRIu64 " us after the enqueue,"
+		       " %" PRIu64 " us CPU in %" PRIu64 " us\n", i,
+		       (wake_ns - gbl->enq_ns) / 1000, cpu / 1000,
+		       wait_ns / 1000);
+
+		/* The sleep time passing would wake it up too late */
+		if (wake_ns - gbl->enq_ns > SLEEP_NS / 2) {
+			fprintf(stderr, "round %i: not woken up by enqueue\n",
+				i);
+			odp_atomic_inc_u32(&gbl->errors);
+		}
+
+		if (cpu > wait_ns / 2) {
+			fprintf(stderr, "round %i: did not sleep\n", i);
+			odp_atomic_inc_u32(&gbl->errors);
+		}
+
+		odp_event_free(ev);
+		odp_atomic_inc_u32(&gbl->done);
+	}
+
+	return NULL;
+}
+
+static int wait_for(odp_atomic_u32_t *cnt, uint32_t val)
+{
+	int us;
+
+	for (us = 0; us < TIMEOUT_US; us += POLL_US) {
+		if (odp_atomic_load_u32(cnt) >= val)
+			return 0;
+
+		usleep(POLL_US);
+	}
+
+	return -1;
+}
+
+static int run_test(void)
+{
+	odph_linux_pthread_t thread;
+	odp_pool_param_t params;
+	odp_queue_param_t qp;
+	odp_cpumask_t mask;
+	odp_pool_t pool;
+	odp_buffer_t buf;
+	odp_shm_t shm;
+	int i, ret = 0;
+
+	shm = odp_shm_reserve("test_globals", sizeof(test_globals_t),
+			      ODP_CACHE_LINE_SIZE, 0);
+	gbl = odp_shm_addr(shm);
+	if (gbl == NULL) {
+		fprintf(stderr, "shm reserve failed\n");
+		return -1;
+	}
+	memset(gbl, 0, sizeof(*gbl));
+	odp_atomic_init_u32(&gbl->waiting, 0);
+	odp_atomic_init_u32(&gbl->done, 0);
+	odp_atomic_init_u32(&gbl->errors, 0);
+
+	odp_pool_param_init(&params);
+	params.buf.size  = 64;
+	params.buf.align = 0;
+	params.buf.num   = ROUNDS;
+	params.type      = ODP_POOL_BUFFER;
+
+	pool = odp_pool_create("sched_idle_pool", &params);
+
+	odp_queue_param_init(&qp);
+	qp.sched.prio  = ODP_SCHED_PRIO_DEFAULT;
+	qp.sched.sync  = ODP_SCHED_SYNC_NONE;
+	qp.sched.group = ODP_SCHED_GROUP_ALL;
+	gbl->queue = odp_queue_create("sched_idle_queue", ODP_QUEUE_TYPE_SCHED,
+				      &qp);
+
+	if (pool == ODP_POOL_INVALID || gbl->queue == ODP_QUEUE_INVALID) {
+		fprintf(stderr, "pool or queue create failed\n");
+		return -1;
+	}
+
+	odp_cpumask_default_worker(&mask, 1);
+	if (odph_linux_pthread_create(&thread, &mask, worker, NULL,
+				      ODP_THREAD_WORKER) != 1) {
+		fprintf(stderr, "worker create failed\n");
+		return -1;
+	}
+
+	for (i = 0; i < ROUNDS; i++) {
+		if (wait_for(&gbl->waiting, i + 1)) {
+			fprintf(stderr, "round %i: worker not waiting\n", i);
+			ret = -1;
+			break;
+		}
+
+		/* Let the worker go through spin and pause and fall asleep */
+		usleep(IDLE_US);
+
+		buf = odp_buffer_alloc(pool);
+		gbl->enq_ns = odp_time_to_ns(odp_time_local());
+		if (buf == ODP_BUFFER_INVALID ||
+		    odp_queue_enq(gbl->queue, odp_buffer_to_event(buf))) {
+			fprintf(stderr, "round %i: enqueue failed\n", i);
+			ret = -1;
+			break;
+		}
+
+		if (wait_for(&gbl->done, i + 1)) {
+			fprintf(stderr, "round %i: event not received\n", i);
+			ret = -1;
+			break;
+		}
+	}
+
+	/* A worker left waiting would never return */
+	if (ret) {
+		odp_term_local();
+		exit(EXIT_FAILURE);
+	}
+
+	odph_linux_pthread_join(&thread, 1);
+
+	if (odp_atomic_load_u32(&gbl->errors))
+		ret = -1;
+
+	if (odp_queue_destroy(gbl->queue) || odp_pool_destroy(pool) ||
+	    odp_shm_free(shm))
+		ret = -1;
+
+	return ret;
+}
+
+int main(void)
+{
+	odp_platform_init_t plat;
+	int ret;
+
+	/* Asleep after a few empty polls, for longer than the test waits */
+	memset(&plat, 0, sizeof(plat));
+	plat.sched_idle_spin     = 10;
+	plat.sched_idle_pause    = 10;
+	plat.sched_idle_sleep_ns = SLEEP_NS;
+
+	if (odp_init_global(NULL, &plat) ||
+	    odp_init_local(ODP_THREAD_CONTROL)) {
+		fprintf(stderr, "init failed\n");
+		return EXIT_FAILURE;
+	}
+
+	ret = run_test();
+
+	if (odp_term_local() || odp_term_global()) {
+		fprintf(stderr, "term failed\n");
+		ret = -1;
+	}
+
+	return ret ? EXIT_FAILURE : EXIT_SUCCESS;
+}
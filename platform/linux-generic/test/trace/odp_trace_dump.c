@@ -0,0 +1,246 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * Print the trace snapshot of a running ODP application
+ *
+ * Maps the "odp_trace_<pid>" shm block of an application built with
+ * --enable-trace read-only and prints per trace point latency percentiles,
+ * summed over all threads, and the most recent events of each thread.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <odp_trace_internal.h>
+
+static const double percentile[] = {50.0, 90.0, 99.0, 99.9};
+
+#define NUM_PERCENTILES (sizeof(percentile) / sizeof(percentile[0]))
+
+static double cycles_to_ns(const trace_shm_t *shm, uint64_t cycles)
+{
+	if (shm->cpu_hz == 0)
+		return 0.0;
+
+	return (double)cycles * 1000000000.0 / shm->cpu_hz;
+}
+
+static void print_hist(const trace_shm_t *shm, int point)
+{
+	static trace_hist_t sum;
+	uint64_t target, seen;
+	unsigned b, p;
+	int thr;
+
+	memset(&sum, 0, sizeof(sum));
+	sum.min = UINT64_MAX;
+
+	/* Writers do not stop, the snapshot is approximate */
+	for (thr = 0; thr < ODP_THREAD_COUNT_MAX; thr++) {
+		const trace_hist_t *hist = &shm->thread[thr].hist[point];
+
+		if (hist->count == 0)
+			continue;
+
+		sum.count += hist->count;
+		sum.sum += hist->sum;
+		if (hist->min < sum.min)
+			sum.min = hist->min;
+		if (hist->max > sum.max)
+			sum.max = hist->max;
+		for (b = 0; b < TRACE_HIST_BUCKETS; b++)
+			sum.bucket[b] += hist->bucket[b];
+	}
+
+	printf("%-*s", TRACE_NAME_LEN, shm->point_name[point]);
+
+	if (sum.count == 0) {
+		printf(" %12" PRIu64 "\n", sum.count);
+		return;
+	}
+
+	printf(" %12" PRIu64 " %8" PRIu64 " %8" PRIu64, sum.count,
+	       sum.sum / sum.count, sum.min);
+
+	for (p = 0, seen = 0, b = 0; p < NUM_PERCENTILES; p++) {
+		target = (uint64_t)(sum.count * percentile[p] / 100.0);
+
+		for (; b < TRACE_HIST_BUCKETS - 1; b++) {
+			if (seen + sum.bucket[b] > target)
+				break;
+			seen += sum.bucket[b];
+		}
+
+		printf(" %8" PRIu64, trace_hist_bucket_min(b));
+	}
+
+	printf(" %8" PRIu64 "  (avg %.0f ns)\n", sum.max,
+	       cycles_to_ns(shm, sum.sum / sum.count));
+}
+
+static void print_events(const trace_shm_t *shm, int thr, unsigned num)
+{
+	const trace_thread_t *t = &shm->thread[thr];
+	uint64_t head = __atomic_load_n(&t->head, __ATOMIC_ACQUIRE);
+	uint64_t first, i;
+
+	if (head == 0)
+		return;
+
+	if (num > TRACE_RING_SIZE)
+		num = TRACE_RING_SIZE;
+	first = head > num ? head - num : 0;
+
+	printf("\nThread %i, %" PRIu64 " events\n", thr, head);
+
+	for (i = first; i < head; i++) {
+		const trace_event_t *ev = &t->ring[i & (TRACE_RING_SIZE - 1)];
+
+		if (ev->point >= TRACE_NUM_POINTS)
+			continue;
+
+		printf("  %20" PRIu64 "  %-*s %10" PRIu32 " cycles  arg %u\n",
+		       ev->start, TRACE_NAME_LEN, shm->point_name[ev->point],
+		       ev->cycles, ev->arg);
+	}
+}
+
+static void print_snapshot(const trace_shm_t *shm, unsigned events)
+{
+	unsigned p;
+	int thr;
+
+	printf("\nTrace snapshot, %" PRIu64 " Hz, mask 0x%" PRIx32
+	       ", durations in cycles\n", shm->cpu_hz, shm->mask);
+	printf("%-*s %12s %8s %8s", TRACE_NAME_LEN, "point", "count", "avg",
+	       "min");
+	for (p = 0; p < NUM_PERCENTILES; p++)
+		printf(" %7.1f%%", percentile[p]);
+	printf(" %8s\n", "max");
+
+	for (p = 0; p < TRACE_NUM_POINTS; p++)
+		print_hist(shm, p);
+
+	if (events == 0)
+		return;
+
+	for (thr = 0; thr < ODP_THREAD_COUNT_MAX; thr++)
+		print_events(shm, thr, events);
+}
+
+static void usage(char *progname)
+{
+	printf("\n"
+	       "Usage: %s [OPTIONS] <pid | shm file>\n"
+	       "  E.g. %s -e 16 -i 1 $(pidof odp_l2fwd)\n"
+	       "\n"
+	       "Optional OPTIONS\n"
+	       "  -e, --events <number>   Print last events of each thread\n"
+	       "  -i, --interval <sec>    Print a snapshot every interval\n"
+	       "  -h, --help              Display help and exit.\n"
+	       "\n", progname, progname);
+}
+
+int main(int argc, char *argv[])
+{
+	char path[256];
+	const trace_shm_t *shm;
+	struct stat st;
+	unsigned events = 0;
+	int interval = 0;
+	int opt, long_index, fd;
+	char *end;
+
+	static struct option longopts[] = {
+		{"events", required_argument, NULL, 'e'},
+		{"interval", required_argument, NULL, 'i'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	while (1) {
+		opt = getopt_long(argc, argv, "+e:i:h", longopts, &long_index);
+
+		if (opt == -1)
+			break;
+
+		switch (opt) {
+		case 'e':
+			events = atoi(optarg);
+			break;
+		case 'i':
+			interval = atoi(optarg);
+			break;
+		case 'h':
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+		default:
+			usage(argv[0]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (optind != argc - 1) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	strtol(argv[optind], &end, 10);
+	if (*end == '\0')
+		snprintf(path, sizeof(path), "/dev/shm/odp_trace_%s",
+			 argv[optind]);
+	else
+		snprintf(path, sizeof(path), "%s", argv[optind]);
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0 || fstat(fd, &st)) {
+		fprintf(stderr, "Error: cannot open %s\n", path);
+		exit(EXIT_FAILURE);
+	}
+
+	if ((size_t)st.st_size < sizeof(trace_shm_t)) {
+		fprintf(stderr, "Error: %s is not a trace snapshot\n", path);
+		exit(EXIT_FAILURE);
+	}
+
+	shm = mmap(NULL, sizeof(trace_shm_t), PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (shm == MAP_FAILED) {
+		fprintf(stderr, "Error: cannot map %s\n", path);
+		exit(EXIT_FAILURE);
+	}
+
+	if (__atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) != TRACE_MAGIC ||
+	    shm->version != TRACE_VERSION ||
+	    shm->num_threads != ODP_THREAD_COUNT_MAX ||
+	    shm->num_points != TRACE_NUM_POINTS ||
+	    shm->ring_size != TRACE_RING_SIZE ||
+	    shm->hist_sub_bits != TRACE_HIST_SUB_BITS ||
+	    shm->hist_buckets != TRACE_HIST_BUCKETS) {
+		fprintf(stderr, "Error: %s layout does not match\n", path);
+		exit(EXIT_FAILURE);
+	}
+
+	do {
+		print_snapshot(shm, events);
+		if (interval)
+			sleep(interval);
+	} while (interval);
+
+	munmap((void *)(uintptr_t)shm, sizeof(trace_shm_t));
+
+	return EXIT_SUCCESS;
+}
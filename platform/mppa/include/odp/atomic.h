@@ -113,7 +113,7 @@ static inline uint64_t odp_atomic_fetch_add_u64(odp_atomic_u64_t *atom,
 {
 	unsigned long long val64 = val;
 	asm volatile ("afdau 0[%1] = %0\n;;\n" : "+r"(val64) : "r" (&atom->_u64): "memory");
-	return (unsigned)val64;
+	return val64;
 }
 
 static inline uint64_t odp_atomic_fetch_sub_u64(odp_atomic_u64_t *atom,
@@ -121,7 +121,7 @@ static inline uint64_t odp_atomic_fetch_sub_u64(odp_atomic_u64_t *atom,
 {
 	long long val64 = -val;
 	asm volatile ("afdau 0[%1] = %0\n;;\n" : "+r"(val64) : "r" (&atom->_u64): "memory");
-	return (unsigned)val64;
+	return val64;
 }
 
 static inline void odp_atomic_add_u64(odp_atomic_u64_t *atom, uint64_t val)
@@ -0,0 +1,28 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP MCS lock
+ */
+
+#ifndef ODP_PLAT_MCSLOCK_H_
+#define ODP_PLAT_MCSLOCK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/plat/mcslock_types.h>
+
+#include <odp/api/mcslock.h>
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
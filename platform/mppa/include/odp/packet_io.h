@@ -23,6 +23,7 @@ extern "C" {
 #include <odp/plat/packet_types.h>
 #include <odp/plat/packet_io_types.h>
 #include <odp/plat/queue_types.h>
+#include <odp/packet.h>
 
 /** @ingroup odp_packet_io
  *  @{
@@ -17,6 +17,8 @@
 extern "C" {
 #endif
 
+#include <odp/std_types.h>
+
 /**
  * @internal platform specific data
  */
@@ -26,6 +28,12 @@ typedef struct odp_platform_init_t {
 	int sort_buffers;               /**< Force buffer reordering when n_rx_thr > 1
 					 * This only work if a pktio is affected to a single threads */
 	unsigned enable_pkt_nofree;     /**< Enable usage of the nofree refcount in packets */
+	int sched_idle_spin;            /**< Empty odp_schedule() polls before pausing.
+					 *   0: default, -1: always busy poll */
+	int sched_idle_pause;           /**< Polls with CPU backoff before sleeping.
+					 *   0: default, -1: none */
+	int64_t sched_idle_sleep_ns;    /**< Sleep time between polls when idle, the wake
+					 *   latency. 0 (default) or -1: never sleep */
 } odp_platform_init_t;
 
 #ifdef __cplusplus
@@ -80,6 +80,12 @@ typedef struct _odp_pktio_stats_t {
 	 */
 	uint64_t in_dropped;
 
+	/**
+	 * The number of inbound packets dropped because no packet buffer was
+	 * available. These packets are also counted in in_discards.
+	 */
+	uint64_t in_no_buffers;
+
 	/**
 	 * The sum for this interface of AlignmentErrors, FCSErrors, FrameTooLongs,
 	 * InternalMacReceiveErrors. See ifInErrors in RFC 3635.
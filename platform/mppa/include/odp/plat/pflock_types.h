@@ -0,0 +1,38 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+
+/**
+ * @file
+ *
+ * ODP phase-fair reader/writer lock
+ */
+
+#ifndef ODP_PFLOCK_TYPES_H_
+#define ODP_PFLOCK_TYPES_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/atomic.h>
+
+/** @internal */
+struct odp_pflock_s {
+	odp_atomic_u32_t rd_in;  /**< Readers entered (upper bits) and
+				      writer present/phase (lower bits) */
+	odp_atomic_u32_t rd_out; /**< Readers exited */
+	odp_atomic_u32_t wr_in;  /**< Writer tickets taken */
+	odp_atomic_u32_t wr_out; /**< Writer tickets served */
+};
+
+typedef struct odp_pflock_s odp_pflock_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
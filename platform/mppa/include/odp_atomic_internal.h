@@ -195,7 +195,7 @@ static inline uint32_t _odp_atomic_u32_xchg_mm(odp_atomic_u32_t *atom,
 
 		uint32_t ret_val = tmp & 0xFFFFFFFF;
 		if (ret_val == old_val)
-			return 1;
+			return old_val;
 
 		old_val = ret_val;
 	} while(1);
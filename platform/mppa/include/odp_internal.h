@@ -39,12 +39,19 @@ struct odp_global_data_s {
 	uint32_t n_rx_thr;
 	uint32_t enable_pkt_nofree;
 	uint32_t sort_buffers;
+	struct {
+		int spin;
+		int pause;
+		int64_t sleep_ns;
+	} sched_idle;
 };
 
 extern struct odp_global_data_s odp_global_data;
 
 int odp_system_info_init(void);
 
+int _odp_sleep_ns(uint64_t ns);
+
 int odp_thread_init_global(void);
 int odp_thread_init_local(odp_thread_type_t type);
 int odp_thread_term_local(void);
@@ -80,6 +87,11 @@ int odp_schedule_term_local(void);
 int odp_timer_init_global(void);
 int odp_timer_disarm_all(void);
 
+int odp_rcu_init_global(void);
+int odp_rcu_term_global(void);
+int odp_rcu_init_local(void);
+int odp_rcu_term_local(void);
+
 int odp_time_global_init(void);
 
 void _odp_flush_caches(void);
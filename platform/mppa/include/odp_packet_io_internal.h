@@ -28,6 +28,7 @@ extern "C" {
 #include <odp/rpc/rpc.h>
 
 #include <odp/config.h>
+#include <odp/thread.h>
 #include <odp/hints.h>
 
 #define PKTIO_NAME_LEN 256
@@ -179,6 +180,11 @@ typedef struct {
 	pkt_tx_uc_config tx_config;
 } pkt_pcie_t;
 
+/** Statistics counters updated by a single thread, summed when read */
+typedef struct {
+	odp_pktio_stats_t cnt ODP_ALIGNED_CACHE;
+} pktio_stats_slot_t;
+
 struct pktio_entry {
 	const struct pktio_if_ops *ops; /**< Implementation specific methods */
 	odp_ticketlock_t lock;		/**< entry ticketlock */
@@ -190,6 +196,9 @@ struct pktio_entry {
 	classifier_t cls;		/**< classifier linked with this pktio*/
 	char name[PKTIO_NAME_LEN];      /**< name of pktio provided to
 					     pktio_open() */
+	pktio_stats_slot_t stats[ODP_THREAD_COUNT_MAX];
+					/**< counters, one slot per thread */
+	odp_pktio_stats_t stats_base;	/**< counters at last reset */
 
 
 	union {
@@ -262,8 +271,26 @@ static inline void pktio_cls_enabled_set(pktio_entry_t *entry, int ena)
 	entry->s.cls_enabled = ena;
 }
 
+/** Counters of the calling thread */
+static inline odp_pktio_stats_t *pktio_stats(pktio_entry_t *entry)
+{
+	return &entry->s.stats[odp_thread_id()].cnt;
+}
+
 int pktin_poll(pktio_entry_t *entry);
 
+/**
+ * Add a classified packet to the open vector of a CoS queue
+ *
+ * Vectors are collected per thread and enqueued when full or at the end of
+ * odp_pktio_recv().
+ *
+ * @return 0 on success, -1 if no vector could be allocated
+ */
+int _odp_pktio_vec_add(pktio_entry_t *entry, queue_entry_t *queue,
+		       const odp_packet_vector_param_t *param,
+		       odp_packet_t pkt);
+
 extern const pktio_if_ops_t loopback_pktio_ops;
 extern const pktio_if_ops_t magic_pktio_ops;
 extern const pktio_if_ops_t cluster_pktio_ops;
@@ -0,0 +1,88 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * ODP RCU - implementation internal
+ *
+ * Grace periods are numbered by a global counter. Each thread publishes in
+ * its own cache line the last grace period number it has observed in a
+ * quiescent state, or zero while offline. odp_rcu_synchronize() starts a
+ * new grace period by incrementing the counter and waits until all online
+ * threads have observed it.
+ *
+ * Grace period counters are accessed uncached. Data caches are not coherent,
+ * so a quiescent state also invalidates the L1 data cache: protected data
+ * read after it is fetched from memory, and lines of memory freed after a
+ * grace period cannot be stale.
+ */
+
+#ifndef ODP_RCU_INTERNAL_H_
+#define ODP_RCU_INTERNAL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <odp/align.h>
+#include <odp/atomic.h>
+#include <odp/hints.h>
+#include <odp/sync.h>
+#include <odp/thread.h>
+#include <odp_atomic_internal.h>
+
+/** Quiescent state value of an offline thread */
+#define RCU_OFFLINE 0
+
+/** Per thread quiescent state */
+typedef struct {
+	odp_atomic_u64_t qs;	/**< last observed grace period */
+} ODP_ALIGNED_CACHE rcu_thread_t;
+
+/** RCU global state */
+typedef struct {
+	odp_atomic_u64_t gp ODP_ALIGNED_CACHE; /**< current grace period */
+	rcu_thread_t thread[ODP_THREAD_COUNT_MAX]; /**< by thread id */
+} rcu_global_t;
+
+extern rcu_global_t *rcu_global;
+extern __thread rcu_thread_t *rcu_local;
+
+/** Report a quiescent state of the calling thread */
+static inline void _odp_rcu_quiescent(void)
+{
+	rcu_thread_t *thr = rcu_local;
+	uint64_t gp, qs;
+
+	if (odp_unlikely(thr == NULL))
+		return;
+
+	__builtin_k1_dinval();
+
+	/* Acquire pairs with the grace period start, reads after this see
+	 * the updates published before it */
+	gp = _odp_atomic_u64_load_mm(&rcu_global->gp, _ODP_MEMMODEL_ACQ);
+	qs = _odp_atomic_u64_load_mm(&thr->qs, _ODP_MEMMODEL_RLX);
+
+	if (odp_likely(qs == gp))
+		return;
+
+	/* Release orders the reads done before the quiescent state */
+	__builtin_k1_wpurge();
+	_odp_atomic_u64_store_mm(&thr->qs, gp, _ODP_MEMMODEL_RLS);
+
+	/* Coming online, the new state must be visible to updaters before
+	 * the thread reads any protected data */
+	if (qs == RCU_OFFLINE)
+		odp_mb_full();
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -122,6 +122,9 @@ int odp_init_global(const odp_init_t *params,
 	odp_global_data.n_rx_thr = DEF_N_RX_THR;
 	odp_global_data.enable_pkt_nofree = 0;
 	odp_global_data.sort_buffers = 0;
+	odp_global_data.sched_idle.spin = 0;
+	odp_global_data.sched_idle.pause = 0;
+	odp_global_data.sched_idle.sleep_ns = 0;
 	if (params != NULL) {
 		if (params->log_fn != NULL)
 			odp_global_data.log_fn = params->log_fn;
@@ -139,6 +142,12 @@ int odp_init_global(const odp_init_t *params,
 			odp_global_data.sort_buffers = 1;
 		odp_global_data.enable_pkt_nofree =
 			platform_params->enable_pkt_nofree;
+		odp_global_data.sched_idle.spin =
+			platform_params->sched_idle_spin;
+		odp_global_data.sched_idle.pause =
+			platform_params->sched_idle_pause;
+		odp_global_data.sched_idle.sleep_ns =
+			platform_params->sched_idle_sleep_ns;
 	}
 	if (odp_global_data.n_rx_thr == 1)
 		odp_global_data.sort_buffers = 1;
@@ -163,6 +172,11 @@ int odp_init_global(const odp_init_t *params,
 		return -1;
 	}
 
+	if (odp_rcu_init_global()) {
+		ODP_ERR("ODP rcu init failed.\n");
+		return -1;
+	}
+
 	if (odp_pool_init_global()) {
 		ODP_ERR("ODP pool init failed.\n");
 		return -1;
@@ -249,6 +263,11 @@ int odp_term_global(void)
 		rc = -1;
 	}
 
+	if (odp_rcu_term_global()) {
+		ODP_ERR("ODP rcu term failed.\n");
+		rc = -1;
+	}
+
 	if (odp_thread_term_global()) {
 		ODP_ERR("ODP thread term failed.\n");
 		rc = -1;
@@ -274,6 +293,11 @@ int odp_init_local(odp_thread_type_t thr_type)
 		return -1;
 	}
 
+	if (odp_rcu_init_local()) {
+		ODP_ERR("ODP rcu local init failed.\n");
+		return -1;
+	}
+
 	if (odp_pktio_init_local()) {
 		ODP_ERR("ODP packet io local init failed.\n");
 		return -1;
@@ -292,6 +316,11 @@ int odp_term_local(void)
 	int rc = 0;
 	int rc_thd = 0;
 
+	if (odp_rcu_term_local()) {
+		ODP_ERR("ODP rcu local term failed.\n");
+		rc = -1;
+	}
+
 	if (odp_schedule_term_local()) {
 		ODP_ERR("ODP schedule local term failed.\n");
 		rc = -1;
@@ -0,0 +1,91 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <odp/mcslock.h>
+#include <odp/atomic.h>
+#include <odp_atomic_internal.h>
+#include <odp_spin_internal.h>
+
+#include <stddef.h>
+
+/* Tail and next pointers are accessed as pointer atomics */
+#define MCS_PTR(p) ((_odp_atomic_ptr_t *)(void *)(p))
+
+void odp_mcslock_init(odp_mcslock_t *lock)
+{
+	_odp_atomic_ptr_init(MCS_PTR(&lock->tail), NULL);
+}
+
+void odp_mcslock_lock(odp_mcslock_t *lock, odp_mcslock_node_t *node)
+{
+	odp_mcslock_node_t *prev;
+
+	__builtin_k1_wpurge();
+	_odp_atomic_ptr_store(MCS_PTR(&node->next), NULL, _ODP_MEMMODEL_RLX);
+	_odp_atomic_u32_store_mm(&node->locked, 1, _ODP_MEMMODEL_RLX);
+
+	/* Queue up behind the current tail. Release publishes the node
+	 * initialization to the predecessor, acquire pairs with the
+	 * release of the previous owner when the lock was free. */
+	prev = _odp_atomic_ptr_xchg(MCS_PTR(&lock->tail), node,
+				    _ODP_MEMMODEL_ACQ_RLS);
+	if (prev == NULL)
+		return;
+
+	/* Link behind the predecessor and spin on our own node until it
+	 * hands the lock over */
+	_odp_atomic_ptr_store(MCS_PTR(&prev->next), node, _ODP_MEMMODEL_RLS);
+	while (_odp_atomic_u32_load_mm(&node->locked, _ODP_MEMMODEL_ACQ))
+		odp_spin();
+}
+
+int odp_mcslock_trylock(odp_mcslock_t *lock, odp_mcslock_node_t *node)
+{
+	void *tail = NULL;
+
+	__builtin_k1_wpurge();
+	_odp_atomic_ptr_store(MCS_PTR(&node->next), NULL, _ODP_MEMMODEL_RLX);
+	_odp_atomic_u32_store_mm(&node->locked, 1, _ODP_MEMMODEL_RLX);
+
+	/* Take the lock only if nobody holds or waits for it */
+	return _odp_atomic_ptr_cmp_xchg_strong(MCS_PTR(&lock->tail), &tail,
+					       node, _ODP_MEMMODEL_ACQ_RLS,
+					       _ODP_MEMMODEL_RLX);
+}
+
+void odp_mcslock_unlock(odp_mcslock_t *lock, odp_mcslock_node_t *node)
+{
+	odp_mcslock_node_t *next;
+	void *self = node;
+
+	__k1_wmb();
+	__builtin_k1_wpurge();
+	next = _odp_atomic_ptr_load(MCS_PTR(&node->next), _ODP_MEMMODEL_ACQ);
+	if (next == NULL) {
+		/* No known successor, release the lock if we are still the
+		 * tail */
+		if (_odp_atomic_ptr_cmp_xchg_strong(MCS_PTR(&lock->tail),
+						    &self, NULL,
+						    _ODP_MEMMODEL_RLS,
+						    _ODP_MEMMODEL_RLX))
+			return;
+
+		/* A successor swapped the tail but has not linked itself
+		 * yet, wait for it */
+		while ((next = _odp_atomic_ptr_load(MCS_PTR(&node->next),
+						    _ODP_MEMMODEL_ACQ)) == NULL)
+			odp_spin();
+	}
+
+	/* Hand over the lock, writes only the successor's cache line */
+	_odp_atomic_u32_store_mm(&next->locked, 0, _ODP_MEMMODEL_RLS);
+}
+
+int odp_mcslock_is_locked(odp_mcslock_t *lock)
+{
+	return _odp_atomic_ptr_load(MCS_PTR(&lock->tail),
+				    _ODP_MEMMODEL_RLX) != NULL;
+}
@@ -1110,3 +1110,47 @@ int packet_parse_full(odp_packet_hdr_t *pkt_hdr)
 {
 	return _odp_parse_common(pkt_hdr, NULL);
 }
+
+/* Number of packets whose headers are prefetched ahead of the parser */
+#define PARSE_PREFETCH 4
+
+/**
+ * Burst parser
+ *
+ * There is no SIMD unit to classify headers of several packets at once, so
+ * packets are parsed one by one while headers of the next ones are
+ * prefetched. Levels above L2 all trigger a full parse.
+ */
+void packet_parse_multi(const odp_packet_t pkt[], int num,
+			odp_pktio_parse_level_t level)
+{
+	odp_packet_hdr_t *pkt_hdr;
+	int i;
+
+	switch (level) {
+	case ODP_PKTIO_PARSE_NONE:
+		return;
+	case ODP_PKTIO_PARSE_DEFAULT:
+	case ODP_PKTIO_PARSE_L2:
+		for (i = 0; i < num; i++) {
+			pkt_hdr = odp_packet_hdr(pkt[i]);
+			if (packet_parse_l2_not_done(pkt_hdr))
+				packet_parse_l2(pkt_hdr);
+		}
+		return;
+	default:
+		break;
+	}
+
+	for (i = 0; i < num && i < PARSE_PREFETCH; i++)
+		odp_prefetch(packet_map(odp_packet_hdr(pkt[i]), 0, NULL));
+
+	for (i = 0; i < num; i++) {
+		if (i + PARSE_PREFETCH < num)
+			odp_prefetch(packet_map(odp_packet_hdr(pkt[i +
+						PARSE_PREFETCH]), 0, NULL));
+		pkt_hdr = odp_packet_hdr(pkt[i]);
+		if (packet_parse_not_complete(pkt_hdr))
+			packet_parse_full(pkt_hdr);
+	}
+}
@@ -115,6 +115,9 @@ static void init_pktio_entry(pktio_entry_t *entry)
 	pktio_cls_enabled_set(entry, 0);
 	entry->s.inq_default = ODP_QUEUE_INVALID;
 
+	memset(entry->s.stats, 0, sizeof(entry->s.stats));
+	memset(&entry->s.stats_base, 0, sizeof(entry->s.stats_base));
+
 	pktio_classifier_init(entry);
 }
 
@@ -178,6 +181,12 @@ static odp_pktio_t setup_pktio_entry(const char *dev, odp_pool_t pool,
 
 	memcpy(&pktio_entry->s.param, param, sizeof(odp_pktio_param_t));
 
+	if (packet_vector_param_check(&pktio_entry->s.param.in_vector)) {
+		unlock_entry_classifier(pktio_entry);
+		free_pktio_entry(id);
+		return ODP_PKTIO_INVALID;
+	}
+
 	for (pktio_if = 0; pktio_if_ops[pktio_if]; ++pktio_if) {
 		ret = pktio_if_ops[pktio_if]->open(id, pktio_entry, dev, pool);
 
@@ -359,9 +368,88 @@ odp_pktio_t odp_pktio_lookup(const char *dev)
 	return pktio;
 }
 
+/** Maximum number of CoS queues with an open vector per thread */
+#define PKTIO_VEC_PEND_MAX 8
+
+typedef struct {
+	pktio_entry_t *entry;
+	queue_entry_t *queue;
+	odp_packet_vector_t vec;
+	uint32_t max_size;
+} pktio_vec_pend_t;
+
+/* Receive is not serialized per interface, vectors are collected per
+ * thread */
+static __thread pktio_vec_pend_t vec_pend[PKTIO_VEC_PEND_MAX];
+static __thread int vec_pend_num;
+
+static void pktio_vec_enq(pktio_vec_pend_t *pend)
+{
+	odp_packet_vector_hdr_t *hdr = odp_packet_vector_hdr(pend->vec);
+
+	if (odp_unlikely(queue_enq(pend->queue, &hdr->buf_hdr, 0))) {
+		pktio_stats(pend->entry)->in_cls_drops += hdr->size;
+		packet_vector_free_all(pend->vec);
+	}
+}
+
+static void pktio_vec_flush(void)
+{
+	int i;
+
+	for (i = 0; i < vec_pend_num; i++)
+		pktio_vec_enq(&vec_pend[i]);
+
+	vec_pend_num = 0;
+}
+
+int _odp_pktio_vec_add(pktio_entry_t *entry, queue_entry_t *queue,
+		       const odp_packet_vector_param_t *param,
+		       odp_packet_t pkt)
+{
+	pktio_vec_pend_t *pend = NULL;
+	odp_packet_vector_hdr_t *hdr;
+	int i;
+
+	for (i = 0; i < vec_pend_num; i++) {
+		if (vec_pend[i].queue == queue) {
+			pend = &vec_pend[i];
+			break;
+		}
+	}
+
+	if (pend == NULL) {
+		if (vec_pend_num == PKTIO_VEC_PEND_MAX)
+			pktio_vec_flush();
+
+		pend = &vec_pend[vec_pend_num];
+		pend->vec = odp_packet_vector_alloc(param->pool);
+		if (odp_unlikely(pend->vec == ODP_PACKET_VECTOR_INVALID))
+			return -1;
+
+		pend->entry    = entry;
+		pend->queue    = queue;
+		pend->max_size = param->max_size;
+		vec_pend_num++;
+	}
+
+	hdr = odp_packet_vector_hdr(pend->vec);
+	packet_vector_tbl(hdr)[hdr->size++] = pkt;
+
+	/* A full vector is enqueued and its slot released */
+	if (hdr->size == pend->max_size) {
+		pktio_vec_enq(pend);
+		*pend = vec_pend[--vec_pend_num];
+	}
+
+	return 0;
+}
+
 int odp_pktio_recv(odp_pktio_t id, odp_packet_t pkt_table[], int len)
 {
 	pktio_entry_t *pktio_entry = get_pktio_entry(id);
+	odp_pktio_stats_t *stats;
+	uint64_t octets = 0;
 	int pkts;
 	int i;
 
@@ -375,19 +463,48 @@ int odp_pktio_recv(odp_pktio_t id, odp_packet_t pkt_table[], int len)
 	}
 
 	pkts = pktio_entry->s.ops->recv(pktio_entry, pkt_table, len);
+	if (vec_pend_num)
+		pktio_vec_flush();
 
-	if (pkts < 0)
+	stats = pktio_stats(pktio_entry);
+
+	if (pkts < 0) {
+		stats->in_errors++;
 		return pkts;
+	}
+
+	for (i = 0; i < pkts; ++i) {
+		odp_packet_hdr_t *pkt_hdr = odp_packet_hdr(pkt_table[i]);
+
+		pkt_hdr->input = id;
+		octets += pkt_hdr->frame_len;
+	}
 
-	for (i = 0; i < pkts; ++i)
-		odp_packet_hdr(pkt_table[i])->input = id;
+	stats->in_packets += pkts;
+	stats->in_octets += octets;
+
+	/* Backends parse L2, parse the upper layers now when asked to */
+	packet_parse_multi(pkt_table, pkts, pktio_entry->s.param.parse_level);
 
 	return pkts;
 }
 
+static uint64_t pkt_octets(odp_packet_t pkt_table[], int num)
+{
+	uint64_t octets = 0;
+	int i;
+
+	for (i = 0; i < num; i++)
+		octets += odp_packet_hdr(pkt_table[i])->frame_len;
+
+	return octets;
+}
+
 int odp_pktio_send(odp_pktio_t id, odp_packet_t pkt_table[], int len)
 {
 	pktio_entry_t *pktio_entry = get_pktio_entry(id);
+	odp_pktio_stats_t *stats;
+	uint64_t octets;
 	int pkts;
 
 	if (pktio_entry == NULL)
@@ -399,8 +516,24 @@ int odp_pktio_send(odp_pktio_t id, odp_packet_t pkt_table[], int len)
 		return -1;
 	}
 
+	/* Packets must be read before the backend frees them */
+	stats = pktio_stats(pktio_entry);
+	octets = pkt_octets(pkt_table, len);
+
 	pkts = pktio_entry->s.ops->send(pktio_entry, pkt_table, len);
 
+	if (odp_unlikely(pkts < 0)) {
+		stats->out_errors++;
+		return pkts;
+	}
+
+	/* Packets not sent are still owned by the caller */
+	if (odp_unlikely(pkts < len))
+		octets -= pkt_octets(&pkt_table[pkts], len - pkts);
+
+	stats->out_packets += pkts;
+	stats->out_octets += octets;
+
 	return pkts;
 }
 
@@ -590,6 +723,40 @@ odp_buffer_hdr_t *pktin_dequeue(queue_entry_t *qentry)
 	return hdr;
 }
 
+/* Receive a burst directly into a vector and enqueue it as one event */
+static int pktin_poll_vector(pktio_entry_t *entry)
+{
+	const odp_packet_vector_param_t *param = &entry->s.param.in_vector;
+	odp_packet_vector_hdr_t *hdr;
+	odp_packet_vector_t pktv;
+	queue_entry_t *qentry;
+	int num;
+
+	pktv = odp_packet_vector_alloc(param->pool);
+	if (odp_unlikely(pktv == ODP_PACKET_VECTOR_INVALID))
+		return 0;
+
+	hdr = odp_packet_vector_hdr(pktv);
+	num = odp_pktio_recv(entry->s.handle, packet_vector_tbl(hdr),
+			     param->max_size);
+
+	if (num <= 0) {
+		odp_packet_vector_free(pktv);
+		if (num < 0) {
+			ODP_ERR("Packet recv error\n");
+			return -1;
+		}
+		return 0;
+	}
+
+	hdr->size = num;
+	qentry = queue_to_qentry(entry->s.inq_default);
+	if (odp_unlikely(queue_enq(qentry, &hdr->buf_hdr, 0)))
+		packet_vector_free_all(pktv);
+
+	return 0;
+}
+
 int pktin_poll(pktio_entry_t *entry)
 {
 	odp_packet_t pkt_tbl[QUEUE_MULTI_MAX];
@@ -604,6 +771,9 @@ int pktin_poll(pktio_entry_t *entry)
 	if (entry->s.state == STATE_STOP)
 		return 0;
 
+	if (entry->s.param.in_vector.enable)
+		return pktin_poll_vector(entry);
+
 	num = odp_pktio_recv(entry->s.handle, pkt_tbl, QUEUE_MULTI_MAX);
 
 	if (num == 0)
@@ -790,6 +960,133 @@ int _odp_pktio_stats(odp_pktio_t pktio,
 	return ret;
 }
 
+/* Sum the slots of all threads, plus the counters kept by the device */
+static int pktio_stats_sum(pktio_entry_t *entry, odp_pktio_stats_t *stats)
+{
+	uint64_t *sum = (uint64_t *)stats;
+	unsigned num = sizeof(odp_pktio_stats_t) / sizeof(uint64_t);
+	_odp_pktio_stats_t dev;
+	unsigned i, thr;
+
+	memset(stats, 0, sizeof(*stats));
+
+	for (thr = 0; thr < ODP_THREAD_COUNT_MAX; thr++) {
+		const uint64_t *cnt = (const uint64_t *)&entry->s.stats[thr].cnt;
+
+		for (i = 0; i < num; i++)
+			sum[i] += cnt[i];
+	}
+
+	if (!entry->s.ops->stats)
+		return 0;
+
+	if (entry->s.ops->stats(entry, &dev))
+		return -1;
+
+	/* Packets and octets are counted as delivered to the application,
+	 * the device adds the packets it dropped */
+	stats->in_discards += dev.in_discards - dev.in_no_buffers +
+			      dev.in_dropped;
+	stats->in_no_buffers += dev.in_no_buffers;
+	stats->in_errors += dev.in_errors;
+	stats->out_discards += dev.out_discards;
+	stats->out_errors += dev.out_errors;
+
+	return 0;
+}
+
+static void stats_sub(odp_pktio_stats_t *stats, const odp_pktio_stats_t *base)
+{
+	uint64_t *cnt = (uint64_t *)stats;
+	const uint64_t *sub = (const uint64_t *)base;
+	unsigned num = sizeof(odp_pktio_stats_t) / sizeof(uint64_t);
+	unsigned i;
+
+	for (i = 0; i < num; i++)
+		cnt[i] -= sub[i];
+}
+
+int odp_pktio_stats(odp_pktio_t id, odp_pktio_stats_t *stats)
+{
+	pktio_entry_t *entry;
+	int ret;
+
+	entry = get_pktio_entry(id);
+	if (entry == NULL) {
+		ODP_DBG("pktio entry %d does not exist\n", id);
+		return -1;
+	}
+
+	lock_entry(entry);
+
+	if (odp_unlikely(is_free(entry))) {
+		unlock_entry(entry);
+		ODP_DBG("already freed pktio\n");
+		return -1;
+	}
+
+	ret = pktio_stats_sum(entry, stats);
+	stats_sub(stats, &entry->s.stats_base);
+
+	unlock_entry(entry);
+	return ret;
+}
+
+int odp_pktio_stats_reset(odp_pktio_t id)
+{
+	pktio_entry_t *entry;
+	int ret;
+
+	entry = get_pktio_entry(id);
+	if (entry == NULL) {
+		ODP_DBG("pktio entry %d does not exist\n", id);
+		return -1;
+	}
+
+	lock_entry(entry);
+
+	if (odp_unlikely(is_free(entry))) {
+		unlock_entry(entry);
+		ODP_DBG("already freed pktio\n");
+		return -1;
+	}
+
+	/* Slots are written by their threads without locks, reset by
+	 * remembering the current values instead of clearing them */
+	ret = pktio_stats_sum(entry, &entry->s.stats_base);
+
+	unlock_entry(entry);
+	return ret;
+}
+
+int odp_pktio_stats_num_queues(odp_pktio_t id)
+{
+	if (get_pktio_entry(id) == NULL)
+		return -1;
+
+	/* Rx threads dispatch all device queues to a single input */
+	return 1;
+}
+
+int odp_pktio_queue_stats(odp_pktio_t id, int queue,
+			  odp_pktio_queue_stats_t *stats)
+{
+	odp_pktio_stats_t cnt;
+
+	if (queue != 0)
+		return -1;
+
+	if (odp_pktio_stats(id, &cnt))
+		return -1;
+
+	stats->in_octets = cnt.in_octets;
+	stats->in_packets = cnt.in_packets;
+	stats->out_octets = cnt.out_octets;
+	stats->out_packets = cnt.out_packets;
+
+	return 0;
+}
+
 void _odp_pktio_stats_print(odp_pktio_t pktio,
 			    const _odp_pktio_stats_t *stats)
 {
@@ -0,0 +1,107 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <odp/packet.h>
+#include <odp/event.h>
+#include <odp_packet_internal.h>
+#include <odp_debug_internal.h>
+
+odp_packet_vector_t odp_packet_vector_alloc(odp_pool_t pool_hdl)
+{
+	pool_entry_t *pool = odp_pool_to_entry(pool_hdl);
+	odp_packet_vector_hdr_t *hdr;
+	odp_buffer_t buf;
+
+	if (pool->s.params.type != ODP_POOL_VECTOR)
+		return ODP_PACKET_VECTOR_INVALID;
+
+	if (odp_unlikely(buffer_alloc(pool_hdl, pool->s.params.vec.max_size *
+				      sizeof(odp_packet_t),
+				      (odp_buffer_hdr_t **)&buf, 1) != 1))
+		return ODP_PACKET_VECTOR_INVALID;
+
+	hdr = (odp_packet_vector_hdr_t *)odp_buf_to_hdr(buf);
+	hdr->size = 0;
+
+	return (odp_packet_vector_t)buf;
+}
+
+void odp_packet_vector_free(odp_packet_vector_t pktv)
+{
+	odp_buffer_free((odp_buffer_t)pktv);
+}
+
+odp_packet_vector_t odp_packet_vector_from_event(odp_event_t ev)
+{
+	return (odp_packet_vector_t)ev;
+}
+
+odp_event_t odp_packet_vector_to_event(odp_packet_vector_t pktv)
+{
+	return (odp_event_t)pktv;
+}
+
+uint32_t odp_packet_vector_tbl(odp_packet_vector_t pktv,
+			       odp_packet_t **pkt_tbl)
+{
+	odp_packet_vector_hdr_t *hdr = odp_packet_vector_hdr(pktv);
+
+	*pkt_tbl = packet_vector_tbl(hdr);
+
+	return hdr->size;
+}
+
+uint32_t odp_packet_vector_size(odp_packet_vector_t pktv)
+{
+	return odp_packet_vector_hdr(pktv)->size;
+}
+
+void odp_packet_vector_size_set(odp_packet_vector_t pktv, uint32_t size)
+{
+	odp_packet_vector_hdr_t *hdr = odp_packet_vector_hdr(pktv);
+
+	ODP_ASSERT(size <= packet_vector_max_size(hdr));
+
+	hdr->size = size;
+}
+
+odp_pool_t odp_packet_vector_pool(odp_packet_vector_t pktv)
+{
+	return odp_packet_vector_hdr(pktv)->buf_hdr.pool_hdl;
+}
+
+void packet_vector_free_all(odp_packet_vector_t pktv)
+{
+	odp_packet_vector_hdr_t *hdr = odp_packet_vector_hdr(pktv);
+
+	odp_packet_free_multi(packet_vector_tbl(hdr), hdr->size);
+	odp_packet_vector_free(pktv);
+}
+
+int packet_vector_param_check(odp_packet_vector_param_t *param)
+{
+	pool_entry_t *pool;
+
+	if (!param->enable)
+		return 0;
+
+	if (param->pool == ODP_POOL_INVALID) {
+		ODP_ERR("No vector pool\n");
+		return -1;
+	}
+
+	pool = odp_pool_to_entry(param->pool);
+	if (pool->s.params.type != ODP_POOL_VECTOR) {
+		ODP_ERR("Not a vector pool\n");
+		return -1;
+	}
+
+	if (param->max_size == 0 ||
+	    param->max_size > pool->s.params.vec.max_size)
+		param->max_size = pool->s.params.vec.max_size;
+
+	return 0;
+}
@@ -34,6 +34,7 @@ typedef union buffer_type_any_u {
 	odp_buffer_hdr_t  buf;
 	odp_packet_hdr_t  pkt;
 	odp_timeout_hdr_t tmo;
+	odp_packet_vector_hdr_t vec;
 } odp_anybuf_t;
 
 /* Any buffer type header */
@@ -206,6 +207,16 @@ odp_pool_t odp_pool_create(const char *name, odp_pool_param_t *params)
 		buf_stride = sizeof(odp_timeout_hdr_stride);
 		break;
 
+	case ODP_POOL_VECTOR:
+		if (params->vec.max_size == 0)
+			return ODP_POOL_INVALID;
+
+		buf_num  = params->vec.num;
+		blk_size = ODP_ALIGN_ROUNDUP(params->vec.max_size *
+					     sizeof(odp_packet_t), buf_align);
+		buf_stride = sizeof(odp_packet_vector_hdr_stride);
+		break;
+
 	default:
 		return ODP_POOL_INVALID;
 	}
@@ -524,7 +535,8 @@ void odp_pool_print(odp_pool_t pool_hdl)
 		pool->s.params.type == ODP_POOL_BUFFER ? "buffer" :
 	       (pool->s.params.type == ODP_POOL_PACKET ? "packet" :
 	       (pool->s.params.type == ODP_POOL_TIMEOUT ? "timeout" :
-		"unknown")));
+	       (pool->s.params.type == ODP_POOL_VECTOR ? "vector" :
+		"unknown"))));
 	ODP_DBG(" pool storage    ODP managed shm handle %" PRIu64 "\n",
 		odp_shm_to_u64(pool->s.pool_shm));
 	ODP_DBG(" pool status     %s\n",
@@ -549,6 +561,8 @@ void odp_pool_print(odp_pool_t pool_hdl)
 			pool->s.params.pkt.seg_len, pool->s.seg_size);
 		ODP_DBG(" pkt length      %u requested, %u used\n",
 			pool->s.params.pkt.len, pool->s.blk_size);
+	} else if (pool->s.params.type == ODP_POOL_VECTOR) {
+		ODP_DBG(" vector size     %u\n", pool->s.params.vec.max_size);
 	}
 	ODP_DBG(" num bufs        %u\n",  pool->s.buf_num);
 	ODP_DBG(" bufs available  %u %s\n", bufcount,
@@ -0,0 +1,230 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+#include <odp/rcu.h>
+#include <odp/shared_memory.h>
+#include <odp/thread.h>
+#include <odp_internal.h>
+#include <odp_rcu_internal.h>
+#include <odp_spin_internal.h>
+#include <odp_debug_internal.h>
+
+#include <string.h>
+
+/** Deferred calls queued per thread, power of two */
+#define RCU_DEFER_SIZE 256
+
+typedef struct {
+	odp_rcu_cb_t func;
+	void *arg;
+	uint64_t gp;		/**< grace period that must be observed */
+} rcu_defer_t;
+
+typedef struct {
+	uint32_t head;		/**< oldest entry */
+	uint32_t tail;		/**< next free entry */
+	rcu_defer_t ent[RCU_DEFER_SIZE];
+} rcu_defer_queue_t;
+
+rcu_global_t *rcu_global;
+__thread rcu_thread_t *rcu_local;
+
+static __thread rcu_defer_queue_t rcu_defer_q;
+
+int odp_rcu_init_global(void)
+{
+	odp_shm_t shm;
+	int i;
+
+	shm = odp_shm_reserve("odp_rcu", sizeof(rcu_global_t),
+			      ODP_CACHE_LINE_SIZE, 0);
+
+	rcu_global = odp_shm_addr(shm);
+
+	if (rcu_global == NULL) {
+		ODP_ERR("RCU init: Shm reserve failed.\n");
+		return -1;
+	}
+
+	memset(rcu_global, 0, sizeof(rcu_global_t));
+
+	/* Zero is reserved for offline threads */
+	odp_atomic_init_u64(&rcu_global->gp, 1);
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++)
+		odp_atomic_init_u64(&rcu_global->thread[i].qs, RCU_OFFLINE);
+
+	return 0;
+}
+
+int odp_rcu_term_global(void)
+{
+	int rc = 0;
+
+	if (odp_shm_free(odp_shm_lookup("odp_rcu"))) {
+		ODP_ERR("RCU term: Shm free failed.\n");
+		rc = -1;
+	}
+
+	rcu_global = NULL;
+
+	return rc;
+}
+
+int odp_rcu_init_local(void)
+{
+	rcu_local = &rcu_global->thread[odp_thread_id()];
+	_odp_atomic_u64_store_mm(&rcu_local->qs, RCU_OFFLINE,
+				 _ODP_MEMMODEL_RLS);
+	rcu_defer_q.head = 0;
+	rcu_defer_q.tail = 0;
+
+	return 0;
+}
+
+int odp_rcu_term_local(void)
+{
+	odp_rcu_thread_offline();
+	odp_rcu_barrier();
+	rcu_local = NULL;
+
+	return 0;
+}
+
+void odp_rcu_quiescent(void)
+{
+	_odp_rcu_quiescent();
+}
+
+void odp_rcu_thread_online(void)
+{
+	_odp_rcu_quiescent();
+}
+
+void odp_rcu_thread_offline(void)
+{
+	if (rcu_local == NULL)
+		return;
+
+	__builtin_k1_wpurge();
+	_odp_atomic_u64_store_mm(&rcu_local->qs, RCU_OFFLINE,
+				 _ODP_MEMMODEL_RLS);
+}
+
+/* Check if all other online threads have observed grace period 'gp' */
+static int rcu_gp_done(uint64_t gp)
+{
+	uint64_t qs;
+	int i;
+
+	for (i = 0; i < ODP_THREAD_COUNT_MAX; i++) {
+		rcu_thread_t *thr = &rcu_global->thread[i];
+
+		if (thr == rcu_local)
+			continue;
+
+		qs = _odp_atomic_u64_load_mm(&thr->qs, _ODP_MEMMODEL_ACQ);
+		if (qs != RCU_OFFLINE && qs < gp)
+			return 0;
+	}
+
+	return 1;
+}
+
+/* Start a new grace period, returns its number */
+static uint64_t rcu_gp_start(void)
+{
+	uint64_t gp;
+
+	/* Updates done before are visible to readers that observe the new
+	 * grace period. The fence orders the increment before the quiescent
+	 * state loads, against threads coming online. */
+	__k1_wmb();
+	__builtin_k1_wpurge();
+	gp = _odp_atomic_u64_fetch_add_mm(&rcu_global->gp, 1,
+					  _ODP_MEMMODEL_SC) + 1;
+	odp_mb_full();
+
+	return gp;
+}
+
+static void rcu_gp_wait(uint64_t gp)
+{
+	while (!rcu_gp_done(gp)) {
+		/* Updaters waiting for each other must not deadlock */
+		if (rcu_local != NULL &&
+		    _odp_atomic_u64_load_mm(&rcu_local->qs,
+					    _ODP_MEMMODEL_RLX) != RCU_OFFLINE)
+			_odp_rcu_quiescent();
+
+		odp_spin();
+	}
+
+	/* Frees done after this do not pass the quiescent state loads */
+	odp_mb_acquire();
+	__builtin_k1_dinval();
+}
+
+void odp_rcu_synchronize(void)
+{
+	rcu_gp_wait(rcu_gp_start());
+}
+
+/* Run deferred calls whose grace period has ended. Blocks only when
+ * 'wait' is set. */
+static void rcu_defer_run(int wait)
+{
+	rcu_defer_queue_t *q = &rcu_defer_q;
+	uint64_t done = 0;
+	rcu_defer_t *ent;
+
+	while (q->head != q->tail) {
+		ent = &q->ent[q->head & (RCU_DEFER_SIZE - 1)];
+
+		if (ent->gp > done) {
+			if (wait)
+				rcu_gp_wait(ent->gp);
+			else if (!rcu_gp_done(ent->gp))
+				return;
+			else
+				__builtin_k1_dinval();
+
+			done = ent->gp;
+		}
+
+		q->head++;
+		ent->func(ent->arg);
+	}
+}
+
+int odp_rcu_defer(odp_rcu_cb_t func, void *arg)
+{
+	rcu_defer_queue_t *q = &rcu_defer_q;
+	rcu_defer_t *ent;
+
+	if (func == NULL) {
+		ODP_ERR("No function\n");
+		return -1;
+	}
+
+	rcu_defer_run(0);
+
+	if (q->tail - q->head == RCU_DEFER_SIZE)
+		rcu_defer_run(1);
+
+	ent = &q->ent[q->tail & (RCU_DEFER_SIZE - 1)];
+	ent->func = func;
+	ent->arg  = arg;
+	ent->gp   = rcu_gp_start();
+	q->tail++;
+
+	return 0;
+}
+
+void odp_rcu_barrier(void)
+{
+	rcu_defer_run(1);
+}
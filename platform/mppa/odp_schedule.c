@@ -15,6 +15,7 @@
 #include <odp_internal.h>
 #include <odp/config.h>
 #include <odp_debug_internal.h>
+#include <odp_rcu_internal.h>
 #include <odp/thread.h>
 #include <odp/time.h>
 #include <odp/spinlock.h>
@@ -22,6 +23,7 @@
 
 #include <odp_queue_internal.h>
 #include <odp_packet_io_internal.h>
+#include <odp_spin_internal.h>
 
 odp_thrmask_t sched_mask_all;
 
@@ -32,6 +34,18 @@ odp_thrmask_t sched_mask_all;
 /* Maximum number of dequeues */
 #define MAX_DEQ 4
 
+/* Idle policy defaults: empty polls before backing off and polls with
+ * backoff before sleeping. Threads sleep only when given a sleep time. */
+#define IDLE_SPIN_DEF     1000
+#define IDLE_PAUSE_DEF    10000
+
+/* odp_spin() backoffs between polls in the pause phase */
+#define IDLE_PAUSE_SPINS  16
+
+/* Polls after a sleep even when the wait time has passed: packet input
+ * takes two rounds (poll, then dequeue) */
+#define IDLE_WAKE_POLLS   2
+
 
 /* Internal: Start of named groups in group mask arrays */
 #define _ODP_SCHED_GROUP_NAMED (ODP_SCHED_GROUP_CONTROL + 1)
@@ -47,6 +61,11 @@ typedef struct {
 		char           name[ODP_SCHED_GROUP_NAME_LEN];
 		odp_thrmask_t *mask;
 	} sched_grp[ODP_CONFIG_SCHED_GRPS];
+
+	/* Idle policy, UINT32_MAX: phase not used */
+	uint32_t       idle_spin;
+	uint32_t       idle_pause;
+	uint64_t       idle_sleep_ns;
 } sched_t;
 
 /* Schedule command */
@@ -82,6 +101,7 @@ typedef struct {
 	uint32_t index;
 	uint32_t pause;
 	int ignore_ordered_context;
+	uint32_t idle;		/* empty polls since the last event */
 } sched_local_t;
 
 /* Global scheduler context */
@@ -140,6 +160,25 @@ int odp_schedule_init_global(void)
 	sched->shm  = shm;
 	odp_spinlock_init(&sched->mask_lock);
 
+	sched->idle_spin  = odp_global_data.sched_idle.spin ?
+			    (uint32_t)odp_global_data.sched_idle.spin :
+			    IDLE_SPIN_DEF;
+	sched->idle_pause = odp_global_data.sched_idle.pause ?
+			    (uint32_t)odp_global_data.sched_idle.pause :
+			    IDLE_PAUSE_DEF;
+	sched->idle_sleep_ns = odp_global_data.sched_idle.sleep_ns > 0 ?
+			       (uint64_t)odp_global_data.sched_idle.sleep_ns :
+			       0;
+
+	if (odp_global_data.sched_idle.pause < 0)
+		sched->idle_pause = 0;
+
+	/* Busy poll or back off forever */
+	if (odp_global_data.sched_idle.spin < 0)
+		sched->idle_spin = UINT32_MAX;
+	else if (sched->idle_sleep_ns == 0)
+		sched->idle_pause = UINT32_MAX - sched->idle_spin;
+
 	for (i = 0; i < ODP_CONFIG_SCHED_PRIOS; i++) {
 		odp_queue_t queue;
 		char name[] = "odp_priXX";
@@ -505,22 +544,69 @@ static int schedule(odp_queue_t *out_queue, odp_event_t out_ev[],
 }
 
 
+/* Idle policy after an empty poll: spin, back off, then sleep for the
+ * sleep time or until 'next' when not NULL. There is no wake up on
+ * enqueue, the sleep time is the wake latency. Returns 1 after a sleep. */
+static int sched_idle(const odp_time_t *next)
+{
+	uint64_t ns;
+	int i;
+
+	if (odp_likely(sched_local.idle < sched->idle_spin)) {
+		sched_local.idle++;
+		return 0;
+	}
+
+	if (sched_local.idle - sched->idle_spin < sched->idle_pause) {
+		sched_local.idle++;
+
+		for (i = 0; i < IDLE_PAUSE_SPINS; i++)
+			odp_spin();
+
+		return 0;
+	}
+
+	ns = sched->idle_sleep_ns;
+
+	if (next) {
+		odp_time_t now = odp_time_local();
+
+		if (odp_time_cmp(*next, now) < 0)
+			return 0;
+
+		if (odp_time_to_ns(odp_time_diff(*next, now)) < ns)
+			ns = odp_time_to_ns(odp_time_diff(*next, now));
+	}
+
+	_odp_sleep_ns(ns);
+
+	return 1;
+}
+
 static int schedule_loop(odp_queue_t *out_queue, uint64_t wait,
 			 odp_event_t out_ev[],
 			 unsigned int max_num, unsigned int max_deq)
 {
 	odp_time_t next, wtime;
 	int first = 1;
+	int woken = 0;
 	int ret;
 
 	while (1) {
+		/* The thread holds no references from previous events */
+		_odp_rcu_quiescent();
+
 		ret = schedule(out_queue, out_ev, max_num, max_deq);
 
-		if (ret)
+		if (ret) {
+			sched_local.idle = 0;
 			break;
+		}
 
-		if (wait == ODP_SCHED_WAIT)
+		if (wait == ODP_SCHED_WAIT) {
+			sched_idle(NULL);
 			continue;
+		}
 
 		if (wait == ODP_SCHED_NO_WAIT)
 			break;
@@ -532,8 +618,15 @@ static int schedule_loop(odp_queue_t *out_queue, uint64_t wait,
 			continue;
 		}
 
-		if (odp_time_cmp(next, odp_time_local()) < 0)
-			break;
+		if (odp_time_cmp(next, odp_time_local()) < 0) {
+			if (woken == 0)
+				break;
+
+			woken--;
+			continue;
+		}
+
+		woken = sched_idle(&next) ? IDLE_WAKE_POLLS : 0;
 	}
 
 	return ret;
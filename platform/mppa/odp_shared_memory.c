@@ -288,6 +288,7 @@ int odp_shm_info(odp_shm_t shm, odp_shm_info_t *info)
 	info->size      = block->size;
 	info->page_size = ODP_PAGE_SIZE;
 	info->flags     = block->flags;
+	info->numa_node = 0;
 
 	return 0;
 }
@@ -36,6 +36,15 @@ static int my_nanosleep(struct timespec *ts){
 #endif
 }
 
+int _odp_sleep_ns(uint64_t ns)
+{
+	struct timespec ts;
+
+	ts.tv_sec = ns / 1000000000ULL;
+	ts.tv_nsec = ns % 1000000000ULL;
+	return my_nanosleep(&ts);
+}
+
 unsigned int sleep(unsigned int seconds){
    struct timespec ts;
 
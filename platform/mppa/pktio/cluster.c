@@ -600,8 +600,9 @@ static int cluster_stats(pktio_entry_t *const pktio_entry,
 	memset(stats, 0, sizeof(*stats));
 
 	if (rx_thread_fetch_stats(clus->rx_config.pktio_id,
-				  &stats->in_dropped, &stats->in_discards))
+				  &stats->in_dropped, &stats->in_no_buffers))
 		return -1;
+	stats->in_discards += stats->in_no_buffers;
 	return 0;
 }
 const pktio_if_ops_t cluster_pktio_ops = {
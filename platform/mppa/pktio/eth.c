@@ -577,6 +577,7 @@ static int eth_stats(pktio_entry_t *const pktio_entry,
 	stats->in_ucast_pkts     = rpc_stats->in_ucast_pkts;
 	stats->in_discards       = rpc_stats->in_discards;
 	stats->in_dropped        = 0;
+	stats->in_no_buffers     = 0;
 	stats->in_errors         = rpc_stats->in_errors;
 	stats->in_unknown_protos = 0;
 	stats->out_octets        = rpc_stats->out_octets;
@@ -585,8 +586,9 @@ static int eth_stats(pktio_entry_t *const pktio_entry,
 	stats->out_errors        = rpc_stats->out_errors;
 
 	if (rx_thread_fetch_stats(eth->rx_config.pktio_id,
-				  &stats->in_dropped, &stats->in_discards))
+				  &stats->in_dropped, &stats->in_no_buffers))
 		return -1;
+	stats->in_discards += stats->in_no_buffers;
 	return 0;
 }
 
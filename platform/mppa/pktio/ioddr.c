@@ -336,8 +336,9 @@ static int ioddr_stats(pktio_entry_t *const pktio_entry,
 
 	memset(stats, 0, sizeof(*stats));
 	if (rx_thread_fetch_stats(ioddr->rx_config.pktio_id,
-				  &stats->in_dropped, &stats->in_discards))
+				  &stats->in_dropped, &stats->in_no_buffers))
 		return -1;
+	stats->in_discards += stats->in_no_buffers;
 	return 0;
 }
 
@@ -471,8 +471,9 @@ static int pcie_stats(pktio_entry_t *const pktio_entry,
 	memset(stats, 0, sizeof(*stats));
 
 	if (rx_thread_fetch_stats(pcie->rx_config.pktio_id,
-				  &stats->in_dropped, &stats->in_discards))
+				  &stats->in_dropped, &stats->in_no_buffers))
 		return -1;
+	stats->in_discards += stats->in_no_buffers;
 	return 0;
 }
 
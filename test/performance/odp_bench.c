@@ -0,0 +1,1853 @@
+/* Copyright (c) 2016, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * @example odp_bench.c  ODP benchmark driver
+ *
+ * Runs a matrix of benchmarks: each benchmark for each of its parameter
+ * values (burst, data size, number of rules...) and each thread count.
+ * A case runs for a fixed time, throughput and percentiles of the time per
+ * operation are reported as text, CSV or JSON. Results of a run saved in
+ * CSV can be used as the baseline of a later run, which then fails when a
+ * case is slower than its baseline by more than a tolerance.
+ */
+
+/** enable strtok */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <unistd.h>
+
+#include <test_debug.h>
+
+#include <odp.h>
+#include <odp/helper/linux.h>
+#include <odp/helper/chksum.h>
+#include <odp/helper/eth.h>
+#include <odp/helper/ip.h>
+#include <odp/helper/udp.h>
+
+/** Maximum number of worker threads */
+#define MAX_WORKERS            32
+
+/** Maximum number of values in a list option */
+#define MAX_LIST               16
+
+/** Maximum number of parameter values of a benchmark */
+#define MAX_PARAMS             8
+
+/** Maximum number of samples kept per thread */
+#define MAX_SAMPLES            4096
+
+/** Default run time of a case in milliseconds */
+#define DEFAULT_TIME_MS        100
+
+/** Default tolerance to the baseline in percents */
+#define DEFAULT_TOLERANCE      10
+
+/** Maximum number of baseline results */
+#define MAX_BASELINE           1024
+
+/** Maximum burst size of any benchmark */
+#define MAX_BURST              64
+
+/** Buffers in the buffer pool */
+#define NUM_BUFS               8192
+
+/** Size of the buffers */
+#define BUF_SIZE               64
+
+/** Packets in the packet pool */
+#define NUM_PKTS               2048
+
+/** Length of the packets sent by the pktio benchmarks */
+#define PKT_LEN                64
+
+/** Maximum crypto data size */
+#define MAX_DATA_SIZE          1536
+
+/** Room reserved for the ICV after crypto data */
+#define MAX_ICV_LEN            16
+
+/** Maximum number of queues of the scheduler benchmarks */
+#define MAX_QUEUES             64
+
+/** Events per queue in the scheduler benchmarks */
+#define SCHED_EVENTS           32
+
+/** Maximum number of timers per thread */
+#define MAX_TIMERS             64
+
+/** Timer resolution */
+#define TIMER_RES_NS           ODP_TIME_MSEC_IN_NS
+
+/** Timeout of the timer expire benchmark, in timer ticks */
+#define TIMER_EXPIRE_TCK       2
+
+/** Timeout of the timer set benchmark, in timer ticks */
+#define TIMER_SET_TCK          1000
+
+/** Crypto operations per run call */
+#define CRYPTO_BURST           8
+
+/** Hash operations per run call */
+#define HASH_BURST             16
+
+/** Maximum number of classifier rules */
+#define MAX_RULES              8
+
+/** UDP destination port of the first classifier rule */
+#define CLS_PORT_BASE          1024
+
+/** Time to wait for in flight events when a case stops */
+#define DRAIN_NS               (20 * ODP_TIME_MSEC_IN_NS)
+
+/** Get rid of path in filename - only for unix-type paths using '/' */
+#define NO_PATH(file_name) (strrchr((file_name), '/') ? \
+			    strrchr((file_name), '/') + 1 : (file_name))
+
+/**
+ * Output format
+ */
+typedef enum {
+	FORMAT_TEXT,
+	FORMAT_CSV,
+	FORMAT_JSON,
+} format_t;
+
+/** Benchmark samples are latencies recorded by the run function */
+#define BENCH_LATENCY          0x1
+
+struct bench_thr_s;
+
+/**
+ * Benchmark
+ *
+ * The driver calls init and term from the control thread around each
+ * case, thr_init and thr_term in each worker thread, and run in a loop
+ * until the case time is up. run returns the number of operations done,
+ * or a negative value on error.
+ */
+typedef struct {
+	const char *name;		/**< Benchmark name */
+	const char *desc;		/**< Description */
+	const char *param_name;		/**< Name of the parameter */
+	uint32_t params[MAX_PARAMS];	/**< Default parameter values */
+	int arg;			/**< Benchmark specific argument */
+	int flags;			/**< BENCH_ flags */
+	int (*init)(void);		/**< Case init, optional */
+	int (*term)(void);		/**< Case term, optional */
+	int (*thr_init)(struct bench_thr_s *thr); /**< Optional */
+	int (*thr_term)(struct bench_thr_s *thr); /**< Optional */
+	int (*run)(struct bench_thr_s *thr);	  /**< Run a batch */
+} bench_t;
+
+/**
+ * Worker thread state of a case
+ */
+typedef struct ODP_ALIGNED_CACHE bench_thr_s {
+	int idx;			/**< Thread index in the case */
+	int ret;			/**< Thread result */
+	uint64_t ops;			/**< Operations done */
+	uint64_t ns;			/**< Run time */
+	uint32_t num_samples;		/**< Samples recorded */
+	uint32_t sample_step;		/**< Record one sample per step */
+	uint32_t sample_skip;		/**< Samples to skip before next */
+	odp_queue_t queue;		/**< Queue of the thread */
+	odp_packet_t pkt;		/**< Packet of the thread */
+	odp_crypto_session_t session;	/**< Crypto session */
+	uint32_t num_timers;		/**< Timers allocated */
+	odp_timer_t timer[MAX_TIMERS];	/**< Timers */
+	odp_event_t tmo[MAX_TIMERS];	/**< Timeouts of timers not set */
+	odp_time_t armed[MAX_TIMERS];	/**< Time timers were set */
+	float sample[MAX_SAMPLES];	/**< Nanoseconds per operation */
+} bench_thr_t;
+
+/**
+ * Result of a case
+ */
+typedef struct {
+	uint64_t ops;		/**< Operations done by all threads */
+	double mops;		/**< Million operations per second */
+	double p50;		/**< Median of ns per operation */
+	double p90;		/**< 90th percentile */
+	double p99;		/**< 99th percentile */
+	double max;		/**< Maximum */
+} result_t;
+
+/**
+ * Baseline result
+ */
+typedef struct {
+	char bench[32];		/**< Benchmark name */
+	uint32_t param;		/**< Parameter value */
+	int threads;		/**< Thread count */
+	double mops;		/**< Million operations per second */
+} baseline_t;
+
+/**
+ * Parsed command line application arguments
+ */
+typedef struct {
+	char *bench_str;		/**< Benchmarks to run, NULL: all */
+	uint32_t params[MAX_PARAMS];	/**< Parameter override */
+	int num_params;			/**< 0: benchmark defaults */
+	int threads[MAX_LIST];		/**< Thread counts */
+	int num_threads;		/**< Number of thread counts */
+	int time_ms;			/**< Run time of a case */
+	format_t format;		/**< Output format */
+	char *baseline;			/**< Baseline file, NULL: none */
+	char *output;			/**< Result file, NULL: stdout */
+	int tolerance;			/**< Tolerance to baseline in % */
+} appl_args_t;
+
+/**
+ * Grouping of all global data
+ */
+typedef struct {
+	/** Worker thread states */
+	bench_thr_t thr[MAX_WORKERS];
+	/** Application (parsed) arguments */
+	appl_args_t appl;
+	/** Benchmark of the current case */
+	const bench_t *bench;
+	/** Parameter of the current case */
+	uint32_t param;
+	/** Thread count of the current case */
+	int num_threads;
+	/** Barrier of the current case */
+	odp_barrier_t barrier;
+	/** Next thread state to be picked by a worker */
+	odp_atomic_u32_t next_thr;
+	/** Buffer pool */
+	odp_pool_t buf_pool;
+	/** Packet pool */
+	odp_pool_t pkt_pool;
+	/** Timeout pool */
+	odp_pool_t tmo_pool;
+	/** Timer pool of the timer cases */
+	odp_timer_pool_t timer_pool;
+	/** Queues of the case */
+	odp_queue_t queue[MAX_QUEUES];
+	/** Number of queues */
+	int num_queues;
+	/** Loopback pktio of the case */
+	odp_pktio_t pktio;
+	/** Class of service of the classifier case */
+	odp_cos_t cos;
+	/** Classifier rules */
+	odp_pmr_t pmr[MAX_RULES];
+	/** Number of rules */
+	int num_pmr;
+	/** Packet sent by the pktio cases */
+	uint8_t pkt_tmpl[PKT_LEN];
+	/** Data hashed by the hash cases */
+	uint8_t data[MAX_DATA_SIZE];
+	/** Baseline results */
+	baseline_t base[MAX_BASELINE];
+	/** Number of baseline results */
+	int num_base;
+	/** Result output */
+	FILE *out;
+	/** Number of results printed */
+	int num_results;
+	/** Number of results slower than their baseline */
+	int num_regress;
+} args_t;
+
+/** Global pointer to args */
+static args_t *gbl_args;
+
+/** Keeps hash results alive */
+static volatile uint32_t hash_sink;
+
+/**
+ * Crypto algorithm combination
+ */
+typedef struct {
+	odp_cipher_alg_t cipher;	/**< Cipher algorithm */
+	uint32_t cipher_key_len;	/**< Cipher key length */
+	uint32_t iv_len;		/**< IV length */
+	odp_auth_alg_t auth;		/**< Authentication algorithm */
+	uint32_t auth_key_len;		/**< Authentication key length */
+} crypto_alg_t;
+
+/** Crypto algorithms, indexed by the arg of the crypto benchmarks */
+static const crypto_alg_t crypto_alg[] = {
+	{ODP_CIPHER_ALG_3DES_CBC, 24, 8, ODP_AUTH_ALG_NULL, 0},
+	{ODP_CIPHER_ALG_AES128_CBC, 16, 16, ODP_AUTH_ALG_NULL, 0},
+	{ODP_CIPHER_ALG_NULL, 0, 0, ODP_AUTH_ALG_MD5_96, 16},
+	{ODP_CIPHER_ALG_NULL, 0, 0, ODP_AUTH_ALG_SHA256_128, 32},
+	{ODP_CIPHER_ALG_AES128_CBC, 16, 16, ODP_AUTH_ALG_SHA256_128, 32},
+	{ODP_CIPHER_ALG_AES128_GCM, 16, 12, ODP_AUTH_ALG_AES128_GCM, 0},
+};
+
+/** Key and IV bytes of the crypto sessions */
+static uint8_t crypto_key[32] = {
+	0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+	0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe,
+	0x02, 0x46, 0x8a, 0xce, 0x13, 0x57, 0x9b, 0xdf,
+	0x20, 0x64, 0xa8, 0xec, 0x31, 0x75, 0xb9, 0xfd,
+};
+
+static void parse_args(int argc, char *argv[], appl_args_t *appl_args);
+static void usage(char *progname);
+
+/**
+ * Record a sample of a thread
+ *
+ * When the sample table is full every other sample is dropped and only
+ * every other sample is recorded after that, which keeps samples spread
+ * over the whole run time.
+ *
+ * @param thr  Thread state
+ * @param ns   Nanoseconds per operation, or latency
+ */
+static void sample_add(bench_thr_t *thr, double ns)
+{
+	uint32_t i;
+
+	if (thr->sample_skip) {
+		thr->sample_skip--;
+		return;
+	}
+
+	if (thr->num_samples == MAX_SAMPLES) {
+		for (i = 0; i < MAX_SAMPLES / 2; i++)
+			thr->sample[i] = thr->sample[2 * i];
+
+		thr->num_samples = MAX_SAMPLES / 2;
+		thr->sample_step *= 2;
+	}
+
+	thr->sample[thr->num_samples++] = ns;
+	thr->sample_skip = thr->sample_step - 1;
+}
+
+/**
+ * Drain and destroy the queues of a case
+ */
+static int queues_destroy(void)
+{
+	odp_event_t ev[MAX_BURST];
+	int i, j, num, ret = 0;
+
+	for (i = 0; i < gbl_args->num_queues; i++) {
+		while ((num = odp_queue_deq_multi(gbl_args->queue[i], ev,
+						  MAX_BURST)) > 0) {
+			for (j = 0; j < num; j++)
+				odp_event_free(ev[j]);
+		}
+
+		if (odp_queue_destroy(gbl_args->queue[i])) {
+			LOG_ERR("Error: queue destroy failed\n");
+			ret = -1;
+		}
+	}
+
+	gbl_args->num_queues = 0;
+	return ret;
+}
+
+/**
+ * Create queues of a case and fill them with buffers
+ *
+ * @param num     Number of queues
+ * @param type    Queue type
+ * @param sync    Scheduling synchronization of scheduled queues
+ * @param events  Buffers per queue
+ */
+static int queues_create(int num, odp_queue_type_t type,
+			 odp_schedule_sync_t sync, int events)
+{
+	odp_queue_param_t qparam;
+	odp_buffer_t buf;
+	char name[ODP_QUEUE_NAME_LEN];
+	int i, j;
+
+	odp_queue_param_init(&qparam);
+	qparam.sched.prio  = ODP_SCHED_PRIO_DEFAULT;
+	qparam.sched.sync  = sync;
+	qparam.sched.group = ODP_SCHED_GROUP_ALL;
+
+	for (i = 0; i < num; i++) {
+		snprintf(name, sizeof(name), "bench_q%i", i);
+		gbl_args->queue[i] = odp_queue_create(name, type,
+						      type == ODP_QUEUE_TYPE_SCHED ?
+						      &qparam : NULL);
+		if (gbl_args->queue[i] == ODP_QUEUE_INVALID) {
+			LOG_ERR("Error: queue create failed\n");
+			queues_destroy();
+			return -1;
+		}
+		gbl_args->num_queues++;
+
+		for (j = 0; j < events; j++) {
+			buf = odp_buffer_alloc(gbl_args->buf_pool);
+			if (buf == ODP_BUFFER_INVALID ||
+			    odp_queue_enq(gbl_args->queue[i],
+					  odp_buffer_to_event(buf))) {
+				LOG_ERR("Error: queue fill failed\n");
+				if (buf != ODP_BUFFER_INVALID)
+					odp_buffer_free(buf);
+				queues_destroy();
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Buffer alloc and free
+ */
+static int run_pool(bench_thr_t *thr ODP_UNUSED)
+{
+	odp_buffer_t buf[MAX_BURST];
+	int num;
+
+	num = odp_buffer_alloc_multi(gbl_args->buf_pool, buf,
+				     gbl_args->param);
+	if (num > 0)
+		odp_buffer_free_multi(buf, num);
+
+	return num < 0 ? 0 : num;
+}
+
+static int init_queue(void)
+{
+	return queues_create(1, ODP_QUEUE_TYPE_POLL, ODP_SCHED_SYNC_NONE,
+			     2 * gbl_args->param * gbl_args->num_threads);
+}
+
+/**
+ * Dequeue and enqueue back a burst of a shared queue
+ */
+static int run_queue(bench_thr_t *thr ODP_UNUSED)
+{
+	odp_event_t ev[MAX_BURST];
+	int num, sent;
+
+	num = odp_queue_deq_multi(gbl_args->queue[0], ev, gbl_args->param);
+	if (num <= 0)
+		return 0;
+
+	sent = odp_queue_enq_multi(gbl_args->queue[0], ev, num);
+	if (odp_unlikely(sent != num)) {
+		LOG_ERR("Error: enqueue failed\n");
+		return -1;
+	}
+
+	return num;
+}
+
+static int init_sched(void)
+{
+	return queues_create(gbl_args->param, ODP_QUEUE_TYPE_SCHED,
+			     gbl_args->bench->arg, SCHED_EVENTS);
+}
+
+/**
+ * Schedule events and enqueue them back to their queue
+ */
+static int run_sched(bench_thr_t *thr ODP_UNUSED)
+{
+	odp_event_t ev[MAX_BURST];
+	odp_queue_t from;
+	int num;
+
+	num = odp_schedule_multi(&from, ODP_SCHED_NO_WAIT, ev, 16);
+	if (num <= 0)
+		return 0;
+
+	if (odp_unlikely(odp_queue_enq_multi(from, ev, num) != num)) {
+		LOG_ERR("Error: enqueue failed\n");
+		return -1;
+	}
+
+	return num;
+}
+
+/**
+ * Free the events the scheduler still has for this thread
+ *
+ * Threads stop enqueueing together, then each frees what it schedules
+ * until the queues are empty.
+ */
+static int thr_term_sched(bench_thr_t *thr ODP_UNUSED)
+{
+	uint64_t wait = odp_schedule_wait_time(DRAIN_NS);
+	odp_event_t ev[MAX_BURST];
+	int i, num;
+
+	while ((num = odp_schedule_multi(NULL, wait, ev, MAX_BURST)) > 0) {
+		for (i = 0; i < num; i++)
+			odp_event_free(ev[i]);
+	}
+
+	return 0;
+}
+
+static int init_timer(void)
+{
+	odp_timer_pool_param_t tparam;
+
+	if (gbl_args->param > MAX_TIMERS) {
+		LOG_ERR("Error: max %i timers per thread\n", MAX_TIMERS);
+		return -1;
+	}
+
+	tparam.res_ns     = TIMER_RES_NS;
+	tparam.min_tmo    = TIMER_RES_NS;
+	tparam.max_tmo    = 10 * ODP_TIME_SEC_IN_NS;
+	tparam.num_timers = MAX_WORKERS * MAX_TIMERS;
+	tparam.priv       = 0;
+	tparam.clk_src    = ODP_CLOCK_CPU;
+
+	gbl_args->timer_pool = odp_timer_pool_create("bench_timers", &tparam);
+	if (gbl_args->timer_pool == ODP_TIMER_POOL_INVALID) {
+		LOG_ERR("Error: timer pool create failed\n");
+		return -1;
+	}
+	odp_timer_pool_start();
+
+	return 0;
+}
+
+/**
+ * Destroy the timer pool, so that it does not tick during other cases
+ */
+static int term_timer(void)
+{
+	odp_timer_pool_destroy(gbl_args->timer_pool);
+	gbl_args->timer_pool = ODP_TIMER_POOL_INVALID;
+
+	return 0;
+}
+
+/**
+ * Free the timers and timeouts of a thread
+ */
+static int thr_term_timer(bench_thr_t *thr)
+{
+	odp_event_t ev;
+	uint32_t i;
+	int ret = 0;
+
+	for (i = 0; i < thr->num_timers; i++) {
+		if (thr->tmo[i] == ODP_EVENT_INVALID &&
+		    odp_timer_cancel(thr->timer[i], &ev) == 0)
+			thr->tmo[i] = ev;
+	}
+
+	/* Timers which could not be canceled have expired */
+	if (thr->queue != ODP_QUEUE_INVALID) {
+		usleep(DRAIN_NS / 1000);
+		while ((ev = odp_queue_deq(thr->queue)) != ODP_EVENT_INVALID)
+			odp_event_free(ev);
+	}
+
+	for (i = 0; i < thr->num_timers; i++) {
+		if (thr->tmo[i] != ODP_EVENT_INVALID)
+			odp_event_free(thr->tmo[i]);
+
+		ev = odp_timer_free(thr->timer[i]);
+		if (ev != ODP_EVENT_INVALID)
+			odp_event_free(ev);
+	}
+	thr->num_timers = 0;
+
+	if (thr->queue != ODP_QUEUE_INVALID && odp_queue_destroy(thr->queue))
+		ret = -1;
+	thr->queue = ODP_QUEUE_INVALID;
+
+	return ret;
+}
+
+/**
+ * Allocate the timers and timeouts of a thread
+ */
+static int thr_init_timer(bench_thr_t *thr)
+{
+	char name[ODP_QUEUE_NAME_LEN];
+	odp_timeout_t tmo;
+	uint32_t i;
+
+	snprintf(name, sizeof(name), "bench_tq%i", thr->idx);
+	thr->queue = odp_queue_create(name, ODP_QUEUE_TYPE_POLL, NULL);
+	if (thr->queue == ODP_QUEUE_INVALID)
+		return -1;
+
+	for (i = 0; i < gbl_args->param; i++) {
+		thr->timer[i] = odp_timer_alloc(gbl_args->timer_pool,
+						thr->queue, &thr->armed[i]);
+		if (thr->timer[i] == ODP_TIMER_INVALID)
+			break;
+
+		tmo = odp_timeout_alloc(gbl_args->tmo_pool);
+		if (tmo == ODP_TIMEOUT_INVALID) {
+			odp_timer_free(thr->timer[i]);
+			break;
+		}
+		thr->tmo[i] = odp_timeout_to_event(tmo);
+		thr->num_timers++;
+	}
+
+	if (thr->num_timers != gbl_args->param) {
+		LOG_ERR("Error: timer alloc failed\n");
+		thr_term_timer(thr);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Set and cancel all timers of the thread
+ */
+static int run_timer_set(bench_thr_t *thr)
+{
+	uint32_t i;
+
+	for (i = 0; i < thr->num_timers; i++) {
+		if (odp_timer_set_rel(thr->timer[i], TIMER_SET_TCK,
+				      &thr->tmo[i]) != ODP_TIMER_SUCCESS) {
+			LOG_ERR("Error: timer set failed\n");
+			return -1;
+		}
+		thr->tmo[i] = ODP_EVENT_INVALID;
+
+		if (odp_timer_cancel(thr->timer[i], &thr->tmo[i])) {
+			LOG_ERR("Error: timer cancel failed\n");
+			return -1;
+		}
+	}
+
+	return thr->num_timers;
+}
+
+/**
+ * Set a timer of the expire benchmark
+ */
+static int timer_expire_set(bench_thr_t *thr, uint32_t i, odp_event_t *ev)
+{
+	thr->armed[i] = odp_time_local();
+
+	if (odp_timer_set_rel(thr->timer[i], TIMER_EXPIRE_TCK, ev) !=
+	    ODP_TIMER_SUCCESS) {
+		LOG_ERR("Error: timer set failed\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static int thr_init_timer_expire(bench_thr_t *thr)
+{
+	uint32_t i;
+
+	if (thr_init_timer(thr))
+		return -1;
+
+	for (i = 0; i < thr->num_timers; i++) {
+		if (timer_expire_set(thr, i, &thr->tmo[i])) {
+			thr_term_timer(thr);
+			return -1;
+		}
+		thr->tmo[i] = ODP_EVENT_INVALID;
+	}
+
+	return 0;
+}
+
+/**
+ * Receive expired timeouts, record their latency and set them again
+ *
+ * The latency is the delay between the requested and the actual delivery
+ * of the timeout to the thread, it includes the timer resolution.
+ */
+static int run_timer_expire(bench_thr_t *thr)
+{
+	uint64_t tmo_ns = TIMER_EXPIRE_TCK * TIMER_RES_NS;
+	odp_event_t ev[MAX_BURST];
+	odp_time_t *armed;
+	uint64_t ns;
+	uint32_t i;
+	int j, num;
+
+	num = odp_queue_deq_multi(thr->queue, ev, MAX_BURST);
+	if (num <= 0)
+		return 0;
+
+	for (j = 0; j < num; j++) {
+		armed = odp_timeout_user_ptr(odp_timeout_from_event(ev[j]));
+		i = armed - thr->armed;
+
+		ns = odp_time_to_ns(odp_time_diff(odp_time_local(), *armed));
+		sample_add(thr, ns > tmo_ns ? ns - tmo_ns : 0);
+
+		if (timer_expire_set(thr, i, &ev[j])) {
+			thr->tmo[i] = ev[j];
+			return -1;
+		}
+	}
+
+	return num;
+}
+
+static int init_crypto(void)
+{
+	if (gbl_args->param > MAX_DATA_SIZE || gbl_args->param % 16) {
+		LOG_ERR("Error: crypto size must be a multiple of 16 up to "
+			"%i\n", MAX_DATA_SIZE);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Create the crypto session and the packet of a thread
+ *
+ * Sessions are per thread, as sessions of some algorithms keep state
+ * during an operation.
+ */
+static int thr_init_crypto(bench_thr_t *thr)
+{
+	const crypto_alg_t *alg = &crypto_alg[gbl_args->bench->arg];
+	odp_crypto_session_params_t ses_params;
+	odp_crypto_ses_create_err_t status;
+
+	memset(&ses_params, 0, sizeof(ses_params));
+	ses_params.op               = ODP_CRYPTO_OP_ENCODE;
+	ses_params.auth_cipher_text = 1;
+	ses_params.pref_mode        = ODP_CRYPTO_SYNC;
+	ses_params.cipher_alg       = alg->cipher;
+	ses_params.cipher_key.data  = crypto_key;
+	ses_params.cipher_key.length = alg->cipher_key_len;
+	ses_params.iv.data          = crypto_key;
+	ses_params.iv.length        = alg->iv_len;
+	ses_params.auth_alg         = alg->auth;
+	ses_params.auth_key.data    = crypto_key;
+	ses_params.auth_key.length  = alg->auth_key_len;
+	ses_params.compl_queue      = ODP_QUEUE_INVALID;
+	ses_params.output_pool      = gbl_args->pkt_pool;
+
+	if (odp_crypto_session_create(&ses_params, &thr->session, &status) ||
+	    status != ODP_CRYPTO_SES_CREATE_ERR_NONE) {
+		LOG_ERR("Error: crypto session create failed\n");
+		return -1;
+	}
+
+	thr->pkt = odp_packet_alloc(gbl_args->pkt_pool,
+				    gbl_args->param + MAX_ICV_LEN);
+	if (thr->pkt == ODP_PACKET_INVALID) {
+		LOG_ERR("Error: packet alloc failed\n");
+		odp_crypto_session_destroy(thr->session);
+		return -1;
+	}
+
+	memset(odp_packet_data(thr->pkt), 0x5a, gbl_args->param);
+	return 0;
+}
+
+static int thr_term_crypto(bench_thr_t *thr)
+{
+	odp_packet_free(thr->pkt);
+	thr->pkt = ODP_PACKET_INVALID;
+
+	return odp_crypto_session_destroy(thr->session);
+}
+
+/**
+ * Encode the packet of the thread in place
+ */
+static int run_crypto(bench_thr_t *thr)
+{
+	odp_crypto_op_params_t op_params;
+	odp_crypto_op_result_t result;
+	odp_bool_t posted;
+	int i;
+
+	memset(&op_params, 0, sizeof(op_params));
+	op_params.session             = thr->session;
+	op_params.pkt                 = thr->pkt;
+	op_params.out_pkt             = thr->pkt;
+	op_params.cipher_range.length = gbl_args->param;
+	op_params.auth_range.length   = gbl_args->param;
+	op_params.hash_result_offset  = gbl_args->param;
+
+	for (i = 0; i < CRYPTO_BURST; i++) {
+		if (odp_crypto_operation(&op_params, &posted, &result) ||
+		    posted || !result.ok) {
+			LOG_ERR("Error: crypto operation failed\n");
+			return -1;
+		}
+	}
+
+	return CRYPTO_BURST;
+}
+
+static int init_hash(void)
+{
+	if (gbl_args->param > MAX_DATA_SIZE) {
+		LOG_ERR("Error: max hash size %i\n", MAX_DATA_SIZE);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Hash a block of data
+ */
+static int run_hash(bench_thr_t *thr ODP_UNUSED)
+{
+	uint32_t hash = 0;
+	int i;
+
+	for (i = 0; i < HASH_BURST; i++)
+		hash = odp_hash_crc32c(gbl_args->data, gbl_args->param, hash);
+
+	hash_sink = hash;
+	return HASH_BURST;
+}
+
+/**
+ * Build the UDP packet sent by the pktio benchmarks
+ *
+ * @param dport  UDP destination port
+ */
+static void pkt_tmpl_init(uint16_t dport)
+{
+	uint8_t *data = gbl_args->pkt_tmpl;
+	odph_ethhdr_t *eth = (odph_ethhdr_t *)data;
+	odph_ipv4hdr_t *ip = (odph_ipv4hdr_t *)(data + ODPH_ETHHDR_LEN);
+	odph_udphdr_t *udp = (odph_udphdr_t *)(data + ODPH_ETHHDR_LEN +
+					       ODPH_IPV4HDR_LEN);
+
+	memset(data, 0, PKT_LEN);
+	memset(eth->dst.addr, 0xff, ODPH_ETHADDR_LEN);
+	eth->src.addr[0] = 0x02;
+	eth->type        = odp_cpu_to_be_16(ODPH_ETHTYPE_IPV4);
+
+	ip->ver_ihl  = ODPH_IPV4 << 4 | ODPH_IPV4HDR_IHL_MIN;
+	ip->tot_len  = odp_cpu_to_be_16(PKT_LEN - ODPH_ETHHDR_LEN);
+	ip->ttl      = 64;
+	ip->proto    = ODPH_IPPROTO_UDP;
+	ip->src_addr = odp_cpu_to_be_32(0x0a000001);
+	ip->dst_addr = odp_cpu_to_be_32(0x0a000002);
+	ip->chksum   = odp_chksum(ip, ODPH_IPV4HDR_LEN);
+
+	udp->src_port = odp_cpu_to_be_16(CLS_PORT_BASE);
+	udp->dst_port = odp_cpu_to_be_16(dport);
+	udp->length   = odp_cpu_to_be_16(PKT_LEN - ODPH_ETHHDR_LEN -
+					 ODPH_IPV4HDR_LEN);
+}
+
+/**
+ * Open the loopback pktio of a case in direct receive mode
+ */
+static int pktio_open(void)
+{
+	odp_pktio_param_t pktio_param;
+
+	odp_pktio_param_init(&pktio_param);
+	pktio_param.in_mode = ODP_PKTIN_MODE_RECV;
+
+	gbl_args->pktio = odp_pktio_open("loop", gbl_args->pkt_pool,
+					 &pktio_param);
+	if (gbl_args->pktio == ODP_PKTIO_INVALID) {
+		LOG_ERR("Error: loop pktio open failed\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Free the packets left in the loopback and release the case resources
+ */
+static int term_pktio(void)
+{
+	odp_packet_t pkt[MAX_BURST];
+	int i, num, ret = 0;
+
+	if (gbl_args->pktio != ODP_PKTIO_INVALID) {
+		while ((num = odp_pktio_recv(gbl_args->pktio, pkt,
+					     MAX_BURST)) > 0)
+			odp_packet_free_multi(pkt, num);
+
+		odp_pktio_stop(gbl_args->pktio);
+		if (odp_pktio_close(gbl_args->pktio)) {
+			LOG_ERR("Error: pktio close failed\n");
+			ret = -1;
+		}
+		gbl_args->pktio = ODP_PKTIO_INVALID;
+	}
+
+	for (i = 0; i < gbl_args->num_pmr; i++)
+		odp_pmr_destroy(gbl_args->pmr[i]);
+	gbl_args->num_pmr = 0;
+
+	if (gbl_args->cos != ODP_COS_INVALID) {
+		odp_cos_destroy(gbl_args->cos);
+		gbl_args->cos = ODP_COS_INVALID;
+	}
+
+	if (queues_destroy())
+		ret = -1;
+
+	return ret;
+}
+
+static int init_pktio(void)
+{
+	if (gbl_args->param > MAX_BURST) {
+		LOG_ERR("Error: max burst %i\n", MAX_BURST);
+		return -1;
+	}
+
+	pkt_tmpl_init(CLS_PORT_BASE);
+
+	if (pktio_open() || odp_pktio_start(gbl_args->pktio)) {
+		term_pktio();
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Send a burst of packets to the loopback pktio
+ *
+ * @param burst  Number of packets
+ *
+ * @return Number of packets sent
+ */
+static int pkts_send(int burst)
+{
+	odp_packet_t pkt[MAX_BURST];
+	int i, num, sent;
+
+	num = odp_packet_alloc_multi(gbl_args->pkt_pool, PKT_LEN, pkt, burst);
+	if (num <= 0)
+		return 0;
+
+	for (i = 0; i < num; i++)
+		odp_packet_copydata_in(pkt[i], 0, PKT_LEN, gbl_args->pkt_tmpl);
+
+	sent = odp_pktio_send(gbl_args->pktio, pkt, num);
+	if (odp_unlikely(sent < 0))
+		sent = 0;
+
+	if (odp_unlikely(sent < num))
+		odp_packet_free_multi(&pkt[sent], num - sent);
+
+	return sent;
+}
+
+/**
+ * Send a burst to the loopback and receive a burst back
+ */
+static int run_pktio(bench_thr_t *thr ODP_UNUSED)
+{
+	odp_packet_t pkt[MAX_BURST];
+	int num;
+
+	pkts_send(gbl_args->param);
+
+	num = odp_pktio_recv(gbl_args->pktio, pkt, gbl_args->param);
+	if (num <= 0)
+		return 0;
+
+	odp_packet_free_multi(pkt, num);
+	return num;
+}
+
+/**
+ * Create a loopback with UDP destination port rules to one CoS
+ *
+ * Packets match the last rule, so that all rules are checked.
+ */
+static int init_cls(void)
+{
+	odp_cls_cos_param_t cls_param;
+	odp_pmr_match_t match;
+	uint16_t val[MAX_RULES];
+	uint16_t mask = 0xffff;
+	uint32_t i;
+
+	if (gbl_args->param == 0 || gbl_args->param > MAX_RULES) {
+		LOG_ERR("Error: 1 to %i rules\n", MAX_RULES);
+		return -1;
+	}
+
+	pkt_tmpl_init(CLS_PORT_BASE + gbl_args->param - 1);
+
+	if (queues_create(1, ODP_QUEUE_TYPE_POLL, ODP_SCHED_SYNC_NONE, 0) ||
+	    pktio_open())
+		goto error;
+
+	odp_cls_cos_param_init(&cls_param);
+	cls_param.pool        = gbl_args->pkt_pool;
+	cls_param.queue       = gbl_args->queue[0];
+	cls_param.drop_policy = ODP_COS_DROP_POOL;
+
+	gbl_args->cos = odp_cls_cos_create("bench_cos", &cls_param);
+	if (gbl_args->cos == ODP_COS_INVALID) {
+		LOG_ERR("Error: cos create failed\n");
+		goto error;
+	}
+
+	for (i = 0; i < gbl_args->param; i++) {
+		val[i]       = CLS_PORT_BASE + i;
+		match.term   = ODP_PMR_UDP_DPORT;
+		match.val    = &val[i];
+		match.mask   = &mask;
+		match.val_sz = sizeof(val[i]);
+		match.offset = 0;
+
+		gbl_args->pmr[i] = odp_pmr_create(&match);
+		if (gbl_args->pmr[i] == ODP_PMR_INVAL) {
+			LOG_ERR("Error: pmr create failed\n");
+			goto error;
+		}
+		gbl_args->num_pmr++;
+
+		if (odp_pktio_pmr_cos(gbl_args->pmr[i], gbl_args->pktio,
+				      gbl_args->cos)) {
+			LOG_ERR("Error: pmr cos failed\n");
+			goto error;
+		}
+	}
+
+	if (odp_pktio_start(gbl_args->pktio))
+		goto error;
+
+	return 0;
+
+error:
+	term_pktio();
+	return -1;
+}
+
+/**
+ * Send a burst to the loopback and receive the classified packets
+ */
+static int run_cls(bench_thr_t *thr ODP_UNUSED)
+{
+	odp_packet_t pkt[MAX_BURST];
+	odp_event_t ev[MAX_BURST];
+	int i, num;
+
+	pkts_send(gbl_args->param);
+
+	/* Receive classifies packets to the CoS queue */
+	num = odp_pktio_recv(gbl_args->pktio, pkt, MAX_BURST);
+	if (odp_unlikely(num > 0)) {
+		LOG_ERR("Error: %i packets not classified\n", num);
+		odp_packet_free_multi(pkt, num);
+		return -1;
+	}
+
+	num = odp_queue_deq_multi(gbl_args->queue[0], ev, MAX_BURST);
+	if (num <= 0)
+		return 0;
+
+	for (i = 0; i < num; i++)
+		odp_event_free(ev[i]);
+
+	return num;
+}
+
+/** Benchmarks */
+static const bench_t bench_tbl[] = {
+	{"pool", "Buffer alloc and free", "burst", {1, 8, 32}, 0, 0,
+	 NULL, NULL, NULL, NULL, run_pool},
+	{"queue", "Poll queue dequeue and enqueue", "burst", {1, 8, 32}, 0, 0,
+	 init_queue, queues_destroy, NULL, NULL, run_queue},
+	{"sched_none", "Schedule and enqueue, parallel queues", "queues",
+	 {1, 8, 64}, ODP_SCHED_SYNC_NONE, 0,
+	 init_sched, queues_destroy, NULL, thr_term_sched, run_sched},
+	{"sched_atomic", "Schedule and enqueue, atomic queues", "queues",
+	 {1, 8, 64}, ODP_SCHED_SYNC_ATOMIC, 0,
+	 init_sched, queues_destroy, NULL, thr_term_sched, run_sched},
+	{"sched_ordered", "Schedule and enqueue, ordered queues", "queues",
+	 {1, 8, 64}, ODP_SCHED_SYNC_ORDERED, 0,
+	 init_sched, queues_destroy, NULL, thr_term_sched, run_sched},
+	{"timer_set", "Timer set and cancel", "timers", {64}, 0, 0,
+	 init_timer, term_timer, thr_init_timer, thr_term_timer,
+	 run_timer_set},
+	{"timer_expire", "Timer expiration latency", "timers", {16}, 0,
+	 BENCH_LATENCY, init_timer, term_timer, thr_init_timer_expire,
+	 thr_term_timer, run_timer_expire},
+	{"crypto_3des_cbc", "3DES-CBC encode", "bytes", {64, 256, 1024}, 0, 0,
+	 init_crypto, NULL, thr_init_crypto, thr_term_crypto, run_crypto},
+	{"crypto_aes128_cbc", "AES128-CBC encode", "bytes", {64, 256, 1024},
+	 1, 0, init_crypto, NULL, thr_init_crypto, thr_term_crypto,
+	 run_crypto},
+	{"crypto_md5_96", "HMAC-MD5-96 generate", "bytes", {64, 256, 1024},
+	 2, 0, init_crypto, NULL, thr_init_crypto, thr_term_crypto,
+	 run_crypto},
+	{"crypto_sha256_128", "HMAC-SHA256-128 generate", "bytes",
+	 {64, 256, 1024}, 3, 0, init_crypto, NULL, thr_init_crypto,
+	 thr_term_crypto, run_crypto},
+	{"crypto_aes128_cbc_sha256", "AES128-CBC and HMAC-SHA256-128 encode",
+	 "bytes", {64, 256, 1024}, 4, 0, init_crypto, NULL, thr_init_crypto,
+	 thr_term_crypto, run_crypto},
+	{"crypto_aes128_gcm", "AES128-GCM encode", "bytes", {64, 256, 1024},
+	 5, 0, init_crypto, NULL, thr_init_crypto, thr_term_crypto,
+	 run_crypto},
+	{"hash_crc32c", "CRC-32C", "bytes", {64, 256, 1024}, 0, 0,
+	 init_hash, NULL, NULL, NULL, run_hash},
+	{"cls", "Loopback send, classify and receive", "rules", {1, 4, 8},
+	 0, 0, init_cls, term_pktio, NULL, NULL, run_cls},
+	{"pktio_loop", "Loopback send and receive", "burst", {1, 8, 32}, 0, 0,
+	 init_pktio, term_pktio, NULL, NULL, run_pktio},
+};
+
+/** Number of benchmarks */
+#define NUM_BENCH (sizeof(bench_tbl) / sizeof(bench_tbl[0]))
+
+/**
+ * Worker thread of a case
+ *
+ * @param arg  Unused, threads pick their state in start order
+ */
+static void *run_thread(void *arg ODP_UNUSED)
+{
+	const bench_t *bench = gbl_args->bench;
+	uint64_t run_ns = gbl_args->appl.time_ms * ODP_TIME_MSEC_IN_NS;
+	bench_thr_t *thr;
+	odp_time_t start, end, t0, t1;
+	uint64_t ops = 0;
+	int num, init_ok;
+
+	thr = &gbl_args->thr[odp_atomic_fetch_inc_u32(&gbl_args->next_thr)];
+
+	init_ok = bench->thr_init == NULL || bench->thr_init(thr) == 0;
+	thr->ret = init_ok ? 0 : -1;
+
+	/* Start together */
+	odp_barrier_wait(&gbl_args->barrier);
+
+	start = odp_time_local();
+	end   = odp_time_sum(start, odp_time_local_from_ns(run_ns));
+	t0    = start;
+	t1    = start;
+
+	while (init_ok) {
+		num = bench->run(thr);
+		t1  = odp_time_local();
+
+		if (odp_unlikely(num < 0)) {
+			thr->ret = -1;
+			break;
+		}
+
+		/* Empty polls are not operations */
+		if (num && !(bench->flags & BENCH_LATENCY))
+			sample_add(thr, (double)odp_time_to_ns(
+					odp_time_diff(t1, t0)) / num);
+
+		ops += num;
+		t0   = t1;
+
+		if (odp_time_cmp(t1, end) >= 0)
+			break;
+	}
+
+	thr->ops = ops;
+	thr->ns  = odp_time_to_ns(odp_time_diff(t1, start));
+
+	/* Stop together, before events in flight are freed */
+	odp_barrier_wait(&gbl_args->barrier);
+
+	if (init_ok && bench->thr_term && bench->thr_term(thr))
+		thr->ret = -1;
+
+	return NULL;
+}
+
+/**
+ * Compare samples for qsort()
+ */
+static int sample_cmp(const void *a, const void *b)
+{
+	float fa = *(const float *)a;
+	float fb = *(const float *)b;
+
+	return (fa > fb) - (fa < fb);
+}
+
+/**
+ * Percentile of sorted samples
+ */
+static double percentile(const float *sample, uint32_t num, double pct)
+{
+	if (num == 0)
+		return 0;
+
+	return sample[(uint32_t)((num - 1) * pct / 100 + 0.5)];
+}
+
+/**
+ * Run a case and compute its result
+ *
+ * @param bench        Benchmark
+ * @param param        Parameter value
+ * @param num_threads  Number of worker threads
+ * @param cpumask      CPUs of the worker threads
+ * @param[out] res     Result
+ *
+ * @retval 0 on success
+ * @retval <0 on failure
+ */
+static int run_case(const bench_t *bench, uint32_t param, int num_threads,
+		    const odp_cpumask_t *cpumask, result_t *res)
+{
+	odph_linux_pthread_t thread_tbl[MAX_WORKERS];
+	bench_thr_t *thr;
+	float *sample;
+	uint32_t num = 0;
+	int i, ret = 0;
+
+	gbl_args->bench       = bench;
+	gbl_args->param       = param;
+	gbl_args->num_threads = num_threads;
+	gbl_args->num_queues  = 0;
+	gbl_args->pktio       = ODP_PKTIO_INVALID;
+	gbl_args->cos         = ODP_COS_INVALID;
+	gbl_args->num_pmr     = 0;
+
+	for (i = 0; i < num_threads; i++) {
+		thr = &gbl_args->thr[i];
+		memset(thr, 0, offsetof(bench_thr_t, sample));
+		thr->idx         = i;
+		thr->sample_step = 1;
+		thr->queue       = ODP_QUEUE_INVALID;
+		thr->pkt         = ODP_PACKET_INVALID;
+	}
+
+	if (bench->init && bench->init())
+		return -1;
+
+	odp_atomic_init_u32(&gbl_args->next_thr, 0);
+	odp_barrier_init(&gbl_args->barrier, num_threads);
+
+	memset(thread_tbl, 0, sizeof(thread_tbl));
+	odph_linux_pthread_create(thread_tbl, cpumask, run_thread, NULL,
+				  ODP_THREAD_WORKER);
+	odph_linux_pthread_join(thread_tbl, num_threads);
+
+	memset(res, 0, sizeof(*res));
+	for (i = 0; i < num_threads; i++) {
+		thr = &gbl_args->thr[i];
+		if (thr->ret)
+			ret = -1;
+
+		res->ops += thr->ops;
+		if (thr->ns)
+			res->mops += thr->ops * 1000.0 / thr->ns;
+		num += thr->num_samples;
+	}
+
+	if (bench->term && bench->term())
+		ret = -1;
+
+	sample = malloc(num * sizeof(float) + 1);
+	if (sample == NULL)
+		return -1;
+
+	for (i = 0, num = 0; i < num_threads; i++) {
+		thr = &gbl_args->thr[i];
+		memcpy(&sample[num], thr->sample,
+		       thr->num_samples * sizeof(float));
+		num += thr->num_samples;
+	}
+
+	qsort(sample, num, sizeof(float), sample_cmp);
+	res->p50 = percentile(sample, num, 50);
+	res->p90 = percentile(sample, num, 90);
+	res->p99 = percentile(sample, num, 99);
+	res->max = num ? sample[num - 1] : 0;
+	free(sample);
+
+	return ret;
+}
+
+/**
+ * Load baseline results from a CSV file of an earlier run
+ */
+static int load_baseline(const char *file)
+{
+	char line[256];
+	baseline_t *base;
+	FILE *f;
+
+	f = fopen(file, "r");
+	if (f == NULL) {
+		LOG_ERR("Error: cannot open baseline %s\n", file);
+		return -1;
+	}
+
+	while (fgets(line, sizeof(line), f) &&
+	       gbl_args->num_base < MAX_BASELINE) {
+		base = &gbl_args->base[gbl_args->num_base];
+
+		/* bench,param_name,param,threads,ops,mops,... */
+		if (sscanf(line, "%31[^,],%*[^,],%u,%d,%*[^,],%lf",
+			   base->bench, &base->param, &base->threads,
+			   &base->mops) == 4)
+			gbl_args->num_base++;
+	}
+
+	fclose(f);
+
+	if (gbl_args->num_base == 0) {
+		LOG_ERR("Error: no results in baseline %s\n", file);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Find the baseline of a case
+ *
+ * @return Baseline Mops/s, or a negative value when there is none
+ */
+static double find_baseline(const bench_t *bench, uint32_t param,
+			    int threads)
+{
+	const baseline_t *base;
+	int i;
+
+	for (i = 0; i < gbl_args->num_base; i++) {
+		base = &gbl_args->base[i];
+		if (base->param == param && base->threads == threads &&
+		    strcmp(base->bench, bench->name) == 0)
+			return base->mops;
+	}
+
+	return -1;
+}
+
+/**
+ * Print the header of the results
+ */
+static void print_header(void)
+{
+	int base = gbl_args->appl.baseline != NULL;
+
+	switch (gbl_args->appl.format) {
+	case FORMAT_CSV:
+		fprintf(gbl_args->out, "bench,param_name,param,threads,ops,mops,"
+		       "p50_ns,p90_ns,p99_ns,max_ns%s\n",
+		       base ? ",base_mops,change_pct" : "");
+		break;
+	case FORMAT_JSON:
+		fprintf(gbl_args->out, "[");
+		break;
+	default:
+		fprintf(gbl_args->out, "%-25s %-6s %6s %3s %9s %9s %9s %9s %9s%s\n",
+		       "bench", "param", "", "thr", "Mops/s", "p50 ns",
+		       "p90 ns", "p99 ns", "max ns",
+		       base ? "    base   change" : "");
+		break;
+	}
+}
+
+/**
+ * Print the result of a case
+ *
+ * The time per operation is measured per call of the run function, so it
+ * is the average of a burst. Latency benchmarks record their own samples.
+ */
+static void print_result(const bench_t *bench, uint32_t param, int threads,
+			 const result_t *res)
+{
+	double base = -1, change = 0;
+
+	if (gbl_args->appl.baseline) {
+		base = find_baseline(bench, param, threads);
+		if (base > 0)
+			change = (res->mops - base) * 100 / base;
+	}
+
+	switch (gbl_args->appl.format) {
+	case FORMAT_CSV:
+		fprintf(gbl_args->out, "%s,%s,%u,%i,%" PRIu64 ",%.4f,%.1f,%.1f,%.1f,%.1f",
+		       bench->name, bench->param_name, param, threads,
+		       res->ops, res->mops, res->p50, res->p90, res->p99,
+		       res->max);
+		if (gbl_args->appl.baseline) {
+			if (base > 0)
+				fprintf(gbl_args->out, ",%.4f,%.1f", base, change);
+			else
+				fprintf(gbl_args->out, ",,");
+		}
+		fprintf(gbl_args->out, "\n");
+		break;
+	case FORMAT_JSON:
+		fprintf(gbl_args->out, "%s\n  {\"bench\": \"%s\", \"param_name\": \"%s\", "
+		       "\"param\": %u, \"threads\": %i, \"ops\": %" PRIu64
+		       ", \"mops\": %.4f, \"p50_ns\": %.1f, \"p90_ns\": %.1f, "
+		       "\"p99_ns\": %.1f, \"max_ns\": %.1f",
+		       gbl_args->num_results ? "," : "",
+		       bench->name, bench->param_name, param, threads,
+		       res->ops, res->mops, res->p50, res->p90, res->p99,
+		       res->max);
+		if (base > 0)
+			fprintf(gbl_args->out, ", \"base_mops\": %.4f, \"change_pct\": %.1f",
+			       base, change);
+		fprintf(gbl_args->out, "}");
+		break;
+	default:
+		fprintf(gbl_args->out, "%-25s %-6s %6u %3i %9.3f %9.1f %9.1f %9.1f %9.1f",
+		       bench->name, bench->param_name, param, threads,
+		       res->mops, res->p50, res->p90, res->p99, res->max);
+		if (base > 0)
+			fprintf(gbl_args->out, " %8.3f %+7.1f%%", base, change);
+		fprintf(gbl_args->out, "\n");
+		break;
+	}
+	fflush(gbl_args->out);
+
+	gbl_args->num_results++;
+
+	if (base > 0 && change < -gbl_args->appl.tolerance) {
+		fprintf(stderr, "REGRESSION: %s %s %u, %i threads: %.3f Mops/s, "
+			"baseline %.3f (%.1f%%)\n", bench->name,
+			bench->param_name, param, threads, res->mops, base,
+			change);
+		gbl_args->num_regress++;
+	}
+}
+
+/**
+ * Print the end of the results
+ */
+static void print_footer(void)
+{
+	if (gbl_args->appl.format == FORMAT_JSON)
+		fprintf(gbl_args->out, "\n]\n");
+}
+
+/**
+ * Check if a benchmark was selected on the command line
+ *
+ * Benchmarks are selected by name prefix, e.g. "crypto" selects all
+ * crypto benchmarks.
+ */
+static int bench_selected(const bench_t *bench)
+{
+	const char *tok = gbl_args->appl.bench_str;
+	size_t len;
+
+	if (tok == NULL)
+		return 1;
+
+	while (*tok) {
+		len = strcspn(tok, ",");
+		if (len && strncmp(bench->name, tok, len) == 0)
+			return 1;
+
+		tok += len;
+		if (*tok == ',')
+			tok++;
+	}
+
+	return 0;
+}
+
+/**
+ * Create the pools shared by all cases
+ */
+static int pools_create(void)
+{
+	odp_pool_param_t params;
+
+	odp_pool_param_init(&params);
+	params.buf.size  = BUF_SIZE;
+	params.buf.align = 0;
+	params.buf.num   = NUM_BUFS;
+	params.type      = ODP_POOL_BUFFER;
+	gbl_args->buf_pool = odp_pool_create("bench_buf_pool", &params);
+
+	odp_pool_param_init(&params);
+	params.pkt.seg_len = MAX_DATA_SIZE + MAX_ICV_LEN;
+	params.pkt.len     = MAX_DATA_SIZE + MAX_ICV_LEN;
+	params.pkt.num     = NUM_PKTS;
+	params.type        = ODP_POOL_PACKET;
+	gbl_args->pkt_pool = odp_pool_create("bench_pkt_pool", &params);
+
+	odp_pool_param_init(&params);
+	params.tmo.num = MAX_WORKERS * MAX_TIMERS;
+	params.type    = ODP_POOL_TIMEOUT;
+	gbl_args->tmo_pool = odp_pool_create("bench_tmo_pool", &params);
+
+	if (gbl_args->buf_pool == ODP_POOL_INVALID ||
+	    gbl_args->pkt_pool == ODP_POOL_INVALID ||
+	    gbl_args->tmo_pool == ODP_POOL_INVALID) {
+		LOG_ERR("Error: pool create failed\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * ODP benchmark driver main function
+ */
+int main(int argc, char *argv[])
+{
+	odp_cpumask_t cpumask[MAX_LIST];
+	const bench_t *bench;
+	const uint32_t *params;
+	result_t res;
+	odp_shm_t shm;
+	uint32_t b;
+	int max_threads, num_params;
+	int i, p, t;
+	int errors = 0;
+
+	/* Init ODP before calling anything else */
+	if (odp_init_global(NULL, NULL)) {
+		LOG_ERR("Error: ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* Init this thread */
+	if (odp_init_local(ODP_THREAD_CONTROL)) {
+		LOG_ERR("Error: ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	/* Reserve memory for args from shared mem */
+	shm = odp_shm_reserve("shm_bench_args", sizeof(args_t),
+			      ODP_CACHE_LINE_SIZE, 0);
+	gbl_args = odp_shm_addr(shm);
+
+	if (gbl_args == NULL) {
+		LOG_ERR("Error: shared mem alloc failed.\n");
+		exit(EXIT_FAILURE);
+	}
+	memset(gbl_args, 0, sizeof(*gbl_args));
+
+	/* Parse and store the application arguments */
+	parse_args(argc, argv, &gbl_args->appl);
+
+	if (gbl_args->appl.baseline &&
+	    load_baseline(gbl_args->appl.baseline))
+		exit(EXIT_FAILURE);
+
+	gbl_args->out = stdout;
+	if (gbl_args->appl.output) {
+		gbl_args->out = fopen(gbl_args->appl.output, "w");
+		if (gbl_args->out == NULL) {
+			LOG_ERR("Error: cannot open %s\n",
+				gbl_args->appl.output);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (pools_create())
+		exit(EXIT_FAILURE);
+
+	for (i = 0; i < MAX_DATA_SIZE; i++)
+		gbl_args->data[i] = i;
+
+	/* Worker CPUs of each thread count */
+	max_threads = odp_cpu_count();
+	for (t = 0; t < gbl_args->appl.num_threads; t++) {
+		if (gbl_args->appl.threads[t] <= max_threads)
+			odp_cpumask_default_worker(&cpumask[t],
+						   gbl_args->appl.threads[t]);
+	}
+
+	print_header();
+
+	for (b = 0; b < NUM_BENCH; b++) {
+		bench = &bench_tbl[b];
+		if (!bench_selected(bench))
+			continue;
+
+		params     = gbl_args->appl.params;
+		num_params = gbl_args->appl.num_params;
+		if (num_params == 0) {
+			params = bench->params;
+			while (num_params < MAX_PARAMS && params[num_params])
+				num_params++;
+		}
+
+		for (p = 0; p < num_params; p++) {
+			for (t = 0; t < gbl_args->appl.num_threads; t++) {
+				int threads = gbl_args->appl.threads[t];
+
+				if (threads > max_threads)
+					continue;
+
+				if (run_case(bench, params[p], threads,
+					     &cpumask[t], &res)) {
+					fprintf(stderr, "FAILED: %s %s %u, %i "
+						"threads\n", bench->name,
+						bench->param_name, params[p],
+						threads);
+					errors++;
+					continue;
+				}
+
+				print_result(bench, params[p], threads, &res);
+			}
+		}
+	}
+
+	print_footer();
+
+	if (gbl_args->out != stdout)
+		fclose(gbl_args->out);
+
+	for (t = 0; t < gbl_args->appl.num_threads; t++) {
+		if (gbl_args->appl.threads[t] > max_threads)
+			fprintf(stderr, "Skipped %i threads: %i CPUs "
+				"available\n", gbl_args->appl.threads[t],
+				max_threads);
+	}
+
+	if (odp_pool_destroy(gbl_args->buf_pool) ||
+	    odp_pool_destroy(gbl_args->pkt_pool) ||
+	    odp_pool_destroy(gbl_args->tmo_pool)) {
+		LOG_ERR("Error: pool destroy failed\n");
+		errors++;
+	}
+
+	if (gbl_args->num_regress) {
+		fprintf(stderr, "%i regressions over %i%% tolerance\n",
+			gbl_args->num_regress, gbl_args->appl.tolerance);
+		errors++;
+	}
+
+	if (odp_shm_free(shm) || odp_term_local() < 0 || odp_term_global())
+		errors++;
+
+	return errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/**
+ * Parse a comma separated list of numbers
+ *
+ * @param str  List
+ * @param tbl  Numbers
+ * @param max  Maximum number of numbers
+ *
+ * @return Number of numbers, or -1 on a syntax error
+ */
+static int parse_list(const char *str, uint32_t tbl[], int max)
+{
+	char *end;
+	int num = 0;
+
+	while (*str) {
+		if (num == max)
+			return -1;
+
+		tbl[num++] = strtoul(str, &end, 0);
+		if (end == str || (*end != ',' && *end != '\0'))
+			return -1;
+
+		str = *end ? end + 1 : end;
+	}
+
+	return num;
+}
+
+/**
+ * Print the benchmarks
+ */
+static void list_bench(void)
+{
+	uint32_t b;
+	int p;
+
+	printf("%-25s %-7s %-15s %s\n", "bench", "param", "default",
+	       "description");
+
+	for (b = 0; b < NUM_BENCH; b++) {
+		char def[32];
+		int len = 0;
+
+		def[0] = '\0';
+		for (p = 0; p < MAX_PARAMS && bench_tbl[b].params[p]; p++)
+			len += snprintf(&def[len], sizeof(def) - len, "%s%u",
+					p ? "," : "", bench_tbl[b].params[p]);
+
+		printf("%-25s %-7s %-15s %s\n", bench_tbl[b].name,
+		       bench_tbl[b].param_name, def, bench_tbl[b].desc);
+	}
+}
+
+/**
+ * Parse and store the command line arguments
+ *
+ * @param argc       argument count
+ * @param argv[]     argument vector
+ * @param appl_args  Store application arguments here
+ */
+static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
+{
+	uint32_t threads[MAX_LIST];
+	int opt;
+	int long_index;
+	int i, num;
+	static struct option longopts[] = {
+		{"bench", required_argument, NULL, 'b'},
+		{"param", required_argument, NULL, 'p'},
+		{"threads", required_argument, NULL, 'c'},
+		{"time", required_argument, NULL, 't'},
+		{"format", required_argument, NULL, 'f'},
+		{"baseline", required_argument, NULL, 'B'},
+		{"tolerance", required_argument, NULL, 'T'},
+		{"output", required_argument, NULL, 'o'},
+		{"list", no_argument, NULL, 'l'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	appl_args->bench_str   = NULL;
+	appl_args->num_params  = 0;
+	appl_args->threads[0]  = 1;
+	appl_args->num_threads = 1;
+	appl_args->time_ms     = DEFAULT_TIME_MS;
+	appl_args->format      = FORMAT_TEXT;
+	appl_args->baseline    = NULL;
+	appl_args->tolerance   = DEFAULT_TOLERANCE;
+	appl_args->output      = NULL;
+
+	while (1) {
+		opt = getopt_long(argc, argv, "+b:p:c:t:f:B:T:o:lh",
+				  longopts, &long_index);
+
+		if (opt == -1)
+			break;	/* No more options */
+
+		switch (opt) {
+		case 'b':
+			appl_args->bench_str = optarg;
+			break;
+		case 'p':
+			num = parse_list(optarg, appl_args->params,
+					 MAX_PARAMS);
+			if (num <= 0) {
+				usage(argv[0]);
+				exit(EXIT_FAILURE);
+			}
+			appl_args->num_params = num;
+			break;
+		case 'c':
+			num = parse_list(optarg, threads, MAX_LIST);
+			if (num <= 0) {
+				usage(argv[0]);
+				exit(EXIT_FAILURE);
+			}
+			for (i = 0; i < num; i++) {
+				if (threads[i] < 1 || threads[i] > MAX_WORKERS) {
+					usage(argv[0]);
+					exit(EXIT_FAILURE);
+				}
+				appl_args->threads[i] = threads[i];
+			}
+			appl_args->num_threads = num;
+			break;
+		case 't':
+			appl_args->time_ms = atoi(optarg);
+			if (appl_args->time_ms <= 0) {
+				usage(argv[0]);
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 'f':
+			if (strcmp(optarg, "csv") == 0) {
+				appl_args->format = FORMAT_CSV;
+			} else if (strcmp(optarg, "json") == 0) {
+				appl_args->format = FORMAT_JSON;
+			} else if (strcmp(optarg, "text") == 0) {
+				appl_args->format = FORMAT_TEXT;
+			} else {
+				usage(argv[0]);
+				exit(EXIT_FAILURE);
+			}
+			break;
+		case 'B':
+			appl_args->baseline = optarg;
+			break;
+		case 'T':
+			appl_args->tolerance = atoi(optarg);
+			break;
+		case 'o':
+			appl_args->output = optarg;
+			break;
+		case 'l':
+			list_bench();
+			exit(EXIT_SUCCESS);
+			break;
+		case 'h':
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+			break;
+		default:
+			break;
+		}
+	}
+
+	optind = 1;		/* reset 'extern optind' from the getopt lib */
+}
+
+/**
+ * Prinf usage information
+ */
+static void usage(char *progname)
+{
+	printf("\n"
+	       "OpenDataPlane benchmark driver.\n"
+	       "\n"
+	       "Usage: %s [OPTIONS]\n"
+	       "  E.g. %s -b crypto,hash -c 1,2,4 -f csv -o base.csv\n"
+	       "       %s -b crypto,hash -c 1,2,4 -B base.csv -T 5\n"
+	       "\n"
+	       "Optional OPTIONS\n"
+	       "  -b, --bench <list>     Benchmarks to run, by name prefix\n"
+	       "                         (comma-separated, default all)\n"
+	       "  -p, --param <list>     Parameter values, overriding the\n"
+	       "                         defaults of each benchmark\n"
+	       "  -c, --threads <list>   Worker thread counts (default 1).\n"
+	       "                         Counts over the available CPUs are\n"
+	       "                         skipped.\n"
+	       "  -t, --time <ms>        Run time of each case (default %i)\n"
+	       "  -f, --format <fmt>     Output format: text (default), csv\n"
+	       "                         or json\n"
+	       "  -B, --baseline <file>  Compare to the results of an earlier\n"
+	       "                         run saved with -f csv. Exit with\n"
+	       "                         failure on regressions.\n"
+	       "  -T, --tolerance <pct>  Slowdown allowed against the baseline\n"
+	       "                         (default %i%%)\n"
+	       "  -o, --output <file>    Write results to a file instead of\n"
+	       "                         stdout, which also gets ODP logs\n"
+	       "  -l, --list             List benchmarks and exit\n"
+	       "  -h, --help             Display help and exit.\n"
+	       "\n"
+	       " Throughput is the sum of the per thread operation rates.\n"
+	       " Percentiles are of the time per operation of each burst,\n"
+	       " or of the latency for latency benchmarks.\n"
+	       "\n", NO_PATH(progname), NO_PATH(progname), NO_PATH(progname),
+	       DEFAULT_TIME_MS, DEFAULT_TOLERANCE);
+}
@@ -45,6 +45,11 @@
  */
 #define MAX_PKT_BURST          32
 
+/** @def PORT_MAP_SIZE
+ * @brief Size of the pktio handle to port index hash table (power of two)
+ */
+#define PORT_MAP_SIZE          (2 * ODP_CONFIG_PKTIO_ENTRIES)
+
 /**
  * Packet input mode
  */
@@ -74,34 +79,60 @@ typedef struct {
 	int error_check;        /**< Check packet errors */
 	int pktio_stats;        /**< Show pktio stats before exit */
 	int allow_fail;         /**< Allow some pktios to not be available */
+	int vector;		/**< Packets per input vector, 0: no vectors */
+	int csv;		/**< Print per port statistics in CSV */
 } appl_args_t;
 
 static int exit_threads;	/**< Break workers loop if set to 1 */
 
+/**
+ * Statistics of one port
+ */
+typedef struct {
+	/** Number of packets forwarded to the port */
+	uint64_t packets;
+	/** Number of bytes forwarded to the port */
+	uint64_t bytes;
+	/** Packets from the port dropped due to receive error */
+	uint64_t rx_drops;
+	/** Packets to the port dropped due to transmit error */
+	uint64_t tx_drops;
+} port_stats_t;
+
 /**
  * Statistics
  */
-typedef union {
-	struct {
-		/** Number of forwarded packets */
-		uint64_t packets;
-		/** Packets dropped due to receive error */
-		uint64_t rx_drops;
-		/** Packets dropped due to transmit error */
-		uint64_t tx_drops;
-	} s;
-
-	uint8_t padding[ODP_CACHE_LINE_SIZE];
+typedef struct {
+	/** Per port statistics */
+	port_stats_t port[ODP_CONFIG_PKTIO_ENTRIES];
 } stats_t ODP_ALIGNED_CACHE;
 
 /**
  * Thread specific arguments
  */
 typedef struct {
-	int src_idx;    /**< Source interface identifier */
+	int num_src;	/**< Number of source interfaces */
+	/** Source interfaces polled in turn in direct receive mode */
+	int src_idx[ODP_CONFIG_PKTIO_ENTRIES];
 	stats_t *stats;	/**< Pointer to per thread stats */
 } thread_args_t;
 
+/**
+ * Entry of the pktio handle to port index hash table
+ */
+typedef struct {
+	odp_pktio_t pktio;	/**< Input pktio, ODP_PKTIO_INVALID if free */
+	int src_idx;		/**< Port index of the pktio */
+} port_map_t;
+
+/**
+ * Ethernet addresses written to packets sent to a port
+ */
+typedef struct {
+	odph_ethaddr_t dst;	/**< Destination address */
+	odph_ethaddr_t src;	/**< Source address, the port address */
+} eth_addrs_t;
+
 /**
  * Grouping of all global data
  */
@@ -114,29 +145,91 @@ typedef struct {
 	thread_args_t thread[MAX_WORKERS];
 	/** Table of pktio handles */
 	odp_pktio_t pktios[ODP_CONFIG_PKTIO_ENTRIES];
-	/** Table of port ethernet addresses */
-	odph_ethaddr_t port_eth_addr[ODP_CONFIG_PKTIO_ENTRIES];
-	/** Table of dst ethernet addresses */
-	odph_ethaddr_t dst_eth_addr[ODP_CONFIG_PKTIO_ENTRIES];
+	/** Table of addresses written to packets, indexed by dst port */
+	eth_addrs_t eth_addrs[ODP_CONFIG_PKTIO_ENTRIES];
+	/** Offset of the address bytes rewritten in the eth header */
+	unsigned eth_rewrite_off;
+	/** Number of address bytes rewritten, 0: none */
+	unsigned eth_rewrite_len;
 	/** Table of dst ports */
 	int dst_port[ODP_CONFIG_PKTIO_ENTRIES];
+	/** Input pktio to port index hash table */
+	port_map_t port_map[PORT_MAP_SIZE];
+	/** Packet vector pool */
+	odp_pool_t vec_pool;
 } args_t;
 
+/** Vector pool size */
+#define VEC_POOL_SIZE          1024
+
 /** Global pointer to args */
 static args_t *gbl_args;
 /** Global barrier to synchronize main and workers */
 static odp_barrier_t barrier;
 
 /* helper funcs */
-static inline int lookup_dest_port(odp_packet_t pkt);
+static inline int lookup_src_port(odp_pktio_t pktio);
 static inline int find_dest_port(int port);
 static inline int drop_err_pkts(odp_packet_t pkt_tbl[], unsigned num);
-static void fill_eth_addrs(odp_packet_t pkt_tbl[], unsigned num,
-			   int dst_port);
+static uint64_t fill_eth_addrs(odp_packet_t pkt_tbl[], unsigned num,
+			       int dst_port);
 static void parse_args(int argc, char *argv[], appl_args_t *appl_args);
 static void print_info(char *progname, appl_args_t *appl_args);
 static void usage(char *progname);
 
+/**
+ * Forward a burst of packets received from one interface
+ *
+ * @param pkt_tbl  Packets, modified when errors are checked
+ * @param pkts     Number of packets
+ * @param src_idx  Source interface index
+ * @param stats    Thread statistics
+ */
+static void forward_pkts(odp_packet_t pkt_tbl[], int pkts, int src_idx,
+			 stats_t *stats)
+{
+	int dst_idx = gbl_args->dst_port[src_idx];
+	port_stats_t *dst_stats = &stats->port[dst_idx];
+	uint64_t bytes;
+	unsigned tx_drops;
+	int sent, i;
+
+	if (gbl_args->appl.error_check) {
+		int rx_drops;
+
+		/* Drop packets with errors */
+		rx_drops = drop_err_pkts(pkt_tbl, pkts);
+
+		if (odp_unlikely(rx_drops)) {
+			stats->port[src_idx].rx_drops += rx_drops;
+			if (pkts == rx_drops)
+				return;
+
+			pkts -= rx_drops;
+		}
+	}
+
+	bytes = fill_eth_addrs(pkt_tbl, pkts, dst_idx);
+
+	sent = odp_pktio_send(gbl_args->pktios[dst_idx], pkt_tbl, pkts);
+
+	sent     = odp_unlikely(sent < 0) ? 0 : sent;
+	tx_drops = pkts - sent;
+
+	if (odp_unlikely(tx_drops)) {
+		dst_stats->tx_drops += tx_drops;
+
+		/* Drop rejected packets */
+		for (i = sent; i < pkts; i++) {
+			bytes -= odp_packet_len(pkt_tbl[i]);
+			odp_packet_free(pkt_tbl[i]);
+		}
+	}
+
+	dst_stats->packets += sent;
+	dst_stats->bytes   += bytes;
+}
+
 /**
  * Packet IO worker thread using ODP queues
  *
@@ -146,11 +239,12 @@ static void *pktio_queue_thread(void *arg)
 {
 	odp_event_t  ev_tbl[MAX_PKT_BURST];
 	odp_packet_t pkt_tbl[MAX_PKT_BURST];
+	odp_packet_vector_t pktv;
+	odp_packet_t *vec_tbl;
 	int pkts;
 	int thr;
+	int src_idx;
 	uint64_t wait;
-	int dst_idx;
-	odp_pktio_t pktio_dst;
 	thread_args_t *thr_args = arg;
 	stats_t *stats = thr_args->stats;
 
@@ -163,51 +257,35 @@ static void *pktio_queue_thread(void *arg)
 
 	/* Loop packets */
 	while (!exit_threads) {
-		int sent, i;
-		unsigned tx_drops;
+		int i, num;
 
 		pkts = odp_schedule_multi(NULL, wait, ev_tbl, MAX_PKT_BURST);
 
 		if (pkts <= 0)
 			continue;
 
-		for (i = 0; i < pkts; i++)
-			pkt_tbl[i] = odp_packet_from_event(ev_tbl[i]);
-
-		if (gbl_args->appl.error_check) {
-			int rx_drops;
-
-			/* Drop packets with errors */
-			rx_drops = drop_err_pkts(pkt_tbl, pkts);
-
-			if (odp_unlikely(rx_drops)) {
-				stats->s.rx_drops += rx_drops;
-				if (pkts == rx_drops)
-					continue;
-
-				pkts -= rx_drops;
+		/* Input vectors carry a burst each */
+		if (odp_event_type(ev_tbl[0]) == ODP_EVENT_PACKET_VECTOR) {
+			for (i = 0; i < pkts; i++) {
+				pktv = odp_packet_vector_from_event(ev_tbl[i]);
+				num  = odp_packet_vector_tbl(pktv, &vec_tbl);
+				if (num) {
+					src_idx = lookup_src_port(
+						odp_packet_input(vec_tbl[0]));
+					forward_pkts(vec_tbl, num, src_idx,
+						     stats);
+				}
+				odp_packet_vector_free(pktv);
 			}
+			continue;
 		}
 
-		/* packets from the same queue are from the same interface */
-		dst_idx = lookup_dest_port(pkt_tbl[0]);
-		fill_eth_addrs(pkt_tbl, pkts, dst_idx);
-		pktio_dst = gbl_args->pktios[dst_idx];
-
-		sent = odp_pktio_send(pktio_dst, pkt_tbl, pkts);
-
-		sent     = odp_unlikely(sent < 0) ? 0 : sent;
-		tx_drops = pkts - sent;
-
-		if (odp_unlikely(tx_drops)) {
-			stats->s.tx_drops += tx_drops;
-
-			/* Drop rejected packets */
-			for (i = sent; i < pkts; i++)
-				odp_packet_free(pkt_tbl[i]);
-		}
+		for (i = 0; i < pkts; i++)
+			pkt_tbl[i] = odp_packet_from_event(ev_tbl[i]);
 
-		stats->s.packets += pkts;
+		/* packets from the same queue are from the same interface */
+		src_idx = lookup_src_port(odp_packet_input(pkt_tbl[0]));
+		forward_pkts(pkt_tbl, pkts, src_idx, stats);
 	}
 
 	/* Make sure that latest stat writes are visible to other threads */
@@ -217,25 +295,57 @@ static void *pktio_queue_thread(void *arg)
 }
 
 /**
- * Lookup the destination port for a given packet
+ * Hash table slot of a pktio handle
  *
- * @param pkt  ODP packet handle
+ * @param pktio  ODP pktio handle
  */
-static inline int lookup_dest_port(odp_packet_t pkt)
+static inline unsigned port_map_slot(odp_pktio_t pktio)
 {
-	int i, src_idx;
-	odp_pktio_t pktio_src;
+	return odp_pktio_to_u64(pktio) & (PORT_MAP_SIZE - 1);
+}
 
-	pktio_src = odp_packet_input(pkt);
+/**
+ * Add a port to the pktio handle to port index hash table
+ *
+ * @param pktio    ODP pktio handle
+ * @param src_idx  Port index
+ */
+static void add_src_port(odp_pktio_t pktio, int src_idx)
+{
+	unsigned slot = port_map_slot(pktio);
 
-	for (src_idx = -1, i = 0; gbl_args->pktios[i] != ODP_PKTIO_INVALID; ++i)
-		if (gbl_args->pktios[i] == pktio_src)
-			src_idx = i;
+	while (gbl_args->port_map[slot].pktio != ODP_PKTIO_INVALID)
+		slot = (slot + 1) & (PORT_MAP_SIZE - 1);
 
-	if (src_idx == -1)
-		LOG_ABORT("Failed to determine pktio input\n");
+	gbl_args->port_map[slot].pktio   = pktio;
+	gbl_args->port_map[slot].src_idx = src_idx;
+}
+
+/**
+ * Lookup the port index of an input pktio
+ *
+ * Handles are hashed to the table filled at pktio open, so that the port of
+ * a burst is found in constant time whatever the number of interfaces.
+ *
+ * @param pktio  Input pktio handle of a received packet
+ */
+static inline int lookup_src_port(odp_pktio_t pktio)
+{
+	unsigned slot = port_map_slot(pktio);
+	unsigned i;
+
+	for (i = 0; i < PORT_MAP_SIZE; i++) {
+		if (odp_likely(gbl_args->port_map[slot].pktio == pktio))
+			return gbl_args->port_map[slot].src_idx;
+
+		if (gbl_args->port_map[slot].pktio == ODP_PKTIO_INVALID)
+			break;
+
+		slot = (slot + 1) & (PORT_MAP_SIZE - 1);
+	}
 
-	return gbl_args->dst_port[src_idx];
+	LOG_ABORT("Failed to determine pktio input\n");
+	return -1;
 }
 
 /**
@@ -267,65 +377,39 @@ static void *pktio_direct_recv_thread(void *arg)
 	int pkts;
 	odp_packet_t pkt_tbl[MAX_PKT_BURST];
 	int src_idx, dst_idx;
-	odp_pktio_t pktio_src, pktio_dst;
+	int idx;
 	thread_args_t *thr_args = arg;
 	stats_t *stats = thr_args->stats;
 
 	thr = odp_thread_id();
 
-	src_idx = thr_args->src_idx;
-	dst_idx = gbl_args->dst_port[src_idx];
-	pktio_src = gbl_args->pktios[src_idx];
-	pktio_dst = gbl_args->pktios[dst_idx];
-
-	printf("[%02i] srcif:%s dstif:%s spktio:%02" PRIu64
-	       " dpktio:%02" PRIu64 " DIRECT RECV mode\n",
-	       thr,
-	       gbl_args->appl.if_names[src_idx],
-	       gbl_args->appl.if_names[dst_idx],
-	       odp_pktio_to_u64(pktio_src), odp_pktio_to_u64(pktio_dst));
+	for (idx = 0; idx < thr_args->num_src; idx++) {
+		src_idx = thr_args->src_idx[idx];
+		dst_idx = gbl_args->dst_port[src_idx];
+
+		printf("[%02i] srcif:%s dstif:%s spktio:%02" PRIu64
+		       " dpktio:%02" PRIu64 " DIRECT RECV mode\n",
+		       thr,
+		       gbl_args->appl.if_names[src_idx],
+		       gbl_args->appl.if_names[dst_idx],
+		       odp_pktio_to_u64(gbl_args->pktios[src_idx]),
+		       odp_pktio_to_u64(gbl_args->pktios[dst_idx]));
+	}
 	odp_barrier_wait(&barrier);
 
-	/* Loop packets */
+	/* Loop packets, polling the source interfaces in turn */
+	idx = 0;
 	while (!exit_threads) {
-		int sent, i;
-		unsigned tx_drops;
+		src_idx = thr_args->src_idx[idx];
+		if (++idx == thr_args->num_src)
+			idx = 0;
 
-		pkts = odp_pktio_recv(pktio_src, pkt_tbl, MAX_PKT_BURST);
+		pkts = odp_pktio_recv(gbl_args->pktios[src_idx], pkt_tbl,
+				      MAX_PKT_BURST);
 		if (odp_unlikely(pkts <= 0))
 			continue;
 
-		if (gbl_args->appl.error_check) {
-			int rx_drops;
-
-			/* Drop packets with errors */
-			rx_drops = drop_err_pkts(pkt_tbl, pkts);
-
-			if (odp_unlikely(rx_drops)) {
-				stats->s.rx_drops += rx_drops;
-				if (pkts == rx_drops)
-					continue;
-
-				pkts -= rx_drops;
-			}
-		}
-
-		fill_eth_addrs(pkt_tbl, pkts, dst_idx);
-
-		sent = odp_pktio_send(pktio_dst, pkt_tbl, pkts);
-
-		sent     = odp_unlikely(sent < 0) ? 0 : sent;
-		tx_drops = pkts - sent;
-
-		if (odp_unlikely(tx_drops)) {
-			stats->s.tx_drops += tx_drops;
-
-			/* Drop rejected packets */
-			for (i = sent; i < pkts; i++)
-				odp_packet_free(pkt_tbl[i]);
-		}
-
-		stats->s.packets += pkts;
+		forward_pkts(pkt_tbl, pkts, src_idx, stats);
 	}
 
 	/* Make sure that latest stat writes are visible to other threads */
@@ -360,6 +444,18 @@ static odp_pktio_t create_pktio(const char *dev, odp_pool_t pool)
 	else
 		pktio_param.in_mode = ODP_PKTIN_MODE_SCHED;
 
+	if (gbl_args->appl.vector && gbl_args->appl.mode != DIRECT_RECV) {
+		pktio_param.in_vector.enable   = 1;
+		pktio_param.in_vector.pool     = gbl_args->vec_pool;
+		pktio_param.in_vector.max_size = gbl_args->appl.vector;
+	}
+
+	/* Only L2 headers are touched, unless errors are checked */
+	if (gbl_args->appl.error_check)
+		pktio_param.parse_level = ODP_PKTIO_PARSE_ALL;
+	else
+		pktio_param.parse_level = ODP_PKTIO_PARSE_L2;
+
 	pktio = odp_pktio_open(dev, pool, &pktio_param);
 	if (pktio == ODP_PKTIO_INVALID) {
 		LOG_ERR("Error: failed to open %s\n", dev);
@@ -403,6 +499,61 @@ static odp_pktio_t create_pktio(const char *dev, odp_pool_t pool)
 	return pktio;
 }
 
+/**
+ * Sum the statistics of a port over all worker threads
+ *
+ * @param num_workers Number of worker threads
+ * @param thr_stats Pointer to stats storage
+ * @param port Port index
+ * @param[out] sum Port statistics
+ */
+static void sum_port_stats(int num_workers, stats_t *thr_stats, int port,
+			   port_stats_t *sum)
+{
+	int i;
+
+	memset(sum, 0, sizeof(*sum));
+
+	for (i = 0; i < num_workers; i++) {
+		port_stats_t *stats = &thr_stats[i].port[port];
+
+		sum->packets  += LOAD_U64(stats->packets);
+		sum->bytes    += LOAD_U64(stats->bytes);
+		sum->rx_drops += LOAD_U64(stats->rx_drops);
+		sum->tx_drops += LOAD_U64(stats->tx_drops);
+	}
+}
+
+/**
+ * Print per port statistics of an interval in CSV
+ *
+ * Rates are of the packets forwarded to the port, bytes are counted from
+ * the Ethernet header without the frame check sequence. Drops are counted
+ * in the interval: receive errors of packets from the port and transmit
+ * errors of packets to the port.
+ *
+ * @param port_stats Port statistics at the end of the interval
+ * @param prev Port statistics at the start of the interval
+ * @param elapsed Seconds since start at the end of the interval
+ * @param interval Interval length in seconds
+ */
+static void print_port_csv(const port_stats_t port_stats[],
+			   const port_stats_t prev[], int elapsed,
+			   int interval)
+{
+	double usec = interval * 1000000.0;
+	int i;
+
+	for (i = 0; i < gbl_args->appl.if_count; i++)
+		printf("csv,%i,%i,%s,%.3f,%.3f,%" PRIu64 ",%" PRIu64 "\n",
+		       elapsed, i, gbl_args->appl.if_names[i],
+		       (port_stats[i].packets - prev[i].packets) / usec,
+		       (port_stats[i].bytes - prev[i].bytes) * 8 /
+		       (usec * 1000),
+		       port_stats[i].rx_drops - prev[i].rx_drops,
+		       port_stats[i].tx_drops - prev[i].tx_drops);
+}
+
 /**
  *  Print statistics
  *
@@ -415,6 +566,8 @@ static odp_pktio_t create_pktio(const char *dev, odp_pool_t pool)
 static int print_speed_stats(int num_workers, stats_t *thr_stats,
 			     int duration, int timeout)
 {
+	port_stats_t port_stats[ODP_CONFIG_PKTIO_ENTRIES];
+	port_stats_t port_prev[ODP_CONFIG_PKTIO_ENTRIES];
 	uint64_t pkts = 0;
 	uint64_t pkts_prev = 0;
 	uint64_t pps;
@@ -424,11 +577,17 @@ static int print_speed_stats(int num_workers, stats_t *thr_stats,
 	int elapsed = 0;
 	int stats_enabled = 1;
 	int loop_forever = (duration == 0);
+	int if_count = gbl_args->appl.if_count;
 
 	if (timeout <= 0) {
 		stats_enabled = 0;
 		timeout = 1;
 	}
+
+	memset(port_prev, 0, sizeof(port_prev));
+	if (stats_enabled && gbl_args->appl.csv)
+		printf("csv,time,port,interface,mpps,gbps,rx_drops,tx_drops\n");
+
 	/* Wait for all threads to be ready*/
 	odp_barrier_wait(&barrier);
 
@@ -438,11 +597,14 @@ static int print_speed_stats(int num_workers, stats_t *thr_stats,
 		tx_drops = 0;
 
 		sleep(timeout);
+		elapsed += timeout;
 
-		for (i = 0; i < num_workers; i++) {
-			pkts += LOAD_U64(thr_stats[i].s.packets);
-			rx_drops += LOAD_U64(thr_stats[i].s.rx_drops);
-			tx_drops += LOAD_U64(thr_stats[i].s.tx_drops);
+		for (i = 0; i < if_count; i++) {
+			sum_port_stats(num_workers, thr_stats, i,
+				       &port_stats[i]);
+			pkts += port_stats[i].packets;
+			rx_drops += port_stats[i].rx_drops;
+			tx_drops += port_stats[i].tx_drops;
 		}
 		if (stats_enabled) {
 			pps = (pkts - pkts_prev) / timeout;
@@ -454,9 +616,14 @@ static int print_speed_stats(int num_workers, stats_t *thr_stats,
 			printf(" %" PRIu64 " rx drops, %" PRIu64 " tx drops\n",
 			       rx_drops, tx_drops);
 
+			if (gbl_args->appl.csv)
+				print_port_csv(port_stats, port_prev, elapsed,
+					       timeout);
+
 			pkts_prev = pkts;
+			memcpy(port_prev, port_stats,
+			       if_count * sizeof(port_stats_t));
 		}
-		elapsed += timeout;
 	} while (loop_forever || (elapsed < duration));
 
 	if (stats_enabled)
@@ -528,12 +695,6 @@ int main(int argc, char *argv[])
 	printf("first CPU:          %i\n", odp_cpumask_first(&cpumask));
 	printf("cpu mask:           %s\n", cpumaskstr);
 
-	if (num_workers < gbl_args->appl.if_count) {
-		LOG_ERR("Error: CPU count %d less than interface count\n",
-			num_workers);
-		exit(EXIT_FAILURE);
-	}
-
 	/* Create packet pool */
 	odp_pool_param_init(&params);
 	params.pkt.seg_len = SHM_PKT_POOL_BUF_SIZE;
@@ -549,6 +710,24 @@ int main(int argc, char *argv[])
 	}
 	odp_pool_print(pool);
 
+	/* Create packet vector pool */
+	gbl_args->vec_pool = ODP_POOL_INVALID;
+	if (gbl_args->appl.vector && gbl_args->appl.mode != DIRECT_RECV) {
+		odp_pool_param_init(&params);
+		params.vec.num      = VEC_POOL_SIZE;
+		params.vec.max_size = gbl_args->appl.vector;
+		params.type         = ODP_POOL_VECTOR;
+
+		gbl_args->vec_pool = odp_pool_create("vector pool", &params);
+		if (gbl_args->vec_pool == ODP_POOL_INVALID) {
+			LOG_ERR("Error: vector pool create failed.\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	for (i = 0; i < PORT_MAP_SIZE; ++i)
+		gbl_args->port_map[i].pktio = ODP_PKTIO_INVALID;
+
 	for (i = 0; i < gbl_args->appl.if_count; ++i) {
 		pktio = create_pktio(gbl_args->appl.if_names[i], pool);
 		if (pktio == ODP_PKTIO_INVALID) {
@@ -579,7 +758,7 @@ int main(int argc, char *argv[])
 		gbl_args->pktios[n_pktios] = pktio;
 
 		/* Save interface ethernet address */
-		if (odp_pktio_mac_addr(pktio, gbl_args->port_eth_addr[n_pktios].addr,
+		if (odp_pktio_mac_addr(pktio, gbl_args->eth_addrs[n_pktios].src.addr,
 				       ODPH_ETHADDR_LEN) != ODPH_ETHADDR_LEN) {
 			LOG_ERR("Error: interface ethernet address unknown\n");
 			exit(EXIT_FAILURE);
@@ -591,7 +770,7 @@ int main(int argc, char *argv[])
 			memset(&new_addr, 0, sizeof(odph_ethaddr_t));
 			new_addr.addr[0] = 0x02;
 			new_addr.addr[5] = i;
-			gbl_args->dst_eth_addr[n_pktios] = new_addr;
+			gbl_args->eth_addrs[n_pktios].dst = new_addr;
 		}
 
 		/* Save interface destination port */
@@ -602,6 +781,22 @@ int main(int argc, char *argv[])
 	gbl_args->pktios[n_pktios] = ODP_PKTIO_INVALID;
 	gbl_args->appl.if_count = n_pktios;
 
+	/* Map input pktios to port indexes */
+	for (i = 0; i < gbl_args->appl.if_count; ++i)
+		add_src_port(gbl_args->pktios[i], i);
+
+	/* eth_addrs_t keeps dst and src addresses in header order, so that
+	 * the rewritten bytes are copied at once */
+	if (gbl_args->appl.dst_change) {
+		gbl_args->eth_rewrite_off = 0;
+		gbl_args->eth_rewrite_len = gbl_args->appl.src_change ?
+					    2 * ODPH_ETHADDR_LEN :
+					    ODPH_ETHADDR_LEN;
+	} else if (gbl_args->appl.src_change) {
+		gbl_args->eth_rewrite_off = ODPH_ETHADDR_LEN;
+		gbl_args->eth_rewrite_len = ODPH_ETHADDR_LEN;
+	}
+
 	/* If all are broken, exit */
 	if (gbl_args->appl.if_count == 0) {
 		usage(argv[0]);
@@ -614,6 +809,19 @@ int main(int argc, char *argv[])
 
 	odp_barrier_init(&barrier, num_workers + 1);
 
+	/* Spread interfaces over workers in direct receive mode: with more
+	 * workers than interfaces several workers receive from the same
+	 * interface, with fewer each worker polls several interfaces. */
+	for (i = 0; i < num_workers; ++i) {
+		thread_args_t *thr_args = &gbl_args->thread[i];
+		int port;
+
+		thr_args->num_src = 0;
+		for (port = i % gbl_args->appl.if_count;
+		     port < gbl_args->appl.if_count; port += num_workers)
+			thr_args->src_idx[thr_args->num_src++] = port;
+	}
+
 	/* Create worker threads */
 	cpu = odp_cpumask_first(&cpumask);
 	for (i = 0; i < num_workers; ++i) {
@@ -625,7 +833,6 @@ int main(int argc, char *argv[])
 		else /* SCHED_NONE / SCHED_ATOMIC / SCHED_ORDERED */
 			thr_run_func = pktio_queue_thread;
 
-		gbl_args->thread[i].src_idx = i % gbl_args->appl.if_count;
 		gbl_args->thread[i].stats = &stats[i];
 
 		odp_cpumask_zero(&thd_mask);
@@ -705,31 +912,47 @@ static int drop_err_pkts(odp_packet_t pkt_tbl[], unsigned num)
 /**
  * Fill packets' eth addresses according to the destination port
  *
+ * The addresses of the port are prepared in header order, a single copy
+ * rewrites the addresses of a packet. Packets are received at least L2
+ * parsed, so the eth header is at the L2 offset of any packet long
+ * enough to carry one.
+ *
  * @param pkt_tbl  Array of packets
  * @param num      Number of packets in the array
  * @param dst_port Destination port
+ *
+ * @return Number of bytes in the packets
  */
-static void fill_eth_addrs(odp_packet_t pkt_tbl[], unsigned num, int dst_port)
+static uint64_t fill_eth_addrs(odp_packet_t pkt_tbl[], unsigned num,
+			       int dst_port)
 {
-	odp_packet_t pkt;
-	odph_ethhdr_t *eth;
+	const uint8_t *addrs = (const uint8_t *)&gbl_args->eth_addrs[dst_port];
+	unsigned off = gbl_args->eth_rewrite_off;
+	unsigned len = gbl_args->eth_rewrite_len;
+	uint64_t bytes = 0;
+	uint32_t pkt_len;
+	uint8_t *eth;
 	unsigned i;
 
-	if (!gbl_args->appl.dst_change && !gbl_args->appl.src_change)
-		return;
+	if (len == 0) {
+		for (i = 0; i < num; ++i)
+			bytes += odp_packet_len(pkt_tbl[i]);
+
+		return bytes;
+	}
 
 	for (i = 0; i < num; ++i) {
-		pkt = pkt_tbl[i];
-		if (odp_packet_has_eth(pkt)) {
-			eth = (odph_ethhdr_t *)odp_packet_l2_ptr(pkt, NULL);
+		pkt_len = odp_packet_len(pkt_tbl[i]);
+		bytes  += pkt_len;
 
-			if (gbl_args->appl.src_change)
-				eth->src = gbl_args->port_eth_addr[dst_port];
+		if (odp_unlikely(pkt_len < ODPH_ETHHDR_LEN))
+			continue;
 
-			if (gbl_args->appl.dst_change)
-				eth->dst = gbl_args->dst_eth_addr[dst_port];
-		}
+		eth = odp_packet_l2_ptr(pkt_tbl[i], NULL);
+		memcpy(eth + off, addrs + off, len);
 	}
+
+	return bytes;
 }
 
 /**
@@ -757,6 +980,8 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 		{"error_check", required_argument, NULL, 'e'},
 		{"pktio_stats", no_argument, NULL, 'S'},
 		{"allow_fail", no_argument, NULL, 'A'},
+		{"vector", required_argument, NULL, 'v'},
+		{"csv", no_argument, NULL, 'C'},
 		{"help", no_argument, NULL, 'h'},
 		{NULL, 0, NULL, 0}
 	};
@@ -767,9 +992,11 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 	appl_args->error_check = 0; /* don't check packet errors by default */
 	appl_args->pktio_stats = 0;
 	appl_args->allow_fail = 0;
+	appl_args->vector = 0;
+	appl_args->csv = 0;
 
 	while (1) {
-		opt = getopt_long(argc, argv, "+c:+t:+a:i:m:d:Ss:e:h",
+		opt = getopt_long(argc, argv, "+c:+t:+a:i:m:d:Ss:e:Av:Ch",
 				  longopts, &long_index);
 
 		if (opt == -1)
@@ -851,6 +1078,12 @@ static void parse_args(int argc, char *argv[], appl_args_t *appl_args)
 		case 'A':
 			appl_args->allow_fail = 1;
 			break;
+		case 'v':
+			appl_args->vector = atoi(optarg);
+			break;
+		case 'C':
+			appl_args->csv = 1;
+			break;
 		case 'h':
 			usage(argv[0]);
 			exit(EXIT_SUCCESS);
@@ -904,6 +1137,8 @@ static void print_info(char *progname, appl_args_t *appl_args)
 		printf("SCHED_ATOMIC");
 	else if (appl_args->mode == SCHED_ORDERED)
 		printf("SCHED_ORDERED");
+	if (appl_args->vector && appl_args->mode != DIRECT_RECV)
+		printf(", vectors of %i packets", appl_args->vector);
 	printf("\n\n");
 	fflush(NULL);
 }
@@ -942,6 +1177,11 @@ static void usage(char *progname)
 	       "                    1: Check packet errors\n"
 	       "  -S, --pktio_stats  : Display pktio statistics before exiting\n"
 	       "  -A, --allow_fail   : Allow a pktio to fail to open. In this case, skip this forward.\n"
+	       "  -v, --vector <number> Receive up to <number> packets per event\n"
+	       "                        in scheduled modes (default 0: no vectors).\n"
+	       "  -C, --csv          : Print per port statistics every -a seconds\n"
+	       "                       as 'csv,time,port,interface,mpps,gbps,\n"
+	       "                       rx_drops,tx_drops' lines.\n"
 	       "  -h, --help           Display help and exit.\n\n"
 	       " environment variables: ODP_PKTIO_DISABLE_NETMAP\n"
 	       "                        ODP_PKTIO_DISABLE_SOCKET_MMAP\n"
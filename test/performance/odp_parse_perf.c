@@ -0,0 +1,316 @@
+/* Copyright (c) 2015, Linaro Limited
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier:     BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * @example odp_parse_perf.c  ODP packet parser benchmark
+ *
+ * Loops a mix of Ethernet/VLAN/IPv4/IPv6/TCP/UDP/ARP packets through the
+ * loop interface and measures the receive cost per packet with parsing
+ * disabled, with the one packet at a time parser and with the burst
+ * parser. The difference with the unparsed run is the cost of parsing.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <inttypes.h>
+
+#include <test_debug.h>
+
+#include <odp.h>
+#include <odp/helper/eth.h>
+#include <odp/helper/ip.h>
+#include <odp/helper/udp.h>
+#include <odp/helper/tcp.h>
+
+#define PKT_NUM		256	/* Packets looped through the interface */
+#define PKT_LEN		128	/* Length of test packets */
+#define BURST_MAX	32	/* Max packets per send/receive */
+#define ROUNDS_DEF	20000	/* Default number of bursts per run */
+
+/** Benchmark runs */
+typedef struct {
+	const char *name;
+	odp_pktio_parse_level_t level;
+	int scalar;	/**< disable the burst parser */
+} parse_run_t;
+
+static const parse_run_t runs[] = {
+	{"no parse",     ODP_PKTIO_PARSE_NONE, 0},
+	{"scalar L3",    ODP_PKTIO_PARSE_L3,   1},
+	{"burst L3",     ODP_PKTIO_PARSE_L3,   0},
+	{"scalar all",   ODP_PKTIO_PARSE_ALL,  1},
+	{"burst all",    ODP_PKTIO_PARSE_ALL,  0},
+};
+
+#define NUM_RUNS (sizeof(runs) / sizeof(runs[0]))
+
+/** Packet mix, one entry per generated packet type */
+typedef enum {
+	MIX_IPV4_UDP = 0,
+	MIX_IPV4_TCP,
+	MIX_VLAN_IPV4_UDP,
+	MIX_IPV6_UDP,
+	MIX_IPV6_TCP,
+	MIX_IPV4_OPT_UDP,
+	MIX_ARP,
+	MIX_NUM
+} pkt_mix_t;
+
+static void fill_packet(odp_packet_t pkt, pkt_mix_t type)
+{
+	uint8_t *buf = odp_packet_data(pkt);
+	uint32_t len = odp_packet_len(pkt);
+	uint32_t off = ODPH_ETHHDR_LEN;
+	odph_ethhdr_t *eth = (odph_ethhdr_t *)(void *)buf;
+	odph_vlanhdr_t *vlan;
+	odph_ipv4hdr_t *ip;
+	odph_ipv6hdr_t *ip6;
+	odph_udphdr_t *udp;
+	odph_tcphdr_t *tcp;
+	uint16_t ethtype;
+	uint8_t proto = ODPH_IPPROTO_UDP;
+	int ihl = ODPH_IPV4HDR_IHL_MIN;
+
+	memset(buf, 0, len);
+	memset(eth->dst.addr, 0xff, ODPH_ETHADDR_LEN);
+	eth->src.addr[0] = 0x02;
+
+	switch (type) {
+	case MIX_VLAN_IPV4_UDP:
+		vlan = (odph_vlanhdr_t *)(void *)(buf + ODPH_ETHHDR_LEN - 2);
+		vlan->tpid = odp_cpu_to_be_16(ODPH_ETHTYPE_VLAN);
+		vlan->tci = odp_cpu_to_be_16(100);
+		off += ODPH_VLANHDR_LEN;
+		ethtype = ODPH_ETHTYPE_IPV4;
+		break;
+	case MIX_IPV6_UDP:
+	case MIX_IPV6_TCP:
+		ethtype = ODPH_ETHTYPE_IPV6;
+		break;
+	case MIX_ARP:
+		ethtype = ODPH_ETHTYPE_ARP;
+		break;
+	default:
+		ethtype = ODPH_ETHTYPE_IPV4;
+		break;
+	}
+
+	*(uint16_t *)(void *)(buf + off - 2) = odp_cpu_to_be_16(ethtype);
+
+	if (type == MIX_IPV4_TCP || type == MIX_IPV6_TCP)
+		proto = ODPH_IPPROTO_TCP;
+	if (type == MIX_IPV4_OPT_UDP)
+		ihl += 1;
+
+	if (ethtype == ODPH_ETHTYPE_IPV4) {
+		ip = (odph_ipv4hdr_t *)(void *)(buf + off);
+		ip->ver_ihl = ODPH_IPV4 << 4 | ihl;
+		ip->tot_len = odp_cpu_to_be_16(len - off);
+		ip->ttl = 64;
+		ip->proto = proto;
+		ip->src_addr = odp_cpu_to_be_32(0x0a000001);
+		ip->dst_addr = odp_cpu_to_be_32(0x0a000002);
+		off += ihl * 4;
+	} else if (ethtype == ODPH_ETHTYPE_IPV6) {
+		ip6 = (odph_ipv6hdr_t *)(void *)(buf + off);
+		ip6->ver_tc_flow = odp_cpu_to_be_32(6 << 28);
+		ip6->payload_len = odp_cpu_to_be_16(len - off -
+						    ODPH_IPV6HDR_LEN);
+		ip6->next_hdr = proto;
+		ip6->hop_limit = 64;
+		off += ODPH_IPV6HDR_LEN;
+	} else {
+		return;
+	}
+
+	if (proto == ODPH_IPPROTO_UDP) {
+		udp = (odph_udphdr_t *)(void *)(buf + off);
+		udp->src_port = odp_cpu_to_be_16(1024);
+		udp->dst_port = odp_cpu_to_be_16(1025);
+		udp->length = odp_cpu_to_be_16(len - off);
+	} else {
+		tcp = (odph_tcphdr_t *)(void *)(buf + off);
+		tcp->src_port = odp_cpu_to_be_16(1024);
+		tcp->dst_port = odp_cpu_to_be_16(1025);
+		tcp->hl = ODPH_TCPHDR_LEN / 4;
+	}
+}
+
+/* Loop packets through the interface, return receive cycles per packet */
+static double run_parse(odp_pool_t pool, odp_packet_t pkt[],
+			const parse_run_t *run, int rounds, int burst)
+{
+	odp_pktio_param_t param;
+	odp_pktio_t pktio;
+	uint64_t c1, cycles = 0, num_rx = 0;
+	int i, j, sent, recv, next = 0;
+
+	if (run->scalar)
+		setenv("ODP_PKTIO_DISABLE_PARSE_BURST", "1", 1);
+	else
+		unsetenv("ODP_PKTIO_DISABLE_PARSE_BURST");
+
+	odp_pktio_param_init(&param);
+	param.in_mode = ODP_PKTIN_MODE_RECV;
+	param.parse_level = run->level;
+
+	pktio = odp_pktio_open("loop", pool, &param);
+	if (pktio == ODP_PKTIO_INVALID || odp_pktio_start(pktio)) {
+		LOG_ERR("Error: failed to open loop interface\n");
+		return -1.0;
+	}
+
+	for (i = 0; i < rounds; i++) {
+		sent = odp_pktio_send(pktio, &pkt[next], burst);
+		if (sent < 0)
+			sent = 0;
+
+		for (j = 0; j < sent; ) {
+			c1 = odp_cpu_cycles();
+			recv = odp_pktio_recv(pktio, &pkt[next + j], sent - j);
+			cycles += odp_cpu_cycles_diff(odp_cpu_cycles(), c1);
+			if (recv < 0)
+				break;
+			j += recv;
+		}
+
+		num_rx += j;
+		next += burst;
+		if (next + burst > PKT_NUM)
+			next = 0;
+	}
+
+	odp_pktio_stop(pktio);
+	odp_pktio_close(pktio);
+
+	return num_rx ? (double)cycles / num_rx : -1.0;
+}
+
+static void usage(char *progname)
+{
+	printf("\n"
+	       "Usage: %s OPTIONS\n"
+	       "  E.g. %s -r 100000 -b 16\n"
+	       "\n"
+	       "Optional OPTIONS\n"
+	       "  -r, --rounds <number>  Number of bursts per run (default %d)\n"
+	       "  -b, --burst <number>   Packets per burst (default %d, max %d)\n"
+	       "  -h, --help             Display help and exit.\n"
+	       "\n", progname, progname, ROUNDS_DEF, BURST_MAX, BURST_MAX);
+}
+
+int main(int argc, char *argv[])
+{
+	odp_pool_param_t params;
+	odp_pool_t pool;
+	odp_packet_t pkt[PKT_NUM];
+	double cost[NUM_RUNS];
+	int rounds = ROUNDS_DEF;
+	int burst = BURST_MAX;
+	int opt, long_index;
+	unsigned i;
+	int ret = 0;
+
+	static struct option longopts[] = {
+		{"rounds", required_argument, NULL, 'r'},
+		{"burst", required_argument, NULL, 'b'},
+		{"help", no_argument, NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	while (1) {
+		opt = getopt_long(argc, argv, "+r:b:h", longopts, &long_index);
+
+		if (opt == -1)
+			break;
+
+		switch (opt) {
+		case 'r':
+			rounds = atoi(optarg);
+			break;
+		case 'b':
+			burst = atoi(optarg);
+			break;
+		case 'h':
+			usage(argv[0]);
+			exit(EXIT_SUCCESS);
+		default:
+			usage(argv[0]);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	if (rounds <= 0 || burst <= 0 || burst > BURST_MAX) {
+		usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_init_global(NULL, NULL)) {
+		LOG_ERR("Error: ODP global init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	if (odp_init_local(ODP_THREAD_CONTROL)) {
+		LOG_ERR("Error: ODP local init failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	odp_pool_param_init(&params);
+	params.pkt.len     = PKT_LEN;
+	params.pkt.seg_len = PKT_LEN;
+	params.pkt.num     = PKT_NUM;
+	params.type        = ODP_POOL_PACKET;
+
+	pool = odp_pool_create("parse_perf_pool", &params);
+	if (pool == ODP_POOL_INVALID) {
+		LOG_ERR("Error: packet pool create failed.\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (i = 0; i < PKT_NUM; i++) {
+		pkt[i] = odp_packet_alloc(pool, PKT_LEN);
+		if (pkt[i] == ODP_PACKET_INVALID) {
+			LOG_ERR("Error: packet alloc failed.\n");
+			exit(EXIT_FAILURE);
+		}
+		fill_packet(pkt[i], i % MIX_NUM);
+	}
+
+	printf("\nParser benchmark: %d bursts of %d packets, %d types mix\n",
+	       rounds, burst, MIX_NUM);
+
+	for (i = 0; i < NUM_RUNS; i++) {
+		cost[i] = run_parse(pool, pkt, &runs[i], rounds, burst);
+		if (cost[i] < 0) {
+			ret = -1;
+			break;
+		}
+
+		printf("  %-12s %8.1f cycles/pkt", runs[i].name, cost[i]);
+		if (i > 0)
+			printf("  (parse %6.1f)", cost[i] - cost[0]);
+		printf("\n");
+	}
+
+	for (i = 0; i < PKT_NUM; i++)
+		odp_packet_free(pkt[i]);
+
+	if (odp_pool_destroy(pool))
+		ret = -1;
+
+	if (odp_term_local() || odp_term_global())
+		ret = -1;
+
+	return ret ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -19,6 +19,13 @@
  * determine the maximum rate at which no packet loss occurs. Alternatively
  * a single packet rate can be specified on the command line.
  *
+ * In RFC 2544 mode the search is repeated for each frame size of a list,
+ * which may include an IMIX. Each frame size starts with a warm-up period
+ * which is not measured. Packets are time stamped at transmit and the
+ * receivers sample the latency. Throughput at zero loss, loss at the
+ * lowest failing rate and latency percentiles at the zero loss rate are
+ * reported per frame size as text and as 'csv,' prefixed lines.
+ *
  */
 #include <odp.h>
 
@@ -28,6 +35,7 @@
 #include <odp/helper/linux.h>
 
 #include <getopt.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -38,6 +46,29 @@
 #define TEST_HDR_MAGIC    0x92749451
 #define MAX_WORKERS       32
 #define BATCH_LEN_MAX     8
+#define MAX_FRAME_SIZES   16
+#define LAT_SAMPLES       2048
+
+/* Ethernet FCS, included in RFC 2544 frame sizes but not in packets */
+#define ETH_FCS_LEN (ODPH_ETH_LEN_MIN_CRC - ODPH_ETH_LEN_MIN)
+
+/* Frame size which selects the IMIX pattern in RFC 2544 mode */
+#define FRAME_SIZE_IMIX 0
+
+/* Simple IMIX, 64:594:1518 frames in 7:4:1 ratio, interleaved */
+static const unsigned imix_pattern[] = {
+	64, 594, 64, 594, 64, 64, 1518, 64, 594, 64, 594, 64
+};
+
+#define MAX_PATTERN_LEN (sizeof(imix_pattern) / sizeof(imix_pattern[0]))
+
+/* Frame sizes of RFC 2544 section 9.1 for Ethernet */
+static const unsigned rfc2544_sizes[] = {
+	64, 128, 256, 512, 1024, 1280, 1518
+};
+
+/* Default warm-up time, in milliseconds, before each frame size */
+#define WARMUP_DEFAULT_MS 100
 
 /* Packet rate at which to start when using binary search */
 #define RATE_SEARCH_INITIAL_PPS 1000000
@@ -86,6 +117,14 @@ typedef struct {
 				   Perform a search at different packet rates
 				   to determine the maximum rate at which no
 				   packet loss occurs. */
+	uint64_t accuracy;	/* Search stops when pass and fail rates are
+				   closer than this (PPS) */
+	int      rfc2544;	/* Run the test for each frame size of
+				   frame_size[] */
+	unsigned frame_size[MAX_FRAME_SIZES]; /* Frame sizes in bytes
+				   including FCS, or FRAME_SIZE_IMIX */
+	int      num_frame_sizes;
+	int      warmup_ms;	/* Warm-up time before each frame size */
 
 	char     *if_str;
 	const char *ifaces[MAX_NUM_IFACES];
@@ -95,6 +134,7 @@ typedef struct {
 struct rx_stats_s {
 	uint64_t rx_cnt;	/* Valid packets received */
 	uint64_t rx_ignore;	/* Ignored packets */
+	uint32_t lat_cnt;	/* Latency samples recorded */
 };
 
 typedef union rx_stats_u {
@@ -127,6 +167,10 @@ typedef struct {
 	uint8_t dst_mac[ODPH_ETHADDR_LEN];
 	uint32_t rx_stats_size;
 	uint32_t tx_stats_size;
+	uint32_t *lat_samples;	/* LAT_SAMPLES latencies (ns) per thread */
+	uint32_t lat_samples_size;
+	odp_packet_t tx_tmpl[MAX_PATTERN_LEN]; /* Packets sent in turn */
+	int num_tx_tmpl;
 } test_globals_t;
 
 /* Status of max rate search */
@@ -134,17 +178,27 @@ typedef struct {
 	uint64_t pps_curr; /* Current attempted PPS */
 	uint64_t pps_pass; /* Highest passing PPS */
 	uint64_t pps_fail; /* Lowest failing PPS */
+	double   loss_pct; /* Packet loss at pps_fail */
+	uint64_t lat_p50;  /* Latency percentiles (ns) at pps_pass */
+	uint64_t lat_p90;
+	uint64_t lat_p99;
+	uint64_t lat_max;
 } test_status_t;
 
 /* Thread specific arguments */
 typedef struct {
 	int batch_len; /* Number of packets per transmit batch */
-	int duration;  /* Run duration in seconds */
+	uint64_t duration_ns; /* Run duration in nanoseconds */
 	uint64_t pps;  /* Packets per second for this thread */
+	int stamp;     /* Time stamp transmitted packets */
+	uint32_t lat_stride; /* Sample latency of every Nth received
+				packet, 0: no sampling */
 } thread_args_t;
 
 typedef struct {
 	uint32be_t magic; /* Packet header magic number */
+	uint32_t pad;
+	uint64_t tx_ns;   /* Global transmit time, 0: not stamped */
 } pkt_head_t;
 
 /* Pool from which transmitted packets are allocated */
@@ -160,9 +214,10 @@ static odp_atomic_u32_t shutdown;
 static test_globals_t *gbl_args;
 
 /*
- * Generate a single test packet for transmission.
+ * Generate a single test packet for transmission, which is used as template
+ * of the transmitted packets.
  */
-static odp_packet_t pktio_create_packet(void)
+static odp_packet_t pktio_create_packet(uint32_t len)
 {
 	odp_packet_t pkt;
 	odph_ethhdr_t *eth;
@@ -174,7 +229,8 @@ static odp_packet_t pktio_create_packet(void)
 	pkt_head_t pkt_hdr;
 	size_t payload_len;
 
-	payload_len = sizeof(pkt_hdr) + gbl_args->args.pkt_len;
+	payload_len = len - (ODPH_UDPHDR_LEN + ODPH_IPV4HDR_LEN +
+			     ODPH_ETHHDR_LEN);
 
 	pkt = odp_packet_alloc(transmit_pkt_pool,
 			       payload_len + ODPH_UDPHDR_LEN +
@@ -220,6 +276,7 @@ static odp_packet_t pktio_create_packet(void)
 
 	/* payload */
 	offset += ODPH_UDPHDR_LEN;
+	memset(&pkt_hdr, 0, sizeof(pkt_hdr));
 	pkt_hdr.magic = TEST_HDR_MAGIC;
 	if (odp_packet_copydata_in(pkt, offset, sizeof(pkt_hdr), &pkt_hdr) != 0)
 		LOG_ABORT("Failed to generate test packet.\n");
@@ -228,48 +285,100 @@ static odp_packet_t pktio_create_packet(void)
 }
 
 /*
- * Check if a packet payload contains test payload magic number.
+ * Check if a packet payload contains test payload magic number. The test
+ * header is copied to pkt_hdr.
  */
-static int pktio_pkt_has_magic(odp_packet_t pkt)
+static int pktio_pkt_has_magic(odp_packet_t pkt, pkt_head_t *pkt_hdr)
 {
 	size_t l4_off;
-	pkt_head_t pkt_hdr;
 
 	l4_off = odp_packet_l4_offset(pkt);
 	if (l4_off) {
 		int ret = odp_packet_copydata_out(pkt,
 						  l4_off+ODPH_UDPHDR_LEN,
-						  sizeof(pkt_hdr), &pkt_hdr);
+						  sizeof(*pkt_hdr), pkt_hdr);
 
 		if (ret != 0)
 			return 0;
 
-		if (pkt_hdr.magic == TEST_HDR_MAGIC)
+		if (pkt_hdr->magic == TEST_HDR_MAGIC)
 			return 1;
 	}
 
 	return 0;
 }
 
+/*
+ * Create the template packets of the given packet lengths. Transmitters
+ * send copies of the templates in turn.
+ */
+static int create_templates(const unsigned len[], int num)
+{
+	int i;
+
+	for (i = 0; i < num; ++i) {
+		gbl_args->tx_tmpl[i] = pktio_create_packet(len[i]);
+		if (gbl_args->tx_tmpl[i] == ODP_PACKET_INVALID) {
+			while (--i >= 0)
+				odp_packet_free(gbl_args->tx_tmpl[i]);
+			return -1;
+		}
+	}
+
+	gbl_args->num_tx_tmpl = num;
+	return 0;
+}
+
+static void free_templates(void)
+{
+	int i;
+
+	for (i = 0; i < gbl_args->num_tx_tmpl; ++i)
+		odp_packet_free(gbl_args->tx_tmpl[i]);
+
+	gbl_args->num_tx_tmpl = 0;
+}
 
 /*
- * Allocate packets for transmission.
+ * Allocate packets for transmission by copying the templates, starting
+ * from template *tmpl_idx.
  */
-static int alloc_packets(odp_event_t *event_tbl, int num_pkts)
+static int alloc_packets(odp_event_t *event_tbl, int num_pkts, int *tmpl_idx)
 {
-	odp_packet_t pkt_tbl[num_pkts];
+	odp_packet_t pkt;
+	int idx = *tmpl_idx;
 	int n;
 
 	for (n = 0; n < num_pkts; ++n) {
-		pkt_tbl[n] = pktio_create_packet();
-		if (pkt_tbl[n] == ODP_PACKET_INVALID)
+		pkt = odp_packet_copy(gbl_args->tx_tmpl[idx],
+				      transmit_pkt_pool);
+		if (pkt == ODP_PACKET_INVALID)
 			break;
-		event_tbl[n] = odp_packet_to_event(pkt_tbl[n]);
+		event_tbl[n] = odp_packet_to_event(pkt);
+
+		if (++idx == gbl_args->num_tx_tmpl)
+			idx = 0;
 	}
 
+	*tmpl_idx = idx;
 	return n;
 }
 
+/*
+ * Write the current global time into the test header of packets
+ */
+static void stamp_packets(odp_event_t *event_tbl, int num_pkts)
+{
+	const uint32_t offset = ODPH_ETHHDR_LEN + ODPH_IPV4HDR_LEN +
+				ODPH_UDPHDR_LEN + offsetof(pkt_head_t, tx_ns);
+	uint64_t tx_ns = odp_time_to_ns(odp_time_global());
+	int i;
+
+	for (i = 0; i < num_pkts; ++i)
+		odp_packet_copydata_in(odp_packet_from_event(event_tbl[i]),
+				       offset, sizeof(tx_ns), &tx_ns);
+}
+
 static int send_packets(odp_queue_t outq,
 			odp_event_t *event_tbl, unsigned num_pkts)
 {
@@ -311,6 +420,7 @@ static void *run_thread_tx(void *arg)
 	int unsent_pkts = 0;
 	odp_event_t  tx_event[BATCH_LEN_MAX];
 	odp_time_t idle_start = ODP_TIME_NULL;
+	int tmpl_idx;
 
 	thread_args_t *targs = arg;
 
@@ -328,10 +438,12 @@ static void *run_thread_tx(void *arg)
 	if (outq == ODP_QUEUE_INVALID)
 		LOG_ABORT("Failed to get output queue for thread %d\n", thr_id);
 
+	/* transmitters start from different templates of a pattern */
+	tmpl_idx = thr_id % globals->num_tx_tmpl;
+
 	burst_gap = odp_time_local_from_ns(
 			ODP_TIME_SEC_IN_NS / (targs->pps / targs->batch_len));
-	send_duration =
-		odp_time_local_from_ns(targs->duration * ODP_TIME_SEC_IN_NS);
+	send_duration = odp_time_local_from_ns(targs->duration_ns);
 
 	odp_barrier_wait(&globals->tx_barrier);
 
@@ -359,10 +471,14 @@ static void *run_thread_tx(void *arg)
 
 		burst_gap_end = odp_time_sum(burst_gap_end, burst_gap);
 
-		alloc_cnt = alloc_packets(tx_event, batch_len - unsent_pkts);
+		alloc_cnt = alloc_packets(tx_event, batch_len - unsent_pkts,
+					  &tmpl_idx);
 		if (alloc_cnt != batch_len)
 			stats->s.alloc_failures++;
 
+		if (targs->stamp)
+			stamp_packets(tx_event, alloc_cnt);
+
 		tx_cnt = send_packets(outq, tx_event, alloc_cnt);
 		unsent_pkts = alloc_cnt - tx_cnt;
 		stats->s.enq_failures += unsent_pkts;
@@ -426,6 +542,7 @@ static void *run_thread_rx(void *arg)
 	globals = odp_shm_addr(odp_shm_lookup("test_globals"));
 
 	pkt_rx_stats_t *stats = &globals->rx_stats[thr_id];
+	uint32_t *lat = &globals->lat_samples[thr_id * LAT_SAMPLES];
 
 	if (gbl_args->args.schedule == 0) {
 		pollq = odp_pktio_inq_getdef(globals->pktio_rx);
@@ -443,10 +560,22 @@ static void *run_thread_rx(void *arg)
 		for (i = 0; i < n_ev; ++i) {
 			if (odp_event_type(ev[i]) == ODP_EVENT_PACKET) {
 				odp_packet_t pkt = odp_packet_from_event(ev[i]);
-				if (pktio_pkt_has_magic(pkt))
+				pkt_head_t pkt_hdr;
+
+				if (pktio_pkt_has_magic(pkt, &pkt_hdr)) {
 					stats->s.rx_cnt++;
-				else
+					if (targs->lat_stride &&
+					    stats->s.rx_cnt %
+					    targs->lat_stride == 0 &&
+					    stats->s.lat_cnt < LAT_SAMPLES &&
+					    pkt_hdr.tx_ns)
+						lat[stats->s.lat_cnt++] =
+							odp_time_to_ns(
+							odp_time_global()) -
+							pkt_hdr.tx_ns;
+				} else {
 					stats->s.rx_ignore++;
+				}
 			}
 			odp_event_free(ev[i]);
 		}
@@ -457,6 +586,52 @@ static void *run_thread_rx(void *arg)
 	return NULL;
 }
 
+static int lat_cmp(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+/*
+ * Compute latency percentiles from the samples of all receivers.
+ * Returns the number of samples.
+ */
+static uint32_t latency_results(test_status_t *lat)
+{
+	uint32_t *tbl;
+	uint32_t num = 0;
+	int i;
+
+	for (i = 0; i < odp_thread_count_max(); ++i)
+		num += gbl_args->rx_stats[i].s.lat_cnt;
+
+	if (num == 0)
+		return 0;
+
+	tbl = malloc(num * sizeof(uint32_t));
+	if (tbl == NULL)
+		return 0;
+
+	num = 0;
+	for (i = 0; i < odp_thread_count_max(); ++i) {
+		memcpy(&tbl[num], &gbl_args->lat_samples[i * LAT_SAMPLES],
+		       gbl_args->rx_stats[i].s.lat_cnt * sizeof(uint32_t));
+		num += gbl_args->rx_stats[i].s.lat_cnt;
+	}
+
+	qsort(tbl, num, sizeof(uint32_t), lat_cmp);
+
+	lat->lat_p50 = tbl[(num - 1) * 50 / 100];
+	lat->lat_p90 = tbl[(num - 1) * 90 / 100];
+	lat->lat_p99 = tbl[(num - 1) * 99 / 100];
+	lat->lat_max = tbl[num - 1];
+
+	free(tbl);
+	return num;
+}
+
 /*
  * Process the results from a single fixed rate test run to determine whether
  * it passed or failed. Pass criteria are that the requested transmit packet
@@ -470,6 +645,8 @@ static int process_results(uint64_t expected_tx_cnt,
 	uint64_t rx_pkts = 0;
 	uint64_t tx_pkts = 0;
 	uint64_t attempted_pps;
+	test_status_t lat;
+	uint32_t lat_num = 0;
 	int i;
 	char str[512];
 	int len = 0;
@@ -495,6 +672,9 @@ static int process_results(uint64_t expected_tx_cnt,
 
 	attempted_pps = status->pps_curr;
 
+	if (gbl_args->args.rfc2544)
+		lat_num = latency_results(&lat);
+
 	len += snprintf(&str[len], sizeof(str)-1-len,
 			"PPS: %-8"PRIu64" ", attempted_pps);
 	len += snprintf(&str[len], sizeof(str)-1-len,
@@ -505,18 +685,29 @@ static int process_results(uint64_t expected_tx_cnt,
 			"RxPkts: %-8"PRIu64" ", rx_pkts);
 	len += snprintf(&str[len], sizeof(str)-1-len,
 			"DropPkts: %-8"PRIu64" ", drops);
+	if (lat_num)
+		len += snprintf(&str[len], sizeof(str)-1-len,
+				"LatP99: %"PRIu64"ns ", lat.lat_p99);
 	printf("%s\n", str);
 
-	if (gbl_args->args.search == 0) {
-		printf("Result: %s\n", fail ? "FAILED" : "PASSED");
-		return fail ? -1 : 0;
-	}
-
 	if (fail && (status->pps_fail == 0 ||
 		     attempted_pps < status->pps_fail)) {
 		status->pps_fail = attempted_pps;
-	} else if (attempted_pps > status->pps_pass) {
+		status->loss_pct = tx_pkts > rx_pkts ?
+			100.0 * (tx_pkts - rx_pkts) / tx_pkts : 0.0;
+	} else if (!fail && attempted_pps > status->pps_pass) {
 		status->pps_pass = attempted_pps;
+		if (lat_num) {
+			status->lat_p50 = lat.lat_p50;
+			status->lat_p90 = lat.lat_p90;
+			status->lat_p99 = lat.lat_p99;
+			status->lat_max = lat.lat_max;
+		}
+	}
+
+	if (gbl_args->args.search == 0) {
+		printf("Result: %s\n", fail ? "FAILED" : "PASSED");
+		return fail ? -1 : 0;
 	}
 
 	if (status->pps_fail == 0) {
@@ -530,12 +721,13 @@ static int process_results(uint64_t expected_tx_cnt,
 	}
 
 	/* stop once the pass and fail measurements are within range */
-	if ((status->pps_fail - status->pps_pass) < RATE_SEARCH_ACCURACY_PPS) {
+	if ((status->pps_fail - status->pps_pass) < gbl_args->args.accuracy) {
 		unsigned pkt_len = gbl_args->args.pkt_len + PKT_HDR_LEN;
 		int mbps = (pkt_len * status->pps_pass * 8) / 1024 / 1024;
 
-		printf("Maximum packet rate: %"PRIu64" PPS (%d Mbps)\n",
-		       status->pps_pass, mbps);
+		if (!gbl_args->args.rfc2544)
+			printf("Maximum packet rate: %"PRIu64" PPS (%d Mbps)\n",
+			       status->pps_pass, mbps);
 
 		return 0;
 	}
@@ -592,17 +784,16 @@ static int setup_txrx_masks(odp_cpumask_t *thd_mask_tx,
 }
 
 /*
- * Run a single instance of the throughput test. When attempting to determine
- * the maximum packet rate this will be invoked multiple times with the only
- * difference between runs being the target PPS rate.
+ * Transmit at a fixed rate for the given time and receive until the
+ * shutdown delay has passed, leaving the counts in the thread statistics.
  */
-static int run_test_single(odp_cpumask_t *thd_mask_tx,
-			   odp_cpumask_t *thd_mask_rx,
-			   test_status_t *status)
+static void run_iteration(odp_cpumask_t *thd_mask_tx,
+			  odp_cpumask_t *thd_mask_rx,
+			  uint64_t pps, uint64_t duration_ns,
+			  uint32_t lat_stride)
 {
 	odph_linux_pthread_t thd_tbl[MAX_WORKERS];
 	thread_args_t args_tx, args_rx;
-	uint64_t expected_tx_cnt;
 	int num_tx_workers, num_rx_workers;
 
 	odp_atomic_store_u32(&shutdown, 0);
@@ -611,20 +802,22 @@ static int run_test_single(odp_cpumask_t *thd_mask_tx,
 	memset(gbl_args->rx_stats, 0, gbl_args->rx_stats_size);
 	memset(gbl_args->tx_stats, 0, gbl_args->tx_stats_size);
 
-	expected_tx_cnt = status->pps_curr * gbl_args->args.duration;
-
 	/* start receiver threads first */
-	args_rx.batch_len = gbl_args->args.rx_batch_len;
+	memset(&args_rx, 0, sizeof(args_rx));
+	args_rx.batch_len  = gbl_args->args.rx_batch_len;
+	args_rx.lat_stride = lat_stride;
 	odph_linux_pthread_create(&thd_tbl[0], thd_mask_rx,
 				  run_thread_rx, &args_rx, ODP_THREAD_WORKER);
 	odp_barrier_wait(&gbl_args->rx_barrier);
 	num_rx_workers = odp_cpumask_count(thd_mask_rx);
 
 	/* then start transmitters */
-	num_tx_workers    = odp_cpumask_count(thd_mask_tx);
-	args_tx.pps       = status->pps_curr / num_tx_workers;
-	args_tx.duration  = gbl_args->args.duration;
-	args_tx.batch_len = gbl_args->args.tx_batch_len;
+	memset(&args_tx, 0, sizeof(args_tx));
+	num_tx_workers      = odp_cpumask_count(thd_mask_tx);
+	args_tx.pps         = pps / num_tx_workers;
+	args_tx.duration_ns = duration_ns;
+	args_tx.batch_len   = gbl_args->args.tx_batch_len;
+	args_tx.stamp       = gbl_args->args.rfc2544;
 	odph_linux_pthread_create(&thd_tbl[num_rx_workers], thd_mask_tx,
 				  run_thread_tx, &args_tx, ODP_THREAD_WORKER);
 	odp_barrier_wait(&gbl_args->tx_barrier);
@@ -641,14 +834,137 @@ static int run_test_single(odp_cpumask_t *thd_mask_tx,
 
 	/* wait for receivers */
 	odph_linux_pthread_join(&thd_tbl[0], num_rx_workers);
+}
+
+/*
+ * Run a single instance of the throughput test. When attempting to determine
+ * the maximum packet rate this will be invoked multiple times with the only
+ * difference between runs being the target PPS rate.
+ */
+static int run_test_single(odp_cpumask_t *thd_mask_tx,
+			   odp_cpumask_t *thd_mask_rx,
+			   test_status_t *status)
+{
+	uint64_t expected_tx_cnt;
+	uint32_t lat_stride = 0;
+
+	expected_tx_cnt = status->pps_curr * gbl_args->args.duration;
+
+	/* spread the latency samples over the iteration */
+	if (gbl_args->args.rfc2544)
+		lat_stride = expected_tx_cnt / LAT_SAMPLES + 1;
+
+	run_iteration(thd_mask_tx, thd_mask_rx, status->pps_curr,
+		      gbl_args->args.duration * ODP_TIME_SEC_IN_NS,
+		      lat_stride);
 
 	return process_results(expected_tx_cnt, status);
 }
 
+static void frame_size_str(char *str, int size, unsigned frame_size)
+{
+	if (frame_size == FRAME_SIZE_IMIX)
+		snprintf(str, size, "imix");
+	else
+		snprintf(str, size, "%u", frame_size);
+}
+
+/*
+ * RFC 2544 throughput, loss and latency of each frame size
+ */
+static int run_rfc2544(odp_cpumask_t *thd_mask_tx,
+		       odp_cpumask_t *thd_mask_rx)
+{
+	test_status_t result[MAX_FRAME_SIZES];
+	double frame_avg[MAX_FRAME_SIZES];
+	unsigned len[MAX_PATTERN_LEN];
+	char name[16];
+	int num, i, j;
+	int ret = 0;
+
+	for (i = 0; i < gbl_args->args.num_frame_sizes; ++i) {
+		test_status_t *status = &result[i];
+		unsigned frame_size = gbl_args->args.frame_size[i];
+		int r;
+
+		memset(status, 0, sizeof(*status));
+		status->pps_curr = gbl_args->args.pps;
+
+		if (frame_size == FRAME_SIZE_IMIX) {
+			num = MAX_PATTERN_LEN;
+			frame_avg[i] = 0;
+			for (j = 0; j < num; ++j) {
+				len[j] = imix_pattern[j] - ETH_FCS_LEN;
+				frame_avg[i] += imix_pattern[j];
+			}
+			frame_avg[i] /= num;
+		} else {
+			num = 1;
+			len[0] = frame_size - ETH_FCS_LEN;
+			frame_avg[i] = frame_size;
+		}
+
+		if (create_templates(len, num) != 0) {
+			LOG_ERR("Failed to create test packets\n");
+			return -1;
+		}
+
+		frame_size_str(name, sizeof(name), frame_size);
+		printf("\nFrame size %s\n", name);
+
+		if (gbl_args->args.warmup_ms)
+			run_iteration(thd_mask_tx, thd_mask_rx,
+				      status->pps_curr,
+				      gbl_args->args.warmup_ms *
+				      ODP_TIME_MSEC_IN_NS, 0);
+
+		do {
+			r = run_test_single(thd_mask_tx, thd_mask_rx, status);
+		} while (r > 0);
+
+		free_templates();
+
+		if (r < 0 || status->pps_pass == 0)
+			ret = -1;
+	}
+
+	printf("\nRFC 2544 results:\n");
+	printf("%-6s %13s %10s %8s %10s %10s %10s %10s\n", "frame",
+	       "zero loss pps", "mbps", "loss %", "p50 ns", "p90 ns",
+	       "p99 ns", "max ns");
+	for (i = 0; i < gbl_args->args.num_frame_sizes; ++i) {
+		frame_size_str(name, sizeof(name),
+			       gbl_args->args.frame_size[i]);
+		printf("%-6s %13" PRIu64 " %10.1f %8.3f %10" PRIu64
+		       " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "\n", name,
+		       result[i].pps_pass,
+		       result[i].pps_pass * frame_avg[i] * 8 / 1000000,
+		       result[i].loss_pct, result[i].lat_p50,
+		       result[i].lat_p90, result[i].lat_p99,
+		       result[i].lat_max);
+	}
+
+	printf("\ncsv,frame,pps,mbps,loss_pct,lat_p50_ns,lat_p90_ns,"
+	       "lat_p99_ns,lat_max_ns\n");
+	for (i = 0; i < gbl_args->args.num_frame_sizes; ++i) {
+		frame_size_str(name, sizeof(name),
+			       gbl_args->args.frame_size[i]);
+		printf("csv,%s,%" PRIu64 ",%.1f,%.3f,%" PRIu64 ",%" PRIu64
+		       ",%" PRIu64 ",%" PRIu64 "\n", name, result[i].pps_pass,
+		       result[i].pps_pass * frame_avg[i] * 8 / 1000000,
+		       result[i].loss_pct, result[i].lat_p50,
+		       result[i].lat_p90, result[i].lat_p99,
+		       result[i].lat_max);
+	}
+
+	return ret;
+}
+
 static int run_test(void)
 {
 	int ret = 1;
 	int i;
+	unsigned len;
 	odp_cpumask_t txmask, rxmask;
 	test_status_t status = {
 		.pps_curr = gbl_args->args.pps,
@@ -674,12 +990,57 @@ static int run_test(void)
 		printf("%s ", gbl_args->args.ifaces[i]);
 	printf("\n");
 
+	if (gbl_args->args.rfc2544) {
+		char name[16];
+
+		printf("\tFrame sizes:          \t");
+		for (i = 0; i < gbl_args->args.num_frame_sizes; ++i) {
+			frame_size_str(name, sizeof(name),
+				       gbl_args->args.frame_size[i]);
+			printf("%s ", name);
+		}
+		printf("\n");
+		printf("\tWarm-up (ms):         \t%d\n",
+		       gbl_args->args.warmup_ms);
+
+		return run_rfc2544(&txmask, &rxmask);
+	}
+
+	len = gbl_args->args.pkt_len + PKT_HDR_LEN;
+	if (create_templates(&len, 1) != 0) {
+		LOG_ERR("Failed to create test packet\n");
+		return -1;
+	}
+
 	while (ret > 0)
 		ret = run_test_single(&txmask, &rxmask, &status);
 
+	free_templates();
+
 	return ret;
 }
 
+/*
+ * Length of the longest packet transmitted
+ */
+static uint32_t max_pkt_len(void)
+{
+	uint32_t len = 0;
+	int i;
+
+	if (!gbl_args->args.rfc2544)
+		return PKT_HDR_LEN + gbl_args->args.pkt_len;
+
+	for (i = 0; i < gbl_args->args.num_frame_sizes; ++i) {
+		if (gbl_args->args.frame_size[i] == FRAME_SIZE_IMIX)
+			len = ODPH_ETH_LEN_MAX;
+		else if (gbl_args->args.frame_size[i] - ETH_FCS_LEN > len)
+			len = gbl_args->args.frame_size[i] - ETH_FCS_LEN;
+	}
+
+	return len;
+}
+
 static odp_pktio_t create_pktio(const char *iface, int schedule)
 {
 	odp_pool_t pool;
@@ -689,7 +1050,7 @@ static odp_pktio_t create_pktio(const char *iface, int schedule)
 	odp_pktio_param_t pktio_param;
 
 	odp_pool_param_init(&params);
-	params.pkt.len     = PKT_HDR_LEN + gbl_args->args.pkt_len;
+	params.pkt.len     = max_pkt_len();
 	params.pkt.seg_len = params.pkt.len;
 	params.pkt.num     = PKT_BUF_NUM;
 	params.type        = ODP_POOL_PACKET;
@@ -721,7 +1082,7 @@ static int test_init(void)
 	char inq_name[ODP_QUEUE_NAME_LEN];
 
 	odp_pool_param_init(&params);
-	params.pkt.len     = PKT_HDR_LEN + gbl_args->args.pkt_len;
+	params.pkt.len     = max_pkt_len();
 	params.pkt.seg_len = params.pkt.len;
 	params.pkt.num     = PKT_BUF_NUM;
 	params.type        = ODP_POOL_PACKET;
@@ -881,12 +1242,69 @@ static void usage(void)
 	printf("                         default: 0\n");
 	printf("  -r, --rate <number>    Attempted packet rate in PPS\n");
 	printf("  -i, --interface <list> List of interface names to use\n");
+	printf("                         default: loop, which is lockless and\n");
+	printf("                         gives the upper bound of the pktio\n");
+	printf("                         path (loop[N][:lat=us][:drop=%%]\n");
+	printf("                         [:parse=0|1])\n");
 	printf("  -d, --duration <secs>  Duration of each test iteration\n");
+	printf("  -s, --sizes <list>     RFC 2544 mode: search the zero loss\n");
+	printf("                         rate of each frame size (bytes incl.\n");
+	printf("                         FCS), 'imix' for the 64:594:1518\n");
+	printf("                         7:4:1 mix or 'rfc2544' for the\n");
+	printf("                         standard sizes, e.g. 64,1518,imix\n");
+	printf("  -w, --warmup <ms>      Warm-up time before each frame size\n");
+	printf("                         default: %d\n", WARMUP_DEFAULT_MS);
+	printf("  -a, --accuracy <pps>   Rate search accuracy\n");
+	printf("                         default: %d\n",
+	       RATE_SEARCH_ACCURACY_PPS);
 	printf("  -v, --verbose          Print verbose information\n");
 	printf("  -h, --help             This help\n");
 	printf("\n");
 }
 
+/*
+ * Parse the RFC 2544 frame size list
+ */
+static int parse_frame_sizes(char *str, test_args_t *args)
+{
+	char *token;
+	unsigned i;
+	int size;
+
+	for (token = strtok(str, ","); token != NULL;
+	     token = strtok(NULL, ",")) {
+		if (strcmp(token, "rfc2544") == 0) {
+			for (i = 0; i < sizeof(rfc2544_sizes) /
+			     sizeof(rfc2544_sizes[0]); ++i) {
+				if (args->num_frame_sizes == MAX_FRAME_SIZES)
+					return -1;
+				args->frame_size[args->num_frame_sizes++] =
+					rfc2544_sizes[i];
+			}
+			continue;
+		}
+
+		if (strcmp(token, "imix") == 0) {
+			size = FRAME_SIZE_IMIX;
+		} else {
+			size = atoi(token);
+			if (size < ODPH_ETH_LEN_MIN_CRC ||
+			    size > ODPH_ETH_LEN_MAX_CRC) {
+				LOG_ERR("Frame size %s not in %d..%d\n", token,
+					ODPH_ETH_LEN_MIN_CRC,
+					ODPH_ETH_LEN_MAX_CRC);
+				return -1;
+			}
+		}
+
+		if (args->num_frame_sizes == MAX_FRAME_SIZES)
+			return -1;
+		args->frame_size[args->num_frame_sizes++] = size;
+	}
+
+	return args->num_frame_sizes ? 0 : -1;
+}
+
 static void parse_args(int argc, char *argv[], test_args_t *args)
 {
 	int opt;
@@ -902,6 +1320,9 @@ static void parse_args(int argc, char *argv[], test_args_t *args)
 		{"rate",      required_argument, NULL, 'r'},
 		{"interface", required_argument, NULL, 'i'},
 		{"duration",  required_argument, NULL, 'd'},
+		{"sizes",     required_argument, NULL, 's'},
+		{"warmup",    required_argument, NULL, 'w'},
+		{"accuracy",  required_argument, NULL, 'a'},
 		{"verbose",   no_argument,       NULL, 'v'},
 		{"help",      no_argument,       NULL, 'h'},
 		{NULL, 0, NULL, 0}
@@ -914,11 +1335,14 @@ static void parse_args(int argc, char *argv[], test_args_t *args)
 	args->duration       = 1;
 	args->pps            = RATE_SEARCH_INITIAL_PPS;
 	args->search         = 1;
+	args->accuracy       = RATE_SEARCH_ACCURACY_PPS;
+	args->rfc2544        = 0;
+	args->warmup_ms      = WARMUP_DEFAULT_MS;
 	args->schedule       = 1;
 	args->verbose        = 0;
 
 	while (1) {
-		opt = getopt_long(argc, argv, "+c:t:b:pR:l:r:i:d:vh",
+		opt = getopt_long(argc, argv, "+c:t:b:pR:l:r:i:d:s:w:a:vh",
 				  longopts, &long_index);
 
 		if (opt == -1)
@@ -937,6 +1361,19 @@ static void parse_args(int argc, char *argv[], test_args_t *args)
 		case 'd':
 			args->duration = atoi(optarg);
 			break;
+		case 's':
+			if (parse_frame_sizes(optarg, args) != 0) {
+				usage();
+				exit(EXIT_FAILURE);
+			}
+			args->rfc2544 = 1;
+			break;
+		case 'w':
+			args->warmup_ms = atoi(optarg);
+			break;
+		case 'a':
+			args->accuracy = atoll(optarg);
+			break;
 		case 'r':
 			args->pps     = atoi(optarg);
 			args->search  = 0;
@@ -1029,6 +1466,17 @@ int main(int argc, char **argv)
 
 	memset(gbl_args->tx_stats, 0, gbl_args->tx_stats_size);
 
+	gbl_args->lat_samples_size = max_thrs * LAT_SAMPLES * sizeof(uint32_t);
+
+	shm = odp_shm_reserve("test_globals.lat_samples",
+			      gbl_args->lat_samples_size,
+			      ODP_CACHE_LINE_SIZE, 0);
+
+	gbl_args->lat_samples = odp_shm_addr(shm);
+
+	if (gbl_args->lat_samples == NULL)
+		LOG_ABORT("Shared memory reserve failed.\n");
+
 	parse_args(argc, argv, &gbl_args->args);
 
 	ret = test_init();
@@ -849,6 +849,152 @@ static void classification_test_pmr_queue_set(void)
 	odp_pktio_close(pktio);
 }
 
+#define CLS_VECTOR_PKTS 4
+
+static void classification_test_pmr_vector(void)
+{
+	odp_packet_t pkt;
+	odp_packet_t *tbl;
+	odp_packet_vector_t pktv;
+	odph_udphdr_t *udp;
+	uint32_t seqno[CLS_VECTOR_PKTS];
+	uint32_t num, i;
+	uint16_t val;
+	uint16_t mask;
+	int retval, rx = 0;
+	odp_pktio_t pktio;
+	odp_pool_t pool;
+	odp_pool_t vec_pool;
+	odp_pool_param_t pool_param;
+	odp_queue_t queue;
+	odp_queue_t retqueue;
+	odp_queue_t default_queue;
+	odp_cos_t default_cos;
+	odp_pool_t default_pool;
+	odp_pmr_t pmr;
+	odp_cos_t cos;
+	odp_event_t ev;
+	odp_time_t end;
+	char cosname[ODP_COS_NAME_LEN];
+	odp_pmr_match_t match;
+	odp_cls_cos_param_t cls_param;
+
+	val = CLS_DEFAULT_DPORT;
+	mask = 0xffff;
+
+	pktio = create_pktio(ODP_QUEUE_TYPE_SCHED);
+	CU_ASSERT_FATAL(pktio != ODP_PKTIO_INVALID);
+	retval = create_default_inq(pktio, ODP_QUEUE_TYPE_SCHED);
+	CU_ASSERT(retval == 0);
+
+	match.term = ODP_PMR_UDP_DPORT;
+	match.val = &val;
+	match.mask = &mask;
+	match.val_sz = sizeof(val);
+
+	pmr = odp_pmr_create(&match);
+	CU_ASSERT(pmr != ODP_PMR_INVAL);
+
+	queue = queue_create("udp_vector", true);
+	CU_ASSERT_FATAL(queue != ODP_QUEUE_INVALID);
+
+	pool = pool_create("udp_vector");
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	odp_pool_param_init(&pool_param);
+	pool_param.type         = ODP_POOL_VECTOR;
+	pool_param.vec.num      = 8;
+	pool_param.vec.max_size = 2 * CLS_VECTOR_PKTS;
+	vec_pool = odp_pool_create("udp_vector_vec", &pool_param);
+	CU_ASSERT_FATAL(vec_pool != ODP_POOL_INVALID);
+
+	sprintf(cosname, "udp_vector");
+	odp_cls_cos_param_init(&cls_param);
+	cls_param.pool = pool;
+	cls_param.queue = queue;
+	cls_param.drop_policy = ODP_COS_DROP_POOL;
+
+	/* Vectors need a vector pool */
+	cls_param.vector.enable = 1;
+	cls_param.vector.pool = pool;
+	CU_ASSERT(odp_cls_cos_create(cosname, &cls_param) == ODP_COS_INVALID);
+
+	cls_param.vector.pool = vec_pool;
+	cos = odp_cls_cos_create(cosname, &cls_param);
+	CU_ASSERT_FATAL(cos != ODP_COS_INVALID);
+
+	retval = odp_pktio_pmr_cos(pmr, pktio, cos);
+	CU_ASSERT(retval == 0);
+
+	configure_default_cos(pktio, &default_cos,
+			      &default_queue, &default_pool);
+
+	for (i = 0; i < CLS_VECTOR_PKTS; i++) {
+		pkt = create_packet(pkt_pool, false, &seq, true);
+		CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+		seqno[i] = cls_pkt_get_seq(pkt);
+		CU_ASSERT(seqno[i] != TEST_SEQ_INVALID);
+
+		udp = (odph_udphdr_t *)odp_packet_l4_ptr(pkt, NULL);
+		udp->dst_port = odp_cpu_to_be_16(CLS_DEFAULT_DPORT);
+
+		enqueue_pktio_interface(pkt, pktio);
+	}
+
+	/* Matching packets arrive in vectors of the CoS queue, in order */
+	end = odp_time_sum(odp_time_local(),
+			   odp_time_local_from_ns(ODP_TIME_SEC_IN_NS));
+	while (rx < CLS_VECTOR_PKTS &&
+	       odp_time_cmp(end, odp_time_local()) > 0) {
+		ev = odp_schedule(&retqueue, ODP_SCHED_NO_WAIT);
+		if (ev == ODP_EVENT_INVALID)
+			continue;
+
+		CU_ASSERT(retqueue == queue);
+		CU_ASSERT_FATAL(odp_event_type(ev) ==
+				ODP_EVENT_PACKET_VECTOR);
+		pktv = odp_packet_vector_from_event(ev);
+
+		num = odp_packet_vector_tbl(pktv, &tbl);
+		CU_ASSERT(num > 0);
+		for (i = 0; i < num && rx < CLS_VECTOR_PKTS; i++) {
+			CU_ASSERT(odp_packet_pool(tbl[i]) == pool);
+			CU_ASSERT(cls_pkt_get_seq(tbl[i]) == seqno[rx]);
+			rx++;
+		}
+
+		odp_event_free(ev);
+	}
+	CU_ASSERT(rx == CLS_VECTOR_PKTS);
+
+	/* Default CoS still delivers packets */
+	pkt = create_packet(pkt_pool, false, &seq, true);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	seqno[0] = cls_pkt_get_seq(pkt);
+
+	udp = (odph_udphdr_t *)odp_packet_l4_ptr(pkt, NULL);
+	udp->dst_port = odp_cpu_to_be_16(CLS_DEFAULT_DPORT + 1);
+
+	enqueue_pktio_interface(pkt, pktio);
+
+	pkt = receive_packet(&retqueue, ODP_TIME_SEC_IN_NS);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+	CU_ASSERT(seqno[0] == cls_pkt_get_seq(pkt));
+	CU_ASSERT(retqueue == default_queue);
+
+	odp_packet_free(pkt);
+	odp_cos_destroy(cos);
+	odp_cos_destroy(default_cos);
+	odp_pmr_destroy(pmr);
+	destroy_inq(pktio);
+	odp_queue_destroy(queue);
+	odp_queue_destroy(default_queue);
+	odp_pool_destroy(default_pool);
+	odp_pool_destroy(pool);
+	odp_pool_destroy(vec_pool);
+	odp_pktio_close(pktio);
+}
+
 odp_testinfo_t classification_suite_pmr[] = {
 	ODP_TEST_INFO(classification_test_pmr_term_tcp_dport),
 	ODP_TEST_INFO(classification_test_pmr_term_tcp_sport),
@@ -857,5 +1003,6 @@ odp_testinfo_t classification_suite_pmr[] = {
 	ODP_TEST_INFO(classification_test_pmr_term_ipproto),
 	ODP_TEST_INFO(classification_test_pmr_pool_set),
 	ODP_TEST_INFO(classification_test_pmr_queue_set),
+	ODP_TEST_INFO(classification_test_pmr_vector),
 	ODP_TEST_INFO_NULL,
 };
@@ -856,6 +856,79 @@ void packet_test_offset(void)
 	CU_ASSERT_PTR_NOT_NULL(ptr);
 }
 
+void packet_test_vector(void)
+{
+	odp_pool_t pool;
+	odp_pool_param_t params;
+	odp_packet_vector_t pktv, pktv2;
+	odp_packet_t *tbl;
+	odp_event_t ev;
+	uint32_t i;
+	const uint32_t max_size = 64;
+	const uint32_t num = 4;
+
+	memset(&params, 0, sizeof(params));
+	params.type         = ODP_POOL_VECTOR;
+	params.vec.num      = 2;
+	params.vec.max_size = max_size;
+
+	pool = odp_pool_create("packet_vector_pool", &params);
+	CU_ASSERT_FATAL(pool != ODP_POOL_INVALID);
+
+	pktv = odp_packet_vector_alloc(pool);
+	CU_ASSERT_FATAL(pktv != ODP_PACKET_VECTOR_INVALID);
+	CU_ASSERT(odp_packet_vector_to_u64(pktv) !=
+		  odp_packet_vector_to_u64(ODP_PACKET_VECTOR_INVALID));
+	CU_ASSERT(odp_packet_vector_pool(pktv) == pool);
+	CU_ASSERT(odp_packet_vector_size(pktv) == 0);
+
+	ev = odp_packet_vector_to_event(pktv);
+	CU_ASSERT(odp_event_type(ev) == ODP_EVENT_PACKET_VECTOR);
+	CU_ASSERT(odp_packet_vector_from_event(ev) == pktv);
+
+	/* Packet vectors are not packets */
+	CU_ASSERT(odp_packet_alloc(pool, packet_len) == ODP_PACKET_INVALID);
+
+	CU_ASSERT(odp_packet_vector_tbl(pktv, &tbl) == 0);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(tbl);
+	for (i = 0; i < num; i++) {
+		tbl[i] = odp_packet_alloc(packet_pool, packet_len);
+		CU_ASSERT_FATAL(tbl[i] != ODP_PACKET_INVALID);
+	}
+
+	/* The whole table is writable */
+	tbl[max_size - 1] = ODP_PACKET_INVALID;
+
+	odp_packet_vector_size_set(pktv, num);
+	CU_ASSERT(odp_packet_vector_size(pktv) == num);
+	CU_ASSERT(odp_packet_vector_tbl(pktv, &tbl) == num);
+	for (i = 0; i < num; i++)
+		CU_ASSERT(odp_packet_len(tbl[i]) == packet_len);
+
+	/* Pool is exhausted after the second vector */
+	pktv2 = odp_packet_vector_alloc(pool);
+	CU_ASSERT_FATAL(pktv2 != ODP_PACKET_VECTOR_INVALID);
+	CU_ASSERT(odp_packet_vector_alloc(pool) == ODP_PACKET_VECTOR_INVALID);
+
+	/* Vector free leaves the packets to the application */
+	odp_packet_vector_size_set(pktv2, 1);
+	odp_packet_vector_tbl(pktv2, &tbl);
+	tbl[0] = odp_packet_alloc(packet_pool, packet_len);
+	CU_ASSERT_FATAL(tbl[0] != ODP_PACKET_INVALID);
+	odp_packet_free(tbl[0]);
+	odp_packet_vector_free(pktv2);
+
+	/* Event free releases the vector and its packets */
+	odp_event_free(ev);
+
+	pktv = odp_packet_vector_alloc(pool);
+	CU_ASSERT_FATAL(pktv != ODP_PACKET_VECTOR_INVALID);
+	CU_ASSERT(odp_packet_vector_size(pktv) == 0);
+	odp_packet_vector_free(pktv);
+
+	CU_ASSERT(odp_pool_destroy(pool) == 0);
+}
+
 odp_testinfo_t packet_suite[] = {
 	ODP_TEST_INFO(packet_test_alloc_free),
 	ODP_TEST_INFO(packet_test_alloc_free_multi),
@@ -876,6 +949,7 @@ odp_testinfo_t packet_suite[] = {
 	ODP_TEST_INFO(packet_test_copy),
 	ODP_TEST_INFO(packet_test_copydata),
 	ODP_TEST_INFO(packet_test_offset),
+	ODP_TEST_INFO(packet_test_vector),
 	ODP_TEST_INFO_NULL,
 };
 
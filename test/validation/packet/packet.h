@@ -29,6 +29,7 @@ void packet_test_add_rem_data(void);
 void packet_test_copy(void);
 void packet_test_copydata(void);
 void packet_test_offset(void);
+void packet_test_vector(void);
 
 /* test arrays: */
 extern odp_testinfo_t packet_suite[];
@@ -1111,6 +1111,248 @@ void pktio_test_send_on_ronly(void)
 	CU_ASSERT_FATAL(ret == 0);
 }
 
+static void test_parse_level(odp_pktio_parse_level_t level)
+{
+	pktio_info_t pktios[MAX_NUM_IFACES];
+	odp_pktio_param_t pktio_param;
+	odp_packet_t pkt;
+	uint32_t seq;
+	int i, if_b;
+
+	odp_pktio_param_init(&pktio_param);
+	pktio_param.in_mode = ODP_PKTIN_MODE_RECV;
+	pktio_param.parse_level = level;
+
+	for (i = 0; i < num_ifaces; ++i) {
+		pktios[i].id = odp_pktio_open(iface_name[i], pool[i],
+					      &pktio_param);
+		CU_ASSERT_FATAL(pktios[i].id != ODP_PKTIO_INVALID);
+		pktios[i].in_mode = ODP_PKTIN_MODE_RECV;
+		CU_ASSERT_FATAL(odp_pktio_start(pktios[i].id) == 0);
+	}
+
+	if_b = (num_ifaces == 1) ? 0 : 1;
+
+	pkt = odp_packet_alloc(default_pkt_pool, packet_len);
+	CU_ASSERT_FATAL(pkt != ODP_PACKET_INVALID);
+
+	seq = pktio_init_packet(pkt);
+	pktio_pkt_set_macs(pkt, pktios[0].id, pktios[if_b].id);
+	CU_ASSERT(pktio_fixup_checksums(pkt) == 0);
+
+	if (odp_pktio_send(pktios[0].id, &pkt, 1) != 1) {
+		CU_FAIL("failed to send test packet");
+		odp_packet_free(pkt);
+		pkt = ODP_PACKET_INVALID;
+	} else {
+		pkt = wait_for_packet(&pktios[if_b], seq, ODP_TIME_SEC_IN_NS);
+	}
+
+	/* Layers above the parse level are parsed on first access */
+	if (pkt != ODP_PACKET_INVALID) {
+		CU_ASSERT(odp_packet_has_eth(pkt));
+		CU_ASSERT(odp_packet_has_ipv4(pkt));
+		CU_ASSERT(odp_packet_l3_offset(pkt) == ODPH_ETHHDR_LEN);
+		CU_ASSERT(odp_packet_has_udp(pkt));
+		CU_ASSERT(odp_packet_l4_offset(pkt) ==
+			  ODPH_ETHHDR_LEN + ODPH_IPV4HDR_LEN);
+		CU_ASSERT(odp_packet_has_error(pkt) == 0);
+		odp_packet_free(pkt);
+	}
+
+	for (i = 0; i < num_ifaces; ++i) {
+		CU_ASSERT(odp_pktio_stop(pktios[i].id) == 0);
+		CU_ASSERT(odp_pktio_close(pktios[i].id) == 0);
+	}
+}
+
+void pktio_test_parse_level(void)
+{
+	test_parse_level(ODP_PKTIO_PARSE_NONE);
+	test_parse_level(ODP_PKTIO_PARSE_L2);
+	test_parse_level(ODP_PKTIO_PARSE_L3);
+	test_parse_level(ODP_PKTIO_PARSE_ALL);
+}
+
+void pktio_test_sched_vector(void)
+{
+	pktio_info_t pktios[MAX_NUM_IFACES];
+	odp_pktio_param_t pktio_param;
+	odp_pool_param_t params;
+	odp_pool_t vec_pool;
+	odp_packet_t pkt_tbl[TX_BATCH_LEN];
+	odp_packet_t *vec_tbl;
+	odp_packet_vector_t pktv;
+	odp_event_t ev;
+	odp_time_t end;
+	uint32_t seq[TX_BATCH_LEN];
+	uint32_t num, j;
+	int i, if_b, rx = 0;
+
+	memset(&params, 0, sizeof(params));
+	params.type         = ODP_POOL_VECTOR;
+	params.vec.num      = 16;
+	params.vec.max_size = 2 * TX_BATCH_LEN;
+	vec_pool = odp_pool_create("pktio_vector_pool", &params);
+	CU_ASSERT_FATAL(vec_pool != ODP_POOL_INVALID);
+
+	odp_pktio_param_init(&pktio_param);
+	pktio_param.in_mode = ODP_PKTIN_MODE_SCHED;
+	pktio_param.in_vector.enable = 1;
+	pktio_param.in_vector.pool   = vec_pool;
+
+	for (i = 0; i < num_ifaces; ++i) {
+		pktios[i].id = odp_pktio_open(iface_name[i], pool[i],
+					      &pktio_param);
+		CU_ASSERT_FATAL(pktios[i].id != ODP_PKTIO_INVALID);
+		pktios[i].in_mode = ODP_PKTIN_MODE_SCHED;
+		CU_ASSERT_FATAL(create_inq(pktios[i].id,
+					   ODP_QUEUE_TYPE_SCHED) == 0);
+		CU_ASSERT_FATAL(odp_pktio_start(pktios[i].id) == 0);
+	}
+
+	if_b = (num_ifaces == 1) ? 0 : 1;
+
+	for (i = 0; i < TX_BATCH_LEN; ++i) {
+		pkt_tbl[i] = odp_packet_alloc(default_pkt_pool, packet_len);
+		CU_ASSERT_FATAL(pkt_tbl[i] != ODP_PACKET_INVALID);
+		seq[i] = pktio_init_packet(pkt_tbl[i]);
+		pktio_pkt_set_macs(pkt_tbl[i], pktios[0].id, pktios[if_b].id);
+		CU_ASSERT(pktio_fixup_checksums(pkt_tbl[i]) == 0);
+	}
+
+	CU_ASSERT(odp_pktio_send(pktios[0].id, pkt_tbl, TX_BATCH_LEN) ==
+		  TX_BATCH_LEN);
+
+	/* Packets arrive in vectors, in order */
+	end = odp_time_sum(odp_time_local(),
+			   odp_time_local_from_ns(ODP_TIME_SEC_IN_NS));
+	while (rx < TX_BATCH_LEN && odp_time_cmp(end, odp_time_local()) > 0) {
+		ev = odp_schedule(NULL, ODP_SCHED_NO_WAIT);
+		if (ev == ODP_EVENT_INVALID)
+			continue;
+
+		CU_ASSERT_FATAL(odp_event_type(ev) ==
+				ODP_EVENT_PACKET_VECTOR);
+		pktv = odp_packet_vector_from_event(ev);
+		CU_ASSERT(odp_packet_vector_pool(pktv) == vec_pool);
+
+		num = odp_packet_vector_tbl(pktv, &vec_tbl);
+		CU_ASSERT(num > 0);
+		CU_ASSERT(num <= params.vec.max_size);
+
+		for (j = 0; j < num; j++) {
+			if (pktio_pkt_seq(vec_tbl[j]) != seq[rx])
+				continue;
+
+			CU_ASSERT(odp_packet_input(vec_tbl[j]) ==
+				  pktios[if_b].id);
+			if (++rx == TX_BATCH_LEN)
+				break;
+		}
+
+		odp_event_free(ev);
+	}
+
+	CU_ASSERT(rx == TX_BATCH_LEN);
+
+	for (i = 0; i < num_ifaces; ++i) {
+		CU_ASSERT(odp_pktio_stop(pktios[i].id) == 0);
+		destroy_inq(pktios[i].id);
+		CU_ASSERT(odp_pktio_close(pktios[i].id) == 0);
+	}
+
+	CU_ASSERT(odp_pool_destroy(vec_pool) == 0);
+}
+
+void pktio_test_statistics_counters(void)
+{
+	pktio_info_t pktios[MAX_NUM_IFACES];
+	odp_pktio_stats_t stats[MAX_NUM_IFACES];
+	odp_pktio_queue_stats_t qstats;
+	odp_packet_t tx_pkt[TX_BATCH_LEN];
+	uint32_t tx_seq[TX_BATCH_LEN];
+	odp_packet_t pkt;
+	uint64_t tx_packets, tx_octets;
+	int i, q, num_queues, if_b, sent;
+
+	for (i = 0; i < num_ifaces; ++i) {
+		pktios[i].id = create_pktio(i, ODP_PKTIN_MODE_RECV,
+					    ODP_PKTOUT_MODE_SEND);
+		CU_ASSERT_FATAL(pktios[i].id != ODP_PKTIO_INVALID);
+		pktios[i].in_mode = ODP_PKTIN_MODE_RECV;
+		CU_ASSERT_FATAL(odp_pktio_start(pktios[i].id) == 0);
+	}
+
+	if_b = (num_ifaces == 1) ? 0 : 1;
+
+	for (i = 0; i < num_ifaces; ++i) {
+		CU_ASSERT(odp_pktio_stats_reset(pktios[i].id) == 0);
+		CU_ASSERT(odp_pktio_stats(pktios[i].id, &stats[i]) == 0);
+		CU_ASSERT(stats[i].out_packets == 0);
+		CU_ASSERT(stats[i].out_octets == 0);
+	}
+
+	for (i = 0; i < TX_BATCH_LEN; ++i) {
+		tx_pkt[i] = odp_packet_alloc(default_pkt_pool, packet_len);
+		CU_ASSERT_FATAL(tx_pkt[i] != ODP_PACKET_INVALID);
+		tx_seq[i] = pktio_init_packet(tx_pkt[i]);
+		pktio_pkt_set_macs(tx_pkt[i], pktios[0].id, pktios[if_b].id);
+		CU_ASSERT(pktio_fixup_checksums(tx_pkt[i]) == 0);
+	}
+
+	sent = odp_pktio_send(pktios[0].id, tx_pkt, TX_BATCH_LEN);
+	CU_ASSERT(sent == TX_BATCH_LEN);
+	if (sent < 0)
+		sent = 0;
+	for (i = sent; i < TX_BATCH_LEN; ++i)
+		odp_packet_free(tx_pkt[i]);
+
+	for (i = 0; i < sent; ++i) {
+		pkt = wait_for_packet(&pktios[if_b], tx_seq[i],
+				      ODP_TIME_SEC_IN_NS);
+		if (pkt == ODP_PACKET_INVALID)
+			break;
+		odp_packet_free(pkt);
+	}
+
+	for (i = 0; i < num_ifaces; ++i)
+		CU_ASSERT(odp_pktio_stats(pktios[i].id, &stats[i]) == 0);
+
+	CU_ASSERT(stats[0].out_packets == (uint64_t)sent);
+	CU_ASSERT(stats[0].out_octets == (uint64_t)sent * packet_len);
+	CU_ASSERT(stats[0].out_errors == 0);
+	/* Other traffic may be received on real interfaces */
+	CU_ASSERT(stats[if_b].in_packets >= (uint64_t)sent);
+	CU_ASSERT(stats[if_b].in_octets >= (uint64_t)sent * packet_len);
+
+	/* Queue counters add up to the interface counters */
+	num_queues = odp_pktio_stats_num_queues(pktios[0].id);
+	CU_ASSERT_FATAL(num_queues > 0);
+	tx_packets = 0;
+	tx_octets = 0;
+	for (q = 0; q < num_queues; ++q) {
+		CU_ASSERT(odp_pktio_queue_stats(pktios[0].id, q,
+						&qstats) == 0);
+		tx_packets += qstats.out_packets;
+		tx_octets += qstats.out_octets;
+	}
+	CU_ASSERT(tx_packets == (uint64_t)sent);
+	CU_ASSERT(tx_octets == (uint64_t)sent * packet_len);
+	CU_ASSERT(odp_pktio_queue_stats(pktios[0].id, num_queues,
+					&qstats) < 0);
+
+	CU_ASSERT(odp_pktio_stats_reset(pktios[0].id) == 0);
+	CU_ASSERT(odp_pktio_stats(pktios[0].id, &stats[0]) == 0);
+	CU_ASSERT(stats[0].out_packets == 0);
+	CU_ASSERT(stats[0].out_octets == 0);
+
+	for (i = 0; i < num_ifaces; ++i) {
+		CU_ASSERT(odp_pktio_stop(pktios[i].id) == 0);
+		CU_ASSERT(odp_pktio_close(pktios[i].id) == 0);
+	}
+}
+
 static int create_pool(const char *iface, int num)
 {
 	char pool_name[ODP_POOL_NAME_LEN];
@@ -1233,6 +1475,9 @@ odp_testinfo_t pktio_suite_unsegmented[] = {
 	ODP_TEST_INFO(pktio_test_start_stop),
 	ODP_TEST_INFO(pktio_test_recv_on_wonly),
 	ODP_TEST_INFO(pktio_test_send_on_ronly),
+	ODP_TEST_INFO(pktio_test_parse_level),
+	ODP_TEST_INFO(pktio_test_sched_vector),
+	ODP_TEST_INFO(pktio_test_statistics_counters),
 	ODP_TEST_INFO_NULL
 };
 
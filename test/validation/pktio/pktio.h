@@ -29,6 +29,9 @@ int pktio_check_send_failure(void);
 void pktio_test_send_failure(void);
 void pktio_test_recv_on_wonly(void);
 void pktio_test_send_on_ronly(void);
+void pktio_test_parse_level(void);
+void pktio_test_sched_vector(void);
+void pktio_test_statistics_counters(void);
 
 /* test arrays: */
 extern odp_testinfo_t pktio_suite[];
@@ -76,8 +76,51 @@ void shmem_test_odp_shm_sunnyday(void)
 	odp_cunit_thread_exit(&thrdarg);
 }
 
+/* Placement requests are met or fall back, never fail */
+void shmem_test_odp_shm_placement(void)
+{
+	static const uint32_t flags[] = {
+		ODP_SHM_PAGE_4K | ODP_SHM_PREFAULT,
+		ODP_SHM_PAGE_2M | ODP_SHM_NUMA_LOCAL | ODP_SHM_PREFAULT,
+		ODP_SHM_PAGE_1G | ODP_SHM_NODE(0),
+	};
+	odp_shm_info_t info;
+	odp_shm_t shm;
+	uint64_t size = 4 * 1024 * 1024;
+	uint8_t *data;
+	unsigned i;
+
+	CU_ASSERT(ODP_SHM_NODE_GET(ODP_SHM_NODE(3)) == 3);
+
+	for (i = 0; i < sizeof(flags) / sizeof(flags[0]); i++) {
+		shm = odp_shm_reserve("cunit_test_placement", size,
+				      ALIGE_SIZE, flags[i]);
+		CU_ASSERT_FATAL(ODP_SHM_INVALID != shm);
+
+		data = odp_shm_addr(shm);
+		CU_ASSERT_FATAL(NULL != data);
+		data[0] = 1;
+		data[size - 1] = 1;
+
+		CU_ASSERT(0 == odp_shm_info(shm, &info));
+		CU_ASSERT(flags[i] == info.flags);
+		CU_ASSERT(size <= info.size);
+		CU_ASSERT(info.page_size >= odp_sys_page_size());
+
+		if (flags[i] & ODP_SHM_PAGE_4K)
+			CU_ASSERT(odp_sys_page_size() == info.page_size);
+		if (flags[i] & ODP_SHM_PAGE_2M)
+			CU_ASSERT(info.page_size <= 2 * 1024 * 1024);
+
+		odp_shm_print_all();
+
+		CU_ASSERT(0 == odp_shm_free(shm));
+	}
+}
+
 odp_testinfo_t shmem_suite[] = {
 	ODP_TEST_INFO(shmem_test_odp_shm_sunnyday),
+	ODP_TEST_INFO(shmem_test_odp_shm_placement),
 	ODP_TEST_INFO_NULL,
 };
 
@@ -11,6 +11,7 @@
 
 /* test functions: */
 void shmem_test_odp_shm_sunnyday(void);
+void shmem_test_odp_shm_placement(void);
 
 /* test arrays: */
 extern odp_testinfo_t shmem_suite[];
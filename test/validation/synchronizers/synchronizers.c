@@ -8,6 +8,7 @@
 #include <odp.h>
 #include <CUnit/Basic.h>
 #include <odp_cunit_common.h>
+#include <odp/helper/linux.h>
 #include <unistd.h>
 #include "synchronizers.h"
 
@@ -35,6 +36,17 @@
 
 #define GLOBAL_SHM_NAME		"GlobalLockTest"
 
+#define BENCH_MAX_THREADS	64
+#ifdef MAGIC_SCALL
+#define BENCH_ITERATIONS	1000
+#else
+#define BENCH_ITERATIONS	20000
+#endif
+#define BENCH_WRITE_RATIO	4	/* rw locks: one write per N ops */
+
+#define RCU_NUM_OBJS		16
+#define RCU_MAGIC		0x52435531
+
 #define UNUSED			__attribute__((__unused__))
 
 static odp_atomic_u32_t a32u;
@@ -49,6 +61,11 @@ typedef struct {
 	odp_atomic_u32_t wait_cnt;
 } custom_barrier_t;
 
+typedef struct {
+	volatile_u32_t magic;	/* RCU_MAGIC while readable */
+	volatile_u32_t in_use;	/* published or waiting to be freed */
+} rcu_obj_t;
+
 typedef struct {
 	/* Global variables */
 	uint32_t g_num_threads;
@@ -73,8 +90,23 @@ typedef struct {
 	odp_ticketlock_t global_ticketlock;
 	odp_rwlock_t global_rwlock;
 	odp_rwlock_recursive_t global_recursive_rwlock;
+	odp_mcslock_t global_mcslock;
+	odp_pflock_t global_pflock;
 
 	volatile_u32_t global_lock_owner;
+
+	/* Lock contention benchmark */
+	uint32_t bench_lock;
+	odp_barrier_t bench_barrier;
+	odp_atomic_u32_t bench_idx;
+	volatile_u64_t bench_counter;
+	uint64_t bench_ns[BENCH_MAX_THREADS];
+
+	/* RCU */
+	rcu_obj_t rcu_obj[RCU_NUM_OBJS];
+	rcu_obj_t * volatile rcu_ptr;
+	odp_atomic_u32_t rcu_writer;
+	volatile_u32_t rcu_done;
 } global_shared_mem_t;
 
 /* Per-thread memory */
@@ -89,6 +121,8 @@ typedef struct {
 	odp_ticketlock_t per_thread_ticketlock;
 	odp_rwlock_t per_thread_rwlock;
 	odp_rwlock_recursive_t per_thread_recursive_rwlock;
+	odp_mcslock_t per_thread_mcslock;
+	odp_pflock_t per_thread_pflock;
 
 	volatile_u64_t delay_counter;
 } per_thread_mem_t;
@@ -489,6 +523,85 @@ static void *rwlock_recursive_api_tests(void *arg UNUSED)
 	return NULL;
 }
 
+static void mcslock_api_test(odp_mcslock_t *mcslock)
+{
+	odp_mcslock_node_t node, other;
+
+	odp_mcslock_init(mcslock);
+	CU_ASSERT(odp_mcslock_is_locked(mcslock) == 0);
+
+	odp_mcslock_lock(mcslock, &node);
+	CU_ASSERT(odp_mcslock_is_locked(mcslock) == 1);
+
+	odp_mcslock_unlock(mcslock, &node);
+	CU_ASSERT(odp_mcslock_is_locked(mcslock) == 0);
+
+	CU_ASSERT(odp_mcslock_trylock(mcslock, &node) == 1);
+	CU_ASSERT(odp_mcslock_trylock(mcslock, &other) == 0);
+	CU_ASSERT(odp_mcslock_is_locked(mcslock) == 1);
+
+	odp_mcslock_unlock(mcslock, &node);
+	CU_ASSERT(odp_mcslock_is_locked(mcslock) == 0);
+}
+
+static void *mcslock_api_tests(void *arg UNUSED)
+{
+	global_shared_mem_t *global_mem;
+	per_thread_mem_t *per_thread_mem;
+	odp_mcslock_t local_mcslock;
+
+	per_thread_mem = thread_init();
+	global_mem = per_thread_mem->global_mem;
+
+	odp_barrier_wait(&global_mem->global_barrier);
+
+	mcslock_api_test(&local_mcslock);
+	mcslock_api_test(&per_thread_mem->per_thread_mcslock);
+
+	thread_finalize(per_thread_mem);
+
+	return NULL;
+}
+
+static void pflock_api_test(odp_pflock_t *pflock)
+{
+	odp_pflock_init(pflock);
+
+	odp_pflock_read_lock(pflock);
+	odp_pflock_read_lock(pflock);
+	odp_pflock_read_unlock(pflock);
+	odp_pflock_read_unlock(pflock);
+
+	odp_pflock_write_lock(pflock);
+	odp_pflock_write_unlock(pflock);
+
+	/* Second writer runs in the other phase */
+	odp_pflock_write_lock(pflock);
+	odp_pflock_write_unlock(pflock);
+
+	odp_pflock_read_lock(pflock);
+	odp_pflock_read_unlock(pflock);
+}
+
+static void *pflock_api_tests(void *arg UNUSED)
+{
+	global_shared_mem_t *global_mem;
+	per_thread_mem_t *per_thread_mem;
+	odp_pflock_t local_pflock;
+
+	per_thread_mem = thread_init();
+	global_mem = per_thread_mem->global_mem;
+
+	odp_barrier_wait(&global_mem->global_barrier);
+
+	pflock_api_test(&local_pflock);
+	pflock_api_test(&per_thread_mem->per_thread_pflock);
+
+	thread_finalize(per_thread_mem);
+
+	return NULL;
+}
+
 static void *no_lock_functional_test(void *arg UNUSED)
 {
 	global_shared_mem_t *global_mem;
@@ -1063,6 +1176,456 @@ static void *rwlock_recursive_functional_test(void *arg UNUSED)
 	return NULL;
 }
 
+static void *mcslock_functional_test(void *arg UNUSED)
+{
+	global_shared_mem_t *global_mem;
+	per_thread_mem_t *per_thread_mem;
+	uint32_t thread_num, resync_cnt, rs_idx, iterations, cnt;
+	uint32_t sync_failures, is_locked_errs, current_errs;
+	uint32_t lock_owner_delay;
+	odp_mcslock_node_t node;
+
+	thread_num = odp_thread_id();
+	per_thread_mem = thread_init();
+	global_mem = per_thread_mem->global_mem;
+	iterations = global_mem->g_iterations;
+
+	/* Wait here until all of the threads have also reached this point */
+	odp_barrier_wait(&global_mem->global_barrier);
+
+	sync_failures = 0;
+	is_locked_errs = 0;
+	current_errs = 0;
+	rs_idx = 0;
+	resync_cnt = iterations / NUM_RESYNC_BARRIERS;
+	lock_owner_delay = BASE_DELAY;
+
+	for (cnt = 1; cnt <= iterations; cnt++) {
+		/* Acquire the shared global lock */
+		odp_mcslock_lock(&global_mem->global_mcslock, &node);
+
+		/* Make sure we have the lock AND didn't previously own it */
+		if (odp_mcslock_is_locked(&global_mem->global_mcslock) != 1)
+			is_locked_errs++;
+
+		if (global_mem->global_lock_owner != 0) {
+			current_errs++;
+			sync_failures++;
+		}
+
+		/* Now set the global_lock_owner to be us, wait a while, and
+		* then we see if anyone else has snuck in and changed the
+		* global_lock_owner to be themselves
+		*/
+		global_mem->global_lock_owner = thread_num;
+		odp_mb_full();
+		thread_delay(per_thread_mem, lock_owner_delay);
+		if (global_mem->global_lock_owner != thread_num) {
+			current_errs++;
+			sync_failures++;
+		}
+
+		/* Release shared lock, and make sure we no longer have it */
+		global_mem->global_lock_owner = 0;
+		odp_mb_full();
+		odp_mcslock_unlock(&global_mem->global_mcslock, &node);
+		if (global_mem->global_lock_owner == thread_num) {
+			current_errs++;
+			sync_failures++;
+		}
+
+		if (current_errs == 0)
+			lock_owner_delay++;
+
+		/* Wait a small amount of time and then rerun the test */
+		thread_delay(per_thread_mem, BASE_DELAY);
+
+		/* Try to resync all of the threads to increase contention */
+		if ((rs_idx < NUM_RESYNC_BARRIERS) &&
+		    ((cnt % resync_cnt) == (resync_cnt - 1)))
+			odp_barrier_wait(&global_mem->barrier_array[rs_idx++]);
+	}
+
+	if ((global_mem->g_verbose) &&
+	    ((sync_failures != 0) || (is_locked_errs != 0)))
+		printf("\nThread %" PRIu32 " (id=%d core=%d) had %" PRIu32
+		       " sync_failures and %" PRIu32
+		       " is_locked_errs in %" PRIu32 " iterations\n",
+		       thread_num,
+		       per_thread_mem->thread_id, per_thread_mem->thread_core,
+		       sync_failures, is_locked_errs, iterations);
+
+	CU_ASSERT(sync_failures == 0);
+	CU_ASSERT(is_locked_errs == 0);
+
+	thread_finalize(per_thread_mem);
+
+	return NULL;
+}
+
+static void *pflock_functional_test(void *arg UNUSED)
+{
+	global_shared_mem_t *global_mem;
+	per_thread_mem_t *per_thread_mem;
+	uint32_t thread_num, resync_cnt, rs_idx, iterations, cnt;
+	uint32_t sync_failures, current_errs, lock_owner_delay;
+
+	thread_num = odp_thread_id();
+	per_thread_mem = thread_init();
+	global_mem = per_thread_mem->global_mem;
+	iterations = global_mem->g_iterations;
+
+	/* Wait here until all of the threads have also reached this point */
+	odp_barrier_wait(&global_mem->global_barrier);
+
+	sync_failures = 0;
+	current_errs = 0;
+	rs_idx = 0;
+	resync_cnt = iterations / NUM_RESYNC_BARRIERS;
+	lock_owner_delay = BASE_DELAY;
+
+	for (cnt = 1; cnt <= iterations; cnt++) {
+		/* Verify that we can obtain a read lock */
+		odp_pflock_read_lock(&global_mem->global_pflock);
+
+		/* Verify lock is unowned (no writer holds it) */
+		thread_delay(per_thread_mem, lock_owner_delay);
+		if (global_mem->global_lock_owner != 0) {
+			current_errs++;
+			sync_failures++;
+		}
+
+		/* Release the read lock */
+		odp_pflock_read_unlock(&global_mem->global_pflock);
+
+		/* Acquire the shared global lock */
+		odp_pflock_write_lock(&global_mem->global_pflock);
+
+		/* Make sure we have lock now AND didn't previously own it */
+		if (global_mem->global_lock_owner != 0) {
+			current_errs++;
+			sync_failures++;
+		}
+
+		/* Now set the global_lock_owner to be us, wait a while, and
+		* then we see if anyone else has snuck in and changed the
+		* global_lock_owner to be themselves
+		*/
+		global_mem->global_lock_owner = thread_num;
+		odp_mb_full();
+		thread_delay(per_thread_mem, lock_owner_delay);
+		if (global_mem->global_lock_owner != thread_num) {
+			current_errs++;
+			sync_failures++;
+		}
+
+		/* Release shared lock, and make sure we no longer have it */
+		global_mem->global_lock_owner = 0;
+		odp_mb_full();
+		odp_pflock_write_unlock(&global_mem->global_pflock);
+		if (global_mem->global_lock_owner == thread_num) {
+			current_errs++;
+			sync_failures++;
+		}
+
+		if (current_errs == 0)
+			lock_owner_delay++;
+
+		/* Wait a small amount of time and then rerun the test */
+		thread_delay(per_thread_mem, BASE_DELAY);
+
+		/* Try to resync all of the threads to increase contention */
+		if ((rs_idx < NUM_RESYNC_BARRIERS) &&
+		    ((cnt % resync_cnt) == (resync_cnt - 1)))
+			odp_barrier_wait(&global_mem->barrier_array[rs_idx++]);
+	}
+
+	if ((global_mem->g_verbose) && (sync_failures != 0))
+		printf("\nThread %" PRIu32 " (id=%d core=%d) had %" PRIu32
+		       " sync_failures in %" PRIu32 " iterations\n", thread_num,
+		       per_thread_mem->thread_id,
+		       per_thread_mem->thread_core,
+		       sync_failures, iterations);
+
+	CU_ASSERT(sync_failures == 0);
+
+	thread_finalize(per_thread_mem);
+
+	return NULL;
+}
+
+static void rcu_defer_count(void *arg)
+{
+	(*(uint32_t *)arg)++;
+}
+
+static void *rcu_api_tests(void *arg UNUSED)
+{
+	global_shared_mem_t *global_mem;
+	per_thread_mem_t *per_thread_mem;
+	uint32_t calls = 0;
+	int i;
+
+	per_thread_mem = thread_init();
+	global_mem = per_thread_mem->global_mem;
+
+	odp_barrier_wait(&global_mem->global_barrier);
+
+	odp_rcu_thread_online();
+	odp_rcu_quiescent();
+	odp_rcu_quiescent();
+
+	/* Offline threads are not waited for */
+	odp_rcu_thread_offline();
+	odp_rcu_synchronize();
+
+	for (i = 0; i < 3; i++)
+		CU_ASSERT(odp_rcu_defer(rcu_defer_count, &calls) == 0);
+
+	odp_rcu_barrier();
+	CU_ASSERT(calls == 3);
+
+	odp_rcu_barrier();
+	CU_ASSERT(calls == 3);
+
+	odp_rcu_thread_online();
+	odp_rcu_thread_offline();
+
+	odp_barrier_wait(&global_mem->global_barrier);
+
+	thread_finalize(per_thread_mem);
+
+	return NULL;
+}
+
+static void rcu_obj_free(void *arg)
+{
+	rcu_obj_t *obj = arg;
+
+	obj->magic = 0;
+	odp_mb_full();
+	obj->in_use = 0;
+}
+
+static rcu_obj_t *rcu_obj_alloc(global_shared_mem_t *global_mem)
+{
+	int i;
+
+	while (1) {
+		for (i = 0; i < RCU_NUM_OBJS; i++) {
+			if (!global_mem->rcu_obj[i].in_use) {
+				global_mem->rcu_obj[i].in_use = 1;
+				global_mem->rcu_obj[i].magic = RCU_MAGIC;
+				return &global_mem->rcu_obj[i];
+			}
+		}
+
+		/* All objects wait for a grace period */
+		odp_rcu_barrier();
+	}
+}
+
+/* One writer replaces the published object, freeing the old one after a
+ * grace period. Readers check that the object they see is never freed
+ * before their next quiescent state. */
+static void *rcu_functional_test(void *arg UNUSED)
+{
+	global_shared_mem_t *global_mem;
+	per_thread_mem_t *per_thread_mem;
+	uint32_t thread_num, iterations, cnt, sync_failures;
+	rcu_obj_t *obj, *old;
+
+	thread_num = odp_thread_id();
+	per_thread_mem = thread_init();
+	global_mem = per_thread_mem->global_mem;
+	iterations = global_mem->g_iterations;
+	sync_failures = 0;
+
+	odp_barrier_wait(&global_mem->global_barrier);
+
+	if (odp_atomic_fetch_inc_u32(&global_mem->rcu_writer) == 0) {
+		for (cnt = 1; cnt <= iterations; cnt++) {
+			obj = rcu_obj_alloc(global_mem);
+			old = global_mem->rcu_ptr;
+
+			odp_mb_release();
+			global_mem->rcu_ptr = obj;
+
+			if (cnt % 2) {
+				CU_ASSERT(odp_rcu_defer(rcu_obj_free, old) == 0);
+			} else {
+				odp_rcu_synchronize();
+				rcu_obj_free(old);
+			}
+
+			thread_delay(per_thread_mem, BASE_DELAY);
+		}
+
+		odp_rcu_barrier();
+		global_mem->rcu_done = 1;
+	} else {
+		odp_rcu_thread_online();
+
+		while (!global_mem->rcu_done) {
+			obj = global_mem->rcu_ptr;
+
+			thread_delay(per_thread_mem, BASE_DELAY);
+			if (obj->magic != RCU_MAGIC)
+				sync_failures++;
+
+			odp_rcu_quiescent();
+		}
+
+		odp_rcu_thread_offline();
+	}
+
+	if ((global_mem->g_verbose) && (sync_failures != 0))
+		printf("\nThread %" PRIu32 " (id=%d core=%d) had %" PRIu32
+		       " sync_failures\n", thread_num,
+		       per_thread_mem->thread_id,
+		       per_thread_mem->thread_core, sync_failures);
+
+	CU_ASSERT(sync_failures == 0);
+
+	thread_finalize(per_thread_mem);
+
+	return NULL;
+}
+
+/* Lock contention benchmark */
+typedef enum {
+	BENCH_SPINLOCK = 0,
+	BENCH_TICKETLOCK,
+	BENCH_MCSLOCK,
+	BENCH_RWLOCK,
+	BENCH_PFLOCK,
+	BENCH_NUM_LOCKS
+} bench_lock_t;
+
+static const char *const bench_lock_name[BENCH_NUM_LOCKS] = {
+	"spinlock", "ticketlock", "mcslock", "rwlock", "pflock"
+};
+
+static void bench_write(global_shared_mem_t *global_mem)
+{
+	INVALIDATE(&global_mem->bench_counter);
+	global_mem->bench_counter++;
+}
+
+static void *lock_bench_thread(void *arg UNUSED)
+{
+	global_shared_mem_t *global_mem;
+	per_thread_mem_t *per_thread_mem;
+	odp_mcslock_node_t node;
+	odp_time_t t1, t2;
+	uint64_t sum = 0;
+	uint32_t cnt, idx;
+	int write;
+
+	per_thread_mem = thread_init();
+	global_mem = per_thread_mem->global_mem;
+
+	odp_barrier_wait(&global_mem->bench_barrier);
+	t1 = odp_time_local();
+
+	for (cnt = 0; cnt < BENCH_ITERATIONS; cnt++) {
+		write = (cnt % BENCH_WRITE_RATIO) == 0;
+
+		switch (global_mem->bench_lock) {
+		case BENCH_SPINLOCK:
+			odp_spinlock_lock(&global_mem->global_spinlock);
+			bench_write(global_mem);
+			odp_spinlock_unlock(&global_mem->global_spinlock);
+			break;
+		case BENCH_TICKETLOCK:
+			odp_ticketlock_lock(&global_mem->global_ticketlock);
+			bench_write(global_mem);
+			odp_ticketlock_unlock(&global_mem->global_ticketlock);
+			break;
+		case BENCH_MCSLOCK:
+			odp_mcslock_lock(&global_mem->global_mcslock, &node);
+			bench_write(global_mem);
+			odp_mcslock_unlock(&global_mem->global_mcslock, &node);
+			break;
+		case BENCH_RWLOCK:
+			if (write) {
+				odp_rwlock_write_lock(&global_mem->global_rwlock);
+				bench_write(global_mem);
+				odp_rwlock_write_unlock(&global_mem->global_rwlock);
+			} else {
+				odp_rwlock_read_lock(&global_mem->global_rwlock);
+				sum += global_mem->bench_counter;
+				odp_rwlock_read_unlock(&global_mem->global_rwlock);
+			}
+			break;
+		case BENCH_PFLOCK:
+			if (write) {
+				odp_pflock_write_lock(&global_mem->global_pflock);
+				bench_write(global_mem);
+				odp_pflock_write_unlock(&global_mem->global_pflock);
+			} else {
+				odp_pflock_read_lock(&global_mem->global_pflock);
+				sum += global_mem->bench_counter;
+				odp_pflock_read_unlock(&global_mem->global_pflock);
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	t2 = odp_time_local();
+	temp_result = sum;
+
+	idx = odp_atomic_fetch_inc_u32(&global_mem->bench_idx);
+	global_mem->bench_ns[idx] = odp_time_to_ns(odp_time_diff(t2, t1));
+
+	thread_finalize(per_thread_mem);
+
+	return NULL;
+}
+
+/* Run the benchmark on one lock type with num threads, return the average
+ * time in ns per lock operation seen by a thread */
+static double lock_bench_run(bench_lock_t lock, int num)
+{
+	odph_linux_pthread_t thread_tbl[BENCH_MAX_THREADS];
+	odp_cpumask_t cpumask;
+	uint64_t expected, max_ns = 0;
+	int i;
+
+	global_mem->bench_lock = lock;
+	global_mem->bench_counter = 0;
+	odp_atomic_init_u32(&global_mem->bench_idx, 0);
+	odp_barrier_init(&global_mem->bench_barrier, num);
+
+	odp_spinlock_init(&global_mem->global_spinlock);
+	odp_ticketlock_init(&global_mem->global_ticketlock);
+	odp_mcslock_init(&global_mem->global_mcslock);
+	odp_rwlock_init(&global_mem->global_rwlock);
+	odp_pflock_init(&global_mem->global_pflock);
+
+	odp_cpumask_default_worker(&cpumask, num);
+	CU_ASSERT_FATAL(odph_linux_pthread_create(thread_tbl, &cpumask,
+						  lock_bench_thread, NULL,
+						  ODP_THREAD_WORKER) == num);
+	odph_linux_pthread_join(thread_tbl, num);
+
+	/* Every write must have been serialized */
+	expected = (uint64_t)num * BENCH_ITERATIONS;
+	if (lock == BENCH_RWLOCK || lock == BENCH_PFLOCK)
+		expected = (uint64_t)num * ((BENCH_ITERATIONS +
+					     BENCH_WRITE_RATIO - 1) /
+					    BENCH_WRITE_RATIO);
+	CU_ASSERT(global_mem->bench_counter == expected);
+
+	for (i = 0; i < num; i++)
+		if (global_mem->bench_ns[i] > max_ns)
+			max_ns = global_mem->bench_ns[i];
+
+	return (double)max_ns / BENCH_ITERATIONS;
+}
+
 static void barrier_test_init(void)
 {
 	uint32_t num_threads, idx;
@@ -1469,6 +2032,131 @@ odp_testinfo_t synchronizers_suite_rwlock_recursive[] = {
 	ODP_TEST_INFO_NULL
 };
 
+/* MCS lock tests */
+void synchronizers_test_mcslock_api(void)
+{
+	pthrd_arg arg;
+
+	arg.numthrds = global_mem->g_num_threads;
+	odp_cunit_thread_create(mcslock_api_tests, &arg);
+	odp_cunit_thread_exit(&arg);
+}
+
+void synchronizers_test_mcslock_functional(void)
+{
+	pthrd_arg arg;
+
+	arg.numthrds = global_mem->g_num_threads;
+	odp_mcslock_init(&global_mem->global_mcslock);
+
+	odp_cunit_thread_create(mcslock_functional_test, &arg);
+	odp_cunit_thread_exit(&arg);
+}
+
+odp_testinfo_t synchronizers_suite_mcslock[] = {
+	ODP_TEST_INFO(synchronizers_test_mcslock_api),
+	ODP_TEST_INFO(synchronizers_test_mcslock_functional),
+	ODP_TEST_INFO_NULL
+};
+
+/* Phase-fair RW lock tests */
+void synchronizers_test_pflock_api(void)
+{
+	pthrd_arg arg;
+
+	arg.numthrds = global_mem->g_num_threads;
+	odp_cunit_thread_create(pflock_api_tests, &arg);
+	odp_cunit_thread_exit(&arg);
+}
+
+void synchronizers_test_pflock_functional(void)
+{
+	pthrd_arg arg;
+
+	arg.numthrds = global_mem->g_num_threads;
+	odp_pflock_init(&global_mem->global_pflock);
+	odp_cunit_thread_create(pflock_functional_test, &arg);
+	odp_cunit_thread_exit(&arg);
+}
+
+odp_testinfo_t synchronizers_suite_pflock[] = {
+	ODP_TEST_INFO(synchronizers_test_pflock_api),
+	ODP_TEST_INFO(synchronizers_test_pflock_functional),
+	ODP_TEST_INFO_NULL
+};
+
+/* RCU tests */
+void synchronizers_test_rcu_api(void)
+{
+	pthrd_arg arg;
+
+	arg.numthrds = global_mem->g_num_threads;
+	odp_cunit_thread_create(rcu_api_tests, &arg);
+	odp_cunit_thread_exit(&arg);
+}
+
+void synchronizers_test_rcu_functional(void)
+{
+	pthrd_arg arg;
+	int i;
+
+	for (i = 0; i < RCU_NUM_OBJS; i++) {
+		global_mem->rcu_obj[i].magic = 0;
+		global_mem->rcu_obj[i].in_use = 0;
+	}
+
+	global_mem->rcu_obj[0].magic = RCU_MAGIC;
+	global_mem->rcu_obj[0].in_use = 1;
+	global_mem->rcu_ptr = &global_mem->rcu_obj[0];
+	global_mem->rcu_done = 0;
+	odp_atomic_init_u32(&global_mem->rcu_writer, 0);
+
+	arg.numthrds = global_mem->g_num_threads;
+	odp_cunit_thread_create(rcu_functional_test, &arg);
+	odp_cunit_thread_exit(&arg);
+}
+
+odp_testinfo_t synchronizers_suite_rcu[] = {
+	ODP_TEST_INFO(synchronizers_test_rcu_api),
+	ODP_TEST_INFO(synchronizers_test_rcu_functional),
+	ODP_TEST_INFO_NULL
+};
+
+/* Lock contention benchmark, 2 to 64 threads as far as there are worker
+ * CPUs. Read/write locks do one write per BENCH_WRITE_RATIO operations. */
+void synchronizers_test_lock_contention(void)
+{
+	odp_cpumask_t cpumask;
+	int max_num, num, lock;
+
+	max_num = odp_cpumask_default_worker(&cpumask, BENCH_MAX_THREADS);
+	if (max_num < 2) {
+		printf("\n  less than 2 worker CPUs, benchmark skipped ");
+		return;
+	}
+
+	printf("\n  ns per lock operation, %d iterations per thread\n",
+	       BENCH_ITERATIONS);
+	printf("  %-10s", "threads");
+	for (num = 2; num <= max_num; num *= 2)
+		printf(" %8d", num);
+	printf("\n");
+
+	for (lock = 0; lock < BENCH_NUM_LOCKS; lock++) {
+		printf("  %-10s", bench_lock_name[lock]);
+		for (num = 2; num <= max_num; num *= 2) {
+			printf(" %8.1f", lock_bench_run(lock, num));
+			fflush(stdout);
+		}
+		printf("\n");
+	}
+}
+
+odp_testinfo_t synchronizers_suite_lock_contention[] = {
+	ODP_TEST_INFO(synchronizers_test_lock_contention),
+	ODP_TEST_INFO_NULL
+};
+
 int synchronizers_suite_init(void)
 {
 	uint32_t num_threads, idx;
@@ -1638,6 +2326,14 @@ odp_suiteinfo_t synchronizers_suites[] = {
 		synchronizers_suite_rwlock},
 	{"rwlock_recursive", synchronizers_suite_init, NULL,
 		synchronizers_suite_rwlock_recursive},
+	{"mcslock", synchronizers_suite_init, NULL,
+		synchronizers_suite_mcslock},
+	{"pflock", synchronizers_suite_init, NULL,
+		synchronizers_suite_pflock},
+	{"rcu", synchronizers_suite_init, NULL,
+		synchronizers_suite_rcu},
+	{"lock_contention", NULL, NULL,
+		synchronizers_suite_lock_contention},
 	{"atomic", NULL, NULL,
 		synchronizers_suite_atomic},
 	ODP_SUITE_INFO_NULL
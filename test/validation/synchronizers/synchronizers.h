@@ -24,6 +24,13 @@ void synchronizers_test_rwlock_api(void);
 void synchronizers_test_rwlock_functional(void);
 void synchronizers_test_rwlock_recursive_api(void);
 void synchronizers_test_rwlock_recursive_functional(void);
+void synchronizers_test_mcslock_api(void);
+void synchronizers_test_mcslock_functional(void);
+void synchronizers_test_pflock_api(void);
+void synchronizers_test_pflock_functional(void);
+void synchronizers_test_rcu_api(void);
+void synchronizers_test_rcu_functional(void);
+void synchronizers_test_lock_contention(void);
 void synchronizers_test_atomic_inc_dec(void);
 void synchronizers_test_atomic_add_sub(void);
 void synchronizers_test_atomic_fetch_inc_dec(void);
@@ -37,6 +44,10 @@ extern odp_testinfo_t synchronizers_suite_spinlock_recursive[];
 extern odp_testinfo_t synchronizers_suite_ticketlock[];
 extern odp_testinfo_t synchronizers_suite_rwlock[];
 extern odp_testinfo_t synchronizers_suite_rwlock_recursive[];
+extern odp_testinfo_t synchronizers_suite_mcslock[];
+extern odp_testinfo_t synchronizers_suite_pflock[];
+extern odp_testinfo_t synchronizers_suite_rcu[];
+extern odp_testinfo_t synchronizers_suite_lock_contention[];
 extern odp_testinfo_t synchronizers_suite_atomic[];
 
 /* test array init/term functions: */